@@ -45,6 +45,11 @@ If you have questions concerning this license or the applicable additional terms
 	A translation with start == end or a rotation with angle == 0 performs
 	a position test and fills in the trace_t structure accordingly.
 
+	Translations, rotations, position tests and contact queries can be issued
+	from several threads at the same time. Each thread gets its own trace
+	context, including its own slot for the trace model set up with
+	SetupTrmModel. Loading and freeing models must not overlap with queries.
+
 ===============================================================================
 */
 
@@ -60,10 +60,10 @@ bool idCollisionModelManagerLocal::TestTrmVertsInBrush( cm_traceWork_t *tw, cm_b
 	float d, bestd;
 	idVec3 *p;
 
-	if ( b->checkcount == idCollisionModelManagerLocal::checkCount ) {
+	if ( CM_BrushCheck( tw, b ) == tw->context->checkCount ) {
 		return false;
 	}
-	b->checkcount = idCollisionModelManagerLocal::checkCount;
+	CM_BrushCheck( tw, b ) = tw->context->checkCount;
 
 	if ( !(b->contents & tw->contents) ) {
 		return false;
@@ -132,10 +132,10 @@ CM_SetTrmEdgeSidedness
 CM_SetTrmPolygonSidedness
 ================
 */
-#define CM_SetTrmPolygonSidedness( v, plane, bitNum ) {						\
+#define CM_SetTrmPolygonSidedness( v, point, plane, bitNum ) {				\
 	const int mask = 1 << bitNum;											\
 	if ( ( (v)->sideSet & mask ) == 0 ) {									\
-		const float fl = plane.Distance( (v)->p );							\
+		const float fl = plane.Distance( point );							\
 		(v)->side = ( (v)->side & ~mask ) | ( ( fl < 0.0f ) ? mask : 0 );		\
 		(v)->sideSet |= mask;												\
 	}																		\
@@ -154,13 +154,14 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 	float d, bestd;
 	cm_trmEdge_t *trmEdge;
 	cm_edge_t *edge;
-	cm_vertex_t *v, *v1, *v2;
+	cm_vertex_t *v;
+	cm_queryState_t *es, *vs, *v1, *v2;
 
 	// if already checked this polygon
-	if ( p->checkcount == idCollisionModelManagerLocal::checkCount ) {
+	if ( CM_PolygonCheck( tw, p ) == tw->context->checkCount ) {
 		return false;
 	}
-	p->checkcount = idCollisionModelManagerLocal::checkCount;
+	CM_PolygonCheck( tw, p ) = tw->context->checkCount;
 
 	// if this polygon does not have the right contents behind it
 	if ( !(p->contents & tw->contents) ) {
@@ -192,14 +193,14 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 			edgeNum = p->edges[i];
 			edge = tw->model->edges + abs(edgeNum);
 			// if this edge is already tested
-			if ( edge->checkcount == idCollisionModelManagerLocal::checkCount ) {
+			if ( CM_EdgeState( tw, edge )->checkcount == tw->context->checkCount ) {
 				continue;
 			}
 
 			for ( j = 0; j < 2; j++ ) {
 				v = &tw->model->vertices[edge->vertexNum[j]];
 				// if this vertex is already tested
-				if ( v->checkcount == idCollisionModelManagerLocal::checkCount ) {
+				if ( CM_VertexState( tw, v )->checkcount == tw->context->checkCount ) {
 					continue;
 				}
 
@@ -234,19 +235,20 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 	for ( i = 0; i < p->numEdges; i++ ) {
 		edgeNum = p->edges[i];
 		edge = tw->model->edges + abs(edgeNum);
+		es = CM_EdgeState( tw, edge );
 		// reset sidedness cache if this is the first time we encounter this edge
-		if ( edge->checkcount != idCollisionModelManagerLocal::checkCount ) {
-			edge->sideSet = 0;
+		if ( es->checkcount != tw->context->checkCount ) {
+			es->sideSet = 0;
 		}
 		// pluecker coordinate for edge
 		tw->polygonEdgePlueckerCache[i].FromLine( tw->model->vertices[edge->vertexNum[0]].p,
 													tw->model->vertices[edge->vertexNum[1]].p );
-		v = &tw->model->vertices[edge->vertexNum[INT32_SIGNBITSET( edgeNum )]];
+		vs = &tw->context->vertexStates[edge->vertexNum[INT32_SIGNBITSET( edgeNum )]];
 		// reset sidedness cache if this is the first time we encounter this vertex
-		if ( v->checkcount != idCollisionModelManagerLocal::checkCount ) {
-			v->sideSet = 0;
+		if ( vs->checkcount != tw->context->checkCount ) {
+			vs->sideSet = 0;
 		}
-		v->checkcount = idCollisionModelManagerLocal::checkCount;
+		vs->checkcount = tw->context->checkCount;
 	}
 
 	// get side of polygon for each trm vertex
@@ -266,10 +268,10 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 		// test if trm edge goes through the polygon between the polygon edges
 		for ( j = 0; j < p->numEdges; j++ ) {
 			edgeNum = p->edges[j];
-			edge = tw->model->edges + abs(edgeNum);
+			es = &tw->context->edgeStates[abs(edgeNum)];
 #if 1
-			CM_SetTrmEdgeSidedness( edge, tw->edges[i].pl, tw->polygonEdgePlueckerCache[j], i );
-			if ( INT32_SIGNBITSET( edgeNum ) ^ ( ( edge->side >> i ) & 1 ) ^ flip ) {
+			CM_SetTrmEdgeSidedness( es, tw->edges[i].pl, tw->polygonEdgePlueckerCache[j], i );
+			if ( INT32_SIGNBITSET( edgeNum ) ^ ( ( es->side >> i ) & 1 ) ^ flip ) {
 				break;
 			}
 #else
@@ -307,17 +309,18 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 	for ( i = 0; i < p->numEdges; i++ ) {
 		edgeNum = p->edges[i];
 		edge = tw->model->edges + abs(edgeNum);
-		if ( edge->checkcount == idCollisionModelManagerLocal::checkCount ) {
+		es = CM_EdgeState( tw, edge );
+		if ( es->checkcount == tw->context->checkCount ) {
 			continue;
 		}
-		edge->checkcount = idCollisionModelManagerLocal::checkCount;
+		es->checkcount = tw->context->checkCount;
 
 		for ( j = 0; j < tw->numPolys; j++ ) {
 #if 1
-			v1 = tw->model->vertices + edge->vertexNum[0];
-			CM_SetTrmPolygonSidedness( v1, tw->polys[j].plane, j );
-			v2 = tw->model->vertices + edge->vertexNum[1];
-			CM_SetTrmPolygonSidedness( v2, tw->polys[j].plane, j );
+			v1 = &tw->context->vertexStates[edge->vertexNum[0]];
+			CM_SetTrmPolygonSidedness( v1, tw->model->vertices[edge->vertexNum[0]].p, tw->polys[j].plane, j );
+			v2 = &tw->context->vertexStates[edge->vertexNum[1]];
+			CM_SetTrmPolygonSidedness( v2, tw->model->vertices[edge->vertexNum[1]].p, tw->polys[j].plane, j );
 			// if the polygon edge does not cross the trm polygon plane
 			if ( !(((v1->side ^ v2->side) >> j) & 1) ) {
 				continue;
@@ -326,10 +329,8 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 #else
 			float d1, d2;
 
-			v1 = tw->model->vertices + edge->vertexNum[0];
-			d1 = tw->polys[j].plane.Distance( v1->p );
-			v2 = tw->model->vertices + edge->vertexNum[1];
-			d2 = tw->polys[j].plane.Distance( v2->p );
+			d1 = tw->polys[j].plane.Distance( tw->model->vertices[edge->vertexNum[0]].p );
+			d2 = tw->polys[j].plane.Distance( tw->model->vertices[edge->vertexNum[1]].p );
 			// if the polygon edge does not cross the trm polygon plane
 			if ( (d1 >= 0.0f && d2 >= 0.0f) || (d1 <= 0.0f && d2 <= 0.0f) ) {
 				continue;
@@ -345,8 +346,8 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 				trmEdge = tw->edges + abs(trmEdgeNum);
 #if 1
 				bitNum = abs(trmEdgeNum);
-				CM_SetTrmEdgeSidedness( edge, trmEdge->pl, tw->polygonEdgePlueckerCache[i], bitNum );
-				if ( INT32_SIGNBITSET( trmEdgeNum ) ^ ( ( edge->side >> bitNum ) & 1 ) ^ flip ) {
+				CM_SetTrmEdgeSidedness( es, trmEdge->pl, tw->polygonEdgePlueckerCache[i], bitNum );
+				if ( INT32_SIGNBITSET( trmEdgeNum ) ^ ( ( es->side >> bitNum ) & 1 ) ^ flip ) {
 					break;
 				}
 #else
@@ -405,6 +406,36 @@ cm_node_t *idCollisionModelManagerLocal::PointNode( const idVec3 &p, cm_model_t
 	return node;
 }
 
+/*
+================
+CM_PointInBrush
+================
+*/
+static bool CM_PointInBrush( const idVec3 &p, const cm_brush_t *b ) {
+	int i;
+	float d;
+	const idPlane *plane;
+
+	// test if the point is within the brush bounds
+	for ( i = 0; i < 3; i++ ) {
+		if ( p[i] < b->bounds[0][i] ) {
+			return false;
+		}
+		if ( p[i] > b->bounds[1][i] ) {
+			return false;
+		}
+	}
+	// test if the point is inside the brush
+	plane = b->planes;
+	for ( i = 0; i < b->numPlanes; i++, plane++ ) {
+		d = plane->Distance( p );
+		if ( d >= 0.0f ) {
+			return false;
+		}
+	}
+	return true;
+}
+
 /*
 ================
 idCollisionModelManagerLocal::PointContents
@@ -412,37 +443,38 @@ idCollisionModelManagerLocal::PointContents
 */
 int idCollisionModelManagerLocal::PointContents( const idVec3 p, cmHandle_t model ) {
 	int i;
-	float d;
+	cm_model_t *cmodel;
 	cm_node_t *node;
 	cm_brushRef_t *bref;
-	cm_brush_t *b;
-	idPlane *plane;
+	const cm_bakedNode_t *bakedNode;
+	cm_brush_t **brushes;
 
-	node = idCollisionModelManagerLocal::PointNode( p, idCollisionModelManagerLocal::models[model] );
-	for ( bref = node->brushes; bref; bref = bref->next ) {
-		b = bref->b;
-		// test if the point is within the brush bounds
-		for ( i = 0; i < 3; i++ ) {
-			if ( p[i] < b->bounds[0][i] ) {
-				break;
+	cmodel = idCollisionModelManagerLocal::QueryModel( GetTraceContext(), model );
+
+	// walk the flattened tree if available
+	if ( cmodel->bakedNodes && cm_bakeModels.GetBool() ) {
+		bakedNode = cmodel->bakedNodes;
+		while ( bakedNode->planeType != -1 ) {
+			if ( p[bakedNode->planeType] > bakedNode->planeDist ) {
+				bakedNode = cmodel->bakedNodes + bakedNode->children[0];
 			}
-			if ( p[i] > b->bounds[1][i] ) {
-				break;
+			else {
+				bakedNode = cmodel->bakedNodes + bakedNode->children[1];
 			}
 		}
-		if ( i < 3 ) {
-			continue;
-		}
-		// test if the point is inside the brush
-		plane = b->planes;
-		for ( i = 0; i < b->numPlanes; i++, plane++ ) {
-			d = plane->Distance( p );
-			if ( d >= 0.0f ) {
-				break;
+		brushes = cmodel->bakedBrushes + bakedNode->firstBrush;
+		for ( i = 0; i < bakedNode->numBrushes; i++ ) {
+			if ( CM_PointInBrush( p, brushes[i] ) ) {
+				return brushes[i]->contents;
 			}
 		}
-		if ( i >= b->numPlanes ) {
-			return b->contents;
+		return 0;
+	}
+
+	node = idCollisionModelManagerLocal::PointNode( p, cmodel );
+	for ( bref = node->brushes; bref; bref = bref->next ) {
+		if ( CM_PointInBrush( p, bref->b ) ) {
+			return bref->b->contents;
 		}
 	}
 	return 0;
@@ -477,6 +509,7 @@ int idCollisionModelManagerLocal::ContentsTrm( trace_t *results, const idVec3 &s
 	bool model_rotated, trm_rotated;
 	idMat3 invModelAxis, tmpAxis;
 	idVec3 dir;
+	cm_traceContext_t *context;
 	ALIGN16( cm_traceWork_t tw );
 
 	// fast point case
@@ -492,8 +525,9 @@ int idCollisionModelManagerLocal::ContentsTrm( trace_t *results, const idVec3 &s
 		return results->c.contents;
 	}
 
-	idCollisionModelManagerLocal::checkCount++;
+	context = idCollisionModelManagerLocal::GetTraceContext();
 
+	tw.context = context;
 	tw.trace.fraction = 1.0f;
 	tw.trace.c.contents = 0;
 	tw.trace.c.type = CONTACT_NONE;
@@ -504,7 +538,9 @@ int idCollisionModelManagerLocal::ContentsTrm( trace_t *results, const idVec3 &s
 	tw.pointTrace = false;
 	tw.quickExit = false;
 	tw.numContacts = 0;
-	tw.model = idCollisionModelManagerLocal::models[model];
+	tw.model = idCollisionModelManagerLocal::QueryModel( context, model );
+
+	idCollisionModelManagerLocal::PrepareTraceContext( context, tw.model );
 	tw.start = start - modelOrigin;
 	tw.end = tw.start;
 
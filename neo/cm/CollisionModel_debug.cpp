@@ -242,10 +242,10 @@ void idCollisionModelManagerLocal::DrawPolygon( cm_model_t *model, cm_polygon_t
 		for ( i = 0; i < p->numEdges; i++ ) {
 			edgeNum = p->edges[i];
 			edge = model->edges + abs(edgeNum);
-			if ( edge->checkcount == checkCount ) {
+			if ( edge->checkcount == checkCount.GetValue() ) {
 				continue;
 			}
-			edge->checkcount = checkCount;
+			edge->checkcount = checkCount.GetValue();
 			DrawEdge( model, edgeNum, origin, axis );
 		}
 	}
@@ -280,7 +280,7 @@ void idCollisionModelManagerLocal::DrawNodePolygons( cm_model_t *model, cm_node_
 					continue;
 				}
 			}
-			if ( p->checkcount == checkCount ) {
+			if ( p->checkcount == checkCount.GetValue() ) {
 				continue;
 			}
 			if ( !( p->contents & cm_contentsFlagByIndex[cm_drawMask.GetInteger()] ) ) {
@@ -288,7 +288,7 @@ void idCollisionModelManagerLocal::DrawNodePolygons( cm_model_t *model, cm_node_
 			}
 
 			DrawPolygon( model, p, origin, axis, viewOrigin );
-			p->checkcount = checkCount;
+			p->checkcount = checkCount.GetValue();
 		}
 		if ( node->planeType == -1 ) {
 			break;
@@ -324,9 +324,9 @@ void idCollisionModelManagerLocal::DrawModel( cmHandle_t handle, const idVec3 &m
 		cm_drawColor.ClearModified();
 	}
 
-	model = models[ handle ];
+	model = QueryModel( handle );
 	viewPos = (viewOrigin - modelOrigin) * modelAxis.Transpose();
-	checkCount++;
+	checkCount.Increment();
 	DrawNodePolygons( model, model->node, modelOrigin, modelAxis, viewPos, radius );
 }
 
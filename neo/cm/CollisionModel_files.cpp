@@ -84,10 +84,10 @@ int idCollisionModelManagerLocal::CountPolygonMemory( cm_node_t *node ) const {
 	memory = 0;
 	for ( pref = node->polygons; pref; pref = pref->next ) {
 		p = pref->p;
-		if ( p->checkcount == checkCount ) {
+		if ( p->checkcount == checkCount.GetValue() ) {
 			continue;
 		}
-		p->checkcount = checkCount;
+		p->checkcount = checkCount.GetValue();
 
 		memory += sizeof( cm_polygon_t ) + ( p->numEdges - 1 ) * sizeof( p->edges[0] );
 	}
@@ -110,10 +110,10 @@ void idCollisionModelManagerLocal::WritePolygons( idFile *fp, cm_node_t *node )
 
 	for ( pref = node->polygons; pref; pref = pref->next ) {
 		p = pref->p;
-		if ( p->checkcount == checkCount ) {
+		if ( p->checkcount == checkCount.GetValue() ) {
 			continue;
 		}
-		p->checkcount = checkCount;
+		p->checkcount = checkCount.GetValue();
 		fp->WriteFloatString( "\t%d (", p->numEdges );
 		for ( i = 0; i < p->numEdges; i++ ) {
 			fp->WriteFloatString( " %d", p->edges[i] );
@@ -142,10 +142,10 @@ int idCollisionModelManagerLocal::CountBrushMemory( cm_node_t *node ) const {
 	memory = 0;
 	for ( bref = node->brushes; bref; bref = bref->next ) {
 		b = bref->b;
-		if ( b->checkcount == checkCount ) {
+		if ( b->checkcount == checkCount.GetValue() ) {
 			continue;
 		}
-		b->checkcount = checkCount;
+		b->checkcount = checkCount.GetValue();
 
 		memory += sizeof( cm_brush_t ) + ( b->numPlanes - 1 ) * sizeof( b->planes[0] );
 	}
@@ -168,10 +168,10 @@ void idCollisionModelManagerLocal::WriteBrushes( idFile *fp, cm_node_t *node ) {
 
 	for ( bref = node->brushes; bref; bref = bref->next ) {
 		b = bref->b;
-		if ( b->checkcount == checkCount ) {
+		if ( b->checkcount == checkCount.GetValue() ) {
 			continue;
 		}
-		b->checkcount = checkCount;
+		b->checkcount = checkCount.GetValue();
 		fp->WriteFloatString( "\t%d {\n", b->numPlanes );
 		for ( i = 0; i < b->numPlanes; i++ ) {
 			fp->WriteFloatString( "\t\t( %f %f %f ) %f\n", b->planes[i].Normal()[0], b->planes[i].Normal()[1], b->planes[i].Normal()[2], b->planes[i].Dist() );
@@ -211,17 +211,17 @@ void idCollisionModelManagerLocal::WriteCollisionModel( idFile *fp, cm_model_t *
 	WriteNodes( fp, model->node );
 	fp->WriteFloatString( "\t}\n" );
 	// polygons
-	checkCount++;
+	checkCount.Increment();
 	polygonMemory = CountPolygonMemory( model->node );
 	fp->WriteFloatString( "\tpolygons /* polygonMemory = */ %d {\n", polygonMemory );
-	checkCount++;
+	checkCount.Increment();
 	WritePolygons( fp, model->node );
 	fp->WriteFloatString( "\t}\n" );
 	// brushes
-	checkCount++;
+	checkCount.Increment();
 	brushMemory = CountBrushMemory( model->node );
 	fp->WriteFloatString( "\tbrushes /* brushMemory = */ %d {\n", brushMemory );
-	checkCount++;
+	checkCount.Increment();
 	WriteBrushes( fp, model->node );
 	fp->WriteFloatString( "\t}\n" );
 	// closing brace
@@ -270,8 +270,11 @@ bool idCollisionModelManagerLocal::WriteCollisionModelForMapEntity( const idMapE
 	idFile *fp;
 	idStr name;
 	cm_model_t *model;
+	cm_buildContext_t *build;
 
-	SetupHash();
+	build = GetBuildContext();
+	SetupHash( build );
+	build->worldModel = ( numModels == 0 );
 	model = CollisionModelForMapEntity( mapEnt );
 	model->name = filename;
 
@@ -532,7 +535,7 @@ cm_model_t * idCollisionModelManagerLocal::ParseCollisionModel( idLexer *src ) {
 		src->Error( "ParseCollisionModel: bad token \"%s\"", token.c_str() );
 	}
 	// calculate edge normals
-	checkCount++;
+	GetBuildContext()->checkCount = checkCount.Increment();
 	CalculateEdgeNormals( model, model->node );
 	// get model bounds from brush and polygon bounds
 	CM_GetNodeBounds( &model->bounds, model->node );
@@ -53,21 +53,19 @@ If you have questions concerning this license or the applicable additional terms
 
 #define CMODEL_BINARYFILE_EXT	"bcmodel"
 
+// trace context of the current thread, NULL until the thread issues its first collision query
+static ID_TLS threadTraceContext;
+
 idCollisionModelManagerLocal	collisionModelManagerLocal;
 idCollisionModelManager *		collisionModelManager = &collisionModelManagerLocal;
 
-cm_windingList_t *				cm_windingList;
-cm_windingList_t *				cm_outList;
-cm_windingList_t *				cm_tmpList;
-
-idHashIndex *					cm_vertexHash;
-idHashIndex *					cm_edgeHash;
-
-idBounds						cm_modelBounds;
-int								cm_vertexShift;
+// build context of the current build job, NULL on threads outside the build jobs
+static ID_TLS threadBuildContext;
 
 
 idCVar preLoad_Collision( "preLoad_Collision", "1", CVAR_SYSTEM | CVAR_BOOL, "preload collision beginlevelload" );
+idCVar cm_bakeModels( "cm_bakeModels", "1", CVAR_GAME | CVAR_BOOL, "flatten the BSP trees of loaded collision models into contiguous arrays and trace through those" );
+idCVar cm_parallelBuild( "cm_parallelBuild", "1", CVAR_GAME | CVAR_BOOL, "build the collision models of maps without a collision model file on job threads" );
 
 /*
 ===============================================================================
@@ -183,19 +181,24 @@ void idCollisionModelManagerLocal::Clear() {
 	mapName.Clear();
 	mapFileTime = 0;
 	loaded = 0;
-	checkCount = 0;
+	checkCount.SetValue( 0 );
 	maxModels = 0;
 	numModels = 0;
 	models = NULL;
-	memset( trmPolygons, 0, sizeof( trmPolygons ) );
-	trmBrushes[0] = NULL;
 	trmMaterial = NULL;
 	numProcNodes = 0;
 	procNodes = NULL;
-	getContacts = false;
-	contacts = NULL;
-	maxContacts = 0;
-	numContacts = 0;
+	// the trace contexts stay claimed by their threads
+	for ( int i = 0; i < CM_MAX_TRACE_CONTEXTS; i++ ) {
+		cm_traceContext_t *context = &traceContexts[i];
+		context->trmModel = NULL;
+		memset( context->trmPolygons, 0, sizeof( context->trmPolygons ) );
+		context->trmBrushes[0] = NULL;
+		context->getContacts = false;
+		context->contacts = NULL;
+		context->maxContacts = 0;
+		context->numContacts = 0;
+	}
 }
 
 /*
@@ -372,6 +375,8 @@ void idCollisionModelManagerLocal::FreeModel( cm_model_t *model ) {
 	cm_brushRefBlock_t *brushRefBlock, *nextBrushRefBlock;
 	cm_nodeBlock_t *nodeBlock, *nextNodeBlock;
 
+	// free the flattened tree
+	FreeBakedModel( model );
 	// free the tree structure
 	if ( model->node ) {
 		FreeTree_r( model, model->node, model->node );
@@ -425,11 +430,15 @@ void idCollisionModelManagerLocal::FreeMap() {
 
 	FreeTrmModelStructure();
 
+	FreeTraceContexts();
+
 	Mem_Free( models );
 
 	Clear();
 
-	ShutdownHash();
+	for ( int i = 0; i < CM_MAX_BUILD_CONTEXTS; i++ ) {
+		ShutdownHash( &buildContexts[i] );
+	}
 }
 
 /*
@@ -438,21 +447,30 @@ idCollisionModelManagerLocal::FreeTrmModelStructure
 ================
 */
 void idCollisionModelManagerLocal::FreeTrmModelStructure() {
-	int i;
+	int i, j;
+	cm_traceContext_t *context;
 
 	assert( models );
 	if ( !models[MAX_SUBMODELS] ) {
 		return;
 	}
 
-	for ( i = 0; i < MAX_TRACEMODEL_POLYS; i++ ) {
-		FreePolygon( models[MAX_SUBMODELS], trmPolygons[i]->p );
-	}
-	FreeBrush( models[MAX_SUBMODELS], trmBrushes[0]->b );
+	for ( i = 0; i < CM_MAX_TRACE_CONTEXTS; i++ ) {
+		context = &traceContexts[i];
+		if ( !context->trmModel ) {
+			continue;
+		}
+		for ( j = 0; j < MAX_TRACEMODEL_POLYS; j++ ) {
+			FreePolygon( context->trmModel, context->trmPolygons[j]->p );
+		}
+		FreeBrush( context->trmModel, context->trmBrushes[0]->b );
 
-	models[MAX_SUBMODELS]->node->polygons = NULL;
-	models[MAX_SUBMODELS]->node->brushes = NULL;
-	FreeModel( models[MAX_SUBMODELS] );
+		context->trmModel->node->polygons = NULL;
+		context->trmModel->node->brushes = NULL;
+		FreeModel( context->trmModel );
+		context->trmModel = NULL;
+	}
+	models[MAX_SUBMODELS] = NULL;
 }
 
 
@@ -472,6 +490,7 @@ idCollisionModelManagerLocal::CalculateEdgeNormals
 #define SHARP_EDGE_DOT	-0.7f
 
 void idCollisionModelManagerLocal::CalculateEdgeNormals( cm_model_t *model, cm_node_t *node ) {
+	cm_buildContext_t *build = GetBuildContext();
 	cm_polygonRef_t *pref;
 	cm_polygon_t *p;
 	cm_edge_t *edge;
@@ -483,10 +502,10 @@ void idCollisionModelManagerLocal::CalculateEdgeNormals( cm_model_t *model, cm_n
 		for ( pref = node->polygons; pref; pref = pref->next ) {
 			p = pref->p;
 			// if we checked this polygon already
-			if ( p->checkcount == checkCount ) {
+			if ( p->checkcount == build->checkCount ) {
 				continue;
 			}
-			p->checkcount = checkCount;
+			p->checkcount = build->checkCount;
 
 			for ( i = 0; i < p->numEdges; i++ ) {
 				edgeNum = p->edges[i];
@@ -552,11 +571,19 @@ cm_model_t *idCollisionModelManagerLocal::AllocModel() {
 	model->numEdges = 0;
 	model->edges= NULL;
 	model->node = NULL;
+	model->numBakedNodes = 0;
+	model->bakedNodes = NULL;
+	model->numBakedPolygons = 0;
+	model->bakedPolygons = NULL;
+	model->numBakedBrushes = 0;
+	model->bakedBrushes = NULL;
 	model->nodeBlocks = NULL;
 	model->polygonRefBlocks = NULL;
 	model->brushRefBlocks = NULL;
 	model->polygonBlock = NULL;
 	model->brushBlock = NULL;
+	model->numPolygonQueryNums = 0;
+	model->numBrushQueryNums = 0;
 	model->numPolygons = model->polygonMemory =
 	model->numBrushes = model->brushMemory =
 	model->numNodes = model->numBrushRefs =
@@ -674,6 +701,7 @@ cm_polygon_t *idCollisionModelManagerLocal::AllocPolygon( cm_model_t *model, int
 	} else {
 		poly = (cm_polygon_t *) Mem_ClearedAlloc( size, TAG_COLLISION );
 	}
+	poly->queryNum = model->numPolygonQueryNums++;
 	return poly;
 }
 
@@ -696,6 +724,7 @@ cm_brush_t *idCollisionModelManagerLocal::AllocBrush( cm_model_t *model, int num
 	} else {
 		brush = (cm_brush_t *) Mem_ClearedAlloc( size, TAG_COLLISION );
 	}
+	brush->queryNum = model->numBrushQueryNums++;
 	return brush;
 }
 
@@ -735,60 +764,168 @@ idCollisionModelManagerLocal::SetupTrmModelStructure
 ================
 */
 void idCollisionModelManagerLocal::SetupTrmModelStructure() {
-	int i;
+	int i, j;
 	cm_node_t *node;
 	cm_model_t *model;
-
-	// setup model
-	model = AllocModel();
+	cm_traceContext_t *context;
 
 	assert( models );
-	models[MAX_SUBMODELS] = model;
-	// create node to hold the collision data
-	node = (cm_node_t *) AllocNode( model, 1 );
-	node->planeType = -1;
-	model->node = node;
-	// allocate vertex and edge arrays
-	model->numVertices = 0;
-	model->maxVertices = MAX_TRACEMODEL_VERTS;
-	model->vertices = (cm_vertex_t *) Mem_ClearedAlloc( model->maxVertices * sizeof(cm_vertex_t), TAG_COLLISION );
-	model->numEdges = 0;
-	model->maxEdges = MAX_TRACEMODEL_EDGES+1;
-	model->edges = (cm_edge_t *) Mem_ClearedAlloc( model->maxEdges * sizeof(cm_edge_t), TAG_COLLISION );
+
 	// create a material for the trace model polygons
 	trmMaterial = declManager->FindMaterial( "_tracemodel", false );
 	if ( !trmMaterial ) {
 		common->FatalError( "_tracemodel material not found" );
 	}
 
-	// allocate polygons
-	for ( i = 0; i < MAX_TRACEMODEL_POLYS; i++ ) {
-		trmPolygons[i] = AllocPolygonReference( model, MAX_TRACEMODEL_POLYS );
-		trmPolygons[i]->p = AllocPolygon( model, MAX_TRACEMODEL_POLYEDGES );
-		trmPolygons[i]->p->bounds.Clear();
-		trmPolygons[i]->p->plane.Zero();
-		trmPolygons[i]->p->checkcount = 0;
-		trmPolygons[i]->p->contents = -1;		// all contents
-		trmPolygons[i]->p->material = trmMaterial;
-		trmPolygons[i]->p->numEdges = 0;
+	// every trace context gets its own trm model so threads can convert trace models concurrently
+	for ( j = 0; j < CM_MAX_TRACE_CONTEXTS; j++ ) {
+		context = &traceContexts[j];
+
+		// setup model
+		model = AllocModel();
+		context->trmModel = model;
+		// create node to hold the collision data
+		node = (cm_node_t *) AllocNode( model, 1 );
+		node->planeType = -1;
+		model->node = node;
+		// allocate vertex and edge arrays
+		model->numVertices = 0;
+		model->maxVertices = MAX_TRACEMODEL_VERTS;
+		model->vertices = (cm_vertex_t *) Mem_ClearedAlloc( model->maxVertices * sizeof(cm_vertex_t), TAG_COLLISION );
+		model->numEdges = 0;
+		model->maxEdges = MAX_TRACEMODEL_EDGES+1;
+		model->edges = (cm_edge_t *) Mem_ClearedAlloc( model->maxEdges * sizeof(cm_edge_t), TAG_COLLISION );
+
+		// allocate polygons
+		for ( i = 0; i < MAX_TRACEMODEL_POLYS; i++ ) {
+			context->trmPolygons[i] = AllocPolygonReference( model, MAX_TRACEMODEL_POLYS );
+			context->trmPolygons[i]->p = AllocPolygon( model, MAX_TRACEMODEL_POLYEDGES );
+			context->trmPolygons[i]->p->bounds.Clear();
+			context->trmPolygons[i]->p->plane.Zero();
+			context->trmPolygons[i]->p->checkcount = 0;
+			context->trmPolygons[i]->p->contents = -1;		// all contents
+			context->trmPolygons[i]->p->material = trmMaterial;
+			context->trmPolygons[i]->p->numEdges = 0;
+		}
+		// allocate brush for position test
+		context->trmBrushes[0] = AllocBrushReference( model, 1 );
+		context->trmBrushes[0]->b = AllocBrush( model, MAX_TRACEMODEL_POLYS );
+		context->trmBrushes[0]->b->primitiveNum = 0;
+		context->trmBrushes[0]->b->bounds.Clear();
+		context->trmBrushes[0]->b->checkcount = 0;
+		context->trmBrushes[0]->b->contents = -1;		// all contents
+		context->trmBrushes[0]->b->material = trmMaterial;
+		context->trmBrushes[0]->b->numPlanes = 0;
+	}
+
+	// the first context owns the trm model slot used for debug drawing and model info
+	models[MAX_SUBMODELS] = traceContexts[0].trmModel;
+}
+
+/*
+================
+idCollisionModelManagerLocal::GetTraceContext
+
+  Returns the trace context of the calling thread. A thread claims a context
+  the first time it issues a collision query and keeps it for its lifetime.
+================
+*/
+cm_traceContext_t *idCollisionModelManagerLocal::GetTraceContext() {
+	cm_traceContext_t *context = (cm_traceContext_t *) (ptrdiff_t) threadTraceContext;
+	if ( context == NULL ) {
+		int contextNum = numTraceContexts.Increment() - 1;
+		if ( contextNum >= CM_MAX_TRACE_CONTEXTS ) {
+			common->FatalError( "idCollisionModelManagerLocal::GetTraceContext: more than %d threads issue collision queries", CM_MAX_TRACE_CONTEXTS );
+		}
+		context = &traceContexts[contextNum];
+		threadTraceContext = (ptrdiff_t) context;
+	}
+	return context;
+}
+
+/*
+================
+idCollisionModelManagerLocal::PrepareTraceContext
+
+  Starts a new query on the model. The query state arrays only grow, stale
+  entries are recognized by their check count.
+================
+*/
+void idCollisionModelManagerLocal::PrepareTraceContext( cm_traceContext_t *context, const cm_model_t *model ) {
+	if ( context->maxVertexStates < model->maxVertices ) {
+		Mem_Free( context->vertexStates );
+		context->maxVertexStates = model->maxVertices;
+		context->vertexStates = (cm_queryState_t *) Mem_ClearedAlloc( context->maxVertexStates * sizeof( cm_queryState_t ), TAG_COLLISION );
+	}
+	if ( context->maxEdgeStates < model->maxEdges ) {
+		Mem_Free( context->edgeStates );
+		context->maxEdgeStates = model->maxEdges;
+		context->edgeStates = (cm_queryState_t *) Mem_ClearedAlloc( context->maxEdgeStates * sizeof( cm_queryState_t ), TAG_COLLISION );
+	}
+	if ( context->maxPolygonChecks < model->numPolygonQueryNums ) {
+		Mem_Free( context->polygonChecks );
+		context->maxPolygonChecks = model->numPolygonQueryNums;
+		context->polygonChecks = (int *) Mem_ClearedAlloc( context->maxPolygonChecks * sizeof( int ), TAG_COLLISION );
+	}
+	if ( context->maxBrushChecks < model->numBrushQueryNums ) {
+		Mem_Free( context->brushChecks );
+		context->maxBrushChecks = model->numBrushQueryNums;
+		context->brushChecks = (int *) Mem_ClearedAlloc( context->maxBrushChecks * sizeof( int ), TAG_COLLISION );
+	}
+	context->checkCount++;
+}
+
+/*
+================
+idCollisionModelManagerLocal::QueryModel
+
+  The trace model handle resolves to the trm model of the trace context.
+================
+*/
+cm_model_t *idCollisionModelManagerLocal::QueryModel( cm_traceContext_t *context, cmHandle_t model ) const {
+	if ( model == TRACE_MODEL_HANDLE ) {
+		return context->trmModel;
+	}
+	return models[model];
+}
+
+/*
+================
+idCollisionModelManagerLocal::QueryModel
+
+  Resolves the handle with the trace context of the calling thread.
+================
+*/
+cm_model_t *idCollisionModelManagerLocal::QueryModel( cmHandle_t model ) const {
+	return QueryModel( const_cast<idCollisionModelManagerLocal *>( this )->GetTraceContext(), model );
+}
+
+/*
+================
+idCollisionModelManagerLocal::FreeTraceContexts
+================
+*/
+void idCollisionModelManagerLocal::FreeTraceContexts() {
+	for ( int i = 0; i < CM_MAX_TRACE_CONTEXTS; i++ ) {
+		cm_traceContext_t *context = &traceContexts[i];
+		Mem_Free( context->vertexStates );
+		Mem_Free( context->edgeStates );
+		Mem_Free( context->polygonChecks );
+		Mem_Free( context->brushChecks );
+		context->vertexStates = context->edgeStates = NULL;
+		context->polygonChecks = context->brushChecks = NULL;
+		context->maxVertexStates = context->maxEdgeStates = 0;
+		context->maxPolygonChecks = context->maxBrushChecks = 0;
+		context->checkCount = 0;
 	}
-	// allocate brush for position test
-	trmBrushes[0] = AllocBrushReference( model, 1 );
-	trmBrushes[0]->b = AllocBrush( model, MAX_TRACEMODEL_POLYS );
-	trmBrushes[0]->b->primitiveNum = 0;
-	trmBrushes[0]->b->bounds.Clear();
-	trmBrushes[0]->b->checkcount = 0;
-	trmBrushes[0]->b->contents = -1;		// all contents
-	trmBrushes[ 0 ]->b->material = trmMaterial;
-	trmBrushes[0]->b->numPlanes = 0;
 }
 
 /*
 ================
 idCollisionModelManagerLocal::SetupTrmModel
 
-Trace models (item boxes, etc) are converted to collision models on the fly, using the last model slot
-as a reusable temporary buffer
+Trace models (item boxes, etc) are converted to collision models on the fly, using the trm model of
+the calling thread's trace context as a reusable temporary buffer
 ================
 */
 cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm, const idMaterial *material ) {
@@ -800,6 +937,7 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm,
 	const traceModelVert_t *trmVert;
 	const traceModelEdge_t *trmEdge;
 	const traceModelPoly_t *trmPoly;
+	cm_traceContext_t *context;
 
 	assert( models );
 
@@ -807,7 +945,8 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm,
 		material = trmMaterial;
 	}
 
-	model = models[MAX_SUBMODELS];
+	context = GetTraceContext();
+	model = context->trmModel;
 	model->node->brushes = NULL;
 	model->node->polygons = NULL;
 	// if not a valid trace model
@@ -837,7 +976,7 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm,
 	model->numPolygons = trm.numPolys;
 	trmPoly = trm.polys;
 	for ( i = 0; i < trm.numPolys; i++, trmPoly++ ) {
-		poly = trmPolygons[i]->p;
+		poly = context->trmPolygons[i]->p;
 		poly->numEdges = trmPoly->numEdges;
 		for ( j = 0; j < trmPoly->numEdges; j++ ) {
 			poly->edges[j] = trmPoly->edges[j];
@@ -847,21 +986,21 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm,
 		poly->bounds = trmPoly->bounds;
 		poly->material = material;
 		// link polygon at node
-		trmPolygons[i]->next = model->node->polygons;
-		model->node->polygons = trmPolygons[i];
+		context->trmPolygons[i]->next = model->node->polygons;
+		model->node->polygons = context->trmPolygons[i];
 	}
 	// if the trace model is convex
 	if ( trm.isConvex ) {
 		// setup brush for position test
-		trmBrushes[0]->b->numPlanes = trm.numPolys;
+		context->trmBrushes[0]->b->numPlanes = trm.numPolys;
 		for ( i = 0; i < trm.numPolys; i++ ) {
-			trmBrushes[0]->b->planes[i] = trmPolygons[i]->p->plane;
+			context->trmBrushes[0]->b->planes[i] = context->trmPolygons[i]->p->plane;
 		}
-		trmBrushes[0]->b->bounds = trm.bounds;
+		context->trmBrushes[0]->b->bounds = trm.bounds;
 		// link brush at node
-		trmBrushes[0]->next = model->node->brushes;
-		trmBrushes[ 0 ]->b->material = material;
-		model->node->brushes = trmBrushes[0];
+		context->trmBrushes[0]->next = model->node->brushes;
+		context->trmBrushes[0]->b->material = material;
+		model->node->brushes = context->trmBrushes[0];
 	}
 	// model bounds
 	model->bounds = trm.bounds;
@@ -974,6 +1113,7 @@ idCollisionModelManagerLocal::ChopWindingWithBrush
 =============
 */
 void idCollisionModelManagerLocal::ChopWindingListWithBrush( cm_windingList_t *list, cm_brush_t *b ) {
+	cm_buildContext_t *build = GetBuildContext();
 	int i, k, res, startPlane, planeNum, bestNumWindings;
 	idFixedWinding back, front;
 	idPlane plane;
@@ -1010,7 +1150,7 @@ void idCollisionModelManagerLocal::ChopWindingListWithBrush( cm_windingList_t *l
 		}
 	}
 
-	cm_outList->numWindings = 0;
+	build->outList->numWindings = 0;
 	for ( k = 0; k < list->numWindings; k++ ) {
 		//
 		startPlane = 0;
@@ -1018,7 +1158,7 @@ void idCollisionModelManagerLocal::ChopWindingListWithBrush( cm_windingList_t *l
 		chopped = false;
 		do {
 			front = list->w[k];
-			cm_tmpList->numWindings = 0;
+			build->tmpList->numWindings = 0;
 			for ( planeNum = startPlane, i = 0; i < b->numPlanes; i++, planeNum++ ) {
 
 				if ( planeNum >= b->numPlanes ) {
@@ -1042,44 +1182,44 @@ void idCollisionModelManagerLocal::ChopWindingListWithBrush( cm_windingList_t *l
 				}
 
 				if ( res == SIDE_BACK ) {
-					if ( cm_outList->numWindings >= MAX_WINDING_LIST ) {
+					if ( build->outList->numWindings >= MAX_WINDING_LIST ) {
 						common->Warning( "idCollisionModelManagerLocal::ChopWindingWithBrush: primitive %d more than %d windings", list->primitiveNum, MAX_WINDING_LIST );
 						return;
 					}
 					// winding and brush didn't intersect, store the original winding
-					cm_outList->w[cm_outList->numWindings] = list->w[k];
-					cm_outList->numWindings++;
+					build->outList->w[build->outList->numWindings] = list->w[k];
+					build->outList->numWindings++;
 					chopped = false;
 					break;
 				}
 
 				if ( res == SIDE_CROSS ) {
-					if ( cm_tmpList->numWindings >= MAX_WINDING_LIST ) {
+					if ( build->tmpList->numWindings >= MAX_WINDING_LIST ) {
 						common->Warning( "idCollisionModelManagerLocal::ChopWindingWithBrush: primitive %d more than %d windings", list->primitiveNum, MAX_WINDING_LIST );
 						return;
 					}
 					// store the front winding in the temporary list
-					cm_tmpList->w[cm_tmpList->numWindings] = back;
-					cm_tmpList->numWindings++;
+					build->tmpList->w[build->tmpList->numWindings] = back;
+					build->tmpList->numWindings++;
 					chopped = true;
 				}
 
 				// if already found a start plane which generates less fragments
-				if ( cm_tmpList->numWindings >= bestNumWindings ) {
+				if ( build->tmpList->numWindings >= bestNumWindings ) {
 					break;
 				}
 			}
 
 			// find the best start plane to get the least number of fragments outside the brush
-			if ( cm_tmpList->numWindings < bestNumWindings ) {
-				bestNumWindings = cm_tmpList->numWindings;
+			if ( build->tmpList->numWindings < bestNumWindings ) {
+				bestNumWindings = build->tmpList->numWindings;
 				// store windings from temporary list in the out list
-				for ( i = 0; i < cm_tmpList->numWindings; i++ ) {
-					if ( cm_outList->numWindings + i >= MAX_WINDING_LIST ) {
+				for ( i = 0; i < build->tmpList->numWindings; i++ ) {
+					if ( build->outList->numWindings + i >= MAX_WINDING_LIST ) {
 						common->Warning( "idCollisionModelManagerLocal::ChopWindingWithBrush: primitive %d more than %d windings", list->primitiveNum, MAX_WINDING_LIST );
 						return;
 					}
-					cm_outList->w[cm_outList->numWindings+i] = cm_tmpList->w[i];
+					build->outList->w[build->outList->numWindings+i] = build->tmpList->w[i];
 				}
 				// if only one winding left then we can't do any better
 				if ( bestNumWindings == 1 ) {
@@ -1093,13 +1233,13 @@ void idCollisionModelManagerLocal::ChopWindingListWithBrush( cm_windingList_t *l
 		} while ( chopped && startPlane < b->numPlanes );
 		//
 		if ( chopped ) {
-			cm_outList->numWindings += bestNumWindings;
+			build->outList->numWindings += bestNumWindings;
 		}
 	}
-	for ( k = 0; k < cm_outList->numWindings; k++ ) {
-		list->w[k] = cm_outList->w[k];
+	for ( k = 0; k < build->outList->numWindings; k++ ) {
+		list->w[k] = build->outList->w[k];
 	}
-	list->numWindings = cm_outList->numWindings;
+	list->numWindings = build->outList->numWindings;
 }
 
 /*
@@ -1108,6 +1248,7 @@ idCollisionModelManagerLocal::R_ChopWindingListWithTreeBrushes
 ============
 */
 void idCollisionModelManagerLocal::R_ChopWindingListWithTreeBrushes( cm_windingList_t *list, cm_node_t *node ) {
+	cm_buildContext_t *build = GetBuildContext();
 	int i;
 	cm_brushRef_t *bref;
 	cm_brush_t *b;
@@ -1116,10 +1257,10 @@ void idCollisionModelManagerLocal::R_ChopWindingListWithTreeBrushes( cm_windingL
 		for ( bref = node->brushes; bref; bref = bref->next ) {
 			b = bref->b;
 			// if we checked this brush already
-			if ( b->checkcount == checkCount ) {
+			if ( b->checkcount == build->checkCount ) {
 				continue;
 			}
-			b->checkcount = checkCount;
+			b->checkcount = build->checkCount;
 			// if the windings in the list originate from this brush
 			if ( b->primitiveNum == list->primitiveNum ) {
 				continue;
@@ -1178,42 +1319,43 @@ idCollisionModelManagerLocal::WindingOutsideBrushes
 ============
 */
 idFixedWinding *idCollisionModelManagerLocal::WindingOutsideBrushes( idFixedWinding *w, const idPlane &plane, int contents, int primitiveNum, cm_node_t *headNode ) {
+	cm_buildContext_t *build = GetBuildContext();
 	int i, windingLeft;
 
-	cm_windingList->bounds.Clear();
+	build->windingList->bounds.Clear();
 	for ( i = 0; i < w->GetNumPoints(); i++ ) {
-		cm_windingList->bounds.AddPoint( (*w)[i].ToVec3() );
+		build->windingList->bounds.AddPoint( (*w)[i].ToVec3() );
 	}
 
-	cm_windingList->origin = (cm_windingList->bounds[1] - cm_windingList->bounds[0]) * 0.5;
-	cm_windingList->radius = cm_windingList->origin.Length() + CHOP_EPSILON;
-	cm_windingList->origin = cm_windingList->bounds[0] + cm_windingList->origin;
-	cm_windingList->bounds[0] -= idVec3( CHOP_EPSILON, CHOP_EPSILON, CHOP_EPSILON );
-	cm_windingList->bounds[1] += idVec3( CHOP_EPSILON, CHOP_EPSILON, CHOP_EPSILON );
+	build->windingList->origin = (build->windingList->bounds[1] - build->windingList->bounds[0]) * 0.5;
+	build->windingList->radius = build->windingList->origin.Length() + CHOP_EPSILON;
+	build->windingList->origin = build->windingList->bounds[0] + build->windingList->origin;
+	build->windingList->bounds[0] -= idVec3( CHOP_EPSILON, CHOP_EPSILON, CHOP_EPSILON );
+	build->windingList->bounds[1] += idVec3( CHOP_EPSILON, CHOP_EPSILON, CHOP_EPSILON );
 
-	cm_windingList->w[0] = *w;
-	cm_windingList->numWindings = 1;
-	cm_windingList->normal = plane.Normal();
-	cm_windingList->contents = contents;
-	cm_windingList->primitiveNum = primitiveNum;
+	build->windingList->w[0] = *w;
+	build->windingList->numWindings = 1;
+	build->windingList->normal = plane.Normal();
+	build->windingList->contents = contents;
+	build->windingList->primitiveNum = primitiveNum;
 	//
-	checkCount++;
-	R_ChopWindingListWithTreeBrushes( cm_windingList, headNode );
+	build->checkCount = checkCount.Increment();
+	R_ChopWindingListWithTreeBrushes( build->windingList, headNode );
 	//
-	if ( !cm_windingList->numWindings ) {
+	if ( !build->windingList->numWindings ) {
 		return NULL;
 	}
-	if ( cm_windingList->numWindings == 1 ) {
-		return &cm_windingList->w[0];
+	if ( build->windingList->numWindings == 1 ) {
+		return &build->windingList->w[0];
 	}
 	// if not the world model
-	if ( numModels != 0 ) {
+	if ( !build->worldModel ) {
 		return w;
 	}
 	// check if winding fragments would be chopped away by the proc BSP tree
 	windingLeft = -1;
-	for ( i = 0; i < cm_windingList->numWindings; i++ ) {
-		if ( !ChoppedAwayByProcBSP( cm_windingList->w[i], plane, contents ) ) {
+	for ( i = 0; i < build->windingList->numWindings; i++ ) {
+		if ( !ChoppedAwayByProcBSP( build->windingList->w[i], plane, contents ) ) {
 			if ( windingLeft >= 0 ) {
 				return w;
 			}
@@ -1221,7 +1363,7 @@ idFixedWinding *idCollisionModelManagerLocal::WindingOutsideBrushes( idFixedWind
 		}
 	}
 	if ( windingLeft >= 0 ) {
-		return &cm_windingList->w[windingLeft];
+		return &build->windingList->w[windingLeft];
 	}
 	return NULL;
 }
@@ -1304,7 +1446,7 @@ idCollisionModelManagerLocal::TryMergePolygons
 cm_polygon_t *idCollisionModelManagerLocal::TryMergePolygons( cm_model_t *model, cm_polygon_t *p1, cm_polygon_t *p2 ) {
 	int i, j, nexti, prevj;
 	int p1BeforeShare, p1AfterShare, p2BeforeShare, p2AfterShare;
-	int newEdges[CM_MAX_POLYGON_EDGES], newNumEdges;
+	int newEdges[CM_MAX_POLYGON_EDGES], newNumEdges, queryNum;
 	int edgeNum, edgeNum1, edgeNum2, newEdgeNum1, newEdgeNum2;
 	cm_edge_t *edge;
 	cm_polygon_t *newp;
@@ -1456,10 +1598,12 @@ cm_polygon_t *idCollisionModelManagerLocal::TryMergePolygons( cm_model_t *model,
 	}
 
 	newp = AllocPolygon( model, newNumEdges );
+	queryNum = newp->queryNum;
 	memcpy( newp, p1, sizeof(cm_polygon_t) );
 	memcpy( newp->edges, newEdges, newNumEdges * sizeof(int) );
 	newp->numEdges = newNumEdges;
 	newp->checkcount = 0;
+	newp->queryNum = queryNum;
 	// increase usage count for the edges of this polygon
 	for ( i = 0; i < newp->numEdges; i++ ) {
 		if ( !keep1 && newp->edges[i] == newEdgeNum1 ) {
@@ -1542,6 +1686,7 @@ idCollisionModelManagerLocal::MergeTreePolygons
 =============
 */
 void idCollisionModelManagerLocal::MergeTreePolygons( cm_model_t *model, cm_node_t *node ) {
+	cm_buildContext_t *build = GetBuildContext();
 	cm_polygonRef_t *pref;
 	cm_polygon_t *p;
 	bool merge;
@@ -1552,10 +1697,10 @@ void idCollisionModelManagerLocal::MergeTreePolygons( cm_model_t *model, cm_node
 			for ( pref = node->polygons; pref; pref = pref->next ) {
 				p = pref->p;
 				// if we checked this polygon already
-				if ( p->checkcount == checkCount ) {
+				if ( p->checkcount == build->checkCount ) {
 					continue;
 				}
-				p->checkcount = checkCount;
+				p->checkcount = build->checkCount;
 				// try to merge this polygon with other polygons in the tree
 				if ( MergePolygonWithTreePolygons( model, model->node, p ) ) {
 					merge = true;
@@ -1799,6 +1944,7 @@ idCollisionModelManagerLocal::FindInternalEdges
 =============
 */
 void idCollisionModelManagerLocal::FindInternalEdges( cm_model_t *model, cm_node_t *node ) {
+	cm_buildContext_t *build = GetBuildContext();
 	cm_polygonRef_t *pref;
 	cm_polygon_t *p;
 
@@ -1806,10 +1952,10 @@ void idCollisionModelManagerLocal::FindInternalEdges( cm_model_t *model, cm_node
 		for ( pref = node->polygons; pref; pref = pref->next ) {
 			p = pref->p;
 			// if we checked this polygon already
-			if ( p->checkcount == checkCount ) {
+			if ( p->checkcount == build->checkCount ) {
 				continue;
 			}
-			p->checkcount = checkCount;
+			p->checkcount = build->checkCount;
 
 			FindInternalPolygonEdges( model, model->node, p );
 
@@ -2174,32 +2320,174 @@ cm_node_t *idCollisionModelManagerLocal::CreateAxialBSPTree( cm_model_t *model,
 /*
 ===============================================================================
 
+Flattened spatial subdivision
+
+	After loading, the pointer linked BSP tree of a model is copied into a
+	node array laid out depth first, so the first child of a node directly
+	follows it in memory. The polygons and brushes referenced by each node are
+	stored contiguously in arrays that are walked in the same order as the
+	reference lists. The pointer tree is kept for debug drawing and writing.
+
+===============================================================================
+*/
+
+/*
+================
+CM_CountNodeData_r
+================
+*/
+static void CM_CountNodeData_r( const cm_node_t *node, int &numNodes, int &numPolygons, int &numBrushes ) {
+	const cm_polygonRef_t *pref;
+	const cm_brushRef_t *bref;
+
+	while ( node ) {
+		numNodes++;
+		for ( pref = node->polygons; pref; pref = pref->next ) {
+			numPolygons++;
+		}
+		for ( bref = node->brushes; bref; bref = bref->next ) {
+			numBrushes++;
+		}
+		if ( node->planeType == -1 ) {
+			break;
+		}
+		CM_CountNodeData_r( node->children[0], numNodes, numPolygons, numBrushes );
+		node = node->children[1];
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::BakeNode_r
+================
+*/
+int idCollisionModelManagerLocal::BakeNode_r( cm_model_t *model, const cm_node_t *node ) {
+	const cm_polygonRef_t *pref;
+	const cm_brushRef_t *bref;
+	cm_bakedNode_t *baked;
+	int nodeNum, child0, child1;
+
+	if ( !node ) {
+		return -1;
+	}
+
+	nodeNum = model->numBakedNodes++;
+	baked = &model->bakedNodes[nodeNum];
+	baked->planeType = node->planeType;
+	baked->planeDist = node->planeDist;
+	baked->children[0] = baked->children[1] = -1;
+
+	baked->firstPolygon = model->numBakedPolygons;
+	for ( pref = node->polygons; pref; pref = pref->next ) {
+		model->bakedPolygons[model->numBakedPolygons++] = pref->p;
+	}
+	baked->numPolygons = model->numBakedPolygons - baked->firstPolygon;
+
+	baked->firstBrush = model->numBakedBrushes;
+	for ( bref = node->brushes; bref; bref = bref->next ) {
+		model->bakedBrushes[model->numBakedBrushes++] = bref->b;
+	}
+	baked->numBrushes = model->numBakedBrushes - baked->firstBrush;
+
+	if ( node->planeType != -1 ) {
+		child0 = BakeNode_r( model, node->children[0] );
+		child1 = BakeNode_r( model, node->children[1] );
+		baked->children[0] = child0;
+		baked->children[1] = child1;
+	}
+	return nodeNum;
+}
+
+/*
+================
+idCollisionModelManagerLocal::BakeModel
+================
+*/
+void idCollisionModelManagerLocal::BakeModel( cm_model_t *model ) {
+	int numNodes, numPolygons, numBrushes;
+
+	FreeBakedModel( model );
+
+	if ( !cm_bakeModels.GetBool() || !model->node ) {
+		return;
+	}
+
+	numNodes = numPolygons = numBrushes = 0;
+	CM_CountNodeData_r( model->node, numNodes, numPolygons, numBrushes );
+
+	model->bakedNodes = (cm_bakedNode_t *) Mem_Alloc( numNodes * sizeof( cm_bakedNode_t ), TAG_COLLISION );
+	model->bakedPolygons = (cm_polygon_t **) Mem_Alloc( Max( numPolygons, 1 ) * sizeof( cm_polygon_t * ), TAG_COLLISION );
+	model->bakedBrushes = (cm_brush_t **) Mem_Alloc( Max( numBrushes, 1 ) * sizeof( cm_brush_t * ), TAG_COLLISION );
+
+	BakeNode_r( model, model->node );
+
+	assert( model->numBakedNodes == numNodes );
+	assert( model->numBakedPolygons == numPolygons );
+	assert( model->numBakedBrushes == numBrushes );
+}
+
+/*
+================
+idCollisionModelManagerLocal::FreeBakedModel
+================
+*/
+void idCollisionModelManagerLocal::FreeBakedModel( cm_model_t *model ) {
+	Mem_Free( model->bakedNodes );
+	Mem_Free( model->bakedPolygons );
+	Mem_Free( model->bakedBrushes );
+	model->numBakedNodes = 0;
+	model->bakedNodes = NULL;
+	model->numBakedPolygons = 0;
+	model->bakedPolygons = NULL;
+	model->numBakedBrushes = 0;
+	model->bakedBrushes = NULL;
+}
+
+/*
+===============================================================================
+
 Raw polygon and brush data
 
 ===============================================================================
 */
 
+/*
+================
+idCollisionModelManagerLocal::GetBuildContext
+
+  Returns the build context of the build job running on this thread, or the
+  first build context on threads outside the build jobs.
+================
+*/
+cm_buildContext_t *idCollisionModelManagerLocal::GetBuildContext() {
+	cm_buildContext_t *build = (cm_buildContext_t *) (ptrdiff_t) threadBuildContext;
+	if ( build == NULL ) {
+		build = &buildContexts[0];
+	}
+	return build;
+}
+
 /*
 ================
 idCollisionModelManagerLocal::SetupHash
 ================
 */
-void idCollisionModelManagerLocal::SetupHash() {
-	if ( !cm_vertexHash ) {
-		cm_vertexHash = new (TAG_COLLISION) idHashIndex( VERTEX_HASH_SIZE, 1024 );
+void idCollisionModelManagerLocal::SetupHash( cm_buildContext_t *build ) {
+	if ( !build->vertexHash ) {
+		build->vertexHash = new (TAG_COLLISION) idHashIndex( VERTEX_HASH_SIZE, 1024 );
 	}
-	if ( !cm_edgeHash ) {
-		cm_edgeHash = new (TAG_COLLISION) idHashIndex( EDGE_HASH_SIZE, 1024 );
+	if ( !build->edgeHash ) {
+		build->edgeHash = new (TAG_COLLISION) idHashIndex( EDGE_HASH_SIZE, 1024 );
 	}
 	// init variables used during loading and optimization
-	if ( !cm_windingList ) {
-		cm_windingList = new (TAG_COLLISION) cm_windingList_t;
+	if ( !build->windingList ) {
+		build->windingList = new (TAG_COLLISION) cm_windingList_t;
 	}
-	if ( !cm_outList ) {
-		cm_outList = new (TAG_COLLISION) cm_windingList_t;
+	if ( !build->outList ) {
+		build->outList = new (TAG_COLLISION) cm_windingList_t;
 	}
-	if ( !cm_tmpList ) {
-		cm_tmpList = new (TAG_COLLISION) cm_windingList_t;
+	if ( !build->tmpList ) {
+		build->tmpList = new (TAG_COLLISION) cm_windingList_t;
 	}
 }
 
@@ -2208,17 +2496,17 @@ void idCollisionModelManagerLocal::SetupHash() {
 idCollisionModelManagerLocal::ShutdownHash
 ================
 */
-void idCollisionModelManagerLocal::ShutdownHash() {
-	delete cm_vertexHash;
-	cm_vertexHash = NULL;
-	delete cm_edgeHash;
-	cm_edgeHash = NULL;
-	delete cm_tmpList;
-	cm_tmpList = NULL;
-	delete cm_outList;
-	cm_outList = NULL;
-	delete cm_windingList;
-	cm_windingList = NULL;
+void idCollisionModelManagerLocal::ShutdownHash( cm_buildContext_t *build ) {
+	delete build->vertexHash;
+	build->vertexHash = NULL;
+	delete build->edgeHash;
+	build->edgeHash = NULL;
+	delete build->tmpList;
+	build->tmpList = NULL;
+	delete build->outList;
+	build->outList = NULL;
+	delete build->windingList;
+	build->windingList = NULL;
 }
 
 /*
@@ -2227,26 +2515,27 @@ idCollisionModelManagerLocal::ClearHash
 ================
 */
 void idCollisionModelManagerLocal::ClearHash( idBounds &bounds ) {
+	cm_buildContext_t *build = GetBuildContext();
 	int i;
 	float f, max;
 
-	cm_vertexHash->Clear();
-	cm_edgeHash->Clear();
+	build->vertexHash->Clear();
+	build->edgeHash->Clear();
 
-	cm_modelBounds = bounds;
+	build->modelBounds = bounds;
 	max = bounds[1].x - bounds[0].x;
 	f = bounds[1].y - bounds[0].y;
 	if ( f > max ) {
 		max = f;
 	}
-	cm_vertexShift = (float) max / VERTEX_HASH_BOXSIZE;
-	for ( i = 0; (1<<i) < cm_vertexShift; i++ ) {
+	build->vertexShift = (float) max / VERTEX_HASH_BOXSIZE;
+	for ( i = 0; (1<<i) < build->vertexShift; i++ ) {
 	}
 	if ( i == 0 ) {
-		cm_vertexShift = 1;
+		build->vertexShift = 1;
 	}
 	else {
-		cm_vertexShift = i;
+		build->vertexShift = i;
 	}
 }
 
@@ -2256,11 +2545,12 @@ idCollisionModelManagerLocal::HashVec
 ================
 */
 ID_INLINE int idCollisionModelManagerLocal::HashVec(const idVec3 &vec) {
+	cm_buildContext_t *build = GetBuildContext();
 	/*
 	int x, y;
 
-	x = (((int)(vec[0] - cm_modelBounds[0].x + 0.5 )) >> cm_vertexShift) & (VERTEX_HASH_BOXSIZE-1);
-	y = (((int)(vec[1] - cm_modelBounds[0].y + 0.5 )) >> cm_vertexShift) & (VERTEX_HASH_BOXSIZE-1);
+	x = (((int)(vec[0] - build->modelBounds[0].x + 0.5 )) >> build->vertexShift) & (VERTEX_HASH_BOXSIZE-1);
+	y = (((int)(vec[1] - build->modelBounds[0].y + 0.5 )) >> build->vertexShift) & (VERTEX_HASH_BOXSIZE-1);
 
 	assert (x >= 0 && x < VERTEX_HASH_BOXSIZE && y >= 0 && y < VERTEX_HASH_BOXSIZE);
 
@@ -2268,9 +2558,9 @@ ID_INLINE int idCollisionModelManagerLocal::HashVec(const idVec3 &vec) {
 	*/
 	int x, y, z;
 
-	x = (((int) (vec[0] - cm_modelBounds[0].x + 0.5)) + 2) >> 2;
-	y = (((int) (vec[1] - cm_modelBounds[0].y + 0.5)) + 2) >> 2;
-	z = (((int) (vec[2] - cm_modelBounds[0].z + 0.5)) + 2) >> 2;
+	x = (((int) (vec[0] - build->modelBounds[0].x + 0.5)) + 2) >> 2;
+	y = (((int) (vec[1] - build->modelBounds[0].y + 0.5)) + 2) >> 2;
+	z = (((int) (vec[2] - build->modelBounds[0].z + 0.5)) + 2) >> 2;
 	return (x + y * VERTEX_HASH_BOXSIZE + z) & (VERTEX_HASH_SIZE-1);
 }
 
@@ -2280,6 +2570,7 @@ idCollisionModelManagerLocal::GetVertex
 ================
 */
 int idCollisionModelManagerLocal::GetVertex( cm_model_t *model, const idVec3 &v, int *vertexNum ) {
+	cm_buildContext_t *build = GetBuildContext();
 	int i, hashKey, vn;
 	idVec3 vert, *p;
 	
@@ -2292,7 +2583,7 @@ int idCollisionModelManagerLocal::GetVertex( cm_model_t *model, const idVec3 &v,
 
 	hashKey = HashVec( vert );
 
-	for (vn = cm_vertexHash->First( hashKey ); vn >= 0; vn = cm_vertexHash->Next( vn ) ) {
+	for (vn = build->vertexHash->First( hashKey ); vn >= 0; vn = build->vertexHash->Next( vn ) ) {
 		p = &model->vertices[vn].p;
 		// first compare z-axis because hash is based on x-y plane
 		if (idMath::Fabs(vert[2] - (*p)[2]) < VERTEX_EPSILON &&
@@ -2314,13 +2605,13 @@ int idCollisionModelManagerLocal::GetVertex( cm_model_t *model, const idVec3 &v,
 		memcpy( model->vertices, oldVertices, model->numVertices * sizeof(cm_vertex_t) );
 		Mem_Free( oldVertices );
 
-		cm_vertexHash->ResizeIndex( model->maxVertices );
+		build->vertexHash->ResizeIndex( model->maxVertices );
 	}
 	model->vertices[model->numVertices].p = vert;
 	model->vertices[model->numVertices].checkcount = 0;
 	*vertexNum = model->numVertices;
 	// add vertice to hash
-	cm_vertexHash->Add( hashKey, model->numVertices );
+	build->vertexHash->Add( hashKey, model->numVertices );
 	//
 	model->numVertices++;
 	return false;
@@ -2332,6 +2623,7 @@ idCollisionModelManagerLocal::GetEdge
 ================
 */
 int idCollisionModelManagerLocal::GetEdge( cm_model_t *model, const idVec3 &v1, const idVec3 &v2, int *edgeNum, int v1num ) {
+	cm_buildContext_t *build = GetBuildContext();
 	int v2num, hashKey, e;
 	int found, *vertexNum;
 
@@ -2352,10 +2644,10 @@ int idCollisionModelManagerLocal::GetEdge( cm_model_t *model, const idVec3 &v1,
 		*edgeNum = 0;
 		return true;
 	}
-	hashKey = cm_edgeHash->GenerateKey( v1num, v2num );
+	hashKey = build->edgeHash->GenerateKey( v1num, v2num );
 	// if both vertices where already stored
 	if (found) {
-		for (e = cm_edgeHash->First( hashKey ); e >= 0; e = cm_edgeHash->Next( e ) )
+		for (e = build->edgeHash->First( hashKey ); e >= 0; e = build->edgeHash->Next( e ) )
 		{
 			// NOTE: only allow at most two users that use the edge in opposite direction
 			if ( model->edges[e].numUsers != 1 ) {
@@ -2395,7 +2687,7 @@ int idCollisionModelManagerLocal::GetEdge( cm_model_t *model, const idVec3 &v1,
 		memcpy( model->edges, oldEdges, model->numEdges * sizeof(cm_edge_t) );
 		Mem_Free( oldEdges );
 
-		cm_edgeHash->ResizeIndex( model->maxEdges );
+		build->edgeHash->ResizeIndex( model->maxEdges );
 	}
 	// setup edge
 	model->edges[model->numEdges].vertexNum[0] = v1num;
@@ -2407,7 +2699,7 @@ int idCollisionModelManagerLocal::GetEdge( cm_model_t *model, const idVec3 &v1,
 	//
 	*edgeNum = model->numEdges;
 	// add edge to hash
-	cm_edgeHash->Add( hashKey, model->numEdges );
+	build->edgeHash->Add( hashKey, model->numEdges );
 
 	model->numEdges++;
 
@@ -2487,7 +2779,7 @@ void idCollisionModelManagerLocal::PolygonFromWinding( cm_model_t *model, idFixe
 	contents = material->GetContentFlags();
 
 	// if this polygon is part of the world model
-	if ( numModels == 0 ) {
+	if ( GetBuildContext()->worldModel ) {
 		// if the polygon is fully chopped away by the proc bsp tree
 		if ( ChoppedAwayByProcBSP( *w, plane, contents ) ) {
 			model->numRemovedPolys++;
@@ -2829,6 +3121,7 @@ idCollisionModelManagerLocal::RemapEdges
 ==================
 */
 void idCollisionModelManagerLocal::RemapEdges( cm_node_t *node, int *edgeRemap ) {
+	cm_buildContext_t *build = GetBuildContext();
 	cm_polygonRef_t *pref;
 	cm_polygon_t *p;
 	int i;
@@ -2837,10 +3130,10 @@ void idCollisionModelManagerLocal::RemapEdges( cm_node_t *node, int *edgeRemap )
 		for ( pref = node->polygons; pref; pref = pref->next ) {
 			p = pref->p;
 			// if we checked this polygon already
-			if ( p->checkcount == checkCount ) {
+			if ( p->checkcount == build->checkCount ) {
 				continue;
 			}
-			p->checkcount = checkCount;
+			p->checkcount = build->checkCount;
 			for ( i = 0; i < p->numEdges; i++ ) {
 				if ( p->edges[i] < 0 ) {
 					p->edges[i] = -edgeRemap[ abs(p->edges[i]) ];
@@ -2868,6 +3161,7 @@ idCollisionModelManagerLocal::OptimizeArrays
 ==================
 */
 void idCollisionModelManagerLocal::OptimizeArrays( cm_model_t *model ) {
+	cm_buildContext_t *build = GetBuildContext();
 	int i, newNumVertices, newNumEdges, *v;
 	int *remap;
 	cm_edge_t *oldEdges;
@@ -2907,7 +3201,7 @@ void idCollisionModelManagerLocal::OptimizeArrays( cm_model_t *model ) {
 		}
 	}
 	// change polygon edge indexes
-	checkCount++;
+	build->checkCount = checkCount.Increment();
 	RemapEdges( model->node, remap );
 	model->numEdges = newNumEdges;
 
@@ -2938,18 +3232,19 @@ idCollisionModelManagerLocal::FinishModel
 ================
 */
 void idCollisionModelManagerLocal::FinishModel( cm_model_t *model ) {
+	cm_buildContext_t *build = GetBuildContext();
 	// try to merge polygons
-	checkCount++;
+	build->checkCount = checkCount.Increment();
 	MergeTreePolygons( model, model->node );
 	// find internal edges (no mesh can ever collide with internal edges)
-	checkCount++;
+	build->checkCount = checkCount.Increment();
 	FindInternalEdges( model, model->node );
 	// calculate edge normals
-	checkCount++;
+	build->checkCount = checkCount.Increment();
 	CalculateEdgeNormals( model, model->node );
 
-	//common->Printf( "%s vertex hash spread is %d\n", model->name.c_str(), cm_vertexHash->GetSpread() );
-	//common->Printf( "%s edge hash spread is %d\n", model->name.c_str(), cm_edgeHash->GetSpread() );
+	//common->Printf( "%s vertex hash spread is %d\n", model->name.c_str(), build->vertexHash->GetSpread() );
+	//common->Printf( "%s edge hash spread is %d\n", model->name.c_str(), build->edgeHash->GetSpread() );
 
 	// remove all unused vertices and edges
 	OptimizeArrays( model );
@@ -3286,6 +3581,7 @@ cm_model_t *idCollisionModelManagerLocal::LoadRenderModel( const char *fileName
 	idBounds bounds;
 	bool collisionSurface;
 	idStr extension;
+	cm_buildContext_t *build;
 
 	// only load ASE and LWO models
 	idStr( fileName ).ExtractFileExtension( extension );
@@ -3349,10 +3645,12 @@ cm_model_t *idCollisionModelManagerLocal::LoadRenderModel( const char *fileName
 	model->edges = (cm_edge_t *) Mem_ClearedAlloc( model->maxEdges * sizeof(cm_edge_t), TAG_COLLISION );
 
 	// setup hash to speed up finding shared vertices and edges
-	SetupHash();
+	build = GetBuildContext();
+	SetupHash( build );
+	build->worldModel = ( numModels == 0 );
 
-	cm_vertexHash->ResizeIndex( model->maxVertices );
-	cm_edgeHash->ResizeIndex( model->maxEdges );
+	build->vertexHash->ResizeIndex( model->maxVertices );
+	build->edgeHash->ResizeIndex( model->maxEdges );
 
 	ClearHash( bounds );
 
@@ -3386,7 +3684,7 @@ cm_model_t *idCollisionModelManagerLocal::LoadRenderModel( const char *fileName
 	FinishModel( model );
 
 	// shutdown the hash
-	ShutdownHash();
+	ShutdownHash( build );
 
 	WriteBinaryModel( model, generatedFileName, sourceTimeStamp );
 
@@ -3404,6 +3702,7 @@ cm_model_t *idCollisionModelManagerLocal::CollisionModelForMapEntity( const idMa
 	idBounds bounds;
 	const char *name;
 	int i, brushCount;
+	cm_buildContext_t *build = GetBuildContext();
 
 	// if the entity has no primitives
 	if ( mapEnt->GetNumPrimitives() < 1 ) {
@@ -3415,7 +3714,7 @@ cm_model_t *idCollisionModelManagerLocal::CollisionModelForMapEntity( const idMa
 	if ( !name[0] ) {
 		mapEnt->epairs.GetString( "name", "", &name );
 		if ( !name[0] ) {
-			if ( !numModels ) {
+			if ( build->worldModel ) {
 				// first model is always the world
 				name = "worldMap";
 			}
@@ -3434,8 +3733,8 @@ cm_model_t *idCollisionModelManagerLocal::CollisionModelForMapEntity( const idMa
 	model->vertices = (cm_vertex_t *) Mem_ClearedAlloc( model->maxVertices * sizeof(cm_vertex_t), TAG_COLLISION );
 	model->edges = (cm_edge_t *) Mem_ClearedAlloc( model->maxEdges * sizeof(cm_edge_t), TAG_COLLISION );
 
-	cm_vertexHash->ResizeIndex( model->maxVertices );
-	cm_edgeHash->ResizeIndex( model->maxEdges );
+	build->vertexHash->ResizeIndex( model->maxVertices );
+	build->edgeHash->ResizeIndex( model->maxEdges );
 
 	model->name = name;
 	model->isConvex = false;
@@ -3524,6 +3823,8 @@ void idCollisionModelManagerLocal::PrintModelInfo( const cm_model_t *model ) {
 	common->Printf( "%6i nodes (%i KB)\n", model->numNodes, (model->numNodes * sizeof(cm_node_t))>>10 );
 	common->Printf( "%6i polygon refs (%i KB)\n", model->numPolygonRefs, (model->numPolygonRefs * sizeof(cm_polygonRef_t))>>10 );
 	common->Printf( "%6i brush refs (%i KB)\n", model->numBrushRefs, (model->numBrushRefs * sizeof(cm_brushRef_t))>>10 );
+	common->Printf( "%6i baked nodes (%i KB)\n", model->numBakedNodes, (model->numBakedNodes * sizeof(cm_bakedNode_t) +
+					( model->numBakedPolygons + model->numBakedBrushes ) * sizeof(void *))>>10 );
 	common->Printf( "%6i internal edges\n", model->numInternalEdges );
 	common->Printf( "%6i sharp edges\n", model->numSharpEdges );
 	common->Printf( "%6i contained polygons removed\n", model->numRemovedPolys );
@@ -3550,6 +3851,9 @@ void idCollisionModelManagerLocal::AccumulateModelInfo( cm_model_t *model ) {
 		model->brushMemory += models[i]->brushMemory;
 		model->numNodes += models[i]->numNodes;
 		model->numBrushRefs += models[i]->numBrushRefs;
+		model->numBakedNodes += models[i]->numBakedNodes;
+		model->numBakedPolygons += models[i]->numBakedPolygons;
+		model->numBakedBrushes += models[i]->numBakedBrushes;
 		model->numPolygonRefs += models[i]->numPolygonRefs;
 		model->numInternalEdges += models[i]->numInternalEdges;
 		model->numSharpEdges += models[i]->numSharpEdges;
@@ -3576,12 +3880,12 @@ void idCollisionModelManagerLocal::ModelInfo( cmHandle_t model ) {
 		common->Printf( "idCollisionModelManagerLocal::ModelInfo: invalid model handle\n" );
 		return;
 	}
-	if ( !models[model] ) {
+	if ( !QueryModel( model ) ) {
 		common->Printf( "idCollisionModelManagerLocal::ModelInfo: invalid model\n" );
 		return;
 	}
 
-	PrintModelInfo( models[model] );
+	PrintModelInfo( QueryModel( model ) );
 }
 
 /*
@@ -3600,6 +3904,145 @@ void idCollisionModelManagerLocal::ListModels() {
 	common->Printf( "%4d KB in %d models\n", (totalMemory>>10), numModels );
 }
 
+/*
+================
+CM_BuildModelsJob
+================
+*/
+static void CM_BuildModelsJob( cm_buildJob_t *job ) {
+	job->manager->BuildEntityModels( job );
+}
+
+REGISTER_PARALLEL_JOB( CM_BuildModelsJob, "CM_BuildModelsJob" );
+
+/*
+================
+idCollisionModelManagerLocal::BuildEntityModels
+
+  Each job claims map entities one at a time so the small inline models are
+  spread over the jobs that are not busy with the world model.
+================
+*/
+void idCollisionModelManagerLocal::BuildEntityModels( cm_buildJob_t *job ) {
+	const ptrdiff_t previousBuildContext = threadBuildContext;
+	threadBuildContext = (ptrdiff_t) job->context;
+
+	SetupHash( job->context );
+
+	while( 1 ) {
+		const int entityNum = job->nextEntity->Increment() - 1;
+		if ( entityNum >= job->mapFile->GetNumEntities() ) {
+			break;
+		}
+		const uint64 startTime = Sys_Microseconds();
+		job->context->worldModel = ( entityNum == job->worldEntity );
+		job->entityModels[entityNum] = CollisionModelForMapEntity( job->mapFile->GetEntity( entityNum ) );
+		job->entityMsec[entityNum] = ( Sys_Microseconds() - startTime ) * 0.001f;
+	}
+
+	threadBuildContext = previousBuildContext;
+}
+
+/*
+================
+idCollisionModelManagerLocal::PrecacheMaterials
+
+  Materials can only be parsed on the main thread, so all materials of the
+  map primitives are looked up before the build jobs are started.
+================
+*/
+void idCollisionModelManagerLocal::PrecacheMaterials( const idMapFile *mapFile ) {
+	for ( int i = 0; i < mapFile->GetNumEntities(); i++ ) {
+		const idMapEntity *mapEnt = mapFile->GetEntity( i );
+		for ( int j = 0; j < mapEnt->GetNumPrimitives(); j++ ) {
+			const idMapPrimitive *mapPrim = mapEnt->GetPrimitive( j );
+			if ( mapPrim->GetType() == idMapPrimitive::TYPE_BRUSH ) {
+				const idMapBrush *mapBrush = static_cast<const idMapBrush *>( mapPrim );
+				for ( int k = 0; k < mapBrush->GetNumSides(); k++ ) {
+					declManager->FindMaterial( mapBrush->GetSide( k )->GetMaterial() );
+				}
+			} else if ( mapPrim->GetType() == idMapPrimitive::TYPE_PATCH ) {
+				declManager->FindMaterial( static_cast<const idMapPatch *>( mapPrim )->GetMaterial() );
+			}
+		}
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::BuildModelsParallel
+
+  Converts the map entities to collision models on job threads. The models
+  are stored in map entity order so the handles are the same as with a
+  serial build.
+================
+*/
+void idCollisionModelManagerLocal::BuildModelsParallel( const idMapFile *mapFile ) {
+	const int numEntities = mapFile->GetNumEntities();
+
+	// the first entity with primitives is the world
+	int worldEntity = 0;
+	while ( worldEntity < numEntities && mapFile->GetEntity( worldEntity )->GetNumPrimitives() < 1 ) {
+		worldEntity++;
+	}
+
+	PrecacheMaterials( mapFile );
+
+	cm_model_t **entityModels = (cm_model_t **) Mem_ClearedAlloc( numEntities * sizeof( cm_model_t * ), TAG_COLLISION );
+	float *entityMsec = (float *) Mem_ClearedAlloc( numEntities * sizeof( float ), TAG_COLLISION );
+	idSysInterlockedInteger nextEntity;
+
+	// the first build context is left to the threads outside the build jobs
+	const int numJobs = Min( Min( numEntities, CM_MAX_BUILD_CONTEXTS - 1 ), Max( parallelJobManager->GetNumProcessingUnits(), 1 ) );
+	cm_buildJob_t jobs[CM_MAX_BUILD_CONTEXTS - 1];
+
+	idParallelJobList *jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, numJobs, 0, NULL );
+	for ( int i = 0; i < numJobs; i++ ) {
+		cm_buildJob_t &job = jobs[i];
+		job.manager = this;
+		job.context = &buildContexts[1 + i];
+		job.mapFile = mapFile;
+		job.worldEntity = worldEntity;
+		job.nextEntity = &nextEntity;
+		job.entityModels = entityModels;
+		job.entityMsec = entityMsec;
+		jobList->AddJob( (jobRun_t)CM_BuildModelsJob, &job );
+	}
+	jobList->Submit();
+	jobList->Wait();
+	parallelJobManager->FreeJobList( jobList );
+
+	for ( int i = 0; i < numJobs; i++ ) {
+		ShutdownHash( jobs[i].context );
+	}
+
+	float totalMsec = 0.0f;
+	int slowestEntity = -1;
+	for ( int i = 0; i < numEntities; i++ ) {
+		if ( !entityModels[i] ) {
+			continue;
+		}
+		if ( numModels >= MAX_SUBMODELS ) {
+			common->Error( "idCollisionModelManagerLocal::BuildModels: more than %d collision models", MAX_SUBMODELS );
+			break;
+		}
+		models[numModels++] = entityModels[i];
+
+		common->DPrintf( "%6.1f msec to build collision model %s\n", entityMsec[i], entityModels[i]->name.c_str() );
+		totalMsec += entityMsec[i];
+		if ( slowestEntity < 0 || entityMsec[i] > entityMsec[slowestEntity] ) {
+			slowestEntity = i;
+		}
+	}
+	if ( slowestEntity >= 0 ) {
+		common->Printf( "%.0f msec building %d collision models on %d jobs, slowest is %s with %.0f msec\n",
+						totalMsec, numModels, numJobs, entityModels[slowestEntity]->name.c_str(), entityMsec[slowestEntity] );
+	}
+
+	Mem_Free( entityModels );
+	Mem_Free( entityMsec );
+}
+
 /*
 ================
 idCollisionModelManagerLocal::BuildModels
@@ -3622,16 +4065,22 @@ void idCollisionModelManagerLocal::BuildModels( const idMapFile *mapFile ) {
 		LoadProcBSP( mapFile->GetName() );
 
 		// convert brushes and patches to collision data
-		for ( i = 0; i < mapFile->GetNumEntities(); i++ ) {
-			mapEnt = mapFile->GetEntity(i);
+		if ( cm_parallelBuild.GetBool() ) {
+			BuildModelsParallel( mapFile );
+		} else {
+			cm_buildContext_t *build = GetBuildContext();
+			for ( i = 0; i < mapFile->GetNumEntities(); i++ ) {
+				mapEnt = mapFile->GetEntity(i);
 
-			if ( numModels >= MAX_SUBMODELS ) {
-				common->Error( "idCollisionModelManagerLocal::BuildModels: more than %d collision models", MAX_SUBMODELS );
-				break;
-			}
-			models[numModels] = CollisionModelForMapEntity( mapEnt );
-			if ( models[ numModels] ) {
-				numModels++;
+				if ( numModels >= MAX_SUBMODELS ) {
+					common->Error( "idCollisionModelManagerLocal::BuildModels: more than %d collision models", MAX_SUBMODELS );
+					break;
+				}
+				build->worldModel = ( numModels == 0 );
+				models[numModels] = CollisionModelForMapEntity( mapEnt );
+				if ( models[ numModels] ) {
+					numModels++;
+				}
 			}
 		}
 
@@ -3643,6 +4092,11 @@ void idCollisionModelManagerLocal::BuildModels( const idMapFile *mapFile ) {
 		WriteCollisionModelsToFile( mapFile->GetName(), 0, numModels, mapFile->GetGeometryCRC() );
 	} 
 
+	// flatten the trees for tracing
+	for ( i = 0; i < numModels; i++ ) {
+		BakeModel( models[i] );
+	}
+
 	timer.Stop();
 
 	// print statistics on collision data
@@ -3675,6 +4129,20 @@ void idCollisionModelManagerLocal::Preload( const char *mapName ) {
 		common->Printf( "Preloading collision models...\n" );
 		int	start = Sys_Milliseconds();
 		int numLoaded = 0;
+
+		// read the binary models on job threads while the ones before them are baked
+		idStrList preloadFiles;
+		for ( int i = 0; i < manifest.NumResources(); i++ ) {
+			const preloadEntry_s & p = manifest.GetPreloadByIndex( i );
+			if ( p.resType == PRELOAD_COLLISION && FindModel( p.resourceName ) < 0 ) {
+				idStrStatic< MAX_OSPATH > generatedFileName = "generated/collision/";
+				generatedFileName.AppendPath( p.resourceName );
+				generatedFileName.SetFileExtension( CMODEL_BINARYFILE_EXT );
+				preloadFiles.Append( generatedFileName );
+			}
+		}
+		fileSystem->StartPreload( preloadFiles );
+
 		for ( int i = 0; i < manifest.NumResources(); i++ ) {
 			const preloadEntry_s & p = manifest.GetPreloadByIndex( i );
 			if ( p.resType == PRELOAD_COLLISION ) {
@@ -3682,6 +4150,7 @@ void idCollisionModelManagerLocal::Preload( const char *mapName ) {
 				numLoaded++;
 			}
 		}
+		fileSystem->StopPreload();
 		int	end = Sys_Milliseconds();
 		common->Printf( "%05d collision models preloaded ( or were already loaded ) in %5.1f seconds\n", numLoaded, ( end - start ) * 0.001 );
 		common->Printf( "----------------------------------------\n" );
@@ -3721,7 +4190,7 @@ void idCollisionModelManagerLocal::LoadMap( const idMapFile *mapFile ) {
 	models = (cm_model_t **) Mem_ClearedAlloc( (maxModels+1) * sizeof(cm_model_t *), TAG_COLLISION );
 
 	// setup hash to speed up finding shared vertices and edges
-	SetupHash();
+	SetupHash( GetBuildContext() );
 
 	common->UpdateLevelLoadPacifier();
 
@@ -3741,7 +4210,7 @@ void idCollisionModelManagerLocal::LoadMap( const idMapFile *mapFile ) {
 	loaded = true;
 
 	// shutdown the hash
-	ShutdownHash();
+	ShutdownHash( GetBuildContext() );
 }
 
 /*
@@ -3750,11 +4219,13 @@ idCollisionModelManagerLocal::GetModelName
 ===================
 */
 const char *idCollisionModelManagerLocal::GetModelName( cmHandle_t model ) const {
-	if ( model < 0 || model > MAX_SUBMODELS || model >= numModels || !models[model] ) {
+	if ( model < 0 || model > MAX_SUBMODELS || ( model >= numModels && model != TRACE_MODEL_HANDLE ) || !QueryModel( model ) ) {
 		common->Printf( "idCollisionModelManagerLocal::GetModelBounds: invalid model handle\n" );
 		return "";
 	}
-	return models[model]->name.c_str();
+
+	const cm_model_t *cm = QueryModel( model );
+	return cm->name.c_str();
 }
 
 /*
@@ -3764,12 +4235,14 @@ idCollisionModelManagerLocal::GetModelBounds
 */
 bool idCollisionModelManagerLocal::GetModelBounds( cmHandle_t model, idBounds &bounds ) const {
 
-	if ( model < 0 || model > MAX_SUBMODELS || model >= numModels || !models[model] ) {
+	if ( model < 0 || model > MAX_SUBMODELS || ( model >= numModels && model != TRACE_MODEL_HANDLE ) || !QueryModel( model ) ) {
 		common->Printf( "idCollisionModelManagerLocal::GetModelBounds: invalid model handle\n" );
 		return false;
 	}
 
-	bounds = models[model]->bounds;
+	const cm_model_t *cm = QueryModel( model );
+
+	bounds = cm->bounds;
 	return true;
 }
 
@@ -3779,12 +4252,14 @@ idCollisionModelManagerLocal::GetModelContents
 ===================
 */
 bool idCollisionModelManagerLocal::GetModelContents( cmHandle_t model, int &contents ) const {
-	if ( model < 0 || model > MAX_SUBMODELS || model >= numModels || !models[model] ) {
+	if ( model < 0 || model > MAX_SUBMODELS || ( model >= numModels && model != TRACE_MODEL_HANDLE ) || !QueryModel( model ) ) {
 		common->Printf( "idCollisionModelManagerLocal::GetModelContents: invalid model handle\n" );
 		return false;
 	}
 
-	contents = models[model]->contents;
+	const cm_model_t *cm = QueryModel( model );
+
+	contents = cm->contents;
 
 	return true;
 }
@@ -3795,17 +4270,19 @@ idCollisionModelManagerLocal::GetModelVertex
 ===================
 */
 bool idCollisionModelManagerLocal::GetModelVertex( cmHandle_t model, int vertexNum, idVec3 &vertex ) const {
-	if ( model < 0 || model > MAX_SUBMODELS || model >= numModels || !models[model] ) {
+	if ( model < 0 || model > MAX_SUBMODELS || ( model >= numModels && model != TRACE_MODEL_HANDLE ) || !QueryModel( model ) ) {
 		common->Printf( "idCollisionModelManagerLocal::GetModelVertex: invalid model handle\n" );
 		return false;
 	}
 
-	if ( vertexNum < 0 || vertexNum >= models[model]->numVertices ) {
+	const cm_model_t *cm = QueryModel( model );
+
+	if ( vertexNum < 0 || vertexNum >= cm->numVertices ) {
 		common->Printf( "idCollisionModelManagerLocal::GetModelVertex: invalid vertex number\n" );
 		return false;
 	}
 
-	vertex = models[model]->vertices[vertexNum].p;
+	vertex = cm->vertices[vertexNum].p;
 
 	return true;
 }
@@ -3816,19 +4293,21 @@ idCollisionModelManagerLocal::GetModelEdge
 ===================
 */
 bool idCollisionModelManagerLocal::GetModelEdge( cmHandle_t model, int edgeNum, idVec3 &start, idVec3 &end ) const {
-	if ( model < 0 || model > MAX_SUBMODELS || model >= numModels || !models[model] ) {
+	if ( model < 0 || model > MAX_SUBMODELS || ( model >= numModels && model != TRACE_MODEL_HANDLE ) || !QueryModel( model ) ) {
 		common->Printf( "idCollisionModelManagerLocal::GetModelEdge: invalid model handle\n" );
 		return false;
 	}
 
+	const cm_model_t *cm = QueryModel( model );
+
 	edgeNum = abs( edgeNum );
-	if ( edgeNum >= models[model]->numEdges ) {
+	if ( edgeNum >= cm->numEdges ) {
 		common->Printf( "idCollisionModelManagerLocal::GetModelEdge: invalid edge number\n" );
 		return false;
 	}
 
-	start = models[model]->vertices[models[model]->edges[edgeNum].vertexNum[0]].p;
-	end = models[model]->vertices[models[model]->edges[edgeNum].vertexNum[1]].p;
+	start = cm->vertices[cm->edges[edgeNum].vertexNum[0]].p;
+	end = cm->vertices[cm->edges[edgeNum].vertexNum[1]].p;
 
 	return true;
 }
@@ -3842,16 +4321,18 @@ bool idCollisionModelManagerLocal::GetModelPolygon( cmHandle_t model, int polygo
 	int i, edgeNum;
 	cm_polygon_t *poly;
 
-	if ( model < 0 || model > MAX_SUBMODELS || model >= numModels || !models[model] ) {
+	if ( model < 0 || model > MAX_SUBMODELS || ( model >= numModels && model != TRACE_MODEL_HANDLE ) || !QueryModel( model ) ) {
 		common->Printf( "idCollisionModelManagerLocal::GetModelPolygon: invalid model handle\n" );
 		return false;
 	}
 
+	const cm_model_t *cm = QueryModel( model );
+
 	poly = *reinterpret_cast<cm_polygon_t **>(&polygonNum);
 	winding.Clear();
 	for ( i = 0; i < poly->numEdges; i++ ) {
 		edgeNum = poly->edges[i];
-		winding += models[model]->vertices[ models[model]->edges[abs(edgeNum)].vertexNum[INT32_SIGNBITSET(edgeNum)] ].p;
+		winding += cm->vertices[ cm->edges[abs(edgeNum)].vertexNum[INT32_SIGNBITSET(edgeNum)] ].p;
 	}
 
 	return true;
@@ -3883,6 +4364,7 @@ cmHandle_t idCollisionModelManagerLocal::LoadModel( const char *modelName ) {
 
 	models[ numModels ] = LoadBinaryModel( generatedFileName, sourceTimeStamp );
 	if ( models[ numModels ] != NULL ) {
+		BakeModel( models[ numModels ] );
 		numModels++;
 		if ( cvarSystem->GetCVarBool( "fs_buildresources" ) ) {
 			// for resource gathering write this model to the preload file for this map
@@ -3892,7 +4374,11 @@ cmHandle_t idCollisionModelManagerLocal::LoadModel( const char *modelName ) {
 	}
 
 	// try to load a .cm file
+	const int firstModel = numModels;
 	if ( LoadCollisionModelFile( modelName, 0 ) ) {
+		for ( int i = firstModel; i < numModels; i++ ) {
+			BakeModel( models[i] );
+		}
 		handle = FindModel( modelName );
 		if ( handle >= 0  && handle < numModels ) {
 			cm_model_t * cm = models[ handle ];
@@ -3906,6 +4392,7 @@ cmHandle_t idCollisionModelManagerLocal::LoadModel( const char *modelName ) {
 	// try to load a .ASE or .LWO model and convert it to a collision model
 	models[ numModels ] = LoadRenderModel( modelName );
 	if ( models[ numModels ] != NULL ) {
+		BakeModel( models[ numModels ] );
 		numModels++;
 		return ( numModels - 1 );
 	}
@@ -3927,11 +4414,11 @@ bool idCollisionModelManagerLocal::TrmFromModel_r( idTraceModel &trm, cm_node_t
 		for ( pref = node->polygons; pref; pref = pref->next ) {
 			p = pref->p;
 
-			if ( p->checkcount == checkCount ) {
+			if ( p->checkcount == checkCount.GetValue() ) {
 				continue;
 			}
 
-			p->checkcount = checkCount;
+			p->checkcount = checkCount.GetValue();
 
 			if ( trm.numPolys >= MAX_TRACEMODEL_POLYS ) {
 				return false;
@@ -3989,7 +4476,7 @@ bool idCollisionModelManagerLocal::TrmFromModel( const cm_model_t *model, idTrac
 	trm.bounds.Clear();
 
 	// copy polygons
-	checkCount++;
+	checkCount.Increment();
 	if ( !TrmFromModel_r( trm, model->node ) ) {
 		common->Printf( "idCollisionModelManagerLocal::TrmFromModel: model %s has too many polygons.\n", model->name.c_str() );
 		PrintModelInfo( model );
@@ -4064,5 +4551,5 @@ bool idCollisionModelManagerLocal::TrmFromModel( const char *modelName, idTraceM
 		return false;
 	}
 
-	return TrmFromModel( models[ handle ], trm );
+	return TrmFromModel( QueryModel( handle ), trm );
 }
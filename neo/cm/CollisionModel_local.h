@@ -103,6 +103,7 @@ typedef struct cm_polygonBlock_s {
 typedef struct cm_polygon_s {
 	idBounds				bounds;				// polygon bounds
 	int						checkcount;			// for multi-check avoidance
+	int						queryNum;			// index into the per thread collision query state
 	int						contents;			// contents behind polygon
 	const idMaterial *		material;			// material
 	idPlane					plane;				// polygon plane
@@ -128,12 +129,14 @@ typedef struct cm_brushBlock_s {
 typedef struct cm_brush_s {
 	cm_brush_s() {
 		checkcount = 0;
+		queryNum = 0;
 		contents = 0;
 		material = NULL;
 		primitiveNum = 0;
 		numPlanes = 0;
 	}
 	int						checkcount;			// for multi-check avoidance
+	int						queryNum;			// index into the per thread collision query state
 	idBounds				bounds;				// brush bounds
 	int						contents;			// contents of brush
 	const idMaterial *		material;			// material
@@ -166,6 +169,16 @@ typedef struct cm_nodeBlock_s {
 	struct cm_nodeBlock_s *next;				// next block with nodes
 } cm_nodeBlock_t;
 
+typedef struct cm_bakedNode_s {
+	int						planeType;			// node axial plane type, -1 for leaf nodes
+	float					planeDist;			// node plane distance
+	int						children[2];		// indexes into the baked node array, -1 if no child
+	int						firstPolygon;		// first polygon of this node in the baked polygon array
+	int						numPolygons;		// number of polygons in node
+	int						firstBrush;			// first brush of this node in the baked brush array
+	int						numBrushes;			// number of brushes in node
+} cm_bakedNode_t;
+
 typedef struct cm_model_s {
 	idStr					name;				// model name
 	idBounds				bounds;				// model bounds
@@ -179,12 +192,22 @@ typedef struct cm_model_s {
 	int						numEdges;			// number of edges
 	cm_edge_t *				edges;				// array with all edges used by the model
 	cm_node_t *				node;				// first node of spatial subdivision
+	// spatial subdivision flattened into arrays for tracing, NULL if not baked
+	int						numBakedNodes;
+	cm_bakedNode_t *		bakedNodes;			// nodes laid out depth first
+	int						numBakedPolygons;
+	cm_polygon_t **			bakedPolygons;		// polygons of each node stored contiguously
+	int						numBakedBrushes;
+	cm_brush_t **			bakedBrushes;		// brushes of each node stored contiguously
 	// blocks with allocated memory
 	cm_nodeBlock_t *		nodeBlocks;			// list with blocks of nodes
 	cm_polygonRefBlock_t *	polygonRefBlocks;	// list with blocks of polygon references
 	cm_brushRefBlock_t *	brushRefBlocks;		// list with blocks of brush references
 	cm_polygonBlock_t *		polygonBlock;		// memory block with all polygons
 	cm_brushBlock_t *		brushBlock;			// memory block with all brushes
+	// per thread collision query state
+	int						numPolygonQueryNums;	// number of query numbers handed out to polygons
+	int						numBrushQueryNums;	// number of query numbers handed out to brushes
 	// statistics
 	int						numPolygons;
 	int						polygonMemory;
@@ -239,6 +262,7 @@ typedef struct cm_trmPolygon_s {
 } cm_trmPolygon_t;
 
 typedef struct cm_traceWork_s {
+	struct cm_traceContext_s *context;				// query state of the thread running the trace
 	int numVerts;
 	cm_trmVertex_t vertices[MAX_TRACEMODEL_VERTS];	// trm vertices
 	int numEdges;
@@ -287,6 +311,103 @@ typedef struct cm_traceWork_s {
 /*
 ===============================================================================
 
+Per thread collision query state
+
+	Each thread that issues collision queries gets its own trace context so
+	traces can run concurrently. The check counts and sidedness caches that
+	used to be stored in the model vertices, edges, polygons and brushes are
+	stored per context instead, indexed by vertex number, edge number and the
+	polygon and brush query numbers. The collision model data itself is only
+	read while tracing.
+
+===============================================================================
+*/
+
+#define CM_MAX_TRACE_CONTEXTS				8
+
+typedef struct cm_queryState_s {
+	int checkcount;									// for multi-check avoidance
+	unsigned long side;								// sidedness bits, see cm_vertex_t and cm_edge_t
+	unsigned long sideSet;							// each bit tells if the sidedness has been calculated yet
+} cm_queryState_t;
+
+typedef struct cm_traceContext_s {
+	ALIGN16( cm_traceWork_t translationWork );		// trace work for translations
+	ALIGN16( cm_traceWork_t rotationWork );			// trace work for rotations
+	int checkCount;									// for multi-check avoidance
+	int maxVertexStates;
+	cm_queryState_t *vertexStates;					// query state for each model vertex
+	int maxEdgeStates;
+	cm_queryState_t *edgeStates;					// query state for each model edge
+	int maxPolygonChecks;
+	int *polygonChecks;								// check count for each model polygon query number
+	int maxBrushChecks;
+	int *brushChecks;								// check count for each model brush query number
+	cm_model_t *trmModel;							// trace model converted to a collision model
+	cm_polygonRef_t *trmPolygons[MAX_TRACEMODEL_POLYS];
+	cm_brushRef_t *trmBrushes[1];
+	bool getContacts;								// for retrieving contact points
+	contactInfo_t *contacts;
+	int maxContacts;
+	int numContacts;
+} cm_traceContext_t;
+
+ID_INLINE cm_queryState_t *CM_VertexState( const cm_traceWork_t *tw, const cm_vertex_t *v ) {
+	return &tw->context->vertexStates[v - tw->model->vertices];
+}
+
+ID_INLINE cm_queryState_t *CM_EdgeState( const cm_traceWork_t *tw, const cm_edge_t *edge ) {
+	return &tw->context->edgeStates[edge - tw->model->edges];
+}
+
+ID_INLINE int &CM_PolygonCheck( const cm_traceWork_t *tw, const cm_polygon_t *p ) {
+	return tw->context->polygonChecks[p->queryNum];
+}
+
+ID_INLINE int &CM_BrushCheck( const cm_traceWork_t *tw, const cm_brush_t *b ) {
+	return tw->context->brushChecks[b->queryNum];
+}
+
+/*
+===============================================================================
+
+Per thread collision model build state
+
+	Converting map entities to collision models uses winding lists and vertex
+	and edge hashes as scratch memory. Each build job has its own build context
+	so the models of a map can be built concurrently. Threads outside the build
+	jobs use the first build context.
+
+===============================================================================
+*/
+
+#define CM_MAX_BUILD_CONTEXTS				8
+
+typedef struct cm_buildContext_s {
+	cm_windingList_t *windingList;
+	cm_windingList_t *outList;
+	cm_windingList_t *tmpList;
+	idHashIndex *vertexHash;						// hash to find shared vertices
+	idHashIndex *edgeHash;							// hash to find shared edges
+	idBounds modelBounds;							// bounds of the model used for hashing
+	int vertexShift;
+	int checkCount;									// for multi-check avoidance on the model being built
+	bool worldModel;								// set while building the world model, which is pruned with the proc BSP tree
+} cm_buildContext_t;
+
+typedef struct cm_buildJob_s {
+	class idCollisionModelManagerLocal *manager;
+	cm_buildContext_t *context;						// build context owned by this job
+	const idMapFile *mapFile;
+	int worldEntity;								// first map entity with primitives
+	idSysInterlockedInteger *nextEntity;			// next map entity to be converted, shared by all jobs
+	cm_model_t **entityModels;						// collision model for each map entity
+	float *entityMsec;								// build time for each map entity
+} cm_buildJob_t;
+
+/*
+===============================================================================
+
 Collision Map
 
 ===============================================================================
@@ -352,6 +473,8 @@ public:
 	void			ListModels();
 	// write a collision model file for the map entity
 	bool			WriteCollisionModelForMapEntity( const idMapEntity *mapEnt, const char *filename, const bool testTraceModel = true );
+	// converts map entities to collision models until all entities are claimed, run by the build jobs
+	void			BuildEntityModels( cm_buildJob_t *job );
 
 private:			// CollisionMap_translate.cpp
 	int				TranslateEdgeThroughEdge( idVec3 &cross, idPluecker &l1, idPluecker &l2, float *fraction );
@@ -404,6 +527,9 @@ private:			// CollisionMap_contents.cpp
 private:			// CollisionMap_trace.cpp
 	void			TraceTrmThroughNode( cm_traceWork_t *tw, cm_node_t *node );
 	void			TraceThroughAxialBSPTree_r( cm_traceWork_t *tw, cm_node_t *node, float p1f, float p2f, idVec3 &p1, idVec3 &p2);
+	void			TraceTrmThroughBakedNode( cm_traceWork_t *tw, const cm_bakedNode_t *node );
+	void			TraceThroughBakedBSPTree_r( cm_traceWork_t *tw, int nodeNum, float p1f, float p2f, idVec3 &p1, idVec3 &p2 );
+	void			TraceThroughSubdivision( cm_traceWork_t *tw, idVec3 &start, idVec3 &end );
 	void			TraceThroughModel( cm_traceWork_t *tw );
 	void			RecurseProcBSP_r( trace_t *results, int parentNodeNum, int nodeNum, float p1f, float p2f, const idVec3 &p1, const idVec3 &p2 );
 
@@ -450,13 +576,24 @@ private:			// CollisionMap_load.cpp
 	void			AddPolygonToNode( cm_model_t *model, cm_node_t *node, cm_polygon_t *p );
 	void			AddBrushToNode( cm_model_t *model, cm_node_t *node, cm_brush_t *b );
 	void			SetupTrmModelStructure();
+					// per thread collision query state
+	cm_traceContext_t *GetTraceContext();
+	void			PrepareTraceContext( cm_traceContext_t *context, const cm_model_t *model );
+	cm_model_t *	QueryModel( cm_traceContext_t *context, cmHandle_t model ) const;
+	cm_model_t *	QueryModel( cmHandle_t model ) const;
+	void			FreeTraceContexts();
 	void			R_FilterPolygonIntoTree( cm_model_t *model, cm_node_t *node, cm_polygonRef_t *pref, cm_polygon_t *p );
 	void			R_FilterBrushIntoTree( cm_model_t *model, cm_node_t *node, cm_brushRef_t *pref, cm_brush_t *b );
 	cm_node_t *		R_CreateAxialBSPTree( cm_model_t *model, cm_node_t *node, const idBounds &bounds );
 	cm_node_t *		CreateAxialBSPTree( cm_model_t *model, cm_node_t *node );
+					// flattened spatial subdivision
+	void			BakeModel( cm_model_t *model );
+	int				BakeNode_r( cm_model_t *model, const cm_node_t *node );
+	void			FreeBakedModel( cm_model_t *model );
 					// creation of raw polygons
-	void			SetupHash();
-	void			ShutdownHash();
+	cm_buildContext_t *GetBuildContext();
+	void			SetupHash( cm_buildContext_t *build );
+	void			ShutdownHash( cm_buildContext_t *build );
 	void			ClearHash( idBounds &bounds );
 	int				HashVec(const idVec3 &vec);
 	int				GetVertex( cm_model_t *model, const idVec3 &v, int *vertexNum );
@@ -473,6 +610,8 @@ private:			// CollisionMap_load.cpp
 	void			RemapEdges( cm_node_t *node, int *edgeRemap );
 	void			OptimizeArrays( cm_model_t *model );
 	void			FinishModel( cm_model_t *model );
+	void			PrecacheMaterials( const idMapFile *mapFile );
+	void			BuildModelsParallel( const idMapFile *mapFile );
 	void			BuildModels( const idMapFile *mapFile );
 	cmHandle_t		FindModel( const char *name );
 	cm_model_t *	CollisionModelForMapEntity( const idMapEntity *mapEnt );	// brush/patch model from .map
@@ -515,25 +654,25 @@ private:			// collision map data
 	idStr			mapName;
 	ID_TIME_T			mapFileTime;
 	int				loaded;
-					// for multi-check avoidance
-	int				checkCount;
+					// for multi-check avoidance while building and writing models, shared by the build jobs
+	idSysInterlockedInteger checkCount;
 					// models
 	int				maxModels;
 	int				numModels;
 	cm_model_t **	models;
-					// polygons and brush for trm model
-	cm_polygonRef_t*trmPolygons[MAX_TRACEMODEL_POLYS];
-	cm_brushRef_t *	trmBrushes[1];
+					// material for trm model polygons
 	const idMaterial *trmMaterial;
 					// for data pruning
 	int				numProcNodes;
 	cm_procNode_t *	procNodes;
-					// for retrieving contact points
-	bool			getContacts;
-	contactInfo_t *	contacts;
-	int				maxContacts;
-	int				numContacts;
+					// query state for each thread issuing collision queries
+	cm_traceContext_t traceContexts[CM_MAX_TRACE_CONTEXTS];
+	idSysInterlockedInteger numTraceContexts;
+					// scratch state for building models
+	cm_buildContext_t buildContexts[CM_MAX_BUILD_CONTEXTS];
 };
 
 // for debugging
 extern idCVar cm_debugCollision;
+extern idCVar cm_bakeModels;
+extern idCVar cm_parallelBuild;
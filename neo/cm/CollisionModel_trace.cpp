@@ -209,6 +209,181 @@ void idCollisionModelManagerLocal::TraceThroughAxialBSPTree_r( cm_traceWork_t *t
 	idCollisionModelManagerLocal::TraceThroughAxialBSPTree_r( tw, node->children[side^1], midf, p2f, mid, p2 );
 }
 
+/*
+================
+idCollisionModelManagerLocal::TraceTrmThroughBakedNode
+================
+*/
+void idCollisionModelManagerLocal::TraceTrmThroughBakedNode( cm_traceWork_t *tw, const cm_bakedNode_t *node ) {
+	cm_polygon_t **polygons;
+	cm_brush_t **brushes;
+	int i;
+
+	polygons = tw->model->bakedPolygons + node->firstPolygon;
+	brushes = tw->model->bakedBrushes + node->firstBrush;
+
+	// position test
+	if ( tw->positionTest ) {
+		// if already stuck in solid
+		if ( tw->trace.fraction == 0.0f ) {
+			return;
+		}
+		// test if any of the trm vertices is inside a brush
+		for ( i = 0; i < node->numBrushes; i++ ) {
+			if ( idCollisionModelManagerLocal::TestTrmVertsInBrush( tw, brushes[i] ) ) {
+				return;
+			}
+		}
+		// if just testing a point we're done
+		if ( tw->pointTrace ) {
+			return;
+		}
+		// test if the trm is stuck in any polygons
+		for ( i = 0; i < node->numPolygons; i++ ) {
+			if ( idCollisionModelManagerLocal::TestTrmInPolygon( tw, polygons[i] ) ) {
+				return;
+			}
+		}
+	}
+	else if ( tw->rotation ) {
+		// rotate through all polygons in this leaf
+		for ( i = 0; i < node->numPolygons; i++ ) {
+			if ( idCollisionModelManagerLocal::RotateTrmThroughPolygon( tw, polygons[i] ) ) {
+				return;
+			}
+		}
+	}
+	else {
+		// trace through all polygons in this leaf
+		for ( i = 0; i < node->numPolygons; i++ ) {
+			if ( idCollisionModelManagerLocal::TranslateTrmThroughPolygon( tw, polygons[i] ) ) {
+				return;
+			}
+		}
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::TraceThroughBakedBSPTree_r
+
+  same as TraceThroughAxialBSPTree_r but walks the flattened node array
+================
+*/
+void idCollisionModelManagerLocal::TraceThroughBakedBSPTree_r( cm_traceWork_t *tw, int nodeNum, float p1f, float p2f, idVec3 &p1, idVec3 &p2 ) {
+	float		t1, t2, offset;
+	float		frac, frac2;
+	float		idist;
+	idVec3		mid;
+	int			side;
+	float		midf;
+	const cm_bakedNode_t *node;
+
+	if ( nodeNum < 0 ) {
+		return;
+	}
+
+	if ( tw->quickExit ) {
+		return;		// stop immediately
+	}
+
+	if ( tw->trace.fraction <= p1f ) {
+		return;		// already hit something nearer
+	}
+
+	node = &tw->model->bakedNodes[nodeNum];
+
+	// if we need to test this node for collisions
+	if ( node->numPolygons || (tw->positionTest && node->numBrushes) ) {
+		// trace through node with collision data
+		idCollisionModelManagerLocal::TraceTrmThroughBakedNode( tw, node );
+	}
+	// if already stuck in solid
+	if ( tw->positionTest && tw->trace.fraction == 0.0f ) {
+		return;
+	}
+	// if this is a leaf node
+	if ( node->planeType == -1 ) {
+		return;
+	}
+	// distance from plane for trace start and end
+	t1 = p1[node->planeType] - node->planeDist;
+	t2 = p2[node->planeType] - node->planeDist;
+	// adjust the plane distance appropriately for mins/maxs
+	offset = tw->extents[node->planeType];
+	// see which sides we need to consider
+	if ( t1 >= offset && t2 >= offset ) {
+		idCollisionModelManagerLocal::TraceThroughBakedBSPTree_r( tw, node->children[0], p1f, p2f, p1, p2 );
+		return;
+	}
+
+	if ( t1 < -offset && t2 < -offset ) {
+		idCollisionModelManagerLocal::TraceThroughBakedBSPTree_r( tw, node->children[1], p1f, p2f, p1, p2 );
+		return;
+	}
+
+	if ( t1 < t2 ) {
+		idist = 1.0f / (t1-t2);
+		side = 1;
+		frac2 = (t1 + offset) * idist;
+		frac = (t1 - offset) * idist;
+	} else if (t1 > t2) {
+		idist = 1.0f / (t1-t2);
+		side = 0;
+		frac2 = (t1 - offset) * idist;
+		frac = (t1 + offset) * idist;
+	} else {
+		side = 0;
+		frac = 1.0f;
+		frac2 = 0.0f;
+	}
+
+	// move up to the node
+	if ( frac < 0.0f ) {
+		frac = 0.0f;
+	}
+	else if ( frac > 1.0f ) {
+		frac = 1.0f;
+	}
+
+	midf = p1f + (p2f - p1f)*frac;
+
+	mid[0] = p1[0] + frac*(p2[0] - p1[0]);
+	mid[1] = p1[1] + frac*(p2[1] - p1[1]);
+	mid[2] = p1[2] + frac*(p2[2] - p1[2]);
+
+	idCollisionModelManagerLocal::TraceThroughBakedBSPTree_r( tw, node->children[side], p1f, midf, p1, mid );
+
+	// go past the node
+	if ( frac2 < 0.0f ) {
+		frac2 = 0.0f;
+	}
+	else if ( frac2 > 1.0f ) {
+		frac2 = 1.0f;
+	}
+
+	midf = p1f + (p2f - p1f)*frac2;
+
+	mid[0] = p1[0] + frac2*(p2[0] - p1[0]);
+	mid[1] = p1[1] + frac2*(p2[1] - p1[1]);
+	mid[2] = p1[2] + frac2*(p2[2] - p1[2]);
+
+	idCollisionModelManagerLocal::TraceThroughBakedBSPTree_r( tw, node->children[side^1], midf, p2f, mid, p2 );
+}
+
+/*
+================
+idCollisionModelManagerLocal::TraceThroughSubdivision
+================
+*/
+void idCollisionModelManagerLocal::TraceThroughSubdivision( cm_traceWork_t *tw, idVec3 &start, idVec3 &end ) {
+	if ( tw->model->bakedNodes && cm_bakeModels.GetBool() ) {
+		idCollisionModelManagerLocal::TraceThroughBakedBSPTree_r( tw, 0, 0, 1, start, end );
+	} else {
+		idCollisionModelManagerLocal::TraceThroughAxialBSPTree_r( tw, tw->model->node, 0, 1, start, end );
+	}
+}
+
 /*
 ================
 idCollisionModelManagerLocal::TraceThroughModel
@@ -222,7 +397,7 @@ void idCollisionModelManagerLocal::TraceThroughModel( cm_traceWork_t *tw ) {
 
 	if ( !tw->rotation ) {
 		// trace through spatial subdivision and then through leafs
-		idCollisionModelManagerLocal::TraceThroughAxialBSPTree_r( tw, tw->model->node, 0, 1, tw->start, tw->end );
+		idCollisionModelManagerLocal::TraceThroughSubdivision( tw, tw->start, tw->end );
 	}
 	else {
 		// approximate the rotation with a series of straight line movements
@@ -240,7 +415,7 @@ void idCollisionModelManagerLocal::TraceThroughModel( cm_traceWork_t *tw ) {
 				rot.Set( tw->origin, tw->axis, tw->angle * ((float) (i+1) / numSteps) );
 				end = start * rot;
 				// trace through spatial subdivision and then through leafs
-				idCollisionModelManagerLocal::TraceThroughAxialBSPTree_r( tw, tw->model->node, 0, 1, start, end );
+				idCollisionModelManagerLocal::TraceThroughSubdivision( tw, start, end );
 				// no need to continue if something was hit already
 				if ( tw->trace.fraction < 1.0f ) {
 					return;
@@ -252,6 +427,6 @@ void idCollisionModelManagerLocal::TraceThroughModel( cm_traceWork_t *tw ) {
 			start = tw->start;
 		}
 		// last step of the approximation
-		idCollisionModelManagerLocal::TraceThroughAxialBSPTree_r( tw, tw->model->node, 0, 1, start, tw->end );
+		idCollisionModelManagerLocal::TraceThroughSubdivision( tw, start, tw->end );
 	}
 }
@@ -1489,7 +1489,6 @@ idActor::CanSee
 =====================
 */
 bool idActor::CanSee( idEntity *ent, bool useFov ) const {
-	trace_t		tr;
 	idVec3		eye;
 	idVec3		toPos;
 
@@ -1509,12 +1508,7 @@ bool idActor::CanSee( idEntity *ent, bool useFov ) const {
 
 	eye = GetEyePosition();
 
-	gameLocal.clip.TracePoint( tr, eye, toPos, MASK_OPAQUE, this );
-	if ( tr.fraction >= 1.0f || ( gameLocal.GetTraceEntity( tr ) == ent ) ) {
-		return true;
-	}
-
-	return false;
+	return gameLocal.visibility.LineOfSight( eye, toPos, MASK_OPAQUE, this, ent );
 }
 
 /*
@@ -220,6 +220,7 @@ void idGameLocal::Clear() {
 	testFx = NULL;
 	clip.Shutdown();
 	pvs.Shutdown();
+	visibility.Shutdown();
 	sessionCommand.Clear();
 	locationEntities = NULL;
 	smokeParticles = NULL;
@@ -322,6 +323,9 @@ void idGameLocal::Init() {
 	idEvent::Init();
 	idClass::Init();
 
+	idPhysics_AF::InitParallelJobs();
+	animationLib.Init();
+
 	InitConsoleCommands();
 
 	shellHandler = new (TAG_SWF) idMenuHandler_Shell();
@@ -390,6 +394,8 @@ void idGameLocal::Shutdown() {
 
 	idAI::FreeObstacleAvoidanceNodes();
 
+	idPhysics_AF::ShutdownParallelJobs();
+
 	idEvent::Shutdown();
 
 	delete[] locationEntities;
@@ -974,6 +980,7 @@ void idGameLocal::LoadMap( const char * mapName, int randseed ) {
 	common->UpdateLevelLoadPacifier();
 
 	pvs.Init();
+	visibility.Init();
 
 	common->UpdateLevelLoadPacifier();
 
@@ -1523,12 +1530,16 @@ void idGameLocal::MapShutdown() {
 	}
 
 	pvs.Shutdown();
+	visibility.Shutdown();
 
 	common->UpdateLevelLoadPacifier();
 
 	clip.Shutdown();
 	idClipModel::ClearTraceModelCache();
 
+	// the AAS files are reloaded for the next map
+	idAI::FreeObstacleAvoidanceNodes();
+
 	common->UpdateLevelLoadPacifier();
 
 	collisionModelManager->FreeMap();		// Fixes an issue where when maps were reloaded the materials wouldn't get their surfaceFlags re-set.  Now we free the map collision model forcing materials to be reparsed.
@@ -2124,6 +2135,123 @@ const idVec3 &idGameLocal::GetGravity() const {
 	return gravity;
 }
 
+/*
+================
+ThinksWithRagdollPhysics
+
+  Returns true if the next think of the entity runs the physics of its articulated
+  figure and does not change the figure before doing so.
+================
+*/
+static bool ThinksWithRagdollPhysics( idEntity *ent ) {
+	if ( !( ent->thinkFlags & TH_PHYSICS ) || ent->GetPhysics() == NULL || !ent->GetPhysics()->IsType( idPhysics_AF::Type ) ) {
+		return false;
+	}
+
+	// the other team parts are evaluated after the figure so they can't move or block before it
+	if ( ent->GetTeamMaster() != NULL ) {
+		if ( ent->GetTeamMaster() != ent ) {
+			return false;
+		}
+		for ( idEntity *part = ent->GetNextTeamEntity(); part != NULL; part = part->GetNextTeamEntity() ) {
+			if ( part->GetPhysics() != NULL && !part->GetPhysics()->IsType( idPhysics_Static::Type ) ) {
+				return false;
+			}
+		}
+	}
+
+	if ( ent->IsType( idAFEntity_Gibbable::Type ) ) {
+		return true;
+	}
+	if ( ent->IsType( idAI::Type ) ) {
+		return static_cast<idAI *>( ent )->ThinksAsRagdoll();
+	}
+	return false;
+}
+
+/*
+================
+idGameLocal::GetParallelArticulatedFigures
+================
+*/
+void idGameLocal::GetParallelArticulatedFigures( idList<idPhysics_AF *> &figures ) {
+	figures.SetNum( 0 );
+	for ( idEntity *ent = activeEntities.Next(); ent != NULL; ent = ent->activeNode.Next() ) {
+		if ( ent->timeGroup != TIME_GROUP1 || !ThinksWithRagdollPhysics( ent ) ) {
+			continue;
+		}
+		idPhysics_AF *af = static_cast<idPhysics_AF *>( ent->GetPhysics() );
+		if ( af->CanEvaluateInParallel() ) {
+			figures.Append( af );
+		}
+	}
+}
+
+/*
+================
+idGameLocal::EvaluateRagdollsInParallel
+
+  Evaluates the articulated figures of the ragdolls before any entity thinks.
+  The constraints of the figures are solved in parallel on the job threads,
+  everything else runs in the order of the active entity list.
+================
+*/
+void idGameLocal::EvaluateRagdollsInParallel() {
+	idList<idPhysics_AF *> figures;
+
+	if ( !af_parallelSolve.GetBool() || common->IsClient() ) {
+		return;
+	}
+
+	GetParallelArticulatedFigures( figures );
+
+	// a single figure is solved faster on this thread when it thinks
+	if ( figures.Num() > 1 ) {
+		idPhysics_AF::EvaluateParallel( figures.Ptr(), figures.Num(), time );
+	}
+}
+
+/*
+================
+idGameLocal::CreateAnimationFramesInParallel
+
+  Creates the new animation frames of all active animated entities in the
+  player PVS on the job threads. This runs after all entities thought and all
+  events were serviced so the frames are not created again when the entities
+  are rendered.
+================
+*/
+void idGameLocal::CreateAnimationFramesInParallel() {
+	idList<idAnimator *> animators;
+	idList<int> animtimes;
+	idEntity *ent;
+
+	if ( !g_parallelAnimation.GetBool() || g_debugAnim.GetInteger() != -1 || common->IsClient() ) {
+		return;
+	}
+
+	for ( ent = activeEntities.Next(); ent != NULL; ent = ent->activeNode.Next() ) {
+		if ( !( ent->thinkFlags & TH_ANIMATE ) || ent->IsHidden() || ent->GetModelDefHandle() == -1 ) {
+			continue;
+		}
+		idAnimator *animator = ent->GetAnimator();
+		if ( animator == NULL ) {
+			continue;
+		}
+		const int animtime = GetTimeGroupTime( ent->GetRenderEntity()->timeGroup );
+		if ( !animator->NeedsNewFrame( animtime ) || !InPlayerPVS( ent ) ) {
+			continue;
+		}
+		animators.Append( animator );
+		animtimes.Append( animtime );
+	}
+
+	// a single frame is created faster on this thread when the entity is rendered
+	if ( animators.Num() > 1 ) {
+		idAnimator::CreateFramesParallel( animators.Ptr(), animtimes.Ptr(), animators.Num() );
+	}
+}
+
 /*
 ================
 idGameLocal::SortActiveEntityList
@@ -2350,6 +2478,14 @@ void idGameLocal::RunFrame( idUserCmdMgr & cmdMgr, gameReturn_t & ret ) {
 		// sort the active entity list
 		SortActiveEntityList();
 
+		// trace the line of sight queries of the last frame in one batch
+		visibility.BeginFrame();
+
+		// solve the ragdolls in parallel, they pick up the results when they think
+		if ( !inCinematic ) {
+			EvaluateRagdollsInParallel();
+		}
+
 		timer_think.Clear();
 		timer_think.Start();
 
@@ -2396,6 +2532,9 @@ void idGameLocal::RunFrame( idUserCmdMgr & cmdMgr, gameReturn_t & ret ) {
 
 		RunTimeGroup2( cmdMgr );
 
+		// put islands of touching rigid bodies to rest
+		idPhysics_RigidBody::UpdateIslands();
+
 		// Run catch-up for any client projectiles.
 		// This is done after the main think so that all projectiles will be up-to-date
 		// when snapshots are created.
@@ -2435,6 +2574,9 @@ void idGameLocal::RunFrame( idUserCmdMgr & cmdMgr, gameReturn_t & ret ) {
 
 		timer_events.Stop();
 
+		// create the animation frames of the visible animated entities
+		CreateAnimationFramesInParallel();
+
 		// free the player pvs
 		FreePlayerPVS();
 
@@ -3354,6 +3496,36 @@ bool idGameLocal::SpawnEntityDef( const idDict &args, idEntity **ent, bool setDe
 	return false;
 }
 
+/*
+===================
+idGameLocal::SpawnBenchmarkGrid
+===================
+*/
+bool idGameLocal::SpawnBenchmarkGrid( const char *classname, int count, float spacing, float zOffset ) {
+	idPlayer *player = GetLocalPlayer();
+	if ( player == NULL ) {
+		return false;
+	}
+
+	const int gridSize = idMath::Ftoi( idMath::Sqrt( (float)count ) ) + 1;
+	idVec3 forward, right;
+	idAngles( 0.0f, player->viewAngles.yaw, 0.0f ).ToVectors( &forward, &right );
+
+	idDict dict;
+	for ( int i = 0; i < count; i++ ) {
+		const idVec3 org = player->GetPhysics()->GetOrigin() + forward * ( 128.0f + ( i / gridSize ) * spacing ) + right * ( ( i % gridSize ) - gridSize / 2 ) * spacing + idVec3( 0.0f, 0.0f, zOffset );
+		dict.Clear();
+		dict.Set( "classname", classname );
+		dict.Set( "angle", va( "%f", player->viewAngles.yaw + 180.0f ) );
+		dict.Set( "origin", org.ToString() );
+		if ( !SpawnEntityDef( dict ) ) {
+			Printf( "couldn't spawn '%s'\n", classname );
+			return false;
+		}
+	}
+	return true;
+}
+
 /*
 ================
 idGameLocal::FindEntityDef
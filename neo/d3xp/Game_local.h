@@ -66,6 +66,7 @@ class idThread;
 class idEditEntities;
 class idLocationEntity;
 class idMenuHandler_Shell;
+class idPhysics_AF;
 
 const int MAX_CLIENTS			= MAX_PLAYERS;
 const int MAX_CLIENTS_IN_PVS	= MAX_CLIENTS >> 3;
@@ -96,6 +97,7 @@ void gameError( const char *fmt, ... );
 #include "physics/Push.h"
 
 #include "Pvs.h"
+#include "Visibility.h"
 #include "Leaderboards.h"
 #include "MultiplayerGame.h"
 
@@ -273,6 +275,7 @@ public:
 	idClip					clip;					// collision detection
 	idPush					push;					// geometric pushing
 	idPVS					pvs;					// potential visible set
+	idVisibilityCache		visibility;				// line of sight queries shared during a frame
 
 	idTestModel *			testmodel;				// for development testing of models
 	idEntityFx *			testFx;					// for development testing of fx
@@ -402,9 +405,13 @@ public:
 	void					RemoveAllAASObstacles();
 
 	bool					CheatsOk( bool requirePlayer = true );
+							// articulated figures of active ragdolls that can be evaluated with EvaluateRagdollsInParallel
+	void					GetParallelArticulatedFigures( idList<idPhysics_AF *> &figures );
 	gameState_t				GameState() const;
 	idEntity *				SpawnEntityType( const idTypeInfo &classdef, const idDict *args = NULL, bool bIsClientReadSnapshot = false );
 	bool					SpawnEntityDef( const idDict &args, idEntity **ent = NULL, bool setDefaults = true );
+							// spawns entities on a square grid in front of the local player facing the player, for benchmarks
+	bool					SpawnBenchmarkGrid( const char *classname, int count, float spacing, float zOffset );
 	int						GetSpawnId( const idEntity *ent ) const;
 
 	const idDeclEntityDef *	FindEntityDef( const char *name, bool makeDefault = true ) const;
@@ -610,6 +617,8 @@ private:
 	void					FreePlayerPVS();
 	void					UpdateGravity();
 	void					SortActiveEntityList();
+	void					EvaluateRagdollsInParallel();
+	void					CreateAnimationFramesInParallel();
 	void					ShowTargets();
 	void					RunDebugInfo();
 
@@ -1042,6 +1042,9 @@ void idGameLocal::ClientRunFrame( idUserCmdMgr & cmdMgr, bool lastPredictFrame,
 		// service any pending events
 		idEvent::ServiceEvents();
 
+		// rigid bodies evaluated by the events still have to leave the island list
+		idPhysics_RigidBody::UpdateIslands();
+
 		return;
 	}
 
@@ -1075,6 +1078,10 @@ void idGameLocal::ClientRunFrame( idUserCmdMgr & cmdMgr, bool lastPredictFrame,
 		}
 	}
 
+	// put islands of touching rigid bodies to rest, client only bodies such as
+	// debris are registered the same way as on the server
+	idPhysics_RigidBody::UpdateIslands();
+
 	// service any pending events
 	idEvent::ServiceEvents();
 
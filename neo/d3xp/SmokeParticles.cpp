@@ -347,6 +347,10 @@ bool idSmokeParticles::UpdateRenderEntity( renderEntity_s *renderEntity, const r
 		tri->bounds[1][1] =
 		tri->bounds[1][2] = 99999;
 
+		// live particles are gathered so their colors and quads can be evaluated together
+		particleGen_t batch[MAX_PARTICLE_BATCH];
+		int numBatched = 0;
+
 		tri->numVerts = 0;
 		for ( last = NULL, smoke = active->smokes; smoke; smoke = next ) {
 			next = smoke->next;
@@ -380,10 +384,15 @@ bool idSmokeParticles::UpdateRenderEntity( renderEntity_s *renderEntity, const r
 			g.originalRandom = g.random;
 			g.age = g.frac * stage->particleLife;
 
-			tri->numVerts += stage->CreateParticle( &g, tri->verts + tri->numVerts );
+			batch[numBatched++] = g;
+			if ( numBatched == MAX_PARTICLE_BATCH ) {
+				tri->numVerts += stage->CreateParticles( batch, numBatched, tri->verts + tri->numVerts );
+				numBatched = 0;
+			}
 
 			last = smoke;
 		}
+		tri->numVerts += stage->CreateParticles( batch, numBatched, tri->verts + tri->numVerts );
 		if ( tri->numVerts > quads * 4 ) {
 			gameLocal.Error( "idSmokeParticles::UpdateRenderEntity: miscounted verts" );
 		}
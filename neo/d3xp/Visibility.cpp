@@ -0,0 +1,398 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. 
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").  
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+
+#include "../idlib/precompiled.h"
+#pragma hdrstop
+
+#include "Game_local.h"
+
+/*
+================
+EntityForSpawnId
+================
+*/
+static idEntity *EntityForSpawnId( int spawnId ) {
+	idEntityPtr<idEntity> ptr;
+
+	if ( spawnId == 0 || !ptr.SetSpawnId( spawnId ) ) {
+		return NULL;
+	}
+	return ptr.GetEntity();
+}
+
+/*
+================
+TargetClipEnabled
+================
+*/
+static bool TargetClipEnabled( const idEntity *target ) {
+	const idClipModel *clipModel = target->GetPhysics()->GetClipModel();
+	return ( clipModel != NULL && clipModel->IsEnabled() );
+}
+
+/*
+================
+Visibility_TraceWorldJob
+
+  Only the world is traced on the job threads, the clip sectors of idClip are
+  not safe to walk from several threads.
+================
+*/
+static void Visibility_TraceWorldJob( visibilityTraceParms_t *parms ) {
+	trace_t tr;
+
+	for ( int i = 0; i < parms->numQueries; i++ ) {
+		visibilityQuery_t &query = parms->queries[i];
+		collisionModelManager->Translation( &tr, query.key.start, query.key.end, NULL, mat3_identity, query.key.contentMask, 0, vec3_origin, mat3_default );
+		query.worldFraction = tr.fraction;
+	}
+}
+
+REGISTER_PARALLEL_JOB( Visibility_TraceWorldJob, "Visibility_TraceWorldJob" );
+
+static const int MAX_VISIBILITY_TRACE_JOBS	= 64;
+static const int VISIBILITY_QUERIES_PER_JOB	= 8;
+
+/*
+================
+idVisibilityCache::idVisibilityCache
+================
+*/
+idVisibilityCache::idVisibilityCache() {
+	frameNum = -1;
+	traceJobList = NULL;
+	ClearStats();
+}
+
+/*
+================
+idVisibilityCache::Init
+================
+*/
+void idVisibilityCache::Init() {
+	queries.Clear();
+	lastQueries.Clear();
+	queryHash.Clear( 1024, 1024 );
+	frameNum = -1;
+	ClearStats();
+
+	if ( traceJobList == NULL ) {
+		traceJobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_HIGH, MAX_VISIBILITY_TRACE_JOBS, 0, NULL );
+	}
+}
+
+/*
+================
+idVisibilityCache::Shutdown
+================
+*/
+void idVisibilityCache::Shutdown() {
+	queries.Clear();
+	lastQueries.Clear();
+	traceParms.Clear();
+	queryHash.Free();
+	frameNum = -1;
+
+	if ( traceJobList != NULL ) {
+		parallelJobManager->FreeJobList( traceJobList );
+		traceJobList = NULL;
+	}
+}
+
+/*
+================
+idVisibilityCache::ClearStats
+================
+*/
+void idVisibilityCache::ClearStats() {
+	numQueries = 0;
+	numShared = 0;
+	numPrefetchHits = 0;
+	numPrefetched = 0;
+	numTraces = 0;
+}
+
+/*
+================
+idVisibilityCache::MakeKey
+================
+*/
+void idVisibilityCache::MakeKey( const idVec3 &start, const idVec3 &end, int contentMask, const idEntity *passEntity, const idEntity *target, visibilityKey_t &key ) const {
+	key.start = start;
+	key.end = end;
+	key.contentMask = contentMask;
+	key.passEntityNum = ( passEntity != NULL ) ? passEntity->entityNumber : ENTITYNUM_NONE;
+	key.targetEntityNum = ( target != NULL ) ? target->entityNumber : ENTITYNUM_NONE;
+	key.targetClip = ( target != NULL && TargetClipEnabled( target ) ) ? 1 : 0;
+}
+
+/*
+================
+idVisibilityCache::HashKey
+================
+*/
+int idVisibilityCache::HashKey( const visibilityKey_t &key ) const {
+	const int *bits = reinterpret_cast<const int *>( &key );
+	int hash = 0;
+	for ( int i = 0; i < (int)( sizeof( key ) / sizeof( int ) ); i++ ) {
+		hash = hash * 31 + bits[i];
+	}
+	return hash;
+}
+
+/*
+================
+idVisibilityCache::FindQuery
+================
+*/
+int idVisibilityCache::FindQuery( const visibilityKey_t &key, int hash ) const {
+	for ( int i = queryHash.First( hash ); i != -1; i = queryHash.Next( i ) ) {
+		if ( memcmp( &queries[i].key, &key, sizeof( key ) ) == 0 ) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/*
+================
+idVisibilityCache::AddQuery
+================
+*/
+void idVisibilityCache::AddQuery( const visibilityQuery_t &query, int hash ) {
+	queryHash.Add( hash, queries.Append( query ) );
+}
+
+/*
+================
+idVisibilityCache::TraceQuery
+================
+*/
+bool idVisibilityCache::TraceQuery( visibilityQuery_t &query, const idEntity *passEntity, const idEntity *target ) {
+	trace_t tr;
+
+	gameLocal.clip.TracePoint( tr, query.key.start, query.key.end, query.key.contentMask, passEntity );
+	query.visible = ( tr.fraction >= 1.0f || ( target != NULL && gameLocal.GetTraceEntity( tr ) == target ) );
+	return query.visible;
+}
+
+/*
+================
+idVisibilityCache::FinishBatchedQuery
+
+  Combines the world trace from the job with a trace against the entities, the
+  same way idClip::Translation does. The target is clipped the same way as when
+  the query was first issued.
+================
+*/
+bool idVisibilityCache::FinishBatchedQuery( visibilityQuery_t &query, const idEntity *passEntity, idEntity *target ) {
+	trace_t tr;
+
+	if ( query.worldFraction <= 0.0f ) {
+		// blocked immediately by the world
+		query.visible = false;
+		return query.visible;
+	}
+
+	const bool disableTarget = ( target != NULL && query.key.targetClip == 0 && TargetClipEnabled( target ) );
+	if ( disableTarget ) {
+		target->GetPhysics()->DisableClip();
+	}
+	gameLocal.clip.TranslationEntities( tr, query.key.start, query.key.end, NULL, mat3_identity, query.key.contentMask, passEntity );
+	if ( disableTarget ) {
+		target->GetPhysics()->EnableClip();
+	}
+
+	if ( tr.fraction < query.worldFraction ) {
+		query.visible = ( target != NULL && gameLocal.GetTraceEntity( tr ) == target );
+	} else {
+		query.visible = ( query.worldFraction >= 1.0f );
+	}
+	return query.visible;
+}
+
+/*
+================
+idVisibilityCache::TraceBatch
+================
+*/
+void idVisibilityCache::TraceBatch() {
+	const int num = queries.Num();
+	if ( num == 0 ) {
+		return;
+	}
+
+	const int numJobs = ( num + VISIBILITY_QUERIES_PER_JOB - 1 ) / VISIBILITY_QUERIES_PER_JOB;
+	traceParms.SetNum( numJobs );
+	for ( int i = 0; i < numJobs; i++ ) {
+		const int first = i * VISIBILITY_QUERIES_PER_JOB;
+		traceParms[i].queries = queries.Ptr() + first;
+		traceParms[i].numQueries = Min( VISIBILITY_QUERIES_PER_JOB, num - first );
+	}
+
+	if ( traceJobList != NULL ) {
+		// the list is reused every frame, so submit in waves of at most MAX_VISIBILITY_TRACE_JOBS
+		for ( int i = 0; i < numJobs; i++ ) {
+			traceJobList->AddJob( (jobRun_t)Visibility_TraceWorldJob, &traceParms[i] );
+			if ( ( i % MAX_VISIBILITY_TRACE_JOBS ) == MAX_VISIBILITY_TRACE_JOBS - 1 || i == numJobs - 1 ) {
+				traceJobList->Submit();
+				traceJobList->Wait();
+			}
+		}
+	} else {
+		for ( int i = 0; i < numJobs; i++ ) {
+			Visibility_TraceWorldJob( &traceParms[i] );
+		}
+	}
+
+	for ( int i = 0; i < num; i++ ) {
+		FinishBatchedQuery( queries[i], EntityForSpawnId( queries[i].passSpawnId ), EntityForSpawnId( queries[i].targetSpawnId ) );
+	}
+}
+
+/*
+================
+idVisibilityCache::BeginFrame
+================
+*/
+void idVisibilityCache::BeginFrame() {
+	idEntity *passEntity, *target;
+	visibilityQuery_t query;
+	int i, hash;
+
+	if ( ai_showVisibilityStats.GetBool() && numQueries > 0 ) {
+		PrintStats();
+	}
+	ClearStats();
+
+	frameNum = gameLocal.framenum;
+
+	queries.Swap( lastQueries );
+	queries.SetNum( 0 );
+	queryHash.Clear();
+
+	if ( !ai_visibilityCache.GetBool() ) {
+		return;
+	}
+
+	// issue the queries used during the last frame again if their entities did not
+	// move, the entities are likely to ask for exactly the same line of sight
+	for ( i = 0; i < lastQueries.Num(); i++ ) {
+		const visibilityQuery_t &last = lastQueries[i];
+		if ( !last.used ) {
+			continue;
+		}
+
+		passEntity = EntityForSpawnId( last.passSpawnId );
+		target = EntityForSpawnId( last.targetSpawnId );
+		if ( ( last.passSpawnId != 0 && passEntity == NULL ) || ( last.targetSpawnId != 0 && target == NULL ) ) {
+			continue;
+		}
+		if ( passEntity != NULL && passEntity->GetPhysics()->GetOrigin() != last.passOrigin ) {
+			continue;
+		}
+		if ( target != NULL && target->GetPhysics()->GetOrigin() != last.targetOrigin ) {
+			continue;
+		}
+		// a target that is no longer clipped can't be clipped again for the trace
+		if ( target != NULL && last.key.targetClip != 0 && !TargetClipEnabled( target ) ) {
+			continue;
+		}
+
+		query = last;
+		query.prefetched = true;
+		query.used = false;
+
+		hash = HashKey( query.key );
+		if ( FindQuery( query.key, hash ) != -1 ) {
+			continue;
+		}
+		AddQuery( query, hash );
+	}
+
+	TraceBatch();
+	numPrefetched = queries.Num();
+
+	lastQueries.SetNum( 0 );
+}
+
+/*
+================
+idVisibilityCache::LineOfSight
+================
+*/
+bool idVisibilityCache::LineOfSight( const idVec3 &start, const idVec3 &end, int contentMask, const idEntity *passEntity, const idEntity *target ) {
+	visibilityQuery_t query;
+	int index, hash;
+
+	numQueries++;
+
+	MakeKey( start, end, contentMask, passEntity, target, query.key );
+
+	if ( !ai_visibilityCache.GetBool() || frameNum != gameLocal.framenum ) {
+		numTraces++;
+		return TraceQuery( query, passEntity, target );
+	}
+
+	hash = HashKey( query.key );
+	index = FindQuery( query.key, hash );
+	if ( index != -1 ) {
+		visibilityQuery_t &cached = queries[index];
+		if ( cached.prefetched && !cached.used ) {
+			numPrefetchHits++;
+		} else {
+			numShared++;
+		}
+		cached.used = true;
+		return cached.visible;
+	}
+
+	numTraces++;
+	query.passSpawnId = ( passEntity != NULL ) ? gameLocal.GetSpawnId( passEntity ) : 0;
+	query.targetSpawnId = ( target != NULL ) ? gameLocal.GetSpawnId( target ) : 0;
+	query.passOrigin = ( passEntity != NULL ) ? passEntity->GetPhysics()->GetOrigin() : vec3_origin;
+	query.targetOrigin = ( target != NULL ) ? target->GetPhysics()->GetOrigin() : vec3_origin;
+	query.worldFraction = 1.0f;
+	query.prefetched = false;
+	query.used = true;
+	TraceQuery( query, passEntity, target );
+	AddQuery( query, hash );
+	return query.visible;
+}
+
+/*
+================
+idVisibilityCache::PrintStats
+================
+*/
+void idVisibilityCache::PrintStats() const {
+	const int numCached = numShared + numPrefetchHits;
+	gameLocal.Printf( "visibility: %4d queries, %4d shared, %4d from batch, %4d batched traces, %4d traces, %3d%% answered from cache\n",
+						numQueries, numShared, numPrefetchHits, numPrefetched, numTraces, ( numQueries > 0 ) ? ( numCached * 100 / numQueries ) : 0 );
+}
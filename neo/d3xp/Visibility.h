@@ -0,0 +1,113 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. 
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").  
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+
+#ifndef __GAME_VISIBILITY_H__
+#define __GAME_VISIBILITY_H__
+
+/*
+===================================================================================
+
+	Visibility cache
+
+	Line of sight queries are shared by all entities during a frame. Queries with
+	exactly the same start and end point, which ignore the same entity and look
+	for the same target, are only traced once. The queries of the previous frame
+	whose entities did not move are issued again before the entities think, their
+	world traces run on the job threads.
+
+===================================================================================
+*/
+
+typedef struct visibilityKey_s {
+	idVec3				start;
+	idVec3				end;
+	int					contentMask;
+	int					passEntityNum;		// ENTITYNUM_NONE if no entity is ignored by the trace
+	int					targetEntityNum;	// ENTITYNUM_NONE if there is no target
+	int					targetClip;			// non-zero if the target was enabled for clipping
+} visibilityKey_t;
+
+typedef struct visibilityQuery_s {
+	visibilityKey_t		key;
+	int					passSpawnId;		// spawn id of the entity ignored by the trace
+	int					targetSpawnId;		// spawn id of the entity that does not block the line of sight
+	idVec3				passOrigin;			// origins at the time of the query, the query is only
+	idVec3				targetOrigin;		// issued again next frame if the entities did not move
+	float				worldFraction;		// fraction of the world trace done on a job thread
+	bool				visible;
+	bool				prefetched;			// traced in the batch at the start of the frame
+	bool				used;				// queried during this frame
+} visibilityQuery_t;
+
+typedef struct visibilityTraceParms_s {
+	visibilityQuery_t *	queries;
+	int					numQueries;
+} visibilityTraceParms_t;
+
+class idVisibilityCache {
+public:
+						idVisibilityCache();
+
+						// setup for the current map
+	void				Init();
+	void				Shutdown();
+						// starts a new frame, traces the unchanged queries of the previous frame in one batch
+	void				BeginFrame();
+						// returns true if nothing blocks the line from start to end or if the target is hit first
+	bool				LineOfSight( const idVec3 &start, const idVec3 &end, int contentMask, const idEntity *passEntity, const idEntity *target );
+
+	void				PrintStats() const;
+
+private:
+	idList<visibilityQuery_t>	queries;		// queries for the current frame
+	idList<visibilityQuery_t>	lastQueries;	// queries from the previous frame
+	idHashIndex			queryHash;
+	int					frameNum;
+
+	idParallelJobList *	traceJobList;			// world traces of the batch
+	idList<visibilityTraceParms_t>	traceParms;
+
+	int					numQueries;				// number of line of sight queries
+	int					numShared;				// queries answered by another query from the same frame
+	int					numPrefetchHits;		// queries answered by the batch
+	int					numPrefetched;			// traces in the batch
+	int					numTraces;				// traces for queries that could not be answered from the cache
+
+private:
+	void				MakeKey( const idVec3 &start, const idVec3 &end, int contentMask, const idEntity *passEntity, const idEntity *target, visibilityKey_t &key ) const;
+	int					HashKey( const visibilityKey_t &key ) const;
+	int					FindQuery( const visibilityKey_t &key, int hash ) const;
+	void				AddQuery( const visibilityQuery_t &query, int hash );
+	void				ClearStats();
+	void				TraceBatch();
+	static bool			TraceQuery( visibilityQuery_t &query, const idEntity *passEntity, const idEntity *target );
+	static bool			FinishBatchedQuery( visibilityQuery_t &query, const idEntity *passEntity, idEntity *target );
+};
+
+#endif /* !__GAME_VISIBILITY_H__ */
@@ -136,6 +136,8 @@ public:
 	virtual void				ShowFlyPath( const idVec3 &origin, int goalAreaNum, const idVec3 &goalOrigin ) const = 0;
 								// Find the nearest goal which satisfies the callback.
 	virtual bool				FindNearestGoal( aasGoal_t &goal, int areaNum, const idVec3 origin, const idVec3 &target, int travelFlags, aasObstacle_t *obstacles, int numObstacles, idAASCallback &callback ) const = 0;
+								// Times routes between random areas with and without the cluster graph.
+	virtual void				BenchmarkRouting( int numRoutes, int travelFlags ) = 0;
 };
 
 #endif /* !__AAS_H__ */
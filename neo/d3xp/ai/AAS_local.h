@@ -73,6 +73,34 @@ private:
 };
 
 
+class idRoutingClusterGraph {
+	friend class idAASLocal;
+
+public:
+								idRoutingClusterGraph( int travelFlags, int numClusters, int numTravelTimes );
+
+private:
+	int							travelFlags;			// combinations of the travel flags
+	float						heuristicScale;			// lowest travel time per unit of distance between two portals
+	idList<bool, TAG_AAS>		clusterValid;			// true if the portal travel times of the cluster are up to date
+	idList<unsigned short, TAG_AAS>	portalTravelTimes;	// travel times between the portals of each cluster
+	idRoutingClusterGraph *		next;					// next in list
+};
+
+
+class idRoutingGraphNode {
+	friend class idAASLocal;
+
+private:
+	int							travelTime;				// travel time from the start area to the portal area
+	int							estimate;				// travel time plus the estimated travel time to the goal
+	int							searchNum;				// search that last reached this portal
+	int							heapIndex;				// index in the open heap, -1 if closed
+	short						firstPortal;			// first portal on the route, -1 if the route starts in this portal
+	short						firstCluster;			// cluster the route leaves the start area through
+};
+
+
 class idRoutingObstacle {
 	friend class idAASLocal;
 								idRoutingObstacle() { }
@@ -118,6 +146,7 @@ public:
 	virtual void				ShowWalkPath( const idVec3 &origin, int goalAreaNum, const idVec3 &goalOrigin ) const;
 	virtual void				ShowFlyPath( const idVec3 &origin, int goalAreaNum, const idVec3 &goalOrigin ) const;
 	virtual bool				FindNearestGoal( aasGoal_t &goal, int areaNum, const idVec3 origin, const idVec3 &target, int travelFlags, aasObstacle_t *obstacles, int numObstacles, idAASCallback &callback ) const;
+	virtual void				BenchmarkRouting( int numRoutes, int travelFlags );
 
 private:
 	idAASFile *					file;
@@ -137,6 +166,13 @@ private:	// routing data
 	mutable idRoutingCache *	cacheListEnd;			// end of list with cache sorted from oldest to newest
 	mutable int					totalCacheMemory;		// total cache memory used
 	idList<idRoutingObstacle *, TAG_AAS>	obstacleList;			// list with obstacles
+	mutable idRoutingClusterGraph *	clusterGraphs;		// cluster level routing graph for each combination of travel flags
+	int *						clusterGraphOffsets;	// offset of the portal travel times of each cluster in a graph
+	int							clusterGraphSize;		// number of portal travel times in a graph
+	short *						portalClusterIndex;		// number of each portal in the portal list of its front and back cluster
+	idRoutingGraphNode *		graphNodes;				// memory used to search the cluster graph
+	mutable int					graphSearchNum;			// number of the current cluster graph search
+	mutable idList<int, TAG_AAS>	graphOpenHeap;		// portals still to be expanded sorted on estimated travel time
 
 private:	// routing
 	bool						SetupRouting();
@@ -164,6 +200,15 @@ private:	// routing
 	bool						SetAreaState_r( int nodeNum, const idBounds &bounds, const int areaContents, bool disabled );
 	void						GetBoundsAreas_r( int nodeNum, const idBounds &bounds, idList<int> &areas ) const;
 	void						SetObstacleState( const idRoutingObstacle *obstacle, bool enable );
+	void						SetupClusterGraphs();
+	void						ShutdownClusterGraphs();
+	void						InvalidateClusterGraphs( int clusterNum );
+	idRoutingClusterGraph *		GetClusterGraph( int travelFlags ) const;
+	void						UpdateClusterGraph( idRoutingClusterGraph *graph ) const;
+	void						PushGraphNode( int portalNum ) const;
+	int							PopGraphNode() const;
+	void						SiftGraphNodeUp( int heapIndex ) const;
+	bool						RouteThroughClusterGraph( int areaNum, const idVec3 &origin, int goalAreaNum, int travelFlags, int &travelTime, idReachability **reach ) const;
 
 private:	// pathing
 	bool						EdgeSplitPoint( idVec3 &split, int edgeNum, const idPlane &plane ) const;
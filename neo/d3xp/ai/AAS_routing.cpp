@@ -79,6 +79,21 @@ int idRoutingCache::Size() const {
 	return sizeof( idRoutingCache ) + size * sizeof( reachabilities[0] ) + size * sizeof( travelTimes[0] );
 }
 
+/*
+============
+idRoutingClusterGraph::idRoutingClusterGraph
+============
+*/
+idRoutingClusterGraph::idRoutingClusterGraph( int travelFlags, int numClusters, int numTravelTimes ) {
+	this->travelFlags = travelFlags;
+	heuristicScale = 0.0f;
+	clusterValid.SetNum( numClusters );
+	memset( clusterValid.Ptr(), 0, numClusters * sizeof( clusterValid[0] ) );
+	portalTravelTimes.SetNum( numTravelTimes );
+	memset( portalTravelTimes.Ptr(), 0, numTravelTimes * sizeof( portalTravelTimes[0] ) );
+	next = NULL;
+}
+
 /*
 ============
 idAASLocal::AreaTravelTime
@@ -213,6 +228,8 @@ void idAASLocal::SetupRoutingCache() {
 
 	cacheListStart = cacheListEnd = NULL;
 	totalCacheMemory = 0;
+
+	SetupClusterGraphs();
 }
 
 /*
@@ -278,6 +295,8 @@ void idAASLocal::ShutdownRoutingCache() {
 	Mem_Free( goalAreaTravelTimes );
 	goalAreaTravelTimes = NULL;
 
+	ShutdownClusterGraphs();
+
 	cacheListStart = cacheListEnd = NULL;
 	totalCacheMemory = 0;
 }
@@ -310,7 +329,8 @@ idAASLocal::RoutingStats
 */
 void idAASLocal::RoutingStats() const {
 	idRoutingCache *cache;
-	int numAreaCache, numPortalCache;
+	idRoutingClusterGraph *graph;
+	int numAreaCache, numPortalCache, numClusterGraphs;
 	int totalAreaCacheMemory, totalPortalCacheMemory;
 
 	numAreaCache = numPortalCache = 0;
@@ -331,6 +351,12 @@ void idAASLocal::RoutingStats() const {
 	gameLocal.Printf( "%6d area travel times (%d KB)\n", numAreaTravelTimes, ( numAreaTravelTimes * sizeof( unsigned short ) ) >> 10 );
 	gameLocal.Printf( "%6d area cache entries (%d KB)\n", areaCacheIndexSize, ( areaCacheIndexSize * sizeof( idRoutingCache * ) ) >> 10 );
 	gameLocal.Printf( "%6d portal cache entries (%d KB)\n", portalCacheIndexSize, ( portalCacheIndexSize * sizeof( idRoutingCache * ) ) >> 10 );
+
+	numClusterGraphs = 0;
+	for ( graph = clusterGraphs; graph; graph = graph->next ) {
+		numClusterGraphs++;
+	}
+	gameLocal.Printf( "%6d cluster graphs (%d KB)\n", numClusterGraphs, ( numClusterGraphs * clusterGraphSize * sizeof( unsigned short ) ) >> 10 );
 }
 
 /*
@@ -345,11 +371,14 @@ void idAASLocal::RemoveRoutingCacheUsingArea( int areaNum ) {
 	if ( clusterNum > 0 ) {
 		// remove all the cache in the cluster the area is in
 		DeleteClusterCache( clusterNum );
+		InvalidateClusterGraphs( clusterNum );
 	}
 	else {
 		// if this is a portal remove all cache in both the front and back cluster
 		DeleteClusterCache( file->GetPortal( -clusterNum ).clusters[0] );
 		DeleteClusterCache( file->GetPortal( -clusterNum ).clusters[1] );
+		InvalidateClusterGraphs( file->GetPortal( -clusterNum ).clusters[0] );
+		InvalidateClusterGraphs( file->GetPortal( -clusterNum ).clusters[1] );
 	}
 	DeletePortalCache();
 }
@@ -987,6 +1016,445 @@ idRoutingCache *idAASLocal::GetPortalRoutingCache( int clusterNum, int areaNum,
 	return cache;
 }
 
+/*
+============
+idAASLocal::SetupClusterGraphs
+============
+*/
+void idAASLocal::SetupClusterGraphs() {
+	int i, j, portalNum;
+
+	clusterGraphs = NULL;
+
+	clusterGraphOffsets = (int *) Mem_Alloc( file->GetNumClusters() * sizeof( int ), TAG_AAS );
+	clusterGraphSize = 0;
+	for ( i = 0; i < file->GetNumClusters(); i++ ) {
+		clusterGraphOffsets[i] = clusterGraphSize;
+		clusterGraphSize += Square( file->GetCluster( i ).numPortals );
+	}
+
+	portalClusterIndex = (short *) Mem_ClearedAlloc( file->GetNumPortals() * 2 * sizeof( short ), TAG_AAS );
+	for ( i = 0; i < file->GetNumClusters(); i++ ) {
+		const aasCluster_t &cluster = file->GetCluster( i );
+		for ( j = 0; j < cluster.numPortals; j++ ) {
+			portalNum = file->GetPortalIndex( cluster.firstPortal + j );
+			portalClusterIndex[portalNum * 2 + ( file->GetPortal( portalNum ).clusters[0] != i )] = j;
+		}
+	}
+
+	graphNodes = (idRoutingGraphNode *) Mem_ClearedAlloc( file->GetNumPortals() * sizeof( idRoutingGraphNode ), TAG_AAS );
+	graphSearchNum = 0;
+	graphOpenHeap.Clear();
+}
+
+/*
+============
+idAASLocal::ShutdownClusterGraphs
+============
+*/
+void idAASLocal::ShutdownClusterGraphs() {
+	idRoutingClusterGraph *graph;
+
+	while( clusterGraphs ) {
+		graph = clusterGraphs;
+		clusterGraphs = graph->next;
+		delete graph;
+	}
+
+	Mem_Free( clusterGraphOffsets );
+	clusterGraphOffsets = NULL;
+	clusterGraphSize = 0;
+	Mem_Free( portalClusterIndex );
+	portalClusterIndex = NULL;
+	Mem_Free( graphNodes );
+	graphNodes = NULL;
+	graphOpenHeap.Clear();
+}
+
+/*
+============
+idAASLocal::InvalidateClusterGraphs
+============
+*/
+void idAASLocal::InvalidateClusterGraphs( int clusterNum ) {
+	idRoutingClusterGraph *graph;
+
+	for ( graph = clusterGraphs; graph; graph = graph->next ) {
+		graph->clusterValid[clusterNum] = false;
+	}
+}
+
+/*
+============
+idAASLocal::UpdateClusterGraph
+
+  calculates the travel times between the portals of all clusters that changed
+============
+*/
+void idAASLocal::UpdateClusterGraph( idRoutingClusterGraph *graph ) const {
+	int i, j, k, numPortals, clusterAreaNum;
+	float scale, dist;
+	bool changed;
+	const aasCluster_t *cluster;
+	unsigned short *travelTimes;
+	idRoutingCache *cache;
+
+	changed = false;
+	for ( i = 0; i < file->GetNumClusters(); i++ ) {
+		if ( graph->clusterValid[i] ) {
+			continue;
+		}
+
+		cluster = &file->GetCluster( i );
+		numPortals = cluster->numPortals;
+		travelTimes = &graph->portalTravelTimes[clusterGraphOffsets[i]];
+		memset( travelTimes, 0, numPortals * numPortals * sizeof( travelTimes[0] ) );
+
+		// the area cache of a portal has the travel times from the other portals towards it
+		for ( j = 0; j < numPortals; j++ ) {
+			const aasPortal_t &portal = file->GetPortal( file->GetPortalIndex( cluster->firstPortal + j ) );
+			if ( ClusterAreaNum( i, portal.areaNum ) >= cluster->numReachableAreas ) {
+				continue;
+			}
+			cache = GetAreaRoutingCache( i, portal.areaNum, graph->travelFlags );
+			for ( k = 0; k < numPortals; k++ ) {
+				if ( k == j ) {
+					continue;
+				}
+				clusterAreaNum = ClusterAreaNum( i, file->GetPortal( file->GetPortalIndex( cluster->firstPortal + k ) ).areaNum );
+				if ( clusterAreaNum >= cluster->numReachableAreas ) {
+					continue;
+				}
+				travelTimes[k * numPortals + j] = cache->travelTimes[clusterAreaNum];
+			}
+		}
+
+		graph->clusterValid[i] = true;
+		changed = true;
+	}
+
+	if ( !changed ) {
+		return;
+	}
+
+	// the lowest travel time per unit of distance between any two portals keeps the
+	// distance based estimate below the real travel time between portals
+	scale = idMath::INFINITY;
+	for ( i = 0; i < file->GetNumClusters(); i++ ) {
+		cluster = &file->GetCluster( i );
+		numPortals = cluster->numPortals;
+		travelTimes = &graph->portalTravelTimes[clusterGraphOffsets[i]];
+		for ( j = 0; j < numPortals; j++ ) {
+			const idVec3 &start = file->GetArea( file->GetPortal( file->GetPortalIndex( cluster->firstPortal + j ) ).areaNum ).center;
+			for ( k = 0; k < numPortals; k++ ) {
+				if ( !travelTimes[j * numPortals + k] ) {
+					continue;
+				}
+				dist = ( file->GetArea( file->GetPortal( file->GetPortalIndex( cluster->firstPortal + k ) ).areaNum ).center - start ).Length();
+				if ( dist > 1.0f && travelTimes[j * numPortals + k] < scale * dist ) {
+					scale = travelTimes[j * numPortals + k] / dist;
+				}
+			}
+		}
+	}
+	graph->heuristicScale = ( scale < idMath::INFINITY ) ? scale : 0.0f;
+}
+
+/*
+============
+idAASLocal::GetClusterGraph
+============
+*/
+idRoutingClusterGraph *idAASLocal::GetClusterGraph( int travelFlags ) const {
+	idRoutingClusterGraph *graph;
+
+	// check if a graph for these travel flags already exists
+	for ( graph = clusterGraphs; graph; graph = graph->next ) {
+		if ( graph->travelFlags == travelFlags ) {
+			break;
+		}
+	}
+	// if no graph found
+	if ( !graph ) {
+		graph = new (TAG_AAS) idRoutingClusterGraph( travelFlags, file->GetNumClusters(), clusterGraphSize );
+		graph->next = clusterGraphs;
+		clusterGraphs = graph;
+	}
+	UpdateClusterGraph( graph );
+	return graph;
+}
+
+/*
+============
+idAASLocal::SiftGraphNodeUp
+============
+*/
+void idAASLocal::SiftGraphNodeUp( int heapIndex ) const {
+	int portalNum, parent;
+
+	portalNum = graphOpenHeap[heapIndex];
+	while( heapIndex > 0 ) {
+		parent = ( heapIndex - 1 ) >> 1;
+		if ( graphNodes[graphOpenHeap[parent]].estimate <= graphNodes[portalNum].estimate ) {
+			break;
+		}
+		graphOpenHeap[heapIndex] = graphOpenHeap[parent];
+		graphNodes[graphOpenHeap[heapIndex]].heapIndex = heapIndex;
+		heapIndex = parent;
+	}
+	graphOpenHeap[heapIndex] = portalNum;
+	graphNodes[portalNum].heapIndex = heapIndex;
+}
+
+/*
+============
+idAASLocal::PushGraphNode
+============
+*/
+void idAASLocal::PushGraphNode( int portalNum ) const {
+	graphOpenHeap.Append( portalNum );
+	SiftGraphNodeUp( graphOpenHeap.Num() - 1 );
+}
+
+/*
+============
+idAASLocal::PopGraphNode
+
+  removes the portal with the lowest estimated travel time from the open heap
+============
+*/
+int idAASLocal::PopGraphNode() const {
+	int portalNum, lastPortalNum, heapIndex, child, numOpen;
+
+	portalNum = graphOpenHeap[0];
+	graphNodes[portalNum].heapIndex = -1;
+
+	numOpen = graphOpenHeap.Num() - 1;
+	lastPortalNum = graphOpenHeap[numOpen];
+	graphOpenHeap.SetNum( numOpen );
+
+	if ( numOpen > 0 ) {
+		// sift the last portal down from the top
+		heapIndex = 0;
+		while( 1 ) {
+			child = heapIndex * 2 + 1;
+			if ( child >= numOpen ) {
+				break;
+			}
+			if ( child + 1 < numOpen && graphNodes[graphOpenHeap[child + 1]].estimate < graphNodes[graphOpenHeap[child]].estimate ) {
+				child++;
+			}
+			if ( graphNodes[lastPortalNum].estimate <= graphNodes[graphOpenHeap[child]].estimate ) {
+				break;
+			}
+			graphOpenHeap[heapIndex] = graphOpenHeap[child];
+			graphNodes[graphOpenHeap[heapIndex]].heapIndex = heapIndex;
+			heapIndex = child;
+		}
+		graphOpenHeap[heapIndex] = lastPortalNum;
+		graphNodes[lastPortalNum].heapIndex = heapIndex;
+	}
+	return portalNum;
+}
+
+/*
+============
+idAASLocal::RouteThroughClusterGraph
+
+  A* search over the cluster portals, using the travel times between the portals of each
+  cluster. Only the area routing cache of the start and goal cluster is needed to get onto
+  and off the graph, so long routes no longer build a portal cache flooded over all clusters.
+  On input travelTime and reach hold the route within the start cluster if there is one,
+  it's only replaced if the graph has a faster route. When the start area is not a portal
+  the travel times include the time from the origin to the first reachability, like the
+  travel time of the route within the start cluster.
+
+  The distance estimate is only a lower bound for the travel time between portals, not
+  for the last step from a portal to the goal area. So it only orders the search, every
+  portal that can still lead to a faster route is expanded and closed portals are opened
+  again when they're reached faster.
+============
+*/
+bool idAASLocal::RouteThroughClusterGraph( int areaNum, const idVec3 &origin, int goalAreaNum, int travelFlags, int &travelTime, idReachability **reach ) const {
+	int i, side, clusterNum, goalClusterNum, startPortalNum, portalNum, nextPortalNum, clusterAreaNum, numPortals, t;
+	int bestTime, bestFirstPortal, bestFirstCluster;
+	const aasPortal_t *portal, *nextPortal;
+	const aasCluster_t *cluster;
+	const unsigned short *portalTravelTimes;
+	idRoutingClusterGraph *graph;
+	idRoutingCache *cache, *goalCache;
+	idRoutingGraphNode *node, *nextNode;
+	idReachability *firstReach;
+	idVec3 goalCenter;
+
+	clusterNum = file->GetArea( areaNum ).cluster;
+	goalClusterNum = file->GetArea( goalAreaNum ).cluster;
+
+	// if the goal area is a portal
+	if ( goalClusterNum < 0 ) {
+		// just assume the goal area is part of the front cluster
+		goalClusterNum = file->GetPortal( -goalClusterNum ).clusters[0];
+	}
+	if ( ClusterAreaNum( goalClusterNum, goalAreaNum ) >= file->GetCluster( goalClusterNum ).numReachableAreas ) {
+		return ( *reach != NULL );
+	}
+
+	graph = GetClusterGraph( travelFlags );
+	goalCache = GetAreaRoutingCache( goalClusterNum, goalAreaNum, travelFlags );
+	goalCenter = file->GetArea( goalAreaNum ).center;
+
+	bestTime = travelTime;
+	bestFirstPortal = -1;
+	bestFirstCluster = 0;
+
+	graphSearchNum++;
+	graphOpenHeap.SetNum( 0 );
+
+	if ( clusterNum < 0 ) {
+		// start the search in the portal itself
+		startPortalNum = -clusterNum;
+		node = &graphNodes[startPortalNum];
+		node->searchNum = graphSearchNum;
+		node->travelTime = 0;
+		node->estimate = 0;
+		node->firstPortal = -1;
+		node->firstCluster = 0;
+		PushGraphNode( startPortalNum );
+	}
+	else {
+		startPortalNum = 0;
+		cluster = &file->GetCluster( clusterNum );
+		clusterAreaNum = ClusterAreaNum( clusterNum, areaNum );
+		// if the area is not a reachable area
+		if ( clusterAreaNum >= cluster->numReachableAreas ) {
+			return ( *reach != NULL );
+		}
+		// get onto the graph through the portals of the start cluster
+		for ( i = 0; i < cluster->numPortals; i++ ) {
+			portalNum = file->GetPortalIndex( cluster->firstPortal + i );
+			portal = &file->GetPortal( portalNum );
+			if ( ClusterAreaNum( clusterNum, portal->areaNum ) >= cluster->numReachableAreas ) {
+				continue;
+			}
+			cache = GetAreaRoutingCache( clusterNum, portal->areaNum, travelFlags );
+			// if the portal is not reachable from this area
+			if ( !cache->travelTimes[clusterAreaNum] ) {
+				continue;
+			}
+			firstReach = GetAreaReachability( areaNum, cache->reachabilities[clusterAreaNum] );
+			node = &graphNodes[portalNum];
+			node->searchNum = graphSearchNum;
+			node->travelTime = cache->travelTimes[clusterAreaNum] + portal->maxAreaTravelTime + AreaTravelTime( areaNum, origin, firstReach->start );
+			node->estimate = node->travelTime + idMath::Ftoi( graph->heuristicScale * ( file->GetArea( portal->areaNum ).center - goalCenter ).Length() );
+			node->firstPortal = portalNum;
+			node->firstCluster = clusterNum;
+			PushGraphNode( portalNum );
+		}
+	}
+
+	while( graphOpenHeap.Num() ) {
+
+		portalNum = PopGraphNode();
+		node = &graphNodes[portalNum];
+
+		// no route through this portal can be faster
+		if ( bestTime && node->travelTime >= bestTime ) {
+			continue;
+		}
+
+		portal = &file->GetPortal( portalNum );
+
+		for ( side = 0; side < 2; side++ ) {
+			clusterNum = portal->clusters[side];
+			cluster = &file->GetCluster( clusterNum );
+
+			// get off the graph towards the goal area
+			if ( clusterNum == goalClusterNum ) {
+				clusterAreaNum = ClusterAreaNum( clusterNum, portal->areaNum );
+				if ( clusterAreaNum < cluster->numReachableAreas && goalCache->travelTimes[clusterAreaNum] ) {
+					// the portal routing cache starts with a travel time of 1 as well
+					t = node->travelTime + goalCache->travelTimes[clusterAreaNum] + 1;
+					if ( !bestTime || t < bestTime ) {
+						bestTime = t;
+						if ( portalNum == startPortalNum ) {
+							bestFirstPortal = -1;
+							bestFirstCluster = clusterNum;
+						}
+						else {
+							bestFirstPortal = node->firstPortal;
+							bestFirstCluster = node->firstCluster;
+						}
+					}
+				}
+			}
+
+			// travel to the other portals of the cluster
+			numPortals = cluster->numPortals;
+			portalTravelTimes = &graph->portalTravelTimes[clusterGraphOffsets[clusterNum] + portalClusterIndex[portalNum * 2 + side] * numPortals];
+			for ( i = 0; i < numPortals; i++ ) {
+				if ( !portalTravelTimes[i] ) {
+					continue;
+				}
+				nextPortalNum = file->GetPortalIndex( cluster->firstPortal + i );
+				nextPortal = &file->GetPortal( nextPortalNum );
+				nextNode = &graphNodes[nextPortalNum];
+
+				// add the largest travel time through the next portal area like the portal routing cache does
+				t = node->travelTime + portalTravelTimes[i] + nextPortal->maxAreaTravelTime;
+				if ( bestTime && t >= bestTime ) {
+					continue;
+				}
+
+				if ( nextNode->searchNum == graphSearchNum ) {
+					// if the portal is already reached faster, a closed portal reached faster is opened again
+					if ( t >= nextNode->travelTime ) {
+						continue;
+					}
+				}
+				else {
+					nextNode->searchNum = graphSearchNum;
+					nextNode->heapIndex = -1;
+				}
+
+				nextNode->travelTime = t;
+				nextNode->estimate = t + idMath::Ftoi( graph->heuristicScale * ( file->GetArea( nextPortal->areaNum ).center - goalCenter ).Length() );
+				if ( portalNum == startPortalNum ) {
+					nextNode->firstPortal = nextPortalNum;
+					nextNode->firstCluster = clusterNum;
+				}
+				else {
+					nextNode->firstPortal = node->firstPortal;
+					nextNode->firstCluster = node->firstCluster;
+				}
+
+				if ( nextNode->heapIndex < 0 ) {
+					PushGraphNode( nextPortalNum );
+				}
+				else {
+					SiftGraphNodeUp( nextNode->heapIndex );
+				}
+			}
+		}
+	}
+
+	// if the route within the start cluster is the fastest
+	if ( !bestFirstCluster ) {
+		return ( *reach != NULL );
+	}
+
+	// only the first step of the route is refined to the area level
+	if ( bestFirstPortal >= 0 ) {
+		cache = GetAreaRoutingCache( bestFirstCluster, file->GetPortal( bestFirstPortal ).areaNum, travelFlags );
+	}
+	else {
+		cache = goalCache;
+	}
+	*reach = GetAreaReachability( areaNum, cache->reachabilities[ClusterAreaNum( bestFirstCluster, areaNum )] );
+	travelTime = bestTime;
+
+	return true;
+}
+
 /*
 ============
 idAASLocal::RouteToGoalArea
@@ -1029,6 +1497,13 @@ bool idAASLocal::RouteToGoalArea( int areaNum, const idVec3 origin, int goalArea
 
 	// if the source area is a cluster portal, read directly from the portal cache
 	if ( clusterNum < 0 ) {
+		if ( aas_clusterRouting.GetBool() ) {
+			if ( !RouteThroughClusterGraph( areaNum, origin, goalAreaNum, travelFlags, travelTime, reach ) ) {
+				return false;
+			}
+			travelTime += AreaTravelTime( areaNum, origin, (*reach)->start );
+			return true;
+		}
 		// if the goal area is a portal
 		if ( goalClusterNum < 0 ) {
 			// just assume the goal area is part of the front cluster
@@ -1069,6 +1544,13 @@ bool idAASLocal::RouteToGoalArea( int areaNum, const idVec3 origin, int goalArea
 		clusterCache = NULL;
 	}
 
+	if ( aas_clusterRouting.GetBool() ) {
+		// see if a route through other clusters beats the route within the cluster
+		travelTime = bestTime;
+		*reach = bestReach;
+		return RouteThroughClusterGraph( areaNum, origin, goalAreaNum, travelFlags, travelTime, reach );
+	}
+
 	clusterNum = file->GetArea( areaNum ).cluster;
 	goalClusterNum = file->GetArea( goalAreaNum ).cluster;
 
@@ -1348,3 +1830,87 @@ bool idAASLocal::FindNearestGoal( aasGoal_t &goal, int areaNum, const idVec3 ori
 
 	return false;
 }
+
+/*
+============
+idAASLocal::BenchmarkRouting
+
+  routes between the same random areas with the portal routing cache and with the
+  cluster graph, both starting out with empty caches
+============
+*/
+void idAASLocal::BenchmarkRouting( int numRoutes, int travelFlags ) {
+	int i, mode, travelTime, numFound, numDifferent, maxCacheMemory, areaFlags;
+	bool clusterRouting;
+	idReachability *reach;
+	idRandom random;
+	idList<int> areas;
+	idList<int> startAreas;
+	idList<int> goalAreas;
+	idList<idReachability *> firstReach;
+
+	if ( !file ) {
+		return;
+	}
+
+	areaFlags = ( travelFlags & TFL_FLY ) ? AREA_REACHABLE_FLY : AREA_REACHABLE_WALK;
+	for ( i = 1; i < file->GetNumAreas(); i++ ) {
+		if ( file->GetArea( i ).flags & areaFlags ) {
+			areas.Append( i );
+		}
+	}
+	if ( areas.Num() < 2 ) {
+		gameLocal.Printf( "%s has too few reachable areas\n", file->GetName() );
+		return;
+	}
+
+	startAreas.SetNum( numRoutes );
+	goalAreas.SetNum( numRoutes );
+	firstReach.SetNum( numRoutes );
+	for ( i = 0; i < numRoutes; i++ ) {
+		startAreas[i] = areas[random.RandomInt( areas.Num() )];
+		goalAreas[i] = areas[random.RandomInt( areas.Num() )];
+	}
+
+	gameLocal.Printf( "[%s] %d routes between %d areas\n", file->GetName(), numRoutes, areas.Num() );
+
+	clusterRouting = aas_clusterRouting.GetBool();
+	numDifferent = 0;
+
+	for ( mode = 0; mode < 2; mode++ ) {
+		aas_clusterRouting.SetBool( mode != 0 );
+
+		ShutdownRoutingCache();
+		SetupRoutingCache();
+
+		numFound = 0;
+		maxCacheMemory = 0;
+
+		const uint64 startTime = Sys_Microseconds();
+		for ( i = 0; i < numRoutes; i++ ) {
+			if ( RouteToGoalArea( startAreas[i], file->GetArea( startAreas[i] ).center, goalAreas[i], travelFlags, travelTime, &reach ) ) {
+				numFound++;
+			}
+			if ( mode == 0 ) {
+				firstReach[i] = reach;
+			} else if ( reach != firstReach[i] ) {
+				numDifferent++;
+			}
+			if ( totalCacheMemory > maxCacheMemory ) {
+				maxCacheMemory = totalCacheMemory;
+			}
+		}
+		const uint64 endTime = Sys_Microseconds();
+
+		gameLocal.Printf( "%-14s %6d found, %8lld usec, %6.2f usec per route, %5d KB peak cache\n", ( mode == 0 ) ? "portal cache:" : "cluster graph:",
+							numFound, endTime - startTime, (float)( endTime - startTime ) / numRoutes, maxCacheMemory >> 10 );
+	}
+
+	// routes with the same travel time through different portals can take a different first step
+	gameLocal.Printf( "%d routes took a different first reachability\n", numDifferent );
+
+	aas_clusterRouting.SetBool( clusterRouting );
+
+	ShutdownRoutingCache();
+	SetupRoutingCache();
+}
@@ -1217,6 +1217,24 @@ void idAI::Think() {
 	}
 }
 
+/*
+=====================
+idAI::ThinksAsRagdoll
+
+Dead monsters with an active ragdoll only update the death script and run
+the physics of the ragdoll when they think.
+=====================
+*/
+bool idAI::ThinksAsRagdoll() const {
+	if ( fl.isDormant || !ai_think.GetBool() || !af.IsActive() ) {
+		return false;
+	}
+	if ( !( thinkFlags & TH_THINK ) ) {
+		return true;
+	}
+	return ( num_cinematics == 0 && ( allowHiddenMovement || !IsHidden() ) && move.moveType == MOVETYPE_DEAD );
+}
+
 /***********************************************************************
 
 	AI script state management
@@ -2359,7 +2377,6 @@ idAI::EntityCanSeePos
 */
 bool idAI::EntityCanSeePos( idActor *actor, const idVec3 &actorOrigin, const idVec3 &pos ) {
 	idVec3 eye, point;
-	trace_t results;
 	pvsHandle_t handle;
 
 	handle = gameLocal.pvs.SetupCurrentPVS( actor->GetPVSAreas(), actor->GetNumPVSAreas() );
@@ -2378,8 +2395,7 @@ bool idAI::EntityCanSeePos( idActor *actor, const idVec3 &actorOrigin, const idV
 
 	physicsObj.DisableClip();
 
-	gameLocal.clip.TracePoint( results, eye, point, MASK_SOLID, actor );
-	if ( results.fraction >= 1.0f || ( gameLocal.GetTraceEntity( results ) == this ) ) {
+	if ( gameLocal.visibility.LineOfSight( eye, point, MASK_SOLID, actor, this ) ) {
 		physicsObj.EnableClip();
 		return true;
 	}
@@ -2387,12 +2403,9 @@ bool idAI::EntityCanSeePos( idActor *actor, const idVec3 &actorOrigin, const idV
 	const idBounds &bounds = physicsObj.GetBounds();
 	point[2] += bounds[1][2] - bounds[0][2];
 
-	gameLocal.clip.TracePoint( results, eye, point, MASK_SOLID, actor );
+	const bool visible = gameLocal.visibility.LineOfSight( eye, point, MASK_SOLID, actor, this );
 	physicsObj.EnableClip();
-	if ( results.fraction >= 1.0f || ( gameLocal.GetTraceEntity( results ) == this ) ) {
-		return true;
-	}
-	return false;
+	return visible;
 }
 
 /*
@@ -278,8 +278,10 @@ public:
 
 							// Finds a path around dynamic obstacles.
 	static bool				FindPathAroundObstacles( const idPhysics *physics, const idAAS *aas, const idEntity *ignore, const idVec3 &startPos, const idVec3 &seekPos, obstaclePath_t &path );
-							// Frees any nodes used for the dynamic obstacle avoidance.
+							// Frees any nodes and wall obstacles cached for the dynamic obstacle avoidance.
 	static void				FreeObstacleAvoidanceNodes();
+							// Times the dynamic obstacle avoidance of all monsters.
+	static void				BenchmarkObstacleAvoidance_f( const idCmdArgs &args );
 							// Predicts movement, returns true if a stop event was triggered.
 	static bool				PredictPath( const idEntity *ent, const idAAS *aas, const idVec3 &start, const idVec3 &velocity, int totalTime, int frameTime, int stopEvent, predictedPath_t &path );
 							// Return true if the trajectory of the clip model is collision free.
@@ -289,6 +291,9 @@ public:
 
 	virtual void			Gib( const idVec3 &dir, const char *damageDefName );
 
+							// Returns true if the next think only runs the ragdoll physics besides the death script.
+	bool					ThinksAsRagdoll() const;
+
 protected:
 	// navigation
 	idAAS *					aas;
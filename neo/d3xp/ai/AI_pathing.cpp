@@ -57,6 +57,7 @@ const int 	MAX_AAS_WALL_EDGES			= 256;
 const int 	MAX_OBSTACLES				= 256;
 const int	MAX_PATH_NODES				= 256;
 const int 	MAX_OBSTACLE_PATH			= 64;
+const int	MAX_WALL_OBSTACLE_BATCHES	= 8;
 
 typedef struct obstacle_s {
 	idVec2				bounds[2];
@@ -88,7 +89,129 @@ void pathNode_s::Init() {
 	parent = children[0] = children[1] = next = NULL;
 }
 
-idBlockAlloc<pathNode_t, 128>	pathNodeAllocator;
+/*
+===============================================================================
+
+	Path node arena
+
+	The path tree is rebuilt for every query so the nodes are taken from a
+	fixed arena which is reset at once instead of freeing the tree node by node.
+
+===============================================================================
+*/
+
+class idPathNodeArena {
+public:
+					idPathNodeArena() : numNodes( 0 ) {}
+
+	pathNode_t *	Alloc() { assert( numNodes < MAX_ARENA_NODES ); return &nodes[numNodes++]; }
+	void			Reset() { numNodes = 0; }
+	int				GetAllocCount() const { return numNodes; }
+
+private:
+	// a node is only expanded while fewer than MAX_PATH_NODES are allocated and can add two children
+	static const int MAX_ARENA_NODES = MAX_PATH_NODES + 2;
+
+	pathNode_t		nodes[MAX_ARENA_NODES];
+	int				numNodes;
+};
+
+idPathNodeArena		pathNodeArena;
+
+/*
+===============================================================================
+
+	Wall obstacle batches
+
+	The AAS wall obstacles only depend on the area, the search bounds and the
+	size of the AI. The walls are gathered once per frame for an area within
+	bounds large enough to cover nearby AI of the same size, which then only
+	select the walls touching their own search bounds.
+
+===============================================================================
+*/
+
+typedef struct wallObstacleBatch_s {
+	const idAAS *		aas;
+	int					areaNum;
+	int					frameNum;
+	float				halfBoundsSize;
+	idBounds			bounds;
+	int					numObstacles;
+	obstacle_t			obstacles[MAX_AAS_WALL_EDGES];
+} wallObstacleBatch_t;
+
+wallObstacleBatch_t	wallObstacleBatches[MAX_WALL_OBSTACLE_BATCHES];
+int					nextWallObstacleBatch;
+int					numWallObstacleBatchesBuilt;
+int					numWallObstacleBatchesShared;
+
+/*
+============
+ClearWallObstacleBatches
+============
+*/
+void ClearWallObstacleBatches() {
+	for ( int i = 0; i < MAX_WALL_OBSTACLE_BATCHES; i++ ) {
+		wallObstacleBatches[i].aas = NULL;
+		wallObstacleBatches[i].numObstacles = 0;
+	}
+	nextWallObstacleBatch = 0;
+}
+
+/*
+============
+CullObstacleBounds
+
+  Stores the indices of the obstacles with 2D bounds touching the given bounds.
+  Returns the number of indices stored. The obstacles are kept in order.
+============
+*/
+int CullObstacleBounds( const obstacle_t *obstacles, const int numObstacles, const idVec2 bounds[2], int *touching ) {
+	int i, numTouching;
+
+	numTouching = 0;
+	i = 0;
+
+#ifdef ID_WIN_X86_SSE2_INTRIN
+
+	const __m128 minX = _mm_set1_ps( bounds[0].x );
+	const __m128 minY = _mm_set1_ps( bounds[0].y );
+	const __m128 maxX = _mm_set1_ps( bounds[1].x );
+	const __m128 maxY = _mm_set1_ps( bounds[1].y );
+
+	// transpose the bounds of four obstacles and test them at once
+	for ( ; i + 3 < numObstacles; i += 4 ) {
+		__m128 b0 = _mm_loadu_ps( obstacles[i+0].bounds[0].ToFloatPtr() );
+		__m128 b1 = _mm_loadu_ps( obstacles[i+1].bounds[0].ToFloatPtr() );
+		__m128 b2 = _mm_loadu_ps( obstacles[i+2].bounds[0].ToFloatPtr() );
+		__m128 b3 = _mm_loadu_ps( obstacles[i+3].bounds[0].ToFloatPtr() );
+		_MM_TRANSPOSE4_PS( b0, b1, b2, b3 );
+
+		const __m128 outside = _mm_or_ps( _mm_or_ps( _mm_cmpgt_ps( minX, b2 ), _mm_cmpgt_ps( minY, b3 ) ),
+										_mm_or_ps( _mm_cmplt_ps( maxX, b0 ), _mm_cmplt_ps( maxY, b1 ) ) );
+		const int inside = ~_mm_movemask_ps( outside ) & 15;
+		if ( inside == 0 ) {
+			continue;
+		}
+		for ( int j = 0; j < 4; j++ ) {
+			if ( inside & ( 1 << j ) ) {
+				touching[numTouching++] = i + j;
+			}
+		}
+	}
+
+#endif
+
+	for ( ; i < numObstacles; i++ ) {
+		if ( bounds[0].x > obstacles[i].bounds[1].x || bounds[0].y > obstacles[i].bounds[1].y ||
+				bounds[1].x < obstacles[i].bounds[0].x || bounds[1].y < obstacles[i].bounds[0].y ) {
+			continue;
+		}
+		touching[numTouching++] = i;
+	}
+	return numTouching;
+}
 
 
 /*
@@ -97,10 +220,60 @@ LineIntersectsPath
 ============
 */
 bool LineIntersectsPath( const idVec2 &start, const idVec2 &end, const pathNode_t *node ) {
-	float d0, d1, d2, d3;
+	float d2, d3;
 	idVec3 plane1, plane2;
 
 	plane1 = idWinding2D::Plane2DFromPoints( start, end );
+
+#ifdef ID_WIN_X86_SSE2_INTRIN
+
+	// gather the path points, a path never has more points than the arena has nodes
+	ALIGNTYPE16 idVec2 points[MAX_PATH_NODES + 8];
+	byte sides[MAX_PATH_NODES + 8];
+	int numPoints, i;
+
+	for ( numPoints = 0; node; node = node->parent ) {
+		points[numPoints++] = node->pos;
+	}
+	for ( i = numPoints; i < ( ( numPoints + 3 ) & ~3 ); i++ ) {
+		points[i].Zero();
+	}
+
+	// get the side of the line for four path points at once
+	const __m128 px = _mm_set1_ps( plane1.x );
+	const __m128 py = _mm_set1_ps( plane1.y );
+	const __m128 pz = _mm_set1_ps( plane1.z );
+	for ( i = 0; i < numPoints; i += 4 ) {
+		const __m128 xy01 = _mm_load_ps( points[i+0].ToFloatPtr() );
+		const __m128 xy23 = _mm_load_ps( points[i+2].ToFloatPtr() );
+		const __m128 x = _mm_shuffle_ps( xy01, xy23, _MM_SHUFFLE( 2, 0, 2, 0 ) );
+		const __m128 y = _mm_shuffle_ps( xy01, xy23, _MM_SHUFFLE( 3, 1, 3, 1 ) );
+		const __m128 d = _mm_add_ps( _mm_add_ps( _mm_mul_ps( px, x ), _mm_mul_ps( py, y ) ), pz );
+		const int signs = _mm_movemask_ps( d );
+		sides[i+0] = ( signs >> 0 ) & 1;
+		sides[i+1] = ( signs >> 1 ) & 1;
+		sides[i+2] = ( signs >> 2 ) & 1;
+		sides[i+3] = ( signs >> 3 ) & 1;
+	}
+
+	// only the path edges crossing the line can intersect the line segment
+	for ( i = 0; i < numPoints - 1; i++ ) {
+		if ( sides[i] == sides[i+1] ) {
+			continue;
+		}
+		plane2 = idWinding2D::Plane2DFromPoints( points[i], points[i+1] );
+		d2 = plane2.x * start.x + plane2.y * start.y + plane2.z;
+		d3 = plane2.x * end.x + plane2.y * end.y + plane2.z;
+		if ( IEEE_FLT_SIGNBITSET( d2 ) ^ IEEE_FLT_SIGNBITSET( d3 ) ) {
+			return true;
+		}
+	}
+	return false;
+
+#else
+
+	float d0, d1;
+
 	d0 = plane1.x * node->pos.x + plane1.y * node->pos.y + plane1.z;
 	while( node->parent ) {
 		d1 = plane1.x * node->parent->pos.x + plane1.y * node->parent->pos.y + plane1.z;
@@ -116,6 +289,8 @@ bool LineIntersectsPath( const idVec2 &start, const idVec2 &end, const pathNode_
 		node = node->parent;
 	}
 	return false;
+
+#endif
 }
 
 /*
@@ -272,10 +447,12 @@ GetFirstBlockingObstacle
 ============
 */
 bool GetFirstBlockingObstacle( const obstacle_t *obstacles, int numObstacles, int skipObstacle, const idVec2 &startPos, const idVec2 &delta, float &blockingScale, int &blockingObstacle, int &blockingEdgeNum ) {
-	int i, edgeNums[2];
+	int i, j, numTouching, touching[MAX_OBSTACLES], edgeNums[2];
 	float dist, scale1, scale2;
 	idVec2 bounds[2];
 
+	assert( numObstacles <= MAX_OBSTACLES );
+
 	// get bounds for the current movement delta
 	bounds[0] = startPos - idVec2( CM_BOX_EPSILON, CM_BOX_EPSILON );
 	bounds[1] = startPos + idVec2( CM_BOX_EPSILON, CM_BOX_EPSILON );
@@ -285,14 +462,12 @@ bool GetFirstBlockingObstacle( const obstacle_t *obstacles, int numObstacles, in
 	// test for obstacles blocking the path
 	blockingScale = idMath::INFINITY;
 	dist = delta.Length();
-	for ( i = 0; i < numObstacles; i++ ) {
+	numTouching = CullObstacleBounds( obstacles, numObstacles, bounds, touching );
+	for ( j = 0; j < numTouching; j++ ) {
+		i = touching[j];
 		if ( i == skipObstacle ) {
 			continue;
 		}
-		if ( bounds[0].x > obstacles[i].bounds[1].x || bounds[0].y > obstacles[i].bounds[1].y ||
-				bounds[1].x < obstacles[i].bounds[0].x || bounds[1].y < obstacles[i].bounds[0].y ) {
-			continue;
-		}
 		if ( obstacles[i].winding.RayIntersection( startPos, delta, scale1, scale2, edgeNums ) ) {
 			if ( scale1 < blockingScale && scale1 * dist > -0.01f && scale2 * dist > 0.01f ) {
 				blockingScale = scale1;
@@ -304,6 +479,133 @@ bool GetFirstBlockingObstacle( const obstacle_t *obstacles, int numObstacles, in
 	return ( blockingScale < 1.0f );
 }
 
+/*
+============
+GetWallObstacles
+
+  Creates obstacles for the AAS wall edges within the bounds.
+============
+*/
+int GetWallObstacles( const idAAS *aas, int areaNum, const idBounds &bounds, float halfBoundsSize, obstacle_t *obstacles, int maxObstacles, bool *truncated = NULL ) {
+	int i, numObstacles, wallEdges[MAX_AAS_WALL_EDGES], numWallEdges, verts[2], lastVerts[2], nextVerts[2];
+	idVec3 start, end, nextStart, nextEnd;
+	idVec2 edgeDir, edgeNormal, nextEdgeDir, nextEdgeNormal, lastEdgeNormal;
+
+	numObstacles = 0;
+
+	numWallEdges = aas->GetWallEdges( areaNum, bounds, TFL_WALK, wallEdges, MAX_AAS_WALL_EDGES );
+	aas->SortWallEdges( wallEdges, numWallEdges );
+
+	if ( truncated ) {
+		*truncated = ( numWallEdges >= MAX_AAS_WALL_EDGES || numWallEdges > maxObstacles );
+	}
+
+	lastVerts[0] = lastVerts[1] = 0;
+	lastEdgeNormal.Zero();
+	nextVerts[0] = nextVerts[1] = 0;
+	for ( i = 0; i < numWallEdges && numObstacles < maxObstacles; i++ ) {
+		aas->GetEdge( wallEdges[i], start, end );
+		aas->GetEdgeVertexNumbers( wallEdges[i], verts );
+		edgeDir = end.ToVec2() - start.ToVec2();
+		edgeDir.Normalize();
+		edgeNormal.x = edgeDir.y;
+		edgeNormal.y = -edgeDir.x;
+		if ( i < numWallEdges-1 ) {
+			aas->GetEdge( wallEdges[i+1], nextStart, nextEnd );
+			aas->GetEdgeVertexNumbers( wallEdges[i+1], nextVerts );
+			nextEdgeDir = nextEnd.ToVec2() - nextStart.ToVec2();
+			nextEdgeDir.Normalize();
+			nextEdgeNormal.x = nextEdgeDir.y;
+			nextEdgeNormal.y = -nextEdgeDir.x;
+		}
+
+		obstacle_t &obstacle = obstacles[numObstacles++];
+		obstacle.winding.Clear();
+		obstacle.winding.AddPoint( end.ToVec2() );
+		obstacle.winding.AddPoint( start.ToVec2() );
+		obstacle.winding.AddPoint( start.ToVec2() - edgeDir - edgeNormal * halfBoundsSize );
+		obstacle.winding.AddPoint( end.ToVec2() + edgeDir - edgeNormal * halfBoundsSize );
+		if ( lastVerts[1] == verts[0] ) {
+			obstacle.winding[2] -= lastEdgeNormal * halfBoundsSize;
+		} else {
+			obstacle.winding[1] -= edgeDir;
+		}
+		if ( verts[1] == nextVerts[0] ) {
+			obstacle.winding[3] -= nextEdgeNormal * halfBoundsSize;
+		} else {
+			obstacle.winding[0] += edgeDir;
+		}
+		obstacle.winding.GetBounds( obstacle.bounds );
+		obstacle.entity = NULL;
+
+		memcpy( lastVerts, verts, sizeof( lastVerts ) );
+		lastEdgeNormal = edgeNormal;
+	}
+
+	return numObstacles;
+}
+
+/*
+============
+GetBatchedWallObstacles
+
+  Same as GetWallObstacles but shares the walls gathered for an area with all AI
+  of the same size searching within the same area and height range during this frame.
+============
+*/
+int GetBatchedWallObstacles( const idAAS *aas, int areaNum, const idBounds &bounds, float halfBoundsSize, obstacle_t *obstacles, int maxObstacles ) {
+	int i, numObstacles, numTouching, touching[MAX_AAS_WALL_EDGES];
+	idVec2 bounds2D[2];
+	wallObstacleBatch_t *batch;
+	bool truncated;
+
+	for ( i = 0; i < MAX_WALL_OBSTACLE_BATCHES; i++ ) {
+		batch = &wallObstacleBatches[i];
+		// the obstacles are culled in 2D only, so the batch must have been gathered
+		// over exactly the same height range as the query
+		if ( batch->aas == aas && batch->areaNum == areaNum && batch->frameNum == gameLocal.framenum &&
+				batch->halfBoundsSize == halfBoundsSize && batch->bounds.ContainsPoint( bounds[0] ) && batch->bounds.ContainsPoint( bounds[1] ) &&
+				batch->bounds[0].z == bounds[0].z && batch->bounds[1].z == bounds[1].z ) {
+			break;
+		}
+	}
+
+	if ( i < MAX_WALL_OBSTACLE_BATCHES ) {
+		numWallObstacleBatchesShared++;
+	} else {
+		// gather the walls for a larger part of the area so nearby AI can share them
+		batch = &wallObstacleBatches[nextWallObstacleBatch];
+		nextWallObstacleBatch = ( nextWallObstacleBatch + 1 ) % MAX_WALL_OBSTACLE_BATCHES;
+
+		batch->aas = aas;
+		batch->areaNum = areaNum;
+		batch->frameNum = gameLocal.framenum;
+		batch->halfBoundsSize = halfBoundsSize;
+		batch->bounds = bounds;
+		batch->bounds[0].ToVec2() -= idVec2( MAX_OBSTACLE_RADIUS, MAX_OBSTACLE_RADIUS );
+		batch->bounds[1].ToVec2() += idVec2( MAX_OBSTACLE_RADIUS, MAX_OBSTACLE_RADIUS );
+		batch->numObstacles = GetWallObstacles( aas, areaNum, batch->bounds, halfBoundsSize, batch->obstacles, MAX_AAS_WALL_EDGES, &truncated );
+		numWallObstacleBatchesBuilt++;
+
+		// walls close by may have been dropped from a full batch
+		if ( truncated ) {
+			batch->aas = NULL;
+			return GetWallObstacles( aas, areaNum, bounds, halfBoundsSize, obstacles, maxObstacles );
+		}
+	}
+
+	// select the walls touching the search bounds
+	bounds2D[0] = bounds[0].ToVec2();
+	bounds2D[1] = bounds[1].ToVec2();
+	numTouching = CullObstacleBounds( batch->obstacles, batch->numObstacles, bounds2D, touching );
+
+	numObstacles = Min( numTouching, maxObstacles );
+	for ( i = 0; i < numObstacles; i++ ) {
+		obstacles[i] = batch->obstacles[touching[i]];
+	}
+	return numObstacles;
+}
+
 /*
 ============
 GetObstacles
@@ -311,10 +613,9 @@ GetObstacles
 */
 int GetObstacles( const idPhysics *physics, const idAAS *aas, const idEntity *ignore, int areaNum, const idVec3 &startPos, const idVec3 &seekPos, obstacle_t *obstacles, int maxObstacles, idBounds &clipBounds ) {
 	int i, j, numListedClipModels, numObstacles, numVerts, clipMask, blockingObstacle, blockingEdgeNum;
-	int wallEdges[MAX_AAS_WALL_EDGES], numWallEdges, verts[2], lastVerts[2], nextVerts[2];
 	float stepHeight, headHeight, blockingScale, min, max;
-	idVec3 seekDelta, silVerts[32], start, end, nextStart, nextEnd;
-	idVec2 expBounds[2], edgeDir, edgeNormal, nextEdgeDir, nextEdgeNormal, lastEdgeNormal;
+	idVec3 seekDelta, silVerts[32];
+	idVec2 expBounds[2];
 	idVec2 obDelta;
 	idPhysics *obPhys;
 	idBox box;
@@ -421,49 +722,10 @@ int GetObstacles( const idPhysics *physics, const idAAS *aas, const idEntity *ig
 	if ( aas ) {
 		float halfBoundsSize = ( expBounds[ 1 ].x - expBounds[ 0 ].x ) * 0.5f;
 
-		numWallEdges = aas->GetWallEdges( areaNum, clipBounds, TFL_WALK, wallEdges, MAX_AAS_WALL_EDGES );
-		aas->SortWallEdges( wallEdges, numWallEdges );
-
-		lastVerts[0] = lastVerts[1] = 0;
-		lastEdgeNormal.Zero();
-		nextVerts[0] = nextVerts[1] = 0;
-		for ( i = 0; i < numWallEdges && numObstacles < MAX_OBSTACLES; i++ ) {
-            aas->GetEdge( wallEdges[i], start, end );
-			aas->GetEdgeVertexNumbers( wallEdges[i], verts );
-			edgeDir = end.ToVec2() - start.ToVec2();
-			edgeDir.Normalize();
-			edgeNormal.x = edgeDir.y;
-			edgeNormal.y = -edgeDir.x;
-			if ( i < numWallEdges-1 ) {
-				aas->GetEdge( wallEdges[i+1], nextStart, nextEnd );
-				aas->GetEdgeVertexNumbers( wallEdges[i+1], nextVerts );
-				nextEdgeDir = nextEnd.ToVec2() - nextStart.ToVec2();
-				nextEdgeDir.Normalize();
-				nextEdgeNormal.x = nextEdgeDir.y;
-				nextEdgeNormal.y = -nextEdgeDir.x;
-			}
-
-			obstacle_t &obstacle = obstacles[numObstacles++];
-			obstacle.winding.Clear();
-			obstacle.winding.AddPoint( end.ToVec2() );
-			obstacle.winding.AddPoint( start.ToVec2() );
-			obstacle.winding.AddPoint( start.ToVec2() - edgeDir - edgeNormal * halfBoundsSize );
-			obstacle.winding.AddPoint( end.ToVec2() + edgeDir - edgeNormal * halfBoundsSize );
-			if ( lastVerts[1] == verts[0] ) {
-				obstacle.winding[2] -= lastEdgeNormal * halfBoundsSize;
-			} else {
-				obstacle.winding[1] -= edgeDir;
-			}
-			if ( verts[1] == nextVerts[0] ) {
-				obstacle.winding[3] -= nextEdgeNormal * halfBoundsSize;
-			} else {
-				obstacle.winding[0] += edgeDir;
-			}
-			obstacle.winding.GetBounds( obstacle.bounds );
-			obstacle.entity = NULL;
-
-			memcpy( lastVerts, verts, sizeof( lastVerts ) );
-			lastEdgeNormal = edgeNormal;
+		if ( ai_batchObstacles.GetBool() ) {
+			numObstacles += GetBatchedWallObstacles( aas, areaNum, clipBounds, halfBoundsSize, obstacles + numObstacles, MAX_OBSTACLES - numObstacles );
+		} else {
+			numObstacles += GetWallObstacles( aas, areaNum, clipBounds, halfBoundsSize, obstacles + numObstacles, MAX_OBSTACLES - numObstacles );
 		}
 	}
 
@@ -484,20 +746,6 @@ int GetObstacles( const idPhysics *physics, const idAAS *aas, const idEntity *ig
 	return numObstacles;
 }
 
-/*
-============
-FreePathTree_r
-============
-*/
-void FreePathTree_r( pathNode_t *node ) {
-	if ( node->children[0] ) {
-		FreePathTree_r( node->children[0] );
-	}
-	if ( node->children[1] ) {
-		FreePathTree_r( node->children[1] );
-	}
-	pathNodeAllocator.Free( node );
-}
 
 /*
 ============
@@ -599,7 +847,7 @@ pathNode_t *BuildPathTree( const obstacle_t *obstacles, int numObstacles, const
 	// gcc 4.0
 	idQueueTemplate<pathNode_t, offsetof( pathNode_t, next ) > pathNodeQueue, treeQueue;
 
-	root = pathNodeAllocator.Alloc();
+	root = pathNodeArena.Alloc();
 	root->Init();
 	root->pos = startPos;
 
@@ -607,7 +855,7 @@ pathNode_t *BuildPathTree( const obstacle_t *obstacles, int numObstacles, const
 	root->numNodes = 0;
 	pathNodeQueue.Add( root );
 
-	for ( node = pathNodeQueue.Get(); node != NULL && pathNodeAllocator.GetAllocCount() < MAX_PATH_NODES; node = pathNodeQueue.Get() ) {
+	for ( node = pathNodeQueue.Get(); node != NULL && pathNodeArena.GetAllocCount() < MAX_PATH_NODES; node = pathNodeQueue.Get() ) {
 
 		treeQueue.Add( node );
 
@@ -633,9 +881,9 @@ pathNode_t *BuildPathTree( const obstacle_t *obstacles, int numObstacles, const
 			node->delta *= blockingScale;
 
 			if ( node->edgeNum == -1 ) {
-				node->children[0] = pathNodeAllocator.Alloc();
+				node->children[0] = pathNodeArena.Alloc();
 				node->children[0]->Init();
-				node->children[1] = pathNodeAllocator.Alloc();
+				node->children[1] = pathNodeArena.Alloc();
 				node->children[1]->Init();
 				node->children[0]->dir = 0;
 				node->children[1]->dir = 1;
@@ -651,7 +899,7 @@ pathNode_t *BuildPathTree( const obstacle_t *obstacles, int numObstacles, const
 					pathNodeQueue.Add( node->children[1] );
 				}
 			} else {
-				node->children[node->dir] = child = pathNodeAllocator.Alloc();
+				node->children[node->dir] = child = pathNodeArena.Alloc();
 				child->Init();
 				child->dir = node->dir;
 				child->parent = node;
@@ -664,7 +912,7 @@ pathNode_t *BuildPathTree( const obstacle_t *obstacles, int numObstacles, const
 				}
 			}
 		} else {
-			node->children[node->dir] = child = pathNodeAllocator.Alloc();
+			node->children[node->dir] = child = pathNodeArena.Alloc();
 			child->Init();
 			child->dir = node->dir;
 			child->parent = node;
@@ -726,12 +974,9 @@ void PrunePathTree( pathNode_t *root, const idVec2 &seekPos ) {
 				}
 			}
 
-			// free tree down from the best node
+			// cut the tree down from the best node, the nodes are released with the arena
 			for ( i = 0; i < 2; i++ ) {
-				if ( bestNode->children[i] ) {
-					FreePathTree_r( bestNode->children[i] );
-					bestNode->children[i] = NULL;
-				}
+				bestNode->children[i] = NULL;
 			}
 
 			for ( lastNode = bestNode, node = bestNode->parent; node; lastNode = node, node = node->parent ) {
@@ -750,7 +995,7 @@ OptimizePath
 ============
 */
 int OptimizePath( const pathNode_t *root, const pathNode_t *leafNode, const obstacle_t *obstacles, int numObstacles, idVec2 optimizedPath[MAX_OBSTACLE_PATH] ) {
-	int i, numPathPoints, edgeNums[2];
+	int i, j, numPathPoints, numTouching, touching[MAX_OBSTACLES], edgeNums[2];
 	const pathNode_t *curNode, *nextNode;
 	idVec2 curPos, curDelta, bounds[2];
 	float scale1, scale2, curLength;
@@ -778,11 +1023,9 @@ int OptimizePath( const pathNode_t *root, const pathNode_t *leafNode, const obst
 			bounds[IEEE_FLT_SIGNBITNOTSET(curDelta.y)].y += curDelta.y;
 
 			// test if the shortcut intersects with any obstacles
-			for ( i = 0; i < numObstacles; i++ ) {
-				if ( bounds[0].x > obstacles[i].bounds[1].x || bounds[0].y > obstacles[i].bounds[1].y ||
-						bounds[1].x < obstacles[i].bounds[0].x || bounds[1].y < obstacles[i].bounds[0].y ) {
-					continue;
-				}
+			numTouching = CullObstacleBounds( obstacles, numObstacles, bounds, touching );
+			for ( j = 0; j < numTouching; j++ ) {
+				i = touching[j];
 				if ( obstacles[i].winding.RayIntersection( curPos, curDelta, scale1, scale2, edgeNums ) ) {
 					if ( scale1 >= 0.0f && scale1 <= 1.0f && ( i != nextNode->obstacle || scale1 * curLength < curLength - 0.5f ) ) {
 						break;
@@ -792,7 +1035,7 @@ int OptimizePath( const pathNode_t *root, const pathNode_t *leafNode, const obst
 					}
 				}
 			}
-			if ( i >= numObstacles ) {
+			if ( j >= numTouching ) {
 				break;
 			}
 		}
@@ -981,6 +1224,7 @@ bool idAI::FindPathAroundObstacles( const idPhysics *physics, const idAAS *aas,
 	}
 
 	// build a path tree
+	pathNodeArena.Reset();
 	root = BuildPathTree( obstacles, numObstacles, clipBounds, path.startPosOutsideObstacles.ToVec2(), path.seekPosOutsideObstacles.ToVec2(), path );
 
 	// draw the path tree
@@ -994,9 +1238,6 @@ bool idAI::FindPathAroundObstacles( const idPhysics *physics, const idAAS *aas,
 	// find the optimal path
 	pathToGoalExists = FindOptimalPath( root, obstacles, numObstacles, physics->GetOrigin().z, physics->GetLinearVelocity(), path.seekPos );
 
-	// free the tree
-	FreePathTree_r( root );
-
 	return pathToGoalExists;
 }
 
@@ -1006,7 +1247,91 @@ idAI::FreeObstacleAvoidanceNodes
 ============
 */
 void idAI::FreeObstacleAvoidanceNodes() {
-	pathNodeAllocator.Shutdown();
+	pathNodeArena.Reset();
+	ClearWallObstacleBatches();
+}
+
+/*
+============
+idAI::BenchmarkObstacleAvoidance_f
+
+  Times the obstacle avoidance of all monsters for a number of frames with and
+  without sharing the wall obstacles. Optionally spawns a crowd of monsters
+  in front of the player first.
+============
+*/
+void idAI::BenchmarkObstacleAvoidance_f( const idCmdArgs &args ) {
+	int i, e, numFrames, mode, frame, numFound;
+	idList<idAI *> monsters;
+	obstaclePath_t path;
+	idVec3 seekPos;
+	idPlayer *player;
+	idAI *check;
+
+	player = gameLocal.GetLocalPlayer();
+	if ( !player || !gameLocal.CheatsOk() ) {
+		return;
+	}
+
+	if ( args.Argc() != 2 && args.Argc() != 4 ) {
+		gameLocal.Printf( "usage: aiBenchmarkObstacles <numFrames> [monsterDef numMonsters]\n" );
+		return;
+	}
+
+	numFrames = Max( atoi( args.Argv( 1 ) ), 1 );
+
+	// spawn a crowd on a grid in front of the player
+	if ( args.Argc() == 4 ) {
+		if ( !gameLocal.SpawnBenchmarkGrid( args.Argv( 2 ), atoi( args.Argv( 3 ) ), 64.0f, 1.0f ) ) {
+			return;
+		}
+	}
+
+	for ( e = 0; e < MAX_GENTITIES; e++ ) {
+		check = static_cast<idAI *>( gameLocal.entities[ e ] );
+		if ( !check || !check->IsType( idAI::Type ) || !check->aas || check->health <= 0 ) {
+			continue;
+		}
+		monsters.Append( check );
+	}
+	if ( monsters.Num() == 0 ) {
+		gameLocal.Printf( "no monsters with an AAS\n" );
+		return;
+	}
+
+	const bool batchObstacles = ai_batchObstacles.GetBool();
+
+	for ( mode = 0; mode < 2; mode++ ) {
+		ai_batchObstacles.SetBool( mode != 0 );
+		numWallObstacleBatchesBuilt = 0;
+		numWallObstacleBatchesShared = 0;
+		numFound = 0;
+
+		const uint64 startTime = Sys_Microseconds();
+		for ( frame = 0; frame < numFrames; frame++ ) {
+			// every pass is a new frame for the wall obstacle batches
+			ClearWallObstacleBatches();
+			for ( i = 0; i < monsters.Num(); i++ ) {
+				check = monsters[i];
+				seekPos = check->move.moveDest;
+				if ( ( seekPos - check->physicsObj.GetOrigin() ).LengthSqr() < Square( 16.0f ) ) {
+					seekPos = player->GetPhysics()->GetOrigin();
+				}
+				if ( FindPathAroundObstacles( &check->physicsObj, check->aas, check->enemy.GetEntity(), check->physicsObj.GetOrigin(), seekPos, path ) ) {
+					numFound++;
+				}
+			}
+		}
+		const uint64 endTime = Sys_Microseconds();
+
+		const float msec = ( endTime - startTime ) / 1000.0f;
+		gameLocal.Printf( "%s: %d monsters, %d frames, %.2f msec per frame, %.1f usec per query, %d paths, %d wall batches built, %d shared\n",
+							mode ? "batched" : "per monster", monsters.Num(), numFrames, msec / numFrames, msec * 1000.0f / ( numFrames * monsters.Num() ),
+							numFound, numWallObstacleBatchesBuilt, numWallObstacleBatchesShared );
+	}
+
+	ai_batchObstacles.SetBool( batchObstacles );
+	ClearWallObstacleBatches();
 }
 
 
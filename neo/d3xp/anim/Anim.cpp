@@ -33,12 +33,17 @@ If you have questions concerning this license or the applicable additional terms
 #include "../Game_local.h"
 
 idCVar binaryLoadAnim( "binaryLoadAnim", "1", 0, "enable binary load/write of idMD5Anim" );
+idCVar anim_compress( "anim_compress", "1", CVAR_GAME | CVAR_BOOL, "store animation frames as 16 bit components with reduced key frames, takes effect when anims are loaded" );
 
 static const byte B_ANIM_MD5_VERSION = 101;
 static const unsigned int B_ANIM_MD5_MAGIC = ( 'B' << 24 ) | ( 'M' << 16 ) | ( 'D' << 8 ) | B_ANIM_MD5_VERSION;
 
 static const int JOINT_FRAME_PAD	= 1;	// one extra to be able to read one more float than is necessary
 
+static const int ANIM_MAX_KEY_SPACING				= 8;		// maximum number of frames between two keys
+static const float ANIM_COMPRESS_TRANSLATION_EPSILON	= 0.01f;	// maximum translation error of a frame removed between keys
+static const float ANIM_COMPRESS_QUAT_EPSILON		= 0.0001f;	// maximum quaternion component error of a frame removed between keys
+
 bool idAnimManager::forceExport = false;
 
 /***********************************************************************
@@ -59,6 +64,8 @@ idMD5Anim::idMD5Anim() {
 	frameRate	= 24;
 	animLength	= 0;
 	numAnimatedComponents = 0;
+	numKeys		= 0;
+	numPaddedComponents = 0;
 	totaldelta.Zero();
 }
 
@@ -82,6 +89,8 @@ void idMD5Anim::Free() {
 	frameRate	= 24;
 	animLength	= 0;
 	numAnimatedComponents = 0;
+	numKeys		= 0;
+	numPaddedComponents = 0;
 	//name		= "";
 
 	totaldelta.Zero();
@@ -89,6 +98,11 @@ void idMD5Anim::Free() {
 	jointInfo.Clear();
 	bounds.Clear();
 	componentFrames.Clear();
+	componentMin.Clear();
+	componentScale.Clear();
+	quantizedKeys.Clear();
+	keyFrames.Clear();
+	frameKeys.Clear();
 }
 
 /*
@@ -157,6 +171,7 @@ idMD5Anim::Allocated
 */
 size_t idMD5Anim::Allocated() const {
 	size_t	size = bounds.Allocated() + jointInfo.Allocated() + componentFrames.Allocated() + name.Allocated();
+	size += componentMin.Allocated() + componentScale.Allocated() + quantizedKeys.Allocated() + keyFrames.Allocated() + frameKeys.Allocated();
 	return size;
 }
 
@@ -180,6 +195,7 @@ bool idMD5Anim::LoadAnim( const char * filename ) {
 	idFileLocal file( fileSystem->OpenFileReadMemory( generatedFileName ) );
 	if ( binaryLoadAnim.GetBool() && LoadBinary( file, sourceTimeStamp ) ) {
 		name = filename;
+		Compress();
 		if ( cvarSystem->GetCVarBool( "fs_buildresources" ) ) {
 			// for resource gathering write this anim to the preload file for this map
 			fileSystem->AddAnimPreload( name );
@@ -356,6 +372,8 @@ bool idMD5Anim::LoadAnim( const char * filename ) {
 		WriteBinary( outputFile, sourceTimeStamp );
 	}
 
+	Compress();
+
 	// done
 	return true;
 }
@@ -498,6 +516,204 @@ void idMD5Anim::WriteBinary( idFile * file, ID_TIME_T sourceTimeStamp ) {
 	//file->WriteBig( ref_count );
 }
 
+/*
+========================
+idMD5Anim::Compress
+
+Quantizes all animated components to 16 bits relative to the range of each
+component over the whole animation and only keeps the frames that can not be
+linearly interpolated from the surrounding keys within a small error.
+========================
+*/
+void idMD5Anim::Compress() {
+	numKeys = 0;
+	numPaddedComponents = 0;
+	componentMin.Clear();
+	componentScale.Clear();
+	quantizedKeys.Clear();
+	keyFrames.Clear();
+	frameKeys.Clear();
+
+	if ( !anim_compress.GetBool() || numAnimatedComponents == 0 || numFrames > 0xFFFF ) {
+		return;
+	}
+
+	const int numPadded = ( numAnimatedComponents + 7 ) & ~7;
+
+	// the error allowed for each component depends on whether it is a translation or a quaternion component
+	idList<float> tolerance;
+	tolerance.SetNum( numAnimatedComponents );
+	for ( int c = 0; c < numAnimatedComponents; c++ ) {
+		tolerance[c] = ANIM_COMPRESS_QUAT_EPSILON;
+	}
+	for ( int i = 0; i < jointInfo.Num(); i++ ) {
+		int c = jointInfo[i].firstComponent;
+		for ( int bit = 0; bit < 6; bit++ ) {
+			if ( jointInfo[i].animBits & BIT( bit ) ) {
+				if ( c < numAnimatedComponents ) {
+					tolerance[c] = ( bit < ANIM_BIT_QX ) ? ANIM_COMPRESS_TRANSLATION_EPSILON : ANIM_COMPRESS_QUAT_EPSILON;
+				}
+				c++;
+			}
+		}
+	}
+
+	componentMin.SetGranularity( 1 );
+	componentMin.SetNum( numPadded );
+	componentScale.SetGranularity( 1 );
+	componentScale.SetNum( numPadded );
+	for ( int c = 0; c < numPadded; c++ ) {
+		if ( c >= numAnimatedComponents ) {
+			componentMin[c] = 0.0f;
+			componentScale[c] = 0.0f;
+			continue;
+		}
+		float minValue = componentFrames[c];
+		float maxValue = componentFrames[c];
+		for ( int f = 1; f < numFrames; f++ ) {
+			minValue = Min( minValue, componentFrames[f * numAnimatedComponents + c] );
+			maxValue = Max( maxValue, componentFrames[f * numAnimatedComponents + c] );
+		}
+		componentMin[c] = minValue;
+		componentScale[c] = ( maxValue - minValue ) / 65535.0f;
+	}
+
+	// quantize all frames
+	idList<unsigned short> quantized;
+	quantized.SetNum( numFrames * numPadded );
+	for ( int f = 0; f < numFrames; f++ ) {
+		for ( int c = 0; c < numPadded; c++ ) {
+			unsigned short q = 0;
+			if ( c < numAnimatedComponents && componentScale[c] > 0.0f ) {
+				q = (unsigned short)idMath::ClampInt( 0, 65535, idMath::Ftoi( ( componentFrames[f * numAnimatedComponents + c] - componentMin[c] ) / componentScale[c] + 0.5f ) );
+			}
+			quantized[f * numPadded + c] = q;
+		}
+	}
+
+	// greedily extend the distance to the next key while all frames in between can be interpolated
+	keyFrames.SetGranularity( 1 );
+	keyFrames.Append( 0 );
+	int key = 0;
+	while ( key < numFrames - 1 ) {
+		int next = key + 1;
+		for ( int end = key + 2; end < numFrames && end - key <= ANIM_MAX_KEY_SPACING; end++ ) {
+			const unsigned short *q1 = &quantized[key * numPadded];
+			const unsigned short *q2 = &quantized[end * numPadded];
+			bool fits = true;
+			for ( int f = key + 1; f < end && fits; f++ ) {
+				const float lerp = (float)( f - key ) / ( end - key );
+				const float *original = &componentFrames[f * numAnimatedComponents];
+				for ( int c = 0; c < numAnimatedComponents; c++ ) {
+					const float value = componentMin[c] + ( q1[c] + ( (float)q2[c] - (float)q1[c] ) * lerp ) * componentScale[c];
+					if ( idMath::Fabs( value - original[c] ) > tolerance[c] + componentScale[c] ) {
+						fits = false;
+						break;
+					}
+				}
+			}
+			if ( !fits ) {
+				break;
+			}
+			next = end;
+		}
+		keyFrames.Append( (unsigned short)next );
+		key = next;
+	}
+
+	numKeys = keyFrames.Num();
+	numPaddedComponents = numPadded;
+
+	quantizedKeys.SetGranularity( 1 );
+	quantizedKeys.SetNum( numKeys * numPadded );
+	frameKeys.SetGranularity( 1 );
+	frameKeys.SetNum( numFrames );
+	for ( int k = 0; k < numKeys; k++ ) {
+		memcpy( &quantizedKeys[k * numPadded], &quantized[keyFrames[k] * numPadded], numPadded * sizeof( quantizedKeys[0] ) );
+		const int lastFrame = ( k + 1 < numKeys ) ? keyFrames[k + 1] : numFrames;
+		for ( int f = keyFrames[k]; f < lastFrame; f++ ) {
+			frameKeys[f] = (unsigned short)k;
+		}
+	}
+
+	componentFrames.Clear();
+}
+
+/*
+====================
+DequantizeKeys
+
+Decodes components interpolated between two quantized keys.
+====================
+*/
+static void DequantizeKeys( float *dest, const unsigned short *key1, const unsigned short *key2, const float lerp,
+							const float *componentMin, const float *componentScale, const int numComponents ) {
+	int i = 0;
+
+#ifdef ID_WIN_X86_SSE2_INTRIN
+
+	const __m128 vlerp = _mm_set1_ps( lerp );
+	const __m128i zero = _mm_setzero_si128();
+	for ( ; i + 7 < numComponents; i += 8 ) {
+		const __m128i q1 = _mm_loadu_si128( (const __m128i *)( key1 + i ) );
+		const __m128i q2 = _mm_loadu_si128( (const __m128i *)( key2 + i ) );
+		__m128 a0 = _mm_cvtepi32_ps( _mm_unpacklo_epi16( q1, zero ) );
+		__m128 a1 = _mm_cvtepi32_ps( _mm_unpackhi_epi16( q1, zero ) );
+		const __m128 b0 = _mm_cvtepi32_ps( _mm_unpacklo_epi16( q2, zero ) );
+		const __m128 b1 = _mm_cvtepi32_ps( _mm_unpackhi_epi16( q2, zero ) );
+		a0 = _mm_add_ps( a0, _mm_mul_ps( _mm_sub_ps( b0, a0 ), vlerp ) );
+		a1 = _mm_add_ps( a1, _mm_mul_ps( _mm_sub_ps( b1, a1 ), vlerp ) );
+		_mm_storeu_ps( dest + i + 0, _mm_add_ps( _mm_loadu_ps( componentMin + i + 0 ), _mm_mul_ps( a0, _mm_loadu_ps( componentScale + i + 0 ) ) ) );
+		_mm_storeu_ps( dest + i + 4, _mm_add_ps( _mm_loadu_ps( componentMin + i + 4 ), _mm_mul_ps( a1, _mm_loadu_ps( componentScale + i + 4 ) ) ) );
+	}
+
+#endif
+
+	for ( ; i < numComponents; i++ ) {
+		const float q = key1[i] + ( (float)key2[i] - (float)key1[i] ) * lerp;
+		dest[i] = componentMin[i] + q * componentScale[i];
+	}
+}
+
+/*
+====================
+idMD5Anim::GetFrameComponents
+
+Returns a pointer to the requested components of a frame, compressed frames are decoded into the buffer.
+====================
+*/
+const float * idMD5Anim::GetFrameComponents( int framenum, int firstComponent, int numComponents, float *buffer ) const {
+	if ( !IsCompressed() ) {
+		return &componentFrames[ numAnimatedComponents * framenum + firstComponent ];
+	}
+
+	const int key = frameKeys[framenum];
+	const unsigned short *key1 = &quantizedKeys[key * numPaddedComponents + firstComponent];
+	if ( keyFrames[key] == framenum ) {
+		DequantizeKeys( buffer, key1, key1, 0.0f, &componentMin[firstComponent], &componentScale[firstComponent], numComponents );
+	} else {
+		const unsigned short *key2 = key1 + numPaddedComponents;
+		const float lerp = (float)( framenum - keyFrames[key] ) / ( keyFrames[key + 1] - keyFrames[key] );
+		DequantizeKeys( buffer, key1, key2, lerp, &componentMin[firstComponent], &componentScale[firstComponent], numComponents );
+	}
+	return buffer;
+}
+
+/*
+====================
+NumAnimBitComponents
+====================
+*/
+static int NumAnimBitComponents( int animBits ) {
+	int num = 0;
+	for ( int bit = 0; bit < 6; bit++ ) {
+		if ( animBits & BIT( bit ) ) {
+			num++;
+		}
+	}
+	return num;
+}
+
 /*
 ====================
 idMD5Anim::IncreaseRefs
@@ -612,8 +828,10 @@ void idMD5Anim::GetOrigin( idVec3 &offset, int time, int cyclecount ) const {
 	frameBlend_t frame;
 	ConvertTimeToFrame( time, cyclecount, frame );
 
-	const float *componentPtr1 = &componentFrames[ numAnimatedComponents * frame.frame1 + jointInfo[ 0 ].firstComponent ];
-	const float *componentPtr2 = &componentFrames[ numAnimatedComponents * frame.frame2 + jointInfo[ 0 ].firstComponent ];
+	float buffer1[8], buffer2[8];
+	const int numComponents = NumAnimBitComponents( jointInfo[ 0 ].animBits );
+	const float *componentPtr1 = GetFrameComponents( frame.frame1, jointInfo[ 0 ].firstComponent, numComponents, buffer1 );
+	const float *componentPtr2 = GetFrameComponents( frame.frame2, jointInfo[ 0 ].firstComponent, numComponents, buffer2 );
 
 	if ( jointInfo[ 0 ].animBits & ANIM_TX ) {
 		offset.x = *componentPtr1 * frame.frontlerp + *componentPtr2 * frame.backlerp;
@@ -652,8 +870,10 @@ void idMD5Anim::GetOriginRotation( idQuat &rotation, int time, int cyclecount )
 	frameBlend_t frame;
 	ConvertTimeToFrame( time, cyclecount, frame );
 
-	const float	*jointframe1 = &componentFrames[ numAnimatedComponents * frame.frame1 + jointInfo[ 0 ].firstComponent ];
-	const float	*jointframe2 = &componentFrames[ numAnimatedComponents * frame.frame2 + jointInfo[ 0 ].firstComponent ];
+	float buffer1[8], buffer2[8];
+	const int numComponents = NumAnimBitComponents( animBits );
+	const float	*jointframe1 = GetFrameComponents( frame.frame1, jointInfo[ 0 ].firstComponent, numComponents, buffer1 );
+	const float	*jointframe2 = GetFrameComponents( frame.frame2, jointInfo[ 0 ].firstComponent, numComponents, buffer2 );
 
 	if ( animBits & ANIM_TX ) {
 		jointframe1++;
@@ -764,8 +984,10 @@ void idMD5Anim::GetBounds( idBounds &bnds, int time, int cyclecount ) const {
 	// origin position
 	idVec3 offset = baseFrame[ 0 ].t;
 	if ( jointInfo[ 0 ].animBits & ( ANIM_TX | ANIM_TY | ANIM_TZ ) ) {
-		const float *componentPtr1 = &componentFrames[ numAnimatedComponents * frame.frame1 + jointInfo[ 0 ].firstComponent ];
-		const float *componentPtr2 = &componentFrames[ numAnimatedComponents * frame.frame2 + jointInfo[ 0 ].firstComponent ];
+		float buffer1[8], buffer2[8];
+		const int numComponents = NumAnimBitComponents( jointInfo[ 0 ].animBits );
+		const float *componentPtr1 = GetFrameComponents( frame.frame1, jointInfo[ 0 ].firstComponent, numComponents, buffer1 );
+		const float *componentPtr2 = GetFrameComponents( frame.frame2, jointInfo[ 0 ].firstComponent, numComponents, buffer2 );
 
 		if ( jointInfo[ 0 ].animBits & ANIM_TX ) {
 			offset.x = *componentPtr1 * frame.frontlerp + *componentPtr2 * frame.backlerp;
@@ -867,8 +1089,15 @@ void idMD5Anim::GetInterpolatedFrame( frameBlend_t &frame, idJointQuat *joints,
 	idJointQuat * blendJoints = (idJointQuat *)_alloca16( baseFrame.Num() * sizeof( blendJoints[ 0 ] ) );
 	int * lerpIndex = (int *)_alloca16( baseFrame.Num() * sizeof( lerpIndex[ 0 ] ) );
 
-	const float * frame1 = &componentFrames[frame.frame1 * numAnimatedComponents];
-	const float * frame2 = &componentFrames[frame.frame2 * numAnimatedComponents];
+	float * buffer1 = NULL;
+	float * buffer2 = NULL;
+	if ( IsCompressed() ) {
+		buffer1 = (float *)_alloca16( ( numPaddedComponents + JOINT_FRAME_PAD ) * sizeof( buffer1[ 0 ] ) );
+		buffer2 = (float *)_alloca16( ( numPaddedComponents + JOINT_FRAME_PAD ) * sizeof( buffer2[ 0 ] ) );
+	}
+
+	const float * frame1 = GetFrameComponents( frame.frame1, 0, numAnimatedComponents, buffer1 );
+	const float * frame2 = GetFrameComponents( frame.frame2, 0, numAnimatedComponents, buffer2 );
 
 	int numLerpJoints = DecodeInterpolatedFrames( joints, blendJoints, lerpIndex, frame1, frame2, jointInfo.Ptr(), index, numIndexes );
 
@@ -940,11 +1169,71 @@ void idMD5Anim::GetSingleFrame( int framenum, idJointQuat *joints, const int *in
 		return;
 	}
 
-	const float * frame = &componentFrames[framenum * numAnimatedComponents];
+	float * buffer = NULL;
+	if ( IsCompressed() ) {
+		buffer = (float *)_alloca16( ( numPaddedComponents + JOINT_FRAME_PAD ) * sizeof( buffer[ 0 ] ) );
+	}
+
+	const float * frame = GetFrameComponents( framenum, 0, numAnimatedComponents, buffer );
 
 	DecodeSingleFrame( joints, frame, jointInfo.Ptr(), index, numIndexes );
 }
 
+/*
+====================
+idMD5Anim::TestDecode
+
+Compares the size of the frames with the uncompressed format and times
+decoding all frames from both formats.
+====================
+*/
+void idMD5Anim::TestDecode( int &keys, size_t &rawBytes, size_t &compressedBytes, uint64 &rawMicroseconds, uint64 &decodeMicroseconds ) const {
+	const int numPasses = 16;
+
+	keys = IsCompressed() ? numKeys : numFrames;
+	rawBytes = ( numFrames * numAnimatedComponents + JOINT_FRAME_PAD ) * sizeof( float );
+	compressedBytes = componentFrames.Allocated() + componentMin.Allocated() + componentScale.Allocated() + quantizedKeys.Allocated() + keyFrames.Allocated() + frameKeys.Allocated();
+	rawMicroseconds = 0;
+	decodeMicroseconds = 0;
+
+	if ( numAnimatedComponents == 0 || numFrames < 2 ) {
+		return;
+	}
+
+	// expand all frames to the uncompressed format
+	idList<float> frames;
+	frames.SetNum( numFrames * numAnimatedComponents + JOINT_FRAME_PAD );
+	frames[ numFrames * numAnimatedComponents ] = 0.0f;
+	float * buffer = (float *)_alloca16( ( Max( numPaddedComponents, numAnimatedComponents ) + JOINT_FRAME_PAD ) * sizeof( buffer[ 0 ] ) );
+	for ( int i = 0; i < numFrames; i++ ) {
+		memcpy( &frames[ i * numAnimatedComponents ], GetFrameComponents( i, 0, numAnimatedComponents, buffer ), numAnimatedComponents * sizeof( float ) );
+	}
+
+	idList<int> index;
+	index.SetNum( jointInfo.Num() );
+	for ( int i = 0; i < index.Num(); i++ ) {
+		index[ i ] = i;
+	}
+	idJointQuat * joints = (idJointQuat *)_alloca16( baseFrame.Num() * sizeof( joints[ 0 ] ) );
+
+	uint64 start = Sys_Microseconds();
+	for ( int pass = 0; pass < numPasses; pass++ ) {
+		for ( int i = 1; i < numFrames; i++ ) {
+			SIMDProcessor->Memcpy( joints, baseFrame.Ptr(), baseFrame.Num() * sizeof( baseFrame[ 0 ] ) );
+			DecodeSingleFrame( joints, &frames[ i * numAnimatedComponents ], jointInfo.Ptr(), index.Ptr(), index.Num() );
+		}
+	}
+	rawMicroseconds = Sys_Microseconds() - start;
+
+	start = Sys_Microseconds();
+	for ( int pass = 0; pass < numPasses; pass++ ) {
+		for ( int i = 1; i < numFrames; i++ ) {
+			GetSingleFrame( i, joints, index.Ptr(), index.Num() );
+		}
+	}
+	decodeMicroseconds = Sys_Microseconds() - start;
+}
+
 /*
 ====================
 idMD5Anim::CheckModelHierarchy
@@ -990,6 +1279,7 @@ idAnimManager::idAnimManager
 ====================
 */
 idAnimManager::idAnimManager() {
+	createFramesJobList = NULL;
 }
 
 /*
@@ -1001,6 +1291,17 @@ idAnimManager::~idAnimManager() {
 	Shutdown();
 }
 
+/*
+====================
+idAnimManager::Init
+====================
+*/
+void idAnimManager::Init() {
+	if ( createFramesJobList == NULL ) {
+		createFramesJobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, MAX_CREATE_FRAMES_JOBS, 0, NULL );
+	}
+}
+
 /*
 ====================
 idAnimManager::Shutdown
@@ -1010,6 +1311,10 @@ void idAnimManager::Shutdown() {
 	animations.DeleteContents();
 	jointnames.Clear();
 	jointnamesHash.Free();
+	if ( createFramesJobList != NULL ) {
+		parallelJobManager->FreeJobList( createFramesJobList );
+		createFramesJobList = NULL;
+	}
 }
 
 /*
@@ -1056,6 +1361,20 @@ void idAnimManager::Preload( const idPreloadManifest &manifest ) {
 		common->Printf( "Preloading anims...\n" );
 		int	start = Sys_Milliseconds();
 		int numLoaded = 0;
+
+		// read the binary anims on job threads while the ones before them are set up
+		idStrList preloadFiles;
+		for ( int i = 0; i < manifest.NumResources(); i++ ) {
+			const preloadEntry_s & p = manifest.GetPreloadByIndex( i );
+			if ( p.resType == PRELOAD_ANIM && !animations.Get( p.resourceName ) ) {
+				idStr generatedFileName = "generated/anim/";
+				generatedFileName.AppendPath( p.resourceName );
+				generatedFileName.SetFileExtension( ".bMD5anim" );
+				preloadFiles.Append( generatedFileName );
+			}
+		}
+		fileSystem->StartPreload( preloadFiles );
+
 		for ( int i = 0; i < manifest.NumResources(); i++ ) {
 			const preloadEntry_s & p = manifest.GetPreloadByIndex( i );
 			if ( p.resType == PRELOAD_ANIM ) {
@@ -1063,6 +1382,7 @@ void idAnimManager::Preload( const idPreloadManifest &manifest ) {
 				numLoaded++;
 			}
 		}
+		fileSystem->StopPreload();
 		int	end = Sys_Milliseconds();
 		common->Printf( "%05d anims preloaded ( or were already loaded ) in %5.1f seconds\n", numLoaded, ( end - start ) * 0.001 );
 		common->Printf( "----------------------------------------\n" );
@@ -1151,6 +1471,45 @@ void idAnimManager::ListAnims() const {
 	gameLocal.Printf( "%d memory used in %d joint names\n", namesize, jointnames.Num() );
 }
 
+/*
+================
+idAnimManager::TestCompression
+================
+*/
+void idAnimManager::TestCompression() const {
+	int			i, keys, frames, totalKeys, totalFrames, num;
+	idMD5Anim	**animptr;
+	idMD5Anim	*anim;
+	size_t		rawBytes, compressedBytes, totalRawBytes, totalCompressedBytes;
+	uint64		rawMicroseconds, decodeMicroseconds, totalRawMicroseconds, totalDecodeMicroseconds;
+
+	num = totalKeys = totalFrames = 0;
+	totalRawBytes = totalCompressedBytes = 0;
+	totalRawMicroseconds = totalDecodeMicroseconds = 0;
+	for( i = 0; i < animations.Num(); i++ ) {
+		animptr = animations.GetIndex( i );
+		if ( animptr != NULL && *animptr != NULL ) {
+			anim = *animptr;
+			anim->TestDecode( keys, rawBytes, compressedBytes, rawMicroseconds, decodeMicroseconds );
+			frames = anim->NumFrames();
+			gameLocal.Printf( "%8d -> %8d bytes : %4d / %4d keys : %6.2f / %6.2f msec : %s\n", rawBytes, compressedBytes, keys, frames,
+								rawMicroseconds * 0.001f, decodeMicroseconds * 0.001f, anim->Name() );
+			totalKeys += keys;
+			totalFrames += frames;
+			totalRawBytes += rawBytes;
+			totalCompressedBytes += compressedBytes;
+			totalRawMicroseconds += rawMicroseconds;
+			totalDecodeMicroseconds += decodeMicroseconds;
+			num++;
+		}
+	}
+
+	gameLocal.Printf( "\n%d anims, %d of %d frames stored as keys\n", num, totalKeys, totalFrames );
+	gameLocal.Printf( "frame memory: %d bytes uncompressed, %d bytes as stored (%.1f%%)\n", totalRawBytes, totalCompressedBytes,
+						totalRawBytes ? 100.0f * totalCompressedBytes / totalRawBytes : 0.0f );
+	gameLocal.Printf( "decoding all frames 16 times: %.2f msec uncompressed, %.2f msec as stored\n", totalRawMicroseconds * 0.001f, totalDecodeMicroseconds * 0.001f );
+}
+
 /*
 ================
 idAnimManager::FlushUnusedAnims
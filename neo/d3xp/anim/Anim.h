@@ -35,6 +35,9 @@ const int ANIM_NumAnimChannels		= 5;
 const int ANIM_MaxAnimsPerChannel	= 3;
 const int ANIM_MaxSyncedAnims		= 3;
 
+// size of the job list used to create animation frames in parallel
+const int MAX_CREATE_FRAMES_JOBS	= 256;
+
 //
 // animation channels.  make sure to change script/doom_defs.script if you add any channels, or change their order
 //
@@ -202,6 +205,14 @@ private:
 	idList<jointAnimInfo_t, TAG_MD5_ANIM>	jointInfo;
 	idList<idJointQuat, TAG_MD5_ANIM>		baseFrame;
 	idList<float, TAG_MD5_ANIM>			componentFrames;
+	// compressed frames, when used componentFrames is empty
+	int						numKeys;
+	int						numPaddedComponents;
+	idList<float, TAG_MD5_ANIM>			componentMin;		// component = min + quantized * scale
+	idList<float, TAG_MD5_ANIM>			componentScale;
+	idList<unsigned short, TAG_MD5_ANIM>	quantizedKeys;		// numKeys * numPaddedComponents 16 bit components
+	idList<unsigned short, TAG_MD5_ANIM>	keyFrames;			// frame number of each key
+	idList<unsigned short, TAG_MD5_ANIM>	frameKeys;			// key at or before each frame
 	idStr					name;
 	idVec3					totaldelta;
 	mutable int				ref_count;
@@ -217,6 +228,9 @@ public:
 	bool					LoadAnim( const char *filename );
 	bool					LoadBinary( idFile * file, ID_TIME_T sourceTimeStamp );
 	void					WriteBinary( idFile * file, ID_TIME_T sourceTimeStamp );
+	void					Compress();
+	bool					IsCompressed() const { return numKeys > 0; }
+	void					TestDecode( int &keys, size_t &rawBytes, size_t &compressedBytes, uint64 &rawMicroseconds, uint64 &decodeMicroseconds ) const;
 
 	void					IncreaseRefs() const;
 	void					DecreaseRefs() const;
@@ -237,6 +251,9 @@ public:
 	void					GetOrigin( idVec3 &offset, int currentTime, int cyclecount ) const;
 	void					GetOriginRotation( idQuat &rotation, int time, int cyclecount ) const;
 	void					GetBounds( idBounds &bounds, int currentTime, int cyclecount ) const;
+
+private:
+	const float *			GetFrameComponents( int framenum, int firstComponent, int numComponents, float *buffer ) const;
 };
 
 /*
@@ -491,6 +508,9 @@ public:
 	void						ForceUpdate();
 	void						ClearForceUpdate();
 	bool						CreateFrame( int animtime, bool force );
+	bool						NeedsNewFrame( int animtime ) const;
+								// creates the frames of a number of animators on the job threads
+	static void					CreateFramesParallel( idAnimator * const *animators, const int *animtimes, const int numAnimators );
 	bool						FrameHasChanged( int animtime ) const;
 	void						GetDelta( int fromtime, int totime, idVec3 &delta ) const;
 	bool						GetDeltaRotation( int fromtime, int totime, idMat3 &delta ) const;
@@ -578,21 +598,27 @@ public:
 
 	static bool					forceExport;
 
+	void						Init();
 	void						Shutdown();
 	idMD5Anim *					GetAnim( const char *name );
 	void						Preload( const idPreloadManifest &manifest );
 	void						ReloadAnims();
 	void						ListAnims() const;
+	void						TestCompression() const;
 	int							JointIndex( const char *name );
 	const char *				JointName( int index ) const;
 
 	void						ClearAnimsInUse();
 	void						FlushUnusedAnims();
 
+								// job list reused by idAnimator::CreateFramesParallel
+	idParallelJobList *			GetCreateFramesJobList() const { return createFramesJobList; }
+
 private:
 	idHashTable<idMD5Anim *>	animations;
 	idStrList					jointnames;
 	idHashIndex					jointnamesHash;
+	idParallelJobList *			createFramesJobList;
 };
 
 #endif /* !__ANIM_H__ */
@@ -4253,6 +4253,27 @@ bool idAnimator::FrameHasChanged( int currentTime ) const {
 	return false;
 }
 
+// not a function static because frames are also created on the job threads
+static idCVar r_showSkel( "r_showSkel", "0", CVAR_RENDERER | CVAR_INTEGER, "", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
+
+/*
+=====================
+idAnimator::NeedsNewFrame
+=====================
+*/
+bool idAnimator::NeedsNewFrame( int currentTime ) const {
+	if ( !modelDef || !modelDef->ModelHandle() ) {
+		return false;
+	}
+	if ( lastTransformTime == currentTime ) {
+		return false;
+	}
+	if ( lastTransformTime != -1 && !stoppedAnimatingUpdate && !IsAnimating( currentTime ) ) {
+		return false;
+	}
+	return true;
+}
+
 /*
 =====================
 idAnimator::CreateFrame
@@ -4271,17 +4292,12 @@ bool idAnimator::CreateFrame( int currentTime, bool force ) {
 	const jointMod_t *	jointMod;
 	const idJointQuat *	defaultPose;
 
-	static idCVar		r_showSkel( "r_showSkel", "0", CVAR_RENDERER | CVAR_INTEGER, "", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
-
 	if ( !modelDef || !modelDef->ModelHandle() ) {
 		return false;
 	}
 
 	if ( !force && !r_showSkel.GetInteger() ) {
-		if ( lastTransformTime == currentTime ) {
-			return false;
-		}
-		if ( lastTransformTime != -1 && !stoppedAnimatingUpdate && !IsAnimating( currentTime ) ) {
+		if ( !NeedsNewFrame( currentTime ) ) {
 			return false;
 		}
 	}
@@ -4494,6 +4510,65 @@ bool idAnimator::CreateFrame( int currentTime, bool force ) {
 	return true;
 }
 
+typedef struct createFramesParms_s {
+	idAnimator * const *	animators;
+	const int *				animtimes;
+	int						numAnimators;
+} createFramesParms_t;
+
+/*
+=====================
+Anim_CreateFramesJob
+=====================
+*/
+static void Anim_CreateFramesJob( createFramesParms_t * parms ) {
+	for ( int i = 0; i < parms->numAnimators; i++ ) {
+		parms->animators[i]->CreateFrame( parms->animtimes[i], false );
+	}
+}
+
+REGISTER_PARALLEL_JOB( Anim_CreateFramesJob, "Anim_CreateFramesJob" );
+
+/*
+=====================
+idAnimator::CreateFramesParallel
+
+  Only blends the animations and transforms the joints, frame commands are
+  serviced when the entities think. The animators must all be different.
+=====================
+*/
+void idAnimator::CreateFramesParallel( idAnimator * const *animators, const int *animtimes, const int numAnimators ) {
+	const int ANIMATORS_PER_JOB = 4;
+
+	if ( numAnimators <= 0 ) {
+		return;
+	}
+
+	idParallelJobList * jobList = animationLib.GetCreateFramesJobList();
+	if ( jobList == NULL ) {
+		for ( int i = 0; i < numAnimators; i++ ) {
+			animators[i]->CreateFrame( animtimes[i], false );
+		}
+		return;
+	}
+
+	const int numJobs = ( numAnimators + ANIMATORS_PER_JOB - 1 ) / ANIMATORS_PER_JOB;
+	createFramesParms_t * parms = (createFramesParms_t *)_alloca( numJobs * sizeof( parms[0] ) );
+
+	// the list is reused every frame, so submit in waves of at most MAX_CREATE_FRAMES_JOBS
+	for ( int i = 0; i < numJobs; i++ ) {
+		const int first = i * ANIMATORS_PER_JOB;
+		parms[i].animators = animators + first;
+		parms[i].animtimes = animtimes + first;
+		parms[i].numAnimators = Min( ANIMATORS_PER_JOB, numAnimators - first );
+		jobList->AddJob( (jobRun_t)Anim_CreateFramesJob, &parms[i] );
+		if ( ( i % MAX_CREATE_FRAMES_JOBS ) == MAX_CREATE_FRAMES_JOBS - 1 || i == numJobs - 1 ) {
+			jobList->Submit();
+			jobList->Wait();
+		}
+	}
+}
+
 /*
 =====================
 idAnimator::ForceUpdate
@@ -1404,6 +1404,15 @@ static void Cmd_ListAnims_f( const idCmdArgs &args ) {
 	}
 }
 
+/*
+==================
+Cmd_TestAnimCompression_f
+==================
+*/
+static void Cmd_TestAnimCompression_f( const idCmdArgs &args ) {
+	animationLib.TestCompression();
+}
+
 /*
 ==================
 Cmd_AASStats_f
@@ -1425,6 +1434,36 @@ static void Cmd_AASStats_f( const idCmdArgs &args ) {
 	}
 }
 
+/*
+==================
+Cmd_AASBenchmarkRouting_f
+==================
+*/
+static void Cmd_AASBenchmarkRouting_f( const idCmdArgs &args ) {
+	int aasNum, numRoutes;
+
+	if ( !gameLocal.CheatsOk() ) {
+		return;
+	}
+
+	numRoutes = 4096;
+	if ( args.Argc() > 1 ) {
+		numRoutes = atoi( args.Argv( 1 ) );
+	}
+	if ( numRoutes <= 0 ) {
+		gameLocal.Printf( "usage: aasBenchmarkRouting [numRoutes]\n" );
+		return;
+	}
+
+	aasNum = aas_test.GetInteger();
+	idAAS *aas = gameLocal.GetAAS( aasNum );
+	if ( !aas ) {
+		gameLocal.Printf( "No aas #%d loaded\n", aasNum );
+	} else {
+		aas->BenchmarkRouting( numRoutes, TFL_WALK|TFL_AIR );
+	}
+}
+
 /*
 ==================
 Cmd_TestDamage_f
@@ -1804,6 +1843,375 @@ static void Cmd_UnbindRagdoll_f( const idCmdArgs &args ) {
 	}
 }
 
+/*
+==================
+Cmd_AFBenchmark_f
+
+Times the articulated figures of all ragdolls for a number of frames evaluated
+one after the other like their entities do, and with EvaluateParallel. Optionally
+spawns a number of ragdolls in front of the player first. Each pass starts from
+the same state so the results of both passes should be identical.
+==================
+*/
+static void Cmd_AFBenchmark_f( const idCmdArgs &args ) {
+	idPlayer *player;
+	idList<idPhysics_AF *> figures;
+	idList<idVec3> serialOrigins;
+	int i, j, k, numFrames, mode;
+
+	player = gameLocal.GetLocalPlayer();
+	if ( !player || !gameLocal.CheatsOk() ) {
+		return;
+	}
+
+	if ( args.Argc() != 2 && args.Argc() != 4 ) {
+		gameLocal.Printf( "usage: afBenchmark <numFrames> [entityDef numRagdolls]\n" );
+		return;
+	}
+
+	numFrames = Max( atoi( args.Argv( 1 ) ), 1 );
+
+	// spawn the ragdolls on a grid in front of the player, a bit above the ground so they fall
+	if ( args.Argc() == 4 ) {
+		if ( !gameLocal.SpawnBenchmarkGrid( args.Argv( 2 ), atoi( args.Argv( 3 ) ), 80.0f, 32.0f ) ) {
+			return;
+		}
+	}
+
+	gameLocal.GetParallelArticulatedFigures( figures );
+	if ( figures.Num() == 0 ) {
+		gameLocal.Printf( "no active ragdolls\n" );
+		return;
+	}
+
+	int numBodies = 0;
+	for ( i = 0; i < figures.Num(); i++ ) {
+		figures[i]->SaveState();
+		numBodies += figures[i]->GetNumBodies();
+	}
+
+	const bool parallelSolve = af_parallelSolve.GetBool();
+
+	// the first pass evaluates the figures one after the other like their entities do, the second
+	// pass evaluates them with EvaluateParallel, which should give the same results
+	for ( mode = 0; mode < 2; mode++ ) {
+		af_parallelSolve.SetBool( true );
+
+		for ( i = 0; i < figures.Num(); i++ ) {
+			figures[i]->RestoreState();
+			figures[i]->UpdateClipModels();
+			figures[i]->Activate();
+		}
+
+		// the end time stays at the time of the last game frame so none of the
+		// results are picked up by the next game frame
+		const uint64 startTime = Sys_Microseconds();
+		for ( i = 0; i < numFrames; i++ ) {
+			if ( mode == 0 ) {
+				idPhysics_AF::EvaluateSerial( figures.Ptr(), figures.Num(), gameLocal.time );
+			} else {
+				idPhysics_AF::EvaluateParallel( figures.Ptr(), figures.Num(), gameLocal.time );
+			}
+		}
+		const uint64 endTime = Sys_Microseconds();
+
+		// compare the final poses with the pass in entity order
+		float maxDelta = 0.0f;
+		for ( i = 0, k = 0; i < figures.Num(); i++ ) {
+			for ( j = 0; j < figures[i]->GetNumBodies(); j++, k++ ) {
+				const idVec3 &origin = figures[i]->GetBody( j )->GetWorldOrigin();
+				if ( mode == 0 ) {
+					serialOrigins.Append( origin );
+				} else {
+					maxDelta = Max( maxDelta, ( origin - serialOrigins[k] ).LengthFast() );
+				}
+			}
+		}
+
+		const float msec = ( endTime - startTime ) / 1000.0f;
+		gameLocal.Printf( "%s: %d figures, %d bodies, %d frames, %.2f msec per frame, max deviation %.4f\n",
+							mode ? "parallel" : "entity order", figures.Num(), numBodies, numFrames, msec / numFrames, maxDelta );
+	}
+
+	af_parallelSolve.SetBool( parallelSolve );
+
+	for ( i = 0; i < figures.Num(); i++ ) {
+		figures[i]->RestoreState();
+		figures[i]->UpdateClipModels();
+		figures[i]->Activate();
+	}
+}
+
+/*
+==================
+Cmd_AnimBenchmark_f
+
+Times creating the animation frames of an increasing number of animated
+entities on this thread and on the job threads. Optionally spawns a number of
+actors in front of the player first.
+==================
+*/
+static void Cmd_AnimBenchmark_f( const idCmdArgs &args ) {
+	idPlayer *player;
+	idEntity *ent;
+	idAnimator *animator;
+	idList<idAnimator *> animators;
+	idList<int> animtimes;
+	int i, j, count, num, numFrames;
+
+	player = gameLocal.GetLocalPlayer();
+	if ( !player || !gameLocal.CheatsOk() ) {
+		return;
+	}
+
+	if ( args.Argc() != 2 && args.Argc() != 4 ) {
+		gameLocal.Printf( "usage: animBenchmark <numFrames> [entityDef numActors]\n" );
+		return;
+	}
+
+	numFrames = Max( atoi( args.Argv( 1 ) ), 1 );
+
+	// spawn the actors on a grid in front of the player
+	if ( args.Argc() == 4 ) {
+		if ( !gameLocal.SpawnBenchmarkGrid( args.Argv( 2 ), atoi( args.Argv( 3 ) ), 80.0f, 0.0f ) ) {
+			return;
+		}
+	}
+
+	for ( ent = gameLocal.spawnedEntities.Next(); ent != NULL; ent = ent->spawnNode.Next() ) {
+		animator = ent->GetAnimator();
+		if ( animator != NULL && animator->ModelHandle() != NULL ) {
+			animators.Append( animator );
+			animtimes.Append( gameLocal.GetTimeGroupTime( ent->GetRenderEntity()->timeGroup ) );
+		}
+	}
+
+	if ( animators.Num() == 0 ) {
+		gameLocal.Printf( "no animated entities\n" );
+		return;
+	}
+
+	for ( count = 1; ; count *= 2 ) {
+		num = Min( count, animators.Num() );
+
+		uint64 startTime = Sys_Microseconds();
+		for ( i = 0; i < numFrames; i++ ) {
+			for ( j = 0; j < num; j++ ) {
+				animators[j]->ForceUpdate();
+				animators[j]->CreateFrame( animtimes[j], false );
+			}
+		}
+		const uint64 serialTime = Sys_Microseconds() - startTime;
+
+		startTime = Sys_Microseconds();
+		for ( i = 0; i < numFrames; i++ ) {
+			for ( j = 0; j < num; j++ ) {
+				animators[j]->ForceUpdate();
+			}
+			idAnimator::CreateFramesParallel( animators.Ptr(), animtimes.Ptr(), num );
+		}
+		const uint64 parallelTime = Sys_Microseconds() - startTime;
+
+		gameLocal.Printf( "%4d animators: %.3f msec serial, %.3f msec parallel per frame\n", num,
+							serialTime / ( 1000.0f * numFrames ), parallelTime / ( 1000.0f * numFrames ) );
+
+		if ( num == animators.Num() ) {
+			break;
+		}
+	}
+}
+
+/*
+==================
+Trace benchmark
+==================
+*/
+typedef struct traceBenchmarkParms_s {
+	const idVec3 *			starts;
+	const idVec3 *			ends;
+	const idTraceModel *	trm;
+	float *					fractions;
+	int						firstTrace;
+	int						numTraces;
+} traceBenchmarkParms_t;
+
+/*
+==================
+TraceBenchmarkJob
+
+Every other trace moves the box trace model, every eighth trace converts a
+trace model to a collision model and traces a point through it to test the
+per thread trace model slot.
+==================
+*/
+static void TraceBenchmarkJob( traceBenchmarkParms_t * parms ) {
+	trace_t tr;
+	idTraceModel box;
+
+	for ( int i = 0; i < parms->numTraces; i++ ) {
+		const int traceNum = parms->firstTrace + i;
+		const idVec3 &start = parms->starts[traceNum];
+		const idVec3 &end = parms->ends[traceNum];
+		if ( ( traceNum & 7 ) == 7 ) {
+			box.SetupBox( 8.0f + ( traceNum & 63 ) );
+			const cmHandle_t handle = collisionModelManager->SetupTrmModel( box, NULL );
+			collisionModelManager->Translation( &tr, start, end, NULL, mat3_identity, -1, handle, ( start + end ) * 0.5f, mat3_identity );
+		} else {
+			collisionModelManager->Translation( &tr, start, end, ( traceNum & 1 ) ? parms->trm : NULL, mat3_identity, MASK_SOLID, 0, vec3_origin, mat3_identity );
+		}
+		parms->fractions[traceNum] = tr.fraction;
+	}
+}
+
+REGISTER_PARALLEL_JOB( TraceBenchmarkJob, "TraceBenchmarkJob" );
+
+/*
+==================
+Cmd_TraceBenchmark_f
+
+Runs the same random traces against the world collision model on this thread
+and spread over the job threads and compares the timings and results. The
+serial traces are also timed through the pointer linked collision BSP trees
+to compare against the flattened trees.
+==================
+*/
+static void Cmd_TraceBenchmark_f( const idCmdArgs &args ) {
+	const int TRACES_PER_JOB = 256;
+	idPlayer *player;
+	idList<idVec3> starts, ends;
+	idList<float> treeFractions, serialFractions, parallelFractions;
+	idTraceModel trm;
+	idRandom random( 0 );
+	int i, numTraces, numJobs, numMismatches;
+
+	player = gameLocal.GetLocalPlayer();
+	if ( !player || !gameLocal.CheatsOk() ) {
+		return;
+	}
+
+	if ( args.Argc() != 2 ) {
+		gameLocal.Printf( "usage: traceBenchmark <numTraces>\n" );
+		return;
+	}
+
+	numTraces = Max( atoi( args.Argv( 1 ) ), 1 );
+	numJobs = ( numTraces + TRACES_PER_JOB - 1 ) / TRACES_PER_JOB;
+
+	// random traces from around the player
+	const idVec3 origin = player->GetEyePosition();
+	starts.SetNum( numTraces );
+	ends.SetNum( numTraces );
+	for ( i = 0; i < numTraces; i++ ) {
+		starts[i] = origin + idVec3( random.CRandomFloat(), random.CRandomFloat(), random.CRandomFloat() ) * 64.0f;
+		idVec3 dir( random.CRandomFloat(), random.CRandomFloat(), random.CRandomFloat() );
+		dir.Normalize();
+		ends[i] = starts[i] + dir * ( 256.0f + random.RandomFloat() * 768.0f );
+	}
+	trm.SetupBox( idBounds( idVec3( -16.0f, -16.0f, -16.0f ), idVec3( 16.0f, 16.0f, 16.0f ) ) );
+	treeFractions.SetNum( numTraces );
+	serialFractions.SetNum( numTraces );
+	parallelFractions.SetNum( numTraces );
+
+	traceBenchmarkParms_t * parms = (traceBenchmarkParms_t *)_alloca( numJobs * sizeof( parms[0] ) );
+	for ( i = 0; i < numJobs; i++ ) {
+		parms[i].starts = starts.Ptr();
+		parms[i].ends = ends.Ptr();
+		parms[i].trm = &trm;
+		parms[i].firstTrace = i * TRACES_PER_JOB;
+		parms[i].numTraces = Min( TRACES_PER_JOB, numTraces - parms[i].firstTrace );
+	}
+
+	const bool bakeModels = cvarSystem->GetCVarBool( "cm_bakeModels" );
+	cvarSystem->SetCVarBool( "cm_bakeModels", false );
+	uint64 startTime = Sys_Microseconds();
+	for ( i = 0; i < numJobs; i++ ) {
+		parms[i].fractions = treeFractions.Ptr();
+		TraceBenchmarkJob( &parms[i] );
+	}
+	const uint64 treeTime = Sys_Microseconds() - startTime;
+	cvarSystem->SetCVarBool( "cm_bakeModels", bakeModels );
+
+	startTime = Sys_Microseconds();
+	for ( i = 0; i < numJobs; i++ ) {
+		parms[i].fractions = serialFractions.Ptr();
+		TraceBenchmarkJob( &parms[i] );
+	}
+	const uint64 serialTime = Sys_Microseconds() - startTime;
+
+	startTime = Sys_Microseconds();
+	idParallelJobList * jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, numJobs, 0, NULL );
+	for ( i = 0; i < numJobs; i++ ) {
+		parms[i].fractions = parallelFractions.Ptr();
+		jobList->AddJob( (jobRun_t)TraceBenchmarkJob, &parms[i] );
+	}
+	jobList->Submit();
+	jobList->Wait();
+	parallelJobManager->FreeJobList( jobList );
+	const uint64 parallelTime = Sys_Microseconds() - startTime;
+
+	numMismatches = 0;
+	for ( i = 0; i < numTraces; i++ ) {
+		if ( serialFractions[i] != parallelFractions[i] || serialFractions[i] != treeFractions[i] ) {
+			numMismatches++;
+		}
+	}
+
+	gameLocal.Printf( "%d traces: %.3f msec serial through pointer trees (%.0f traces/sec)\n", numTraces,
+						treeTime / 1000.0f, numTraces * 1000000.0f / Max( treeTime, (uint64)1 ) );
+	gameLocal.Printf( "%d traces: %.3f msec serial (%.0f traces/sec), %.3f msec parallel (%.0f traces/sec), %d mismatches\n", numTraces,
+						serialTime / 1000.0f, numTraces * 1000000.0f / Max( serialTime, (uint64)1 ),
+						parallelTime / 1000.0f, numTraces * 1000000.0f / Max( parallelTime, (uint64)1 ), numMismatches );
+}
+
+/*
+==================
+Cmd_RBBenchmark_f
+
+Drops a number of rigid bodies on a grid above the player and gathers rigid
+body statistics over the next frames while they fall, pile up and come to rest.
+==================
+*/
+static void Cmd_RBBenchmark_f( const idCmdArgs &args ) {
+	idPlayer *player;
+	idDict dict;
+	int i, numFrames, numSpawn, numDefs;
+
+	player = gameLocal.GetLocalPlayer();
+	if ( !player || !gameLocal.CheatsOk() ) {
+		return;
+	}
+
+	if ( args.Argc() < 4 ) {
+		gameLocal.Printf( "usage: rbBenchmark <numFrames> <numBodies> <entityDef> [entityDef ...]\n" );
+		return;
+	}
+
+	numFrames = Max( atoi( args.Argv( 1 ) ), 1 );
+	numSpawn = atoi( args.Argv( 2 ) );
+	numDefs = args.Argc() - 3;
+
+	// stack the bodies in layers of a grid in front of the player, alternating the entity defs
+	const int gridSize = 8;
+	idVec3 forward, right;
+	idAngles( 0.0f, player->viewAngles.yaw, 0.0f ).ToVectors( &forward, &right );
+	for ( i = 0; i < numSpawn; i++ ) {
+		const int layer = i / ( gridSize * gridSize );
+		const int cell = i % ( gridSize * gridSize );
+		const idVec3 org = player->GetPhysics()->GetOrigin() + forward * ( 128.0f + ( cell / gridSize ) * 48.0f ) +
+							right * ( ( cell % gridSize ) - gridSize / 2 ) * 48.0f + idVec3( 0.0f, 0.0f, 64.0f + layer * 48.0f );
+		dict.Clear();
+		dict.Set( "classname", args.Argv( 3 + ( i % numDefs ) ) );
+		dict.Set( "angle", va( "%f", gameLocal.random.RandomFloat() * 360.0f ) );
+		dict.Set( "origin", org.ToString() );
+		if ( !gameLocal.SpawnEntityDef( dict ) ) {
+			gameLocal.Printf( "couldn't spawn '%s'\n", args.Argv( 3 + ( i % numDefs ) ) );
+			return;
+		}
+	}
+
+	idPhysics_RigidBody::StartBenchmark( numFrames );
+}
+
 /*
 ==================
 Cmd_GameError_f
@@ -2299,6 +2707,7 @@ void idGameLocal::InitConsoleCommands() {
 	cmdSystem->AddCommand( "listEntities",			Cmd_EntityList_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"lists game entities" );
 	cmdSystem->AddCommand( "listActiveEntities",	Cmd_ActiveEntityList_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"lists active game entities" );
 	cmdSystem->AddCommand( "listMonsters",			idAI::List_f,				CMD_FL_GAME|CMD_FL_CHEAT,	"lists monsters" );
+	cmdSystem->AddCommand( "aiBenchmarkObstacles",	idAI::BenchmarkObstacleAvoidance_f,	CMD_FL_GAME|CMD_FL_CHEAT,	"times monster obstacle avoidance with and without shared wall obstacles" );
 	cmdSystem->AddCommand( "listSpawnArgs",			Cmd_ListSpawnArgs_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"list the spawn args of an entity", idGameLocal::ArgCompletion_EntityName );
 	cmdSystem->AddCommand( "say",					Cmd_Say_f,					CMD_FL_GAME,				"text chat" );
 	cmdSystem->AddCommand( "sayTeam",				Cmd_SayTeam_f,				CMD_FL_GAME,				"team text chat" );
@@ -2349,7 +2758,9 @@ void idGameLocal::InitConsoleCommands() {
 	cmdSystem->AddCommand( "collisionModelInfo",	Cmd_CollisionModelInfo_f,	CMD_FL_GAME,				"shows collision model info" );
 	cmdSystem->AddCommand( "reloadanims",			Cmd_ReloadAnims_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"reloads animations" );
 	cmdSystem->AddCommand( "listAnims",				Cmd_ListAnims_f,			CMD_FL_GAME,				"lists all animations" );
+	cmdSystem->AddCommand( "testAnimCompression",	Cmd_TestAnimCompression_f,	CMD_FL_GAME,				"compares memory and decode time of the loaded animations with the uncompressed format" );
 	cmdSystem->AddCommand( "aasStats",				Cmd_AASStats_f,				CMD_FL_GAME,				"shows AAS stats" );
+	cmdSystem->AddCommand( "aasBenchmarkRouting",	Cmd_AASBenchmarkRouting_f,	CMD_FL_GAME|CMD_FL_CHEAT,	"times random routes with and without the AAS cluster graph" );
 	cmdSystem->AddCommand( "testDamage",			Cmd_TestDamage_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"tests a damage def", idCmdSystem::ArgCompletion_Decl<DECL_ENTITYDEF> );
 	cmdSystem->AddCommand( "weaponSplat",			Cmd_WeaponSplat_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"projects a blood splat on the player weapon" );
 	cmdSystem->AddCommand( "saveSelected",			Cmd_SaveSelected_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"saves the selected entity to the .map file" );
@@ -2358,6 +2769,10 @@ void idGameLocal::InitConsoleCommands() {
 	cmdSystem->AddCommand( "saveRagdolls",			Cmd_SaveRagdolls_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"save all ragdoll poses to the .map file" );
 	cmdSystem->AddCommand( "bindRagdoll",			Cmd_BindRagdoll_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"binds ragdoll at the current drag position" );
 	cmdSystem->AddCommand( "unbindRagdoll",			Cmd_UnbindRagdoll_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"unbinds the selected ragdoll" );
+	cmdSystem->AddCommand( "afBenchmark",			Cmd_AFBenchmark_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"times the ragdoll physics with the constraints solved serially and in parallel" );
+	cmdSystem->AddCommand( "rbBenchmark",			Cmd_RBBenchmark_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"drops rigid bodies above the player and prints rigid body statistics while they come to rest" );
+	cmdSystem->AddCommand( "animBenchmark",			Cmd_AnimBenchmark_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"times creating the animation frames of animated entities serially and in parallel" );
+	cmdSystem->AddCommand( "traceBenchmark",		Cmd_TraceBenchmark_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"times random collision model traces around the player serially and on the job threads" );
 	cmdSystem->AddCommand( "saveLights",			Cmd_SaveLights_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"saves all lights to the .map file" );
 	cmdSystem->AddCommand( "saveParticles",			Cmd_SaveParticles_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"saves all lights to the .map file" );
 	cmdSystem->AddCommand( "clearLights",			Cmd_ClearLights_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"clears all lights" );
@@ -47,6 +47,7 @@ extern idCVar	g_muzzleFlash;
 extern idCVar	g_disasm;
 extern idCVar	g_debugBounds;
 extern idCVar	g_debugAnim;
+extern idCVar	g_parallelAnimation;
 extern idCVar	g_debugMove;
 extern idCVar	g_debugDamage;
 extern idCVar	g_debugWeapon;
@@ -87,6 +88,9 @@ extern idCVar	ai_testPredictPath;
 extern idCVar	ai_showCombatNodes;
 extern idCVar	ai_showPaths;
 extern idCVar	ai_showObstacleAvoidance;
+extern idCVar	ai_batchObstacles;
+extern idCVar	ai_visibilityCache;
+extern idCVar	ai_showVisibilityStats;
 extern idCVar	ai_blockedFailSafe;
 extern idCVar	ai_showHealth;
 
@@ -150,6 +154,7 @@ extern idCVar	af_showInertia;
 extern idCVar	af_showVelocity;
 extern idCVar	af_showActive;
 extern idCVar	af_testSolid;
+extern idCVar	af_parallelSolve;
 
 extern idCVar	rb_showTimings;
 extern idCVar	rb_showBodies;
@@ -157,6 +162,9 @@ extern idCVar	rb_showMass;
 extern idCVar	rb_showInertia;
 extern idCVar	rb_showVelocity;
 extern idCVar	rb_showActive;
+extern idCVar	rb_islands;
+extern idCVar	rb_islandWakeSpeed;
+extern idCVar	rb_contactCache;
 
 extern idCVar	pm_jumpheight;
 extern idCVar	pm_stepsize;
@@ -249,6 +257,7 @@ extern idCVar	aas_pullPlayer;
 extern idCVar	aas_randomPullPlayer;
 extern idCVar	aas_goalArea;
 extern idCVar	aas_showPushIntoArea;
+extern idCVar	aas_clusterRouting;
 
 extern idCVar	net_clientPredictGUI;
 
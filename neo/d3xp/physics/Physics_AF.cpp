@@ -59,7 +59,15 @@ const idVec6 vec6_lcp_epsilon				= idVec6( LCP_EPSILON, LCP_EPSILON, LCP_EPSILON
 #ifdef AF_TIMINGS
 static int lastTimerReset = 0;
 static int numArticulatedFigures = 0;
+static int numPrimaryRows = 0;
+static int numAuxiliaryRows = 0;
 static idTimer timer_total, timer_pc, timer_ac, timer_collision, timer_lcp;
+// the timers are shared by all figures so they only run when the figures are evaluated one at a time
+#define AF_TIMER_START( timer )		if ( af_showTimings.GetBool() ) { timer.Start(); }
+#define AF_TIMER_STOP( timer )		if ( af_showTimings.GetBool() ) { timer.Stop(); }
+#else
+#define AF_TIMER_START( timer )
+#define AF_TIMER_STOP( timer )
 #endif
 
 
@@ -5222,18 +5230,14 @@ void idPhysics_AF::AuxiliaryForces( float timeStep ) {
 		}
 	}
 
-#ifdef AF_TIMINGS
-	timer_lcp.Start();
-#endif
+	AF_TIMER_START( timer_lcp );
 
 	// calculate lagrange multipliers for auxiliary constraints
 	if ( !lcp->Solve( jmk, lm, rhs, lo, hi, boxIndex ) ) {
 		return;		// bad monkey!
 	}
 
-#ifdef AF_TIMINGS
-	timer_lcp.Stop();
-#endif
+	AF_TIMER_STOP( timer_lcp );
 
 	// calculate auxiliary constraint forces
 	for ( k = 0, i = 0; i < auxiliaryConstraints.Num(); i++ ) {
@@ -6214,10 +6218,36 @@ const idBounds &idPhysics_AF::GetAbsBounds( int id ) const {
 
 /*
 ================
-idPhysics_AF::Evaluate
+idPhysics_AF::CanEvaluateInParallel
+
+Returns true if the constraints of the figure can be solved on a job thread.
+Suspension constraints trace against the world while being evaluated so
+figures with those are always evaluated on the game thread.
 ================
 */
-bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
+bool idPhysics_AF::CanEvaluateInParallel() const {
+	if ( af_showTimings.GetBool() ) {
+		return false;
+	}
+	if ( current.atRest >= 0 ) {
+		return false;
+	}
+	for ( int i = 0; i < constraints.Num(); i++ ) {
+		if ( constraints[i]->GetType() == CONSTRAINT_SUSPENSION ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+================
+idPhysics_AF::EvaluateBegin
+
+Returns false if the figure does not need to be solved this frame.
+================
+*/
+bool idPhysics_AF::EvaluateBegin( int timeStepMSec, int endTimeMSec ) {
 	float timeStep;
 
 	if ( timeScaleRampStart < MS2SEC( endTimeMSec ) && timeScaleRampEnd > MS2SEC( endTimeMSec ) ) {
@@ -6258,13 +6288,8 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
 	// move the af velocity into the frame of a pusher
 	AddPushVelocity( -current.pushVelocity );
 
-#ifdef AF_TIMINGS
-	timer_total.Start();
-#endif
-
-#ifdef AF_TIMINGS
-	timer_collision.Start();
-#endif
+	AF_TIMER_START( timer_total );
+	AF_TIMER_START( timer_collision );
 
 	// evaluate contacts
 	EvaluateContacts();
@@ -6272,50 +6297,77 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
 	// setup contact constraints
 	SetupContactConstraints();
 
-#ifdef AF_TIMINGS
-	timer_collision.Stop();
-#endif
+	AF_TIMER_STOP( timer_collision );
+
+	evaluateTimeStep = timeStep;
+	evaluateEndTimeMSec = endTimeMSec;
+
+	return true;
+}
+
+/*
+================
+idPhysics_AF::EvaluateSolve
+
+Solves the constraints and evolves the state of the figure. This does not
+touch the collision system or any other entity and only uses idVecX and
+idMatX temporary memory, so figures can be solved in parallel as long as
+each thread has its own temporary memory.
+================
+*/
+void idPhysics_AF::EvaluateSolve() {
+	const float timeStep = evaluateTimeStep;
 
 	// evaluate constraint equations
 	EvaluateConstraints( timeStep );
 
 	// apply friction
-	ApplyFriction( timeStep, endTimeMSec );
+	ApplyFriction( timeStep, evaluateEndTimeMSec );
 
 	// add frame constraints
 	AddFrameConstraints();
 
 #ifdef AF_TIMINGS
-	int i, numPrimary = 0, numAuxiliary = 0;
-	for ( i = 0; i < primaryConstraints.Num(); i++ ) {
-		numPrimary += primaryConstraints[i]->J1.GetNumRows();
-	}
-	for ( i = 0; i < auxiliaryConstraints.Num(); i++ ) {
-		numAuxiliary += auxiliaryConstraints[i]->J1.GetNumRows();
+	if ( af_showTimings.GetBool() ) {
+		numPrimaryRows = 0;
+		numAuxiliaryRows = 0;
+		for ( int i = 0; i < primaryConstraints.Num(); i++ ) {
+			numPrimaryRows += primaryConstraints[i]->J1.GetNumRows();
+		}
+		for ( int i = 0; i < auxiliaryConstraints.Num(); i++ ) {
+			numAuxiliaryRows += auxiliaryConstraints[i]->J1.GetNumRows();
+		}
 	}
-	timer_pc.Start();
 #endif
 
+	AF_TIMER_START( timer_pc );
+
 	// factor matrices for primary constraints
 	PrimaryFactor();
 
 	// calculate forces on bodies after applying primary constraints
 	PrimaryForces( timeStep );
 
-#ifdef AF_TIMINGS
-	timer_pc.Stop();
-	timer_ac.Start();
-#endif
+	AF_TIMER_STOP( timer_pc );
+	AF_TIMER_START( timer_ac );
 
 	// calculate and apply auxiliary constraint forces
 	AuxiliaryForces( timeStep );
 
-#ifdef AF_TIMINGS
-	timer_ac.Stop();
-#endif
+	AF_TIMER_STOP( timer_ac );
 
 	// evolve current state to next state
 	Evolve( timeStep );
+}
+
+/*
+================
+idPhysics_AF::EvaluateEnd
+================
+*/
+bool idPhysics_AF::EvaluateEnd() {
+	const float timeStep = evaluateTimeStep;
+	const int endTimeMSec = evaluateEndTimeMSec;
 
 	// debug graphics
 	DebugDraw();
@@ -6329,16 +6381,12 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
 	// remove all frame constraints
 	RemoveFrameConstraints();
 
-#ifdef AF_TIMINGS
-	timer_collision.Start();
-#endif
+	AF_TIMER_START( timer_collision );
 
 	// check for collisions between current and next state
 	CheckForCollisions( timeStep );
 
-#ifdef AF_TIMINGS
-	timer_collision.Stop();
-#endif
+	AF_TIMER_STOP( timer_collision );
 
 	// swap the current and next state
 	SwapStates();
@@ -6375,14 +6423,14 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
 	}
 
 #ifdef AF_TIMINGS
-	timer_total.Stop();
+	AF_TIMER_STOP( timer_total );
 
 	if ( af_showTimings.GetInteger() == 1 ) {
 		gameLocal.Printf( "%12s: t %1.4f pc %2d, %1.4f ac %2d %1.4f lcp %1.4f cd %1.4f\n",
 						self->name.c_str(),
 						timer_total.Milliseconds(),
-						numPrimary, timer_pc.Milliseconds(),
-						numAuxiliary, timer_ac.Milliseconds() - timer_lcp.Milliseconds(),
+						numPrimaryRows, timer_pc.Milliseconds(),
+						numAuxiliaryRows, timer_ac.Milliseconds() - timer_lcp.Milliseconds(),
 						timer_lcp.Milliseconds(), timer_collision.Milliseconds() );
 	}
 	else if ( af_showTimings.GetInteger() == 2 ) {
@@ -6391,8 +6439,8 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
 			gameLocal.Printf( "af %d: t %1.4f pc %2d, %1.4f ac %2d %1.4f lcp %1.4f cd %1.4f\n",
 							numArticulatedFigures,
 							timer_total.Milliseconds(),
-							numPrimary, timer_pc.Milliseconds(),
-							numAuxiliary, timer_ac.Milliseconds() - timer_lcp.Milliseconds(),
+							numPrimaryRows, timer_pc.Milliseconds(),
+							numAuxiliaryRows, timer_ac.Milliseconds() - timer_lcp.Milliseconds(),
 							timer_lcp.Milliseconds(), timer_collision.Milliseconds() );
 		}
 	}
@@ -6411,6 +6459,235 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
 	return true;
 }
 
+/*
+================
+idPhysics_AF::Evaluate
+================
+*/
+bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
+
+	// the figure may already have been evaluated for this frame by EvaluateParallel
+	if ( parallelEndTimeMSec == endTimeMSec ) {
+		parallelEndTimeMSec = -1;
+		return parallelMoved;
+	}
+
+	if ( !EvaluateBegin( timeStepMSec, endTimeMSec ) ) {
+		return false;
+	}
+
+	EvaluateSolve();
+
+	return EvaluateEnd();
+}
+
+/*
+================
+AF_SetTeamClip
+
+Mirrors the team clip handling of idEntity::RunPhysics.
+================
+*/
+static void AF_SetTeamClip( idEntity * ent, bool enable ) {
+	for ( idEntity * part = ent; part != NULL; part = part->GetNextTeamEntity() ) {
+		if ( part->GetPhysics() != NULL && !part->fl.solidForTeam ) {
+			if ( enable ) {
+				part->GetPhysics()->EnableClip();
+			} else {
+				part->GetPhysics()->DisableClip();
+			}
+		}
+	}
+}
+
+/*
+================
+AF_EvaluateSolveJob
+================
+*/
+static void AF_EvaluateSolveJob( idPhysics_AF * physics ) {
+	idScopedMathTempMemory tempMemory;
+	physics->EvaluateSolve();
+}
+
+REGISTER_PARALLEL_JOB( AF_EvaluateSolveJob, "AF_EvaluateSolveJob" );
+
+static const int MAX_AF_SOLVE_JOBS = 256;
+static idParallelJobList * afSolveJobList = NULL;
+
+/*
+================
+idPhysics_AF::InitParallelJobs
+================
+*/
+void idPhysics_AF::InitParallelJobs() {
+	if ( afSolveJobList == NULL ) {
+		afSolveJobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_HIGH, MAX_AF_SOLVE_JOBS, 0, NULL );
+	}
+}
+
+/*
+================
+idPhysics_AF::ShutdownParallelJobs
+================
+*/
+void idPhysics_AF::ShutdownParallelJobs() {
+	if ( afSolveJobList != NULL ) {
+		parallelJobManager->FreeJobList( afSolveJobList );
+		afSolveJobList = NULL;
+	}
+}
+
+/*
+================
+idPhysics_AF::GetEvaluateBounds
+
+Bounds of the space the bodies of the figure can reach and find contacts in
+during a time step.
+================
+*/
+void idPhysics_AF::GetEvaluateBounds( idBounds &bounds, int timeStepMSec ) const {
+	// the largest time step EvaluateBegin can use outside of a time scale ramp
+	const float timeStep = MS2SEC( timeStepMSec ) * Max( 1.0f, Max( timeScale, af_timeScale.GetFloat() ) );
+	const float gravitySpeed = gravityVector.Length() * timeStep;
+
+	bounds.Clear();
+	for ( int i = 0; i < bodies.Num(); i++ ) {
+		const idAFBody *body = bodies[i];
+		const float radius = body->clipModel->GetBounds().GetRadius();
+		const float speed = body->current->spatialVelocity.SubVec3( 0 ).Length() + body->current->spatialVelocity.SubVec3( 1 ).Length() * radius + gravitySpeed;
+
+		// EvaluateContacts finds contacts up to 2 units away
+		idBounds bodyBounds = body->clipModel->GetAbsBounds();
+		bodyBounds.ExpandSelf( speed * timeStep + 2.0f );
+		bounds.AddBounds( bodyBounds );
+	}
+}
+
+/*
+================
+idPhysics_AF::EvaluateParallel
+
+Evaluates a number of articulated figures at once, with the same results as
+when evaluated one after the other in the given order at the start of the frame.
+Figures that may touch another figure during the frame are evaluated completely
+one after the other, so each one collides with the poses the ones before it
+already moved to. For the other figures the parts that use the collision system
+run on the game thread in the given order and only the constraint solves run
+on job threads. The result of each figure is returned by the Evaluate call from
+its entity later in the frame.
+================
+*/
+void idPhysics_AF::EvaluateParallel( idPhysics_AF * const * figures, const int numFigures, const int endTimeMSec ) {
+	if ( numFigures <= 0 ) {
+		return;
+	}
+
+	const bool parallelSolve = af_parallelSolve.GetBool() && afSolveJobList != NULL;
+
+	// same time step as idEntity::GetPhysicsTimeStep, only players use a different one
+	const int timeStepMSec = gameLocal.time - gameLocal.previousTime;
+
+	// find the figures that may touch another figure
+	idBounds * bounds = (idBounds *) _alloca( numFigures * sizeof( idBounds ) );
+	bool * isolated = (bool *) _alloca( numFigures * sizeof( bool ) );
+	for ( int i = 0; i < numFigures; i++ ) {
+		figures[i]->GetEvaluateBounds( bounds[i], timeStepMSec );
+		isolated[i] = true;
+	}
+	for ( int i = 0; i < numFigures; i++ ) {
+		for ( int j = i + 1; j < numFigures; j++ ) {
+			if ( bounds[i].IntersectsBounds( bounds[j] ) ) {
+				isolated[i] = false;
+				isolated[j] = false;
+			}
+		}
+	}
+
+	// begin on this thread in the given order, figures touching others are evaluated completely
+	bool * solve = (bool *) _alloca( numFigures * sizeof( bool ) );
+	for ( int i = 0; i < numFigures; i++ ) {
+		idPhysics_AF * af = figures[i];
+		AF_SetTeamClip( af->self, false );
+		if ( isolated[i] ) {
+			solve[i] = af->EvaluateBegin( timeStepMSec, endTimeMSec );
+		} else {
+			solve[i] = false;
+			if ( af->EvaluateBegin( timeStepMSec, endTimeMSec ) ) {
+				af->EvaluateSolve();
+				af->parallelMoved = af->EvaluateEnd();
+			} else {
+				af->parallelMoved = false;
+			}
+			af->parallelEndTimeMSec = endTimeMSec;
+		}
+		AF_SetTeamClip( af->self, true );
+	}
+
+	if ( parallelSolve ) {
+		// the list is reused every frame, so submit in waves of at most MAX_AF_SOLVE_JOBS
+		int numJobs = 0;
+		for ( int i = 0; i < numFigures; i++ ) {
+			if ( !solve[i] ) {
+				continue;
+			}
+			afSolveJobList->AddJob( (jobRun_t)AF_EvaluateSolveJob, figures[i] );
+			if ( ++numJobs == MAX_AF_SOLVE_JOBS ) {
+				afSolveJobList->Submit();
+				afSolveJobList->Wait();
+				numJobs = 0;
+			}
+		}
+		if ( numJobs > 0 ) {
+			afSolveJobList->Submit();
+			afSolveJobList->Wait();
+		}
+	} else {
+		// solve on this thread for comparison
+		for ( int i = 0; i < numFigures; i++ ) {
+			if ( solve[i] ) {
+				figures[i]->EvaluateSolve();
+			}
+		}
+	}
+
+	// end on this thread in the given order
+	for ( int i = 0; i < numFigures; i++ ) {
+		idPhysics_AF * af = figures[i];
+		if ( !isolated[i] ) {
+			continue;
+		}
+		if ( solve[i] ) {
+			AF_SetTeamClip( af->self, false );
+			af->parallelMoved = af->EvaluateEnd();
+			AF_SetTeamClip( af->self, true );
+		} else {
+			af->parallelMoved = false;
+		}
+		af->parallelEndTimeMSec = endTimeMSec;
+	}
+}
+
+/*
+================
+idPhysics_AF::EvaluateSerial
+
+Evaluates a number of articulated figures one after the other in the given
+order, the way their entities evaluate them when they think.
+================
+*/
+void idPhysics_AF::EvaluateSerial( idPhysics_AF * const * figures, const int numFigures, const int endTimeMSec ) {
+	const int timeStepMSec = gameLocal.time - gameLocal.previousTime;
+
+	for ( int i = 0; i < numFigures; i++ ) {
+		idPhysics_AF * af = figures[i];
+		af->parallelEndTimeMSec = -1;
+		AF_SetTeamClip( af->self, false );
+		af->Evaluate( timeStepMSec, endTimeMSec );
+		AF_SetTeamClip( af->self, true );
+	}
+}
+
 /*
 ================
 idPhysics_AF::UpdateTime
@@ -6602,6 +6879,11 @@ idPhysics_AF::idPhysics_AF() {
 
 	lcp = idLCP::AllocSymmetric();
 
+	evaluateTimeStep = 0.0f;
+	evaluateEndTimeMSec = 0;
+	parallelEndTimeMSec = -1;
+	parallelMoved = false;
+
 	memset( &current, 0, sizeof( current ) );
 	current.atRest = -1;
 	current.lastTimeStep = 0.0f;
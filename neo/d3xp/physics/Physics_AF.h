@@ -888,6 +888,18 @@ public:
 	void					SetForcePushable( const bool enable ) { forcePushable = enable; }
 							// update the clip model positions
 	void					UpdateClipModels();
+							// split evaluation, only EvaluateSolve may run on a job thread
+	bool					CanEvaluateInParallel() const;
+	bool					EvaluateBegin( int timeStepMSec, int endTimeMSec );
+	void					EvaluateSolve();
+	bool					EvaluateEnd();
+							// evaluate figures with the constraints of the independent ones solved in parallel
+	static void				EvaluateParallel( idPhysics_AF * const * figures, const int numFigures, const int endTimeMSec );
+							// evaluate figures one after the other like their entities do
+	static void				EvaluateSerial( idPhysics_AF * const * figures, const int numFigures, const int endTimeMSec );
+							// allocate and free the job list used by EvaluateParallel
+	static void				InitParallelJobs();
+	static void				ShutdownParallelJobs();
 
 public:	// common physics interface
 	void					SetClipModel( idClipModel *model, float density, int id = 0, bool freeOld = true );
@@ -1016,6 +1028,11 @@ private:
 	idAFBody *				masterBody;						// master body
 	idLCP *					lcp;							// linear complementarity problem solver
 
+	float					evaluateTimeStep;				// time step of the evaluation in progress
+	int						evaluateEndTimeMSec;			// end time of the evaluation in progress
+	int						parallelEndTimeMSec;			// end time of the last evaluation by EvaluateParallel
+	bool					parallelMoved;					// result of the last evaluation by EvaluateParallel
+
 private:
 	void					BuildTrees();
 	bool					IsClosedLoop( const idAFBody *body1, const idAFBody *body2 ) const;
@@ -1042,6 +1059,7 @@ private:
 	void					Rest();
 	void					AddPushVelocity( const idVec6 &pushVelocity );
 	void					DebugDraw();
+	void					GetEvaluateBounds( idBounds &bounds, int timeStepMSec ) const;
 };
 
 #endif /* !__PHYSICS_AF_H__ */
@@ -36,6 +36,23 @@ END_CLASS
 
 const float STOP_SPEED		= 10.0f;
 
+const float CONTACT_CACHE_ORIGIN_EPSILON	= 0.01f;
+const float CONTACT_CACHE_AXIS_EPSILON		= 0.0001f;
+const float CONTACT_CACHE_DIR_DOT			= 0.99f;
+const int CONTACT_CACHE_MAX_FRAMES			= 8;
+
+idList<idPhysics_RigidBody *, TAG_IDLIB_LIST_PHYSICS> idPhysics_RigidBody::islandBodies;
+
+// statistics gathered while benchmarking
+static int			rbBenchmarkFrames = 0;
+static int			rbBenchmarkTotalFrames = 0;
+static uint64		rbBenchmarkMicroseconds = 0;
+static int			rbBenchmarkBodies = 0;
+static int			rbBenchmarkIslands = 0;
+static int			rbBenchmarkIslandsResting = 0;
+static int			rbBenchmarkContactQueries = 0;
+static int			rbBenchmarkContactReuses = 0;
+
 
 #undef RB_TIMINGS
 
@@ -467,6 +484,16 @@ idPhysics_RigidBody::idPhysics_RigidBody() {
 	hasMaster = false;
 	isOrientated = false;
 
+	restCandidate = false;
+	islandFrame = -1;
+	islandIndex = -1;
+
+	contactCacheValid = false;
+	contactCacheFrame = 0;
+	contactCacheOrigin.Zero();
+	contactCacheAxis.Identity();
+	contactCacheDir.Zero();
+
 #ifdef RB_TIMINGS
 	lastTimerReset = 0;
 #endif
@@ -483,6 +510,7 @@ idPhysics_RigidBody::~idPhysics_RigidBody() {
 		clipModel = NULL;
 	}
 	delete integrator;
+	islandBodies.Remove( this );
 }
 
 /*
@@ -598,6 +626,8 @@ void idPhysics_RigidBody::SetClipModel( idClipModel *model, const float density,
 	int minIndex;
 	idMat3 inertiaScale;
 
+	contactCacheValid = false;
+
 	assert( self );
 	assert( model );					// we need a clip model
 	assert( model->IsTraceModel() );	// and it should be a trace model
@@ -837,8 +867,10 @@ bool idPhysics_RigidBody::Evaluate( int timeStepMSec, int endTimeMSec ) {
 	idMat3 oldAxis, masterAxis;
 	float timeStep;
 	bool collided, cameToRest = false;
+	uint64 startTime = 0;
 
 	timeStep = MS2SEC( timeStepMSec );
+	restCandidate = false;
 	current.lastTimeStep = timeStep;
 
 	if ( hasMaster ) {
@@ -875,6 +907,10 @@ bool idPhysics_RigidBody::Evaluate( int timeStepMSec, int endTimeMSec ) {
 		return true;
 	}
 
+	if ( rbBenchmarkFrames > 0 ) {
+		startTime = Sys_Microseconds();
+	}
+
 #ifdef RB_TIMINGS
 	timer_total.Start();
 #endif
@@ -930,8 +966,13 @@ bool idPhysics_RigidBody::Evaluate( int timeStepMSec, int endTimeMSec ) {
 
 		// check if the body has come to rest
 		if ( TestIfAtRest() ) {
-			// put to rest
-			Rest();
+			if ( rb_islands.GetBool() ) {
+				// only put to rest at the end of the frame when all touching bodies can rest as well
+				restCandidate = true;
+			} else {
+				// put to rest
+				Rest();
+			}
 			cameToRest = true;
 		}  else {
 			// apply contact friction
@@ -939,8 +980,12 @@ bool idPhysics_RigidBody::Evaluate( int timeStepMSec, int endTimeMSec ) {
 		}
 	}
 
-	if ( current.atRest < 0 ) {
-		ActivateContactEntities();
+	if ( current.atRest < 0 && !restCandidate ) {
+		// a body that is barely moving does not wake up the bodies resting against it,
+		// an actual collision still applies an impulse which wakes up the other body
+		if ( !rb_islands.GetBool() || IsMovingFasterThan( rb_islandWakeSpeed.GetFloat() ) ) {
+			ActivateContactEntities();
+		}
 	}
 
 	if ( collided ) {
@@ -967,6 +1012,16 @@ bool idPhysics_RigidBody::Evaluate( int timeStepMSec, int endTimeMSec ) {
 		Rest();
 	}
 
+	if ( rb_islands.GetBool() && current.atRest < 0 && islandFrame != gameLocal.framenum ) {
+		islandFrame = gameLocal.framenum;
+		islandBodies.Append( this );
+	}
+
+	if ( rbBenchmarkFrames > 0 ) {
+		rbBenchmarkMicroseconds += Sys_Microseconds() - startTime;
+		rbBenchmarkBodies++;
+	}
+
 #ifdef RB_TIMINGS
 	timer_total.Stop();
 
@@ -1078,6 +1133,8 @@ void idPhysics_RigidBody::ApplyImpulse( const int id, const idVec3 &point, const
 	}
 	current.i.linearMomentum += impulse;
 	current.i.angularMomentum += ( point - ( current.i.position + centerOfMass * current.i.orientation ) ).Cross( impulse );
+	// something hit the body so it may touch new clip models
+	contactCacheValid = false;
 	Activate();
 }
 
@@ -1389,23 +1446,141 @@ bool idPhysics_RigidBody::EvaluateContacts() {
 	idVec6 dir;
 	int num;
 
-	ClearContacts();
-
-	contacts.SetNum( 10 );
-
 	dir.SubVec3(0) = current.i.linearMomentum + current.lastTimeStep * gravityVector * mass;
 	dir.SubVec3(1) = current.i.angularMomentum;
 	dir.SubVec3(0).Normalize();
 	dir.SubVec3(1).Normalize();
+
+	if ( ReuseCachedContacts( dir.SubVec3(0) ) ) {
+		return ( contacts.Num() != 0 );
+	}
+
+	ClearContacts();
+
+	contacts.SetNum( 10 );
+
 	num = gameLocal.clip.Contacts( &contacts[0], 10, clipModel->GetOrigin(),
 					dir, CONTACT_EPSILON, clipModel, clipModel->GetAxis(), clipMask, self );
 	contacts.SetNum( num );
 
 	AddContactEntitiesForContacts();
 
+	CacheContacts( dir.SubVec3(0) );
+
 	return ( contacts.Num() != 0 );
 }
 
+/*
+================
+idPhysics_RigidBody::IsMovingFasterThan
+================
+*/
+bool idPhysics_RigidBody::IsMovingFasterThan( const float speed ) const {
+	if ( ( current.i.linearMomentum * inverseMass ).LengthSqr() > Square( speed ) ) {
+		return true;
+	}
+	// angular speed in units per second at a distance equal to the radius of the bounds
+	const float radius = clipModel->GetBounds().GetRadius();
+	return ( ( inverseInertiaTensor * current.i.angularMomentum ).LengthSqr() * Square( radius ) > Square( speed ) );
+}
+
+/*
+================
+idPhysics_RigidBody::ReuseCachedContacts
+
+  Contacts are cached per pair of this clip model and a touching clip model.
+  The contacts are reused as long as neither clip model of any pair moved and the
+  body keeps moving in the same direction.
+================
+*/
+bool idPhysics_RigidBody::ReuseCachedContacts( const idVec3 &dir ) {
+	int i, id;
+	idEntity *ent;
+	idPhysics *phys;
+
+	if ( !rb_contactCache.GetBool() || !contactCacheValid ) {
+		return false;
+	}
+	if ( gameLocal.framenum - contactCacheFrame >= CONTACT_CACHE_MAX_FRAMES ) {
+		return false;
+	}
+	if ( !clipModel->GetOrigin().Compare( contactCacheOrigin, CONTACT_CACHE_ORIGIN_EPSILON ) ||
+			!clipModel->GetAxis().Compare( contactCacheAxis, CONTACT_CACHE_AXIS_EPSILON ) ) {
+		return false;
+	}
+	if ( dir * contactCacheDir < CONTACT_CACHE_DIR_DOT ) {
+		return false;
+	}
+
+	for ( i = 0; i < contactCache.Num(); i++ ) {
+		const rigidBodyCachedContact_t &cached = contactCache[i];
+		ent = gameLocal.entities[ cached.info.entityNum ];
+		if ( ent == NULL ) {
+			return false;
+		}
+		phys = ent->GetPhysics();
+		id = ( cached.info.id >= 0 && cached.info.id < phys->GetNumClipModels() ) ? cached.info.id : 0;
+		if ( !phys->GetOrigin( id ).Compare( cached.otherOrigin, CONTACT_CACHE_ORIGIN_EPSILON ) ||
+				!phys->GetAxis( id ).Compare( cached.otherAxis, CONTACT_CACHE_AXIS_EPSILON ) ) {
+			return false;
+		}
+	}
+
+	ClearContacts();
+
+	contacts.SetNum( contactCache.Num() );
+	for ( i = 0; i < contactCache.Num(); i++ ) {
+		contacts[i] = contactCache[i].info;
+	}
+
+	AddContactEntitiesForContacts();
+
+	if ( rbBenchmarkFrames > 0 ) {
+		rbBenchmarkContactReuses++;
+	}
+
+	return true;
+}
+
+/*
+================
+idPhysics_RigidBody::CacheContacts
+================
+*/
+void idPhysics_RigidBody::CacheContacts( const idVec3 &dir ) {
+	int i, id;
+	idEntity *ent;
+	idPhysics *phys;
+
+	if ( rbBenchmarkFrames > 0 ) {
+		rbBenchmarkContactQueries++;
+	}
+
+	contactCacheValid = false;
+	if ( !rb_contactCache.GetBool() ) {
+		return;
+	}
+
+	contactCache.SetNum( contacts.Num() );
+	for ( i = 0; i < contacts.Num(); i++ ) {
+		ent = gameLocal.entities[ contacts[i].entityNum ];
+		if ( ent == NULL ) {
+			return;
+		}
+		phys = ent->GetPhysics();
+		id = ( contacts[i].id >= 0 && contacts[i].id < phys->GetNumClipModels() ) ? contacts[i].id : 0;
+		contactCache[i].info = contacts[i];
+		contactCache[i].otherOrigin = phys->GetOrigin( id );
+		contactCache[i].otherAxis = phys->GetAxis( id );
+	}
+
+	contactCacheValid = true;
+	contactCacheFrame = gameLocal.framenum;
+	contactCacheOrigin = clipModel->GetOrigin();
+	contactCacheAxis = clipModel->GetAxis();
+	contactCacheDir = dir;
+}
+
 /*
 ================
 idPhysics_RigidBody::SetPushed
@@ -1537,3 +1712,118 @@ void idPhysics_RigidBody::ReadFromSnapshot( const idBitMsg &msg ) {
 		clipModel->Link( gameLocal.clip, self, clipModel->GetId(), next.i.position, next.i.orientation );
 	}
 }
+
+/*
+================
+idPhysics_RigidBody::UpdateIslands
+
+  Rigid bodies that touch each other form an island. A body that came to rest
+  is only put to rest when all active bodies in its island can rest as well,
+  otherwise a stack of bodies keeps waking up the bodies that just fell asleep.
+================
+*/
+static int RB_FindIsland( idList<int> &parent, int i ) {
+	while ( parent[i] != i ) {
+		parent[i] = parent[parent[i]];
+		i = parent[i];
+	}
+	return i;
+}
+
+void idPhysics_RigidBody::UpdateIslands() {
+	int i, j, root, otherRoot, numIslands, numResting;
+	idList<int> parent;
+	idList<bool> canRest;
+	idPhysics_RigidBody *body, *other;
+	idEntity *ent;
+
+	const int num = islandBodies.Num();
+
+	parent.SetNum( num );
+	canRest.SetNum( num );
+	for ( i = 0; i < num; i++ ) {
+		islandBodies[i]->islandIndex = i;
+		parent[i] = i;
+		canRest[i] = true;
+	}
+
+	// join the islands of active bodies that touch each other
+	for ( i = 0; i < num; i++ ) {
+		body = islandBodies[i];
+		for ( j = 0; j < body->contacts.Num(); j++ ) {
+			ent = gameLocal.entities[ body->contacts[j].entityNum ];
+			if ( ent == NULL || !ent->GetPhysics()->IsType( idPhysics_RigidBody::Type ) ) {
+				continue;
+			}
+			other = static_cast<idPhysics_RigidBody *>( ent->GetPhysics() );
+			if ( other->islandFrame != gameLocal.framenum || other->islandIndex < 0 || other->islandIndex >= num || islandBodies[other->islandIndex] != other ) {
+				continue;
+			}
+			root = RB_FindIsland( parent, i );
+			otherRoot = RB_FindIsland( parent, other->islandIndex );
+			if ( root != otherRoot ) {
+				parent[otherRoot] = root;
+			}
+		}
+	}
+
+	// an island can only rest if none of its bodies is still moving
+	for ( i = 0; i < num; i++ ) {
+		body = islandBodies[i];
+		if ( !body->restCandidate && body->current.atRest < 0 ) {
+			canRest[ RB_FindIsland( parent, i ) ] = false;
+		}
+	}
+
+	numIslands = numResting = 0;
+	for ( i = 0; i < num; i++ ) {
+		root = RB_FindIsland( parent, i );
+		if ( root == i ) {
+			numIslands++;
+			if ( canRest[i] ) {
+				numResting++;
+			}
+		}
+	}
+
+	for ( i = 0; i < num; i++ ) {
+		body = islandBodies[i];
+		if ( body->restCandidate && body->current.atRest < 0 && canRest[ RB_FindIsland( parent, i ) ] ) {
+			body->Rest();
+		}
+		body->restCandidate = false;
+		body->islandIndex = -1;
+	}
+
+	islandBodies.SetNum( 0 );
+
+	if ( rbBenchmarkFrames > 0 ) {
+		rbBenchmarkIslands += numIslands;
+		rbBenchmarkIslandsResting += numResting;
+		if ( --rbBenchmarkFrames == 0 ) {
+			const int frames = rbBenchmarkTotalFrames;
+			const int queries = rbBenchmarkContactQueries + rbBenchmarkContactReuses;
+			gameLocal.Printf( "rigid bodies over %d frames: %.3f msec per frame, %.1f active bodies, %.1f islands, %.1f islands put to rest\n",
+								frames, rbBenchmarkMicroseconds / ( 1000.0f * frames ), (float)rbBenchmarkBodies / frames,
+								(float)rbBenchmarkIslands / frames, (float)rbBenchmarkIslandsResting / frames );
+			gameLocal.Printf( "contacts: %d determined, %d reused from the cache (%.1f%%)\n",
+								rbBenchmarkContactQueries, rbBenchmarkContactReuses, queries ? 100.0f * rbBenchmarkContactReuses / queries : 0.0f );
+		}
+	}
+}
+
+/*
+================
+idPhysics_RigidBody::StartBenchmark
+================
+*/
+void idPhysics_RigidBody::StartBenchmark( const int numFrames ) {
+	rbBenchmarkFrames = numFrames;
+	rbBenchmarkTotalFrames = numFrames;
+	rbBenchmarkMicroseconds = 0;
+	rbBenchmarkBodies = 0;
+	rbBenchmarkIslands = 0;
+	rbBenchmarkIslandsResting = 0;
+	rbBenchmarkContactQueries = 0;
+	rbBenchmarkContactReuses = 0;
+}
@@ -80,6 +80,12 @@ typedef struct rigidBodyPState_s {
 	}
 } rigidBodyPState_t;
 
+typedef struct rigidBodyCachedContact_s {
+	contactInfo_t			info;						// contact with another clip model
+	idVec3					otherOrigin;				// origin of the other clip model when the contact was determined
+	idMat3					otherAxis;					// axis of the other clip model when the contact was determined
+} rigidBodyCachedContact_t;
+
 class idPhysics_RigidBody : public idPhysics_Base {
 
 public:
@@ -171,6 +177,11 @@ public:	// common physics interface
 	void					WriteToSnapshot( idBitMsg &msg ) const;
 	void					ReadFromSnapshot( const idBitMsg &msg );
 
+							// puts islands of touching rigid bodies to rest, called once per frame after all entities have thought
+	static void				UpdateIslands();
+							// gathers rigid body statistics over the next frames and prints them
+	static void				StartBenchmark( const int numFrames );
+
 private:
 	// state of the rigid body
 	rigidBodyPState_t		current;
@@ -204,6 +215,21 @@ private:
 	bool					hasMaster;
 	bool					isOrientated;
 
+	// islands
+	bool					restCandidate;				// came to rest this frame but only rests if the whole island can rest
+	int						islandFrame;				// frame number the body was last added to the island list
+	int						islandIndex;				// index into the island list for this frame
+
+	// contact cache
+	bool					contactCacheValid;			// true if the cached contacts can be tested for reuse
+	int						contactCacheFrame;			// frame number the cached contacts were determined
+	idVec3					contactCacheOrigin;			// origin of the clip model when the contacts were determined
+	idMat3					contactCacheAxis;			// axis of the clip model when the contacts were determined
+	idVec3					contactCacheDir;			// direction of movement when the contacts were determined
+	idList<rigidBodyCachedContact_t, TAG_IDLIB_LIST_PHYSICS> contactCache;
+
+	static idList<idPhysics_RigidBody *, TAG_IDLIB_LIST_PHYSICS> islandBodies;	// bodies evaluated this frame
+
 private:
 	friend void				RigidBodyDerivatives( const float t, const void *clientData, const float *state, float *derivatives );
 	void					Integrate( const float deltaTime, rigidBodyPState_t &next );
@@ -213,6 +239,9 @@ private:
 	void					DropToFloorAndRest();
 	bool					TestIfAtRest() const;
 	void					Rest();
+	bool					IsMovingFasterThan( const float speed ) const;
+	bool					ReuseCachedContacts( const idVec3 &dir );
+	void					CacheContacts( const idVec3 &dir );
 	void					DebugDraw();
 };
 
@@ -1365,7 +1365,7 @@ idCommonLocal::CreateMainMenu
 void idCommonLocal::CreateMainMenu() {
 	if ( game != NULL ) {
 		// note which media we are going to need to load
-		declManager->BeginLevelLoad();
+		declManager->BeginLevelLoad( "" );
 		renderSystem->BeginLevelLoad();
 		soundSystem->BeginLevelLoad();
 		uiManager->BeginLevelLoad();
@@ -468,7 +468,7 @@ void idCommonLocal::ExecuteMapChange() {
 	sm = Sys_Milliseconds();
 	renderSystem->BeginLevelLoad();
 	soundSystem->BeginLevelLoad();
-	declManager->BeginLevelLoad();
+	declManager->BeginLevelLoad( currentMapName );
 	uiManager->BeginLevelLoad();
 	ms = Sys_Milliseconds() - sm;
 	common->Printf( "%6d msec to free assets\n", ms );
@@ -29,6 +29,8 @@ If you have questions concerning this license or the applicable additional terms
 #include "../idlib/precompiled.h"
 #pragma hdrstop
 
+static const byte BDEF_VERSION = 100;
+static const unsigned int BDEF_MAGIC = ( 'B' << 24 ) | ( 'D' << 16 ) | ( 'E' << 8 ) | BDEF_VERSION;
 
 /*
 =================
@@ -57,6 +59,17 @@ bool idDeclEntityDef::Parse( const char *text, const int textLength, bool allowB
 	idLexer src;
 	idToken	token, token2;
 
+	if ( allowBinaryVersion ) {
+		idFileLocal file( declManager->ReadBinaryDecl( this ) );
+		if ( file != NULL ) {
+			if ( LoadBinary( file ) ) {
+				ResolveInheritance( NULL );
+				return true;
+			}
+			dict.Clear();
+		}
+	}
+
 	src.LoadMemory( text, textLength, GetFileName(), GetLineNum() );
 	src.SetFlags( DECL_LEXER_FLAGS );
 	src.SkipUntilString( "{" );
@@ -90,6 +103,23 @@ bool idDeclEntityDef::Parse( const char *text, const int textLength, bool allowB
 	// we always automatically set a "classname" key to our name
 	dict.Set( "classname", GetName() );
 
+	// the binary version is stored before inheriting, so changes to the
+	// inherited entityDefs are picked up without invalidating it
+	if ( allowBinaryVersion ) {
+		WriteBinary();
+	}
+
+	ResolveInheritance( &src );
+
+	return true;
+}
+
+/*
+================
+idDeclEntityDef::ResolveInheritance
+================
+*/
+void idDeclEntityDef::ResolveInheritance( idLexer *src ) {
 	// "inherit" keys will cause all values from another entityDef to be copied into this one
 	// if they don't conflict.  We can't have circular recursions, because each entityDef will
 	// never be parsed mroe than once
@@ -106,7 +136,11 @@ bool idDeclEntityDef::Parse( const char *text, const int textLength, bool allowB
 
 		const idDeclEntityDef *copy = static_cast<const idDeclEntityDef *>( declManager->FindType( DECL_ENTITYDEF, kv->GetValue(), false ) );
 		if ( !copy ) {
-			src.Warning( "Unknown entityDef '%s' inherited by '%s'", kv->GetValue().c_str(), GetName() );
+			if ( src != NULL ) {
+				src->Warning( "Unknown entityDef '%s' inherited by '%s'", kv->GetValue().c_str(), GetName() );
+			} else {
+				common->Warning( "Unknown entityDef '%s' inherited by '%s'", kv->GetValue().c_str(), GetName() );
+			}
 		} else {
 			defList.Append( copy );
 		}
@@ -121,10 +155,49 @@ bool idDeclEntityDef::Parse( const char *text, const int textLength, bool allowB
 	}
 
 	game->CacheDictionaryMedia( &dict );
+}
 
+/*
+================
+idDeclEntityDef::LoadBinary
+================
+*/
+bool idDeclEntityDef::LoadBinary( idFile *file ) {
+	unsigned int magic = 0;
+	file->ReadBig( magic );
+	if ( magic != BDEF_MAGIC ) {
+		return false;
+	}
+
+	int numKeys = 0;
+	file->ReadBig( numKeys );
+
+	idStr key, value;
+	for ( int i = 0; i < numKeys; i++ ) {
+		file->ReadString( key );
+		file->ReadString( value );
+		dict.Set( key, value );
+	}
 	return true;
 }
 
+/*
+================
+idDeclEntityDef::WriteBinary
+================
+*/
+void idDeclEntityDef::WriteBinary() const {
+	idFile_Memory file;
+	file.WriteBig( BDEF_MAGIC );
+	file.WriteBig( dict.GetNumKeyVals() );
+	for ( int i = 0; i < dict.GetNumKeyVals(); i++ ) {
+		const idKeyValue *kv = dict.GetKeyVal( i );
+		file.WriteString( kv->GetKey() );
+		file.WriteString( kv->GetValue() );
+	}
+	declManager->WriteBinaryDecl( this, &file );
+}
+
 /*
 ================
 idDeclEntityDef::DefaultDefinition
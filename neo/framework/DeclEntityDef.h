@@ -46,6 +46,11 @@ public:
 	virtual bool			Parse( const char *text, const int textLength, bool allowBinaryVersion );
 	virtual void			FreeData();
 	virtual void			Print();
+
+private:
+	void					ResolveInheritance( idLexer *src );
+	bool					LoadBinary( idFile *file );
+	void					WriteBinary() const;
 };
 
 #endif /* !__DECLENTITYDEF_H__ */
@@ -64,11 +64,81 @@ missing reload over a previously explicit definition
 #define USE_COMPRESSED_DECLS
 //#define GET_HUFFMAN_FREQUENCIES
 
+/*
+
+Decl text prefetching
+
+Parsing a decl can reference other decls, images and models, so tokenizing and parsing
+stay on the main thread. Only the huffman decompression of the decl text is done ahead.
+At the start of a level load the decls the level used the last time it was loaded and
+the decls the previous level used are queued, and jobs decompress their text in the
+background. A decl that is found before its job started
+is simply decompressed on the main thread, and one whose job is still running is waited
+for.
+
+*/
+
+static const int MAX_DECL_PREFETCH_JOBS		= 64;
+
+enum declPrefetchState_t {
+	DECL_PREFETCH_NONE,						// no prefetched text
+	DECL_PREFETCH_QUEUED,					// waiting for a job, can be claimed by the main thread
+	DECL_PREFETCH_BUSY,						// a job is preparing the text
+	DECL_PREFETCH_DONE						// prefetchText is ready for the parser
+};
+
+/*
+
+Binary decl cache
+
+The post-parse state of decls is stored per decl type in generated/decls/<type>.bdecl,
+keyed by decl name. Every entry carries a checksum of the decl text it was created from,
+so a decl that was edited simply misses the cache, gets parsed from text and replaces
+its entry. Each decl type writes its own versioned data into the entries.
+
+*/
+
+static const byte BDECL_VERSION = 100;
+static const unsigned int BDECL_MAGIC = ( 'B' << 24 ) | ( 'D' << 16 ) | ( 'C' << 8 ) | BDECL_VERSION;
+
+class idBinaryDeclCache {
+public:
+								idBinaryDeclCache();
+								~idBinaryDeclCache();
+
+	idFile *					Read( const char *declName, unsigned int sourceChecksum );
+	void						Write( const char *declName, unsigned int sourceChecksum, const idFile_Memory *data );
+	void						Flush();
+	void						Clear();
+
+public:
+	idStr						fileName;
+	int							numHits;
+	int							numMisses;
+
+private:
+	struct binaryDecl_t {
+		idStr					name;
+		unsigned int			checksum;
+		byte *					data;
+		int						length;
+	};
+
+	void						Load();
+	binaryDecl_t *				Find( const char *declName ) const;
+
+	bool						loaded;
+	bool						modified;
+	idList<binaryDecl_t *, TAG_DECL>	entries;
+	idHashIndex					entryHash;
+};
+
 class idDeclType {
 public:
 	idStr						typeName;
 	declType_t					type;
 	idDecl *					(*allocator)();
+	idBinaryDeclCache			binaryCache;
 };
 
 class idDeclFolder {
@@ -115,6 +185,14 @@ protected:
 	virtual void				List() const;
 	virtual void				Print() const;
 
+public:
+								// Decompresses the text for parsing, called from a prefetch job.
+	void						PrefetchText();
+
+								// Takes the prefetched text, waiting for the job to finish if needed.
+								// Returns NULL if there is no prefetched text.
+	char *						TakePrefetchedText( int & previousState );
+
 protected:
 	void						AllocateSelf();
 
@@ -151,6 +229,9 @@ private:
 	bool						redefinedInReload;		// used during file reloading to make sure a decl that has
 														// its source removed will be defaulted
 	idDeclLocal *				nextInFile;				// next decl in the decl file
+
+	idSysInterlockedInteger		prefetchState;			// declPrefetchState_t
+	char *						prefetchText;			// decompressed text prepared by a prefetch job
 };
 
 class idDeclFile {
@@ -173,6 +254,11 @@ public:
 	idDeclLocal *				decls;
 };
 
+struct declPrefetchJob_t {
+	idDeclLocal **				decls;
+	int							numDecls;
+};
+
 class idDeclManagerLocal : public idDeclManager {
 	friend class idDeclLocal;
 
@@ -181,7 +267,7 @@ public:
 	virtual void				Init2();
 	virtual void				Shutdown();
 	virtual void				Reload( bool force );
-	virtual void				BeginLevelLoad();
+	virtual void				BeginLevelLoad( const char *mapName );
 	virtual void				EndLevelLoad();
 	virtual void				RegisterDeclType( const char *typeName, declType_t type, idDecl *(*allocator)() );
 	virtual void				RegisterDeclFolder( const char *folder, const char *extension, declType_t defaultType );
@@ -217,6 +303,9 @@ public:
 
 	virtual void					Touch( const idDecl * decl );
 
+	virtual idFile *				ReadBinaryDecl( const idDecl *decl );
+	virtual void					WriteBinaryDecl( const idDecl *decl, const idFile_Memory *data );
+
 public:
 	static void					MakeNameCanonical( const char *name, char *result, int maxLength );
 	idDeclLocal *				FindTypeWithoutParsing( declType_t type, const char *name, bool makeDefault = true );
@@ -226,6 +315,16 @@ public:
 
 	void						ConvertPDAsToStrings( const idCmdArgs &args );
 
+	void						QueuePrefetch( idDeclLocal *decl );
+	void						StartPrefetch();
+	void						WaitForPrefetch();
+
+	void						FlushBinaryDecls();
+
+	void						WriteTouchCommands( idFile *f, bool print ) const;
+	void						QueueLevelPrecache();
+	void						WriteLevelPrecache() const;
+
 private:
 	idSysMutex					mutex;
 
@@ -241,20 +340,48 @@ private:
 	int							checksum;		// checksum of all loaded decl text
 	int							indent;			// for MediaPrint
 	bool						insideLevelLoad;
+	idStr						levelPrecacheName;	// generated/decls/<map>.precache of the level being loaded
+
+	idParallelJobList *			prefetchJobList;
+	declPrefetchJob_t			prefetchJobs[MAX_DECL_PREFETCH_JOBS];
+	idList<idDeclLocal *, TAG_IDLIB_LIST_DECL>		pendingPrefetch;	// queued decls not yet handed to a job
+	idList<idDeclLocal *, TAG_IDLIB_LIST_DECL>		activePrefetch;		// decls handed to the running jobs
+	int							numPrefetchQueued;
+	int							numPrefetchReady;	// parses that found their text already decompressed
+	int							numPrefetchWaited;	// parses that had to wait for a running job
+	int							numPrefetchClaimed;	// parses that decompressed the text before the job started
 
 	static idCVar				decl_show;
+	static idCVar				decl_prefetch;
+	static idCVar				decl_binaryCache;
 
 private:
 	static void					ListDecls_f( const idCmdArgs &args );
 	static void					ReloadDecls_f( const idCmdArgs &args );
 	static void					TouchDecl_f( const idCmdArgs &args );
+	static void					BenchmarkDecls_f( const idCmdArgs &args );
 };
 
 idCVar idDeclManagerLocal::decl_show( "decl_show", "0", CVAR_SYSTEM, "set to 1 to print parses, 2 to also print references", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
+idCVar idDeclManagerLocal::decl_binaryCache( "decl_binaryCache", "1", CVAR_SYSTEM | CVAR_BOOL, "load the post-parse state of decls from generated/decls/ and store it there after parsing from text" );
+idCVar idDeclManagerLocal::decl_prefetch( "decl_prefetch", "1", CVAR_SYSTEM | CVAR_BOOL, "decompress the text of decls expected to be used by a level on job threads during level load" );
 
 idDeclManagerLocal	declManagerLocal;
 idDeclManager *		declManager = &declManagerLocal;
 
+/*
+================
+DeclPrefetchJob
+================
+*/
+static void DeclPrefetchJob( declPrefetchJob_t * job ) {
+	for ( int i = 0; i < job->numDecls; i++ ) {
+		job->decls[i]->PrefetchText();
+	}
+}
+
+REGISTER_PARALLEL_JOB( DeclPrefetchJob, "DeclPrefetchJob" );
+
 /*
 ====================================================================================
 
@@ -622,6 +749,9 @@ int idDeclFile::LoadAndParse() {
 	idDeclLocal *newDecl;
 	bool		reparse;
 
+	// no job may be reading the decl text while it is replaced
+	declManagerLocal.WaitForPrefetch();
+
 	// load the text
 	common->DPrintf( "...loading '%s'\n", fileName.c_str() );
 	length = fileSystem->ReadFile( fileName, (void **)&buffer, &timestamp );
@@ -804,6 +934,7 @@ void idDeclManagerLocal::Init() {
 	common->Printf( "----- Initializing Decls -----\n" );
 
 	checksum = 0;
+	prefetchJobList = NULL;
 
 #ifdef USE_COMPRESSED_DECLS
 	SetupHuffman();
@@ -836,6 +967,7 @@ void idDeclManagerLocal::Init() {
 
 	cmdSystem->AddCommand( "reloadDecls", ReloadDecls_f, CMD_FL_SYSTEM, "reloads decls" );
 	cmdSystem->AddCommand( "touch", TouchDecl_f, CMD_FL_SYSTEM, "touches a decl" );
+	cmdSystem->AddCommand( "benchmarkDecls", BenchmarkDecls_f, CMD_FL_SYSTEM, "times reparsing the parsed decls from text and from the binary decl cache" );
 
 	cmdSystem->AddCommand( "listTables", idListDecls_f<DECL_TABLE>, CMD_FL_SYSTEM, "lists tables", idCmdSystem::ArgCompletion_String<listDeclStrings> );
 	cmdSystem->AddCommand( "listMaterials", idListDecls_f<DECL_MATERIAL>, CMD_FL_SYSTEM, "lists materials", idCmdSystem::ArgCompletion_String<listDeclStrings> );
@@ -888,6 +1020,14 @@ void idDeclManagerLocal::Shutdown() {
 	int			i, j;
 	idDeclLocal *decl;
 
+	WaitForPrefetch();
+	if ( prefetchJobList != NULL ) {
+		parallelJobManager->FreeJobList( prefetchJobList );
+		prefetchJobList = NULL;
+	}
+
+	FlushBinaryDecls();
+
 	// free decls
 	for ( i = 0; i < DECL_MAX_TYPES; i++ ) {
 		for ( j = 0; j < linearLists[i].Num(); j++ ) {
@@ -934,18 +1074,41 @@ void idDeclManagerLocal::Reload( bool force ) {
 idDeclManagerLocal::BeginLevelLoad
 ===================
 */
-void idDeclManagerLocal::BeginLevelLoad() {
+void idDeclManagerLocal::BeginLevelLoad( const char *mapName ) {
 	insideLevelLoad = true;
 
+	if ( mapName != NULL && mapName[0] != '\0' ) {
+		levelPrecacheName.Format( "generated/decls/%s.precache", mapName );
+	} else {
+		levelPrecacheName.Clear();
+	}
+
+	WaitForPrefetch();
+	numPrefetchQueued = 0;
+	numPrefetchReady = 0;
+	numPrefetchWaited = 0;
+	numPrefetchClaimed = 0;
+
 	// clear all the referencedThisLevel flags and purge all the data
 	// so the next reference will cause a reparse
 	for ( int i = 0; i < DECL_MAX_TYPES; i++ ) {
 		int	num = linearLists[i].Num();
 		for ( int j = 0 ; j < num ; j++ ) {
 			idDeclLocal *decl = linearLists[i][j];
+			const bool referencedLastLevel = decl->referencedThisLevel;
 			decl->Purge();
+
+			// levels share most of their decls, so expect the last level's to be needed again
+			if ( referencedLastLevel ) {
+				QueuePrefetch( decl );
+			}
 		}
 	}
+
+	// the decls this level used the last time, which also covers the first load after startup
+	QueueLevelPrecache();
+
+	StartPrefetch();
 }
 
 /*
@@ -954,8 +1117,22 @@ idDeclManagerLocal::EndLevelLoad
 ===================
 */
 void idDeclManagerLocal::EndLevelLoad() {
+	// release the text of decls that weren't used by this level after all
+	WaitForPrefetch();
+
+	if ( numPrefetchQueued > 0 ) {
+		common->Printf( "%6d decl texts queued for decompression, %d decompressed ahead, %d waited for a job, %d decompressed inline, %d unused\n",
+			numPrefetchQueued, numPrefetchReady, numPrefetchWaited, numPrefetchClaimed,
+			numPrefetchQueued - numPrefetchReady - numPrefetchWaited - numPrefetchClaimed );
+	}
+
 	insideLevelLoad = false;
 
+	WriteLevelPrecache();
+
+	// save the binary versions of the decls that were parsed from text
+	FlushBinaryDecls();
+
 	// we don't need to do anything here, but the image manager, model manager,
 	// and sound sample manager will need to free media that was not referenced
 }
@@ -977,6 +1154,7 @@ void idDeclManagerLocal::RegisterDeclType( const char *typeName, declType_t type
 	declType->typeName = typeName;
 	declType->type = type;
 	declType->allocator = allocator;
+	declType->binaryCache.fileName.Format( "generated/decls/%s.bdecl", typeName );
 
 	if ( (int)type + 1 > declTypes.Num() ) {
 		declTypes.AssureSize( (int)type + 1, NULL );
@@ -1521,6 +1699,17 @@ idDeclManagerLocal::WritePrecacheCommands
 ===================
 */
 void idDeclManagerLocal::WritePrecacheCommands( idFile *f ) {
+	WriteTouchCommands( f, true );
+}
+
+/*
+===================
+idDeclManagerLocal::WriteTouchCommands
+
+Writes a touch command for every decl referenced this level.
+===================
+*/
+void idDeclManagerLocal::WriteTouchCommands( idFile *f, bool print ) const {
 	for ( int i = 0; i < declTypes.Num(); i++ ) {
 		int num;
 
@@ -1539,7 +1728,9 @@ void idDeclManagerLocal::WritePrecacheCommands( idFile *f ) {
 
 			char	str[1024];
 			sprintf( str, "touch %s %s\n", declTypes[i]->typeName.c_str(), decl->GetName() );
-			common->Printf( "%s", str );
+			if ( print ) {
+				common->Printf( "%s", str );
+			}
 			f->Printf( "%s", str );
 		}
 	}
@@ -1717,6 +1908,424 @@ void idDeclManagerLocal::TouchDecl_f( const idCmdArgs &args ) {
 	}
 }
 
+/*
+===================
+idDeclManagerLocal::QueuePrefetch
+===================
+*/
+void idDeclManagerLocal::QueuePrefetch( idDeclLocal *decl ) {
+	if ( !decl_prefetch.GetBool() ) {
+		return;
+	}
+	if ( decl->declState != DS_UNPARSED || decl->textSource == NULL || decl->prefetchState.GetValue() != DECL_PREFETCH_NONE ) {
+		return;
+	}
+	decl->prefetchState.SetValue( DECL_PREFETCH_QUEUED );
+	pendingPrefetch.Append( decl );
+	numPrefetchQueued++;
+}
+
+/*
+===================
+idDeclManagerLocal::QueueLevelPrecache
+
+Queues the decls touched by the precache file of the level being loaded.
+===================
+*/
+void idDeclManagerLocal::QueueLevelPrecache() {
+	if ( !decl_prefetch.GetBool() || levelPrecacheName.IsEmpty() ) {
+		return;
+	}
+
+	char *buffer = NULL;
+	const int length = fileSystem->ReadFile( levelPrecacheName, (void **)&buffer, NULL );
+	if ( length <= 0 || buffer == NULL ) {
+		return;
+	}
+
+	idCmdArgs args;
+	for ( char *line = buffer; *line != '\0'; ) {
+		char *end = strchr( line, '\n' );
+		if ( end != NULL ) {
+			*end = '\0';
+		}
+
+		args.TokenizeString( line, false );
+		if ( args.Argc() == 3 && idStr::Icmp( args.Argv( 0 ), "touch" ) == 0 ) {
+			const declType_t type = GetDeclTypeFromName( args.Argv( 1 ) );
+			if ( type != DECL_MAX_TYPES ) {
+				idDeclLocal *decl = FindTypeWithoutParsing( type, args.Argv( 2 ), false );
+				if ( decl != NULL ) {
+					QueuePrefetch( decl );
+				}
+			}
+		}
+
+		if ( end == NULL ) {
+			break;
+		}
+		line = end + 1;
+	}
+
+	fileSystem->FreeFile( buffer );
+}
+
+/*
+===================
+idDeclManagerLocal::WriteLevelPrecache
+
+Stores the decls referenced by the level that was just loaded for the next time it's loaded.
+===================
+*/
+void idDeclManagerLocal::WriteLevelPrecache() const {
+	// the generated files are part of the resource files in builds that use them
+	if ( !decl_prefetch.GetBool() || levelPrecacheName.IsEmpty() || fileSystem->UsingResourceFiles() ) {
+		return;
+	}
+
+	idFileLocal file( fileSystem->OpenFileWrite( levelPrecacheName, "fs_basepath" ) );
+	if ( file == NULL ) {
+		common->Warning( "couldn't write %s", levelPrecacheName.c_str() );
+		return;
+	}
+	WriteTouchCommands( file, false );
+}
+
+/*
+===================
+idDeclManagerLocal::StartPrefetch
+
+Hands the queued decls to jobs, the previous jobs must have been waited for.
+===================
+*/
+void idDeclManagerLocal::StartPrefetch() {
+	if ( pendingPrefetch.Num() == 0 ) {
+		return;
+	}
+
+	if ( prefetchJobList == NULL ) {
+		prefetchJobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_LOW, MAX_DECL_PREFETCH_JOBS, 0, NULL );
+	}
+
+	activePrefetch = pendingPrefetch;
+	pendingPrefetch.SetNum( 0 );
+
+	const int declsPerJob = Max( ( activePrefetch.Num() + MAX_DECL_PREFETCH_JOBS - 1 ) / MAX_DECL_PREFETCH_JOBS, 1 );
+	int numJobs = 0;
+	for ( int i = 0; i < activePrefetch.Num(); i += declsPerJob ) {
+		declPrefetchJob_t & job = prefetchJobs[numJobs++];
+		job.decls = activePrefetch.Ptr() + i;
+		job.numDecls = Min( declsPerJob, activePrefetch.Num() - i );
+		prefetchJobList->AddJob( (jobRun_t)DeclPrefetchJob, &job );
+	}
+	prefetchJobList->Submit();
+}
+
+/*
+===================
+idDeclManagerLocal::WaitForPrefetch
+
+Waits for the running jobs and releases all prefetched text that wasn't used.
+===================
+*/
+void idDeclManagerLocal::WaitForPrefetch() {
+	if ( prefetchJobList != NULL ) {
+		prefetchJobList->Wait();
+	}
+
+	for ( int i = 0; i < activePrefetch.Num(); i++ ) {
+		int previousState;
+		Mem_Free( activePrefetch[i]->TakePrefetchedText( previousState ) );
+	}
+	for ( int i = 0; i < pendingPrefetch.Num(); i++ ) {
+		pendingPrefetch[i]->prefetchState.SetValue( DECL_PREFETCH_NONE );
+	}
+	activePrefetch.Clear();
+	pendingPrefetch.Clear();
+}
+
+/*
+===================
+idDeclManagerLocal::ReadBinaryDecl
+===================
+*/
+idFile *idDeclManagerLocal::ReadBinaryDecl( const idDecl *decl ) {
+	if ( !decl_binaryCache.GetBool() ) {
+		return NULL;
+	}
+	const idDeclLocal *declLocal = static_cast< const idDeclLocal * >( decl->base );
+	return declTypes[decl->GetType()]->binaryCache.Read( decl->GetName(), declLocal->checksum );
+}
+
+/*
+===================
+idDeclManagerLocal::WriteBinaryDecl
+===================
+*/
+void idDeclManagerLocal::WriteBinaryDecl( const idDecl *decl, const idFile_Memory *data ) {
+	// the generated files are part of the resource files in builds that use them
+	if ( !decl_binaryCache.GetBool() || fileSystem->UsingResourceFiles() ) {
+		return;
+	}
+	const idDeclLocal *declLocal = static_cast< const idDeclLocal * >( decl->base );
+	declTypes[decl->GetType()]->binaryCache.Write( decl->GetName(), declLocal->checksum, data );
+}
+
+/*
+===================
+idDeclManagerLocal::FlushBinaryDecls
+===================
+*/
+void idDeclManagerLocal::FlushBinaryDecls() {
+	for ( int i = 0; i < declTypes.Num(); i++ ) {
+		if ( declTypes[i] != NULL ) {
+			declTypes[i]->binaryCache.Flush();
+		}
+	}
+}
+
+/*
+===================
+idDeclManagerLocal::BenchmarkDecls_f
+
+Reparses all currently parsed decls of the given types three times: from text,
+from text while filling the binary cache, and from the binary cache. Only decls
+that are already parsed are used, so the media they reference is already loaded.
+===================
+*/
+void idDeclManagerLocal::BenchmarkDecls_f( const idCmdArgs &args ) {
+	idList<declType_t> types;
+
+	if ( args.Argc() > 1 ) {
+		declType_t type = declManagerLocal.GetDeclTypeFromName( args.Argv( 1 ) );
+		if ( type == DECL_MAX_TYPES ) {
+			common->Printf( "unknown decl type '%s'\n", args.Argv( 1 ) );
+			return;
+		}
+		types.Append( type );
+	} else {
+		types.Append( DECL_TABLE );
+		types.Append( DECL_MATERIAL );
+		types.Append( DECL_SKIN );
+		types.Append( DECL_ENTITYDEF );
+	}
+
+	const bool useBinaryCache = decl_binaryCache.GetBool();
+
+	for ( int t = 0; t < types.Num(); t++ ) {
+		idDeclType *declType = declManagerLocal.declTypes[types[t]];
+		if ( declType == NULL ) {
+			continue;
+		}
+
+		idList<idDeclLocal *> decls;
+		for ( int i = 0; i < declManagerLocal.linearLists[types[t]].Num(); i++ ) {
+			idDeclLocal *decl = declManagerLocal.linearLists[types[t]][i];
+			if ( decl->declState == DS_PARSED ) {
+				decls.Append( decl );
+			}
+		}
+
+		uint64 passTime[3];
+		int numHits = 0;
+		for ( int pass = 0; pass < 3; pass++ ) {
+			decl_binaryCache.SetBool( pass > 0 );
+
+			const int startHits = declType->binaryCache.numHits;
+			const uint64 start = Sys_Microseconds();
+			for ( int i = 0; i < decls.Num(); i++ ) {
+				decls[i]->Invalidate();
+				decls[i]->EnsureNotPurged();
+			}
+			passTime[pass] = Sys_Microseconds() - start;
+			numHits = declType->binaryCache.numHits - startHits;
+		}
+
+		common->Printf( "%-20s %5d decls: text %7.2f ms, writing cache %7.2f ms, binary %7.2f ms, %d cache hits\n",
+			declType->typeName.c_str(), decls.Num(), passTime[0] * 0.001f, passTime[1] * 0.001f, passTime[2] * 0.001f, numHits );
+	}
+
+	decl_binaryCache.SetBool( useBinaryCache );
+	declManagerLocal.FlushBinaryDecls();
+}
+
+/*
+====================================================================================
+
+ idBinaryDeclCache
+
+====================================================================================
+*/
+
+/*
+===================
+idBinaryDeclCache::idBinaryDeclCache
+===================
+*/
+idBinaryDeclCache::idBinaryDeclCache() {
+	numHits = 0;
+	numMisses = 0;
+	loaded = false;
+	modified = false;
+}
+
+/*
+===================
+idBinaryDeclCache::~idBinaryDeclCache
+===================
+*/
+idBinaryDeclCache::~idBinaryDeclCache() {
+	Clear();
+}
+
+/*
+===================
+idBinaryDeclCache::Clear
+===================
+*/
+void idBinaryDeclCache::Clear() {
+	for ( int i = 0; i < entries.Num(); i++ ) {
+		Mem_Free( entries[i]->data );
+	}
+	entries.DeleteContents( true );
+	entryHash.Free();
+	loaded = false;
+	modified = false;
+}
+
+/*
+===================
+idBinaryDeclCache::Load
+
+Reads the whole cache file the first time a decl of this type is looked up.
+===================
+*/
+void idBinaryDeclCache::Load() {
+	loaded = true;
+
+	idFileLocal file( fileSystem->OpenFileReadMemory( fileName ) );
+	if ( file == NULL ) {
+		return;
+	}
+
+	unsigned int magic = 0;
+	file->ReadBig( magic );
+	if ( magic != BDECL_MAGIC ) {
+		return;
+	}
+
+	int numEntries = 0;
+	file->ReadBig( numEntries );
+	for ( int i = 0; i < numEntries; i++ ) {
+		binaryDecl_t *entry = new (TAG_DECL) binaryDecl_t;
+		file->ReadString( entry->name );
+		file->ReadBig( entry->checksum );
+		file->ReadBig( entry->length );
+		if ( entry->length < 0 || entry->length > file->Length() - file->Tell() ) {
+			common->Warning( "%s is corrupt", fileName.c_str() );
+			delete entry;
+			break;
+		}
+		entry->data = (byte *)Mem_Alloc( entry->length, TAG_DECL );
+		file->Read( entry->data, entry->length );
+		entryHash.Add( entryHash.GenerateKey( entry->name, false ), entries.Append( entry ) );
+	}
+}
+
+/*
+===================
+idBinaryDeclCache::Find
+===================
+*/
+idBinaryDeclCache::binaryDecl_t *idBinaryDeclCache::Find( const char *declName ) const {
+	const int key = entryHash.GenerateKey( declName, false );
+	for ( int i = entryHash.First( key ); i != -1; i = entryHash.Next( i ) ) {
+		if ( entries[i]->name.Icmp( declName ) == 0 ) {
+			return entries[i];
+		}
+	}
+	return NULL;
+}
+
+/*
+===================
+idBinaryDeclCache::Read
+
+Returns a file with the cached data if it was created from the same decl text.
+===================
+*/
+idFile *idBinaryDeclCache::Read( const char *declName, unsigned int sourceChecksum ) {
+	if ( !loaded ) {
+		Load();
+	}
+
+	const binaryDecl_t *entry = Find( declName );
+	if ( entry == NULL || entry->checksum != sourceChecksum ) {
+		numMisses++;
+		return NULL;
+	}
+
+	numHits++;
+	return new (TAG_DECL) idFile_Memory( declName, (const char *)entry->data, entry->length );
+}
+
+/*
+===================
+idBinaryDeclCache::Write
+===================
+*/
+void idBinaryDeclCache::Write( const char *declName, unsigned int sourceChecksum, const idFile_Memory *data ) {
+	if ( !loaded ) {
+		Load();
+	}
+
+	binaryDecl_t *entry = Find( declName );
+	if ( entry == NULL ) {
+		entry = new (TAG_DECL) binaryDecl_t;
+		entry->name = declName;
+		entryHash.Add( entryHash.GenerateKey( entry->name, false ), entries.Append( entry ) );
+	} else {
+		Mem_Free( entry->data );
+	}
+
+	entry->checksum = sourceChecksum;
+	entry->length = data->Length();
+	entry->data = (byte *)Mem_Alloc( entry->length, TAG_DECL );
+	memcpy( entry->data, data->GetDataPtr(), entry->length );
+
+	modified = true;
+}
+
+/*
+===================
+idBinaryDeclCache::Flush
+
+Writes the cache file if any entries were added or replaced.
+===================
+*/
+void idBinaryDeclCache::Flush() {
+	if ( !modified ) {
+		return;
+	}
+	modified = false;
+
+	idFileLocal file( fileSystem->OpenFileWrite( fileName, "fs_basepath" ) );
+	if ( file == NULL ) {
+		common->Warning( "couldn't write %s", fileName.c_str() );
+		return;
+	}
+
+	file->WriteBig( BDECL_MAGIC );
+	file->WriteBig( entries.Num() );
+	for ( int i = 0; i < entries.Num(); i++ ) {
+		const binaryDecl_t *entry = entries[i];
+		file->WriteString( entry->name );
+		file->WriteBig( entry->checksum );
+		file->WriteBig( entry->length );
+		file->Write( entry->data, entry->length );
+	}
+}
+
 /*
 ===================
 idDeclManagerLocal::FindTypeWithoutParsing
@@ -1978,6 +2587,8 @@ idDeclLocal::idDeclLocal() {
 	everReferenced = false;
 	redefinedInReload = false;
 	nextInFile = NULL;
+	prefetchState.SetValue( DECL_PREFETCH_NONE );
+	prefetchText = NULL;
 }
 
 /*
@@ -2119,6 +2730,10 @@ idDeclLocal::SetTextLocal
 */
 void idDeclLocal::SetTextLocal( const char *text, const int length ) {
 
+	// any prefetched text is out of date now
+	int previousPrefetchState;
+	Mem_Free( TakePrefetchedText( previousPrefetchState ) );
+
 	Mem_Free( textSource );
 
 	checksum = MD5_BlockChecksum( text, length );
@@ -2389,10 +3004,25 @@ void idDeclLocal::ParseLocal() {
 
 	declState = DS_PARSED;
 
+	// use the text decompressed by a prefetch job if there is one
+	int prefetchedState;
+	char *prefetchedText = TakePrefetchedText( prefetchedState );
+	if ( prefetchedState == DECL_PREFETCH_QUEUED ) {
+		declManagerLocal.numPrefetchClaimed++;
+	} else if ( prefetchedState == DECL_PREFETCH_BUSY ) {
+		declManagerLocal.numPrefetchWaited++;
+	} else if ( prefetchedState == DECL_PREFETCH_DONE ) {
+		declManagerLocal.numPrefetchReady++;
+	}
+
 	// parse
-	char *declText = (char *) _alloca( ( GetTextLength() + 1 ) * sizeof( char ) );
-	GetText( declText );
+	char *declText = prefetchedText;
+	if ( declText == NULL ) {
+		declText = (char *) _alloca( ( GetTextLength() + 1 ) * sizeof( char ) );
+		GetText( declText );
+	}
 	self->Parse( declText, GetTextLength(), true );
+	Mem_Free( prefetchedText );
 
 	// free generated text
 	if ( generatedDefaultText ) {
@@ -2404,6 +3034,46 @@ void idDeclLocal::ParseLocal() {
 	declManagerLocal.indent--;
 }
 
+/*
+=================
+idDeclLocal::PrefetchText
+=================
+*/
+void idDeclLocal::PrefetchText() {
+	// the main thread may have claimed the decl already
+	if ( prefetchState.CompareExchange( DECL_PREFETCH_QUEUED, DECL_PREFETCH_BUSY ) != DECL_PREFETCH_QUEUED ) {
+		return;
+	}
+
+	prefetchText = (char *)Mem_Alloc( GetTextLength() + 1, TAG_DECLTEXT );
+	GetText( prefetchText );
+
+	// publish the text
+	prefetchState.CompareExchange( DECL_PREFETCH_BUSY, DECL_PREFETCH_DONE );
+}
+
+/*
+=================
+idDeclLocal::TakePrefetchedText
+=================
+*/
+char *idDeclLocal::TakePrefetchedText( int & previousState ) {
+	// claim it if no job has started on it yet
+	previousState = prefetchState.CompareExchange( DECL_PREFETCH_QUEUED, DECL_PREFETCH_NONE );
+	if ( previousState == DECL_PREFETCH_NONE || previousState == DECL_PREFETCH_QUEUED ) {
+		return NULL;
+	}
+
+	while ( prefetchState.GetValue() != DECL_PREFETCH_DONE ) {
+		Sys_Yield();
+	}
+
+	char *text = prefetchText;
+	prefetchText = NULL;
+	prefetchState.SetValue( DECL_PREFETCH_NONE );
+	return text;
+}
+
 /*
 =================
 idDeclLocal::Purge
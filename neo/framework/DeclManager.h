@@ -256,7 +256,9 @@ public:
 	virtual void			Shutdown() = 0;
 	virtual void			Reload( bool force ) = 0;
 
-	virtual void			BeginLevelLoad() = 0;
+							// The decls a level referenced are written to generated/decls/<mapName>.precache
+							// at the end of its load, and prefetched from there at the start of the next load.
+	virtual void			BeginLevelLoad( const char *mapName ) = 0;
 	virtual void			EndLevelLoad() = 0;
 
 							// Registers a new decl type.
@@ -321,6 +323,13 @@ public:
 	virtual const idSoundShader *	SoundByIndex( int index, bool forceParse = true ) = 0;
 
 	virtual void					Touch( const idDecl * decl ) = 0;
+
+									// The binary decl cache holds the post-parse state of decls, validated against
+									// the checksum the decl manager keeps of their source text. Returns a file to load the
+									// state from, or NULL if there is no up to date version. The caller deletes the file.
+	virtual idFile *				ReadBinaryDecl( const idDecl *decl ) = 0;
+									// Stores the post-parse state of a decl that was parsed from its source text.
+	virtual void					WriteBinaryDecl( const idDecl *decl, const idFile_Memory *data ) = 0;
 };
 
 extern idDeclManager *		declManager;
@@ -30,6 +30,7 @@ If you have questions concerning this license or the applicable additional terms
 #pragma hdrstop
 
 idCVar binaryLoadParticles( "binaryLoadParticles", "1", 0, "enable binary load/write of particle decls" );
+idCVar r_useParticleBatches( "r_useParticleBatches", "1", CVAR_RENDERER | CVAR_BOOL, "evaluate particle colors and quads four particles at a time" );
 
 static const byte BPRT_VERSION = 101;
 static const unsigned int BPRT_MAGIC = ( 'B' << 24 ) | ( 'P' << 16 ) | ( 'R' << 8 ) | BPRT_VERSION;
@@ -1506,11 +1507,22 @@ int idParticleStage::CreateParticle( particleGen_t *g, idDrawVert *verts ) const
 
 	int	numVerts = ParticleVerts( g, origin, verts );
 
+	return ParticleCrossFade( g, verts, numVerts );
+}
+
+/*
+================
+idParticleStage::ParticleCrossFade
+
+If we are doing strip-animation, the quads need to be doubled and cross faded.
+Returns the final number of verts.
+================
+*/
+int idParticleStage::ParticleCrossFade( const particleGen_t *g, idDrawVert *verts, int numVerts ) const {
 	if ( animationFrames <= 1 ) {
 		return numVerts;
 	}
 
-	// if we are doing strip-animation, we need to double the quad and cross fade it
 	float	width = 1.0f / animationFrames;
 	float	frac = g->animationFrameFrac;
 	float	iFrac = 1.0f - frac;
@@ -1536,6 +1548,296 @@ int idParticleStage::CreateParticle( particleGen_t *g, idDrawVert *verts ) const
 	return numVerts * 2;
 }
 
+/*
+================
+idParticleStage::CreateParticles
+
+Creates the same verts as calling CreateParticle on each particle in turn.
+The fade colors and the quad corners are evaluated for four particles at a
+time, while everything that consumes the per-particle random sequence is
+still done one particle after the other, so the results are identical.
+All particles must share the same render entity and view.
+================
+*/
+int idParticleStage::CreateParticles( particleGen_t *gens, int numGens, idDrawVert *verts ) const {
+	if ( numGens <= 0 ) {
+		return 0;
+	}
+
+	// aimed particles step back in time to build trails, which doesn't batch
+	if ( orientation == POR_AIMED || !r_useParticleBatches.GetBool() ) {
+		int numVerts = 0;
+		for ( int i = 0; i < numGens; i++ ) {
+			numVerts += CreateParticle( &gens[i], verts + numVerts );
+		}
+		return numVerts;
+	}
+
+	const renderEntity_t * renderEnt = gens[0].renderEnt;
+	const renderView_t * renderView = gens[0].renderView;
+
+	// the quad orientation is always left = axisA * c + axisB * s and up = axisB * c - axisA * s
+	idVec3 axisA, axisB;
+	if ( orientation == POR_Z ) {
+		axisA.Set( 0.0f, 1.0f, 0.0f );
+		axisB.Set( 1.0f, 0.0f, 0.0f );
+	} else if ( orientation == POR_X ) {
+		axisA.Set( 0.0f, 1.0f, 0.0f );
+		axisB.Set( 0.0f, 0.0f, 1.0f );
+	} else if ( orientation == POR_Y ) {
+		axisA.Set( 1.0f, 0.0f, 0.0f );
+		axisB.Set( 0.0f, 0.0f, 1.0f );
+	} else {
+		// oriented in viewer space
+		renderEnt->axis.ProjectVector( renderView->viewaxis[1], axisA );
+		renderEnt->axis.ProjectVector( renderView->viewaxis[2], axisB );
+	}
+
+	ALIGN16( float baseColor[4] );
+	ALIGN16( float baseFadeColor[4] );
+	for ( int i = 0; i < 4; i++ ) {
+		baseColor[i] = ( entityColor ) ? renderEnt->shaderParms[i] : color[i];
+		baseFadeColor[i] = fadeColor[i];
+	}
+
+	// the divisors are only used for lanes that pass the compare, so they can never be zero there
+	const float fadeInDivisor = ( fadeInFraction > 0.0f ) ? fadeInFraction : 1.0f;
+	const float fadeOutDivisor = ( fadeOutFraction > 0.0f ) ? fadeOutFraction : 1.0f;
+	const float fadeIndexDivisor = ( fadeIndexFraction > 0.0f ) ? fadeIndexFraction : 1.0f;
+	const float totalParticlesFloat = (float)totalParticles;
+	const int vertsPerParticle = ( animationFrames > 1 ) ? 8 : 4;
+
+	int numVerts = 0;
+
+	for ( int base = 0; base < numGens; base += 4 ) {
+		const int count = Min( numGens - base, 4 );
+
+		ALIGN16( float frac[4] );
+		ALIGN16( int index[4] );
+		for ( int i = 0; i < 4; i++ ) {
+			const particleGen_t * g = &gens[base + Min( i, count - 1 )];
+			frac[i] = g->frac;
+			index[i] = g->index;
+		}
+
+		//
+		// fade fractions for four particles
+		//
+		ALIGN16( float fade[4] );
+
+#ifdef ID_WIN_X86_SSE2_INTRIN
+
+		const __m128 vector_float_one = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+		const __m128 vecFrac = _mm_load_ps( frac );
+		const __m128 vecFadeIn = _mm_splat_ps( _mm_load_ss( &fadeInFraction ), 0 );
+		const __m128 vecFadeOut = _mm_splat_ps( _mm_load_ss( &fadeOutFraction ), 0 );
+		const __m128 vecFadeInDivisor = _mm_splat_ps( _mm_load_ss( &fadeInDivisor ), 0 );
+		const __m128 vecFadeOutDivisor = _mm_splat_ps( _mm_load_ss( &fadeOutDivisor ), 0 );
+
+		__m128 vecFade = vector_float_one;
+
+		// most particles fade in at the beginning and fade out at the end
+		const __m128 fadeInMask = _mm_cmplt_ps( vecFrac, vecFadeIn );
+		vecFade = _mm_sel_ps( vecFade, _mm_mul_ps( vecFade, _mm_div_ps( vecFrac, vecFadeInDivisor ) ), fadeInMask );
+
+		const __m128 vecInvFrac = _mm_sub_ps( vector_float_one, vecFrac );
+		const __m128 fadeOutMask = _mm_cmplt_ps( vecInvFrac, vecFadeOut );
+		vecFade = _mm_sel_ps( vecFade, _mm_mul_ps( vecFade, _mm_div_ps( vecInvFrac, vecFadeOutDivisor ) ), fadeOutMask );
+
+		// individual gun smoke particles get more and more faded as the cycle goes on
+		if ( fadeIndexFraction ) {
+			const __m128i vecTotal = _mm_shuffle_epi32( _mm_cvtsi32_si128( totalParticles ), 0 );
+			const __m128 vecTotalFloat = _mm_splat_ps( _mm_load_ss( &totalParticlesFloat ), 0 );
+			const __m128 vecFadeIndex = _mm_splat_ps( _mm_load_ss( &fadeIndexFraction ), 0 );
+			const __m128 vecFadeIndexDivisor = _mm_splat_ps( _mm_load_ss( &fadeIndexDivisor ), 0 );
+
+			const __m128 indexFrac = _mm_div_ps( _mm_cvtepi32_ps( _mm_sub_epi32( vecTotal, _mm_load_si128( (const __m128i *)index ) ) ), vecTotalFloat );
+			const __m128 fadeIndexMask = _mm_cmplt_ps( indexFrac, vecFadeIndex );
+			vecFade = _mm_sel_ps( vecFade, _mm_mul_ps( vecFade, _mm_div_ps( indexFrac, vecFadeIndexDivisor ) ), fadeIndexMask );
+		}
+
+		_mm_store_ps( fade, vecFade );
+
+#else
+
+		for ( int i = 0; i < 4; i++ ) {
+			float fadeFraction = 1.0f;
+			if ( frac[i] < fadeInFraction ) {
+				fadeFraction *= ( frac[i] / fadeInDivisor );
+			}
+			if ( 1.0f - frac[i] < fadeOutFraction ) {
+				fadeFraction *= ( ( 1.0f - frac[i] ) / fadeOutDivisor );
+			}
+			if ( fadeIndexFraction ) {
+				float indexFrac = ( totalParticles - index[i] ) / totalParticlesFloat;
+				if ( indexFrac < fadeIndexFraction ) {
+					fadeFraction *= indexFrac / fadeIndexDivisor;
+				}
+			}
+			fade[i] = fadeFraction;
+		}
+
+#endif
+
+		//
+		// colors, completely faded out particles are killed here
+		//
+		int numLive = 0;
+		int live[4];
+		dword colors[4];
+
+		for ( int i = 0; i < count; i++ ) {
+#ifdef ID_WIN_X86_SSE2_INTRIN
+			const __m128 vector_float_255 = { 255.0f, 255.0f, 255.0f, 255.0f };
+			const __m128 f = _mm_splat_ps( _mm_load_ss( &fade[i] ), 0 );
+			const __m128 invF = _mm_sub_ps( vector_float_one, f );
+			__m128 c = _mm_add_ps( _mm_mul_ps( _mm_load_ps( baseColor ), f ), _mm_mul_ps( _mm_load_ps( baseFadeColor ), invF ) );
+			__m128i ci = _mm_cvttps_epi32( _mm_mul_ps( c, vector_float_255 ) );
+			ci = _mm_packs_epi32( ci, ci );
+			ci = _mm_packus_epi16( ci, ci );
+			colors[i] = (dword)_mm_cvtsi128_si32( ci );
+#else
+			byte * c = (byte *)&colors[i];
+			for ( int j = 0; j < 4; j++ ) {
+				float fcolor = baseColor[j] * fade[i] + baseFadeColor[j] * ( 1.0f - fade[i] );
+				int icolor = idMath::Ftoi( fcolor * 255.0f );
+				c[j] = (byte)( ( icolor < 0 ) ? 0 : ( ( icolor > 255 ) ? 255 : icolor ) );
+			}
+#endif
+			if ( colors[i] != 0 ) {
+				live[numLive++] = i;
+			}
+		}
+
+		if ( numLive == 0 ) {
+			continue;
+		}
+
+		//
+		// origins and rotations, these consume the per-particle random sequence
+		//
+		ALIGN16( float originX[4] ) = { 0.0f, 0.0f, 0.0f, 0.0f };
+		ALIGN16( float originY[4] ) = { 0.0f, 0.0f, 0.0f, 0.0f };
+		ALIGN16( float originZ[4] ) = { 0.0f, 0.0f, 0.0f, 0.0f };
+		ALIGN16( float sinAngle[4] ) = { 0.0f, 0.0f, 0.0f, 0.0f };
+		ALIGN16( float cosAngle[4] ) = { 0.0f, 0.0f, 0.0f, 0.0f };
+		ALIGN16( float width[4] ) = { 0.0f, 0.0f, 0.0f, 0.0f };
+		ALIGN16( float height[4] ) = { 0.0f, 0.0f, 0.0f, 0.0f };
+		idDrawVert * dest[4];
+
+		for ( int i = 0; i < numLive; i++ ) {
+			particleGen_t * g = &gens[base + live[i]];
+			idDrawVert * v = verts + numVerts;
+
+			for ( int j = 0; j < 4; j++ ) {
+				v[j].Clear();
+				*reinterpret_cast<dword *>( v[j].color ) = colors[live[i]];
+			}
+
+			idVec3 origin;
+			ParticleOrigin( g, origin );
+			ParticleTexCoords( g, v );
+
+			const float psize = size.Eval( g->frac, g->random );
+			const float paspect = aspect.Eval( g->frac, g->random );
+
+			float angle = ( initialAngle ) ? initialAngle : 360 * g->random.RandomFloat();
+			const float angleMove = rotationSpeed.Integrate( g->frac, g->random ) * particleLife;
+			// have half the particles rotate each way
+			if ( g->index & 1 ) {
+				angle += angleMove;
+			} else {
+				angle -= angleMove;
+			}
+			angle = angle / 180 * idMath::PI;
+
+			originX[i] = origin.x;
+			originY[i] = origin.y;
+			originZ[i] = origin.z;
+			cosAngle[i] = idMath::Cos16( angle );
+			sinAngle[i] = idMath::Sin16( angle );
+			width[i] = psize;
+			height[i] = psize * paspect;
+			dest[i] = v;
+
+			numVerts += vertsPerParticle;
+		}
+
+		//
+		// quad corners for four particles
+		//
+		ALIGN16( float cornerX[4][4] );
+		ALIGN16( float cornerY[4][4] );
+		ALIGN16( float cornerZ[4][4] );
+
+#ifdef ID_WIN_X86_SSE2_INTRIN
+
+		const __m128 c = _mm_load_ps( cosAngle );
+		const __m128 s = _mm_load_ps( sinAngle );
+		const __m128 w = _mm_load_ps( width );
+		const __m128 h = _mm_load_ps( height );
+
+		const __m128 ax = _mm_splat_ps( _mm_load_ss( &axisA.x ), 0 );
+		const __m128 ay = _mm_splat_ps( _mm_load_ss( &axisA.y ), 0 );
+		const __m128 az = _mm_splat_ps( _mm_load_ss( &axisA.z ), 0 );
+		const __m128 bx = _mm_splat_ps( _mm_load_ss( &axisB.x ), 0 );
+		const __m128 by = _mm_splat_ps( _mm_load_ss( &axisB.y ), 0 );
+		const __m128 bz = _mm_splat_ps( _mm_load_ss( &axisB.z ), 0 );
+
+		const __m128 leftX = _mm_mul_ps( _mm_add_ps( _mm_mul_ps( ax, c ), _mm_mul_ps( bx, s ) ), w );
+		const __m128 leftY = _mm_mul_ps( _mm_add_ps( _mm_mul_ps( ay, c ), _mm_mul_ps( by, s ) ), w );
+		const __m128 leftZ = _mm_mul_ps( _mm_add_ps( _mm_mul_ps( az, c ), _mm_mul_ps( bz, s ) ), w );
+		const __m128 upX = _mm_mul_ps( _mm_sub_ps( _mm_mul_ps( bx, c ), _mm_mul_ps( ax, s ) ), h );
+		const __m128 upY = _mm_mul_ps( _mm_sub_ps( _mm_mul_ps( by, c ), _mm_mul_ps( ay, s ) ), h );
+		const __m128 upZ = _mm_mul_ps( _mm_sub_ps( _mm_mul_ps( bz, c ), _mm_mul_ps( az, s ) ), h );
+
+		const __m128 ox = _mm_load_ps( originX );
+		const __m128 oy = _mm_load_ps( originY );
+		const __m128 oz = _mm_load_ps( originZ );
+
+		_mm_store_ps( cornerX[0], _mm_add_ps( _mm_sub_ps( ox, leftX ), upX ) );
+		_mm_store_ps( cornerY[0], _mm_add_ps( _mm_sub_ps( oy, leftY ), upY ) );
+		_mm_store_ps( cornerZ[0], _mm_add_ps( _mm_sub_ps( oz, leftZ ), upZ ) );
+		_mm_store_ps( cornerX[1], _mm_add_ps( _mm_add_ps( ox, leftX ), upX ) );
+		_mm_store_ps( cornerY[1], _mm_add_ps( _mm_add_ps( oy, leftY ), upY ) );
+		_mm_store_ps( cornerZ[1], _mm_add_ps( _mm_add_ps( oz, leftZ ), upZ ) );
+		_mm_store_ps( cornerX[2], _mm_sub_ps( _mm_sub_ps( ox, leftX ), upX ) );
+		_mm_store_ps( cornerY[2], _mm_sub_ps( _mm_sub_ps( oy, leftY ), upY ) );
+		_mm_store_ps( cornerZ[2], _mm_sub_ps( _mm_sub_ps( oz, leftZ ), upZ ) );
+		_mm_store_ps( cornerX[3], _mm_sub_ps( _mm_add_ps( ox, leftX ), upX ) );
+		_mm_store_ps( cornerY[3], _mm_sub_ps( _mm_add_ps( oy, leftY ), upY ) );
+		_mm_store_ps( cornerZ[3], _mm_sub_ps( _mm_add_ps( oz, leftZ ), upZ ) );
+
+#else
+
+		for ( int i = 0; i < numLive; i++ ) {
+			const idVec3 origin( originX[i], originY[i], originZ[i] );
+			const idVec3 left = ( axisA * cosAngle[i] + axisB * sinAngle[i] ) * width[i];
+			const idVec3 up = ( axisB * cosAngle[i] - axisA * sinAngle[i] ) * height[i];
+
+			const idVec3 corners[4] = { origin - left + up, origin + left + up, origin - left - up, origin + left - up };
+			for ( int j = 0; j < 4; j++ ) {
+				cornerX[j][i] = corners[j].x;
+				cornerY[j][i] = corners[j].y;
+				cornerZ[j][i] = corners[j].z;
+			}
+		}
+
+#endif
+
+		for ( int i = 0; i < numLive; i++ ) {
+			idDrawVert * v = dest[i];
+			for ( int j = 0; j < 4; j++ ) {
+				v[j].xyz.Set( cornerX[j][i], cornerY[j][i], cornerZ[j][i] );
+			}
+			ParticleCrossFade( &gens[base + live[i]], v, 4 );
+		}
+	}
+
+	return numVerts;
+}
+
 /*
 ==================
 idParticleStage::GetCustomPathName
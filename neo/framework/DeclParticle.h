@@ -38,6 +38,7 @@ If you have questions concerning this license or the applicable additional terms
 */
 
 static const int MAX_PARTICLE_STAGES	= 32;
+static const int MAX_PARTICLE_BATCH		= 64;		// particles handed to idParticleStage::CreateParticles at once
 
 class idParticleParm {
 public:
@@ -112,11 +113,15 @@ public:
 	int						NumQuadsPerParticle() const;	// includes trails and cross faded animations
 	// returns the number of verts created, which will range from 0 to 4*NumQuadsPerParticle()
 	int						CreateParticle( particleGen_t *g, idDrawVert *verts ) const;
+	// creates a run of particles that share a render entity and view, evaluating four at a time,
+	// returns the number of verts created, which will range from 0 to 4*NumQuadsPerParticle()*numGens
+	int						CreateParticles( particleGen_t *gens, int numGens, idDrawVert *verts ) const;
 
 	void					ParticleOrigin( particleGen_t *g, idVec3 &origin ) const;
 	int						ParticleVerts( particleGen_t *g, const idVec3 origin, idDrawVert *verts ) const;
 	void					ParticleTexCoords( particleGen_t *g, idDrawVert *verts ) const;
 	void					ParticleColors( particleGen_t *g, idDrawVert *verts ) const;
+	int						ParticleCrossFade( const particleGen_t *g, idDrawVert *verts, int numVerts ) const;
 
 	const char *			GetCustomPathName();
 	const char *			GetCustomPathDesc();
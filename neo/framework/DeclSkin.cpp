@@ -29,6 +29,8 @@ If you have questions concerning this license or the applicable additional terms
 #include "../idlib/precompiled.h"
 #pragma hdrstop
 
+static const byte BSKN_VERSION = 100;
+static const unsigned int BSKN_MAGIC = ( 'B' << 24 ) | ( 'S' << 16 ) | ( 'K' << 8 ) | BSKN_VERSION;
 
 /*
 =================
@@ -57,12 +59,23 @@ bool idDeclSkin::Parse( const char *text, const int textLength, bool allowBinary
 	idLexer src;
 	idToken	token, token2;
 
+	associatedModels.Clear();
+
+	if ( allowBinaryVersion ) {
+		idFileLocal file( declManager->ReadBinaryDecl( this ) );
+		if ( file != NULL ) {
+			if ( LoadBinary( file ) ) {
+				return false;
+			}
+			associatedModels.Clear();
+			mappings.Clear();
+		}
+	}
+
 	src.LoadMemory( text, textLength, GetFileName(), GetLineNum() );
 	src.SetFlags( DECL_LEXER_FLAGS );
 	src.SkipUntilString( "{" );
 
-	associatedModels.Clear();
-
 	while (1) {
 		if ( !src.ReadToken( &token ) ) {
 			break;
@@ -96,9 +109,70 @@ bool idDeclSkin::Parse( const char *text, const int textLength, bool allowBinary
 		mappings.Append( map );
 	}
 
+	if ( allowBinaryVersion ) {
+		WriteBinary();
+	}
+
 	return false;
 }
 
+/*
+================
+idDeclSkin::LoadBinary
+================
+*/
+bool idDeclSkin::LoadBinary( idFile *file ) {
+	unsigned int magic = 0;
+	file->ReadBig( magic );
+	if ( magic != BSKN_MAGIC ) {
+		return false;
+	}
+
+	int numModels = 0;
+	file->ReadBig( numModels );
+	for ( int i = 0; i < numModels; i++ ) {
+		file->ReadString( associatedModels.Alloc() );
+	}
+
+	int numMappings = 0;
+	file->ReadBig( numMappings );
+	mappings.SetNum( numMappings );
+
+	idStr name;
+	for ( int i = 0; i < numMappings; i++ ) {
+		file->ReadString( name );
+		mappings[i].from = name.IsEmpty() ? NULL : declManager->FindMaterial( name );
+		file->ReadString( name );
+		mappings[i].to = declManager->FindMaterial( name );
+	}
+
+	return true;
+}
+
+/*
+================
+idDeclSkin::WriteBinary
+================
+*/
+void idDeclSkin::WriteBinary() const {
+	idFile_Memory file;
+	file.WriteBig( BSKN_MAGIC );
+
+	file.WriteBig( associatedModels.Num() );
+	for ( int i = 0; i < associatedModels.Num(); i++ ) {
+		file.WriteString( associatedModels[i] );
+	}
+
+	// a NULL from material is the wildcard
+	file.WriteBig( mappings.Num() );
+	for ( int i = 0; i < mappings.Num(); i++ ) {
+		file.WriteString( mappings[i].from != NULL ? mappings[i].from->GetName() : "" );
+		file.WriteString( mappings[i].to->GetName() );
+	}
+
+	declManager->WriteBinaryDecl( this, &file );
+}
+
 /*
 ================
 idDeclSkin::SetDefaultText
@@ -56,6 +56,10 @@ public:
 	const int				GetNumModelAssociations() const;
 	const char *			GetAssociatedModel( int index ) const;
 
+private:
+	bool					LoadBinary( idFile *file );
+	void					WriteBinary() const;
+
 private:
 	idList<skinMapping_t, TAG_IDLIB_LIST_DECL>	mappings;
 	idStrList				associatedModels;
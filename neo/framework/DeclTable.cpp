@@ -29,6 +29,8 @@ If you have questions concerning this license or the applicable additional terms
 #include "../idlib/precompiled.h"
 #pragma hdrstop
 
+static const byte BTBL_VERSION = 100;
+static const unsigned int BTBL_MAGIC = ( 'B' << 24 ) | ( 'T' << 16 ) | ( 'B' << 8 ) | BTBL_VERSION;
 
 /*
 =================
@@ -114,6 +116,13 @@ bool idDeclTable::Parse( const char *text, const int textLength, bool allowBinar
 	idToken token;
 	float v;
 
+	if ( allowBinaryVersion ) {
+		idFileLocal file( declManager->ReadBinaryDecl( this ) );
+		if ( file != NULL && LoadBinary( file ) ) {
+			return true;
+		}
+	}
+
 	src.LoadMemory( text, textLength, GetFileName(), GetLineNum() );
 	src.SetFlags( DECL_LEXER_FLAGS );
 	src.SkipUntilString( "{" );
@@ -173,5 +182,49 @@ bool idDeclTable::Parse( const char *text, const int textLength, bool allowBinar
 	float val = values[0];		// template bug requires this to not be in the Append()?
 	values.Append( val );
 
+	if ( allowBinaryVersion ) {
+		WriteBinary();
+	}
+
+	return true;
+}
+
+/*
+=================
+idDeclTable::LoadBinary
+=================
+*/
+bool idDeclTable::LoadBinary( idFile *file ) {
+	unsigned int magic = 0;
+	file->ReadBig( magic );
+	if ( magic != BTBL_MAGIC ) {
+		return false;
+	}
+
+	int numValues = 0;
+	file->ReadBig( snap );
+	file->ReadBig( clamp );
+	file->ReadBig( numValues );
+	if ( numValues <= 0 ) {
+		return false;
+	}
+
+	values.SetNum( numValues );
+	file->ReadBigArray( values.Ptr(), numValues );
 	return true;
 }
+
+/*
+=================
+idDeclTable::WriteBinary
+=================
+*/
+void idDeclTable::WriteBinary() const {
+	idFile_Memory file;
+	file.WriteBig( BTBL_MAGIC );
+	file.WriteBig( snap );
+	file.WriteBig( clamp );
+	file.WriteBig( values.Num() );
+	file.WriteBigArray( values.Ptr(), values.Num() );
+	declManager->WriteBinaryDecl( this, &file );
+}
@@ -47,6 +47,10 @@ public:
 
 	float					TableLookup( float index ) const;
 
+private:
+	bool					LoadBinary( idFile *file );
+	void					WriteBinary() const;
+
 private:
 	bool					clamp;
 	bool					snap;
@@ -124,6 +124,68 @@ struct searchpath_t {
 #define FSFLAG_SEARCH_DIRS		( 1 << 0 )
 #define FSFLAG_RETURN_FILE_MEM	( 1 << 1 )
 
+/*
+
+Asynchronous reads
+
+The I/O threads are worker threads that serve the queued read requests until the queues are
+empty. Loose files are opened when a request is queued, since finding them walks the search
+paths, and resource containers are read through handles each I/O thread keeps for itself, so
+a file handle is never used by two threads at once.
+
+Resource preloading
+
+The subsystems that load a level's resources from its preload manifest hand the generated
+file names to StartPreload before they start loading. The entries are queued as asynchronous
+reads in container order, so the I/O threads read and decode them while the main thread
+parses the data that is already there. An entry that is opened before it was read is moved
+to the front of the queue and waited for. Only fs_preloadMemory worth of entries is queued or
+waiting to be opened at a time, the next ones are queued as the loader takes the data.
+
+*/
+
+static const int MAX_FILE_READ_THREADS		= 4;
+
+class idFileSystemLocal;
+
+class idFileReadThread : public idSysThread {
+public:
+							idFileReadThread() : owner( NULL ), containerGeneration( 0 ) {}
+	virtual					~idFileReadThread() { CloseContainers(); }
+
+	virtual int				Run();
+
+	idFile *				GetContainer( const char *path );
+	void					CloseContainers();
+
+	idFileSystemLocal *		owner;
+	int						containerGeneration;	// containers are closed when the file system's generation changes
+
+private:
+	idStrList				containerPaths;
+	idList< idFile * >		containerFiles;
+};
+
+// I/O trace of a single request, only recorded with fs_ioTrace
+struct fileReadTrace_t {
+	idStr					fileName;
+	int						priority;
+	int						bytes;
+	int						queueDepth;
+	uint64					latency;				// from queueing to finishing
+	uint64					ioMicroseconds;
+};
+
+class idSort_ResourcePreload : public idSort_Quick< idResourceCacheEntry, idSort_ResourcePreload > {
+public:
+	int Compare( const idResourceCacheEntry & a, const idResourceCacheEntry & b ) const {
+		if ( a.containerIndex != b.containerIndex ) {
+			return a.containerIndex - b.containerIndex;
+		}
+		return a.offset - b.offset;
+	}
+};
+
 class idFileSystemLocal : public idFileSystem {
 public:
 							idFileSystemLocal();
@@ -179,6 +241,15 @@ public:
 
 	virtual void			StartPreload( const idStrList &_preload );
 	virtual void			StopPreload();
+	byte *					TakePreloadedResource( const idResourceCacheEntry &rc );
+	void					QueuePreloads();
+	virtual bool			ReadFileAsync( fileReadRequest_t * request );
+	virtual bool			CancelRead( fileReadRequest_t * request );
+	virtual bool			WaitForRead( fileReadRequest_t * request );
+	virtual void			WaitForAllReads();
+	fileReadRequest_t *		NextReadRequest();
+	void					ServeReadRequest( idFileReadThread * thread, fileReadRequest_t * request );
+	int						GetContainerGeneration() const { return containerGeneration.GetValue(); }
 	idFile *				GetResourceFile( const char *fileName, bool memFile );
 	bool					GetResourceCacheEntry( const char *fileName, idResourceCacheEntry &rc );
 	virtual int				ReadFromBGL( idFile *_resourceFile, void * _buffer, int _offset, int _len );
@@ -232,6 +303,10 @@ private:
 	static idCVar			fs_game_base;
 	static idCVar			fs_enableBGL;
 	static idCVar			fs_debugBGL;
+	static idCVar			fs_preload;
+	static idCVar			fs_preloadMemory;
+	static idCVar			fs_ioThreads;
+	static idCVar			fs_ioTrace;
 
 	idStr					manifestName;
 	idStrList				fileManifest;
@@ -243,6 +318,43 @@ private:
 	int		resourceBufferAvailable;
 	int		numFilesOpenedAsCached;
 
+	// asynchronous reads
+	idSysMutex							readMutex;
+	idList< fileReadRequest_t * >		readQueue[ FILE_READ_PRIORITY_MAX ];
+	int									readQueueHead[ FILE_READ_PRIORITY_MAX ];	// requests before this have been handed out
+	idFileReadThread					readThreads[ MAX_FILE_READ_THREADS ];
+	idFileReadThread					syncReadThread;		// serves requests on the calling thread when there are no I/O threads
+	int									numReadThreads;
+	int									numReadsBusy;
+	idSysInterlockedInteger				containerGeneration;
+
+	// I/O trace, reset by BeginLevelLoad and printed by EndLevelLoad
+	int									numAsyncReads;
+	int									numAsyncCancelled;
+	int									maxReadQueueDepth;
+	int64								readQueueDepthSum;
+	int64								asyncBytesRead;		// bytes read from disk
+	uint64								asyncReadMicroseconds;
+	uint64								asyncLatencyMicroseconds;
+	idList< fileReadTrace_t >			readTrace;
+
+	idList< fileReadRequest_t, TAG_RESOURCE >	preloadRequests;
+	idList< idResourceCacheEntry >		preloadEntries;		// the entry of each request, in request order
+	idHashIndex							preloadHash;
+	int									numPreloadsQueued;	// requests before this one have been queued
+	int64								preloadBytesInFlight;	// queued and read but not taken yet
+
+	// level load statistics, reset by BeginLevelLoad and printed by EndLevelLoad
+	int		numResourceReads;			// files opened from the resource containers
+	int		numPreloadReady;			// reads that found their data prepared by a job
+	int		numPreloadWaited;			// reads that had to wait for a running job
+	int		numPreloadBoosted;			// reads that moved their request to the front of the queue
+	int		numPreloadUnused;			// preloaded entries that were never read
+	int64	resourceDiskBytes;			// bytes read from the containers, streamed entries count in full
+	int64	resourceDataBytes;			// uncompressed bytes of the files opened
+	uint64	resourceReadMicroseconds;	// main thread time spent reading, decoding and waiting
+	uint64	preloadMicroseconds;		// I/O thread time spent reading and decoding
+
 private:
 
 	// .resource file creation
@@ -270,6 +382,12 @@ private:
 	void					RemoveResourceFile( const char * resourceFileName );
 	int						FindResourceFile( const char * resourceFileName );
 
+	void					StartReadThreads();
+	void					StopReadThreads();
+	int						ReadQueueDepth() const;
+	void					FinishReadRequest( fileReadRequest_t * request, bool ok );
+	void					PrintReadTrace();
+
 	void					SetupGameDirectories( const char *gameName );
 	void					Startup();
 	void					InitPrecache();
@@ -280,6 +398,10 @@ idCVar	idFileSystemLocal::fs_debug( "fs_debug", "0", CVAR_SYSTEM | CVAR_INTEGER,
 idCVar	idFileSystemLocal::fs_debugResources( "fs_debugResources", "0", CVAR_SYSTEM | CVAR_BOOL, "" );
 idCVar	idFileSystemLocal::fs_enableBGL( "fs_enableBGL", "0", CVAR_SYSTEM | CVAR_BOOL, "" );
 idCVar	idFileSystemLocal::fs_debugBGL( "fs_debugBGL", "0", CVAR_SYSTEM | CVAR_BOOL, "" );
+idCVar	idFileSystemLocal::fs_preload( "fs_preload", "1", CVAR_SYSTEM | CVAR_BOOL, "read and decode the resources in a level's preload manifest on job threads" );
+idCVar	idFileSystemLocal::fs_preloadMemory( "fs_preloadMemory", "128", CVAR_SYSTEM | CVAR_INTEGER, "megabytes of resource data that can be preloaded and not taken by the loader yet at a time" );
+idCVar	idFileSystemLocal::fs_ioThreads( "fs_ioThreads", "1", CVAR_SYSTEM | CVAR_INIT | CVAR_INTEGER, "number of threads serving asynchronous reads, 0 = serve them on the calling thread", 0, MAX_FILE_READ_THREADS );
+idCVar	idFileSystemLocal::fs_ioTrace( "fs_ioTrace", "0", CVAR_SYSTEM | CVAR_BOOL, "print every asynchronous read of a level load at the end of the load" );
 idCVar	idFileSystemLocal::fs_copyfiles( "fs_copyfiles", "0", CVAR_SYSTEM | CVAR_INIT | CVAR_BOOL, "Copy every file touched to fs_savepath" );
 idCVar	idFileSystemLocal::fs_buildResources( "fs_buildresources", "0", CVAR_SYSTEM | CVAR_BOOL | CVAR_INIT, "Copy every file touched to a resource file" );
 idCVar	idFileSystemLocal::fs_game( "fs_game", "", CVAR_SYSTEM | CVAR_INIT | CVAR_SERVERINFO, "mod path" );
@@ -305,20 +427,556 @@ int idFileSystemLocal::ReadFromBGL( idFile *_resourceFile, void * _buffer, int _
 	return _resourceFile->Read( _buffer, _len );
 }
 
+/*
+================
+idFileReadThread::GetContainer
+================
+*/
+idFile * idFileReadThread::GetContainer( const char *path ) {
+	if ( containerGeneration != owner->GetContainerGeneration() ) {
+		CloseContainers();
+		containerGeneration = owner->GetContainerGeneration();
+	}
+	for ( int i = 0; i < containerPaths.Num(); i++ ) {
+		if ( containerPaths[i].Icmp( path ) == 0 ) {
+			return containerFiles[i];
+		}
+	}
+	idFile * file = owner->OpenExplicitFileRead( path );
+	if ( file != NULL ) {
+		containerPaths.Append( path );
+		containerFiles.Append( file );
+	}
+	return file;
+}
+
+/*
+================
+idFileReadThread::CloseContainers
+================
+*/
+void idFileReadThread::CloseContainers() {
+	containerFiles.DeleteContents();
+	containerPaths.Clear();
+}
+
+/*
+================
+idFileReadThread::Run
+================
+*/
+int idFileReadThread::Run() {
+	for ( fileReadRequest_t * request = owner->NextReadRequest(); request != NULL; request = owner->NextReadRequest() ) {
+		owner->ServeReadRequest( this, request );
+	}
+	return 0;
+}
+
+/*
+================
+idFileSystemLocal::StartReadThreads
+================
+*/
+void idFileSystemLocal::StartReadThreads() {
+	syncReadThread.owner = this;
+	numReadThreads = fs_ioThreads.GetInteger();
+	for ( int i = 0; i < numReadThreads; i++ ) {
+		readThreads[i].owner = this;
+		readThreads[i].StartWorkerThread( va( "FileRead%d", i ), CORE_ANY, THREAD_NORMAL );
+	}
+}
+
+/*
+================
+idFileSystemLocal::StopReadThreads
+================
+*/
+void idFileSystemLocal::StopReadThreads() {
+	WaitForAllReads();
+	for ( int i = 0; i < numReadThreads; i++ ) {
+		readThreads[i].StopThread();
+		readThreads[i].CloseContainers();
+	}
+	numReadThreads = 0;
+	syncReadThread.CloseContainers();
+}
+
+/*
+================
+idFileSystemLocal::ReadQueueDepth
+
+Number of requests that are queued or being served, readMutex must be locked.
+================
+*/
+int idFileSystemLocal::ReadQueueDepth() const {
+	int depth = numReadsBusy;
+	for ( int i = 0; i < FILE_READ_PRIORITY_MAX; i++ ) {
+		depth += readQueue[i].Num() - readQueueHead[i];
+	}
+	return depth;
+}
+
+/*
+================
+idFileSystemLocal::ReadFileAsync
+================
+*/
+bool idFileSystemLocal::ReadFileAsync( fileReadRequest_t * request ) {
+	request->data = NULL;
+	request->bytesRead = 0;
+	request->file = NULL;
+	request->inResource = false;
+	request->containerPath.Empty();
+	request->ioMicroseconds = 0;
+	request->priority = ( fileReadPriority_t )idMath::ClampInt( FILE_READ_PRIORITY_LOW, FILE_READ_PRIORITY_HIGH, request->priority );
+
+	int fileLength = 0;
+	if ( resourceFiles.Num() > 0 && GetResourceCacheEntry( request->fileName, request->resource ) ) {
+		request->inResource = true;
+		fileLength = request->resource.length;
+
+		// memory containers get their own view of the data, the others are opened by the I/O threads
+		idFile * container = resourceFiles[ request->resource.containerIndex ]->resourceFile;
+		idFile_Memory * memContainer = dynamic_cast< idFile_Memory * >( container );
+		if ( memContainer != NULL ) {
+			request->file = new idFile_Memory( container->GetName(), ( const char * )memContainer->GetDataPtr(), memContainer->Length() );
+		} else {
+			request->containerPath = container->GetFullPath();
+		}
+	} else {
+		request->file = OpenFileReadFlags( request->fileName, FSFLAG_SEARCH_DIRS, false );
+		if ( request->file == NULL ) {
+			request->status.SetValue( FILE_READ_FAILED );
+			return false;
+		}
+		fileLength = request->file->Length();
+	}
+
+	if ( request->offset < 0 || request->offset > fileLength ) {
+		delete request->file;
+		request->file = NULL;
+		request->status.SetValue( FILE_READ_FAILED );
+		return false;
+	}
+	if ( request->length < 0 || request->offset + request->length > fileLength ) {
+		request->length = fileLength - request->offset;
+	}
+	request->data = ( request->buffer != NULL ) ? request->buffer : ( byte * )Mem_Alloc( Max( request->length, 1 ), TAG_RESOURCE );
+	request->queueTime = Sys_Microseconds();
+
+	readMutex.Lock();
+	request->status.SetValue( FILE_READ_QUEUED );
+	readQueue[ request->priority ].Append( request );
+	numAsyncReads++;
+	const int depth = ReadQueueDepth();
+	readQueueDepthSum += depth;
+	maxReadQueueDepth = Max( maxReadQueueDepth, depth );
+	readMutex.Unlock();
+
+	if ( numReadThreads == 0 ) {
+		fileReadRequest_t * next = NextReadRequest();
+		if ( next != NULL ) {
+			ServeReadRequest( &syncReadThread, next );
+		}
+		return true;
+	}
+	for ( int i = 0; i < numReadThreads; i++ ) {
+		readThreads[i].SignalWork();
+	}
+	return true;
+}
+
+/*
+================
+idFileSystemLocal::NextReadRequest
+
+Hands the oldest request of the highest priority to an I/O thread.
+================
+*/
+fileReadRequest_t * idFileSystemLocal::NextReadRequest() {
+	idScopedCriticalSection lock( readMutex );
+	for ( int i = FILE_READ_PRIORITY_MAX - 1; i >= 0; i-- ) {
+		if ( readQueueHead[i] < readQueue[i].Num() ) {
+			fileReadRequest_t * request = readQueue[i][ readQueueHead[i]++ ];
+			if ( readQueueHead[i] == readQueue[i].Num() ) {
+				readQueue[i].SetNum( 0 );
+				readQueueHead[i] = 0;
+			}
+			request->status.SetValue( FILE_READ_BUSY );
+			numReadsBusy++;
+			return request;
+		}
+	}
+	return NULL;
+}
+
+/*
+================
+idFileSystemLocal::ServeReadRequest
+
+Called from an I/O thread.
+================
+*/
+void idFileSystemLocal::ServeReadRequest( idFileReadThread * thread, fileReadRequest_t * request ) {
+	const uint64 start = Sys_Microseconds();
+
+	bool ok = false;
+	if ( request->inResource ) {
+		const idResourceCacheEntry & rc = request->resource;
+		idFile * container = ( request->file != NULL ) ? request->file : thread->GetContainer( request->containerPath );
+		if ( container == NULL ) {
+			ok = false;
+		} else if ( rc.codec == RESOURCE_CODEC_NONE ) {
+			container->Seek( rc.offset + request->offset, FS_SEEK_SET );
+			ok = ( container->Read( request->data, request->length ) == request->length );
+		} else if ( request->offset == 0 && request->length == rc.length ) {
+			ok = idResourceContainer::ReadEntryData( container, rc, request->data );
+		} else {
+			// compressed entries can only be decoded as a whole
+			byte * decoded = ( byte * )Mem_Alloc( rc.length, TAG_TEMP );
+			ok = idResourceContainer::ReadEntryData( container, rc, decoded );
+			if ( ok ) {
+				memcpy( request->data, decoded + request->offset, request->length );
+			}
+			Mem_Free( decoded );
+		}
+	} else {
+		request->file->Seek( request->offset, FS_SEEK_SET );
+		ok = ( request->file->Read( request->data, request->length ) == request->length );
+	}
+
+	delete request->file;
+	request->file = NULL;
+
+	request->ioMicroseconds = Sys_Microseconds() - start;
+	request->bytesRead = ok ? request->length : 0;
+	if ( !ok && request->buffer == NULL ) {
+		Mem_Free( request->data );
+		request->data = NULL;
+	}
+
+	if ( request->callback != NULL ) {
+		request->callback( request );
+	}
+
+	FinishReadRequest( request, ok );
+}
+
+/*
+================
+idFileSystemLocal::FinishReadRequest
+
+Updates the trace and publishes the result, the request belongs to its owner again after this.
+================
+*/
+void idFileSystemLocal::FinishReadRequest( fileReadRequest_t * request, bool ok ) {
+	idScopedCriticalSection lock( readMutex );
+
+	const bool compressed = request->inResource && request->resource.codec != RESOURCE_CODEC_NONE;
+	const int diskBytes = compressed ? request->resource.compressedLength : request->length;
+	const uint64 latency = Sys_Microseconds() - request->queueTime;
+	asyncBytesRead += diskBytes;
+	asyncReadMicroseconds += request->ioMicroseconds;
+	asyncLatencyMicroseconds += latency;
+
+	if ( fs_ioTrace.GetBool() ) {
+		fileReadTrace_t & trace = readTrace.Alloc();
+		trace.fileName = request->fileName;
+		trace.priority = request->priority;
+		trace.bytes = diskBytes;
+		trace.queueDepth = ReadQueueDepth();
+		trace.latency = latency;
+		trace.ioMicroseconds = request->ioMicroseconds;
+	}
+
+	numReadsBusy--;
+	request->status.SetValue( ok ? FILE_READ_DONE : FILE_READ_FAILED );
+}
+
+/*
+================
+idFileSystemLocal::CancelRead
+================
+*/
+bool idFileSystemLocal::CancelRead( fileReadRequest_t * request ) {
+	{
+		idScopedCriticalSection lock( readMutex );
+		if ( request->status.GetValue() != FILE_READ_QUEUED ) {
+			return false;
+		}
+		idList< fileReadRequest_t * > & queue = readQueue[ request->priority ];
+		const int index = queue.FindIndex( request );
+		assert( index >= readQueueHead[ request->priority ] );
+		queue.RemoveIndex( index );
+		request->status.SetValue( FILE_READ_CANCELLED );
+		numAsyncCancelled++;
+	}
+
+	delete request->file;
+	request->file = NULL;
+	if ( request->buffer == NULL ) {
+		Mem_Free( request->data );
+	}
+	request->data = NULL;
+	return true;
+}
+
+/*
+================
+idFileSystemLocal::WaitForRead
+================
+*/
+bool idFileSystemLocal::WaitForRead( fileReadRequest_t * request ) {
+	readMutex.Lock();
+	if ( request->status.GetValue() == FILE_READ_QUEUED && request->priority != FILE_READ_PRIORITY_HIGH ) {
+		// someone is waiting for it now, so it goes next
+		idList< fileReadRequest_t * > & queue = readQueue[ request->priority ];
+		queue.RemoveIndex( queue.FindIndex( request ) );
+		request->priority = FILE_READ_PRIORITY_HIGH;
+		readQueue[ FILE_READ_PRIORITY_HIGH ].Insert( request, readQueueHead[ FILE_READ_PRIORITY_HIGH ] );
+	}
+	readMutex.Unlock();
+
+	if ( numReadThreads == 0 ) {
+		for ( fileReadRequest_t * next = NextReadRequest(); next != NULL; next = NextReadRequest() ) {
+			ServeReadRequest( &syncReadThread, next );
+		}
+	}
+
+	while ( request->status.GetValue() == FILE_READ_QUEUED || request->status.GetValue() == FILE_READ_BUSY ) {
+		Sys_Yield();
+	}
+	return ( request->status.GetValue() == FILE_READ_DONE );
+}
+
+/*
+================
+idFileSystemLocal::WaitForAllReads
+================
+*/
+void idFileSystemLocal::WaitForAllReads() {
+	for ( ; ; ) {
+		readMutex.Lock();
+		const int depth = ReadQueueDepth();
+		readMutex.Unlock();
+		if ( depth == 0 ) {
+			break;
+		}
+		if ( numReadThreads == 0 ) {
+			for ( fileReadRequest_t * next = NextReadRequest(); next != NULL; next = NextReadRequest() ) {
+				ServeReadRequest( &syncReadThread, next );
+			}
+		}
+		Sys_Yield();
+	}
+}
+
+/*
+================
+idFileSystemLocal::PrintReadTrace
+================
+*/
+void idFileSystemLocal::PrintReadTrace() {
+	if ( numAsyncReads == 0 ) {
+		return;
+	}
+
+	idScopedCriticalSection lock( readMutex );
+	for ( int i = 0; i < readTrace.Num(); i++ ) {
+		const fileReadTrace_t & trace = readTrace[i];
+		common->Printf( "%d %8d bytes, depth %3d, %7.2f ms latency, %6.2f ms io: %s\n", trace.priority, trace.bytes, trace.queueDepth,
+			trace.latency * 0.001, trace.ioMicroseconds * 0.001, trace.fileName.c_str() );
+	}
+	readTrace.Clear();
+
+	const int numServed = numAsyncReads - numAsyncCancelled;
+	const double megabytesPerSecond = ( asyncReadMicroseconds > 0 ) ? asyncBytesRead / (double)asyncReadMicroseconds : 0.0;
+	common->Printf( "%5i async reads, %d cancelled, %lld bytes in %5.1f ms of io ( %5.1f MB/s ), %5.2f ms average latency\n",
+		numAsyncReads, numAsyncCancelled, asyncBytesRead, asyncReadMicroseconds * 0.001, megabytesPerSecond,
+		( numServed > 0 ) ? asyncLatencyMicroseconds * 0.001 / numServed : 0.0 );
+	common->Printf( "      queue depth %5.1f average, %d max\n", readQueueDepthSum / (double)numAsyncReads, maxReadQueueDepth );
+}
+
 /*
 ================
 idFileSystemLocal::StartPreload
+
+Prepares read requests for the resource files in the list and queues them in container order,
+as many as fs_preloadMemory allows. Any preload that is still running is stopped first.
 ================
 */
 void idFileSystemLocal::StartPreload( const idStrList & _preload ) {
+	StopPreload();
+
+	if ( !fs_preload.GetBool() || resourceFiles.Num() == 0 || _preload.Num() == 0 ) {
+		return;
+	}
+
+	int64 totalBytes = 0;
+
+	preloadEntries.Resize( _preload.Num() );
+	preloadHash.Clear( 4096, _preload.Num() );
+	for ( int i = 0; i < _preload.Num(); i++ ) {
+		idResourceCacheEntry rc;
+		if ( !GetResourceCacheEntry( _preload[i], rc ) || rc.length == 0 ) {
+			continue;
+		}
+		const int key = preloadHash.GenerateKey( rc.filename, false );
+		bool found = false;
+		for ( int j = preloadHash.First( key ); j != idHashIndex::NULL_INDEX; j = preloadHash.Next( j ) ) {
+			if ( preloadEntries[j].containerIndex == rc.containerIndex && preloadEntries[j].offset == rc.offset ) {
+				found = true;
+				break;
+			}
+		}
+		if ( found ) {
+			continue;
+		}
+		preloadHash.Add( key, preloadEntries.Append( rc ) );
+		totalBytes += rc.length;
+	}
+
+	if ( preloadEntries.Num() == 0 ) {
+		return;
+	}
+
+	// read each container front to back
+	preloadEntries.SortWithTemplate( idSort_ResourcePreload() );
+
+	// the requests can't move once they are queued
+	preloadRequests.SetNum( preloadEntries.Num() );
+	preloadHash.Clear();
+	for ( int i = 0; i < preloadEntries.Num(); i++ ) {
+		fileReadRequest_t & request = preloadRequests[i];
+		request.Clear();
+		request.fileName = preloadEntries[i].filename;
+		request.priority = FILE_READ_PRIORITY_NORMAL;
+		preloadHash.Add( preloadHash.GenerateKey( request.fileName, false ), i );
+	}
+
+	QueuePreloads();
+
+	if ( fs_debugResources.GetBool() ) {
+		idLib::Printf( "RES: preloading %d files, %lld bytes, %d files queued\n", preloadEntries.Num(), totalBytes, numPreloadsQueued );
+	}
+}
+
+/*
+================
+idFileSystemLocal::QueuePreloads
+
+Queues the next preload requests until the data that is queued or read but not taken yet
+reaches fs_preloadMemory. The next request is always queued when nothing is in flight, so an
+entry larger than the budget is still preloaded on its own.
+================
+*/
+void idFileSystemLocal::QueuePreloads() {
+	const int64 memoryBudget = (int64)fs_preloadMemory.GetInteger() * 1024 * 1024;
+
+	for ( ; numPreloadsQueued < preloadRequests.Num(); numPreloadsQueued++ ) {
+		fileReadRequest_t & request = preloadRequests[ numPreloadsQueued ];
+
+		// already taken by the loader, which read it itself
+		if ( request.status.GetValue() == FILE_READ_CANCELLED ) {
+			continue;
+		}
+
+		const int length = preloadEntries[ numPreloadsQueued ].length;
+		if ( preloadBytesInFlight > 0 && preloadBytesInFlight + length > memoryBudget ) {
+			break;
+		}
+		if ( !ReadFileAsync( &request ) ) {
+			request.status.SetValue( FILE_READ_CANCELLED );
+			continue;
+		}
+		preloadBytesInFlight += length;
+	}
 }
 
 /*
 ================
 idFileSystemLocal::StopPreload
+
+Cancels the preloads that haven't been read yet and releases all preloaded data that wasn't used.
 ================
 */
 void idFileSystemLocal::StopPreload() {
+	for ( int i = 0; i < numPreloadsQueued; i++ ) {
+		fileReadRequest_t & request = preloadRequests[i];
+		if ( CancelRead( &request ) ) {
+			continue;
+		}
+		if ( WaitForRead( &request ) ) {
+			numPreloadUnused++;
+			resourceDiskBytes += request.resource.StoredLength();
+			preloadMicroseconds += request.ioMicroseconds;
+			Mem_Free( request.data );
+			request.data = NULL;
+		}
+	}
+	preloadRequests.Clear();
+	preloadEntries.Clear();
+	preloadHash.Clear();
+	numPreloadsQueued = 0;
+	preloadBytesInFlight = 0;
+}
+
+/*
+================
+idFileSystemLocal::TakePreloadedResource
+
+Returns the data an I/O thread read for the entry, waiting for it if needed, or NULL if the
+entry has to be read by the caller. Taking the data frees its share of fs_preloadMemory for
+the next requests.
+================
+*/
+byte * idFileSystemLocal::TakePreloadedResource( const idResourceCacheEntry &rc ) {
+	if ( preloadRequests.Num() == 0 ) {
+		return NULL;
+	}
+
+	const int key = preloadHash.GenerateKey( rc.filename, false );
+	for ( int i = preloadHash.First( key ); i != idHashIndex::NULL_INDEX; i = preloadHash.Next( i ) ) {
+		if ( preloadEntries[i].containerIndex != rc.containerIndex || preloadEntries[i].offset != rc.offset ) {
+			continue;
+		}
+		fileReadRequest_t & request = preloadRequests[i];
+
+		// taken requests are marked cancelled
+		const int previousStatus = request.status.GetValue();
+		if ( previousStatus == FILE_READ_CANCELLED ) {
+			return NULL;
+		}
+
+		// not queued yet, the caller reads it and the preload skips it
+		if ( i >= numPreloadsQueued ) {
+			request.status.SetValue( FILE_READ_CANCELLED );
+			return NULL;
+		}
+
+		if ( previousStatus == FILE_READ_QUEUED ) {
+			numPreloadBoosted++;
+		} else if ( previousStatus == FILE_READ_BUSY ) {
+			numPreloadWaited++;
+		} else {
+			numPreloadReady++;
+		}
+
+		const bool read = WaitForRead( &request );
+		byte * data = request.data;
+		request.data = NULL;
+		request.status.SetValue( FILE_READ_CANCELLED );
+		preloadBytesInFlight -= preloadEntries[i].length;
+		QueuePreloads();
+
+		if ( !read ) {
+			return NULL;
+		}
+		resourceDiskBytes += request.resource.StoredLength();
+		preloadMicroseconds += request.ioMicroseconds;
+		return data;
+	}
+	return NULL;
 }
 
 /*
@@ -333,6 +991,29 @@ idFileSystemLocal::idFileSystemLocal() {
 	resourceBufferSize = 0;
 	resourceBufferAvailable = 0;
 	numFilesOpenedAsCached = 0;
+	for ( int i = 0; i < FILE_READ_PRIORITY_MAX; i++ ) {
+		readQueueHead[i] = 0;
+	}
+	numReadThreads = 0;
+	numReadsBusy = 0;
+	numAsyncReads = 0;
+	numAsyncCancelled = 0;
+	maxReadQueueDepth = 0;
+	readQueueDepthSum = 0;
+	asyncBytesRead = 0;
+	asyncReadMicroseconds = 0;
+	asyncLatencyMicroseconds = 0;
+	numResourceReads = 0;
+	numPreloadReady = 0;
+	numPreloadWaited = 0;
+	numPreloadBoosted = 0;
+	numPreloadUnused = 0;
+	numPreloadsQueued = 0;
+	preloadBytesInFlight = 0;
+	resourceDiskBytes = 0;
+	resourceDataBytes = 0;
+	resourceReadMicroseconds = 0;
+	preloadMicroseconds = 0;
 }
 
 /*
@@ -517,10 +1198,34 @@ void idFileSystemLocal::BeginLevelLoad( const char *name, char *_blockBuffer, in
 		return;
 	}
 
+	StopPreload();
+	WaitForAllReads();
+
 	resourceBufferPtr = ( byte* )_blockBuffer;
 	resourceBufferAvailable = _blockBufferSize;
 	resourceBufferSize = _blockBufferSize;
 
+	numResourceReads = 0;
+	numPreloadReady = 0;
+	numPreloadWaited = 0;
+	numPreloadBoosted = 0;
+	numPreloadUnused = 0;
+	resourceDiskBytes = 0;
+	resourceDataBytes = 0;
+	resourceReadMicroseconds = 0;
+	preloadMicroseconds = 0;
+
+	readMutex.Lock();
+	numAsyncReads = 0;
+	numAsyncCancelled = 0;
+	maxReadQueueDepth = 0;
+	readQueueDepthSum = 0;
+	asyncBytesRead = 0;
+	asyncReadMicroseconds = 0;
+	asyncLatencyMicroseconds = 0;
+	readTrace.Clear();
+	readMutex.Unlock();
+
 	manifestName = name;
 
 	fileManifest.Clear();
@@ -600,6 +1305,16 @@ void idFileSystemLocal::EndLevelLoad() {
 		fs_copyfiles.SetInteger( saveCopyFiles );
 	}
 
+	StopPreload();
+
+	if ( numResourceReads > 0 ) {
+		common->Printf( "%5i resource files read, %lld bytes from disk for %lld bytes of data in %5.1f ms\n",
+			numResourceReads, resourceDiskBytes, resourceDataBytes, resourceReadMicroseconds * 0.001 );
+		common->Printf( "%5i preloaded, %d waited for, %d moved to the front of the queue, %d unused, %5.1f ms of io time\n",
+			numPreloadReady + numPreloadWaited + numPreloadBoosted, numPreloadWaited, numPreloadBoosted, numPreloadUnused, preloadMicroseconds * 0.001 );
+	}
+	PrintReadTrace();
+
 	EnableBackgroundCache( true );
 
 	resourceBufferPtr = NULL;
@@ -2298,7 +3013,7 @@ void idFileSystemLocal::CreateCRCsForResourceFileList( const idFileList & list )
 		uint32 resourceMagic;
 		currentFile->ReadBig( resourceMagic );
 
-		if ( resourceMagic != RESOURCE_FILE_MAGIC ) {
+		if ( resourceMagic != RESOURCE_FILE_MAGIC && resourceMagic != RESOURCE_FILE_COMPRESSED_MAGIC ) {
 			idLib::Printf( "Resource file magic number doesn't match, skipping %s.\n", list.GetFile( fileIndex ) );
 			continue;
 		}
@@ -2319,15 +3034,15 @@ void idFileSystemLocal::CreateCRCsForResourceFileList( const idFileList & list )
 		cacheEntries.SetNum( numFileResources );
 
 		for ( int innerFileIndex = 0; innerFileIndex < numFileResources; ++innerFileIndex ) {
-			cacheEntries[innerFileIndex].Read( currentFile.get() );
+			cacheEntries[innerFileIndex].Read( currentFile.get(), resourceMagic == RESOURCE_FILE_COMPRESSED_MAGIC );
 		}
 
-		// All tables read, now seek to each one and calculate the CRC.
+		// All tables read, now seek to each one and calculate the CRC of the data as it is stored.
 		idTempArray< unsigned long > innerFileCRCs( numFileResources );
 		for ( int innerFileIndex = 0; innerFileIndex < numFileResources; ++innerFileIndex ) {
 			const char * innerFileDataBegin = currentFile->GetDataPtr() + cacheEntries[innerFileIndex].offset;
 
-			innerFileCRCs[innerFileIndex] = CRC32_BlockChecksum( innerFileDataBegin, cacheEntries[innerFileIndex].length );
+			innerFileCRCs[innerFileIndex] = CRC32_BlockChecksum( innerFileDataBegin, cacheEntries[innerFileIndex].StoredLength() );
 		}
 
 		// Get the CRC for all the CRCs.
@@ -2388,6 +3103,10 @@ idFileSystemLocal::RemoveResourceFileByIndex
 */
 void idFileSystemLocal::RemoveResourceFileByIndex( const int &idx ) {
 	if ( idx >= 0 && idx < resourceFiles.Num() ) {
+		// the preloaded entries refer to containers by index, and the I/O threads have it open
+		StopPreload();
+		WaitForAllReads();
+		containerGeneration.Increment();
 		if ( idx >= 0 && idx < resourceFiles.Num() ) {
 			delete resourceFiles[ idx ];
 			resourceFiles.RemoveIndex( idx );
@@ -2576,6 +3295,8 @@ void idFileSystemLocal::Startup() {
 
 	cmdSystem->AddCommand( "generateResourceCRCs", GenerateResourceCRCs_f, CMD_FL_SYSTEM, "Generates CRC checksums for all the resource files." );
 
+	StartReadThreads();
+
 	// print the current search paths
 	Path_f( idCmdArgs() );
 
@@ -2651,6 +3372,8 @@ void idFileSystemLocal::Shutdown( bool reloading ) {
 	gameFolder.Clear();
 	searchPaths.Clear();
 
+	StopPreload();
+	StopReadThreads();
 	resourceFiles.DeleteContents();
 
 
@@ -2705,6 +3428,8 @@ bool idFileSystemLocal::GetResourceCacheEntry( const char *fileName, idResourceC
 			if ( idStr::Icmp( rt.filename, canonical ) == 0 ) {
 				rc.filename = rt.filename;
 				rc.length = rt.length;
+				rc.compressedLength = rt.compressedLength;
+				rc.codec = rt.codec;
 				rc.containerIndex = idx;
 				rc.offset = rt.offset;
 				return true;
@@ -2734,8 +3459,23 @@ idFile * idFileSystemLocal::GetResourceFile( const char *fileName, bool memFile
 		if ( fs_debugResources.GetBool() ) {
 			idLib::Printf( "RES: loading file %s\n", rc.filename.c_str() );
 		}
+		const uint64 start = Sys_Microseconds();
+		numResourceReads++;
+		resourceDataBytes += rc.length;
+
+		// use the data a preload job has already read
+		byte *preloaded = TakePreloadedResource( rc );
+		if ( preloaded != NULL ) {
+			idFile_Memory *mfile = new idFile_Memory( rc.filename, ( const char * )preloaded, rc.length );
+			mfile->TakeDataOwnership();
+			resourceReadMicroseconds += Sys_Microseconds() - start;
+			return mfile;
+		}
+
+		resourceDiskBytes += rc.StoredLength();
 		idFile_InnerResource *file = new idFile_InnerResource( rc.filename, resourceFiles[ rc.containerIndex ]->resourceFile, rc.offset, rc.length );
-		if ( file != NULL && ( memFile || rc.length <= resourceBufferAvailable ) || rc.length < 8 * 1024 * 1024 ) {
+		// compressed entries can't be streamed, they are always decoded into memory
+		if ( file != NULL && ( memFile || rc.length <= resourceBufferAvailable ) || rc.length < 8 * 1024 * 1024 || rc.codec != RESOURCE_CODEC_NONE ) {
 			byte *buf = NULL;
 			if ( rc.length < resourceBufferAvailable ) {
 				buf = resourceBufferPtr;
@@ -2746,7 +3486,12 @@ idFile * idFileSystemLocal::GetResourceFile( const char *fileName, bool memFile
 }
 				buf = ( byte * )Mem_Alloc( rc.length, TAG_TEMP );
 			}
-			file->Read( (void*)buf, rc.length );
+			if ( rc.codec == RESOURCE_CODEC_NONE ) {
+				file->Read( (void*)buf, rc.length );
+			} else if ( !idResourceContainer::ReadEntryData( resourceFiles[ rc.containerIndex ]->resourceFile, rc, buf ) ) {
+				idLib::Warning( "Unable to decode resource file %s", rc.filename.c_str() );
+			}
+			resourceReadMicroseconds += Sys_Microseconds() - start;
 
 			if ( buf == resourceBufferPtr ) {
 				file->SetResourceBuffer( buf );
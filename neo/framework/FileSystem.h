@@ -79,6 +79,82 @@ private:
 	idStrList				list;
 };
 
+/*
+================================================
+Asynchronous reads
+
+Requests are queued with ReadFileAsync and served by the file system's I/O threads in
+priority order, first come first served within a priority. The request is owned by the
+caller and must stay valid until its status is no longer FILE_READ_QUEUED or FILE_READ_BUSY.
+Entries of resource containers are decoded before they are handed out.
+================================================
+*/
+
+enum fileReadPriority_t {
+	FILE_READ_PRIORITY_LOW,				// background streaming
+	FILE_READ_PRIORITY_NORMAL,			// level load
+	FILE_READ_PRIORITY_HIGH,			// something is waiting for the data
+	FILE_READ_PRIORITY_MAX
+};
+
+enum fileReadStatus_t {
+	FILE_READ_QUEUED,
+	FILE_READ_BUSY,
+	FILE_READ_DONE,
+	FILE_READ_FAILED,
+	FILE_READ_CANCELLED
+};
+
+struct fileReadRequest_t;
+
+// called from an I/O thread when a request has been served, before its status is updated,
+// so it should be short, like kicking off the work that uses the data
+typedef void ( *fileReadCallback_t )( fileReadRequest_t * request );
+
+struct fileReadRequest_t {
+							fileReadRequest_t() { Clear(); }
+	void					Clear() {
+								fileName.Empty();
+								offset = 0;
+								length = -1;
+								buffer = NULL;
+								priority = FILE_READ_PRIORITY_NORMAL;
+								callback = NULL;
+								userData = NULL;
+								data = NULL;
+								bytesRead = 0;
+								status.SetValue( FILE_READ_DONE );
+								file = NULL;
+								inResource = false;
+								resource.Clear();
+								containerPath.Empty();
+								queueTime = 0;
+								ioMicroseconds = 0;
+							}
+
+	// set by the caller
+	idStrStatic< MAX_OSPATH >	fileName;		// relative path, found the same way as OpenFileRead
+	int						offset;				// into the file
+	int						length;				// number of bytes to read, -1 reads to the end of the file
+	byte *					buffer;				// destination, or NULL to have one allocated that the caller frees with Mem_Free
+	fileReadPriority_t		priority;
+	fileReadCallback_t		callback;			// may be NULL
+	void *					userData;
+
+	// set by the file system
+	byte *					data;				// buffer or the allocated one
+	int						bytesRead;
+	idSysInterlockedInteger	status;				// fileReadStatus_t
+
+	// used by the I/O threads
+	idFile *				file;				// loose file or memory container opened when the request was queued
+	bool					inResource;
+	idResourceCacheEntry	resource;
+	idStrStatic< MAX_OSPATH >	containerPath;	// resource container read through the I/O thread's own handle
+	uint64					queueTime;
+	uint64					ioMicroseconds;		// time the I/O thread spent on the request
+};
+
 class idFileSystem {
 public:
 	virtual					~idFileSystem() {}
@@ -187,6 +263,16 @@ public:
 	virtual void			UnloadResourceContainer( const char *name ) = 0;
 	virtual void			StartPreload( const idStrList &_preload ) = 0;
 	virtual void			StopPreload() = 0;
+							// Queues an asynchronous read, returns false if the file can't be found.
+							// Should be called from the main thread, since it looks the file up.
+	virtual bool			ReadFileAsync( fileReadRequest_t * request ) = 0;
+							// Removes a queued request, returns false if it is already being served or finished.
+	virtual bool			CancelRead( fileReadRequest_t * request ) = 0;
+							// Moves a queued request to the front and waits for it, returns true if the data was read.
+							// Can be called from jobs to wait for the data they work on.
+	virtual bool			WaitForRead( fileReadRequest_t * request ) = 0;
+							// Waits until all queued requests have been served.
+	virtual void			WaitForAllReads() = 0;
 	virtual int				ReadFromBGL( idFile *_resourceFile, void * _buffer, int _offset, int _len ) = 0;
 	virtual bool			IsBinaryModel( const idStr & resName ) const = 0;
 	virtual bool			IsSoundSample( const idStr & resName ) const = 0;
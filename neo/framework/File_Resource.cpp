@@ -37,6 +37,157 @@ idResourceContainer
 ================================================================================================
 */
 
+idCVar fs_resourceCompression( "fs_resourceCompression", "1", CVAR_SYSTEM | CVAR_BOOL, "write .resources files with per entry compression" );
+
+// raw deflate with no header / checksum, the table already has the lengths
+static const int RESOURCE_ZLIB_WINDOW_BITS = -15;
+
+/*
+========================
+ResourceZlibAlloc
+========================
+*/
+static void * ResourceZlibAlloc( void *opaque, uInt items, uInt size ) {
+	return Mem_Alloc( items * size, TAG_RESOURCE );
+}
+
+/*
+========================
+ResourceZlibFree
+========================
+*/
+static void ResourceZlibFree( void *opaque, void * address ) {
+	Mem_Free( address );
+}
+
+/*
+========================
+idResourceContainer::CodecForFile
+
+Data that is already compressed is stored as is, everything else is deflated.
+========================
+*/
+resourceCodec_t idResourceContainer::CodecForFile( const char *_fileName ) {
+	static const char * storedExtensions[] = { "bimage", "idwav", "idxma", "idmsf", "jpg", "png", "ogg", "bik", "roq" };
+
+	idStrStatic< MAX_OSPATH > name = _fileName;
+	idStrStatic< 16 > ext;
+	name.ExtractFileExtension( ext );
+	for ( int i = 0; i < sizeof( storedExtensions ) / sizeof( storedExtensions[0] ); i++ ) {
+		if ( ext.Icmp( storedExtensions[i] ) == 0 ) {
+			return RESOURCE_CODEC_NONE;
+		}
+	}
+	return RESOURCE_CODEC_DEFLATE;
+}
+
+/*
+========================
+idResourceContainer::WriteEntryData
+
+Writes the data of an entry at the current position of the file and fills in the offset,
+codec and compressed length of the entry. rc.length must be the uncompressed length.
+========================
+*/
+void idResourceContainer::WriteEntryData( idFile *f, idResourceCacheEntry &rc, const byte *data, bool compressed ) {
+	rc.offset = f->Tell();
+	rc.codec = RESOURCE_CODEC_NONE;
+	rc.compressedLength = rc.length;
+
+	if ( compressed && rc.length > 0 && CodecForFile( rc.filename ) == RESOURCE_CODEC_DEFLATE ) {
+		z_stream zStream;
+		memset( &zStream, 0, sizeof( zStream ) );
+		zStream.zalloc = ResourceZlibAlloc;
+		zStream.zfree = ResourceZlibFree;
+		int status = deflateInit2( &zStream, Z_BEST_SPEED, Z_DEFLATED, RESOURCE_ZLIB_WINDOW_BITS, 9, Z_DEFAULT_STRATEGY );
+		if ( status != Z_OK ) {
+			idLib::FatalError( "idResourceContainer::WriteEntryData: deflateInit2() error %i", status );
+		}
+
+		const int bound = deflateBound( &zStream, rc.length );
+		byte * packed = (byte *)Mem_Alloc( bound, TAG_TEMP );
+		zStream.next_in = (Bytef *)data;
+		zStream.avail_in = rc.length;
+		zStream.next_out = packed;
+		zStream.avail_out = bound;
+		status = deflate( &zStream, Z_FINISH );
+		const int packedLength = bound - zStream.avail_out;
+		deflateEnd( &zStream );
+
+		// not worth the decompression time if it doesn't save at least an eighth
+		if ( status == Z_STREAM_END && packedLength < rc.length - rc.length / 8 ) {
+			rc.codec = RESOURCE_CODEC_DEFLATE;
+			rc.compressedLength = packedLength;
+			f->Write( packed, packedLength );
+		}
+		Mem_Free( packed );
+
+		if ( rc.codec != RESOURCE_CODEC_NONE ) {
+			return;
+		}
+	}
+
+	f->Write( data, rc.length );
+}
+
+/*
+========================
+idResourceContainer::DecodeEntryData
+
+Decodes the rc.StoredLength() bytes of src into the rc.length bytes of dest. This
+doesn't touch any shared state, so it can be used from jobs.
+========================
+*/
+bool idResourceContainer::DecodeEntryData( const idResourceCacheEntry &rc, const byte *src, byte *dest ) {
+	if ( rc.codec == RESOURCE_CODEC_NONE ) {
+		memcpy( dest, src, rc.length );
+		return true;
+	}
+	if ( rc.codec != RESOURCE_CODEC_DEFLATE ) {
+		return false;
+	}
+
+	z_stream zStream;
+	memset( &zStream, 0, sizeof( zStream ) );
+	zStream.zalloc = ResourceZlibAlloc;
+	zStream.zfree = ResourceZlibFree;
+	if ( inflateInit2( &zStream, RESOURCE_ZLIB_WINDOW_BITS ) != Z_OK ) {
+		return false;
+	}
+	zStream.next_in = (Bytef *)src;
+	zStream.avail_in = rc.compressedLength;
+	zStream.next_out = dest;
+	zStream.avail_out = rc.length;
+	const int status = inflate( &zStream, Z_FINISH );
+	const bool ok = ( status == Z_STREAM_END && zStream.avail_out == 0 );
+	inflateEnd( &zStream );
+	return ok;
+}
+
+/*
+========================
+idResourceContainer::ReadEntryData
+
+Reads an entry from a resource file and decodes it into the rc.length bytes of dest.
+========================
+*/
+bool idResourceContainer::ReadEntryData( idFile *f, const idResourceCacheEntry &rc, byte *dest ) {
+	if ( f->Tell() != rc.offset ) {
+		f->Seek( rc.offset, FS_SEEK_SET );
+	}
+	if ( rc.codec == RESOURCE_CODEC_NONE ) {
+		return f->Read( dest, rc.length ) == rc.length;
+	}
+
+	byte * packed = (byte *)Mem_Alloc( rc.compressedLength, TAG_TEMP );
+	bool ok = ( f->Read( packed, rc.compressedLength ) == rc.compressedLength );
+	if ( ok ) {
+		ok = DecodeEntryData( rc, packed, dest );
+	}
+	Mem_Free( packed );
+	return ok;
+}
+
 /*
 ========================
 idResourceContainer::ReOpen 
@@ -66,7 +217,7 @@ bool idResourceContainer::Init( const char *_fileName, uint8 containerIndex ) {
 	}
 
 	resourceFile->ReadBig( resourceMagic );
-	if ( resourceMagic != RESOURCE_FILE_MAGIC ) {
+	if ( resourceMagic != RESOURCE_FILE_MAGIC && resourceMagic != RESOURCE_FILE_COMPRESSED_MAGIC ) {
 		idLib::FatalError( "resourceFileMagic != RESOURCE_FILE_MAGIC" );
 	}
 
@@ -88,7 +239,7 @@ bool idResourceContainer::Init( const char *_fileName, uint8 containerIndex ) {
 
 	for ( int i = 0; i < numFileResources; i++ ) {
 		idResourceCacheEntry &rt = cacheTable[ i ];
-		rt.Read( &memFile );
+		rt.Read( &memFile, IsCompressed() );
 		rt.filename.BackSlashesToSlashes();
 		rt.filename.ToLower();
 		rt.containerIndex = containerIndex;
@@ -176,7 +327,7 @@ void idResourceContainer::UpdateResourceFile( const char *_filename, const idStr
 
 	idFile *inFile = fileSystem->OpenFileRead( _filename );
 	if ( inFile == NULL ) {
-		magic = RESOURCE_FILE_MAGIC;
+		magic = fs_resourceCompression.GetBool() ? RESOURCE_FILE_COMPRESSED_MAGIC : RESOURCE_FILE_MAGIC;
 
 		outFile->WriteBig( magic );
 		outFile->WriteBig( _tableOffset );
@@ -184,7 +335,7 @@ void idResourceContainer::UpdateResourceFile( const char *_filename, const idStr
 
 	} else {
 		inFile->ReadBig( magic );
-		if ( magic != RESOURCE_FILE_MAGIC ) {
+		if ( magic != RESOURCE_FILE_MAGIC && magic != RESOURCE_FILE_COMPRESSED_MAGIC ) {
 			delete inFile;
 			return;
 		}
@@ -207,7 +358,7 @@ void idResourceContainer::UpdateResourceFile( const char *_filename, const idStr
 		entries.SetNum( _numFileResources );
 
 		for ( int i = 0; i < _numFileResources; i++ ) {
-			entries[ i ].Read( &memFile );
+			entries[ i ].Read( &memFile, magic == RESOURCE_FILE_COMPRESSED_MAGIC );
 
 
 			idLib::Printf( "examining %s\n", entries[ i ].filename.c_str() );
@@ -228,14 +379,17 @@ void idResourceContainer::UpdateResourceFile( const char *_filename, const idStr
 			}
 
 			if ( fileData == NULL ) {
+				// unchanged entries are copied as they are stored
+				const int storedLength = entries[ i ].StoredLength();
 				inFile->Seek( entries[ i ].offset, FS_SEEK_SET );
-				fileData = (byte *)Mem_Alloc( entries[ i ].length, TAG_TEMP );
-				inFile->Read( fileData, entries[ i ].length );
+				fileData = (byte *)Mem_Alloc( storedLength, TAG_TEMP );
+				inFile->Read( fileData, storedLength );
+				entries[ i ].offset = outFile->Tell();
+				outFile->Write( ( void* )fileData, storedLength );
+			} else {
+				WriteEntryData( outFile, entries[ i ], fileData, magic == RESOURCE_FILE_COMPRESSED_MAGIC );
 			}
 
-			entries[ i ].offset = outFile->Tell();
-			outFile->Write( ( void* )fileData, entries[ i ].length );
-
 			Mem_Free( fileData );
 		}
 
@@ -253,8 +407,7 @@ void idResourceContainer::UpdateResourceFile( const char *_filename, const idStr
 			newFile->Read( fileData, rt.length );
 			int idx = entries.Append( rt );
 			if ( idx >= 0 ) {
-				entries[ idx ].offset = outFile->Tell();
-				outFile->Write( ( void* )fileData, entries[ idx ].length );
+				WriteEntryData( outFile, entries[ idx ], fileData, magic == RESOURCE_FILE_COMPRESSED_MAGIC );
 			}
 			delete newFile;
 			Mem_Free( fileData );
@@ -267,7 +420,7 @@ void idResourceContainer::UpdateResourceFile( const char *_filename, const idStr
 
 	// write the individual resource entries
 	for ( int i = 0; i < entries.Num(); i++ ) {
-		entries[ i ].Write( outFile );
+		entries[ i ].Write( outFile, magic == RESOURCE_FILE_COMPRESSED_MAGIC );
 	}
 
 	// go back and write the header offsets again, now that we have file offsets and lengths
@@ -308,7 +461,7 @@ void idResourceContainer::ExtractResourceFile ( const char * _fileName, const ch
 
 	uint32 magic;
 	inFile->ReadBig( magic );
-	if ( magic != RESOURCE_FILE_MAGIC ) {
+	if ( magic != RESOURCE_FILE_MAGIC && magic != RESOURCE_FILE_COMPRESSED_MAGIC ) {
 		delete inFile;
 		return;
 	}
@@ -328,7 +481,7 @@ void idResourceContainer::ExtractResourceFile ( const char * _fileName, const ch
 
 	for ( int i = 0; i < _numFileResources; i++ ) {
 		idResourceCacheEntry rt;
-		rt.Read( &memFile );
+		rt.Read( &memFile, magic == RESOURCE_FILE_COMPRESSED_MAGIC );
 		rt.filename.BackSlashesToSlashes();
 		rt.filename.ToLower();
 		byte *fbuf = NULL;
@@ -339,9 +492,10 @@ void idResourceContainer::ExtractResourceFile ( const char * _fileName, const ch
 			fbuf =  (byte *)Mem_Alloc( len, TAG_RESOURCE );
 			fileSystem->ReadFile( rt.filename, (void**)&fbuf, NULL );
 		} else {
-			inFile->Seek( rt.offset, FS_SEEK_SET );
 			fbuf =  (byte *)Mem_Alloc( rt.length, TAG_RESOURCE );
-			inFile->Read( fbuf, rt.length );
+			if ( !ReadEntryData( inFile, rt, fbuf ) ) {
+				idLib::Warning( "Unable to decode %s", rt.filename.c_str() );
+			}
 		}
 		idStr outName = _outPath;
 		outName.AppendPath( rt.filename );
@@ -424,7 +578,10 @@ void idResourceContainer::WriteResourceFile( const char *manifestName, const idS
 		int	tableOffset = 0;
 		int	tableLength = 0;
 		int	tableNewLength = 0;
-		uint32	resourceFileMagic = RESOURCE_FILE_MAGIC;
+		const bool compressed = fs_resourceCompression.GetBool();
+		uint32	resourceFileMagic = compressed ? RESOURCE_FILE_COMPRESSED_MAGIC : RESOURCE_FILE_MAGIC;
+		int64	storedBytes = 0;
+		int64	uncompressedBytes = 0;
 
 		resFile->WriteBig( resourceFileMagic );
 		resFile->WriteBig( tableOffset );
@@ -453,15 +610,16 @@ void idResourceContainer::WriteResourceFile( const char *manifestName, const idS
 			// always get the offset, even if the file will have zero length
 			ent.offset = resFile->Tell();
 
-			entries.Append( ent );
-
 			if ( ent.length == 0 ) {
-				ent.filename = "";
+				entries.Append( ent );
 				delete fm;
 				continue;
 			}
 
-			resFile->Write( fm->GetDataPtr(), ent.length );
+			WriteEntryData( resFile, ent, (const byte *)fm->GetDataPtr(), compressed );
+			entries.Append( ent );
+			storedBytes += ent.StoredLength();
+			uncompressedBytes += ent.length;
 
 			delete fm;
 
@@ -472,6 +630,9 @@ void idResourceContainer::WriteResourceFile( const char *manifestName, const idS
 		}
 
 		idLib::Printf( "\n" );
+		if ( compressed ) {
+			idLib::Printf( "%lld bytes stored for %lld bytes of data\n", storedBytes, uncompressedBytes );
+		}
 
 		// write the table out now that we have all the files
 		tableOffset = resFile->Tell();
@@ -483,7 +644,7 @@ void idResourceContainer::WriteResourceFile( const char *manifestName, const idS
 
 		// write the individual resource entries
 		for ( int i = 0; i < entries.Num(); i++ ) {
-			entries[ i ].Write( resFile );
+			entries[ i ].Write( resFile, compressed );
 			if ( i + 1 == numFileResources ) {
 				// we just wrote out the last new entry
 				tableNewLength = resFile->Tell() - tableOffset;
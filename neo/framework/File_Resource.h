@@ -37,6 +37,12 @@ If you have questions concerning this license or the applicable additional terms
 ==============================================================
 */
 
+// per entry storage of the data in a compressed container
+enum resourceCodec_t {
+	RESOURCE_CODEC_NONE,			// stored as is, used for data that is already compressed like DXT images and audio
+	RESOURCE_CODEC_DEFLATE			// raw deflate stream at the fastest level
+};
+
 class idResourceCacheEntry {
 public:
 	idResourceCacheEntry() {
@@ -47,27 +53,47 @@ public:
 		//filename = NULL;
 		offset = 0;
 		length = 0;
+		compressedLength = 0;
+		codec = RESOURCE_CODEC_NONE;
 		containerIndex = 0;
 	}
-	size_t Read( idFile *f ) {
+	size_t Read( idFile *f, bool compressedTable = false ) {
 		size_t sz = f->ReadString( filename );
 		sz += f->ReadBig( offset );
 		sz += f->ReadBig( length );
+		if ( compressedTable ) {
+			sz += f->ReadBig( compressedLength );
+			sz += f->ReadBig( codec );
+		} else {
+			compressedLength = length;
+			codec = RESOURCE_CODEC_NONE;
+		}
 		return sz;
 	}
-	size_t Write( idFile *f ) {
+	size_t Write( idFile *f, bool compressedTable = false ) {
 		size_t sz = f->WriteString( filename );
 		sz += f->WriteBig( offset );
 		sz += f->WriteBig( length );
+		if ( compressedTable ) {
+			sz += f->WriteBig( compressedLength );
+			sz += f->WriteBig( codec );
+		}
 		return sz;
 	}
+	// number of bytes the entry takes up in the resource file
+	int StoredLength() const {
+		return ( codec == RESOURCE_CODEC_NONE ) ? length : compressedLength;
+	}
 	idStrStatic< 256 >	filename;
 	int					offset;							// into the resource file
-	int 				length;
+	int 				length;							// uncompressed length
+	int					compressedLength;				// length in the resource file if codec != RESOURCE_CODEC_NONE
+	uint8				codec;							// resourceCodec_t
 	uint8				containerIndex;
 };
 
 static const uint32 RESOURCE_FILE_MAGIC = 0xD000000D;
+static const uint32 RESOURCE_FILE_COMPRESSED_MAGIC = 0xD000000E;	// table entries also have a compressed length and codec
 class idResourceContainer {
 	friend class	idFileSystemLocal;
 	//friend class	idReadSpawnThread;
@@ -89,8 +115,13 @@ public:
 	static int ReadManifestFile( const char *filename, idStrList &list );
 	static void ExtractResourceFile ( const char * fileName, const char * outPath, bool copyWavs );
 	static void UpdateResourceFile( const char *filename, const idStrList &filesToAdd );
+	static resourceCodec_t CodecForFile( const char *fileName );
+	static void WriteEntryData( idFile *f, idResourceCacheEntry &rc, const byte *data, bool compressed );
+	static bool DecodeEntryData( const idResourceCacheEntry &rc, const byte *src, byte *dest );
+	static bool ReadEntryData( idFile *f, const idResourceCacheEntry &rc, byte *dest );
 	idFile *OpenFile( const char *fileName );
 	const char * GetFileName() const { return fileName.c_str(); }
+	bool IsCompressed() const { return resourceMagic == RESOURCE_FILE_COMPRESSED_MAGIC; }
 	void SetContainerIndex( const int & _idx );
 	void ReOpen();
 private:
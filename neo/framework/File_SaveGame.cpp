@@ -62,8 +62,80 @@ idCVar sgf_testCorruption( "sgf_testCorruption", "-1", CVAR_INTEGER, "test corru
 // this is supposed to get faster going from -15 to -9, but it gets slower as well as worse compression
 idCVar sgf_windowBits( "sgf_windowBits", "-15", CVAR_INTEGER, "zlib window bits" );
 
+idCVar sgf_parallelBlocks( "sgf_parallelBlocks", "4", CVAR_INTEGER, "number of 256 kB blocks compressed at a time on the job threads, 0 = single zlib stream on the compression thread", 0, idFile_SaveGamePipelined::MAX_PARALLEL_BLOCKS );
+idCVar sgf_showStats( "sgf_showStats", "0", CVAR_BOOL, "print save game file sizes and times" );
+
 bool idFile_SaveGamePipelined::cancelToTerminate = false;
 
+// The first byte of a raw deflate stream can't have both block type bits set,
+// so this can't be mistaken for the start of a single zlib stream.
+static const byte SGF_PARALLEL_MAGIC[4] = { 0xFE, 'S', 'G', 'P' };
+
+// compressed size + uncompressed size, a compressed size of 0 ends the stream
+static const int SGF_PARALLEL_HEADER_SIZE = 8;
+
+// worst case size of a deflated block, with a generous margin over deflateBound()
+static const int SGF_MAX_COMPRESSED_BLOCK = idFile_SaveGamePipelined::UNCOMPRESSED_BLOCK_SIZE + idFile_SaveGamePipelined::UNCOMPRESSED_BLOCK_SIZE / 256 + 1024;
+
+/*
+================================================
+sgfParallelBlock_t
+
+An uncompressed block and its independent zlib stream.
+================================================
+*/
+struct sgfParallelBlock_t {
+	z_stream				zStream;
+	bool					deflating;			// zStream was set up for deflate instead of inflate
+	byte *					uncompressed;
+	size_t					uncompressedBytes;
+	byte *					compressed;
+	size_t					compressedBytes;
+	int						zstat;
+};
+
+/*
+========================
+SGF_CompressBlockJob
+========================
+*/
+static void SGF_CompressBlockJob( sgfParallelBlock_t * block ) {
+	deflateReset( &block->zStream );
+
+	block->zStream.next_in = (Bytef *)block->uncompressed;
+	block->zStream.avail_in = (uInt)block->uncompressedBytes;
+	block->zStream.next_out = (Bytef *)block->compressed;
+	block->zStream.avail_out = SGF_MAX_COMPRESSED_BLOCK;
+
+	block->zstat = deflate( &block->zStream, Z_FINISH );
+	block->compressedBytes = SGF_MAX_COMPRESSED_BLOCK - block->zStream.avail_out;
+}
+
+REGISTER_PARALLEL_JOB( SGF_CompressBlockJob, "SGF_CompressBlockJob" );
+
+/*
+========================
+SGF_DecompressBlockJob
+========================
+*/
+static void SGF_DecompressBlockJob( sgfParallelBlock_t * block ) {
+	inflateReset( &block->zStream );
+
+	block->zStream.next_in = (Bytef *)block->compressed;
+	block->zStream.avail_in = (uInt)block->compressedBytes;
+	block->zStream.next_out = (Bytef *)block->uncompressed;
+	block->zStream.avail_out = idFile_SaveGamePipelined::UNCOMPRESSED_BLOCK_SIZE;
+
+	block->zstat = inflate( &block->zStream, Z_FINISH );
+
+	const size_t inflatedBytes = idFile_SaveGamePipelined::UNCOMPRESSED_BLOCK_SIZE - block->zStream.avail_out;
+	if ( block->zstat == Z_STREAM_END && inflatedBytes != block->uncompressedBytes ) {
+		block->zstat = Z_DATA_ERROR;
+	}
+}
+
+REGISTER_PARALLEL_JOB( SGF_DecompressBlockJob, "SGF_DecompressBlockJob" );
+
 class idSGFcompressThread : public idSysThread {
 public:
 	virtual int			Run() { sgf->CompressBlock(); return 0; }
@@ -111,6 +183,12 @@ idFile_SaveGamePipelined::idFile_SaveGamePipelined() :
 		writeThread( NULL ),
 		decompressThread( NULL ),
 		compressThread( NULL ),
+		streamFormat( STREAM_UNKNOWN ),
+		numParallelBlocks( 0 ),
+		parallelGroup( 0 ),
+		parallelBlock( 0 ),
+		parallelStreamEndHit( false ),
+		startMicroseconds( 0 ),
 		blockFinished( true ),
 		buildVersion( "" ),
 		saveFormatVersion( 0 ) {
@@ -120,6 +198,12 @@ idFile_SaveGamePipelined::idFile_SaveGamePipelined() :
 	memset( uncompressed, 0, sizeof( uncompressed ) );
 	zStream.zalloc = ZlibAlloc;
 	zStream.zfree = ZlibFree;
+
+	for ( int i = 0; i < 2; i++ ) {
+		parallelBlocks[i] = NULL;
+		parallelJobs[i] = NULL;
+		parallelGroupBlocks[i] = 0;
+	}
 }
 
 /*
@@ -148,6 +232,8 @@ idFile_SaveGamePipelined::~idFile_SaveGamePipelined() {
 		writeThread = NULL;
 	}
 
+	FreeParallelBlocks();
+
 	// close the native file
 /*	if ( nativeFile != NULL ) {
 		delete nativeFile;
@@ -201,17 +287,30 @@ idFile_SaveGamePipelined::Finish
 void idFile_SaveGamePipelined::Finish() {
 	if ( mode == WRITE ) {
 
-		// wait for the compression thread to complete, which may kick off a write
-		if ( compressThread != NULL ) {
-			compressThread->WaitForThread();
-		}
+		if ( streamFormat == STREAM_PARALLEL ) {
+			// compress and emit whatever is left, followed by the end marker
+			FlushParallelGroup( true );
 
-		// force the next compression to emit everything
-		zLibFlushType = Z_FINISH;
-		FlushUncompressedBlock();
+			byte header[SGF_PARALLEL_HEADER_SIZE];
+			memset( header, 0, sizeof( header ) );
+			EmitCompressed( header, sizeof( header ) );
 
-		if ( compressThread != NULL ) {
-			compressThread->WaitForThread();
+			if ( compressedProducedBytes != compressedConsumedBytes ) {
+				FinishCompressedBlock();
+			}
+		} else {
+			// wait for the compression thread to complete, which may kick off a write
+			if ( compressThread != NULL ) {
+				compressThread->WaitForThread();
+			}
+
+			// force the next compression to emit everything
+			zLibFlushType = Z_FINISH;
+			FlushUncompressedBlock();
+
+			if ( compressThread != NULL ) {
+				compressThread->WaitForThread();
+			}
 		}
 
 		if ( writeThread != NULL ) {
@@ -228,6 +327,8 @@ void idFile_SaveGamePipelined::Finish() {
 		// free zlib tables
 		deflateEnd( &zStream );
 
+		PrintStats();
+
 	} else if ( mode == READ ) {
 
 		// wait for the decompression thread to complete, which may kick off a read
@@ -246,8 +347,12 @@ void idFile_SaveGamePipelined::Finish() {
 			blockFinished.Wait();
 		}
 
+		WaitParallelBlocks();
+
 		// free zlib tables
 		inflateEnd( &zStream );
+
+		PrintStats();
 	}
 
 	mode = CLOSED;
@@ -264,6 +369,7 @@ void idFile_SaveGamePipelined::Abort() {
 		if ( compressThread != NULL ) {
 			compressThread->WaitForThread();
 		}
+		WaitParallelBlocks();
 		if ( writeThread != NULL ) {
 			writeThread->WaitForThread();
 		} else if ( nativeFile == NULL && !nativeFileEndHit ) {
@@ -280,6 +386,7 @@ void idFile_SaveGamePipelined::Abort() {
 		if ( decompressThread != NULL ) {
 			decompressThread->WaitForThread();
 		}
+		WaitParallelBlocks();
 		if ( readThread != NULL ) {
 			readThread->WaitForThread();
 		} else if ( nativeFile == NULL && !nativeFileEndHit ) {
@@ -295,6 +402,138 @@ void idFile_SaveGamePipelined::Abort() {
 	mode = CLOSED;
 }
 
+/*
+============================
+idFile_SaveGamePipelined::AllocParallelJobs
+
+Job lists can only be allocated on the thread that opens the file.
+============================
+*/
+void idFile_SaveGamePipelined::AllocParallelJobs() {
+	assert( parallelJobs[0] == NULL );
+
+	numParallelBlocks = idMath::ClampInt( 1, MAX_PARALLEL_BLOCKS, sgf_parallelBlocks.GetInteger() );
+
+	for ( int i = 0; i < 2; i++ ) {
+		parallelJobs[i] = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, numParallelBlocks, 0, NULL );
+	}
+}
+
+/*
+============================
+idFile_SaveGamePipelined::AllocParallelBlocks
+============================
+*/
+void idFile_SaveGamePipelined::AllocParallelBlocks( bool forWriting ) {
+	assert( parallelBlocks[0] == NULL );
+
+	if ( parallelJobs[0] == NULL ) {
+		AllocParallelJobs();
+	}
+
+	for ( int i = 0; i < 2; i++ ) {
+		parallelBlocks[i] = new (TAG_SAVEGAMES) sgfParallelBlock_t[numParallelBlocks];
+		for ( int j = 0; j < numParallelBlocks; j++ ) {
+			sgfParallelBlock_t & block = parallelBlocks[i][j];
+			memset( &block.zStream, 0, sizeof( block.zStream ) );
+			block.zStream.zalloc = ZlibAlloc;
+			block.zStream.zfree = ZlibFree;
+			block.uncompressed = (byte *)Mem_Alloc( UNCOMPRESSED_BLOCK_SIZE, TAG_SAVEGAMES );
+			block.uncompressedBytes = 0;
+			block.compressed = (byte *)Mem_Alloc( SGF_MAX_COMPRESSED_BLOCK, TAG_SAVEGAMES );
+			block.compressedBytes = 0;
+			block.zstat = Z_OK;
+			block.deflating = forWriting;
+
+			int status;
+			if ( forWriting ) {
+				status = deflateInit2( &block.zStream, Z_BEST_SPEED, Z_DEFLATED, sgf_windowBits.GetInteger(), 9, Z_DEFAULT_STRATEGY );
+			} else {
+				status = inflateInit2( &block.zStream, sgf_windowBits.GetInteger() );
+			}
+			if ( status != Z_OK ) {
+				idLib::FatalError( "idFile_SaveGamePipelined::AllocParallelBlocks: zlib init error %i", status );
+			}
+		}
+		parallelGroupBlocks[i] = 0;
+	}
+
+	parallelGroup = 0;
+	parallelBlock = 0;
+	parallelStreamEndHit = false;
+
+	if ( forWriting ) {
+		streamFormat = STREAM_PARALLEL;
+	}
+}
+
+/*
+============================
+idFile_SaveGamePipelined::WaitParallelBlocks
+
+Makes sure no job is still working on a block.
+============================
+*/
+void idFile_SaveGamePipelined::WaitParallelBlocks() {
+	for ( int i = 0; i < 2; i++ ) {
+		if ( parallelJobs[i] != NULL ) {
+			parallelJobs[i]->Wait();
+		}
+	}
+}
+
+/*
+============================
+idFile_SaveGamePipelined::FreeParallelBlocks
+============================
+*/
+void idFile_SaveGamePipelined::FreeParallelBlocks() {
+	WaitParallelBlocks();
+
+	for ( int i = 0; i < 2; i++ ) {
+		if ( parallelJobs[i] != NULL ) {
+			parallelJobManager->FreeJobList( parallelJobs[i] );
+			parallelJobs[i] = NULL;
+		}
+		if ( parallelBlocks[i] != NULL ) {
+			for ( int j = 0; j < numParallelBlocks; j++ ) {
+				sgfParallelBlock_t & block = parallelBlocks[i][j];
+				if ( block.deflating ) {
+					deflateEnd( &block.zStream );
+				} else {
+					inflateEnd( &block.zStream );
+				}
+				Mem_Free( block.uncompressed );
+				Mem_Free( block.compressed );
+			}
+			delete[] parallelBlocks[i];
+			parallelBlocks[i] = NULL;
+		}
+		parallelGroupBlocks[i] = 0;
+	}
+	numParallelBlocks = 0;
+}
+
+/*
+============================
+idFile_SaveGamePipelined::PrintStats
+============================
+*/
+void idFile_SaveGamePipelined::PrintStats() const {
+	if ( !sgf_showStats.GetBool() ) {
+		return;
+	}
+	const uint64 microseconds = Sys_Microseconds() - startMicroseconds;
+	const char * format = ( streamFormat == STREAM_PARALLEL ) ? "parallel blocks" : "single stream";
+	if ( mode == WRITE ) {
+		idLib::Printf( "%s: wrote %i bytes as %i compressed bytes (%s) in %lld microseconds\n",
+			name.c_str(), (int)uncompressedProducedBytes, (int)compressedProducedBytes, format, microseconds );
+	} else {
+		idLib::Printf( "%s: read %i bytes from %i compressed bytes (%s) in %lld microseconds\n",
+			name.c_str(), (int)uncompressedProducedBytes, (int)compressedConsumedBytes, format, microseconds );
+	}
+}
+
 /*
 ===================================================================================
 
@@ -324,25 +563,33 @@ bool idFile_SaveGamePipelined::OpenForWriting( const char * const filename, bool
 		}
 	}
 
-	// raw deflate with no header / checksum
-	// use max memory for fastest compression
-	// optimize for higher speed
-	//mem.PushHeap();
-	int status = deflateInit2( &zStream, Z_BEST_SPEED, Z_DEFLATED, sgf_windowBits.GetInteger(), 9, Z_DEFAULT_STRATEGY );
-	//mem.PopHeap();
-	if ( status != Z_OK ) {
-		idLib::FatalError( "idFile_SaveGamePipelined::OpenForWriting: deflateInit2() error %i", status );
-	}
+	startMicroseconds = Sys_Microseconds();
 
-	// initial buffer setup
-	zStream.avail_out = COMPRESSED_BLOCK_SIZE;
-	zStream.next_out = (Bytef * )compressed;
+	if ( sgf_parallelBlocks.GetInteger() > 0 ) {
+		// independent blocks are compressed on the job threads instead of the compression thread
+		AllocParallelBlocks( true );
+	} else {
+		// raw deflate with no header / checksum
+		// use max memory for fastest compression
+		// optimize for higher speed
+		//mem.PushHeap();
+		int status = deflateInit2( &zStream, Z_BEST_SPEED, Z_DEFLATED, sgf_windowBits.GetInteger(), 9, Z_DEFAULT_STRATEGY );
+		//mem.PopHeap();
+		if ( status != Z_OK ) {
+			idLib::FatalError( "idFile_SaveGamePipelined::OpenForWriting: deflateInit2() error %i", status );
+		}
 
-	if ( sgf_checksums.GetBool() ) {
-		zStream.avail_out -= sizeof( uint32 );
+		// initial buffer setup
+		zStream.avail_out = COMPRESSED_BLOCK_SIZE;
+		zStream.next_out = (Bytef * )compressed;
+
+		if ( sgf_checksums.GetBool() ) {
+			zStream.avail_out -= sizeof( uint32 );
+		}
+		streamFormat = STREAM_DEFLATE;
 	}
 
-	if ( sgf_threads.GetInteger() >= 1 ) {
+	if ( streamFormat == STREAM_DEFLATE && sgf_threads.GetInteger() >= 1 ) {
 		compressThread = new (TAG_IDFILE) idSGFcompressThread();
 		compressThread->sgf = this;
 		compressThread->StartWorkerThread( "SGF_CompressThread", CORE_2B, THREAD_NORMAL );
@@ -353,6 +600,10 @@ bool idFile_SaveGamePipelined::OpenForWriting( const char * const filename, bool
 		writeThread->StartWorkerThread( "SGF_WriteThread", CORE_2A, THREAD_NORMAL );
 	}
 
+	if ( streamFormat == STREAM_PARALLEL ) {
+		EmitCompressed( SGF_PARALLEL_MAGIC, sizeof( SGF_PARALLEL_MAGIC ) );
+	}
+
 	return true;
 }
 
@@ -375,25 +626,33 @@ bool idFile_SaveGamePipelined::OpenForWriting( idFile * file )  {
 	numChecksums = 0;
 
 
-	// raw deflate with no header / checksum
-	// use max memory for fastest compression
-	// optimize for higher speed
-	//mem.PushHeap();
-	int status = deflateInit2( &zStream, Z_BEST_SPEED, Z_DEFLATED, sgf_windowBits.GetInteger(), 9, Z_DEFAULT_STRATEGY );
-	//mem.PopHeap();
-	if ( status != Z_OK ) {
-		idLib::FatalError( "idFile_SaveGamePipelined::OpenForWriting: deflateInit2() error %i", status );
-	}
+	startMicroseconds = Sys_Microseconds();
 
-	// initial buffer setup
-	zStream.avail_out = COMPRESSED_BLOCK_SIZE;
-	zStream.next_out = (Bytef * )compressed;
+	if ( sgf_parallelBlocks.GetInteger() > 0 ) {
+		// independent blocks are compressed on the job threads instead of the compression thread
+		AllocParallelBlocks( true );
+	} else {
+		// raw deflate with no header / checksum
+		// use max memory for fastest compression
+		// optimize for higher speed
+		//mem.PushHeap();
+		int status = deflateInit2( &zStream, Z_BEST_SPEED, Z_DEFLATED, sgf_windowBits.GetInteger(), 9, Z_DEFAULT_STRATEGY );
+		//mem.PopHeap();
+		if ( status != Z_OK ) {
+			idLib::FatalError( "idFile_SaveGamePipelined::OpenForWriting: deflateInit2() error %i", status );
+		}
 
-	if ( sgf_checksums.GetBool() ) {
-		zStream.avail_out -= sizeof( uint32 );
+		// initial buffer setup
+		zStream.avail_out = COMPRESSED_BLOCK_SIZE;
+		zStream.next_out = (Bytef * )compressed;
+
+		if ( sgf_checksums.GetBool() ) {
+			zStream.avail_out -= sizeof( uint32 );
+		}
+		streamFormat = STREAM_DEFLATE;
 	}
 
-	if ( sgf_threads.GetInteger() >= 1 ) {
+	if ( streamFormat == STREAM_DEFLATE && sgf_threads.GetInteger() >= 1 ) {
 		compressThread = new (TAG_IDFILE) idSGFcompressThread();
 		compressThread->sgf = this;
 		compressThread->StartWorkerThread( "SGF_CompressThread", CORE_2B, THREAD_NORMAL );
@@ -404,6 +663,10 @@ bool idFile_SaveGamePipelined::OpenForWriting( idFile * file )  {
 		writeThread->StartWorkerThread( "SGF_WriteThread", CORE_2A, THREAD_NORMAL );
 	}
 
+	if ( streamFormat == STREAM_PARALLEL ) {
+		EmitCompressed( SGF_PARALLEL_MAGIC, sizeof( SGF_PARALLEL_MAGIC ) );
+	}
+
 	return true;
 }
 
@@ -640,6 +903,29 @@ int idFile_SaveGamePipelined::Write( const void * buffer, int length ) {
 	assert( mode == WRITE );
 	size_t lengthRemaining = length;
 	const byte * buffer_p = (const byte *)buffer;
+
+	if ( streamFormat == STREAM_PARALLEL ) {
+		while ( lengthRemaining > 0 ) {
+			sgfParallelBlock_t & block = parallelBlocks[parallelGroup][parallelBlock];
+			const size_t remainingInBlock = UNCOMPRESSED_BLOCK_SIZE - block.uncompressedBytes;
+			const size_t copyToBlock = ( lengthRemaining < remainingInBlock ) ? lengthRemaining : remainingInBlock;
+
+			memcpy( block.uncompressed + block.uncompressedBytes, buffer_p, copyToBlock );
+			block.uncompressedBytes += copyToBlock;
+			uncompressedProducedBytes += copyToBlock;
+
+			buffer_p += copyToBlock;
+			lengthRemaining -= copyToBlock;
+
+			if ( copyToBlock == remainingInBlock ) {
+				if ( ++parallelBlock == numParallelBlocks ) {
+					FlushParallelGroup( false );
+				}
+			}
+		}
+		return length;
+	}
+
 	while ( lengthRemaining > 0 ) {
 		const size_t ofsInBuffer = uncompressedProducedBytes & ( UNCOMPRESSED_BUFFER_SIZE - 1 );
 		const size_t ofsInBlock = uncompressedProducedBytes & ( UNCOMPRESSED_BLOCK_SIZE - 1 );
@@ -659,6 +945,134 @@ int idFile_SaveGamePipelined::Write( const void * buffer, int length ) {
 	return length;
 }
 
+/*
+============================
+idFile_SaveGamePipelined::FinishCompressedBlock
+
+Appends the checksum to the compressed block being filled by EmitCompressed()
+and hands it to the IO.
+============================
+*/
+void idFile_SaveGamePipelined::FinishCompressedBlock() {
+	if ( sgf_checksums.GetBool() ) {
+		const size_t blockSize = compressedProducedBytes - compressedConsumedBytes;
+		byte * block = &compressed[ compressedConsumedBytes & ( COMPRESSED_BUFFER_SIZE - 1 ) ];
+		uint32 checksum = MD5_BlockChecksum( block, blockSize );
+		block[blockSize + 0] = ( ( checksum >>  0 ) & 0xFF );
+		block[blockSize + 1] = ( ( checksum >>  8 ) & 0xFF );
+		block[blockSize + 2] = ( ( checksum >> 16 ) & 0xFF );
+		block[blockSize + 3] = ( ( checksum >> 24 ) & 0xFF );
+		compressedProducedBytes += sizeof( uint32 );
+		numChecksums++;
+	}
+	FlushCompressedBlock();
+}
+
+/*
+============================
+idFile_SaveGamePipelined::EmitCompressed
+
+Appends data to the compressed blocks that go out to the IO, this replaces
+CompressBlock() when blocks are compressed on the job threads.
+
+Modifies:
+	compressed
+	compressedProducedBytes
+============================
+*/
+void idFile_SaveGamePipelined::EmitCompressed( const void * data, size_t bytes ) {
+	const size_t blockPayload = COMPRESSED_BLOCK_SIZE - ( sgf_checksums.GetBool() ? sizeof( uint32 ) : 0 );
+	const byte * data_p = (const byte *)data;
+	while ( bytes > 0 ) {
+		const size_t ofsInBlock = compressedProducedBytes - compressedConsumedBytes;
+		const size_t remainingInBlock = blockPayload - ofsInBlock;
+		const size_t copyToBlock = ( bytes < remainingInBlock ) ? bytes : remainingInBlock;
+
+		memcpy( &compressed[ compressedProducedBytes & ( COMPRESSED_BUFFER_SIZE - 1 ) ], data_p, copyToBlock );
+		compressedProducedBytes += copyToBlock;
+
+		data_p += copyToBlock;
+		bytes -= copyToBlock;
+
+		if ( copyToBlock == remainingInBlock ) {
+			FinishCompressedBlock();
+		}
+	}
+}
+
+/*
+============================
+idFile_SaveGamePipelined::EmitParallelGroup
+
+Waits for a group of blocks to be compressed and emits them in order.
+============================
+*/
+void idFile_SaveGamePipelined::EmitParallelGroup( int group ) {
+	if ( parallelGroupBlocks[group] == 0 ) {
+		return;
+	}
+
+	parallelJobs[group]->Wait();
+
+	for ( int i = 0; i < parallelGroupBlocks[group]; i++ ) {
+		sgfParallelBlock_t & block = parallelBlocks[group][i];
+		if ( block.zstat != Z_STREAM_END ) {
+			idLib::FatalError( "idFile_SaveGamePipelined::EmitParallelGroup: deflate() returned %i", block.zstat );
+		}
+
+		byte header[SGF_PARALLEL_HEADER_SIZE];
+		header[0] = ( ( block.compressedBytes >>  0 ) & 0xFF );
+		header[1] = ( ( block.compressedBytes >>  8 ) & 0xFF );
+		header[2] = ( ( block.compressedBytes >> 16 ) & 0xFF );
+		header[3] = ( ( block.compressedBytes >> 24 ) & 0xFF );
+		header[4] = ( ( block.uncompressedBytes >>  0 ) & 0xFF );
+		header[5] = ( ( block.uncompressedBytes >>  8 ) & 0xFF );
+		header[6] = ( ( block.uncompressedBytes >> 16 ) & 0xFF );
+		header[7] = ( ( block.uncompressedBytes >> 24 ) & 0xFF );
+
+		EmitCompressed( header, sizeof( header ) );
+		EmitCompressed( block.compressed, block.compressedBytes );
+
+		block.uncompressedBytes = 0;
+		block.compressedBytes = 0;
+	}
+	parallelGroupBlocks[group] = 0;
+}
+
+/*
+============================
+idFile_SaveGamePipelined::FlushParallelGroup
+
+Called when a group of uncompressed blocks fills up, and also to flush the final
+partial group.  The group is handed to the job threads and the group submitted
+before it is emitted, so writing continues while the group compresses.
+============================
+*/
+void idFile_SaveGamePipelined::FlushParallelGroup( bool finish ) {
+	const int group = parallelGroup;
+
+	int numBlocks = parallelBlock;
+	if ( numBlocks < numParallelBlocks && parallelBlocks[group][numBlocks].uncompressedBytes > 0 ) {
+		numBlocks++;
+	}
+
+	for ( int i = 0; i < numBlocks; i++ ) {
+		parallelJobs[group]->AddJob( (jobRun_t)SGF_CompressBlockJob, &parallelBlocks[group][i] );
+	}
+	parallelGroupBlocks[group] = numBlocks;
+	if ( numBlocks > 0 ) {
+		parallelJobs[group]->Submit();
+	}
+
+	EmitParallelGroup( group ^ 1 );
+	if ( finish ) {
+		EmitParallelGroup( group );
+	}
+
+	parallelGroup = group ^ 1;
+	parallelBlock = 0;
+}
+
 /*
 ===================================================================================
 
@@ -688,6 +1102,8 @@ bool idFile_SaveGamePipelined::OpenForReading( const char * const filename, bool
 		}
 	}
 
+	startMicroseconds = Sys_Microseconds();
+
 	// init zlib for raw inflate with a 32k dictionary
 	//mem.PushHeap();
 	int status = inflateInit2( &zStream, sgf_windowBits.GetInteger() );
@@ -696,6 +1112,10 @@ bool idFile_SaveGamePipelined::OpenForReading( const char * const filename, bool
 		idLib::FatalError( "idFile_SaveGamePipelined::OpenForReading: inflateInit2() error %i", status );
 	}
 
+	// the format isn't known until the first block is read, the blocks are only
+	// allocated when it turns out to be parallel
+	AllocParallelJobs();
+
 	// spawn threads
 	if ( sgf_threads.GetInteger() >= 1 ) {
 		decompressThread = new (TAG_IDFILE) idSGFdecompressThread();
@@ -730,6 +1150,8 @@ bool idFile_SaveGamePipelined::OpenForReading( idFile * file ) {
 	nativeFile = file;
 	numChecksums = 0;
 
+	startMicroseconds = Sys_Microseconds();
+
 	// init zlib for raw inflate with a 32k dictionary
 	//mem.PushHeap();
 	int status = inflateInit2( &zStream, sgf_windowBits.GetInteger() );
@@ -738,6 +1160,10 @@ bool idFile_SaveGamePipelined::OpenForReading( idFile * file ) {
 		idLib::FatalError( "idFile_SaveGamePipelined::OpenForReading: inflateInit2() error %i", status );
 	}
 
+	// the format isn't known until the first block is read, the blocks are only
+	// allocated when it turns out to be parallel
+	AllocParallelJobs();
+
 	// spawn threads
 	if ( sgf_threads.GetInteger() >= 1 ) {
 		decompressThread = new (TAG_IDFILE) idSGFdecompressThread();
@@ -864,6 +1290,171 @@ void idFile_SaveGamePipelined::PumpCompressedBlock() {
 	}
 }
 
+/*
+============================
+idFile_SaveGamePipelined::FetchCompressed
+
+Points zStream.next_in at the next compressed block, after checking its checksum.
+Returns false at the end of the file or when the checksum is wrong.
+
+Modifies:
+	dataIO
+	bytesIO
+	zStream
+============================
+*/
+bool idFile_SaveGamePipelined::FetchCompressed() {
+	do {
+		PumpCompressedBlock();
+		if ( bytesIO == 0 && nativeFileEndHit ) {
+			// don't try to decompress any more if there is no more data
+			return false;
+		}
+	} while ( bytesIO == 0 );
+
+	zStream.next_in = (Bytef *) dataIO;
+	zStream.avail_in = (uInt) bytesIO;
+
+	dataIO = NULL;
+	bytesIO = 0;
+
+	if ( sgf_checksums.GetBool() ) {
+		if ( sgf_testCorruption.GetInteger() == numChecksums ) {
+			zStream.next_in[0] ^= 0xFF;
+		}
+		zStream.avail_in -= sizeof( uint32 );
+		uint32 checksum = MD5_BlockChecksum( zStream.next_in, zStream.avail_in );
+		if (	!verify( zStream.next_in[zStream.avail_in + 0] == ( ( checksum >>  0 ) & 0xFF ) ) ||
+				!verify( zStream.next_in[zStream.avail_in + 1] == ( ( checksum >>  8 ) & 0xFF ) ) ||
+				!verify( zStream.next_in[zStream.avail_in + 2] == ( ( checksum >> 16 ) & 0xFF ) ) ||
+				!verify( zStream.next_in[zStream.avail_in + 3] == ( ( checksum >> 24 ) & 0xFF ) ) ) {
+			// don't try to decompress any more if the checksum is wrong
+			return false;
+		}
+		numChecksums++;
+	}
+	return true;
+}
+
+/*
+============================
+idFile_SaveGamePipelined::ReadCompressed
+
+Copies raw bytes out of the compressed blocks.
+============================
+*/
+bool idFile_SaveGamePipelined::ReadCompressed( void * data, size_t bytes ) {
+	byte * data_p = (byte *)data;
+	while ( bytes > 0 ) {
+		if ( zStream.avail_in == 0 ) {
+			if ( !FetchCompressed() ) {
+				return false;
+			}
+			continue;
+		}
+
+		const size_t copyFromBlock = ( bytes < zStream.avail_in ) ? bytes : zStream.avail_in;
+
+		memcpy( data_p, zStream.next_in, copyFromBlock );
+		zStream.next_in += copyFromBlock;
+		zStream.avail_in -= (uInt) copyFromBlock;
+
+		data_p += copyFromBlock;
+		bytes -= copyFromBlock;
+	}
+	return true;
+}
+
+/*
+============================
+idFile_SaveGamePipelined::FillParallelGroup
+
+Reads the next group of compressed blocks and hands them to the job threads.
+============================
+*/
+void idFile_SaveGamePipelined::FillParallelGroup( int group ) {
+	int numBlocks = 0;
+	while ( numBlocks < numParallelBlocks && !parallelStreamEndHit ) {
+		sgfParallelBlock_t & block = parallelBlocks[group][numBlocks];
+
+		byte header[SGF_PARALLEL_HEADER_SIZE];
+		if ( !ReadCompressed( header, sizeof( header ) ) ) {
+			parallelStreamEndHit = true;
+			break;
+		}
+
+		block.compressedBytes = header[0] | ( header[1] << 8 ) | ( header[2] << 16 ) | ( header[3] << 24 );
+		block.uncompressedBytes = header[4] | ( header[5] << 8 ) | ( header[6] << 16 ) | ( header[7] << 24 );
+
+		if ( block.compressedBytes == 0 ) {
+			// end of the stream
+			parallelStreamEndHit = true;
+			break;
+		}
+		if ( block.compressedBytes > SGF_MAX_COMPRESSED_BLOCK || block.uncompressedBytes == 0 || block.uncompressedBytes > UNCOMPRESSED_BLOCK_SIZE ) {
+			idLib::Warning( "idFile_SaveGamePipelined::FillParallelGroup: bad block header" );
+			parallelStreamEndHit = true;
+			break;
+		}
+		if ( !ReadCompressed( block.compressed, block.compressedBytes ) ) {
+			parallelStreamEndHit = true;
+			break;
+		}
+
+		parallelJobs[group]->AddJob( (jobRun_t)SGF_DecompressBlockJob, &block );
+		numBlocks++;
+	}
+
+	parallelGroupBlocks[group] = numBlocks;
+	if ( numBlocks > 0 ) {
+		parallelJobs[group]->Submit();
+	}
+}
+
+/*
+============================
+idFile_SaveGamePipelined::DecompressParallelBlock
+
+Takes the next block decompressed on the job threads.  A group is refilled as
+soon as it is drained, so one group is always decompressing ahead of the reader.
+
+Modifies:
+	uncompressed
+	uncompressedProducedBytes
+	zStreamEndHit
+============================
+*/
+void idFile_SaveGamePipelined::DecompressParallelBlock() {
+	for ( int i = 0; i < 2 && parallelBlock == parallelGroupBlocks[parallelGroup]; i++ ) {
+		FillParallelGroup( parallelGroup );
+		parallelGroup ^= 1;
+		parallelBlock = 0;
+	}
+	if ( parallelBlock == parallelGroupBlocks[parallelGroup] ) {
+		// both groups are empty
+		zStreamEndHit = true;
+		return;
+	}
+
+	parallelJobs[parallelGroup]->Wait();
+
+	const sgfParallelBlock_t & block = parallelBlocks[parallelGroup][parallelBlock++];
+	if ( block.zstat != Z_STREAM_END ) {
+		idLib::Warning( "idFile_SaveGamePipelined::DecompressParallelBlock: inflate() returned %i", block.zstat );
+		zStreamEndHit = true;
+		return;
+	}
+
+	assert( ( uncompressedProducedBytes & ( UNCOMPRESSED_BLOCK_SIZE - 1 ) ) == 0 );
+	memcpy( &uncompressed[ uncompressedProducedBytes & ( UNCOMPRESSED_BUFFER_SIZE - 1 ) ], block.uncompressed, block.uncompressedBytes );
+	uncompressedProducedBytes += block.uncompressedBytes;
+
+	if ( block.uncompressedBytes < UNCOMPRESSED_BLOCK_SIZE ) {
+		// only the last block is partial
+		zStreamEndHit = true;
+	}
+}
+
 /*
 ============================
 idFile_SaveGamePipelined::DecompressBlock
@@ -895,42 +1486,35 @@ void idFile_SaveGamePipelined::DecompressBlock() {
 		return;
 	}
 
+	if ( streamFormat == STREAM_UNKNOWN ) {
+		if ( !FetchCompressed() ) {
+			zStreamEndHit = true;
+			return;
+		}
+		if ( zStream.avail_in >= sizeof( SGF_PARALLEL_MAGIC ) && memcmp( zStream.next_in, SGF_PARALLEL_MAGIC, sizeof( SGF_PARALLEL_MAGIC ) ) == 0 ) {
+			streamFormat = STREAM_PARALLEL;
+			zStream.next_in += sizeof( SGF_PARALLEL_MAGIC );
+			zStream.avail_in -= sizeof( SGF_PARALLEL_MAGIC );
+			AllocParallelBlocks( false );
+		} else {
+			streamFormat = STREAM_DEFLATE;
+		}
+	}
+
+	if ( streamFormat == STREAM_PARALLEL ) {
+		DecompressParallelBlock();
+		return;
+	}
+
 	assert( ( uncompressedProducedBytes & ( UNCOMPRESSED_BLOCK_SIZE - 1 ) ) == 0 );
 	zStream.next_out = (Bytef * )&uncompressed[ uncompressedProducedBytes & ( UNCOMPRESSED_BUFFER_SIZE - 1 ) ];
 	zStream.avail_out = UNCOMPRESSED_BLOCK_SIZE;
 
 	while( zStream.avail_out > 0 ) {
 		if ( zStream.avail_in == 0 ) {
-			do {
-				PumpCompressedBlock();
-				if ( bytesIO == 0 && nativeFileEndHit ) {
-					// don't try to decompress any more if there is no more data
-					zStreamEndHit = true;
-					return;
-				}
-			} while ( bytesIO == 0 );
-
-			zStream.next_in = (Bytef *) dataIO;
-			zStream.avail_in = (uInt) bytesIO;
-
-			dataIO = NULL;
-			bytesIO = 0;
-
-			if ( sgf_checksums.GetBool() ) {
-				if ( sgf_testCorruption.GetInteger() == numChecksums ) {
-					zStream.next_in[0] ^= 0xFF;
-				}
-				zStream.avail_in -= sizeof( uint32 );
-				uint32 checksum = MD5_BlockChecksum( zStream.next_in, zStream.avail_in );
-				if (	!verify( zStream.next_in[zStream.avail_in + 0] == ( ( checksum >>  0 ) & 0xFF ) ) ||
-						!verify( zStream.next_in[zStream.avail_in + 1] == ( ( checksum >>  8 ) & 0xFF ) ) ||
-						!verify( zStream.next_in[zStream.avail_in + 2] == ( ( checksum >> 16 ) & 0xFF ) ) ||
-						!verify( zStream.next_in[zStream.avail_in + 3] == ( ( checksum >> 24 ) & 0xFF ) ) ) {
-					// don't try to decompress any more if the checksum is wrong
-					zStreamEndHit = true;
-					return;
-				}
-				numChecksums++;
+			if ( !FetchCompressed() ) {
+				zStreamEndHit = true;
+				return;
 			}
 		}
 
@@ -1043,10 +1627,14 @@ TestProcessFile
 ============================
 */
 static void TestProcessFile( const char * const filename ) {
-	idLib::Printf( "Processing %s:\n", filename );
+	idLib::Printf( "Processing %s with %s:\n", filename, ( sgf_parallelBlocks.GetInteger() > 0 ) ? va( "%i parallel blocks", sgf_parallelBlocks.GetInteger() ) : "a single stream" );
 	// load some test data
 	void *testData;
 	const int testDataLength = fileSystem->ReadFile( filename, &testData, NULL );
+	if ( testDataLength <= 0 ) {
+		idLib::Printf( "Couldn't load %s.\n", filename );
+		return;
+	}
 
 	const char * const outFileName = "junk/savegameTest.bin";
 	idFile_SaveGamePipelined *saveFile = new (TAG_IDFILE) idFile_SaveGamePipelined;
@@ -1061,8 +1649,8 @@ static void TestProcessFile( const char * const filename ) {
 	const uint64 endWriteMicroseconds = Sys_Microseconds();
 	const uint64 writeMicroseconds = endWriteMicroseconds - startWriteMicroseconds;
 
-	idLib::Printf( "%lld microseconds to compress %i bytes to %i written bytes = %4.1f MB/s\n", 
-		writeMicroseconds, testDataLength, readDataLength, (float)readDataLength / writeMicroseconds );
+	idLib::Printf( "%lld microseconds to compress %i bytes to %i written bytes (%4.1f%%) = %4.1f MB/s\n", 
+		writeMicroseconds, testDataLength, readDataLength, 100.0f * readDataLength / testDataLength, (float)testDataLength / writeMicroseconds );
 
 	void * readData = (void *)Mem_Alloc( testDataLength, TAG_SAVEGAMES );
 
@@ -1099,9 +1687,17 @@ static void TestProcessFile( const char * const filename ) {
 TestSaveGameFile
 ============================
 */
-CONSOLE_COMMAND( TestSaveGameFile, "Exercises the pipelined savegame code", 0 ) {
+CONSOLE_COMMAND( TestSaveGameFile, "Exercises the pipelined savegame code, optionally on a given file such as a late game save", 0 ) {
 #if 1
-	TestProcessFile( "maps/game/wasteland1/wasteland1.map" );
+	const char * const filename = ( args.Argc() > 1 ) ? args.Argv( 1 ) : "maps/game/wasteland1/wasteland1.map";
+
+	// compare the single zlib stream against blocks compressed on the job threads
+	const int parallelBlocks = sgf_parallelBlocks.GetInteger();
+	sgf_parallelBlocks.SetInteger( 0 );
+	TestProcessFile( filename );
+	sgf_parallelBlocks.SetInteger( ( parallelBlocks > 0 ) ? parallelBlocks : idFile_SaveGamePipelined::MAX_PARALLEL_BLOCKS / 2 );
+	TestProcessFile( filename );
+	sgf_parallelBlocks.SetInteger( parallelBlocks );
 #else
 	// test every file in base (found a fencepost error >100 files in originally!)
 	idFileList * fileList = fileSystem->ListFiles( "", "" );
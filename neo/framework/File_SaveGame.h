@@ -81,6 +81,8 @@ class idSGFreadThread;
 class idSGFwriteThread;
 class idSGFdecompressThread;
 class idSGFcompressThread;
+class idParallelJobList;
+struct sgfParallelBlock_t;
 
 struct blockForIO_t {
 	byte *		data;
@@ -96,6 +98,10 @@ public:
 	static const int COMPRESSED_BLOCK_SIZE		= 128 * 1024;
 	static const int UNCOMPRESSED_BLOCK_SIZE	= 256 * 1024;
 
+	// Uncompressed blocks can also be compressed as independent zlib streams, a group
+	// of them at a time, on the job threads.  The stream then starts with a marker so
+	// files written with a single zlib stream can still be read.
+	static const int MAX_PARALLEL_BLOCKS		= 8;
 
 							idFile_SaveGamePipelined();
 	virtual					~idFile_SaveGamePipelined();
@@ -219,6 +225,26 @@ private:
 	// The background threads and signals for NextWriteBlock() and NextReadBlock().
 	//------------------------
 
+	//------------------------
+	// These variables are used when blocks are compressed or decompressed on the job threads.
+	//------------------------
+
+	enum streamFormat_t {
+		STREAM_UNKNOWN,			// not read yet
+		STREAM_DEFLATE,			// a single zlib stream
+		STREAM_PARALLEL			// a zlib stream per uncompressed block
+	};
+
+	streamFormat_t			streamFormat;
+	int						numParallelBlocks;		// blocks in each group
+	sgfParallelBlock_t *	parallelBlocks[2];		// one group is filled or drained while the other is in flight
+	idParallelJobList *		parallelJobs[2];
+	int						parallelGroupBlocks[2];
+	int						parallelGroup;
+	int						parallelBlock;
+	bool					parallelStreamEndHit;
+	uint64					startMicroseconds;
+
 	idSGFreadThread *		readThread;
 	idSGFwriteThread *		writeThread;
 
@@ -247,6 +273,20 @@ private:
 	void					PumpCompressedBlock();
 	void					DecompressBlock();
 	void					ReadBlock();
+
+	void					AllocParallelJobs();
+	void					AllocParallelBlocks( bool forWriting );
+	void					FreeParallelBlocks();
+	void					WaitParallelBlocks();
+	void					FlushParallelGroup( bool finish );
+	void					EmitParallelGroup( int group );
+	void					EmitCompressed( const void * data, size_t bytes );
+	void					FinishCompressedBlock();
+	bool					FetchCompressed();
+	bool					ReadCompressed( void * data, size_t bytes );
+	void					FillParallelGroup( int group );
+	void					DecompressParallelBlock();
+	void					PrintStats() const;
 };
 
 #endif // !__FILE_SAVEGAME_H__
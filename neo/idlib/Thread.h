@@ -116,6 +116,9 @@ public:
 	// atomically subtracts a value from the integer and returns the new value
 	int					Sub( int v ) { return Sys_InterlockedSub( value, (interlockedInt_t) v ); }
 
+	// atomically sets the integer to exchange if it equals comparand and returns the previous value
+	int					CompareExchange( int comparand, int exchange ) { return Sys_InterlockedCompareExchange( value, (interlockedInt_t) comparand, (interlockedInt_t) exchange ); }
+
 	// returns the current value of the integer
 	int					GetValue() const { return value; }
 
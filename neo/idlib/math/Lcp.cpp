@@ -1787,21 +1787,20 @@ void idLCP_Square::AddClamped( int r ) {
 
 	Swap( numClamped, r );
 
-	// add row to L
-	for ( int i = 0; i < numClamped; i++ ) {
-		float sum = rowPtrs[numClamped][i];
-		for ( int j = 0; j < i; j++ ) {
-			sum -= clamped[numClamped][j] * clamped[j][i];
-		}
-		clamped[numClamped][i] = sum * diagonal[i];
+	// add row to L, as soon as an element is final it is subtracted from the
+	// rest of the row so the inner loop runs over contiguous memory
+	float * row = clamped[numClamped];
+	memcpy( row, rowPtrs[numClamped], numClamped * sizeof( float ) );
+	for ( int j = 0; j < numClamped; j++ ) {
+		row[j] *= diagonal[j];
+		MultiplyAdd( row + j + 1, -row[j], clamped[j] + j + 1, numClamped - j - 1 );
 	}
 
-	// add column to U
+	// add column to U, the column is gathered in a contiguous buffer for the dot products
+	float * column = (float *) _alloca16( ( ( numClamped + 4 ) & ~3 ) * sizeof( float ) );
 	for ( int i = 0; i <= numClamped; i++ ) {
-		float sum = rowPtrs[i][numClamped];
-		for ( int j = 0; j < i; j++ ) {
-			sum -= clamped[i][j] * clamped[j][numClamped];
-		}
+		float sum = rowPtrs[i][numClamped] - BigDotProduct( clamped[i], column, i );
+		column[i] = sum;
 		clamped[i][numClamped] = sum;
 	}
 
@@ -1868,9 +1867,7 @@ void idLCP_Square::RemoveClamped( int r ) {
 		float beta1 = z1[i] * diagonal[i];
 
 		clamped[i][r] += p0;
-		for ( int j = i+1; j < numClamped; j++ ) {
-			z1[j] -= beta1 * clamped[i][j];
-		}
+		MultiplyAdd( z1 + i + 1, -beta1, clamped[i] + i + 1, numClamped - i - 1 );
 		for ( int j = i+1; j < numClamped; j++ ) {
 			y0[j] -= p0 * clamped[j][i];
 		}
@@ -1907,9 +1904,16 @@ void idLCP_Square::RemoveClamped( int r ) {
 		clamped[i][i] = diag;
 		diagonal[i] = d;
 
-		for ( int j = i+1; j < numClamped; j++ ) {
+		float * rowPtr = clamped[i];
+		int j = i + 1;
+
+#ifdef ID_WIN_X86_SSE_INTRIN
 
-			d = clamped[i][j];
+		// align on the row, the update vectors are only 16 byte aligned
+		// when the number of columns is a multiple of four
+		for ( ; ( (UINT_PTR)( rowPtr + j ) & 0xF ) != 0 && j < numClamped; j++ ) {
+
+			d = rowPtr[j];
 
 			d += p0 * z0[j];
 			z0[j] -= beta0 * d;
@@ -1917,10 +1921,45 @@ void idLCP_Square::RemoveClamped( int r ) {
 			d += q0 * z1[j];
 			z1[j] -= beta1 * d;
 
-			clamped[i][j] = d;
+			rowPtr[j] = d;
 		}
 
-		for ( int j = i+1; j < numClamped; j++ ) {
+		const __m128 vp0 = _mm_set1_ps( p0 );
+		const __m128 vq0 = _mm_set1_ps( q0 );
+		const __m128 vbeta0 = _mm_set1_ps( beta0 );
+		const __m128 vbeta1 = _mm_set1_ps( beta1 );
+		for ( ; j + 4 <= numClamped; j += 4 ) {
+			__m128 vd = _mm_load_ps( rowPtr + j );
+			__m128 vz0 = _mm_loadu_ps( z0 + j );
+			__m128 vz1 = _mm_loadu_ps( z1 + j );
+
+			vd = _mm_add_ps( vd, _mm_mul_ps( vp0, vz0 ) );
+			vz0 = _mm_sub_ps( vz0, _mm_mul_ps( vbeta0, vd ) );
+
+			vd = _mm_add_ps( vd, _mm_mul_ps( vq0, vz1 ) );
+			vz1 = _mm_sub_ps( vz1, _mm_mul_ps( vbeta1, vd ) );
+
+			_mm_storeu_ps( z0 + j, vz0 );
+			_mm_storeu_ps( z1 + j, vz1 );
+			_mm_store_ps( rowPtr + j, vd );
+		}
+
+#endif
+
+		for ( ; j < numClamped; j++ ) {
+
+			d = rowPtr[j];
+
+			d += p0 * z0[j];
+			z0[j] -= beta0 * d;
+
+			d += q0 * z1[j];
+			z1[j] -= beta1 * d;
+
+			rowPtr[j] = d;
+		}
+
+		for ( j = i+1; j < numClamped; j++ ) {
 
 			d = clamped[j][i];
 
@@ -2527,10 +2566,7 @@ void idLCP_Symmetric::RemoveClamped( int r ) {
 			} else {
 				sum = clamped[r][r] * clamped[i][r];
 			}
-			float * ptr = clamped[i];
-			for ( int j = 0; j < r; j++ ) {
-				sum += ptr[j] * v[j];
-			}
+			sum += BigDotProduct( clamped[i], v, r );
 			addSub[i] = rowPtrs[r][i] - sum;
 		}
 	}
@@ -2587,8 +2623,40 @@ void idLCP_Symmetric::RemoveClamped( int r ) {
 		// update column below diagonal (i,i)
 		float * ptr = clamped.ToFloatPtr() + i;
 
-		int j;
-		for ( j = i+1; j < numClamped - 1; j += 2 ) {
+		int j = i+1;
+
+#ifdef ID_WIN_X86_SSE_INTRIN
+
+		// the rows below the diagonal are independent, update four at a time
+		const __m128 vp1 = _mm_set1_ps( p1 );
+		const __m128 vp2 = _mm_set1_ps( p2 );
+		const __m128 vbeta1 = _mm_set1_ps( beta1 );
+		const __m128 vbeta2 = _mm_set1_ps( beta2 );
+		for ( ; j + 4 <= numClamped; j += 4 ) {
+			__m128 sum = _mm_setr_ps( ptr[(j+0)*n], ptr[(j+1)*n], ptr[(j+2)*n], ptr[(j+3)*n] );
+			__m128 vv1 = _mm_loadu_ps( v1 + j );
+			__m128 vv2 = _mm_loadu_ps( v2 + j );
+
+			vv1 = _mm_sub_ps( vv1, _mm_mul_ps( vp1, sum ) );
+			sum = _mm_add_ps( sum, _mm_mul_ps( vbeta1, vv1 ) );
+
+			vv2 = _mm_sub_ps( vv2, _mm_mul_ps( vp2, sum ) );
+			sum = _mm_add_ps( sum, _mm_mul_ps( vbeta2, vv2 ) );
+
+			_mm_storeu_ps( v1 + j, vv1 );
+			_mm_storeu_ps( v2 + j, vv2 );
+
+			ALIGN16( float s[4] );
+			_mm_store_ps( s, sum );
+			ptr[(j+0)*n] = s[0];
+			ptr[(j+1)*n] = s[1];
+			ptr[(j+2)*n] = s[2];
+			ptr[(j+3)*n] = s[3];
+		}
+
+#endif
+
+		for ( ; j < numClamped - 1; j += 2 ) {
 
 			float sum0 = ptr[(j+0)*n];
 			float sum1 = ptr[(j+1)*n];
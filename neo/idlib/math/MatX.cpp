@@ -36,8 +36,8 @@ If you have questions concerning this license or the applicable additional terms
 //===============================================================
 
 float	idMatX::temp[MATX_MAX_TEMP+4];
-float *	idMatX::tempPtr = (float *) ( ( (int) idMatX::temp + 15 ) & ~15 );
-int		idMatX::tempIndex = 0;
+idMatX::tempMemory_t	idMatX::defaultTempMemory = { (float *) ( ( (UINT_PTR) idMatX::temp + 15 ) & ~15 ), 0 };
+ID_TLS	idMatX::threadTempMemory;
 
 
 /*
@@ -36,7 +36,9 @@ idMatX - arbitrary sized dense real matrix
 
 The matrix lives on 16 byte aligned and 16 byte padded memory.
 
-NOTE: due to the temporary memory pool idMatX cannot be used by multiple threads.
+NOTE: due to the temporary memory pool idMatX cannot be used by multiple threads
+unless each thread other than the main thread sets its own pool with
+idScopedMathTempMemory.
 
 ===============================================================================
 */
@@ -239,6 +241,17 @@ public:
 
 	static void		Test();
 
+	// pool of temporary memory used to store intermediate results
+	typedef struct tempMemory_s {
+		float *		ptr;					// pointer to 16 byte aligned temporary memory
+		int			index;					// index into memory pool, wraps around
+	} tempMemory_t;
+
+	static ID_INLINE tempMemory_t &	GetTempMemory();
+	// sets the pool used by the calling thread, NULL selects the default pool, returns the previous pool
+	static ID_INLINE tempMemory_t *	SetThreadTempMemory( tempMemory_t * tempMemory );
+	static ID_INLINE bool			IsTempMemory( const float * ptr );
+
 private:
 	int				numRows;				// number of rows
 	int				numColumns;				// number of columns
@@ -246,8 +259,8 @@ private:
 	float *			mat;					// memory the matrix is stored
 
 	static float	temp[MATX_MAX_TEMP+4];	// used to store intermediate results
-	static float *	tempPtr;				// pointer to 16 byte aligned temporary memory
-	static int		tempIndex;				// index into memory pool, wraps around
+	static tempMemory_t	defaultTempMemory;	// temporary memory used by threads without their own pool
+	static ID_TLS	threadTempMemory;		// temporary memory of the current thread, 0 if default
 
 private:
 	void			SetTempSize( int rows, int columns );
@@ -264,6 +277,37 @@ private:
 	bool			HessenbergToRealSchur( idMatX &H, idVecX &realEigenValues, idVecX &imaginaryEigenValues );
 };
 
+/*
+========================
+idMatX::GetTempMemory
+========================
+*/
+ID_INLINE idMatX::tempMemory_t & idMatX::GetTempMemory() {
+	tempMemory_t * tempMemory = (tempMemory_t *) (ptrdiff_t) threadTempMemory;
+	return ( tempMemory != NULL ) ? *tempMemory : defaultTempMemory;
+}
+
+/*
+========================
+idMatX::SetThreadTempMemory
+========================
+*/
+ID_INLINE idMatX::tempMemory_t * idMatX::SetThreadTempMemory( tempMemory_t * tempMemory ) {
+	tempMemory_t * previous = (tempMemory_t *) (ptrdiff_t) threadTempMemory;
+	threadTempMemory = (ptrdiff_t) tempMemory;
+	return previous;
+}
+
+/*
+========================
+idMatX::IsTempMemory
+========================
+*/
+ID_INLINE bool idMatX::IsTempMemory( const float * ptr ) {
+	const tempMemory_t & tempMemory = GetTempMemory();
+	return ( ptr >= tempMemory.ptr && ptr < tempMemory.ptr + MATX_MAX_TEMP );
+}
+
 /*
 ========================
 idMatX::idMatX
@@ -281,7 +325,7 @@ idMatX::~idMatX
 */
 ID_INLINE idMatX::~idMatX() {
 	// if not temp memory
-	if ( mat != NULL && ( mat < idMatX::tempPtr || mat > idMatX::tempPtr + MATX_MAX_TEMP ) && alloced != -1 ) {
+	if ( mat != NULL && !idMatX::IsTempMemory( mat ) && alloced != -1 ) {
 		Mem_Free16( mat );
 	}
 }
@@ -396,7 +440,7 @@ ID_INLINE idMatX &idMatX::operator=( const idMatX &a ) {
 #else
 	memcpy( mat, a.mat, s * sizeof( float ) );
 #endif
-	idMatX::tempIndex = 0;
+	idMatX::GetTempMemory().index = 0;
 	return *this;
 }
 
@@ -514,7 +558,7 @@ ID_INLINE idMatX &idMatX::operator*=( const float a ) {
 		mat[i] *= a;
 	}
 #endif
-	idMatX::tempIndex = 0;
+	idMatX::GetTempMemory().index = 0;
 	return *this;
 }
 
@@ -525,7 +569,7 @@ idMatX::operator*=
 */
 ID_INLINE idMatX &idMatX::operator*=( const idMatX &a ) {
 	*this = *this * a;
-	idMatX::tempIndex = 0;
+	idMatX::GetTempMemory().index = 0;
 	return *this;
 }
 
@@ -546,7 +590,7 @@ ID_INLINE idMatX &idMatX::operator+=( const idMatX &a ) {
 		mat[i] += a.mat[i];
 	}
 #endif
-	idMatX::tempIndex = 0;
+	idMatX::GetTempMemory().index = 0;
 	return *this;
 }
 
@@ -567,7 +611,7 @@ ID_INLINE idMatX &idMatX::operator-=( const idMatX &a ) {
 		mat[i] -= a.mat[i];
 	}
 #endif
-	idMatX::tempIndex = 0;
+	idMatX::GetTempMemory().index = 0;
 	return *this;
 }
 
@@ -658,7 +702,7 @@ idMatX::SetSize
 */
 ID_INLINE void idMatX::SetSize( int rows, int columns ) {
 	if ( rows != numRows || columns != numColumns || mat == NULL ) {
-		assert( mat < idMatX::tempPtr || mat > idMatX::tempPtr + MATX_MAX_TEMP );
+		assert( !idMatX::IsTempMemory( mat ) );
 		int alloc = ( rows * columns + 3 ) & ~3;
 		if ( alloc > alloced && alloced != -1 ) {
 			if ( mat != NULL ) {
@@ -683,11 +727,12 @@ ID_INLINE void idMatX::SetTempSize( int rows, int columns ) {
 
 	newSize = ( rows * columns + 3 ) & ~3;
 	assert( newSize < MATX_MAX_TEMP );
-	if ( idMatX::tempIndex + newSize > MATX_MAX_TEMP ) {
-		idMatX::tempIndex = 0;
+	tempMemory_t & tempMemory = idMatX::GetTempMemory();
+	if ( tempMemory.index + newSize > MATX_MAX_TEMP ) {
+		tempMemory.index = 0;
 	}
-	mat = idMatX::tempPtr + idMatX::tempIndex;
-	idMatX::tempIndex += newSize;
+	mat = tempMemory.ptr + tempMemory.index;
+	tempMemory.index += newSize;
 	alloced = newSize;
 	numRows = rows;
 	numColumns = columns;
@@ -700,7 +745,7 @@ idMatX::SetData
 ========================
 */
 ID_INLINE void idMatX::SetData( int rows, int columns, float *data ) {
-	assert( mat < idMatX::tempPtr || mat > idMatX::tempPtr + MATX_MAX_TEMP );
+	assert( !idMatX::IsTempMemory( mat ) );
 	if ( mat != NULL && alloced != -1 ) {
 		Mem_Free16( mat );
 	}
@@ -1568,4 +1613,55 @@ ID_INLINE float *idMatX::ToFloatPtr() {
 	return mat;
 }
 
+/*
+===============================================================================
+
+idScopedMathTempMemory
+
+Gives the calling thread its own idVecX and idMatX temporary memory pools for
+the lifetime of the object. Code running on job threads concurrently with the
+main thread declares one of these on the stack before using idVecX or idMatX.
+The object is about 8kB so job stacks must have room for it.
+
+===============================================================================
+*/
+
+class idScopedMathTempMemory {
+public:
+					idScopedMathTempMemory();
+					~idScopedMathTempMemory();
+
+private:
+	ALIGN16( float	vecXTemp[VECX_MAX_TEMP] );
+	ALIGN16( float	matXTemp[MATX_MAX_TEMP] );
+	idVecX::tempMemory_t	vecXTempMemory;
+	idMatX::tempMemory_t	matXTempMemory;
+	idVecX::tempMemory_t *	prevVecXTempMemory;
+	idMatX::tempMemory_t *	prevMatXTempMemory;
+};
+
+/*
+========================
+idScopedMathTempMemory::idScopedMathTempMemory
+========================
+*/
+ID_INLINE idScopedMathTempMemory::idScopedMathTempMemory() {
+	vecXTempMemory.ptr = vecXTemp;
+	vecXTempMemory.index = 0;
+	matXTempMemory.ptr = matXTemp;
+	matXTempMemory.index = 0;
+	prevVecXTempMemory = idVecX::SetThreadTempMemory( &vecXTempMemory );
+	prevMatXTempMemory = idMatX::SetThreadTempMemory( &matXTempMemory );
+}
+
+/*
+========================
+idScopedMathTempMemory::~idScopedMathTempMemory
+========================
+*/
+ID_INLINE idScopedMathTempMemory::~idScopedMathTempMemory() {
+	idVecX::SetThreadTempMemory( prevVecXTempMemory );
+	idMatX::SetThreadTempMemory( prevMatXTempMemory );
+}
+
 #endif // !__MATH_MATRIXX_H__
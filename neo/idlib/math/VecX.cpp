@@ -36,8 +36,8 @@ If you have questions concerning this license or the applicable additional terms
 //===============================================================
 
 float	idVecX::temp[VECX_MAX_TEMP+4];
-float *	idVecX::tempPtr = (float *) ( ( (int) idVecX::temp + 15 ) & ~15 );
-int		idVecX::tempIndex = 0;
+idVecX::tempMemory_t	idVecX::defaultTempMemory = { (float *) ( ( (UINT_PTR) idVecX::temp + 15 ) & ~15 ), 0 };
+ID_TLS	idVecX::threadTempMemory;
 
 /*
 =============
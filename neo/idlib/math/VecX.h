@@ -37,6 +37,8 @@ idVecX - arbitrary sized vector
 The vector lives on 16 byte aligned and 16 byte padded memory.
 
 NOTE: due to the temporary memory pool idVecX cannot be used by multiple threads
+unless each thread other than the main thread sets its own pool with
+idScopedMathTempMemory
 
 ===============================================================================
 */
@@ -109,18 +111,60 @@ public:
 	ID_INLINE	float *			ToFloatPtr();
 	const char *	ToString( int precision = 2 ) const;
 
+	// pool of temporary memory used to store intermediate results
+	typedef struct tempMemory_s {
+		float *		ptr;					// pointer to 16 byte aligned temporary memory
+		int			index;					// index into memory pool, wraps around
+	} tempMemory_t;
+
+	static ID_INLINE tempMemory_t &	GetTempMemory();
+	// sets the pool used by the calling thread, NULL selects the default pool, returns the previous pool
+	static ID_INLINE tempMemory_t *	SetThreadTempMemory( tempMemory_t * tempMemory );
+	static ID_INLINE bool			IsTempMemory( const float * ptr );
+
 private:
 	int				size;					// size of the vector
 	int				alloced;				// if -1 p points to data set with SetData
 	float *			p;						// memory the vector is stored
 
 	static float	temp[VECX_MAX_TEMP+4];	// used to store intermediate results
-	static float *	tempPtr;				// pointer to 16 byte aligned temporary memory
-	static int		tempIndex;				// index into memory pool, wraps around
+	static tempMemory_t	defaultTempMemory;	// temporary memory used by threads without their own pool
+	static ID_TLS	threadTempMemory;		// temporary memory of the current thread, 0 if default
 
 	ID_INLINE void	SetTempSize( int size );
 };
 
+/*
+========================
+idVecX::GetTempMemory
+========================
+*/
+ID_INLINE idVecX::tempMemory_t & idVecX::GetTempMemory() {
+	tempMemory_t * tempMemory = (tempMemory_t *) (ptrdiff_t) threadTempMemory;
+	return ( tempMemory != NULL ) ? *tempMemory : defaultTempMemory;
+}
+
+/*
+========================
+idVecX::SetThreadTempMemory
+========================
+*/
+ID_INLINE idVecX::tempMemory_t * idVecX::SetThreadTempMemory( tempMemory_t * tempMemory ) {
+	tempMemory_t * previous = (tempMemory_t *) (ptrdiff_t) threadTempMemory;
+	threadTempMemory = (ptrdiff_t) tempMemory;
+	return previous;
+}
+
+/*
+========================
+idVecX::IsTempMemory
+========================
+*/
+ID_INLINE bool idVecX::IsTempMemory( const float * ptr ) {
+	const tempMemory_t & tempMemory = GetTempMemory();
+	return ( ptr >= tempMemory.ptr && ptr < tempMemory.ptr + VECX_MAX_TEMP );
+}
+
 
 /*
 ========================
@@ -161,7 +205,7 @@ idVecX::~idVecX
 */
 ID_INLINE idVecX::~idVecX() {
 	// if not temp memory
-	if ( p && ( p < idVecX::tempPtr || p >= idVecX::tempPtr + VECX_MAX_TEMP ) && alloced != -1 ) {
+	if ( p && !idVecX::IsTempMemory( p ) && alloced != -1 ) {
 		Mem_Free16( p );
 	}
 }
@@ -240,7 +284,7 @@ ID_INLINE idVecX &idVecX::operator=( const idVecX &a ) {
 #else
 	memcpy( p, a.p, a.size * sizeof( float ) );
 #endif
-	idVecX::tempIndex = 0;
+	idVecX::GetTempMemory().index = 0;
 	return *this;
 }
 
@@ -304,7 +348,7 @@ ID_INLINE idVecX &idVecX::operator+=( const idVecX &a ) {
 		p[i] += a.p[i];
 	}
 #endif
-	idVecX::tempIndex = 0;
+	idVecX::GetTempMemory().index = 0;
 	return *this;
 }
 
@@ -324,7 +368,7 @@ ID_INLINE idVecX &idVecX::operator-=( const idVecX &a ) {
 		p[i] -= a.p[i];
 	}
 #endif
-	idVecX::tempIndex = 0;
+	idVecX::GetTempMemory().index = 0;
 	return *this;
 }
 
@@ -467,7 +511,7 @@ idVecX::SetSize
 ========================
 */
 ID_INLINE void idVecX::SetSize( int newSize ) {
-	//assert( p < idVecX::tempPtr || p > idVecX::tempPtr + VECX_MAX_TEMP );
+	//assert( !idVecX::IsTempMemory( p ) );
 	if ( newSize != size || p == NULL ) {
 		int alloc = ( newSize + 3 ) & ~3;
 		if ( alloc > alloced && alloced != -1 ) {
@@ -521,11 +565,12 @@ ID_INLINE void idVecX::SetTempSize( int newSize ) {
 	size = newSize;
 	alloced = ( newSize + 3 ) & ~3;
 	assert( alloced < VECX_MAX_TEMP );
-	if ( idVecX::tempIndex + alloced > VECX_MAX_TEMP ) {
-		idVecX::tempIndex = 0;
+	tempMemory_t & tempMemory = idVecX::GetTempMemory();
+	if ( tempMemory.index + alloced > VECX_MAX_TEMP ) {
+		tempMemory.index = 0;
 	}
-	p = idVecX::tempPtr + idVecX::tempIndex;
-	idVecX::tempIndex += alloced;
+	p = tempMemory.ptr + tempMemory.index;
+	tempMemory.index += alloced;
 	VECX_CLEAREND();
 }
 
@@ -535,7 +580,7 @@ idVecX::SetData
 ========================
 */
 ID_INLINE void idVecX::SetData( int length, float *data ) {
-	if ( p != NULL && ( p < idVecX::tempPtr || p >= idVecX::tempPtr + VECX_MAX_TEMP ) && alloced != -1 ) {
+	if ( p != NULL && !idVecX::IsTempMemory( p ) && alloced != -1 ) {
 		Mem_Free16( p );
 	}
 	assert_16_byte_aligned( data ); // data must be 16 byte aligned
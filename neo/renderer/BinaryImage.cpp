@@ -41,10 +41,179 @@ If you have questions concerning this license or the applicable additional terms
 #include "color/ColorSpace.h"
 
 idCVar image_highQualityCompression( "image_highQualityCompression", "0", CVAR_BOOL, "Use high quality (slow) compression" );
+idCVar image_parallelBuild( "image_parallelBuild", "1", CVAR_BOOL, "Filter mip levels and DXT compress images in row bands on the job threads" );
+
+static const int IMAGE_BUILD_MIN_BAND_PIXELS	= 64 * 64;		// levels are only split into bands of at least this many texels
+static const int IMAGE_BUILD_MAX_BANDS			= 32;			// per level
+static const int IMAGE_BUILD_MAX_LEVELS			= 16;
+
+struct imageMipBand_t {
+	const byte *		in;
+	byte *				out;
+	int					width;			// of the source level
+	int					height;
+	int					firstRow;		// of the destination level
+	int					numRows;
+	bool				gamma;
+};
+
+struct imageCompressBand_t {
+	const byte *		in;
+	byte *				out;
+	int					width;
+	int					height;			// rows in this band, a multiple of four unless the whole level is smaller
+	textureFormat_t		format;
+	textureColor_t		colorFormat;
+	bool				highQuality;
+};
+
+/*
+========================
+R_MipMapBand
+========================
+*/
+static void R_MipMapBand( const imageMipBand_t * band ) {
+	if ( band->gamma ) {
+		R_MipMapWithGammaRows( band->in, band->width, band->height, band->out, band->firstRow, band->numRows );
+	} else {
+		R_MipMapRows( band->in, band->width, band->height, band->out, band->firstRow, band->numRows );
+	}
+}
+
+REGISTER_PARALLEL_JOB( R_MipMapBand, "R_MipMapBand" );
+
+/*
+========================
+R_CompressImageBand
+
+Each band gets its own encoder, so bands of the same level can be compressed in parallel.
+========================
+*/
+static void R_CompressImageBand( const imageCompressBand_t * band ) {
+	idDxtEncoder dxt;
+	if ( band->format == FMT_DXT1 ) {
+		if ( band->highQuality ) {
+			dxt.CompressImageDXT1HQ( band->in, band->out, band->width, band->height );
+		} else {
+			dxt.CompressImageDXT1Fast( band->in, band->out, band->width, band->height );
+		}
+	} else if ( band->format == FMT_BC5 ) {
+		if ( band->highQuality ) {
+			dxt.CompressNormalMapDXN2HQ( band->in, band->out, band->width, band->height );
+		} else {
+			dxt.CompressNormalMapDXN2Fast( band->in, band->out, band->width, band->height );
+		}
+	} else if ( band->format == FMT_BC7 ) {
+		if ( band->highQuality ) {
+			dxt.CompressImageBC7HQ( band->in, band->out, band->width, band->height );
+		} else {
+			dxt.CompressImageBC7Fast( band->in, band->out, band->width, band->height );
+		}
+	} else if ( band->colorFormat == CFM_NORMAL_DXT5 ) {
+		if ( band->highQuality ) {
+			dxt.CompressNormalMapDXT5HQ( band->in, band->out, band->width, band->height );
+		} else {
+			dxt.CompressNormalMapDXT5Fast( band->in, band->out, band->width, band->height );
+		}
+	} else if ( band->colorFormat == CFM_YCOCG_DXT5 ) {
+		if ( band->highQuality ) {
+			dxt.CompressYCoCgDXT5HQ( band->in, band->out, band->width, band->height );
+		} else {
+			dxt.CompressYCoCgDXT5Fast( band->in, band->out, band->width, band->height );
+		}
+	} else {
+		if ( band->highQuality ) {
+			dxt.CompressImageDXT5HQ( band->in, band->out, band->width, band->height );
+		} else {
+			dxt.CompressImageDXT5Fast( band->in, band->out, band->width, band->height );
+		}
+	}
+}
+
+REGISTER_PARALLEL_JOB( R_CompressImageBand, "R_CompressImageBand" );
+
+/*
+========================
+R_NumImageBands
+
+Returns the number of bands a level of the given size is split into. The bands
+are a multiple of rowAlign rows high.
+========================
+*/
+static int R_NumImageBands( int width, int height, int rowAlign ) {
+	const int maxBands = Min( IMAGE_BUILD_MAX_BANDS, Max( parallelJobManager->GetNumProcessingUnits(), 1 ) * 2 );
+	const int bandRows = Max( rowAlign, ( IMAGE_BUILD_MIN_BAND_PIXELS / Max( width, 1 ) + rowAlign - 1 ) / rowAlign * rowAlign );
+	return idMath::ClampInt( 1, maxBands, height / bandRows );
+}
+
+/*
+========================
+R_BuildMipLevel
+
+Returns the next mip level of a width x height image. With a job list, large levels
+are filtered in row bands on the job threads.
+========================
+*/
+static byte * R_BuildMipLevel( const byte * in, int width, int height, bool gammaMips, idParallelJobList * jobList ) {
+	const int newWidth = width >> 1;
+	const int newHeight = height >> 1;
+
+	const int numBands = ( jobList != NULL && newWidth > 0 && newHeight > 0 ) ? R_NumImageBands( newWidth, newHeight, 1 ) : 1;
+	if ( numBands <= 1 ) {
+		return gammaMips ? R_MipMapWithGamma( in, width, height ) : R_MipMap( in, width, height );
+	}
+
+	byte * out = (byte *)R_StaticAlloc( newWidth * newHeight * 4, TAG_IMAGE );
+
+	imageMipBand_t bands[IMAGE_BUILD_MAX_BANDS];
+	const int rowsPerBand = ( newHeight + numBands - 1 ) / numBands;
+	int numUsedBands = 0;
+	for ( int firstRow = 0; firstRow < newHeight; firstRow += rowsPerBand ) {
+		imageMipBand_t & band = bands[numUsedBands++];
+		band.in = in;
+		band.out = out;
+		band.width = width;
+		band.height = height;
+		band.firstRow = firstRow;
+		band.numRows = Min( rowsPerBand, newHeight - firstRow );
+		band.gamma = gammaMips;
+		jobList->AddJob( (jobRun_t)R_MipMapBand, &band );
+	}
+	jobList->Submit();
+	jobList->Wait();
+
+	return out;
+}
+
+/*
+========================
+R_AddCompressBands
+========================
+*/
+static void R_AddCompressBands( idList< imageCompressBand_t > & bands, const byte * in, byte * out, int width, int height, textureFormat_t format, textureColor_t colorFormat, bool parallel ) {
+	const int blockBytes = ( format == FMT_DXT1 ) ? 8 : 16;
+	const int numBands = ( parallel && width >= 4 && height >= 4 ) ? R_NumImageBands( width, height, 4 ) : 1;
+	const int rowsPerBand = ( ( height / 4 + numBands - 1 ) / numBands ) * 4;
+
+	for ( int firstRow = 0; firstRow < height; firstRow += rowsPerBand ) {
+		imageCompressBand_t & band = bands.Alloc();
+		band.in = in + firstRow * width * 4;
+		band.out = out + ( firstRow / 4 ) * ( width / 4 ) * blockBytes;
+		band.width = width;
+		band.height = Min( rowsPerBand, height - firstRow );
+		band.format = format;
+		band.colorFormat = colorFormat;
+		band.highQuality = image_highQualityCompression.GetBool();
+	}
+}
 
 /*
 ========================
 idBinaryImage::Load2DFromMemory
+
+All mip levels are filtered first and then compressed together. When image_parallelBuild
+is set, large levels are split into row bands that run on the job threads. The job threads
+produce exactly the same data as the serial build.
 ========================
 */
 void idBinaryImage::Load2DFromMemory( int width, int height, const byte * pic_const, int numLevels, textureFormat_t & textureFormat, textureColor_t & colorFormat, bool gammaMips ) {
@@ -62,8 +231,8 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte * pic_co
 		// convert the image data to YCoCg and use the YCoCgDXT5 compressor
 		idColorSpace::ConvertRGBToCoCg_Y( pic, pic, width, height );
 	} else if ( colorFormat == CFM_NORMAL_DXT5 ) {
-		// Blah, HQ swizzles automatically, Fast doesn't
-		if ( !image_highQualityCompression.GetBool() ) {
+		// Blah, HQ swizzles automatically, Fast doesn't, BC5 keeps X and Y in red and green
+		if ( !image_highQualityCompression.GetBool() && textureFormat != FMT_BC5 ) {
 			for ( int i = 0; i < width * height; i++ ) {
 				pic[i*4+3] = pic[i*4+0];
 				pic[i*4+0] = 0;
@@ -79,18 +248,42 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte * pic_co
 		}
 	}
 
+	if ( textureFormat == FMT_DXT5 && colorFormat != CFM_NORMAL_DXT5 && colorFormat != CFM_YCOCG_DXT5 ) {
+		fileData.colorFormat = colorFormat = CFM_DEFAULT;
+	}
+
+	// only the main thread may submit job lists
+	idParallelJobList * jobList = NULL;
+	if ( image_parallelBuild.GetBool() && idLib::IsMainThread() && numLevels <= IMAGE_BUILD_MAX_LEVELS && width * height >= IMAGE_BUILD_MIN_BAND_PIXELS * 2 ) {
+		jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_HIGH, IMAGE_BUILD_MAX_BANDS * IMAGE_BUILD_MAX_LEVELS, 0, NULL );
+	}
+
+	// filter all the mip levels up front, each level depends on the previous one
+	idList< byte * > levelPics;
+	levelPics.SetNum( numLevels );
+	levelPics[0] = pic;
+	for ( int level = 1, mipWidth = width, mipHeight = height; level < numLevels; level++ ) {
+		levelPics[level] = R_BuildMipLevel( levelPics[level - 1], mipWidth, mipHeight, gammaMips, jobList );
+		mipWidth = Max( 1, mipWidth >> 1 );
+		mipHeight = Max( 1, mipHeight >> 1 );
+	}
+
+	idList< imageCompressBand_t > compressBands;
+	idList< byte * > paddedPics;
+
 	int	scaledWidth = width;
 	int scaledHeight = height;
 	images.SetNum( numLevels );
 	for ( int level = 0; level < images.Num(); level++ ) {
 		idBinaryImageData &img = images[ level ];
+		pic = levelPics[ level ];
 
 		// Images that are going to be DXT compressed and aren't multiples of 4 need to be 
 		// padded out before compressing.
 		byte * dxtPic = pic;
 		int	dxtWidth = 0;
 		int	dxtHeight = 0;
-		if ( textureFormat == FMT_DXT5 || textureFormat == FMT_DXT1 ) {
+		if ( idImage::IsCompressedFormat( textureFormat ) ) {
 			if ( ( scaledWidth & 3 ) || ( scaledHeight & 3 ) ) {
 				dxtWidth = ( scaledWidth + 3 ) & ~3;
 				dxtHeight = ( scaledHeight + 3 ) & ~3;
@@ -98,6 +291,7 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte * pic_co
 				for ( int i = 0; i < scaledHeight; i++ ) {
 					memcpy( dxtPic + i*dxtWidth*4, pic + i*scaledWidth*4, scaledWidth*4 );
 				}
+				paddedPics.Append( dxtPic );
 			} else {
 				dxtPic = pic;
 				dxtWidth = scaledWidth;
@@ -112,36 +306,11 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte * pic_co
 
 		// compress data or convert floats as necessary
 		if ( textureFormat == FMT_DXT1 ) {
-			idDxtEncoder dxt;
 			img.Alloc( dxtWidth * dxtHeight / 2 );
-			if ( image_highQualityCompression.GetBool() ) {
-				dxt.CompressImageDXT1HQ( dxtPic, img.data, dxtWidth, dxtHeight );
-			} else {
-				dxt.CompressImageDXT1Fast( dxtPic, img.data, dxtWidth, dxtHeight );
-			}
-		} else if ( textureFormat == FMT_DXT5 ) {
-			idDxtEncoder dxt;
+			R_AddCompressBands( compressBands, dxtPic, img.data, dxtWidth, dxtHeight, textureFormat, colorFormat, jobList != NULL );
+		} else if ( textureFormat == FMT_DXT5 || textureFormat == FMT_BC5 || textureFormat == FMT_BC7 ) {
 			img.Alloc( dxtWidth * dxtHeight );
-			if ( colorFormat == CFM_NORMAL_DXT5 ) {
-				if ( image_highQualityCompression.GetBool() ) {
-					dxt.CompressNormalMapDXT5HQ( dxtPic, img.data, dxtWidth, dxtHeight );
-				} else {
-					dxt.CompressNormalMapDXT5Fast( dxtPic, img.data, dxtWidth, dxtHeight );
-				}
-			} else if ( colorFormat == CFM_YCOCG_DXT5 ) {
-				if ( image_highQualityCompression.GetBool() ) {
-					dxt.CompressYCoCgDXT5HQ( dxtPic, img.data, dxtWidth, dxtHeight );
-				} else {
-					dxt.CompressYCoCgDXT5Fast( dxtPic, img.data, dxtWidth, dxtHeight );
-				}
-			} else {
-				fileData.colorFormat = colorFormat = CFM_DEFAULT;
-				if ( image_highQualityCompression.GetBool() ) {
-					dxt.CompressImageDXT5HQ( dxtPic, img.data, dxtWidth, dxtHeight );
-				} else {
-					dxt.CompressImageDXT5Fast( dxtPic, img.data, dxtWidth, dxtHeight );
-				}
-			}
+			R_AddCompressBands( compressBands, dxtPic, img.data, dxtWidth, dxtHeight, textureFormat, colorFormat, jobList != NULL );
 		} else if ( textureFormat == FMT_LUM8 || textureFormat == FMT_INT8 ) {
 			// LUM8 and INT8 just read the red channel
 			img.Alloc( scaledWidth * scaledHeight );
@@ -181,27 +350,34 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte * pic_co
 			}
 		}
 
-		// if we had to pad to quads, free the padded version
-		if ( pic != dxtPic ) {
-			Mem_Free( dxtPic );
-			dxtPic = NULL;
-		}
+		scaledWidth = Max( 1, scaledWidth >> 1 );
+		scaledHeight = Max( 1, scaledHeight >> 1 );
+	}
 
-		// downsample for the next level
-		byte * shrunk = NULL;
-		if ( gammaMips ) {
-			shrunk = R_MipMapWithGamma( pic, scaledWidth, scaledHeight );
-		} else {
-			shrunk = R_MipMap( pic, scaledWidth, scaledHeight );
+	// compress the bands of all the levels together
+	if ( jobList != NULL && compressBands.Num() > 1 ) {
+		for ( int i = 0; i < compressBands.Num(); i++ ) {
+			jobList->AddJob( (jobRun_t)R_CompressImageBand, &compressBands[i] );
 		}
-		Mem_Free( pic );
-		pic = shrunk;
+		jobList->Submit();
+		jobList->Wait();
+	} else {
+		for ( int i = 0; i < compressBands.Num(); i++ ) {
+			R_CompressImageBand( &compressBands[i] );
+		}
+	}
 
-		scaledWidth = Max( 1, scaledWidth >> 1 );
-		scaledHeight = Max( 1, scaledHeight >> 1 );
+	if ( jobList != NULL ) {
+		parallelJobManager->FreeJobList( jobList );
 	}
 
-	Mem_Free( pic );
+	// free the padded versions and the filtered levels
+	for ( int i = 0; i < paddedPics.Num(); i++ ) {
+		Mem_Free( paddedPics[i] );
+	}
+	for ( int i = 0; i < levelPics.Num(); i++ ) {
+		Mem_Free( levelPics[i] );
+	}
 }
 
 /*
@@ -332,8 +508,10 @@ ID_TIME_T idBinaryImage::WriteGeneratedFile( ID_TIME_T sourceFileTime ) {
 	file->WriteBig( fileData.height );
 	file->WriteBig( fileData.numLevels );
 
+	fileOffsets.SetNum( images.Num() + 1 );
 	for ( int i = 0; i < images.Num(); i++ ) {
 		idBinaryImageData &img = images[ i ];
+		fileOffsets[ i ] = file->Tell();
 		file->WriteBig( img.level );
 		file->WriteBig( img.destZ );
 		file->WriteBig( img.width );
@@ -341,9 +519,38 @@ ID_TIME_T idBinaryImage::WriteGeneratedFile( ID_TIME_T sourceFileTime ) {
 		file->WriteBig( img.dataSize );
 		file->Write( img.data, img.dataSize );
 	}
+	fileOffsets[ images.Num() ] = file->Tell();
 	return file->Timestamp();
 }
 
+/*
+==========================
+idBinaryImage::IsGeneratedFileCurrent
+
+Checks the header of the generated file without loading the images, so the
+level load knows which source images it will have to decode.
+==========================
+*/
+bool idBinaryImage::IsGeneratedFileCurrent( ID_TIME_T sourceFileTime ) {
+	idStr binaryFileName;
+	MakeGeneratedFileName( binaryFileName );
+	idFileLocal bFile = fileSystem->OpenFileRead( binaryFileName );
+	if ( bFile == NULL ) {
+		return false;
+	}
+	bimageFile_t header;
+	if ( bFile->Read( &header, sizeof( header ) ) <= 0 ) {
+		return false;
+	}
+	idSwapClass<bimageFile_t> swap;
+	swap.Big( header.sourceFileTime );
+	swap.Big( header.headerMagic );
+	if ( BIMAGE_MAGIC != header.headerMagic ) {
+		return false;
+	}
+	return ( header.sourceFileTime == sourceFileTime || fileSystem->InProductionMode() );
+}
+
 /*
 ==========================
 idBinaryImage::LoadFromGeneratedFile
@@ -351,14 +558,14 @@ idBinaryImage::LoadFromGeneratedFile
 Load the preprocessed image from the generated folder.
 ==========================
 */
-ID_TIME_T idBinaryImage::LoadFromGeneratedFile( ID_TIME_T sourceFileTime ) {
+ID_TIME_T idBinaryImage::LoadFromGeneratedFile( ID_TIME_T sourceFileTime, int maxLevelSize ) {
 	idStr binaryFileName;
 	MakeGeneratedFileName( binaryFileName );
 	idFileLocal bFile = fileSystem->OpenFileRead( binaryFileName );
 	if ( bFile == NULL ) {
 		return FILE_NOT_FOUND_TIMESTAMP;
 	}
-	if ( LoadFromGeneratedFile( bFile, sourceFileTime ) ) {
+	if ( LoadFromGeneratedFile( bFile, sourceFileTime, maxLevelSize ) ) {
 		return bFile->Timestamp();
 	}
 	return FILE_NOT_FOUND_TIMESTAMP;
@@ -371,7 +578,7 @@ idBinaryImage::LoadFromGeneratedFile
 Load the preprocessed image from the generated folder.
 ==========================
 */
-bool idBinaryImage::LoadFromGeneratedFile( idFile * bFile, ID_TIME_T sourceFileTime ) {
+bool idBinaryImage::LoadFromGeneratedFile( idFile * bFile, ID_TIME_T sourceFileTime, int maxLevelSize ) {
 	if ( bFile->Read( &fileData, sizeof( fileData ) ) <= 0 ) {
 		return false;
 	}
@@ -398,9 +605,12 @@ bool idBinaryImage::LoadFromGeneratedFile( idFile * bFile, ID_TIME_T sourceFileT
 	}
 
 	images.SetNum( numImages );
+	fileOffsets.SetNum( numImages + 1 );
 
+	int numLoaded = 0;
 	for ( int i = 0; i < numImages; i++ ) {
-		idBinaryImageData &img = images[ i ];
+		idBinaryImageData &img = images[ numLoaded ];
+		fileOffsets[ i ] = bFile->Tell();
 		if ( bFile->Read( &img, sizeof( bimageImage_t ) ) <= 0 ) {
 			return false;
 		}
@@ -417,6 +627,13 @@ bool idBinaryImage::LoadFromGeneratedFile( idFile * bFile, ID_TIME_T sourceFileT
 		// sizes are still retained, so the stored data size may be larger than
 		// just the multiplication of dimensions
 		assert( img.dataSize >= img.width * img.height * BitsForFormat( (textureFormat_t)fileData.format ) / 8 );
+
+		// skip the levels that will be streamed in
+		if ( maxLevelSize > 0 && fileData.textureType == TT_2D && img.level < fileData.numLevels - 1 && Max( img.width, img.height ) > maxLevelSize ) {
+			bFile->Seek( img.dataSize, FS_SEEK_CUR );
+			continue;
+		}
+
 		img.Alloc( img.dataSize );
 		if ( img.data == NULL ) {
 			return false;
@@ -425,7 +642,10 @@ bool idBinaryImage::LoadFromGeneratedFile( idFile * bFile, ID_TIME_T sourceFileT
 		if ( bFile->Read( img.data, img.dataSize ) <= 0 ) {
 			return false;
 		}
+		numLoaded++;
 	}
+	images.SetNum( numLoaded );
+	fileOffsets[ numImages ] = bFile->Tell();
 
 	return true;
 }
@@ -452,3 +672,157 @@ void idBinaryImage::GetGeneratedFileName( idStr & gfn, const char *name ) {
 }
 
 
+/*
+========================
+R_DXTSquaredError
+
+Returns the summed squared error of the decoded top level against the source image.
+========================
+*/
+static double R_DXTSquaredError( const byte * source, const byte * dxtData, int width, int height, textureFormat_t format, int64 & numSamples ) {
+	byte * decoded = (byte *)Mem_Alloc( width * height * 4, TAG_TEMP );
+	idDxtDecoder dxt;
+	if ( format == FMT_DXT1 ) {
+		dxt.DecompressImageDXT1( dxtData, decoded, width, height );
+	} else if ( format == FMT_BC7 ) {
+		dxt.DecompressImageBC7( dxtData, decoded, width, height );
+	} else {
+		dxt.DecompressImageDXT5( dxtData, decoded, width, height );
+	}
+
+	// DXT1 has no alpha to compare
+	const int numChannels = ( format == FMT_DXT1 ) ? 3 : 4;
+	double error = 0.0;
+	for ( int i = 0; i < width * height; i++ ) {
+		for ( int c = 0; c < numChannels; c++ ) {
+			const int d = source[i * 4 + c] - decoded[i * 4 + c];
+			error += d * d;
+		}
+	}
+	numSamples += width * height * numChannels;
+
+	Mem_Free( decoded );
+	return error;
+}
+
+/*
+========================
+benchmarkImageBuild
+
+Builds the mipmapped DXT or BC7 images of the base image set with the serial and
+the parallel image build and reports the throughput of both. Both builds run the same
+encoder on the same data, so the quality of the top level is reported once and the
+parallel build is checked to match the serial one byte for byte on every level.
+========================
+*/
+CONSOLE_COMMAND( benchmarkImageBuild, "times building DXT images from the base image set, usage: benchmarkImageBuild [numImages] [hq] [bc7]", 0 ) {
+	const int maxImages = ( args.Argc() > 1 ) ? Max( atoi( args.Argv( 1 ) ), 1 ) : 64;
+	bool highQuality = false;
+	bool useBC7 = false;
+	for ( int i = 2; i < args.Argc(); i++ ) {
+		if ( idStr::Icmp( args.Argv( i ), "hq" ) == 0 ) {
+			highQuality = true;
+		} else if ( idStr::Icmp( args.Argv( i ), "bc7" ) == 0 ) {
+			useBC7 = true;
+		}
+	}
+
+	const bool oldParallelBuild = image_parallelBuild.GetBool();
+	const bool oldHighQuality = image_highQualityCompression.GetBool();
+	image_highQualityCompression.SetBool( highQuality );
+
+	idFileList * files = fileSystem->ListFilesTree( "textures", ".tga", true );
+
+	int numImages = 0;
+	int numMismatched = 0;
+	double megaPixels = 0.0;
+	uint64 buildMicroseconds[2] = { 0, 0 };
+	double squaredError = 0.0;
+	int64 numSamples = 0;
+
+	for ( int i = 0; i < files->GetNumFiles() && numImages < maxImages; i++ ) {
+		byte * pic = NULL;
+		int width = 0;
+		int height = 0;
+		R_LoadImage( files->GetFile( i ), &pic, &width, &height, NULL, true );
+		if ( pic == NULL ) {
+			continue;
+		}
+		if ( width < 4 || height < 4 ) {
+			R_StaticFree( pic );
+			continue;
+		}
+
+		// images with any translucency go to DXT5, the rest to DXT1
+		textureFormat_t format = FMT_DXT1;
+		for ( int j = 0; j < width * height && !useBC7; j++ ) {
+			if ( pic[j * 4 + 3] != 255 ) {
+				format = FMT_DXT5;
+				break;
+			}
+		}
+		if ( useBC7 ) {
+			format = FMT_BC7;
+		}
+
+		int numLevels = 1;
+		for ( int size = Max( width, height ); size > 1; size >>= 1 ) {
+			numLevels++;
+		}
+
+		idBinaryImage * builds[2];
+		for ( int pass = 0; pass < 2; pass++ ) {
+			image_parallelBuild.SetBool( pass == 1 );
+
+			textureFormat_t buildFormat = format;
+			textureColor_t colorFormat = CFM_DEFAULT;
+			builds[pass] = new (TAG_TEMP) idBinaryImage( files->GetFile( i ) );
+
+			const uint64 start = Sys_Microseconds();
+			builds[pass]->Load2DFromMemory( width, height, pic, numLevels, buildFormat, colorFormat, false );
+			buildMicroseconds[pass] += Sys_Microseconds() - start;
+		}
+
+		squaredError += R_DXTSquaredError( pic, builds[0]->GetImageData( 0 ), width, height, format, numSamples );
+
+		for ( int level = 0; level < builds[0]->NumImages(); level++ ) {
+			const bimageImage_t & header = builds[0]->GetImageHeader( level );
+			if ( memcmp( builds[0]->GetImageData( level ), builds[1]->GetImageData( level ), header.dataSize ) != 0 ) {
+				numMismatched++;
+				break;
+			}
+		}
+
+		delete builds[0];
+		delete builds[1];
+		R_StaticFree( pic );
+
+		megaPixels += width * height / ( 1024.0 * 1024.0 );
+		numImages++;
+	}
+
+	fileSystem->FreeFileList( files );
+
+	image_parallelBuild.SetBool( oldParallelBuild );
+	image_highQualityCompression.SetBool( oldHighQuality );
+
+	if ( numImages == 0 ) {
+		common->Printf( "no images found\n" );
+		return;
+	}
+
+	common->Printf( "%d images, %.1f megapixels, %s %s compression, %d job threads\n", numImages, megaPixels, highQuality ? "high quality" : "fast", useBC7 ? "BC7" : "DXT", parallelJobManager->GetNumProcessingUnits() );
+	const char * passNames[2] = { "serial", "parallel" };
+	for ( int pass = 0; pass < 2; pass++ ) {
+		const double seconds = Max( buildMicroseconds[pass], (uint64)1 ) / 1000000.0;
+		common->Printf( "%8s: %8.1f msec, %7.2f MP/s\n", passNames[pass], seconds * 1000.0, megaPixels / seconds );
+	}
+	const double mse = squaredError / Max( numSamples, (int64)1 );
+	const double psnr = ( mse > 0.0 ) ? 10.0 * log10( 255.0 * 255.0 / mse ) : 99.0;
+	common->Printf( "top level %5.2f dB PSNR, speedup %.2fx\n", psnr, (double)buildMicroseconds[0] / Max( buildMicroseconds[1], (uint64)1 ) );
+	if ( numMismatched == 0 ) {
+		common->Printf( "the parallel build matches the serial build on all levels\n" );
+	} else {
+		common->Warning( "%d of %d images differ between the serial and parallel builds", numMismatched, numImages );
+	}
+}
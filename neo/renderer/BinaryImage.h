@@ -48,14 +48,23 @@ public:
 	void				Load2DFromMemory( int width, int height, const byte * pic_const, int numLevels, textureFormat_t & textureFormat, textureColor_t & colorFormat, bool gammaMips );
 	void				LoadCubeFromMemory( int width, const byte * pics[6], int numLevels, textureFormat_t & textureFormat, bool gammaMips );
 
-	ID_TIME_T			LoadFromGeneratedFile( ID_TIME_T sourceFileTime );
+	// with a maxLevelSize, 2D images only load the levels that are no larger than that, and always the
+	// smallest one, the rest is left for texture streaming
+	ID_TIME_T			LoadFromGeneratedFile( ID_TIME_T sourceFileTime, int maxLevelSize = 0 );
 	ID_TIME_T			WriteGeneratedFile( ID_TIME_T sourceFileTime );
+	// only reads the file header, true if LoadFromGeneratedFile would take the file for this source
+	bool				IsGeneratedFileCurrent( ID_TIME_T sourceFileTime );
 
 	const bimageFile_t &	GetFileHeader() { return fileData; }
 
 	int					NumImages() { return images.Num(); }
 	const bimageImage_t &	GetImageHeader( int i ) const { return images[i]; }
 	const byte *			GetImageData( int i ) const { return images[i].data; }
+
+	// where the header of every image is in the generated file, followed by the length of the file,
+	// set by loading or writing the generated file, including the images a partial load skipped
+	int					NumFileOffsets() const { return fileOffsets.Num(); }
+	int					GetFileOffset( int i ) const { return fileOffsets[i]; }
 	static void			GetGeneratedFileName( idStr & gfn, const char *imageName );
 private:
 	idStr				imgName;			// game path, including extension (except for cube maps), may be an image program
@@ -91,10 +100,11 @@ private:
 	};
 
 	idList< idBinaryImageData, TAG_IDLIB_LIST_IMAGE > images;
+	idList< int, TAG_IDLIB_LIST_IMAGE >	fileOffsets;
 
 private:
 	void				MakeGeneratedFileName( idStr & gfn );
-	bool				LoadFromGeneratedFile( idFile * f, ID_TIME_T sourceFileTime );
+	bool				LoadFromGeneratedFile( idFile * f, ID_TIME_T sourceFileTime, int maxLevelSize );
 };
 
 #endif // __BINARYIMAGE_H__
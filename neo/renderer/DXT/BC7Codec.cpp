@@ -0,0 +1,631 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. 
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").  
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+/*
+================================================================================================
+Contains the BC7 encoder and decoder.
+
+Only the single subset modes are written: mode 6 with RGBA endpoints, a p-bit per endpoint and
+4 bit indices, and mode 5 with separate RGB and alpha endpoints and 2 bit indices for each. The
+fast encoder writes mode 6 with endpoints along the principal axis of the block. The high quality
+encoder also refines the endpoints with least squares, tries every p-bit combination and tries
+mode 5 for blocks with varying alpha.
+================================================================================================
+*/
+#pragma hdrstop
+#include "DXTCodec_local.h"
+#include "DXTCodec.h"
+
+static const int BC7_WEIGHTS_2[4] = { 0, 21, 43, 64 };
+static const int BC7_WEIGHTS_4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+static const int BC7_REFINE_ITERATIONS = 2;		// least squares passes of the high quality encoder
+
+struct bc7Mode6_t {
+	int					endpoints[2][4];	// 7 bits per channel
+	int					pBits[2];
+	byte				indices[16];
+	int					error;
+};
+
+struct bc7Mode5_t {
+	int					colors[2][3];		// 7 bits per channel
+	int					alphas[2];			// 8 bits
+	byte				colorIndices[16];
+	byte				alphaIndices[16];
+	int					error;
+};
+
+/*
+========================
+BC7_Interpolate
+========================
+*/
+static ID_INLINE int BC7_Interpolate( int e0, int e1, int weight ) {
+	return ( ( 64 - weight ) * e0 + weight * e1 + 32 ) >> 6;
+}
+
+/*
+========================
+BC7_WriteBits
+
+Blocks are written least significant bit first.
+========================
+*/
+static void BC7_WriteBits( byte * block, int & bitPos, unsigned int value, int numBits ) {
+	for ( int i = 0; i < numBits; i++, bitPos++ ) {
+		if ( value & ( 1u << i ) ) {
+			block[bitPos >> 3] |= (byte)( 1 << ( bitPos & 7 ) );
+		}
+	}
+}
+
+/*
+========================
+BC7_ReadBits
+========================
+*/
+static unsigned int BC7_ReadBits( const byte * block, int & bitPos, int numBits ) {
+	unsigned int value = 0;
+	for ( int i = 0; i < numBits; i++, bitPos++ ) {
+		value |= (unsigned int)( ( block[bitPos >> 3] >> ( bitPos & 7 ) ) & 1 ) << i;
+	}
+	return value;
+}
+
+/*
+========================
+BC7_PrincipalAxisEndpoints
+
+Finds the extents of the block along the principal axis of the first numChannels channels.
+========================
+*/
+static void BC7_PrincipalAxisEndpoints( const byte * colorBlock, int numChannels, float endpoints[2][4] ) {
+	float mean[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	for ( int i = 0; i < 16; i++ ) {
+		for ( int c = 0; c < numChannels; c++ ) {
+			mean[c] += colorBlock[i * 4 + c];
+		}
+	}
+	for ( int c = 0; c < numChannels; c++ ) {
+		mean[c] *= ( 1.0f / 16.0f );
+	}
+
+	float covariance[4][4];
+	memset( covariance, 0, sizeof( covariance ) );
+	for ( int i = 0; i < 16; i++ ) {
+		float d[4];
+		for ( int c = 0; c < numChannels; c++ ) {
+			d[c] = colorBlock[i * 4 + c] - mean[c];
+		}
+		for ( int c0 = 0; c0 < numChannels; c0++ ) {
+			for ( int c1 = c0; c1 < numChannels; c1++ ) {
+				covariance[c0][c1] += d[c0] * d[c1];
+			}
+		}
+	}
+
+	// power iteration, starting from the channel with the largest variance
+	float axis[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	int largest = 0;
+	for ( int c = 1; c < numChannels; c++ ) {
+		if ( covariance[c][c] > covariance[largest][largest] ) {
+			largest = c;
+		}
+	}
+	axis[largest] = 1.0f;
+	for ( int iteration = 0; iteration < 6; iteration++ ) {
+		float next[4];
+		float length = 0.0f;
+		for ( int c0 = 0; c0 < numChannels; c0++ ) {
+			next[c0] = 0.0f;
+			for ( int c1 = 0; c1 < numChannels; c1++ ) {
+				next[c0] += ( c0 <= c1 ? covariance[c0][c1] : covariance[c1][c0] ) * axis[c1];
+			}
+			length += next[c0] * next[c0];
+		}
+		if ( length < idMath::FLT_SMALLEST_NON_DENORMAL ) {
+			break;
+		}
+		const float scale = idMath::InvSqrt( length );
+		for ( int c = 0; c < numChannels; c++ ) {
+			axis[c] = next[c] * scale;
+		}
+	}
+
+	float minT = 0.0f;
+	float maxT = 0.0f;
+	for ( int i = 0; i < 16; i++ ) {
+		float t = 0.0f;
+		for ( int c = 0; c < numChannels; c++ ) {
+			t += ( colorBlock[i * 4 + c] - mean[c] ) * axis[c];
+		}
+		minT = Min( minT, t );
+		maxT = Max( maxT, t );
+	}
+
+	for ( int c = 0; c < 4; c++ ) {
+		endpoints[0][c] = ( c < numChannels ) ? idMath::ClampFloat( 0.0f, 255.0f, mean[c] + minT * axis[c] ) : 0.0f;
+		endpoints[1][c] = ( c < numChannels ) ? idMath::ClampFloat( 0.0f, 255.0f, mean[c] + maxT * axis[c] ) : 0.0f;
+	}
+}
+
+/*
+========================
+BC7_LeastSquaresEndpoints
+
+Solves for the endpoints that minimize the error of the given index weights, per channel.
+Returns false if all the texels use the same weight.
+========================
+*/
+static bool BC7_LeastSquaresEndpoints( const byte * colorBlock, int firstChannel, int numChannels, const byte * indices, const int * weights, float endpoints[2][4] ) {
+	float a = 0.0f, b = 0.0f, c = 0.0f;
+	float d0[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	float d1[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	for ( int i = 0; i < 16; i++ ) {
+		const float t = weights[indices[i]] * ( 1.0f / 64.0f );
+		const float s = 1.0f - t;
+		a += s * s;
+		b += s * t;
+		c += t * t;
+		for ( int ch = firstChannel; ch < firstChannel + numChannels; ch++ ) {
+			d0[ch] += s * colorBlock[i * 4 + ch];
+			d1[ch] += t * colorBlock[i * 4 + ch];
+		}
+	}
+
+	const float det = a * c - b * b;
+	if ( idMath::Fabs( det ) < 1e-4f ) {
+		return false;
+	}
+	const float invDet = 1.0f / det;
+	for ( int ch = firstChannel; ch < firstChannel + numChannels; ch++ ) {
+		endpoints[0][ch] = idMath::ClampFloat( 0.0f, 255.0f, ( c * d0[ch] - b * d1[ch] ) * invDet );
+		endpoints[1][ch] = idMath::ClampFloat( 0.0f, 255.0f, ( a * d1[ch] - b * d0[ch] ) * invDet );
+	}
+	return true;
+}
+
+/*
+========================
+BC7_QuantizeMode6
+
+Quantizes the endpoints to 7 bits with the given p-bits. A p-bit of -1 picks the p-bit
+with the least quantization error for that endpoint.
+========================
+*/
+static void BC7_QuantizeMode6( const float endpoints[2][4], int pBit0, int pBit1, bc7Mode6_t & mode ) {
+	const int requestedPBits[2] = { pBit0, pBit1 };
+	for ( int e = 0; e < 2; e++ ) {
+		int bestError = MAX_TYPE( int );
+		for ( int p = 0; p < 2; p++ ) {
+			if ( requestedPBits[e] >= 0 && requestedPBits[e] != p ) {
+				continue;
+			}
+			int quantized[4];
+			int error = 0;
+			for ( int c = 0; c < 4; c++ ) {
+				quantized[c] = idMath::ClampInt( 0, 127, idMath::Ftoi( ( endpoints[e][c] - p ) * 0.5f + 0.5f ) );
+				const int d = ( ( quantized[c] << 1 ) | p ) - idMath::Ftoi( endpoints[e][c] + 0.5f );
+				error += d * d;
+			}
+			if ( error < bestError ) {
+				bestError = error;
+				mode.pBits[e] = p;
+				memcpy( mode.endpoints[e], quantized, sizeof( quantized ) );
+			}
+		}
+	}
+}
+
+/*
+========================
+BC7_FindMode6Indices
+========================
+*/
+static int BC7_FindMode6Indices( const byte * colorBlock, bc7Mode6_t & mode ) {
+	int palette[16][4];
+	for ( int c = 0; c < 4; c++ ) {
+		const int e0 = ( mode.endpoints[0][c] << 1 ) | mode.pBits[0];
+		const int e1 = ( mode.endpoints[1][c] << 1 ) | mode.pBits[1];
+		for ( int i = 0; i < 16; i++ ) {
+			palette[i][c] = BC7_Interpolate( e0, e1, BC7_WEIGHTS_4[i] );
+		}
+	}
+
+	mode.error = 0;
+	for ( int i = 0; i < 16; i++ ) {
+		const byte * texel = &colorBlock[i * 4];
+		int bestError = MAX_TYPE( int );
+		for ( int j = 0; j < 16; j++ ) {
+			const int dr = texel[0] - palette[j][0];
+			const int dg = texel[1] - palette[j][1];
+			const int db = texel[2] - palette[j][2];
+			const int da = texel[3] - palette[j][3];
+			const int error = dr * dr + dg * dg + db * db + da * da;
+			if ( error < bestError ) {
+				bestError = error;
+				mode.indices[i] = (byte)j;
+			}
+		}
+		mode.error += bestError;
+	}
+	return mode.error;
+}
+
+/*
+========================
+BC7_EncodeMode6
+========================
+*/
+static void BC7_EncodeMode6( const byte * colorBlock, bool highQuality, bc7Mode6_t & best ) {
+	float endpoints[2][4];
+	BC7_PrincipalAxisEndpoints( colorBlock, 4, endpoints );
+
+	BC7_QuantizeMode6( endpoints, -1, -1, best );
+	BC7_FindMode6Indices( colorBlock, best );
+	if ( !highQuality ) {
+		return;
+	}
+
+	for ( int iteration = 0; iteration <= BC7_REFINE_ITERATIONS && best.error > 0; iteration++ ) {
+		if ( iteration > 0 && !BC7_LeastSquaresEndpoints( colorBlock, 0, 4, best.indices, BC7_WEIGHTS_4, endpoints ) ) {
+			break;
+		}
+		for ( int p = 0; p < 4; p++ ) {
+			bc7Mode6_t trial;
+			BC7_QuantizeMode6( endpoints, p & 1, p >> 1, trial );
+			if ( BC7_FindMode6Indices( colorBlock, trial ) < best.error ) {
+				best = trial;
+			}
+		}
+	}
+}
+
+/*
+========================
+BC7_WriteMode6
+========================
+*/
+static void BC7_WriteMode6( bc7Mode6_t & mode, byte * outBlock ) {
+	// the most significant bit of the first index is implicitly zero
+	if ( mode.indices[0] & 8 ) {
+		for ( int c = 0; c < 4; c++ ) {
+			SwapValues( mode.endpoints[0][c], mode.endpoints[1][c] );
+		}
+		SwapValues( mode.pBits[0], mode.pBits[1] );
+		for ( int i = 0; i < 16; i++ ) {
+			mode.indices[i] = (byte)( 15 - mode.indices[i] );
+		}
+	}
+
+	memset( outBlock, 0, 16 );
+	int bitPos = 0;
+	BC7_WriteBits( outBlock, bitPos, 1 << 6, 7 );
+	for ( int c = 0; c < 4; c++ ) {
+		BC7_WriteBits( outBlock, bitPos, mode.endpoints[0][c], 7 );
+		BC7_WriteBits( outBlock, bitPos, mode.endpoints[1][c], 7 );
+	}
+	BC7_WriteBits( outBlock, bitPos, mode.pBits[0], 1 );
+	BC7_WriteBits( outBlock, bitPos, mode.pBits[1], 1 );
+	for ( int i = 0; i < 16; i++ ) {
+		BC7_WriteBits( outBlock, bitPos, mode.indices[i], ( i == 0 ) ? 3 : 4 );
+	}
+	assert( bitPos == 128 );
+}
+
+/*
+========================
+BC7_FindMode5Indices
+========================
+*/
+static int BC7_FindMode5Indices( const byte * colorBlock, bc7Mode5_t & mode ) {
+	int colors[4][3];
+	int alphas[4];
+	for ( int j = 0; j < 4; j++ ) {
+		for ( int c = 0; c < 3; c++ ) {
+			const int e0 = ( mode.colors[0][c] << 1 ) | ( mode.colors[0][c] >> 6 );
+			const int e1 = ( mode.colors[1][c] << 1 ) | ( mode.colors[1][c] >> 6 );
+			colors[j][c] = BC7_Interpolate( e0, e1, BC7_WEIGHTS_2[j] );
+		}
+		alphas[j] = BC7_Interpolate( mode.alphas[0], mode.alphas[1], BC7_WEIGHTS_2[j] );
+	}
+
+	mode.error = 0;
+	for ( int i = 0; i < 16; i++ ) {
+		const byte * texel = &colorBlock[i * 4];
+		int bestColorError = MAX_TYPE( int );
+		int bestAlphaError = MAX_TYPE( int );
+		for ( int j = 0; j < 4; j++ ) {
+			const int dr = texel[0] - colors[j][0];
+			const int dg = texel[1] - colors[j][1];
+			const int db = texel[2] - colors[j][2];
+			const int colorError = dr * dr + dg * dg + db * db;
+			if ( colorError < bestColorError ) {
+				bestColorError = colorError;
+				mode.colorIndices[i] = (byte)j;
+			}
+			const int da = texel[3] - alphas[j];
+			if ( da * da < bestAlphaError ) {
+				bestAlphaError = da * da;
+				mode.alphaIndices[i] = (byte)j;
+			}
+		}
+		mode.error += bestColorError + bestAlphaError;
+	}
+	return mode.error;
+}
+
+/*
+========================
+BC7_EncodeMode5
+========================
+*/
+static void BC7_EncodeMode5( const byte * colorBlock, bc7Mode5_t & best ) {
+	float endpoints[2][4];
+	BC7_PrincipalAxisEndpoints( colorBlock, 3, endpoints );
+
+	byte minAlpha = 255;
+	byte maxAlpha = 0;
+	for ( int i = 0; i < 16; i++ ) {
+		minAlpha = Min( minAlpha, colorBlock[i * 4 + 3] );
+		maxAlpha = Max( maxAlpha, colorBlock[i * 4 + 3] );
+	}
+	endpoints[0][3] = minAlpha;
+	endpoints[1][3] = maxAlpha;
+
+	best.error = MAX_TYPE( int );
+	for ( int iteration = 0; iteration <= BC7_REFINE_ITERATIONS; iteration++ ) {
+		if ( iteration > 0 ) {
+			const bool colorsRefined = BC7_LeastSquaresEndpoints( colorBlock, 0, 3, best.colorIndices, BC7_WEIGHTS_2, endpoints );
+			const bool alphasRefined = BC7_LeastSquaresEndpoints( colorBlock, 3, 1, best.alphaIndices, BC7_WEIGHTS_2, endpoints );
+			if ( !colorsRefined && !alphasRefined ) {
+				break;
+			}
+		}
+
+		bc7Mode5_t trial;
+		for ( int e = 0; e < 2; e++ ) {
+			for ( int c = 0; c < 3; c++ ) {
+				trial.colors[e][c] = idMath::ClampInt( 0, 127, idMath::Ftoi( endpoints[e][c] * ( 127.0f / 255.0f ) + 0.5f ) );
+			}
+			trial.alphas[e] = idMath::ClampInt( 0, 255, idMath::Ftoi( endpoints[e][3] + 0.5f ) );
+		}
+		if ( BC7_FindMode5Indices( colorBlock, trial ) < best.error ) {
+			best = trial;
+		}
+	}
+}
+
+/*
+========================
+BC7_WriteMode5
+========================
+*/
+static void BC7_WriteMode5( bc7Mode5_t & mode, byte * outBlock ) {
+	// the most significant bits of the first color and alpha indices are implicitly zero
+	if ( mode.colorIndices[0] & 2 ) {
+		for ( int c = 0; c < 3; c++ ) {
+			SwapValues( mode.colors[0][c], mode.colors[1][c] );
+		}
+		for ( int i = 0; i < 16; i++ ) {
+			mode.colorIndices[i] = (byte)( 3 - mode.colorIndices[i] );
+		}
+	}
+	if ( mode.alphaIndices[0] & 2 ) {
+		SwapValues( mode.alphas[0], mode.alphas[1] );
+		for ( int i = 0; i < 16; i++ ) {
+			mode.alphaIndices[i] = (byte)( 3 - mode.alphaIndices[i] );
+		}
+	}
+
+	memset( outBlock, 0, 16 );
+	int bitPos = 0;
+	BC7_WriteBits( outBlock, bitPos, 1 << 5, 6 );
+	BC7_WriteBits( outBlock, bitPos, 0, 2 );		// no channel rotation
+	for ( int c = 0; c < 3; c++ ) {
+		BC7_WriteBits( outBlock, bitPos, mode.colors[0][c], 7 );
+		BC7_WriteBits( outBlock, bitPos, mode.colors[1][c], 7 );
+	}
+	BC7_WriteBits( outBlock, bitPos, mode.alphas[0], 8 );
+	BC7_WriteBits( outBlock, bitPos, mode.alphas[1], 8 );
+	for ( int i = 0; i < 16; i++ ) {
+		BC7_WriteBits( outBlock, bitPos, mode.colorIndices[i], ( i == 0 ) ? 1 : 2 );
+	}
+	for ( int i = 0; i < 16; i++ ) {
+		BC7_WriteBits( outBlock, bitPos, mode.alphaIndices[i], ( i == 0 ) ? 1 : 2 );
+	}
+	assert( bitPos == 128 );
+}
+
+/*
+========================
+BC7_CompressBlock
+========================
+*/
+static void BC7_CompressBlock( const byte * colorBlock, bool highQuality, byte * outBlock ) {
+	bc7Mode6_t mode6;
+	BC7_EncodeMode6( colorBlock, highQuality, mode6 );
+
+	if ( highQuality && mode6.error > 0 ) {
+		bool varyingAlpha = false;
+		for ( int i = 1; i < 16; i++ ) {
+			if ( colorBlock[i * 4 + 3] != colorBlock[3] ) {
+				varyingAlpha = true;
+				break;
+			}
+		}
+		if ( varyingAlpha ) {
+			bc7Mode5_t mode5;
+			BC7_EncodeMode5( colorBlock, mode5 );
+			if ( mode5.error < mode6.error ) {
+				BC7_WriteMode5( mode5, outBlock );
+				return;
+			}
+		}
+	}
+
+	BC7_WriteMode6( mode6, outBlock );
+}
+
+/*
+========================
+BC7_DecompressBlock
+
+Decodes the modes written by the encoder, blocks in any other mode decode to black.
+========================
+*/
+static void BC7_DecompressBlock( const byte * inBlock, byte * colorBlock ) {
+	int bitPos = 0;
+	if ( inBlock[0] & ( 1 << 6 ) && ( inBlock[0] & 0x3F ) == 0 ) {
+		bitPos = 7;
+		int endpoints[2][4];
+		for ( int c = 0; c < 4; c++ ) {
+			endpoints[0][c] = BC7_ReadBits( inBlock, bitPos, 7 ) << 1;
+			endpoints[1][c] = BC7_ReadBits( inBlock, bitPos, 7 ) << 1;
+		}
+		const int pBit0 = BC7_ReadBits( inBlock, bitPos, 1 );
+		const int pBit1 = BC7_ReadBits( inBlock, bitPos, 1 );
+		for ( int c = 0; c < 4; c++ ) {
+			endpoints[0][c] |= pBit0;
+			endpoints[1][c] |= pBit1;
+		}
+		for ( int i = 0; i < 16; i++ ) {
+			const int index = BC7_ReadBits( inBlock, bitPos, ( i == 0 ) ? 3 : 4 );
+			for ( int c = 0; c < 4; c++ ) {
+				colorBlock[i * 4 + c] = (byte)BC7_Interpolate( endpoints[0][c], endpoints[1][c], BC7_WEIGHTS_4[index] );
+			}
+		}
+	} else if ( ( inBlock[0] & 0x3F ) == ( 1 << 5 ) ) {
+		bitPos = 6;
+		const int rotation = BC7_ReadBits( inBlock, bitPos, 2 );
+		int endpoints[2][4];
+		for ( int c = 0; c < 3; c++ ) {
+			endpoints[0][c] = BC7_ReadBits( inBlock, bitPos, 7 );
+			endpoints[1][c] = BC7_ReadBits( inBlock, bitPos, 7 );
+			endpoints[0][c] = ( endpoints[0][c] << 1 ) | ( endpoints[0][c] >> 6 );
+			endpoints[1][c] = ( endpoints[1][c] << 1 ) | ( endpoints[1][c] >> 6 );
+		}
+		endpoints[0][3] = BC7_ReadBits( inBlock, bitPos, 8 );
+		endpoints[1][3] = BC7_ReadBits( inBlock, bitPos, 8 );
+		int colorIndices[16];
+		for ( int i = 0; i < 16; i++ ) {
+			colorIndices[i] = BC7_ReadBits( inBlock, bitPos, ( i == 0 ) ? 1 : 2 );
+		}
+		for ( int i = 0; i < 16; i++ ) {
+			const int alphaIndex = BC7_ReadBits( inBlock, bitPos, ( i == 0 ) ? 1 : 2 );
+			byte * texel = &colorBlock[i * 4];
+			for ( int c = 0; c < 3; c++ ) {
+				texel[c] = (byte)BC7_Interpolate( endpoints[0][c], endpoints[1][c], BC7_WEIGHTS_2[colorIndices[i]] );
+			}
+			texel[3] = (byte)BC7_Interpolate( endpoints[0][3], endpoints[1][3], BC7_WEIGHTS_2[alphaIndex] );
+			if ( rotation != 0 ) {
+				SwapValues( texel[rotation - 1], texel[3] );
+			}
+		}
+	} else {
+		memset( colorBlock, 0, 64 );
+	}
+}
+
+/*
+========================
+idDxtEncoder::CompressImageBC7HQ
+
+params:	inBuf		- image to compress
+paramO:	outBuf		- result of compression
+params:	width		- width of image
+params:	height		- height of image
+========================
+*/
+void idDxtEncoder::CompressImageBC7HQ( const byte *inBuf, byte *outBuf, int width, int height ) {
+	CompressImageBC7( inBuf, outBuf, width, height, true );
+}
+
+/*
+========================
+idDxtEncoder::CompressImageBC7Fast
+
+params:	inBuf		- image to compress
+paramO:	outBuf		- result of compression
+params:	width		- width of image
+params:	height		- height of image
+========================
+*/
+void idDxtEncoder::CompressImageBC7Fast( const byte *inBuf, byte *outBuf, int width, int height ) {
+	CompressImageBC7( inBuf, outBuf, width, height, false );
+}
+
+/*
+========================
+idDxtEncoder::CompressImageBC7
+========================
+*/
+void idDxtEncoder::CompressImageBC7( const byte *inBuf, byte *outBuf, int width, int height, bool highQuality ) {
+	ALIGN16( byte block[64] );
+
+	assert( width >= 4 && ( width & 3 ) == 0 );
+	assert( height >= 4 && ( height & 3 ) == 0 );
+
+	this->width = width;
+	this->height = height;
+	this->outData = outBuf;
+
+	for ( int j = 0; j < height; j += 4, inBuf += width * 4*4 ) {
+		for ( int i = 0; i < width; i += 4 ) {
+			for ( int k = 0; k < 4; k++ ) {
+				memcpy( &block[k*4*4], inBuf + ( k * width + i ) * 4, 4*4 );
+			}
+
+			BC7_CompressBlock( block, highQuality, outData );
+			outData += 16;
+		}
+		outData += dstPadding;
+		inBuf += srcPadding;
+	}
+}
+
+/*
+========================
+idDxtDecoder::DecompressImageBC7
+========================
+*/
+void idDxtDecoder::DecompressImageBC7( const byte *inBuf, byte *outBuf, int width, int height ) {
+	byte block[64];
+
+	this->width = width;
+	this->height = height;
+	this->inData = inBuf;
+
+	for ( int j = 0; j < height; j += 4 ) {
+		for ( int i = 0; i < width; i += 4 ) {
+			BC7_DecompressBlock( inData, block );
+			inData += 16;
+			EmitBlock( outBuf, i, j, block );
+		}
+	}
+}
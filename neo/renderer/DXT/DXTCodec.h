@@ -83,6 +83,12 @@ public:
 	void	CompressImageDXT5Fast_Generic( const byte *inBuf, byte *outBuf, int width, int height );
 	void	CompressImageDXT5Fast_SSE2( const byte *inBuf, byte *outBuf, int width, int height );
 
+	// high quality BC7 compression, refines the endpoints with least squares and also tries mode 5 for blocks with varying alpha
+	void	CompressImageBC7HQ( const byte *inBuf, byte *outBuf, int width, int height );
+
+	// fast BC7 compression, mode 6 with endpoints along the principal axis of each block, for build iteration
+	void	CompressImageBC7Fast( const byte *inBuf, byte *outBuf, int width, int height );
+
 	// high quality CTX1 compression, uses exhaustive search to find a line through 2D space and is very slow
 	void	CompressImageCTX1HQ( const byte *inBuf, byte *outBuf, int width, int height );
 
@@ -209,6 +215,7 @@ private:
 	int					FindCTX1Indices( const byte *colorBlock, const byte *color0, const byte *color1, unsigned int &result ) const;
 
 	void				ExtractBlock( const byte *inPtr, int width, byte *colorBlock ) const;
+	void				CompressImageBC7( const byte *inBuf, byte *outBuf, int width, int height, bool highQuality );
 	void				GetMinMaxBBox( const byte *colorBlock, byte *minColor, byte *maxColor ) const;
 	void				InsetColorsBBox( byte *minColor, byte *maxColor ) const;
 	void				SelectColorsDiagonal( const byte *colorBlock, byte *minColor, byte *maxColor ) const;
@@ -498,6 +505,9 @@ public:
 	// tangent space normal map decompression from DXN2 format
 	void	DecompressNormalMapDXN2( const byte *inBuf, byte *outBuf, int width, int height );
 
+	// BC7 decompression of the single subset modes written by idDxtEncoder
+	void	DecompressImageBC7( const byte *inBuf, byte *outBuf, int width, int height );
+
 	// decompose a DXT image into indices and two images with colors
 	void	DecomposeImageDXT1( const byte *inBuf, byte *colorIndices, byte *pic1, byte *pic2, int width, int height );
 	void	DecomposeImageDXT5( const byte *inBuf, byte *colorIndices, byte *alphaIndices, byte *pic1, byte *pic2, int width, int height );
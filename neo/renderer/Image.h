@@ -68,6 +68,33 @@ typedef enum {
 
 #define	MAX_IMAGE_NAME	256
 
+/*
+================================================
+Streamed images only have the levels of their generated file from residentLevel on
+in their texture, idImageManager::UpdateStreaming moves residentLevel under the
+streaming budget as the front end reports how large the image is on screen.
+================================================
+*/
+static const int MAX_STREAMED_IMAGE_LEVELS = 16;
+
+struct imageStreamState_t {
+	idStr				fileName;				// generated file the levels are read from
+	int					fileOffsets[ MAX_STREAMED_IMAGE_LEVELS + 1 ];	// header of every level, followed by the file length
+	int					fullWidth;				// size of level 0
+	int					fullHeight;
+	int					fullLevels;				// 0 if the image isn't streamed
+	int					baseLevel;				// the levels from here on are always resident
+	int					residentLevel;			// first level in the texture
+	int					targetLevel;			// level the budget allows, assigned every frame
+	int					neededLevel;			// most detailed level the front end asked for when it last saw the image
+	int					lastNeededFrame;
+	int					generation;				// changed on every load, so reads for an older texture are dropped
+	bool				listed;					// in idImageManager::streamedImages
+	bool				requested;				// a read for this image is in flight
+	int					requestedLevel;
+	interlockedInt_t	reportedLevel;			// written by the front end jobs, MAX_STREAMED_IMAGE_LEVELS if not seen
+};
+
 class idImage {
 public:
 				idImage( const char * name );
@@ -110,12 +137,22 @@ public:
 	void		MakeDefault();	// fill with a grid pattern
 
 	const idImageOpts &	GetOpts() const { return opts; }
+	textureFilter_t		GetFilter() const { return filter; }
+	textureRepeat_t		GetRepeat() const { return repeat; }
+	textureUsage_t		GetUsage() const { return usage; }
+	cubeFiles_t			GetCubeFiles() const { return cubeFiles; }
 	int			GetUploadWidth() const { return opts.width; }
 	int			GetUploadHeight() const { return opts.height; }
 
 	void		SetReferencedOutsideLevelLoad() { referencedOutsideLevelLoad = true; }
 	void		SetReferencedInsideLevelLoad() { levelLoadReferenced = true; }
 	void		ActuallyLoadImage( bool fromBackEnd );
+
+	// texture streaming, the front end reports how many texels across the image covers on screen,
+	// may be called from several front end jobs at once
+	bool		IsStreamed() const { return stream.fullLevels > 0; }
+	const imageStreamState_t &	GetStreamState() const { return stream; }
+	void		ReportStreamedSize( float texels );
 	//---------------------------------------------
 	// Platform specific implementations
 	//---------------------------------------------
@@ -153,7 +190,11 @@ public:
 	// done under any normal circumstances, and probably not at all on consoles.
 	virtual void		Resize( int width, int height )=0;
 
-	bool		IsCompressed() const { return ( opts.format == FMT_DXT1 || opts.format == FMT_DXT5 ); }
+	bool		IsCompressed() const { return IsCompressedFormat( opts.format ); }
+	static bool	IsCompressedFormat( textureFormat_t format ) { return ( format == FMT_DXT1 || format == FMT_DXT5 || format == FMT_BC5 || format == FMT_BC7 ); }
+
+	// the format the usage gets without BC5 and BC7
+	static void	DeriveDefaultFormat( textureUsage_t usage, idImageOpts & opts );
 
 	virtual void		SetTexParameters()=0;	// update aniso and trilinear
 
@@ -167,6 +208,11 @@ protected:
 	virtual void				AllocImage()=0;
 	void				DeriveOpts();
 
+	// texture streaming, see Image_streaming.cpp
+	bool				CanStream() const;
+	int					StartStreaming( const idBinaryImage & im, int maxLevelSize );
+	int					StreamedLevelsSize( int level ) const { return stream.fileOffsets[ stream.fullLevels ] - stream.fileOffsets[ level ]; }
+
 	// parameters that define this image
 	idStr				imgName;				// game path, including extension (except for cube maps), may be an image program
 	cubeFiles_t			cubeFiles;				// If this is a cube map, and if so, what kind
@@ -186,6 +232,8 @@ protected:
 
 	int					refCount;				// overall ref count
 
+	imageStreamState_t	stream;
+
 	static const GLuint TEXTURE_NOT_LOADED = 0xFFFFFFFF;
 
 	GLuint				texnum;				// gl texture binding
@@ -213,6 +261,20 @@ ID_INLINE idImage::idImage( const char * name ) : imgName( name ) {
 	sourceFileTime = FILE_NOT_FOUND_TIMESTAMP;
 	binaryFileTime = FILE_NOT_FOUND_TIMESTAMP;
 	refCount = 0;
+
+	stream.fullWidth = 0;
+	stream.fullHeight = 0;
+	stream.fullLevels = 0;
+	stream.baseLevel = 0;
+	stream.residentLevel = 0;
+	stream.targetLevel = 0;
+	stream.neededLevel = 0;
+	stream.lastNeededFrame = 0;
+	stream.generation = 0;
+	stream.listed = false;
+	stream.requested = false;
+	stream.requestedLevel = 0;
+	stream.reportedLevel = MAX_STREAMED_IMAGE_LEVELS;
 }
 
 
@@ -222,6 +284,30 @@ void	R_WriteTGA( const char *filename, const byte *data, int width, int height,
 
 
 
+// a read of the levels of a streamed image
+struct imageStreamRequest_t {
+						imageStreamRequest_t() : image( NULL ), level( 0 ), generation( 0 ), startTime( 0 ) {}
+
+	idImage *			image;					// NULL if the slot is free
+	int					level;					// the read covers the levels from here to the end of the file
+	int					generation;				// of the image when the read was queued
+	uint64				startTime;
+	fileReadRequest_t	read;
+};
+
+static const int MAX_IMAGE_STREAM_REQUESTS = 8;
+
+struct imageStreamStats_t {
+	int64				baseBytes;				// of the streamed images at their base levels
+	int64				residentBytes;			// of the streamed images at their resident levels
+	int					frameMisses;			// images drawn last frame with less detail than they needed
+	int64				totalMisses;
+	int					numStreamedIn;			// residency changes to more detail
+	int					numEvicted;				// residency changes to less detail
+	int64				bytesRead;
+	uint64				readMicroseconds;		// from queueing the reads to uploading the levels
+};
+
 class idImageManager {
 public:
 
@@ -229,6 +315,7 @@ public:
 	{
 		insideLevelLoad = false;
 		preloadingMapImages = false;
+		memset( &streamStats, 0, sizeof( streamStats ) );
 	}
 
 	void				Init();
@@ -286,6 +373,15 @@ public:
 
 	void				PrintMemInfo( MemInfo_t *mi );
 
+	// texture streaming, see Image_streaming.cpp
+	// called between frames, while neither the front end nor the back end are running
+	void				UpdateStreaming();
+	// cancels or finishes the reads in flight
+	void				StopStreaming();
+	bool				StreamingImages() const { return streamedImages.Num() > 0; }
+	void				AddStreamedImage( idImage * image );
+	void				PrintStreamingStats() const;
+
 	// built-in images
 	void CreateIntrinsicImages();
 	idImage *			defaultImage;
@@ -317,6 +413,14 @@ public:
 
 	bool				insideLevelLoad;			// don't actually load images now
 	bool				preloadingMapImages;		// unless this is set
+
+	idList<idImage*, TAG_IDLIB_LIST_IMAGE>	streamedImages;
+	imageStreamRequest_t	streamRequests[ MAX_IMAGE_STREAM_REQUESTS ];
+	imageStreamStats_t	streamStats;
+
+private:
+	bool				StartStreamRequest( idImage * image, int level );
+	bool				UploadStreamedLevels( idImage * image, int level, const byte * data, int dataSize );
 };
 
 extern idImageManager	*globalImages;		// pointer to global list for the rest of the system
@@ -338,6 +442,10 @@ byte *R_MipMapWithAlphaSpecularity( const byte *in, int width, int height );
 byte *R_MipMapWithGamma( const byte *in, int width, int height );
 byte *R_MipMap( const byte *in, int width, int height );
 
+// filter a range of rows of the next mip level into a preallocated level, used by the parallel image build
+void R_MipMapWithGammaRows( const byte *in, int width, int height, byte *out, int firstRow, int numRows );
+void R_MipMapRows( const byte *in, int width, int height, byte *out, int firstRow, int numRows );
+
 // these operate in-place on the provided pixels
 void R_BlendOverTexture( byte *data, int pixelCount, const byte blend[4] );
 void R_HorizontalFlip( byte *data, int width, int height );
@@ -356,6 +464,11 @@ void R_LoadImage( const char *name, byte **pic, int *width, int *height, ID_TIME
 // pic is in top to bottom raster format
 bool R_LoadCubeImages( const char *cname, cubeFiles_t extensions, byte *pic[6], int *size, ID_TIME_T *timestamp );
 
+// decodes a batch of source images on the job threads, R_LoadImage hands them out instead of
+// loading the files until the next batch or R_FreeDecodedImages, main thread only
+void R_DecodeImages( const idStrList &names );
+void R_FreeDecodedImages();
+
 /*
 ====================================================================
 
@@ -40,6 +40,7 @@ idImageManager	imageManager;
 idImageManager * globalImages = &imageManager;
 
 idCVar preLoad_Images( "preLoad_Images", "1", CVAR_SYSTEM | CVAR_BOOL, "preload images during beginlevelload" );
+idCVar image_decodeBatch( "image_decodeBatch", "16", CVAR_RENDERER | CVAR_INTEGER, "source images that have to be built again are decoded on the job threads this many images at a time during level loads, 0 = decode them one by one as they load" );
 
 /*
 ===============
@@ -557,6 +558,8 @@ void idImageManager::PurgeAllImages() {
 	int		i;
 	idImage	*image;
 
+	StopStreaming();
+
 	for ( i = 0; i < images.Num() ; i++ ) {
 		image = images[i];
 		image->PurgeImage();
@@ -705,6 +708,8 @@ Shutdown
 ===============
 */
 void idImageManager::Shutdown() {
+	StopStreaming();
+	streamedImages.Clear();
 	images.DeleteContents( true );
 	imageHash.Clear();
 
@@ -719,6 +724,8 @@ Frees all images used by the previous level
 void idImageManager::BeginLevelLoad() {
 	insideLevelLoad = true;
 
+	StopStreaming();
+
 	for ( int i = 0 ; i < images.Num() ; i++ ) {
 		idImage	*image = images[ i ];
 
@@ -759,6 +766,35 @@ bool idImageManager::ExcludePreloadImage( const char *name ) {
 	return false;
 }
 
+/*
+====================
+R_SourceImageOutOfDate
+
+True if loading the image will decode its source file, because the binary image
+is missing or older than the source. Image programs and cube maps combine several
+files and are left to load their sources themselves.
+====================
+*/
+static bool R_SourceImageOutOfDate( const char *name, textureUsage_t usage, cubeFiles_t cubeFiles ) {
+	if ( cubeFiles != CF_2D || com_productionMode.GetInteger() != 0 || fileSystem->UsingResourceFiles() ) {
+		return false;
+	}
+	if ( name[0] == '_' || strchr( name, '(' ) != NULL ) {
+		return false;
+	}
+
+	ID_TIME_T sourceFileTime;
+	R_LoadImage( name, NULL, NULL, NULL, &sourceFileTime, true );
+	if ( sourceFileTime == FILE_NOT_FOUND_TIMESTAMP ) {
+		return false;
+	}
+
+	idStrStatic< MAX_OSPATH > generatedName = name;
+	idImage::GetGeneratedName( generatedName, usage, cubeFiles );
+	idBinaryImage im( generatedName );
+	return !im.IsGeneratedFileCurrent( sourceFileTime );
+}
+
 /*
 ====================
 idImageManager::Preload
@@ -771,15 +807,36 @@ void idImageManager::Preload( const idPreloadManifest &manifest, const bool & ma
 		preloadingMapImages = mapPreload;
 		int	start = Sys_Milliseconds();
 		int numLoaded = 0;
+		const int decodeBatch = image_decodeBatch.GetInteger();
 
 		//fileSystem->StartPreload( preloadImageFiles );
 		for ( int i = 0; i < manifest.NumResources(); i++ ) {
+			if ( decodeBatch > 0 && i % decodeBatch == 0 ) {
+				// decode the source images of the next batch that have to be built again in parallel
+				idStrList decodeNames;
+				for ( int j = i; j < i + decodeBatch && j < manifest.NumResources(); j++ ) {
+					const preloadEntry_s & p = manifest.GetPreloadByIndex( j );
+					if ( p.resType != PRELOAD_IMAGE || ExcludePreloadImage( p.resourceName ) ) {
+						continue;
+					}
+					const idImage * image = GetImage( p.resourceName );
+					if ( image != NULL && image->IsLoaded() ) {
+						continue;
+					}
+					if ( R_SourceImageOutOfDate( p.resourceName, ( textureUsage_t )p.imgData.usage, ( cubeFiles_t )p.imgData.cubeMap ) ) {
+						decodeNames.Append( p.resourceName );
+					}
+				}
+				R_DecodeImages( decodeNames );
+			}
+
 			const preloadEntry_s & p = manifest.GetPreloadByIndex( i );
 			if ( p.resType == PRELOAD_IMAGE && !ExcludePreloadImage( p.resourceName ) ) {
 				globalImages->ImageFromFile( p.resourceName, ( textureFilter_t )p.imgData.filter, ( textureRepeat_t )p.imgData.repeat, ( textureUsage_t )p.imgData.usage, ( cubeFiles_t )p.imgData.cubeMap );
 				numLoaded++;
 			}
 		}
+		R_FreeDecodedImages();
 		//fileSystem->StopPreload();
 		int	end = Sys_Milliseconds();
 		common->Printf( "%05d images preloaded ( or were already loaded ) in %5.1f seconds\n", numLoaded, ( end - start ) * 0.001 );
@@ -794,6 +851,24 @@ idImageManager::LoadLevelImages
 ===============
 */
 int idImageManager::LoadLevelImages( bool pacifier ) {
+	// read the binary images on job threads while the ones before them are uploaded
+	idStrList preloadFiles;
+	if ( fileSystem->UsingResourceFiles() ) {
+		for ( int i = 0 ; i < images.Num() ; i++ ) {
+			idImage	*image = images[ i ];
+			// streamed images only read their small levels
+			if ( image->generatorFunction == NULL && image->levelLoadReferenced && !image->IsLoaded() && !image->CanStream() ) {
+				idStrStatic< MAX_OSPATH > generatedName = image->GetName();
+				idImage::GetGeneratedName( generatedName, image->usage, image->cubeFiles );
+				idStr generatedFileName;
+				idBinaryImage::GetGeneratedFileName( generatedFileName, generatedName );
+				preloadFiles.Append( generatedFileName );
+			}
+		}
+	}
+	fileSystem->StartPreload( preloadFiles );
+
+	const int decodeBatch = image_decodeBatch.GetInteger();
 	int	loadCount = 0;
 	for ( int i = 0 ; i < images.Num() ; i++ ) {
 		if ( pacifier ) {
@@ -801,6 +876,19 @@ int idImageManager::LoadLevelImages( bool pacifier ) {
 
 		}
 
+		if ( decodeBatch > 0 && i % decodeBatch == 0 ) {
+			// decode the source images of the next batch that have to be built again in parallel
+			idStrList decodeNames;
+			for ( int j = i; j < i + decodeBatch && j < images.Num(); j++ ) {
+				const idImage * image = images[ j ];
+				if ( image->generatorFunction == NULL && image->levelLoadReferenced && !image->IsLoaded()
+					&& R_SourceImageOutOfDate( image->GetName(), image->usage, image->cubeFiles ) ) {
+					decodeNames.Append( image->GetName() );
+				}
+			}
+			R_DecodeImages( decodeNames );
+		}
+
 		idImage	*image = images[ i ];
 		if ( image->generatorFunction ) {
 			continue;
@@ -810,6 +898,9 @@ int idImageManager::LoadLevelImages( bool pacifier ) {
 			image->ActuallyLoadImage( false );
 		}
 	}
+	R_FreeDecodedImages();
+
+	fileSystem->StopPreload();
 	return loadCount;
 }
 
@@ -827,6 +918,43 @@ void idImageManager::EndLevelLoad() {
 
 	int	end = Sys_Milliseconds();
 	common->Printf( "%5i images loaded in %5.1f seconds\n", loadCount, (end-start) * 0.001 );
+
+	// report what the BC5 / BC7 overrides save over the formats the images would otherwise use
+	int blockCount = 0;
+	int64 blockSize = 0;
+	int64 defaultSize = 0;
+	for ( int i = 0 ; i < images.Num() ; i++ ) {
+		idImage	*image = images[ i ];
+		if ( !image->levelLoadReferenced || !image->IsLoaded() ) {
+			continue;
+		}
+		const textureFormat_t format = image->GetOpts().format;
+		if ( format != FMT_BC5 && format != FMT_BC7 ) {
+			continue;
+		}
+		idImageOpts	defaultOpts;
+		idImage::DeriveDefaultFormat( image->GetUsage(), defaultOpts );
+		const int size = image->StorageSize();
+		blockCount++;
+		blockSize += size;
+		defaultSize += (int64)size * BitsForFormat( defaultOpts.format ) / BitsForFormat( format );
+	}
+	if ( blockCount > 0 ) {
+		common->Printf( "%5i BC5 / BC7 images: %5.1f MB, %5.1f MB in the default formats, %5.1f MB saved\n", blockCount,
+			blockSize / ( 1024.0 * 1024.0 ), defaultSize / ( 1024.0 * 1024.0 ), ( defaultSize - blockSize ) / ( 1024.0 * 1024.0 ) );
+	}
+
+	if ( streamedImages.Num() > 0 ) {
+		int64 baseBytes = 0;
+		int64 fullBytes = 0;
+		for ( int i = 0 ; i < streamedImages.Num() ; i++ ) {
+			idImage	*image = streamedImages[ i ];
+			baseBytes += image->StreamedLevelsSize( image->stream.baseLevel );
+			fullBytes += image->StreamedLevelsSize( 0 );
+		}
+		common->Printf( "%5i streamed images: %5.1f MB of base levels resident, %5.1f MB with all levels\n", streamedImages.Num(),
+			baseBytes / ( 1024.0 * 1024.0 ), fullBytes / ( 1024.0 * 1024.0 ) );
+	}
 	common->Printf( "----------------------------------------\n" );
 	//R_ListImages_f( idCmdArgs( "sorted sorted", false ) );
 }
@@ -89,7 +89,14 @@ enum textureFormat_t {
 	FMT_RGB565,			// 16 bpp
 	
 	//Special - has to go at end
-	FMT_BGRA8			// 32 bpp
+	FMT_BGRA8,			// 32 bpp
+
+	//------------------------
+	// Block compressed formats, after FMT_BGRA8 so the formats stored in generated images keep their values
+	//------------------------
+
+	FMT_BC5,			// 8 bpp, two channels
+	FMT_BC7				// 8 bpp
 };
 
 int BitsForFormat( textureFormat_t format );
@@ -101,7 +108,7 @@ DXT5 color formats
 */
 enum textureColor_t {
 	CFM_DEFAULT,			// RGBA
-	CFM_NORMAL_DXT5,		// XY format and use the fast DXT5 compressor
+	CFM_NORMAL_DXT5,		// XY format and use the fast DXT5 compressor, or X and Y in red and green for BC5
 	CFM_YCOCG_DXT5,			// convert RGBA to CoCg_Y format
 	CFM_GREEN_ALPHA			// Copy the alpha channel to green
 };
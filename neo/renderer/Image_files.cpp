@@ -114,6 +114,8 @@ void R_WriteTGA( const char *filename, const byte *data, int width, int height,
 static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_TIME_T *timestamp );
 static void LoadJPG( const char *name, byte **pic, int *width, int *height, ID_TIME_T *timestamp );
 
+idCVar image_decodeSIMD( "image_decodeSIMD", "1", CVAR_RENDERER | CVAR_BOOL, "use the SSE2 paths to convert TGA pixels and for the JPEG IDCT and color conversion" );
+
 /*
 ========================================================================
 
@@ -141,34 +143,140 @@ TARGA LOADING
 
 /*
 =============
-LoadTGA
+R_TGAPixelsToRGBA
+
+Converts a span of BGR, BGRA or gray scale pixels to RGBA.
 =============
 */
-static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_TIME_T *timestamp ) {
-	int		columns, rows, numPixels, fileSize, numBytes;
-	byte	*pixbuf;
-	int		row, column;
-	byte	*buf_p;
-	byte	*buffer;
-	TargaHeader	targa_header;
-	byte		*targa_rgba;
+static void R_TGAPixelsToRGBA( byte *dst, const byte *src, int numPixels, int pixelBytes, bool simd ) {
+	int i = 0;
+
+#if defined( ID_WIN_X86_SSE2_INTRIN )
+	if ( simd ) {
+		const __m128i maskGreenAlpha = _mm_set1_epi32( 0xFF00FF00 );
+		const __m128i maskGreen = _mm_set1_epi32( 0x0000FF00 );
+		const __m128i maskLow = _mm_set1_epi32( 0x000000FF );
+		const __m128i alpha = _mm_set1_epi32( 0xFF000000 );
+		if ( pixelBytes == 4 ) {
+			// swap the red and blue bytes of four pixels at a time
+			for ( ; i + 4 <= numPixels; i += 4 ) {
+				const __m128i bgra = _mm_loadu_si128( (const __m128i *)( src + i * 4 ) );
+				const __m128i red = _mm_and_si128( _mm_srli_epi32( bgra, 16 ), maskLow );
+				const __m128i blue = _mm_slli_epi32( _mm_and_si128( bgra, maskLow ), 16 );
+				_mm_storeu_si128( (__m128i *)( dst + i * 4 ), _mm_or_si128( _mm_and_si128( bgra, maskGreenAlpha ), _mm_or_si128( red, blue ) ) );
+			}
+		} else if ( pixelBytes == 3 ) {
+			// spread four packed pixels over dwords, the 16 byte load reaches up to two pixels ahead
+			for ( ; i + 6 <= numPixels; i += 4 ) {
+				const __m128i packed = _mm_loadu_si128( (const __m128i *)( src + i * 3 ) );
+				const __m128i p01 = _mm_unpacklo_epi32( packed, _mm_srli_si128( packed, 3 ) );
+				const __m128i p23 = _mm_unpacklo_epi32( _mm_srli_si128( packed, 6 ), _mm_srli_si128( packed, 9 ) );
+				const __m128i bgr = _mm_unpacklo_epi64( p01, p23 );
+				const __m128i red = _mm_and_si128( _mm_srli_epi32( bgr, 16 ), maskLow );
+				const __m128i blue = _mm_slli_epi32( _mm_and_si128( bgr, maskLow ), 16 );
+				const __m128i green = _mm_or_si128( _mm_and_si128( bgr, maskGreen ), alpha );
+				_mm_storeu_si128( (__m128i *)( dst + i * 4 ), _mm_or_si128( green, _mm_or_si128( red, blue ) ) );
+			}
+		} else if ( pixelBytes == 1 ) {
+			// widen sixteen gray values at a time
+			const __m128i opaque = _mm_set1_epi8( (char)0xFF );
+			for ( ; i + 16 <= numPixels; i += 16 ) {
+				const __m128i gray = _mm_loadu_si128( (const __m128i *)( src + i ) );
+				const __m128i grayGrayLo = _mm_unpacklo_epi8( gray, gray );
+				const __m128i grayGrayHi = _mm_unpackhi_epi8( gray, gray );
+				const __m128i grayAlphaLo = _mm_unpacklo_epi8( gray, opaque );
+				const __m128i grayAlphaHi = _mm_unpackhi_epi8( gray, opaque );
+				_mm_storeu_si128( (__m128i *)( dst + i * 4 + 0 ), _mm_unpacklo_epi16( grayGrayLo, grayAlphaLo ) );
+				_mm_storeu_si128( (__m128i *)( dst + i * 4 + 16 ), _mm_unpackhi_epi16( grayGrayLo, grayAlphaLo ) );
+				_mm_storeu_si128( (__m128i *)( dst + i * 4 + 32 ), _mm_unpacklo_epi16( grayGrayHi, grayAlphaHi ) );
+				_mm_storeu_si128( (__m128i *)( dst + i * 4 + 48 ), _mm_unpackhi_epi16( grayGrayHi, grayAlphaHi ) );
+			}
+		}
+	}
+#endif
+
+	src += i * pixelBytes;
+	dst += i * 4;
+	for ( ; i < numPixels; i++ ) {
+		switch( pixelBytes ) {
+			case 1:
+				dst[0] = src[0];
+				dst[1] = src[0];
+				dst[2] = src[0];
+				dst[3] = 255;
+				break;
+			case 3:
+				dst[0] = src[2];
+				dst[1] = src[1];
+				dst[2] = src[0];
+				dst[3] = 255;
+				break;
+			case 4:
+				dst[0] = src[2];
+				dst[1] = src[1];
+				dst[2] = src[0];
+				dst[3] = src[3];
+				break;
+		}
+		src += pixelBytes;
+		dst += 4;
+	}
+}
 
-	if ( !pic ) {
-		fileSystem->ReadFile( name, NULL, timestamp );
-		return;	// just getting timestamp
+/*
+=============
+R_TGAFillRGBA
+
+Repeats the pixel of a run-length packet.
+=============
+*/
+static void R_TGAFillRGBA( byte *dst, const byte rgba[4], int numPixels, bool simd ) {
+	int i = 0;
+
+#if defined( ID_WIN_X86_SSE2_INTRIN )
+	if ( simd ) {
+		int pixel;
+		memcpy( &pixel, rgba, 4 );
+		const __m128i run = _mm_set1_epi32( pixel );
+		for ( ; i + 4 <= numPixels; i += 4 ) {
+			_mm_storeu_si128( (__m128i *)( dst + i * 4 ), run );
+		}
+	}
+#endif
+
+	for ( ; i < numPixels; i++ ) {
+		dst[i * 4 + 0] = rgba[0];
+		dst[i * 4 + 1] = rgba[1];
+		dst[i * 4 + 2] = rgba[2];
+		dst[i * 4 + 3] = rgba[3];
 	}
+}
+
+/*
+=============
+R_DecodeTGA
+
+Decodes a TGA file that is already in memory. Returns false with a message in
+error if the file can't be decoded, which leaves *pic NULL. The rows are written
+straight to their final place, bottom to top unless the flip bit is set.
+=============
+*/
+static bool R_DecodeTGA( const byte *buffer, int fileSize, byte **pic, int *width, int *height, bool simd, idStr &error ) {
+	int			columns, rows, numPixels, numBytes, pixelBytes;
+	const byte	*buf_p;
+	const byte	*end;
+	TargaHeader	targa_header;
+	byte		*targa_rgba;
 
 	*pic = NULL;
 
-	//
-	// load the file
-	//
-	fileSize = fileSystem->ReadFile( name, (void **)&buffer, timestamp );
-	if ( !buffer ) {
-		return;
+	if ( fileSize < 18 ) {
+		error = "incomplete file";
+		return false;
 	}
 
 	buf_p = buffer;
+	end = buffer + fileSize;
 
 	targa_header.id_length = *buf_p++;
 	targa_header.colormap_type = *buf_p++;
@@ -191,21 +299,31 @@ static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_T
 	targa_header.attributes = *buf_p++;
 
 	if ( targa_header.image_type != 2 && targa_header.image_type != 10 && targa_header.image_type != 3 ) {
-		common->Error( "LoadTGA( %s ): Only type 2 (RGB), 3 (gray), and 10 (RGB) TGA images supported\n", name );
+		error = "Only type 2 (RGB), 3 (gray), and 10 (RGB) TGA images supported";
+		return false;
 	}
 
 	if ( targa_header.colormap_type != 0 ) {
-		common->Error( "LoadTGA( %s ): colormaps not supported\n", name );
+		error = "colormaps not supported";
+		return false;
 	}
 
 	if ( ( targa_header.pixel_size != 32 && targa_header.pixel_size != 24 ) && targa_header.image_type != 3 ) {
-		common->Error( "LoadTGA( %s ): Only 32 or 24 bit images supported (no colormaps)\n", name );
+		error = "Only 32 or 24 bit images supported (no colormaps)";
+		return false;
+	}
+
+	pixelBytes = targa_header.pixel_size >> 3;
+	if ( ( pixelBytes != 1 && pixelBytes != 3 && pixelBytes != 4 ) || ( targa_header.image_type == 10 && pixelBytes == 1 ) ) {
+		error.Format( "illegal pixel_size '%d'", targa_header.pixel_size );
+		return false;
 	}
 
 	if ( targa_header.image_type == 2 || targa_header.image_type == 3 ) {
-		numBytes = targa_header.width * targa_header.height * ( targa_header.pixel_size >> 3 );
+		numBytes = targa_header.width * targa_header.height * pixelBytes;
 		if ( numBytes > fileSize - 18 - targa_header.id_length ) {
-			common->Error( "LoadTGA( %s ): incomplete file\n", name );
+			error = "incomplete file";
+			return false;
 		}
 	}
 
@@ -213,166 +331,106 @@ static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_T
 	rows = targa_header.height;
 	numPixels = columns * rows;
 
-	if ( width ) {
-		*width = columns;
-	}
-	if ( height ) {
-		*height = rows;
-	}
+	*width = columns;
+	*height = rows;
 
 	targa_rgba = (byte *)R_StaticAlloc(numPixels*4, TAG_IMAGE);
-	*pic = targa_rgba;
 
-	if ( targa_header.id_length != 0 ) {
-		buf_p += targa_header.id_length;  // skip TARGA image comment
-	}
+	buf_p += targa_header.id_length;  // skip TARGA image comment
+
+	// the file stores the bottom row first, unless the flip bit is set
+	const bool topDown = ( targa_header.attributes & (1<<5) ) != 0;
 	
-	if ( targa_header.image_type == 2 || targa_header.image_type == 3 )
-	{ 
+	if ( targa_header.image_type == 2 || targa_header.image_type == 3 ) {
 		// Uncompressed RGB or gray scale image
-		for( row = rows - 1; row >= 0; row-- )
-		{
-			pixbuf = targa_rgba + row*columns*4;
-			for( column = 0; column < columns; column++)
-			{
-				unsigned char red,green,blue,alphabyte;
-				switch( targa_header.pixel_size )
-				{
-					
-				case 8:
-					blue = *buf_p++;
-					green = blue;
-					red = blue;
-					*pixbuf++ = red;
-					*pixbuf++ = green;
-					*pixbuf++ = blue;
-					*pixbuf++ = 255;
-					break;
+		for ( int row = 0; row < rows; row++ ) {
+			byte *pixbuf = targa_rgba + ( topDown ? row : rows - 1 - row ) * columns * 4;
+			R_TGAPixelsToRGBA( pixbuf, buf_p, columns, pixelBytes, simd );
+			buf_p += columns * pixelBytes;
+		}
+	} else {
+		// Runlength encoded RGB images, packets may span across rows
+		int pixel = 0;
+		while ( pixel < numPixels ) {
+			if ( buf_p >= end ) {
+				break;
+			}
+			const byte packetHeader = *buf_p++;
+			const int packetSize = Min( 1 + ( packetHeader & 0x7f ), numPixels - pixel );
+			const bool runLength = ( packetHeader & 0x80 ) != 0;
+			const int packetBytes = runLength ? pixelBytes : packetSize * pixelBytes;
+			if ( end - buf_p < packetBytes ) {
+				break;
+			}
 
-				case 24:
-					blue = *buf_p++;
-					green = *buf_p++;
-					red = *buf_p++;
-					*pixbuf++ = red;
-					*pixbuf++ = green;
-					*pixbuf++ = blue;
-					*pixbuf++ = 255;
-					break;
-				case 32:
-					blue = *buf_p++;
-					green = *buf_p++;
-					red = *buf_p++;
-					alphabyte = *buf_p++;
-					*pixbuf++ = red;
-					*pixbuf++ = green;
-					*pixbuf++ = blue;
-					*pixbuf++ = alphabyte;
-					break;
-				default:
-					common->Error( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
-					break;
-				}
+			byte rgba[4];
+			if ( runLength ) {
+				R_TGAPixelsToRGBA( rgba, buf_p, 1, pixelBytes, false );
 			}
-		}
-	}
-	else if ( targa_header.image_type == 10 ) {   // Runlength encoded RGB images
-		unsigned char red,green,blue,alphabyte,packetHeader,packetSize,j;
-
-		red = 0;
-		green = 0;
-		blue = 0;
-		alphabyte = 0xff;
-
-		for( row = rows - 1; row >= 0; row-- ) {
-			pixbuf = targa_rgba + row*columns*4;
-			for( column = 0; column < columns; ) {
-				packetHeader= *buf_p++;
-				packetSize = 1 + (packetHeader & 0x7f);
-				if ( packetHeader & 0x80 ) {        // run-length packet
-					switch( targa_header.pixel_size ) {
-						case 24:
-								blue = *buf_p++;
-								green = *buf_p++;
-								red = *buf_p++;
-								alphabyte = 255;
-								break;
-						case 32:
-								blue = *buf_p++;
-								green = *buf_p++;
-								red = *buf_p++;
-								alphabyte = *buf_p++;
-								break;
-						default:
-							common->Error( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
-							break;
-					}
-	
-					for( j = 0; j < packetSize; j++ ) {
-						*pixbuf++=red;
-						*pixbuf++=green;
-						*pixbuf++=blue;
-						*pixbuf++=alphabyte;
-						column++;
-						if ( column == columns ) { // run spans across rows
-							column = 0;
-							if ( row > 0) {
-								row--;
-							}
-							else {
-								goto breakOut;
-							}
-							pixbuf = targa_rgba + row*columns*4;
-						}
-					}
-				}
-				else {                            // non run-length packet
-					for( j = 0; j < packetSize; j++ ) {
-						switch( targa_header.pixel_size ) {
-							case 24:
-									blue = *buf_p++;
-									green = *buf_p++;
-									red = *buf_p++;
-									*pixbuf++ = red;
-									*pixbuf++ = green;
-									*pixbuf++ = blue;
-									*pixbuf++ = 255;
-									break;
-							case 32:
-									blue = *buf_p++;
-									green = *buf_p++;
-									red = *buf_p++;
-									alphabyte = *buf_p++;
-									*pixbuf++ = red;
-									*pixbuf++ = green;
-									*pixbuf++ = blue;
-									*pixbuf++ = alphabyte;
-									break;
-							default:
-								common->Error( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
-								break;
-						}
-						column++;
-						if ( column == columns ) { // pixel packet run spans across rows
-							column = 0;
-							if ( row > 0 ) {
-								row--;
-							}
-							else {
-								goto breakOut;
-							}
-							pixbuf = targa_rgba + row*columns*4;
-						}						
-					}
+
+			for ( int done = 0; done < packetSize; ) {
+				const int row = pixel / columns;
+				const int column = pixel - row * columns;
+				const int count = Min( packetSize - done, columns - column );
+				byte *pixbuf = targa_rgba + ( ( topDown ? row : rows - 1 - row ) * columns + column ) * 4;
+				if ( runLength ) {
+					R_TGAFillRGBA( pixbuf, rgba, count, simd );
+				} else {
+					R_TGAPixelsToRGBA( pixbuf, buf_p + done * pixelBytes, count, pixelBytes, simd );
 				}
+				done += count;
+				pixel += count;
 			}
-			breakOut: ;
+			buf_p += packetBytes;
+		}
+		if ( pixel < numPixels ) {
+			R_StaticFree( targa_rgba );
+			error = "incomplete file";
+			return false;
 		}
 	}
 
-	if ( (targa_header.attributes & (1<<5)) ) {			// image flp bit
-		if ( width != NULL && height != NULL ) {
-			R_VerticalFlip( *pic, *width, *height );
-		}
+	*pic = targa_rgba;
+	return true;
+}
+
+/*
+=============
+LoadTGA
+=============
+*/
+static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_TIME_T *timestamp ) {
+	byte	*buffer;
+	int		fileSize;
+	int		columns, rows;
+	idStr	error;
+
+	if ( !pic ) {
+		fileSystem->ReadFile( name, NULL, timestamp );
+		return;	// just getting timestamp
+	}
+
+	*pic = NULL;
+
+	//
+	// load the file
+	//
+	fileSize = fileSystem->ReadFile( name, (void **)&buffer, timestamp );
+	if ( !buffer ) {
+		return;
+	}
+
+	if ( !R_DecodeTGA( buffer, fileSize, pic, &columns, &rows, image_decodeSIMD.GetBool(), error ) ) {
+		fileSystem->FreeFile( buffer );
+		common->Error( "LoadTGA( %s ): %s\n", name, error.c_str() );
+		return;
+	}
+
+	if ( width ) {
+		*width = columns;
+	}
+	if ( height ) {
+		*height = rows;
 	}
 
 	fileSystem->FreeFile( buffer );
@@ -389,18 +447,16 @@ Interfaces with the huge libjpeg
 
 /*
 =============
-LoadJPG
+R_DecodeJPG
+
+Decodes a JPG file that is already in memory, libjpeg reads it in place.
 =============
 */
-static void LoadJPG( const char *filename, unsigned char **pic, int *width, int *height, ID_TIME_T *timestamp ) {
+static void R_DecodeJPG( const char *filename, const byte *fbuffer, int len, byte **pic, int *width, int *height, bool simd ) {
   /* This struct contains the JPEG decompression parameters and pointers to
    * working space (which is allocated as needed by the JPEG library).
    */
   struct jpeg_decompress_struct cinfo;
-  /* We use our private extension JPEG error handler.
-   * Note that this struct must live as long as the main JPEG parameter
-   * struct, to avoid dangling-pointer problems.
-   */
   /* This struct represents a JPEG error handler.  It is declared separately
    * because applications often want to supply a specialized error handler
    * (see the second half of this file for an example).  But here we just
@@ -414,41 +470,9 @@ static void LoadJPG( const char *filename, unsigned char **pic, int *width, int
   JSAMPARRAY buffer;		/* Output row buffer */
   int row_stride;		/* physical row width in output buffer */
   unsigned char *out;
-  byte	*fbuffer;
   byte  *bbuf;
 
-  /* In this example we want to open the input file before doing anything else,
-   * so that the setjmp() error recovery below can assume the file is open.
-   * VERY IMPORTANT: use "b" option to fopen() if you are on a machine that
-   * requires it in order to read binary files.
-   */
-
-	// JDC: because fill_input_buffer() blindly copies INPUT_BUF_SIZE bytes,
-	// we need to make sure the file buffer is padded or it may crash
-  if ( pic ) {
-	*pic = NULL;		// until proven otherwise
-  }
-  {
-		int		len;
-		idFile *f;
-
-		f = fileSystem->OpenFileRead( filename );
-		if ( !f ) {
-			return;
-		}
-		len = f->Length();
-		if ( timestamp ) {
-			*timestamp = f->Timestamp();
-		}
-		if ( !pic ) {
-			fileSystem->CloseFile( f );
-			return;	// just getting timestamp
-		}
-		fbuffer = (byte *)Mem_ClearedAlloc( len + 4096, TAG_JPG );
-		f->Read( fbuffer, len );
-		fileSystem->CloseFile( f );
-  }
-
+  *pic = NULL;		// until proven otherwise
 
   /* Step 1: allocate and initialize JPEG decompression object */
 
@@ -462,46 +486,40 @@ static void LoadJPG( const char *filename, unsigned char **pic, int *width, int
   /* Now we can initialize the JPEG decompression object. */
   jpeg_create_decompress(&cinfo);
 
-  /* Step 2: specify data source (eg, a file) */
+  /* Step 2: specify data source, the whole file in memory */
 
-  jpeg_stdio_src(&cinfo, fbuffer);
+  jpeg_mem_src(&cinfo, fbuffer, len);
 
   /* Step 3: read file parameters with jpeg_read_header() */
 
   (void) jpeg_read_header(&cinfo, true );
   /* We can ignore the return value from jpeg_read_header since
-   *   (a) suspension is not possible with the stdio data source, and
+   *   (a) suspension is not possible with the memory data source, and
    *   (b) we passed TRUE to reject a tables-only JPEG file as an error.
    * See libjpeg.doc for more info.
    */
 
   /* Step 4: set parameters for decompression */
 
-  /* In this example, we don't need to change any of the defaults set by
-   * jpeg_read_header(), so we do nothing here.
-   */
+  cinfo.do_simd = simd;
 
   /* Step 5: Start decompressor */
 
   (void) jpeg_start_decompress(&cinfo);
   /* We can ignore the return value since suspension is not possible
-   * with the stdio data source.
+   * with the memory data source.
    */
 
-  /* We may need to do some setup of our own at this point before reading
-   * the data.  After jpeg_start_decompress() we have the correct scaled
-   * output image dimensions available, as well as the output colormap
-   * if we asked for color quantization.
-   * In this example, we need to make an output work buffer of the right size.
-   */ 
   /* JSAMPLEs per row in output buffer */
   row_stride = cinfo.output_width * cinfo.output_components;
 
+  out = (byte *)R_StaticAlloc(cinfo.output_width*cinfo.output_height*4, TAG_IMAGE);
   if (cinfo.output_components!=4) {
 		common->DWarning( "JPG %s is unsupported color depth (%d)", 
 			filename, cinfo.output_components);
+		// the rows don't fill the image, don't leave the rest uninitialized
+		memset( out, 0, cinfo.output_width*cinfo.output_height*4 );
   }
-  out = (byte *)R_StaticAlloc(cinfo.output_width*cinfo.output_height*4, TAG_IMAGE);
 
   *pic = out;
   *width = cinfo.output_width;
@@ -514,10 +532,6 @@ static void LoadJPG( const char *filename, unsigned char **pic, int *width, int
    * loop counter, so that we don't have to keep track ourselves.
    */
   while (cinfo.output_scanline < cinfo.output_height) {
-    /* jpeg_read_scanlines expects an array of pointers to scanlines.
-     * Here the array is only one element long, but you could ask for
-     * more than one scanline at a time if that's more convenient.
-     */
 	bbuf = ((out+(row_stride*cinfo.output_scanline)));
 	buffer = &bbuf;
     (void) jpeg_read_scanlines(&cinfo, buffer, 1);
@@ -531,7 +545,17 @@ static void LoadJPG( const char *filename, unsigned char **pic, int *width, int
 		buf = *pic;
 
 	  j = cinfo.output_width * cinfo.output_height * 4;
-	  for ( i = 3 ; i < j ; i+=4 ) {
+	  i = 3;
+#if defined( ID_WIN_X86_SSE2_INTRIN )
+	  if ( simd ) {
+		  const __m128i alpha = _mm_set1_epi32( 0xFF000000 );
+		  for ( ; i + 13 <= j ; i+=16 ) {
+			  __m128i * pixels = (__m128i *)( buf + i - 3 );
+			  _mm_storeu_si128( pixels, _mm_or_si128( _mm_loadu_si128( pixels ), alpha ) );
+		  }
+	  }
+#endif
+	  for ( ; i < j ; i+=4 ) {
 		  buf[i] = 255;
 	  }
   }
@@ -540,7 +564,7 @@ static void LoadJPG( const char *filename, unsigned char **pic, int *width, int
 
   (void) jpeg_finish_decompress(&cinfo);
   /* We can ignore the return value since suspension is not possible
-   * with the stdio data source.
+   * with the memory data source.
    */
 
   /* Step 8: Release JPEG decompression object */
@@ -548,13 +572,6 @@ static void LoadJPG( const char *filename, unsigned char **pic, int *width, int
   /* This is an important step since it will release a good deal of memory. */
   jpeg_destroy_decompress(&cinfo);
 
-  /* After finish_decompress, we can close the input file.
-   * Here we postpone it until after no more JPEG errors are possible,
-   * so as to simplify the setjmp error logic above.  (Actually, I don't
-   * think that jpeg_destroy can do an error exit, but why assume anything...)
-   */
-  Mem_Free( fbuffer );
-
   /* At this point you may want to check to see whether any corrupt-data
    * warnings occurred (test whether jerr.pub.num_warnings is nonzero).
    */
@@ -562,6 +579,353 @@ static void LoadJPG( const char *filename, unsigned char **pic, int *width, int
   /* And we're done! */
 }
 
+/*
+=============
+LoadJPG
+=============
+*/
+static void LoadJPG( const char *filename, unsigned char **pic, int *width, int *height, ID_TIME_T *timestamp ) {
+	byte	*fbuffer;
+	int		len;
+	int		columns, rows;
+
+	if ( !pic ) {
+		idFile *f = fileSystem->OpenFileRead( filename );
+		if ( f ) {
+			if ( timestamp ) {
+				*timestamp = f->Timestamp();
+			}
+			fileSystem->CloseFile( f );
+		}
+		return;	// just getting timestamp
+	}
+
+	*pic = NULL;
+
+	len = fileSystem->ReadFile( filename, (void **)&fbuffer, timestamp );
+	if ( !fbuffer ) {
+		return;
+	}
+
+	R_DecodeJPG( filename, fbuffer, len, pic, &columns, &rows, image_decodeSIMD.GetBool() );
+	*width = columns;
+	*height = rows;
+
+	fileSystem->FreeFile( fbuffer );
+}
+
+/*
+=========================================================
+
+DECODING AHEAD
+
+During level loads the source images of the images that have to be
+built again are read with the asynchronous file reads and decoded on
+the job threads a batch at a time. R_LoadImage hands the decoded
+images out instead of loading the files itself.
+
+=========================================================
+*/
+
+struct imageDecode_t {
+	idStr				name;			// the way R_LoadImage looks it up
+	ID_TIME_T			timestamp;
+	bool				jpg;
+	bool				simd;
+	fileReadRequest_t	read;
+	byte *				pic;
+	int					width;
+	int					height;
+};
+
+static idList< imageDecode_t *, TAG_IMAGE > decodedImages;
+
+/*
+=================
+R_ImageFileName
+
+Defaults the extension to tga and lower cases the name, returns false if it
+is too short to be an image file.
+=================
+*/
+static bool R_ImageFileName( idStr &name, idStr &ext ) {
+	name.DefaultFileExtension( ".tga" );
+
+	if (name.Length()<5) {
+		return false;
+	}
+
+	name.ToLower();
+	name.ExtractFileExtension( ext );
+	return true;
+}
+
+/*
+=================
+R_DecodeImageJob
+
+A TGA that fails to decode is left for the main thread to raise the error.
+=================
+*/
+static void R_DecodeImageJob( imageDecode_t * decode ) {
+	decode->pic = NULL;
+	if ( !fileSystem->WaitForRead( &decode->read ) ) {
+		return;
+	}
+	if ( decode->jpg ) {
+		R_DecodeJPG( decode->read.fileName.c_str(), decode->read.data, decode->read.bytesRead, &decode->pic, &decode->width, &decode->height, decode->simd );
+	} else {
+		idStr error;
+		R_DecodeTGA( decode->read.data, decode->read.bytesRead, &decode->pic, &decode->width, &decode->height, decode->simd, error );
+	}
+}
+REGISTER_PARALLEL_JOB( R_DecodeImageJob, "R_DecodeImageJob" );
+
+/*
+=================
+R_RunDecodeJobs
+=================
+*/
+static void R_RunDecodeJobs( imageDecode_t ** decodes, int numDecodes ) {
+	idParallelJobList * jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_HIGH, numDecodes, 0, NULL );
+	for ( int i = 0; i < numDecodes; i++ ) {
+		jobList->AddJob( (jobRun_t)R_DecodeImageJob, decodes[i] );
+	}
+	jobList->Submit();
+	jobList->Wait();
+	parallelJobManager->FreeJobList( jobList );
+}
+
+/*
+=================
+R_DecodeImages
+
+Finds the files the same way R_LoadImage does, queues the reads and decodes
+them all in parallel. Decoded images that R_LoadImage didn't take are freed by
+the next batch or R_FreeDecodedImages.
+=================
+*/
+void R_DecodeImages( const idStrList &names ) {
+	R_FreeDecodedImages();
+
+	// reads have to be queued and jobs submitted from the main thread
+	if ( names.Num() == 0 || !idLib::IsMainThread() ) {
+		return;
+	}
+
+	for ( int i = 0; i < names.Num(); i++ ) {
+		idStr name = names[i];
+		idStr ext;
+		if ( !R_ImageFileName( name, ext ) ) {
+			continue;
+		}
+
+		// try tga first
+		idStr fileName = name;
+		ID_TIME_T timestamp = FILE_NOT_FOUND_TIMESTAMP;
+		bool jpg = ( ext == "jpg" );
+		if ( ext == "tga" ) {
+			LoadTGA( fileName.c_str(), NULL, NULL, NULL, &timestamp );
+			if ( timestamp == FILE_NOT_FOUND_TIMESTAMP ) {
+				fileName.StripFileExtension();
+				fileName.DefaultFileExtension( ".jpg" );
+				jpg = true;
+			}
+		} else if ( !jpg ) {
+			continue;
+		}
+		if ( jpg ) {
+			LoadJPG( fileName.c_str(), NULL, NULL, NULL, &timestamp );
+		}
+		if ( timestamp == FILE_NOT_FOUND_TIMESTAMP ) {
+			continue;
+		}
+
+		imageDecode_t * decode = new (TAG_IMAGE) imageDecode_t;
+		decode->name = name;
+		decode->timestamp = timestamp;
+		decode->jpg = jpg;
+		decode->simd = image_decodeSIMD.GetBool();
+		decode->pic = NULL;
+		decode->width = 0;
+		decode->height = 0;
+		decode->read.fileName = fileName;
+		decode->read.priority = FILE_READ_PRIORITY_NORMAL;
+		if ( !fileSystem->ReadFileAsync( &decode->read ) ) {
+			delete decode;
+			continue;
+		}
+		decodedImages.Append( decode );
+	}
+
+	if ( decodedImages.Num() == 0 ) {
+		return;
+	}
+
+	R_RunDecodeJobs( decodedImages.Ptr(), decodedImages.Num() );
+
+	// only the decoded pixels are kept
+	for ( int i = 0; i < decodedImages.Num(); i++ ) {
+		Mem_Free( decodedImages[i]->read.data );
+		decodedImages[i]->read.data = NULL;
+	}
+}
+
+/*
+=================
+R_FreeDecodedImages
+=================
+*/
+void R_FreeDecodedImages() {
+	for ( int i = 0; i < decodedImages.Num(); i++ ) {
+		if ( decodedImages[i]->pic != NULL ) {
+			R_StaticFree( decodedImages[i]->pic );
+		}
+		delete decodedImages[i];
+	}
+	decodedImages.Clear();
+}
+
+/*
+=================
+R_TakeDecodedImage
+=================
+*/
+static bool R_TakeDecodedImage( const idStr &name, byte **pic, int *width, int *height, ID_TIME_T *timestamp ) {
+	if ( pic == NULL || decodedImages.Num() == 0 || !idLib::IsMainThread() ) {
+		return false;
+	}
+	for ( int i = 0; i < decodedImages.Num(); i++ ) {
+		imageDecode_t * decode = decodedImages[i];
+		if ( decode->pic == NULL || decode->name != name ) {
+			continue;
+		}
+		*pic = decode->pic;
+		decode->pic = NULL;
+		if ( width ) {
+			*width = decode->width;
+		}
+		if ( height ) {
+			*height = decode->height;
+		}
+		if ( timestamp ) {
+			*timestamp = decode->timestamp;
+		}
+		return true;
+	}
+	return false;
+}
+
+/*
+=================
+benchmarkImageDecode
+
+Decodes the TGA and JPG source images with the scalar code, the SIMD code and
+the SIMD code on the job threads, and reports the throughput of each. The files
+are read into memory first so only the decoding is timed.
+=================
+*/
+CONSOLE_COMMAND( benchmarkImageDecode, "times decoding the TGA and JPG source images, usage: benchmarkImageDecode [numImages]", 0 ) {
+	const int maxImages = ( args.Argc() > 1 ) ? Max( atoi( args.Argv( 1 ) ), 1 ) : INT_MAX;
+	const int batchSize = 32;
+
+	idFileList * fileLists[2] = { fileSystem->ListFilesTree( "textures", ".tga", true ), fileSystem->ListFilesTree( "textures", ".jpg", true ) };
+	idStrList files;
+	for ( int i = 0; i < 2; i++ ) {
+		files.Append( fileLists[i]->GetList() );
+		fileSystem->FreeFileList( fileLists[i] );
+	}
+
+	imageDecode_t * decodes[3];
+	for ( int pass = 0; pass < 3; pass++ ) {
+		decodes[pass] = new (TAG_TEMP) imageDecode_t[batchSize];
+	}
+	imageDecode_t * jobDecodes[batchSize];
+
+	int numImages = 0;
+	int numMismatched = 0;
+	double megaPixels = 0.0;
+	double megaBytes = 0.0;
+	uint64 decodeMicroseconds[3] = { 0, 0, 0 };
+
+	for ( int first = 0; first < files.Num() && numImages < maxImages; first += batchSize ) {
+		int numDecodes = 0;
+
+		for ( int i = first; i < files.Num() && i < first + batchSize && numImages + numDecodes < maxImages; i++ ) {
+			byte * buffer = NULL;
+			const int length = fileSystem->ReadFile( files[i], (void **)&buffer, NULL );
+			if ( buffer == NULL ) {
+				continue;
+			}
+			for ( int pass = 0; pass < 3; pass++ ) {
+				imageDecode_t & decode = decodes[pass][numDecodes];
+				decode.jpg = ( idStr::Icmp( files[i].Right( 4 ), ".jpg" ) == 0 );
+				decode.simd = ( pass != 0 );
+				decode.read.fileName = files[i];
+				decode.read.data = buffer;
+				decode.read.bytesRead = length;
+				decode.pic = NULL;
+			}
+			jobDecodes[numDecodes] = &decodes[2][numDecodes];
+			megaBytes += length / ( 1024.0 * 1024.0 );
+			numDecodes++;
+		}
+
+		for ( int pass = 0; pass < 3; pass++ ) {
+			const uint64 start = Sys_Microseconds();
+			if ( pass == 2 ) {
+				R_RunDecodeJobs( jobDecodes, numDecodes );
+			} else {
+				for ( int i = 0; i < numDecodes; i++ ) {
+					R_DecodeImageJob( &decodes[pass][i] );
+				}
+			}
+			decodeMicroseconds[pass] += Sys_Microseconds() - start;
+		}
+
+		for ( int i = 0; i < numDecodes; i++ ) {
+			const imageDecode_t & scalar = decodes[0][i];
+			for ( int pass = 1; pass < 3; pass++ ) {
+				const imageDecode_t & decode = decodes[pass][i];
+				if ( ( scalar.pic == NULL ) != ( decode.pic == NULL ) || ( scalar.pic != NULL && ( scalar.width != decode.width || scalar.height != decode.height
+					|| memcmp( scalar.pic, decode.pic, scalar.width * scalar.height * 4 ) != 0 ) ) ) {
+					numMismatched++;
+					break;
+				}
+			}
+			if ( scalar.pic != NULL ) {
+				megaPixels += scalar.width * scalar.height / ( 1024.0 * 1024.0 );
+				numImages++;
+			}
+			fileSystem->FreeFile( decodes[0][i].read.data );
+			for ( int pass = 0; pass < 3; pass++ ) {
+				if ( decodes[pass][i].pic != NULL ) {
+					R_StaticFree( decodes[pass][i].pic );
+				}
+				decodes[pass][i].read.data = NULL;
+			}
+		}
+	}
+
+	for ( int pass = 0; pass < 3; pass++ ) {
+		delete[] decodes[pass];
+	}
+
+	if ( numImages == 0 ) {
+		common->Printf( "no images found\n" );
+		return;
+	}
+
+	common->Printf( "%d images, %.1f megapixels, %.1f MB of files, %d job threads\n", numImages, megaPixels, megaBytes, parallelJobManager->GetNumProcessingUnits() );
+	const char * passNames[3] = { "scalar", "SIMD", "jobs" };
+	for ( int pass = 0; pass < 3; pass++ ) {
+		const double seconds = Max( decodeMicroseconds[pass], (uint64)1 ) / 1000000.0;
+		common->Printf( "%8s: %8.1f msec, %7.2f MP/s\n", passNames[pass], seconds * 1000.0, megaPixels / seconds );
+	}
+	common->Printf( "SIMD speedup %.2fx, jobs speedup %.2fx, %d images differ from the scalar decode\n", (double)decodeMicroseconds[0] / Max( decodeMicroseconds[1], (uint64)1 ),
+		(double)decodeMicroseconds[0] / Max( decodeMicroseconds[2], (uint64)1 ), numMismatched );
+}
+
 //===================================================================
 
 /*
@@ -604,17 +968,14 @@ void R_LoadImage( const char *cname, byte **pic, int *width, int *height, ID_TIM
 		*height = 0;
 	}
 
-	name.DefaultFileExtension( ".tga" );
-
-	if (name.Length()<5) {
+	idStr ext;
+	if ( !R_ImageFileName( name, ext ) ) {
 		return;
 	}
 
-	name.ToLower();
-	idStr ext;
-	name.ExtractFileExtension( ext );
-
-	if ( ext == "tga" ) {
+	if ( R_TakeDecodedImage( name, pic, width, height, timestamp ) ) {
+		// decoded ahead on the job threads
+	} else if ( ext == "tga" ) {
 		LoadTGA( name.c_str(), pic, width, height, timestamp );            // try tga first
 		if ( ( pic && *pic == 0 ) || ( timestamp && *timestamp == -1 ) ) { //-V595
 			name.StripFileExtension();
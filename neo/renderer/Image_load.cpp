@@ -31,6 +31,11 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "tr_local.h"
 
+idCVar image_useBC5( "image_useBC5", "0", CVAR_RENDERER | CVAR_BOOL | CVAR_ARCHIVE, "compress normal maps to BC5 instead of DXT5" );
+idCVar image_useBC7( "image_useBC7", "0", CVAR_RENDERER | CVAR_INTEGER | CVAR_ARCHIVE, "compress these usages to BC7 (8 bpp): 1 = diffuse, 2 = specular (twice the memory of DXT1), 4 = default, 8 = light (half the memory of RGB565)" );
+
+extern idCVar image_streamMinSize;
+
 /*
 ================
 BitsForFormat
@@ -49,6 +54,8 @@ int BitsForFormat( textureFormat_t format ) {
 		case FMT_INT8:		return 8;
 		case FMT_DXT1:		return 4;
 		case FMT_DXT5:		return 8;
+		case FMT_BC5:		return 8;
+		case FMT_BC7:		return 8;
 		case FMT_DEPTH: {
 #ifdef DOOM3_VULKAN
 			if (r_openGL.GetBool())
@@ -67,6 +74,100 @@ int BitsForFormat( textureFormat_t format ) {
 	}
 }
 
+/*
+========================
+idImage::DeriveDefaultFormat
+========================
+*/
+void idImage::DeriveDefaultFormat( textureUsage_t usage, idImageOpts & opts ) {
+	opts.colorFormat = CFM_DEFAULT;
+
+	switch ( usage ) {
+		case TD_COVERAGE:
+			opts.format = FMT_DXT1;
+			opts.colorFormat = CFM_GREEN_ALPHA;
+			break;
+		case TD_DEPTH:
+			opts.format = FMT_DEPTH;
+			break;
+		case TD_DIFFUSE: 
+			// TD_DIFFUSE gets only set to when its a diffuse texture for an interaction
+			opts.gammaMips = true;
+			opts.format = FMT_DXT5;
+			opts.colorFormat = CFM_YCOCG_DXT5;
+			break;
+		case TD_SPECULAR:
+			opts.gammaMips = true;
+			opts.format = FMT_DXT1;
+			opts.colorFormat = CFM_DEFAULT;
+			break;
+		case TD_DEFAULT:
+			opts.gammaMips = true;
+			opts.format = FMT_DXT5;
+			opts.colorFormat = CFM_DEFAULT;
+			break;
+		case TD_BUMP:
+			opts.format = FMT_DXT5;
+			opts.colorFormat = CFM_NORMAL_DXT5;
+			break;
+		case TD_FONT:
+			opts.format = FMT_DXT1;
+			opts.colorFormat = CFM_GREEN_ALPHA;
+			opts.numLevels = 4; // We only support 4 levels because we align to 16 in the exporter
+			opts.gammaMips = true;
+			break;
+		case TD_LIGHT:
+			opts.format = FMT_RGB565;
+			opts.gammaMips = true;
+			break;
+		case TD_LOOKUP_TABLE_MONO:
+			opts.format = FMT_INT8;
+			break;
+		case TD_LOOKUP_TABLE_ALPHA:
+			opts.format = FMT_ALPHA;
+			break;
+		case TD_LOOKUP_TABLE_RGB1:
+		case TD_LOOKUP_TABLE_RGBA:
+			opts.format = FMT_RGBA8;
+			break;
+		case TD_LOOKUP_TABLE_BGRA:
+			opts.format = FMT_BGRA8;
+			break;
+		default:
+			assert( false );
+			opts.format = FMT_RGBA8;
+	}
+}
+
+/*
+========================
+R_BlockCompressedFormat
+
+Returns the BC5 or BC7 format that replaces the default format of the usage, or FMT_NONE.
+========================
+*/
+static textureFormat_t R_BlockCompressedFormat( textureUsage_t usage ) {
+	if ( usage == TD_BUMP ) {
+		if ( image_useBC5.GetBool() && glConfig.textureCompressionRGTCAvailable ) {
+			return FMT_BC5;
+		}
+		return FMT_NONE;
+	}
+
+	if ( !glConfig.textureCompressionBPTCAvailable ) {
+		return FMT_NONE;
+	}
+	int usageBit = 0;
+	switch ( usage ) {
+		case TD_DIFFUSE:	usageBit = 1; break;
+		case TD_SPECULAR:	usageBit = 2; break;
+		case TD_DEFAULT:	usageBit = 4; break;
+		case TD_LIGHT:		usageBit = 8; break;
+		default:			break;
+	}
+	return ( image_useBC7.GetInteger() & usageBit ) != 0 ? FMT_BC7 : FMT_NONE;
+}
+
 /*
 ========================
 idImage::DeriveOpts
@@ -75,62 +176,12 @@ idImage::DeriveOpts
 ID_INLINE void idImage::DeriveOpts() {
 
 	if ( opts.format == FMT_NONE ) {
-		opts.colorFormat = CFM_DEFAULT;
+		DeriveDefaultFormat( usage, opts );
 
-		switch ( usage ) {
-			case TD_COVERAGE:
-				opts.format = FMT_DXT1;
-				opts.colorFormat = CFM_GREEN_ALPHA;
-				break;
-			case TD_DEPTH:
-				opts.format = FMT_DEPTH;
-				break;
-			case TD_DIFFUSE: 
-				// TD_DIFFUSE gets only set to when its a diffuse texture for an interaction
-				opts.gammaMips = true;
-				opts.format = FMT_DXT5;
-				opts.colorFormat = CFM_YCOCG_DXT5;
-				break;
-			case TD_SPECULAR:
-				opts.gammaMips = true;
-				opts.format = FMT_DXT1;
-				opts.colorFormat = CFM_DEFAULT;
-				break;
-			case TD_DEFAULT:
-				opts.gammaMips = true;
-				opts.format = FMT_DXT5;
-				opts.colorFormat = CFM_DEFAULT;
-				break;
-			case TD_BUMP:
-				opts.format = FMT_DXT5;
-				opts.colorFormat = CFM_NORMAL_DXT5;
-				break;
-			case TD_FONT:
-				opts.format = FMT_DXT1;
-				opts.colorFormat = CFM_GREEN_ALPHA;
-				opts.numLevels = 4; // We only support 4 levels because we align to 16 in the exporter
-				opts.gammaMips = true;
-				break;
-			case TD_LIGHT:
-				opts.format = FMT_RGB565;
-				opts.gammaMips = true;
-				break;
-			case TD_LOOKUP_TABLE_MONO:
-				opts.format = FMT_INT8;
-				break;
-			case TD_LOOKUP_TABLE_ALPHA:
-				opts.format = FMT_ALPHA;
-				break;
-			case TD_LOOKUP_TABLE_RGB1:
-			case TD_LOOKUP_TABLE_RGBA:
-				opts.format = FMT_RGBA8;
-				break;
-			case TD_LOOKUP_TABLE_BGRA:
-				opts.format = FMT_BGRA8;
-				break;
-			default:
-				assert( false );
-				opts.format = FMT_RGBA8;
+		// only 2D images loaded from files switch formats, generated images keep the default format
+		const textureFormat_t blockCompressedFormat = R_BlockCompressedFormat( usage );
+		if ( blockCompressedFormat != FMT_NONE && generatorFunction == NULL && opts.textureType == TT_2D ) {
+			opts.format = blockCompressedFormat;
 		}
 	}
 
@@ -145,7 +196,7 @@ ID_INLINE void idImage::DeriveOpts() {
 			while ( temp_width > 1 || temp_height > 1 ) {
 				temp_width >>= 1;
 				temp_height >>= 1;
-				if ( ( opts.format == FMT_DXT1 || opts.format == FMT_DXT5 ) &&
+				if ( IsCompressedFormat( opts.format ) &&
 					( ( temp_width & 0x3 ) != 0 || ( temp_height & 0x3 ) != 0 ) ) {
 						break;
 				}
@@ -291,6 +342,10 @@ void idImage::ActuallyLoadImage( bool fromBackEnd ) {
 		return;
 	}
 
+	// streaming starts over, reads still in flight are for the old texture
+	stream.generation++;
+	stream.fullLevels = 0;
+
 	if ( com_productionMode.GetInteger() != 0 ) {
 		sourceFileTime = FILE_NOT_FOUND_TIMESTAMP;
 		if ( cubeFiles != CF_2D ) {
@@ -308,14 +363,19 @@ void idImage::ActuallyLoadImage( bool fromBackEnd ) {
 		}
 	}
 
-	// Figure out opts.colorFormat and opts.format so we can make sure the binary image is up to date
+	// Figure out opts.colorFormat and opts.format so we can make sure the binary image is up to date,
+	// derived again on every load because image_useBC5 and image_useBC7 may have changed
+	opts.format = FMT_NONE;
 	DeriveOpts();
 
 	idStrStatic< MAX_OSPATH > generatedName = GetName();
 	GetGeneratedName( generatedName, usage, cubeFiles );
 
+	// images that can be streamed only read their small levels
+	const int streamedLevelSize = CanStream() ? image_streamMinSize.GetInteger() : 0;
+
 	idBinaryImage im( generatedName );
-	binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime );
+	binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime, streamedLevelSize );
 
 	// BFHACK, do not want to tweak on buildgame so catch these images here
 	if ( binaryFileTime == FILE_NOT_FOUND_TIMESTAMP && fileSystem->UsingResourceFiles() ) {
@@ -431,16 +491,29 @@ void idImage::ActuallyLoadImage( bool fromBackEnd ) {
 		binaryFileTime = im.WriteGeneratedFile( sourceFileTime );
 	}
 
+	// streamed images start out with only their small levels, the rest is read from the generated file later
+	int firstLevel = 0;
+	if ( streamedLevelSize > 0 && binaryFileTime != FILE_NOT_FOUND_TIMESTAMP && im.NumImages() > 0 ) {
+		firstLevel = StartStreaming( im, streamedLevelSize );
+	}
+
 	AllocImage();
 
 
 	for ( int i = 0; i < im.NumImages(); i++ ) {
 		const bimageImage_t & img = im.GetImageHeader( i );
+		if ( img.level < firstLevel ) {
+			continue;
+		}
 		const byte * data = im.GetImageData( i );
-		SubImageUpload( img.level, 0, 0, img.destZ, img.width, img.height, data );
+		SubImageUpload( img.level - firstLevel, 0, 0, img.destZ, img.width, img.height, data );
 	}
 
 	FinaliseImageUpload();
+
+	if ( IsStreamed() ) {
+		globalImages->AddStreamedImage( this );
+	}
 }
 
 
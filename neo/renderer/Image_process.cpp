@@ -306,17 +306,18 @@ Returns a new copy of the texture, quartered in size with gamma correction.
 ================
 */
 byte * R_MipMapWithGamma( const byte *in, int width, int height ) {
-	int		i, j;
+	int		i;
 	const byte	*in_p;
 	byte	*out, *out_p;
-	int		row;
+	int		srcWidth, srcHeight;
 	int		newWidth, newHeight;
 
 	if ( width < 1 || height < 1 || ( width + height == 2 ) ) {
 		return NULL;
 	}
 
-	row = width * 4;
+	srcWidth = width;
+	srcHeight = height;
 
 	newWidth = width >> 1;
 	newHeight = height >> 1;
@@ -344,16 +345,37 @@ byte * R_MipMapWithGamma( const byte *in, int width, int height ) {
 		}
 		return out;
 	}
-	for (i=0 ; i<height ; i++, in_p+=row) {
-		for (j=0 ; j<width ; j++, out_p+=4, in_p+=8) {
+	R_MipMapWithGammaRows( in, srcWidth, srcHeight, out, 0, height );
+
+	return out;
+}
+
+/*
+================
+R_MipMapWithGammaRows
+
+Filters rows [firstRow, firstRow + numRows) of the gamma corrected mip level of a
+width x height image into out, which holds the whole ( width / 2 ) x ( height / 2 ) level.
+Both dimensions must be at least two. Distinct row ranges can be filtered in parallel.
+================
+*/
+void R_MipMapWithGammaRows( const byte *in, int width, int height, byte *out, int firstRow, int numRows ) {
+	const int row = width * 4;
+	const int newWidth = width >> 1;
+
+	assert( width >= 2 && height >= 2 );
+	assert( firstRow >= 0 && firstRow + numRows <= ( height >> 1 ) );
+
+	for ( int i = firstRow; i < firstRow + numRows; i++ ) {
+		const byte * in_p = in + i * 2 * row;
+		byte * out_p = out + i * newWidth * 4;
+		for ( int j = 0; j < newWidth; j++, out_p+=4, in_p+=8 ) {
 			out_p[0] = idMath::Ftob( 255.0f * idMath::Pow( 0.25f * ( mip_gammaTable[in_p[0]] + mip_gammaTable[in_p[4]] + mip_gammaTable[in_p[row+0]] + mip_gammaTable[in_p[row+4]] ), 1.0f / 2.2f ) );
 			out_p[1] = idMath::Ftob( 255.0f * idMath::Pow( 0.25f * ( mip_gammaTable[in_p[1]] + mip_gammaTable[in_p[5]] + mip_gammaTable[in_p[row+1]] + mip_gammaTable[in_p[row+5]] ), 1.0f / 2.2f ) );
 			out_p[2] = idMath::Ftob( 255.0f * idMath::Pow( 0.25f * ( mip_gammaTable[in_p[2]] + mip_gammaTable[in_p[6]] + mip_gammaTable[in_p[row+2]] + mip_gammaTable[in_p[row+6]] ), 1.0f / 2.2f ) );
 			out_p[3] = idMath::Ftob( 255.0f * idMath::Pow( 0.25f * ( mip_gammaTable[in_p[3]] + mip_gammaTable[in_p[7]] + mip_gammaTable[in_p[row+3]] + mip_gammaTable[in_p[row+7]] ), 1.0f / 2.2f ) );
 		}
 	}
-
-	return out;
 }
 
 /*
@@ -364,17 +386,18 @@ Returns a new copy of the texture, quartered in size and filtered.
 ================
 */
 byte * R_MipMap( const byte *in, int width, int height ) {
-	int		i, j;
+	int		i;
 	const byte	*in_p;
 	byte	*out, *out_p;
-	int		row;
+	int		srcWidth, srcHeight;
 	int		newWidth, newHeight;
 
 	if ( width < 1 || height < 1 || ( width + height == 2 ) ) {
 		return NULL;
 	}
 
-	row = width * 4;
+	srcWidth = width;
+	srcHeight = height;
 
 	newWidth = width >> 1;
 	newHeight = height >> 1;
@@ -403,16 +426,68 @@ byte * R_MipMap( const byte *in, int width, int height ) {
 		return out;
 	}
 
-	for (i=0 ; i<height ; i++, in_p+=row) {
-		for (j=0 ; j<width ; j++, out_p+=4, in_p+=8) {
+	R_MipMapRows( in, srcWidth, srcHeight, out, 0, height );
+
+	return out;
+}
+
+/*
+================
+R_MipMapRows
+
+Box filters rows [firstRow, firstRow + numRows) of the mip level of a width x height
+image into out, which holds the whole ( width / 2 ) x ( height / 2 ) level. Both
+dimensions must be at least two. Distinct row ranges can be filtered in parallel.
+The SSE2 path produces exactly the same texels as the scalar path.
+================
+*/
+void R_MipMapRows( const byte *in, int width, int height, byte *out, int firstRow, int numRows ) {
+	const int row = width * 4;
+	const int newWidth = width >> 1;
+
+	assert( width >= 2 && height >= 2 );
+	assert( firstRow >= 0 && firstRow + numRows <= ( height >> 1 ) );
+
+#if defined( ID_WIN_X86_SSE2_INTRIN )
+	const __m128i zero = _mm_setzero_si128();
+#endif
+
+	for ( int i = firstRow; i < firstRow + numRows; i++ ) {
+		const byte * in_p = in + i * 2 * row;
+		byte * out_p = out + i * newWidth * 4;
+		int j = 0;
+
+#if defined( ID_WIN_X86_SSE2_INTRIN )
+
+		// four destination texels from two rows of eight source texels per iteration
+		for ( ; j + 4 <= newWidth; j += 4, out_p += 16, in_p += 32 ) {
+			const __m128i a0 = _mm_loadu_si128( (const __m128i *)( in_p + 0 ) );
+			const __m128i a1 = _mm_loadu_si128( (const __m128i *)( in_p + 16 ) );
+			const __m128i b0 = _mm_loadu_si128( (const __m128i *)( in_p + row + 0 ) );
+			const __m128i b1 = _mm_loadu_si128( (const __m128i *)( in_p + row + 16 ) );
+
+			// vertical sums, two source texels per register
+			const __m128i v0 = _mm_add_epi16( _mm_unpacklo_epi8( a0, zero ), _mm_unpacklo_epi8( b0, zero ) );
+			const __m128i v1 = _mm_add_epi16( _mm_unpackhi_epi8( a0, zero ), _mm_unpackhi_epi8( b0, zero ) );
+			const __m128i v2 = _mm_add_epi16( _mm_unpacklo_epi8( a1, zero ), _mm_unpacklo_epi8( b1, zero ) );
+			const __m128i v3 = _mm_add_epi16( _mm_unpackhi_epi8( a1, zero ), _mm_unpackhi_epi8( b1, zero ) );
+
+			// horizontal sums of the even and odd source texels
+			const __m128i s0 = _mm_add_epi16( _mm_unpacklo_epi64( v0, v1 ), _mm_unpackhi_epi64( v0, v1 ) );
+			const __m128i s1 = _mm_add_epi16( _mm_unpacklo_epi64( v2, v3 ), _mm_unpackhi_epi64( v2, v3 ) );
+
+			_mm_storeu_si128( (__m128i *)out_p, _mm_packus_epi16( _mm_srli_epi16( s0, 2 ), _mm_srli_epi16( s1, 2 ) ) );
+		}
+
+#endif
+
+		for ( ; j < newWidth; j++, out_p+=4, in_p+=8 ) {
 			out_p[0] = (in_p[0] + in_p[4] + in_p[row+0] + in_p[row+4])>>2;
 			out_p[1] = (in_p[1] + in_p[5] + in_p[row+1] + in_p[row+5])>>2;
 			out_p[2] = (in_p[2] + in_p[6] + in_p[row+2] + in_p[row+6])>>2;
 			out_p[3] = (in_p[3] + in_p[7] + in_p[row+3] + in_p[row+7])>>2;
 		}
 	}
-
-	return out;
 }
 
 /*
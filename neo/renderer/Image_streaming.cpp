@@ -0,0 +1,487 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. 
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").  
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#pragma hdrstop
+#include "../idlib/precompiled.h"
+
+#include "tr_local.h"
+
+/*
+================================================================================================
+
+Texture streaming
+
+Diffuse, specular and bump images can be streamed. They load only the levels of their
+generated file that are at most image_streamMinSize texels across, and the front end reports
+how many texels across each image covers on screen. Between frames idImageManager::UpdateStreaming
+hands out the levels the budget allows, most recently needed images first. The resident levels
+the budget still covers stay, so under pressure the least recently needed images lose their top
+levels first. A residency change reads the file from the header of the new top level to the end
+with an asynchronous read and replaces the texture with one that starts at that level.
+
+================================================================================================
+*/
+
+idCVar image_streaming( "image_streaming", "0", CVAR_RENDERER | CVAR_BOOL | CVAR_ARCHIVE, "load only the small levels of material images and stream the rest in as they are seen, OpenGL only" );
+idCVar image_streamBudget( "image_streamBudget", "256", CVAR_RENDERER | CVAR_INTEGER | CVAR_ARCHIVE, "megabytes the streamed images may use" );
+idCVar image_streamMinSize( "image_streamMinSize", "64", CVAR_RENDERER | CVAR_INTEGER, "streamed images always keep the levels of at most this many texels across" );
+idCVar image_streamUploadKB( "image_streamUploadKB", "4096", CVAR_RENDERER | CVAR_INTEGER, "kilobytes of streamed levels uploaded per frame" );
+idCVar image_streamMipBias( "image_streamMipBias", "0", CVAR_RENDERER | CVAR_INTEGER, "levels added to the level the front end asks for, positive values stream less" );
+idCVar image_showStreaming( "image_showStreaming", "0", CVAR_RENDERER | CVAR_BOOL, "print the texture streaming stats every frame" );
+
+/*
+========================
+R_StreamingBackEnd
+
+idImageVk::AllocImage queues the image itself for purging, which would free the replacement
+texture, so only the OpenGL images are streamed.
+========================
+*/
+static bool R_StreamingBackEnd() {
+#ifdef DOOM3_VULKAN
+	return r_openGL.GetBool();
+#else
+	return true;
+#endif
+}
+
+/*
+========================
+idImage::CanStream
+========================
+*/
+bool idImage::CanStream() const {
+	if ( !image_streaming.GetBool() || image_streamMinSize.GetInteger() <= 0 || !R_StreamingBackEnd() ) {
+		return false;
+	}
+	if ( generatorFunction != NULL || cubeFiles != CF_2D || filter != TF_DEFAULT ) {
+		return false;
+	}
+	return ( usage == TD_DIFFUSE || usage == TD_SPECULAR || usage == TD_BUMP );
+}
+
+/*
+========================
+idImage::StartStreaming
+
+Called by ActuallyLoadImage with the binary image before the texture is allocated. Returns the
+first level that goes in the texture, and sets opts to the size of that level.
+========================
+*/
+int idImage::StartStreaming( const idBinaryImage & im, int maxLevelSize ) {
+	// a partial load has skipped the top levels already
+	const int firstLoaded = im.GetImageHeader( 0 ).level;
+
+	int firstLevel = firstLoaded;
+	if ( opts.textureType == TT_2D && opts.numLevels <= MAX_STREAMED_IMAGE_LEVELS && im.NumFileOffsets() == opts.numLevels + 1 ) {
+		int baseLevel = firstLoaded;
+		while ( baseLevel < opts.numLevels - 1 && Max( opts.width >> baseLevel, opts.height >> baseLevel ) > maxLevelSize ) {
+			baseLevel++;
+		}
+		if ( baseLevel > 0 ) {
+			idBinaryImage::GetGeneratedFileName( stream.fileName, im.GetName() );
+			for ( int i = 0; i <= opts.numLevels; i++ ) {
+				stream.fileOffsets[i] = im.GetFileOffset( i );
+			}
+			stream.fullWidth = opts.width;
+			stream.fullHeight = opts.height;
+			stream.fullLevels = opts.numLevels;
+			stream.baseLevel = baseLevel;
+			stream.residentLevel = baseLevel;
+			stream.targetLevel = baseLevel;
+			stream.neededLevel = baseLevel;
+			stream.lastNeededFrame = tr->GetFrameCount();
+			stream.reportedLevel = MAX_STREAMED_IMAGE_LEVELS;
+			firstLevel = baseLevel;
+		}
+	}
+
+	if ( firstLevel > 0 ) {
+		for ( int i = 0; i < im.NumImages(); i++ ) {
+			const bimageImage_t & img = im.GetImageHeader( i );
+			if ( img.level == firstLevel ) {
+				opts.width = img.width;
+				opts.height = img.height;
+				break;
+			}
+		}
+		opts.numLevels -= firstLevel;
+	}
+	return firstLevel;
+}
+
+/*
+========================
+idImage::ReportStreamedSize
+========================
+*/
+void idImage::ReportStreamedSize( float texels ) {
+	if ( stream.fullLevels == 0 || texels <= 0.0f ) {
+		return;
+	}
+
+	// the least detailed level that still has as many texels across as the screen needs
+	const int fullSize = Max( stream.fullWidth, stream.fullHeight );
+	int level = idMath::ILog2( fullSize / texels ) + image_streamMipBias.GetInteger();
+	level = idMath::ClampInt( 0, stream.baseLevel, level );
+
+	// keep the most detailed level any surface asked for
+	for ( ; ; ) {
+		const interlockedInt_t current = stream.reportedLevel;
+		if ( level >= current ) {
+			break;
+		}
+		if ( Sys_InterlockedCompareExchange( stream.reportedLevel, current, level ) == current ) {
+			break;
+		}
+	}
+}
+
+/*
+========================
+idSort_StreamedImages
+
+Most recently needed first, then the ones that need the most detail.
+========================
+*/
+class idSort_StreamedImages : public idSort_Quick< idImage *, idSort_StreamedImages > {
+public:
+	int Compare( idImage * const & a, idImage * const & b ) const {
+		const imageStreamState_t & sa = a->GetStreamState();
+		const imageStreamState_t & sb = b->GetStreamState();
+		if ( sa.lastNeededFrame != sb.lastNeededFrame ) {
+			return sb.lastNeededFrame - sa.lastNeededFrame;
+		}
+		return sa.neededLevel - sb.neededLevel;
+	}
+};
+
+/*
+========================
+idImageManager::AddStreamedImage
+========================
+*/
+void idImageManager::AddStreamedImage( idImage * image ) {
+	if ( !image->stream.listed ) {
+		image->stream.listed = true;
+		streamedImages.Append( image );
+	}
+}
+
+/*
+========================
+idImageManager::StartStreamRequest
+========================
+*/
+bool idImageManager::StartStreamRequest( idImage * image, int level ) {
+	imageStreamState_t & stream = image->stream;
+	for ( int i = 0; i < MAX_IMAGE_STREAM_REQUESTS; i++ ) {
+		imageStreamRequest_t & request = streamRequests[i];
+		if ( request.image != NULL ) {
+			continue;
+		}
+
+		request.read.Clear();
+		request.read.fileName = stream.fileName;
+		request.read.offset = stream.fileOffsets[ level ];
+		request.read.length = image->StreamedLevelsSize( level );
+		request.read.priority = FILE_READ_PRIORITY_LOW;
+		if ( !fileSystem->ReadFileAsync( &request.read ) ) {
+			// keep what is resident and stop streaming the image
+			idLib::Warning( "Couldn't stream %s", stream.fileName.c_str() );
+			stream.fullLevels = 0;
+			return false;
+		}
+
+		request.image = image;
+		request.level = level;
+		request.generation = stream.generation;
+		request.startTime = Sys_Microseconds();
+		stream.requested = true;
+		stream.requestedLevel = level;
+		return true;
+	}
+	return false;
+}
+
+/*
+========================
+idImageManager::UploadStreamedLevels
+
+The data runs from the header of the new top level to the end of the generated file.
+========================
+*/
+bool idImageManager::UploadStreamedLevels( idImage * image, int level, const byte * data, int dataSize ) {
+	imageStreamState_t & stream = image->stream;
+	bimageImage_t headers[ MAX_STREAMED_IMAGE_LEVELS ];
+	const byte * levelData[ MAX_STREAMED_IMAGE_LEVELS ];
+
+	// check all of it before the texture is replaced
+	int offset = 0;
+	for ( int i = level; i < stream.fullLevels; i++ ) {
+		if ( offset + (int)sizeof( bimageImage_t ) > dataSize ) {
+			return false;
+		}
+		bimageImage_t & header = headers[ i - level ];
+		memcpy( &header, data + offset, sizeof( header ) );
+		idSwapClass<bimageImage_t> swap;
+		swap.Big( header.level );
+		swap.Big( header.destZ );
+		swap.Big( header.width );
+		swap.Big( header.height );
+		swap.Big( header.dataSize );
+		offset += sizeof( header );
+		if ( header.level != i || header.destZ != 0 || header.dataSize <= 0 || offset + header.dataSize > dataSize ) {
+			return false;
+		}
+		levelData[ i - level ] = data + offset;
+		offset += header.dataSize;
+	}
+
+	image->opts.width = headers[0].width;
+	image->opts.height = headers[0].height;
+	image->opts.numLevels = stream.fullLevels - level;
+	image->AllocImage();
+
+	for ( int i = 0; i < image->opts.numLevels; i++ ) {
+		image->SubImageUpload( i, 0, 0, 0, headers[i].width, headers[i].height, levelData[i] );
+	}
+	image->FinaliseImageUpload();
+
+	stream.residentLevel = level;
+	return true;
+}
+
+/*
+========================
+idImageManager::UpdateStreaming
+========================
+*/
+void idImageManager::UpdateStreaming() {
+	if ( insideLevelLoad ) {
+		return;
+	}
+
+	// replace the textures the reads are done for, as many as the upload limit allows
+	const int maxUploadBytes = Max( image_streamUploadKB.GetInteger(), 1 ) * 1024;
+	int uploadBytes = 0;
+	int numFreeRequests = 0;
+	for ( int i = 0; i < MAX_IMAGE_STREAM_REQUESTS; i++ ) {
+		imageStreamRequest_t & request = streamRequests[i];
+		if ( request.image == NULL ) {
+			numFreeRequests++;
+			continue;
+		}
+		const int status = request.read.status.GetValue();
+		if ( status == FILE_READ_QUEUED || status == FILE_READ_BUSY ) {
+			continue;
+		}
+		if ( status == FILE_READ_DONE && uploadBytes >= maxUploadBytes ) {
+			continue;
+		}
+
+		idImage * image = request.image;
+		const bool current = image->IsLoaded() && image->IsStreamed() && image->stream.generation == request.generation;
+		if ( status == FILE_READ_DONE ) {
+			if ( current ) {
+				const int oldLevel = image->stream.residentLevel;
+				if ( UploadStreamedLevels( image, request.level, request.read.data, request.read.bytesRead ) ) {
+					uploadBytes += request.read.bytesRead;
+					if ( request.level < oldLevel ) {
+						streamStats.numStreamedIn++;
+					} else {
+						streamStats.numEvicted++;
+					}
+					streamStats.bytesRead += request.read.bytesRead;
+					streamStats.readMicroseconds += Sys_Microseconds() - request.startTime;
+				} else {
+					idLib::Warning( "Bad levels streamed from %s", image->stream.fileName.c_str() );
+					image->stream.fullLevels = 0;
+				}
+			}
+			Mem_Free( request.read.data );
+		} else if ( current ) {
+			idLib::Warning( "Couldn't stream %s", image->stream.fileName.c_str() );
+			image->stream.fullLevels = 0;
+		}
+		request.read.data = NULL;
+		image->stream.requested = false;
+		request.image = NULL;
+		numFreeRequests++;
+	}
+
+	// take the front end reports
+	const int frame = tr->GetFrameCount();
+	int64 baseBytes = 0;
+	int64 residentBytes = 0;
+	streamStats.frameMisses = 0;
+	for ( int i = streamedImages.Num() - 1; i >= 0; i-- ) {
+		idImage * image = streamedImages[i];
+		imageStreamState_t & stream = image->stream;
+		if ( !image->IsStreamed() || !image->IsLoaded() ) {
+			stream.listed = false;
+			streamedImages.RemoveIndexFast( i );
+			continue;
+		}
+
+		const int reportedLevel = Sys_InterlockedExchange( stream.reportedLevel, MAX_STREAMED_IMAGE_LEVELS );
+		if ( reportedLevel < MAX_STREAMED_IMAGE_LEVELS ) {
+			stream.neededLevel = reportedLevel;
+			stream.lastNeededFrame = frame;
+			if ( reportedLevel < stream.residentLevel ) {
+				streamStats.frameMisses++;
+			}
+		}
+
+		// streaming in counts from when the read is queued, evicting from when the texture is replaced
+		const int committedLevel = stream.requested ? Min( stream.residentLevel, stream.requestedLevel ) : stream.residentLevel;
+		baseBytes += image->StreamedLevelsSize( stream.baseLevel );
+		residentBytes += image->StreamedLevelsSize( committedLevel );
+	}
+	streamStats.totalMisses += streamStats.frameMisses;
+	streamStats.baseBytes = baseBytes;
+	streamStats.residentBytes = residentBytes;
+
+	if ( streamedImages.Num() == 0 ) {
+		return;
+	}
+
+	streamedImages.SortWithTemplate( idSort_StreamedImages() );
+
+	// hand out the levels the budget allows, most recently needed first
+	const int64 budget = Max( (int64)image_streamBudget.GetInteger() * 1024 * 1024, baseBytes );
+	int64 remaining = budget - baseBytes;
+	for ( int i = 0; i < streamedImages.Num(); i++ ) {
+		idImage * image = streamedImages[i];
+		imageStreamState_t & stream = image->stream;
+		const int baseSize = image->StreamedLevelsSize( stream.baseLevel );
+		int level = stream.neededLevel;
+		while ( level < stream.baseLevel && image->StreamedLevelsSize( level ) - baseSize > remaining ) {
+			level++;
+		}
+		remaining -= image->StreamedLevelsSize( level ) - baseSize;
+		stream.targetLevel = level;
+	}
+
+	// the resident levels that are no longer needed stay while the budget covers them
+	for ( int i = 0; i < streamedImages.Num(); i++ ) {
+		idImage * image = streamedImages[i];
+		imageStreamState_t & stream = image->stream;
+		if ( stream.residentLevel < stream.targetLevel ) {
+			const int keepSize = image->StreamedLevelsSize( stream.residentLevel ) - image->StreamedLevelsSize( stream.targetLevel );
+			if ( keepSize <= remaining ) {
+				remaining -= keepSize;
+				stream.targetLevel = stream.residentLevel;
+			}
+		}
+	}
+
+	// evict the least recently needed images first, so their memory comes back before more is streamed in
+	for ( int i = streamedImages.Num() - 1; i >= 0 && numFreeRequests > 0; i-- ) {
+		idImage * image = streamedImages[i];
+		const imageStreamState_t & stream = image->stream;
+		if ( !stream.requested && stream.targetLevel > stream.residentLevel ) {
+			if ( StartStreamRequest( image, stream.targetLevel ) ) {
+				numFreeRequests--;
+			}
+		}
+	}
+	for ( int i = 0; i < streamedImages.Num() && numFreeRequests > 0; i++ ) {
+		idImage * image = streamedImages[i];
+		const imageStreamState_t & stream = image->stream;
+		if ( !stream.requested && stream.targetLevel < stream.residentLevel ) {
+			const int growSize = image->StreamedLevelsSize( stream.targetLevel ) - image->StreamedLevelsSize( stream.residentLevel );
+			if ( residentBytes + growSize > budget ) {
+				continue;		// wait for the evictions
+			}
+			if ( StartStreamRequest( image, stream.targetLevel ) ) {
+				residentBytes += growSize;
+				numFreeRequests--;
+			}
+		}
+	}
+
+	if ( image_showStreaming.GetBool() ) {
+		common->Printf( "streaming: %i images, %5.1f / %5.1f MB, %i reads, %i misses\n", streamedImages.Num(),
+			residentBytes / ( 1024.0 * 1024.0 ), budget / ( 1024.0 * 1024.0 ), MAX_IMAGE_STREAM_REQUESTS - numFreeRequests, streamStats.frameMisses );
+	}
+}
+
+/*
+========================
+idImageManager::StopStreaming
+========================
+*/
+void idImageManager::StopStreaming() {
+	for ( int i = 0; i < MAX_IMAGE_STREAM_REQUESTS; i++ ) {
+		imageStreamRequest_t & request = streamRequests[i];
+		if ( request.image == NULL ) {
+			continue;
+		}
+		if ( !fileSystem->CancelRead( &request.read ) ) {
+			fileSystem->WaitForRead( &request.read );
+			Mem_Free( request.read.data );
+		}
+		request.read.data = NULL;
+		request.image->stream.requested = false;
+		request.image = NULL;
+	}
+}
+
+/*
+========================
+idImageManager::PrintStreamingStats
+========================
+*/
+void idImageManager::PrintStreamingStats() const {
+	const int numReads = streamStats.numStreamedIn + streamStats.numEvicted;
+	common->Printf( "%5i streamed images, %5.1f MB resident, %5.1f MB in base levels, %i MB budget\n", streamedImages.Num(),
+		streamStats.residentBytes / ( 1024.0 * 1024.0 ), streamStats.baseBytes / ( 1024.0 * 1024.0 ), image_streamBudget.GetInteger() );
+	common->Printf( "%5i streamed in, %i evicted, %5.1f MB read, %5.1f msec average latency\n", streamStats.numStreamedIn, streamStats.numEvicted,
+		streamStats.bytesRead / ( 1024.0 * 1024.0 ), numReads > 0 ? streamStats.readMicroseconds / ( numReads * 1000.0 ) : 0.0 );
+	common->Printf( "%5i streaming misses last frame, %i in total\n", streamStats.frameMisses, (int)streamStats.totalMisses );
+}
+
+/*
+========================
+listStreamedImages
+========================
+*/
+CONSOLE_COMMAND( listStreamedImages, "lists the streamed images with their resident and needed sizes", 0 ) {
+	const int frame = tr->GetFrameCount();
+	for ( int i = 0; i < globalImages->streamedImages.Num(); i++ ) {
+		const idImage * image = globalImages->streamedImages[i];
+		const imageStreamState_t & stream = image->GetStreamState();
+		common->Printf( "%4i x %-4i of %4i x %-4i needs %4i x %-4i seen %5i frames ago %s\n",
+			Max( stream.fullWidth >> stream.residentLevel, 1 ), Max( stream.fullHeight >> stream.residentLevel, 1 ),
+			stream.fullWidth, stream.fullHeight,
+			Max( stream.fullWidth >> stream.neededLevel, 1 ), Max( stream.fullHeight >> stream.neededLevel, 1 ),
+			frame - stream.lastNeededFrame, image->GetName() );
+	}
+	globalImages->PrintStreamingStats();
+}
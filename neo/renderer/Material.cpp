@@ -71,6 +71,9 @@ typedef struct mtrParsingData_s {
 
 idCVar r_forceSoundOpAmplitude( "r_forceSoundOpAmplitude", "0", CVAR_FLOAT, "Don't call into the sound system for amplitudes" );
 
+static const byte BMTR_VERSION = 100;
+static const unsigned int BMTR_MAGIC = ( 'B' << 24 ) | ( 'M' << 16 ) | ( 'T' << 8 ) | BMTR_VERSION;
+
 /*
 =============
 idMaterial::CommonInit
@@ -1940,6 +1943,15 @@ void idMaterial::ParseMaterial( idLexer &src ) {
 			SetMaterialFlag( MF_FORCESHADOWS );
 			continue;
 		}
+		// software occlusion culling occluder selection
+		else if ( !token.Icmp( "noOccluder" ) ) {
+			SetMaterialFlag( MF_NOOCCLUDER );
+			continue;
+		}
+		else if ( !token.Icmp( "forceOccluder" ) ) {
+			SetMaterialFlag( MF_FORCEOCCLUDER );
+			continue;
+		}
 		// overlay / decal suppression
 		else if ( !token.Icmp( "noOverlays" ) ) {
 			allowOverlays = false;
@@ -2198,6 +2210,16 @@ bool idMaterial::Parse( const char *text, const int textLength, bool allowBinary
 	idToken	token;
 	mtrParsingData_t parsingData;
 
+	if ( allowBinaryVersion ) {
+		idFileLocal file( declManager->ReadBinaryDecl( this ) );
+		if ( file != NULL ) {
+			if ( LoadBinary( file ) ) {
+				return true;
+			}
+			FreeData();
+		}
+	}
+
 	src.LoadMemory( text, textLength, GetFileName(), GetLineNum() );
 	src.SetFlags( DECL_LEXER_FLAGS );
 	src.SkipUntilString( "{" );
@@ -2382,11 +2404,15 @@ bool idMaterial::Parse( const char *text, const int textLength, bool allowBinary
 
 	// see if the registers are completely constant, and don't need to be evaluated
 	// per-surface
-	CheckForConstantRegisters();
+	CheckForConstantRegisters( pd->registersAreConstant );
 
 	// See if the material is trivial for the fast path
 	SetFastPathImages();
 
+	if ( allowBinaryVersion && !TestMaterialFlag( MF_DEFAULTED ) ) {
+		WriteBinary( pd->registersAreConstant );
+	}
+
 	pd = NULL;	// the pointer will be invalid after exiting this function
 
 	// finish things up
@@ -2397,6 +2423,286 @@ bool idMaterial::Parse( const char *text, const int textLength, bool allowBinary
 	return true;
 }
 
+/*
+=========================
+R_WriteMaterialImage
+
+Images are stored by the parameters they were created with, so the same
+image is found or created again when the material is loaded.
+=========================
+*/
+static void R_WriteMaterialImage( idFile *file, const idImage *image ) {
+	if ( image == NULL ) {
+		file->WriteString( "" );
+		return;
+	}
+	file->WriteString( image->GetName() );
+	file->WriteBig( image->GetFilter() );
+	file->WriteBig( image->GetRepeat() );
+	file->WriteBig( image->GetUsage() );
+	file->WriteBig( image->GetCubeFiles() );
+}
+
+/*
+=========================
+R_ReadMaterialImage
+=========================
+*/
+static idImage *R_ReadMaterialImage( idFile *file ) {
+	idStr name;
+	file->ReadString( name );
+	if ( name.IsEmpty() ) {
+		return NULL;
+	}
+
+	textureFilter_t filter;
+	textureRepeat_t repeat;
+	textureUsage_t usage;
+	cubeFiles_t cubeMap;
+	file->ReadBig( filter );
+	file->ReadBig( repeat );
+	file->ReadBig( usage );
+	file->ReadBig( cubeMap );
+	return globalImages->ImageFromFile( name, filter, repeat, usage, cubeMap );
+}
+
+/*
+=========================
+idMaterial::WriteBinary
+
+Materials with guis, cinematics, dynamic images or vertex / fragment program
+stages own objects that can't be recreated from a plain description, so only
+the text version of them is used.
+=========================
+*/
+void idMaterial::WriteBinary( bool registersAreConstant ) const {
+	if ( gui != NULL ) {
+		return;
+	}
+	for ( int i = 0; i < numStages; i++ ) {
+		if ( stages[i].texture.cinematic != NULL || stages[i].texture.dynamic != DI_STATIC || stages[i].newStage != NULL ) {
+			return;
+		}
+	}
+
+	idFile_Memory file;
+	file.WriteBig( BMTR_MAGIC );
+
+	file.WriteString( desc );
+	file.WriteString( renderBump );
+	file.WriteString( editorImageName );
+	R_WriteMaterialImage( &file, lightFalloffImage );
+	file.WriteBig( entityGui );
+	file.WriteBig( noFog );
+	file.WriteBig( spectrum );
+	file.WriteFloat( polygonOffset );
+	file.WriteBig( contentFlags );
+	file.WriteBig( surfaceFlags );
+	file.WriteBig( materialFlags );
+	file.WriteBig( decalInfo.stayTime );
+	file.WriteBig( decalInfo.fadeTime );
+	file.WriteBigArray( decalInfo.start, 4 );
+	file.WriteBigArray( decalInfo.end, 4 );
+
+	file.WriteFloat( sort );
+	file.WriteBig( stereoEye );
+	file.WriteBig( deform );
+	file.WriteBigArray( deformRegisters, 4 );
+	if ( deformDecl != NULL ) {
+		file.WriteBig( deformDecl->GetType() );
+		file.WriteString( deformDecl->GetName() );
+	} else {
+		file.WriteBig( DECL_MAX_TYPES );
+	}
+	file.WriteBigArray( texGenRegisters, MAX_TEXGEN_REGISTERS );
+
+	file.WriteBig( coverage );
+	file.WriteBig( cullType );
+	file.WriteBig( shouldCreateBackSides );
+	file.WriteBig( fogLight );
+	file.WriteBig( blendLight );
+	file.WriteBig( ambientLight );
+	file.WriteBig( unsmoothedTangents );
+	file.WriteBig( hasSubview );
+	file.WriteBig( allowOverlays );
+	file.WriteFloat( editorAlpha );
+	file.WriteBig( suppressInSubview );
+	file.WriteBig( portalSky );
+
+	// table ops reference the table by decl index, which depends on the decl files
+	// that are loaded, so the tables are stored by name
+	file.WriteBig( numOps );
+	for ( int i = 0; i < numOps; i++ ) {
+		file.WriteBig( ops[i].opType );
+		if ( ops[i].opType == OP_TYPE_TABLE ) {
+			file.WriteString( declManager->DeclByIndex( DECL_TABLE, ops[i].a, false )->GetName() );
+		} else {
+			file.WriteBig( ops[i].a );
+		}
+		file.WriteBig( ops[i].b );
+		file.WriteBig( ops[i].c );
+	}
+
+	file.WriteBig( numRegisters );
+	file.WriteBigArray( expressionRegisters, numRegisters );
+	file.WriteBig( registersAreConstant );
+
+	file.WriteBig( numStages );
+	file.WriteBig( numAmbientStages );
+	for ( int i = 0; i < numStages; i++ ) {
+		const shaderStage_t *ss = &stages[i];
+		file.WriteBig( ss->conditionRegister );
+		file.WriteBig( ss->lighting );
+		file.WriteBig( ss->drawStateBits );
+		file.WriteBigArray( ss->color.registers, 4 );
+		file.WriteBig( ss->hasAlphaTest );
+		file.WriteBig( ss->alphaTestRegister );
+		R_WriteMaterialImage( &file, ss->texture.image );
+		file.WriteBig( ss->texture.texgen );
+		file.WriteBig( ss->texture.hasMatrix );
+		file.WriteBigArray( ss->texture.matrix[0], 3 );
+		file.WriteBigArray( ss->texture.matrix[1], 3 );
+		file.WriteBig( ss->vertexColor );
+		file.WriteBig( ss->ignoreAlphaTest );
+		file.WriteFloat( ss->privatePolygonOffset );
+	}
+
+	declManager->WriteBinaryDecl( this, &file );
+}
+
+/*
+=========================
+idMaterial::LoadBinary
+=========================
+*/
+bool idMaterial::LoadBinary( idFile *file ) {
+	unsigned int magic = 0;
+	file->ReadBig( magic );
+	if ( magic != BMTR_MAGIC ) {
+		return false;
+	}
+
+	// reset to the unparsed state
+	CommonInit();
+
+	file->ReadString( desc );
+	file->ReadString( renderBump );
+	file->ReadString( editorImageName );
+	lightFalloffImage = R_ReadMaterialImage( file );
+	file->ReadBig( entityGui );
+	file->ReadBig( noFog );
+	file->ReadBig( spectrum );
+	file->ReadFloat( polygonOffset );
+	file->ReadBig( contentFlags );
+	file->ReadBig( surfaceFlags );
+	file->ReadBig( materialFlags );
+	file->ReadBig( decalInfo.stayTime );
+	file->ReadBig( decalInfo.fadeTime );
+	file->ReadBigArray( decalInfo.start, 4 );
+	file->ReadBigArray( decalInfo.end, 4 );
+
+	file->ReadFloat( sort );
+	file->ReadBig( stereoEye );
+	file->ReadBig( deform );
+	file->ReadBigArray( deformRegisters, 4 );
+	declType_t deformDeclType;
+	file->ReadBig( deformDeclType );
+	if ( deformDeclType != DECL_MAX_TYPES ) {
+		idStr deformDeclName;
+		file->ReadString( deformDeclName );
+		deformDecl = declManager->FindType( deformDeclType, deformDeclName, true );
+	}
+	file->ReadBigArray( texGenRegisters, MAX_TEXGEN_REGISTERS );
+
+	file->ReadBig( coverage );
+	file->ReadBig( cullType );
+	file->ReadBig( shouldCreateBackSides );
+	file->ReadBig( fogLight );
+	file->ReadBig( blendLight );
+	file->ReadBig( ambientLight );
+	file->ReadBig( unsmoothedTangents );
+	file->ReadBig( hasSubview );
+	file->ReadBig( allowOverlays );
+	file->ReadFloat( editorAlpha );
+	file->ReadBig( suppressInSubview );
+	file->ReadBig( portalSky );
+
+	file->ReadBig( numOps );
+	if ( numOps < 0 || numOps > MAX_EXPRESSION_OPS ) {
+		numOps = 0;
+		return false;
+	}
+	if ( numOps > 0 ) {
+		ops = (expOp_t *)R_StaticAlloc( numOps * sizeof( ops[0] ), TAG_MATERIAL );
+		for ( int i = 0; i < numOps; i++ ) {
+			file->ReadBig( ops[i].opType );
+			if ( ops[i].opType == OP_TYPE_TABLE ) {
+				idStr tableName;
+				file->ReadString( tableName );
+				const idDecl *table = declManager->FindType( DECL_TABLE, tableName, false );
+				if ( table == NULL ) {
+					return false;
+				}
+				ops[i].a = table->Index();
+			} else {
+				file->ReadBig( ops[i].a );
+			}
+			file->ReadBig( ops[i].b );
+			file->ReadBig( ops[i].c );
+		}
+	}
+
+	file->ReadBig( numRegisters );
+	if ( numRegisters < 0 || numRegisters > MAX_EXPRESSION_REGISTERS ) {
+		numRegisters = 0;
+		return false;
+	}
+	if ( numRegisters > 0 ) {
+		expressionRegisters = (float *)R_StaticAlloc( numRegisters * sizeof( expressionRegisters[0] ), TAG_MATERIAL );
+		file->ReadBigArray( expressionRegisters, numRegisters );
+	}
+	bool registersAreConstant;
+	file->ReadBig( registersAreConstant );
+
+	file->ReadBig( numStages );
+	file->ReadBig( numAmbientStages );
+	if ( numStages < 0 || numStages > MAX_SHADER_STAGES ) {
+		numStages = 0;
+		return false;
+	}
+	if ( numStages > 0 ) {
+		stages = (shaderStage_t *)R_StaticAlloc( numStages * sizeof( stages[0] ), TAG_MATERIAL );
+		memset( stages, 0, numStages * sizeof( stages[0] ) );
+		for ( int i = 0; i < numStages; i++ ) {
+			shaderStage_t *ss = &stages[i];
+			file->ReadBig( ss->conditionRegister );
+			file->ReadBig( ss->lighting );
+			file->ReadBig( ss->drawStateBits );
+			file->ReadBigArray( ss->color.registers, 4 );
+			file->ReadBig( ss->hasAlphaTest );
+			file->ReadBig( ss->alphaTestRegister );
+			ss->texture.image = R_ReadMaterialImage( file );
+			file->ReadBig( ss->texture.texgen );
+			file->ReadBig( ss->texture.hasMatrix );
+			file->ReadBigArray( ss->texture.matrix[0], 3 );
+			file->ReadBigArray( ss->texture.matrix[1], 3 );
+			file->ReadBig( ss->vertexColor );
+			file->ReadBig( ss->ignoreAlphaTest );
+			file->ReadFloat( ss->privatePolygonOffset );
+		}
+	}
+
+	// if we are doing an fs_copyfiles, also reference the editorImage
+	if ( cvarSystem->GetCVarInteger( "fs_copyFiles" ) ) {
+		GetEditorImage();
+	}
+
+	CheckForConstantRegisters( registersAreConstant );
+	SetFastPathImages();
+
+	return true;
+}
+
 /*
 ===================
 idMaterial::Print
@@ -2682,10 +2988,10 @@ As of 5/2/03, about half of the unique materials loaded on typical
 maps are constant, but 2/3 of the surface references are.
 ==================
 */
-void idMaterial::CheckForConstantRegisters() {
+void idMaterial::CheckForConstantRegisters( bool registersAreConstant ) {
 	assert( constantRegisters == NULL );
 
-	if ( !pd->registersAreConstant ) {
+	if ( !registersAreConstant ) {
 		return;
 	}
 	if ( !r_useConstantMaterials.GetBool() ) {
@@ -261,7 +261,9 @@ typedef enum {
 	MF_FORCESHADOWS				= BIT(3),
 	MF_NOSELFSHADOW				= BIT(4),
 	MF_NOPORTALFOG				= BIT(5),	// this fog volume won't ever consider a portal fogged out
-	MF_EDITOR_VISIBLE			= BIT(6)	// in use (visible) per editor
+	MF_EDITOR_VISIBLE			= BIT(6),	// in use (visible) per editor
+	MF_NOOCCLUDER				= BIT(7),	// never used as a software occlusion culling occluder
+	MF_FORCEOCCLUDER			= BIT(8)	// always used as an occluder, regardless of triangle size
 } materialFlags_t;
 
 // contents flags, NOTE: make sure to keep the defines in doom_defs.script up to date with these!
@@ -627,8 +629,10 @@ private:
 	void				MultiplyTextureMatrix( textureStage_t *ts, int registers[2][3] );	// FIXME: for some reason the const is bad for gcc and Mac
 	void				SortInteractionStages();
 	void				AddImplicitStages( const textureRepeat_t trpDefault = TR_REPEAT );
-	void				CheckForConstantRegisters();
+	void				CheckForConstantRegisters( bool registersAreConstant );
 	void				SetFastPathImages();
+	bool				LoadBinary( idFile *file );
+	void				WriteBinary( bool registersAreConstant ) const;
 
 private:
 	idStr				desc;				// description
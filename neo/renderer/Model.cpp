@@ -956,10 +956,20 @@ void idRenderModelStatic::FinishSurfaces() {
 	}
 
 	// clean the surfaces
+	idTempArray< cleanupTrianglesParms_t > cleanupParms( surfaces.Num() );
+	for ( i = 0; i < surfaces.Num(); i++ ) {
+		const modelSurface_t	*surf = &surfaces[i];
+
+		cleanupParms[i].tri = surf->geometry;
+		cleanupParms[i].createNormals = surf->geometry->generateNormals;
+		cleanupParms[i].identifySilEdges = true;
+		cleanupParms[i].useUnsmoothedTangents = surf->shader->UseUnsmoothedTangents();
+	}
+	R_CleanupTriangleSurfaces( cleanupParms.Ptr(), surfaces.Num() );
+
 	for ( i = 0; i < surfaces.Num(); i++ ) {
 		const modelSurface_t	*surf = &surfaces[i];
 
-		R_CleanupTriangles( surf->geometry, surf->geometry->generateNormals, true, surf->shader->UseUnsmoothedTangents() );
 		if ( surf->shader->SurfaceCastsShadow() ) {
 			totalVerts += surf->geometry->numVerts;
 			totalIndexes += surf->geometry->numIndexes;
@@ -65,6 +65,7 @@ struct srfTriangles_t {
 	srfTriangles_t() {}
 
 	idBounds					bounds;					// for culling
+	float						texCoordSpan;			// texture repeats along the longest texture axis, 0 until R_TriSurfTexCoordSpan
 
 	bool						generateNormals;		// create normals from geometry, instead of using explicit ones
 	bool						tangentsCalculated;		// set when the vertex tangents have been calculated
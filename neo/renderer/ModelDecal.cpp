@@ -34,6 +34,8 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "../idlib/geometry/DrawVert_intrinsics.h"
 
+idCVar r_useBatchedDecals( "r_useBatchedDecals", "1", CVAR_RENDERER | CVAR_BOOL, "project all deferred decals of a model in a single pass" );
+
 // decalFade	filter 5 0.1
 // polygonOffset
 // {
@@ -268,11 +270,17 @@ void idRenderModelDecal::CreateDecalFromWinding( const idWinding &w, const idMat
 /*
 ============
 R_DecalPointCullStatic
+
+Categorizes all points against the bounding planes of several decal projections
+in a single pass over the vertices. The cull bits for projection N are stored at
+cullBits + N * cullBitsStride.
 ============
 */
-static void R_DecalPointCullStatic( byte * cullBits, const idPlane * planes, const idDrawVert * verts, const int numVerts ) {
+static void R_DecalPointCullStatic( byte * cullBits, const int cullBitsStride, const decalProjectionParms_t * const * parms, const int numParms, const idDrawVert * verts, const int numVerts ) {
 	assert_16_byte_aligned( cullBits );
 	assert_16_byte_aligned( verts );
+	assert( ( cullBitsStride & 15 ) == 0 );
+	assert( numParms <= MAX_DEFERRED_DECALS );
 
 #ifdef ID_WIN_X86_SSE2_INTRIN
 
@@ -286,42 +294,17 @@ static void R_DecalPointCullStatic( byte * cullBits, const idPlane * planes, con
 	const __m128i vector_int_mask4	= _mm_set1_epi32( 1 << 4 );
 	const __m128i vector_int_mask5	= _mm_set1_epi32( 1 << 5 );
 
-	const __m128 p0 = _mm_loadu_ps( planes[0].ToFloatPtr() );
-	const __m128 p1 = _mm_loadu_ps( planes[1].ToFloatPtr() );
-	const __m128 p2 = _mm_loadu_ps( planes[2].ToFloatPtr() );
-	const __m128 p3 = _mm_loadu_ps( planes[3].ToFloatPtr() );
-	const __m128 p4 = _mm_loadu_ps( planes[4].ToFloatPtr() );
-	const __m128 p5 = _mm_loadu_ps( planes[5].ToFloatPtr() );
-
-	const __m128 p0X = _mm_splat_ps( p0, 0 );
-	const __m128 p0Y = _mm_splat_ps( p0, 1 );
-	const __m128 p0Z = _mm_splat_ps( p0, 2 );
-	const __m128 p0W = _mm_splat_ps( p0, 3 );
-
-	const __m128 p1X = _mm_splat_ps( p1, 0 );
-	const __m128 p1Y = _mm_splat_ps( p1, 1 );
-	const __m128 p1Z = _mm_splat_ps( p1, 2 );
-	const __m128 p1W = _mm_splat_ps( p1, 3 );
-
-	const __m128 p2X = _mm_splat_ps( p2, 0 );
-	const __m128 p2Y = _mm_splat_ps( p2, 1 );
-	const __m128 p2Z = _mm_splat_ps( p2, 2 );
-	const __m128 p2W = _mm_splat_ps( p2, 3 );
-
-	const __m128 p3X = _mm_splat_ps( p3, 0 );
-	const __m128 p3Y = _mm_splat_ps( p3, 1 );
-	const __m128 p3Z = _mm_splat_ps( p3, 2 );
-	const __m128 p3W = _mm_splat_ps( p3, 3 );
-
-	const __m128 p4X = _mm_splat_ps( p4, 0 );
-	const __m128 p4Y = _mm_splat_ps( p4, 1 );
-	const __m128 p4Z = _mm_splat_ps( p4, 2 );
-	const __m128 p4W = _mm_splat_ps( p4, 3 );
-
-	const __m128 p5X = _mm_splat_ps( p5, 0 );
-	const __m128 p5Y = _mm_splat_ps( p5, 1 );
-	const __m128 p5Z = _mm_splat_ps( p5, 2 );
-	const __m128 p5W = _mm_splat_ps( p5, 3 );
+	// splat the plane components of all projections once
+	ALIGN16( __m128 planeSplats[MAX_DEFERRED_DECALS][NUM_DECAL_BOUNDING_PLANES][4] );
+	for ( int n = 0; n < numParms; n++ ) {
+		for ( int j = 0; j < NUM_DECAL_BOUNDING_PLANES; j++ ) {
+			const __m128 p = _mm_loadu_ps( parms[n]->boundingPlanes[j].ToFloatPtr() );
+			planeSplats[n][j][0] = _mm_splat_ps( p, 0 );
+			planeSplats[n][j][1] = _mm_splat_ps( p, 1 );
+			planeSplats[n][j][2] = _mm_splat_ps( p, 2 );
+			planeSplats[n][j][3] = _mm_splat_ps( p, 3 );
+		}
+	}
 
 	for ( int i = 0; i < numVerts; ) {
 
@@ -342,38 +325,42 @@ static void R_DecalPointCullStatic( byte * cullBits, const idPlane * planes, con
 			const __m128 vY = _mm_unpackhi_ps( r0, r2 );	// v0.y, v1.y, v2.y, v3.y
 			const __m128 vZ = _mm_unpacklo_ps( r1, r3 );	// v0.z, v1.z, v2.z, v3.z
 
-			const __m128 d0 = _mm_madd_ps( vX, p0X, _mm_madd_ps( vY, p0Y, _mm_madd_ps( vZ, p0Z, p0W ) ) );
-			const __m128 d1 = _mm_madd_ps( vX, p1X, _mm_madd_ps( vY, p1Y, _mm_madd_ps( vZ, p1Z, p1W ) ) );
-			const __m128 d2 = _mm_madd_ps( vX, p2X, _mm_madd_ps( vY, p2Y, _mm_madd_ps( vZ, p2Z, p2W ) ) );
-			const __m128 d3 = _mm_madd_ps( vX, p3X, _mm_madd_ps( vY, p3Y, _mm_madd_ps( vZ, p3Z, p3W ) ) );
-			const __m128 d4 = _mm_madd_ps( vX, p4X, _mm_madd_ps( vY, p4Y, _mm_madd_ps( vZ, p4Z, p4W ) ) );
-			const __m128 d5 = _mm_madd_ps( vX, p5X, _mm_madd_ps( vY, p5Y, _mm_madd_ps( vZ, p5Z, p5W ) ) );
-
-			__m128i c0 = __m128c( _mm_cmpgt_ps( d0, vector_float_zero ) );
-			__m128i c1 = __m128c( _mm_cmpgt_ps( d1, vector_float_zero ) );
-			__m128i c2 = __m128c( _mm_cmpgt_ps( d2, vector_float_zero ) );
-			__m128i c3 = __m128c( _mm_cmpgt_ps( d3, vector_float_zero ) );
-			__m128i c4 = __m128c( _mm_cmpgt_ps( d4, vector_float_zero ) );
-			__m128i c5 = __m128c( _mm_cmpgt_ps( d5, vector_float_zero ) );
-
-			c0 = _mm_and_si128( c0, vector_int_mask0 );
-			c1 = _mm_and_si128( c1, vector_int_mask1 );
-			c2 = _mm_and_si128( c2, vector_int_mask2 );
-			c3 = _mm_and_si128( c3, vector_int_mask3 );
-			c4 = _mm_and_si128( c4, vector_int_mask4 );
-			c5 = _mm_and_si128( c5, vector_int_mask5 );
-
-			c0 = _mm_or_si128( c0, c1 );
-			c2 = _mm_or_si128( c2, c3 );
-			c4 = _mm_or_si128( c4, c5 );
-
-			c0 = _mm_or_si128( c0, c2 );
-			c0 = _mm_or_si128( c0, c4 );
-
-			__m128i s0 = _mm_packs_epi32( c0, c0 );
-			__m128i b0 = _mm_packus_epi16( s0, s0 );
-
-			*(unsigned int *)&cullBits[i] = _mm_cvtsi128_si32( b0 );
+			for ( int n = 0; n < numParms; n++ ) {
+				const __m128 (*p)[4] = planeSplats[n];
+
+				const __m128 d0 = _mm_madd_ps( vX, p[0][0], _mm_madd_ps( vY, p[0][1], _mm_madd_ps( vZ, p[0][2], p[0][3] ) ) );
+				const __m128 d1 = _mm_madd_ps( vX, p[1][0], _mm_madd_ps( vY, p[1][1], _mm_madd_ps( vZ, p[1][2], p[1][3] ) ) );
+				const __m128 d2 = _mm_madd_ps( vX, p[2][0], _mm_madd_ps( vY, p[2][1], _mm_madd_ps( vZ, p[2][2], p[2][3] ) ) );
+				const __m128 d3 = _mm_madd_ps( vX, p[3][0], _mm_madd_ps( vY, p[3][1], _mm_madd_ps( vZ, p[3][2], p[3][3] ) ) );
+				const __m128 d4 = _mm_madd_ps( vX, p[4][0], _mm_madd_ps( vY, p[4][1], _mm_madd_ps( vZ, p[4][2], p[4][3] ) ) );
+				const __m128 d5 = _mm_madd_ps( vX, p[5][0], _mm_madd_ps( vY, p[5][1], _mm_madd_ps( vZ, p[5][2], p[5][3] ) ) );
+
+				__m128i c0 = __m128c( _mm_cmpgt_ps( d0, vector_float_zero ) );
+				__m128i c1 = __m128c( _mm_cmpgt_ps( d1, vector_float_zero ) );
+				__m128i c2 = __m128c( _mm_cmpgt_ps( d2, vector_float_zero ) );
+				__m128i c3 = __m128c( _mm_cmpgt_ps( d3, vector_float_zero ) );
+				__m128i c4 = __m128c( _mm_cmpgt_ps( d4, vector_float_zero ) );
+				__m128i c5 = __m128c( _mm_cmpgt_ps( d5, vector_float_zero ) );
+
+				c0 = _mm_and_si128( c0, vector_int_mask0 );
+				c1 = _mm_and_si128( c1, vector_int_mask1 );
+				c2 = _mm_and_si128( c2, vector_int_mask2 );
+				c3 = _mm_and_si128( c3, vector_int_mask3 );
+				c4 = _mm_and_si128( c4, vector_int_mask4 );
+				c5 = _mm_and_si128( c5, vector_int_mask5 );
+
+				c0 = _mm_or_si128( c0, c1 );
+				c2 = _mm_or_si128( c2, c3 );
+				c4 = _mm_or_si128( c4, c5 );
+
+				c0 = _mm_or_si128( c0, c2 );
+				c0 = _mm_or_si128( c0, c4 );
+
+				__m128i s0 = _mm_packs_epi32( c0, c0 );
+				__m128i b0 = _mm_packus_epi16( s0, s0 );
+
+				*(unsigned int *)&cullBits[n * cullBitsStride + i] = _mm_cvtsi128_si32( b0 );
+			}
 		}
 	}
 
@@ -388,34 +375,123 @@ static void R_DecalPointCullStatic( byte * cullBits, const idPlane * planes, con
 		for ( ; i <= nextNumVerts; i++ ) {
 			const idVec3 & v = vertsODS[i].xyz;
 
-			const float d0 = planes[0].Distance( v );
-			const float d1 = planes[1].Distance( v );
-			const float d2 = planes[2].Distance( v );
-			const float d3 = planes[3].Distance( v );
-			const float d4 = planes[4].Distance( v );
-			const float d5 = planes[5].Distance( v );
+			for ( int n = 0; n < numParms; n++ ) {
+				const idPlane * planes = parms[n]->boundingPlanes;
+
+				const float d0 = planes[0].Distance( v );
+				const float d1 = planes[1].Distance( v );
+				const float d2 = planes[2].Distance( v );
+				const float d3 = planes[3].Distance( v );
+				const float d4 = planes[4].Distance( v );
+				const float d5 = planes[5].Distance( v );
+
+				byte bits;
+				bits  = IEEE_FLT_SIGNBITNOTSET( d0 ) << 0;
+				bits |= IEEE_FLT_SIGNBITNOTSET( d1 ) << 1;
+				bits |= IEEE_FLT_SIGNBITNOTSET( d2 ) << 2;
+				bits |= IEEE_FLT_SIGNBITNOTSET( d3 ) << 3;
+				bits |= IEEE_FLT_SIGNBITNOTSET( d4 ) << 4;
+				bits |= IEEE_FLT_SIGNBITNOTSET( d5 ) << 5;
+
+				cullBits[n * cullBitsStride + i] = bits;
+			}
+		}
+	}
 
-			byte bits;
-			bits  = IEEE_FLT_SIGNBITNOTSET( d0 ) << 0;
-			bits |= IEEE_FLT_SIGNBITNOTSET( d1 ) << 1;
-			bits |= IEEE_FLT_SIGNBITNOTSET( d2 ) << 2;
-			bits |= IEEE_FLT_SIGNBITNOTSET( d3 ) << 3;
-			bits |= IEEE_FLT_SIGNBITNOTSET( d4 ) << 4;
-			bits |= IEEE_FLT_SIGNBITNOTSET( d5 ) << 5;
+#endif
+}
+
+/*
+=================
+idRenderModelDecal::CreateDecalFromTriangle
+
+Clips a single model triangle to the projection volume and adds the pieces.
+=================
+*/
+void idRenderModelDecal::CreateDecalFromTriangle( const srfTriangles_t * tri, const int firstIndex, const int orBits, const decalProjectionParms_t &localParms ) {
+	const idDrawVert * verts[3] = {
+		&tri->verts[tri->indexes[firstIndex + 0]],
+		&tri->verts[tri->indexes[firstIndex + 1]],
+		&tri->verts[tri->indexes[firstIndex + 2]]
+	};
+
+	// skip back facing triangles
+	const idPlane plane( verts[0]->xyz, verts[1]->xyz, verts[2]->xyz );
+	if ( plane.Normal() * localParms.boundingPlanes[NUM_DECAL_BOUNDING_PLANES - 2].Normal() < -0.1f ) {
+		return;
+	}
 
-			cullBits[i] = bits;
+	// create a winding with texture coordinates for the triangle
+	idFixedWinding fw;
+	fw.SetNumPoints( 3 );
+	if ( localParms.parallel ) {
+		for ( int j = 0; j < 3; j++ ) {
+			fw[j] = verts[j]->xyz;
+			fw[j].s = localParms.textureAxis[0].Distance( verts[j]->xyz );
+			fw[j].t = localParms.textureAxis[1].Distance( verts[j]->xyz );
+		}
+	} else {
+		for ( int j = 0; j < 3; j++ ) {
+			const idVec3 dir = verts[j]->xyz - localParms.projectionOrigin;
+			float scale;
+			localParms.boundingPlanes[NUM_DECAL_BOUNDING_PLANES - 1].RayIntersection( verts[j]->xyz, dir, scale );
+			const idVec3 intersection = verts[j]->xyz + scale * dir;
+
+			fw[j] = verts[j]->xyz;
+			fw[j].s = localParms.textureAxis[0].Distance( intersection );
+			fw[j].t = localParms.textureAxis[1].Distance( intersection );
 		}
 	}
 
-#endif
+	// clip the exact surface triangle to the projection volume
+	for ( int j = 0; j < NUM_DECAL_BOUNDING_PLANES; j++ ) {
+		if ( ( orBits & ( 1 << j ) ) != 0 ) {
+			if ( !fw.ClipInPlace( -localParms.boundingPlanes[j] ) ) {
+				break;
+			}
+		}
+	}
+
+	// if there is a part of the triangle between the bounding planes then clip
+	// the triangle based on depth and add decals for the depth faded parts
+	if ( fw.GetNumPoints() != 0 ) {
+		idFixedWinding back;
+
+		if ( fw.Split( &back, localParms.fadePlanes[0], 0.1f ) == SIDE_CROSS ) {
+			CreateDecalFromWinding( back, localParms.material, localParms.fadePlanes, localParms.fadeDepth, localParms.startTime );
+		}
+
+		if ( fw.Split( &back, localParms.fadePlanes[1], 0.1f ) == SIDE_CROSS ) {
+			CreateDecalFromWinding( back, localParms.material, localParms.fadePlanes, localParms.fadeDepth, localParms.startTime );
+		}
+
+		CreateDecalFromWinding( fw, localParms.material, localParms.fadePlanes, localParms.fadeDepth, localParms.startTime );
+	}
 }
 
+struct decalTriangle_t {
+	const srfTriangles_t *	tri;
+	int						firstIndex;
+	int						orBits;
+};
+
 /*
 =================
-idRenderModelDecal::CreateDecal
+idRenderModelDecal::CreateDecals
+
+Projects several decals onto the model with a single pass over the vertices
+and indexes of every surface. The triangles that touch each projection are
+gathered first and clipped afterwards, one projection after the other, so the
+decals come out in the same order as when they are created one at a time.
 =================
 */
-void idRenderModelDecal::CreateDecal( const idRenderModel *model, const decalProjectionParms_t &localParms ) {
+void idRenderModelDecal::CreateDecals( const idRenderModel *model, const decalProjectionParms_t *parms, const int numParms ) {
+	assert( numParms <= MAX_DEFERRED_DECALS );
+
+	if ( numParms <= 0 ) {
+		return;
+	}
+
 	int maxVerts = 0;
 	for ( int surfNum = 0; surfNum < model->NumSurfaces(); surfNum++ ) {
 		const modelSurface_t *surf = model->Surface( surfNum );
@@ -424,7 +500,10 @@ void idRenderModelDecal::CreateDecal( const idRenderModel *model, const decalPro
 		}
 	}
 
-	idTempArray< byte > cullBits( ALIGN( maxVerts, 4 ) );
+	const int cullBitsStride = ALIGN( maxVerts, 16 );
+	idTempArray< byte > cullBits( cullBitsStride * numParms );
+
+	idList< decalTriangle_t, TAG_MODEL > triangles[MAX_DEFERRED_DECALS];
 
 	// check all model surfaces
 	for ( int surfNum = 0; surfNum < model->NumSurfaces(); surfNum++ ) {
@@ -435,28 +514,39 @@ void idRenderModelDecal::CreateDecal( const idRenderModel *model, const decalPro
 			continue;
 		}
 
-		// decals and overlays use the same rules
-		if ( !localParms.force && !surf->shader->AllowOverlays() ) {
-			continue;
-		}
-
-		srfTriangles_t *tri = surf->geometry;
+		const srfTriangles_t *tri = surf->geometry;
 
-		// if the triangle bounds do not overlap with the projection bounds
-		if ( !localParms.projectionBounds.IntersectsBounds( tri->bounds ) ) {
+		// find the projections that may touch this surface
+		const decalProjectionParms_t * surfParms[MAX_DEFERRED_DECALS];
+		int surfParmNums[MAX_DEFERRED_DECALS];
+		int numSurfParms = 0;
+		for ( int n = 0; n < numParms; n++ ) {
+			// decals and overlays use the same rules
+			if ( !parms[n].force && !surf->shader->AllowOverlays() ) {
+				continue;
+			}
+			// if the triangle bounds do not overlap with the projection bounds
+			if ( !parms[n].projectionBounds.IntersectsBounds( tri->bounds ) ) {
+				continue;
+			}
+			surfParms[numSurfParms] = &parms[n];
+			surfParmNums[numSurfParms] = n;
+			numSurfParms++;
+		}
+		if ( numSurfParms == 0 ) {
 			continue;
 		}
 
 		// decals don't work on animated models
 		assert( tri->staticModelWithJoints == NULL );
 
-		// catagorize all points by the planes
-		R_DecalPointCullStatic( cullBits.Ptr(), localParms.boundingPlanes, tri->verts, tri->numVerts );
+		// catagorize all points by the planes of all projections
+		R_DecalPointCullStatic( cullBits.Ptr(), cullBitsStride, surfParms, numSurfParms, tri->verts, tri->numVerts );
 
 		// start streaming the indexes
 		idODSStreamedArray< triIndex_t, 256, SBT_QUAD, 3 > indexesODS( tri->indexes, tri->numIndexes );
 
-		// find triangles inside the projection volume
+		// find triangles inside the projection volumes
 		for ( int i = 0; i < tri->numIndexes; ) {
 
 			const int nextNumIndexes = indexesODS.FetchNextBatch() - 3;
@@ -466,74 +556,30 @@ void idRenderModelDecal::CreateDecal( const idRenderModel *model, const decalPro
 				const int i1 = indexesODS[i + 1];
 				const int i2 = indexesODS[i + 2];
 
-				// skip triangles completely off one side
-				if ( cullBits[i0] & cullBits[i1] & cullBits[i2] ) {
-					continue;
-				}
-
-				const idDrawVert * verts[3] = {
-					&tri->verts[i0],
-					&tri->verts[i1],
-					&tri->verts[i2]
-				};
-
-				// skip back facing triangles
-				const idPlane plane( verts[0]->xyz, verts[1]->xyz, verts[2]->xyz );
-				if ( plane.Normal() * localParms.boundingPlanes[NUM_DECAL_BOUNDING_PLANES - 2].Normal() < -0.1f ) {
-					continue;
-				}
+				for ( int n = 0; n < numSurfParms; n++ ) {
+					const byte * bits = cullBits.Ptr() + n * cullBitsStride;
 
-				// create a winding with texture coordinates for the triangle
-				idFixedWinding fw;
-				fw.SetNumPoints( 3 );
-				if ( localParms.parallel ) {
-					for ( int j = 0; j < 3; j++ ) {
-						fw[j] = verts[j]->xyz;
-						fw[j].s = localParms.textureAxis[0].Distance( verts[j]->xyz );
-						fw[j].t = localParms.textureAxis[1].Distance( verts[j]->xyz );
+					// skip triangles completely off one side
+					if ( bits[i0] & bits[i1] & bits[i2] ) {
+						continue;
 					}
-				} else {
-					for ( int j = 0; j < 3; j++ ) {
-						const idVec3 dir = verts[j]->xyz - localParms.projectionOrigin;
-						float scale;
-						localParms.boundingPlanes[NUM_DECAL_BOUNDING_PLANES - 1].RayIntersection( verts[j]->xyz, dir, scale );
-						const idVec3 intersection = verts[j]->xyz + scale * dir;
-
-						fw[j] = verts[j]->xyz;
-						fw[j].s = localParms.textureAxis[0].Distance( intersection );
-						fw[j].t = localParms.textureAxis[1].Distance( intersection );
-					}
-				}
-
-				const int orBits = cullBits[i0] | cullBits[i1] | cullBits[i2];
 
-				// clip the exact surface triangle to the projection volume
-				for ( int j = 0; j < NUM_DECAL_BOUNDING_PLANES; j++ ) {
-					if ( ( orBits & ( 1 << j ) ) != 0 ) {
-						if ( !fw.ClipInPlace( -localParms.boundingPlanes[j] ) ) {
-							break;
-						}
-					}
-				}
-
-				// if there is a part of the triangle between the bounding planes then clip
-				// the triangle based on depth and add decals for the depth faded parts
-				if ( fw.GetNumPoints() != 0 ) {
-					idFixedWinding back;
-
-					if ( fw.Split( &back, localParms.fadePlanes[0], 0.1f ) == SIDE_CROSS ) {
-						CreateDecalFromWinding( back, localParms.material, localParms.fadePlanes, localParms.fadeDepth, localParms.startTime );
-					}
-
-					if ( fw.Split( &back, localParms.fadePlanes[1], 0.1f ) == SIDE_CROSS ) {
-						CreateDecalFromWinding( back, localParms.material, localParms.fadePlanes, localParms.fadeDepth, localParms.startTime );
-					}
-
-					CreateDecalFromWinding( fw, localParms.material, localParms.fadePlanes, localParms.fadeDepth, localParms.startTime );
+					decalTriangle_t & t = triangles[surfParmNums[n]].Alloc();
+					t.tri = tri;
+					t.firstIndex = i;
+					t.orBits = bits[i0] | bits[i1] | bits[i2];
 				}
 			}
 		}
 	}
+
+	// clip the gathered triangles
+	for ( int n = 0; n < numParms; n++ ) {
+		for ( int i = 0; i < triangles[n].Num(); i++ ) {
+			const decalTriangle_t & t = triangles[n][i];
+			CreateDecalFromTriangle( t.tri, t.firstIndex, t.orBits, parms[n] );
+		}
+	}
 }
 
 /*
@@ -542,14 +588,24 @@ idRenderModelDecal::CreateDeferredDecals
 =====================
 */
 void idRenderModelDecal::CreateDeferredDecals( const idRenderModel *model ) {
+	decalProjectionParms_t parms[MAX_DEFERRED_DECALS];
+	int numParms = 0;
 	for ( unsigned int i = firstDeferredDecal; i < nextDeferredDecal; i++ ) {
-		decalProjectionParms_t & parms = deferredDecals[i & ( MAX_DEFERRED_DECALS - 1 )];
-		if ( parms.startTime > tr->viewDef->renderView.time[0] -  DEFFERED_DECAL_TIMEOUT ) {
-			CreateDecal( model, parms );
+		const decalProjectionParms_t & p = deferredDecals[i & ( MAX_DEFERRED_DECALS - 1 )];
+		if ( p.startTime > tr->viewDef->renderView.time[0] -  DEFFERED_DECAL_TIMEOUT ) {
+			parms[numParms++] = p;
 		}
 	}
 	firstDeferredDecal = 0;
 	nextDeferredDecal = 0;
+
+	if ( r_useBatchedDecals.GetBool() ) {
+		CreateDecals( model, parms, numParms );
+	} else {
+		for ( int i = 0; i < numParms; i++ ) {
+			CreateDecals( model, &parms[i], 1 );
+		}
+	}
 }
 
 /*
@@ -806,3 +862,146 @@ idRenderModelDecal::WriteToDemoFile
 void idRenderModelDecal::WriteToDemoFile( idDemoFile *f ) const {
 	// FIXME: implement
 }
+
+/*
+====================
+R_RandomProjectionAxis
+
+Random point inside the bounds with a random orthonormal axis, axis[2] is the projection direction.
+====================
+*/
+static void R_RandomProjectionAxis( const idBounds & bounds, idRandom & random, idVec3 & origin, idMat3 & axis ) {
+	for ( int i = 0; i < 3; i++ ) {
+		origin[i] = bounds[0][i] + random.RandomFloat() * ( bounds[1][i] - bounds[0][i] );
+	}
+	axis[2].Set( random.CRandomFloat(), random.CRandomFloat(), random.CRandomFloat() );
+	if ( axis[2].Normalize() < idMath::FLT_EPSILON ) {
+		axis[2].Set( 0.0f, 0.0f, 1.0f );
+	}
+	axis[2].NormalVectors( axis[0], axis[1] );
+}
+
+/*
+====================
+benchmarkDecals
+
+Projects thousands of decals onto the static models and overlays onto the
+animated models of the current map, one projection at a time and batched.
+====================
+*/
+CONSOLE_COMMAND( benchmarkDecals, "times projecting decals and overlays onto the models of the current map", 0 ) {
+	const idRenderWorldLocal * world = tr->primaryWorld;
+	if ( world == NULL ) {
+		common->Printf( "no world loaded\n" );
+		return;
+	}
+
+	const int numProjections = ( args.Argc() > 1 ) ? Max( atoi( args.Argv( 1 ) ), 1 ) : 4096;
+	const float size = 16.0f;
+
+	idList< const idRenderModel * > staticModels;
+	idList< const idRenderModel * > skinnedModels;
+	for ( int i = 0; i < world->entityDefs.Num(); i++ ) {
+		const idRenderEntityLocal * def = world->entityDefs[i];
+		if ( def == NULL || def->parms.hModel == NULL ) {
+			continue;
+		}
+		const idRenderModel * model = def->parms.hModel;
+		if ( model->IsDynamicModel() == DM_STATIC && def->parms.callback == NULL && model->NumSurfaces() > 0 ) {
+			staticModels.Append( model );
+		} else if ( model->IsDynamicModel() == DM_CACHED && def->dynamicModel != NULL && def->dynamicModel->NumSurfaces() > 0 ) {
+			// only models that have been instantiated for a view have skinned geometry
+			skinnedModels.Append( def->dynamicModel );
+		}
+	}
+
+	idRandom random( 0 );
+
+	// build all the projections up front so only the projection itself is timed
+	idList< decalProjectionParms_t > decalParms;
+	idList< const idRenderModel * > decalModels;	// the model each projection is for
+	for ( int i = 0; i < numProjections && staticModels.Num() > 0; i++ ) {
+		const idRenderModel * model = staticModels[( i / MAX_DEFERRED_DECALS ) % staticModels.Num()];
+
+		idVec3 origin;
+		idMat3 axis;
+		R_RandomProjectionAxis( model->Bounds(), random, origin, axis );
+
+		const idVec3 windingOrigin = origin + size * axis[2];
+		idFixedWinding winding;
+		winding += idVec5( windingOrigin + ( axis[0] + axis[1] ) * size * 0.5f, idVec2( 1, 1 ) );
+		winding += idVec5( windingOrigin + ( -axis[0] + axis[1] ) * size * 0.5f, idVec2( 0, 1 ) );
+		winding += idVec5( windingOrigin + ( -axis[0] - axis[1] ) * size * 0.5f, idVec2( 0, 0 ) );
+		winding += idVec5( windingOrigin + ( axis[0] - axis[1] ) * size * 0.5f, idVec2( 1, 0 ) );
+
+		decalProjectionParms_t parms;
+		if ( idRenderModelDecal::CreateProjectionParms( parms, winding, origin - size * axis[2], true, size * 0.5f, tr->defaultMaterial, 0 ) ) {
+			decalParms.Append( parms );
+			decalModels.Append( model );
+		}
+	}
+
+	idList< overlayProjectionParms_t > overlayParms;
+	for ( int i = 0; i < numProjections && skinnedModels.Num() > 0; i++ ) {
+		const idRenderModel * model = skinnedModels[( i / MAX_DEFERRED_OVERLAYS ) % skinnedModels.Num()];
+
+		idVec3 origin;
+		idMat3 axis;
+		R_RandomProjectionAxis( model->Bounds(), random, origin, axis );
+
+		overlayProjectionParms_t & parms = overlayParms.Alloc();
+		for ( int j = 0; j < 2; j++ ) {
+			const idVec3 localAxis = axis[j] * ( 1.0f / size );
+			parms.localTextureAxis[j] = localAxis;
+			parms.localTextureAxis[j][3] = -( origin * localAxis ) + 0.5f;
+		}
+		parms.material = tr->defaultMaterial;
+		parms.startTime = 0;
+	}
+
+	idRenderModelDecal * decals = new (TAG_MODEL) idRenderModelDecal;
+	idRenderModelOverlay * overlays = new (TAG_MODEL) idRenderModelOverlay;
+
+	int decalMsec[2];
+	int overlayMsec[2];
+	for ( int pass = 0; pass < 2; pass++ ) {
+		const int decalsPerBatch = ( pass == 0 ) ? 1 : MAX_DEFERRED_DECALS;
+		const int overlaysPerBatch = ( pass == 0 ) ? 1 : MAX_DEFERRED_OVERLAYS;
+
+		uint64 start = Sys_Microseconds();
+		for ( int i = 0; i < decalParms.Num(); ) {
+			// a run of projections onto the same model, at most one full batch
+			const idRenderModel * model = decalModels[i];
+			int runEnd = i + 1;
+			while ( runEnd < decalParms.Num() && runEnd - i < MAX_DEFERRED_DECALS && decalModels[runEnd] == model ) {
+				runEnd++;
+			}
+			decals->ReUse();
+			for ( int j = i; j < runEnd; j += decalsPerBatch ) {
+				decals->CreateDecals( model, &decalParms[j], Min( decalsPerBatch, runEnd - j ) );
+			}
+			i = runEnd;
+		}
+		decalMsec[pass] = (int)( ( Sys_Microseconds() - start ) / 1000 );
+
+		start = Sys_Microseconds();
+		for ( int i = 0; i < overlayParms.Num(); i += overlaysPerBatch ) {
+			const idRenderModel * model = skinnedModels[( i / MAX_DEFERRED_OVERLAYS ) % skinnedModels.Num()];
+			if ( ( i % MAX_DEFERRED_OVERLAYS ) == 0 ) {
+				overlays->ReUse();
+			}
+			overlays->CreateOverlays( model, &overlayParms[i], Min( overlaysPerBatch, overlayParms.Num() - i ) );
+		}
+		overlayMsec[pass] = (int)( ( Sys_Microseconds() - start ) / 1000 );
+	}
+
+	delete decals;
+	delete overlays;
+
+	common->Printf( "%i decals on %i static models\n", decalParms.Num(), staticModels.Num() );
+	common->Printf( "single: %i msec\n", decalMsec[0] );
+	common->Printf( "batched: %i msec (%1.1fx)\n", decalMsec[1], ( decalMsec[1] > 0 ) ? (float)decalMsec[0] / decalMsec[1] : 0.0f );
+	common->Printf( "%i overlays on %i animated models\n", overlayParms.Num(), skinnedModels.Num() );
+	common->Printf( "single: %i msec\n", overlayMsec[0] );
+	common->Printf( "batched: %i msec (%1.1fx)\n", overlayMsec[1], ( overlayMsec[1] > 0 ) ? (float)overlayMsec[0] / overlayMsec[1] : 0.0f );
+}
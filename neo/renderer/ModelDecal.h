@@ -101,9 +101,12 @@ public:
 								// Save the parameters for the renderer front-end to actually create the decal.
 	void						AddDeferredDecal( const decalProjectionParms_t & localParms );
 
-								// Creates a decal on the given model.
+								// Creates the deferred decals on the given model.
 	void						CreateDeferredDecals( const idRenderModel *model );
 
+								// Creates decals for several projections on the given model in one pass.
+	void						CreateDecals( const idRenderModel *model, const decalProjectionParms_t *parms, const int numParms );
+
 								// Remove decals that are completely faded away.
 	void						RemoveFadedDecals( int time );
 
@@ -126,7 +129,7 @@ private:
 	unsigned int				numDecalMaterials;
 
 	void						CreateDecalFromWinding( const idWinding &w, const idMaterial *decalMaterial, const idPlane fadePlanes[2], float fadeDepth, int startTime );
-	void						CreateDecal( const idRenderModel *model, const decalProjectionParms_t &localParms );
+	void						CreateDecalFromTriangle( const srfTriangles_t * tri, const int firstIndex, const int orBits, const decalProjectionParms_t &localParms );
 };
 
 #endif /* !__MODELDECAL_H__ */
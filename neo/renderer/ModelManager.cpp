@@ -35,6 +35,8 @@ If you have questions concerning this license or the applicable additional terms
 idCVar r_binaryLoadRenderModels( "r_binaryLoadRenderModels", "1", 0, "enable binary load/write of render models" );
 idCVar preload_MapModels( "preload_MapModels", "1", CVAR_SYSTEM | CVAR_BOOL, "preload models during begin or end levelload" );
 
+extern idCVar r_useParallelCleanupTriangles;
+
 class idRenderModelManagerLocal : public idRenderModelManager {
 public:
 							idRenderModelManagerLocal();
@@ -72,6 +74,7 @@ private:
 	static void				ListModels_f( const idCmdArgs &args );
 	static void				ReloadModels_f( const idCmdArgs &args );
 	static void				TouchModel_f( const idCmdArgs &args );
+	static void				BenchmarkCleanupTriangles_f( const idCmdArgs &args );
 };
 
 
@@ -179,6 +182,74 @@ void idRenderModelManagerLocal::TouchModel_f( const idCmdArgs &args ) {
 	}
 }
 
+/*
+==============
+idRenderModelManagerLocal::BenchmarkCleanupTriangles_f
+
+Times the triangle cleanup of the geometry of all loaded static models,
+serially and on the job threads.
+==============
+*/
+void idRenderModelManagerLocal::BenchmarkCleanupTriangles_f( const idCmdArgs &args ) {
+	idList< const srfTriangles_t * >	sourceTris;
+	idList< bool >						sourceUnsmoothed;
+	int numModels = 0;
+	int numTris = 0;
+
+	for ( int i = 0; i < localModelManager.models.Num(); i++ ) {
+		const idRenderModel * model = localModelManager.models[i];
+		if ( !model->IsLoaded() || model->IsDefaultModel() || model->IsDynamicModel() != DM_STATIC ) {
+			continue;
+		}
+		numModels++;
+		for ( int j = 0; j < model->NumSurfaces(); j++ ) {
+			const modelSurface_t * surf = model->Surface( j );
+			if ( surf->geometry == NULL || surf->geometry->verts == NULL || surf->geometry->indexes == NULL || surf->geometry->numIndexes == 0 ) {
+				continue;
+			}
+			sourceTris.Append( surf->geometry );
+			sourceUnsmoothed.Append( surf->shader != NULL && surf->shader->UseUnsmoothedTangents() );
+			numTris += surf->geometry->numIndexes / 3;
+		}
+	}
+
+	if ( sourceTris.Num() == 0 ) {
+		common->Printf( "no static models loaded\n" );
+		return;
+	}
+
+	idTempArray< cleanupTrianglesParms_t > parms( sourceTris.Num() );
+
+	const bool useParallel = r_useParallelCleanupTriangles.GetBool();
+
+	int msec[2];
+	for ( int pass = 0; pass < 2; pass++ ) {
+		for ( int i = 0; i < sourceTris.Num(); i++ ) {
+			parms[i].tri = R_CopyStaticTriSurf( sourceTris[i] );
+			parms[i].tri->generateNormals = sourceTris[i]->generateNormals;
+			parms[i].createNormals = sourceTris[i]->generateNormals;
+			parms[i].identifySilEdges = true;
+			parms[i].useUnsmoothedTangents = sourceUnsmoothed[i];
+		}
+
+		r_useParallelCleanupTriangles.SetBool( pass == 1 );
+
+		const uint64 start = Sys_Microseconds();
+		R_CleanupTriangleSurfaces( parms.Ptr(), sourceTris.Num() );
+		msec[pass] = (int)( ( Sys_Microseconds() - start ) / 1000 );
+
+		for ( int i = 0; i < sourceTris.Num(); i++ ) {
+			R_FreeStaticTriSurf( parms[i].tri );
+		}
+	}
+
+	r_useParallelCleanupTriangles.SetBool( useParallel );
+
+	common->Printf( "%i models, %i surfaces, %i tris\n", numModels, sourceTris.Num(), numTris );
+	common->Printf( "serial: %i msec\n", msec[0] );
+	common->Printf( "jobs: %i msec (%1.1fx)\n", msec[1], ( msec[1] > 0 ) ? (float)msec[0] / msec[1] : 0.0f );
+}
+
 /*
 =================
 idRenderModelManagerLocal::WritePrecacheCommands
@@ -212,6 +283,7 @@ void idRenderModelManagerLocal::Init() {
 	cmdSystem->AddCommand( "printModel", PrintModel_f, CMD_FL_RENDERER, "prints model info", idCmdSystem::ArgCompletion_ModelName );
 	cmdSystem->AddCommand( "reloadModels", ReloadModels_f, CMD_FL_RENDERER|CMD_FL_CHEAT, "reloads models" );
 	cmdSystem->AddCommand( "touchModel", TouchModel_f, CMD_FL_RENDERER, "touches a model", idCmdSystem::ArgCompletion_ModelName );
+	cmdSystem->AddCommand( "benchmarkCleanupTriangles", BenchmarkCleanupTriangles_f, CMD_FL_RENDERER, "times the triangle cleanup of all loaded static models" );
 
 	insideLevelLoad = false;
 
@@ -559,6 +631,7 @@ void idRenderModelManagerLocal::Preload( const idPreloadManifest &manifest  ) {
 		int numLoaded = 0;
 		idList< preloadSort_t > preloadSort;
 		preloadSort.Resize( manifest.NumResources() );
+		idStrList preloadFiles;
 		for ( int i = 0; i < manifest.NumResources(); i++ ) {
 			const preloadEntry_s & p = manifest.GetPreloadByIndex( i );
 			idResourceCacheEntry rc;
@@ -581,12 +654,16 @@ void idRenderModelManagerLocal::Preload( const idPreloadManifest &manifest  ) {
 					ps.idx = i;
 					ps.ofs = rc.offset;
 					preloadSort.Append( ps );
+					preloadFiles.Append( filename );
 				}
 			}
 		}
 		
 		preloadSort.SortWithTemplate( idSort_Preload() );
 
+		// decode the binary models on job threads while the ones before them are parsed
+		fileSystem->StartPreload( preloadFiles );
+
 		for ( int i = 0; i < preloadSort.Num(); i++ ) {
 			const preloadSort_t & ps = preloadSort[ i ];
 			const preloadEntry_s & p = manifest.GetPreloadByIndex( ps.idx );
@@ -600,6 +677,7 @@ void idRenderModelManagerLocal::Preload( const idPreloadManifest &manifest  ) {
 			}
 			numLoaded++;
 		}
+		fileSystem->StopPreload();
 
 		int	end = Sys_Milliseconds();
 		common->Printf( "%05d models preloaded ( or were already loaded ) in %5.1f seconds\n", numLoaded, ( end - start ) * 0.001 );
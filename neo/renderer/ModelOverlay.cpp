@@ -34,6 +34,8 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "../idlib/geometry/DrawVert_intrinsics.h"
 
+extern idCVar r_useBatchedDecals;
+
 /*
 ====================
 idRenderModelOverlay::idRenderModelOverlay
@@ -93,19 +95,66 @@ void idRenderModelOverlay::FreeOverlay( overlay_t & overlay ) {
 
 /*
 ====================
-R_OverlayPointCullStatic
+R_OverlayPointCull
+
+Calculates the texture coordinates and cull bits of a single point for several
+overlay projections. The results for projection N are stored N * stride
+elements after the first projection.
 ====================
 */
-static void R_OverlayPointCullStatic( byte * cullBits, halfFloat_t * texCoordS, halfFloat_t * texCoordT, const idPlane * planes, const idDrawVert * verts, const int numVerts ) {
-	assert_16_byte_aligned( cullBits );
-	assert_16_byte_aligned( texCoordS );
-	assert_16_byte_aligned( texCoordT );
-	assert_16_byte_aligned( verts );
+static ID_INLINE void R_OverlayPointCull( byte * cullBits, halfFloat_t * texCoordS, halfFloat_t * texCoordT, const int stride, const overlayProjectionParms_t * const * parms, const int numParms, const idVec3 & v ) {
+	for ( int n = 0; n < numParms; n++ ) {
+		const idPlane * planes = parms[n]->localTextureAxis;
+
+		const float d0 = planes[0].Distance( v );
+		const float d1 = planes[1].Distance( v );
+		const float d2 = 1.0f - d0;
+		const float d3 = 1.0f - d1;
+
+		halfFloat_t s = Scalar_FastF32toF16( d0 );
+		halfFloat_t t = Scalar_FastF32toF16( d1 );
+
+		texCoordS[n * stride] = s;
+		texCoordT[n * stride] = t;
+
+		byte bits;
+		bits  = IEEE_FLT_SIGNBITSET( d0 ) << 0;
+		bits |= IEEE_FLT_SIGNBITSET( d1 ) << 1;
+		bits |= IEEE_FLT_SIGNBITSET( d2 ) << 2;
+		bits |= IEEE_FLT_SIGNBITSET( d3 ) << 3;
+
+		cullBits[n * stride] = bits;
+	}
+}
 
 #ifdef ID_WIN_X86_SSE2_INTRIN
 
-	idODSStreamedArray< idDrawVert, 16, SBT_DOUBLE, 4 > vertsODS( verts, numVerts );
+/*
+====================
+R_OverlaySplatPlanes
+====================
+*/
+static void R_OverlaySplatPlanes( __m128 planeSplats[MAX_DEFERRED_OVERLAYS][2][4], const overlayProjectionParms_t * const * parms, const int numParms ) {
+	for ( int n = 0; n < numParms; n++ ) {
+		for ( int j = 0; j < 2; j++ ) {
+			const __m128 p = _mm_loadu_ps( parms[n]->localTextureAxis[j].ToFloatPtr() );
+			planeSplats[n][j][0] = _mm_splat_ps( p, 0 );
+			planeSplats[n][j][1] = _mm_splat_ps( p, 1 );
+			planeSplats[n][j][2] = _mm_splat_ps( p, 2 );
+			planeSplats[n][j][3] = _mm_splat_ps( p, 3 );
+		}
+	}
+}
 
+/*
+====================
+R_OverlayPointCull4
+
+Calculates the texture coordinates and cull bits of four points for several
+overlay projections.
+====================
+*/
+static ID_INLINE void R_OverlayPointCull4( byte * cullBits, halfFloat_t * texCoordS, halfFloat_t * texCoordT, const int stride, const __m128 planeSplats[MAX_DEFERRED_OVERLAYS][2][4], const int numParms, const __m128 & vX, const __m128 & vY, const __m128 & vZ ) {
 	const __m128 vector_float_zero	= { 0.0f, 0.0f, 0.0f, 0.0f };
 	const __m128 vector_float_one	= { 1.0f, 1.0f, 1.0f, 1.0f };
 	const __m128i vector_int_mask0	= _mm_set1_epi32( 1 << 0 );
@@ -113,18 +162,62 @@ static void R_OverlayPointCullStatic( byte * cullBits, halfFloat_t * texCoordS,
 	const __m128i vector_int_mask2	= _mm_set1_epi32( 1 << 2 );
 	const __m128i vector_int_mask3	= _mm_set1_epi32( 1 << 3 );
 
-	const __m128 p0 = _mm_loadu_ps( planes[0].ToFloatPtr() );
-	const __m128 p1 = _mm_loadu_ps( planes[1].ToFloatPtr() );
+	for ( int n = 0; n < numParms; n++ ) {
+		const __m128 (*p)[4] = planeSplats[n];
+
+		const __m128 d0 = _mm_madd_ps( vX, p[0][0], _mm_madd_ps( vY, p[0][1], _mm_madd_ps( vZ, p[0][2], p[0][3] ) ) );
+		const __m128 d1 = _mm_madd_ps( vX, p[1][0], _mm_madd_ps( vY, p[1][1], _mm_madd_ps( vZ, p[1][2], p[1][3] ) ) );
+		const __m128 d2 = _mm_sub_ps( vector_float_one, d0 );
+		const __m128 d3 = _mm_sub_ps( vector_float_one, d1 );
+
+		__m128i flt16S = FastF32toF16( __m128c( d0 ) );
+		__m128i flt16T = FastF32toF16( __m128c( d1 ) );
 
-	const __m128 p0X = _mm_splat_ps( p0, 0 );
-	const __m128 p0Y = _mm_splat_ps( p0, 1 );
-	const __m128 p0Z = _mm_splat_ps( p0, 2 );
-	const __m128 p0W = _mm_splat_ps( p0, 3 );
+		_mm_storel_epi64( (__m128i *)&texCoordS[n * stride], flt16S );
+		_mm_storel_epi64( (__m128i *)&texCoordT[n * stride], flt16T );
 
-	const __m128 p1X = _mm_splat_ps( p1, 0 );
-	const __m128 p1Y = _mm_splat_ps( p1, 1 );
-	const __m128 p1Z = _mm_splat_ps( p1, 2 );
-	const __m128 p1W = _mm_splat_ps( p1, 3 );
+		__m128i c0 = __m128c( _mm_cmplt_ps( d0, vector_float_zero ) );
+		__m128i c1 = __m128c( _mm_cmplt_ps( d1, vector_float_zero ) );
+		__m128i c2 = __m128c( _mm_cmplt_ps( d2, vector_float_zero ) );
+		__m128i c3 = __m128c( _mm_cmplt_ps( d3, vector_float_zero ) );
+
+		c0 = _mm_and_si128( c0, vector_int_mask0 );
+		c1 = _mm_and_si128( c1, vector_int_mask1 );
+		c2 = _mm_and_si128( c2, vector_int_mask2 );
+		c3 = _mm_and_si128( c3, vector_int_mask3 );
+
+		c0 = _mm_or_si128( c0, c1 );
+		c2 = _mm_or_si128( c2, c3 );
+		c0 = _mm_or_si128( c0, c2 );
+
+		c0 = _mm_packs_epi32( c0, c0 );
+		c0 = _mm_packus_epi16( c0, c0 );
+
+		*(unsigned int *)&cullBits[n * stride] = _mm_cvtsi128_si32( c0 );
+	}
+}
+
+#endif
+
+/*
+====================
+R_OverlayPointCullStatic
+====================
+*/
+static void R_OverlayPointCullStatic( byte * cullBits, halfFloat_t * texCoordS, halfFloat_t * texCoordT, const int stride, const overlayProjectionParms_t * const * parms, const int numParms, const idDrawVert * verts, const int numVerts ) {
+	assert_16_byte_aligned( cullBits );
+	assert_16_byte_aligned( texCoordS );
+	assert_16_byte_aligned( texCoordT );
+	assert_16_byte_aligned( verts );
+	assert( ( stride & 15 ) == 0 );
+	assert( numParms <= MAX_DEFERRED_OVERLAYS );
+
+#ifdef ID_WIN_X86_SSE2_INTRIN
+
+	idODSStreamedArray< idDrawVert, 16, SBT_DOUBLE, 4 > vertsODS( verts, numVerts );
+
+	ALIGN16( __m128 planeSplats[MAX_DEFERRED_OVERLAYS][2][4] );
+	R_OverlaySplatPlanes( planeSplats, parms, numParms );
 
 	for ( int i = 0; i < numVerts; ) {
 
@@ -145,35 +238,7 @@ static void R_OverlayPointCullStatic( byte * cullBits, halfFloat_t * texCoordS,
 			const __m128 vY = _mm_unpackhi_ps( r0, r2 );	// v0.y, v1.y, v2.y, v3.y
 			const __m128 vZ = _mm_unpacklo_ps( r1, r3 );	// v0.z, v1.z, v2.z, v3.z
 
-			const __m128 d0 = _mm_madd_ps( vX, p0X, _mm_madd_ps( vY, p0Y, _mm_madd_ps( vZ, p0Z, p0W ) ) );
-			const __m128 d1 = _mm_madd_ps( vX, p1X, _mm_madd_ps( vY, p1Y, _mm_madd_ps( vZ, p1Z, p1W ) ) );
-			const __m128 d2 = _mm_sub_ps( vector_float_one, d0 );
-			const __m128 d3 = _mm_sub_ps( vector_float_one, d1 );
-
-			__m128i flt16S = FastF32toF16( __m128c( d0 ) );
-			__m128i flt16T = FastF32toF16( __m128c( d1 ) );
-
-			_mm_storel_epi64( (__m128i *)&texCoordS[i], flt16S );
-			_mm_storel_epi64( (__m128i *)&texCoordT[i], flt16T );
-
-			__m128i c0 = __m128c( _mm_cmplt_ps( d0, vector_float_zero ) );
-			__m128i c1 = __m128c( _mm_cmplt_ps( d1, vector_float_zero ) );
-			__m128i c2 = __m128c( _mm_cmplt_ps( d2, vector_float_zero ) );
-			__m128i c3 = __m128c( _mm_cmplt_ps( d3, vector_float_zero ) );
-
-			c0 = _mm_and_si128( c0, vector_int_mask0 );
-			c1 = _mm_and_si128( c1, vector_int_mask1 );
-			c2 = _mm_and_si128( c2, vector_int_mask2 );
-			c3 = _mm_and_si128( c3, vector_int_mask3 );
-
-			c0 = _mm_or_si128( c0, c1 );
-			c2 = _mm_or_si128( c2, c3 );
-			c0 = _mm_or_si128( c0, c2 );
-
-			c0 = _mm_packs_epi32( c0, c0 );
-			c0 = _mm_packus_epi16( c0, c0 );
-
-			*(unsigned int *)&cullBits[i] = _mm_cvtsi128_si32( c0 );
+			R_OverlayPointCull4( cullBits + i, texCoordS + i, texCoordT + i, stride, planeSplats, numParms, vX, vY, vZ );
 		}
 	}
 
@@ -186,26 +251,7 @@ static void R_OverlayPointCullStatic( byte * cullBits, halfFloat_t * texCoordS,
 		const int nextNumVerts = vertsODS.FetchNextBatch() - 1;
 
 		for ( ; i <= nextNumVerts; i++ ) {
-			const idVec3 & v = vertsODS[i].xyz;
-
-			const float d0 = planes[0].Distance( v );
-			const float d1 = planes[1].Distance( v );
-			const float d2 = 1.0f - d0;
-			const float d3 = 1.0f - d1;
-
-			halfFloat_t s = Scalar_FastF32toF16( d0 );
-			halfFloat_t t = Scalar_FastF32toF16( d1 );
-
-			texCoordS[i] = s;
-			texCoordT[i] = t;
-
-			byte bits;
-			bits  = IEEE_FLT_SIGNBITSET( d0 ) << 0;
-			bits |= IEEE_FLT_SIGNBITSET( d1 ) << 1;
-			bits |= IEEE_FLT_SIGNBITSET( d2 ) << 2;
-			bits |= IEEE_FLT_SIGNBITSET( d3 ) << 3;
-
-			cullBits[i] = bits;
+			R_OverlayPointCull( cullBits + i, texCoordS + i, texCoordT + i, stride, parms, numParms, vertsODS[i].xyz );
 		}
 	}
 
@@ -215,37 +261,24 @@ static void R_OverlayPointCullStatic( byte * cullBits, halfFloat_t * texCoordS,
 /*
 ====================
 R_OverlayPointCullSkinned
+
+Each vertex is skinned only once for all projections.
 ====================
 */
-static void R_OverlayPointCullSkinned( byte * cullBits, halfFloat_t * texCoordS, halfFloat_t * texCoordT, const idPlane * planes, const idDrawVert * verts, const int numVerts, const idJointMat * joints ) {
+static void R_OverlayPointCullSkinned( byte * cullBits, halfFloat_t * texCoordS, halfFloat_t * texCoordT, const int stride, const overlayProjectionParms_t * const * parms, const int numParms, const idDrawVert * verts, const int numVerts, const idJointMat * joints ) {
 	assert_16_byte_aligned( cullBits );
 	assert_16_byte_aligned( texCoordS );
 	assert_16_byte_aligned( texCoordT );
 	assert_16_byte_aligned( verts );
+	assert( ( stride & 15 ) == 0 );
+	assert( numParms <= MAX_DEFERRED_OVERLAYS );
 
 #ifdef ID_WIN_X86_SSE2_INTRIN
 
 	idODSStreamedArray< idDrawVert, 16, SBT_DOUBLE, 4 > vertsODS( verts, numVerts );
 
-	const __m128 vector_float_zero	= { 0.0f, 0.0f, 0.0f, 0.0f };
-	const __m128 vector_float_one	= { 1.0f, 1.0f, 1.0f, 1.0f };
-	const __m128i vector_int_mask0	= _mm_set1_epi32( 1 << 0 );
-	const __m128i vector_int_mask1	= _mm_set1_epi32( 1 << 1 );
-	const __m128i vector_int_mask2	= _mm_set1_epi32( 1 << 2 );
-	const __m128i vector_int_mask3	= _mm_set1_epi32( 1 << 3 );
-
-	const __m128 p0 = _mm_loadu_ps( planes[0].ToFloatPtr() );
-	const __m128 p1 = _mm_loadu_ps( planes[1].ToFloatPtr() );
-
-	const __m128 p0X = _mm_splat_ps( p0, 0 );
-	const __m128 p0Y = _mm_splat_ps( p0, 1 );
-	const __m128 p0Z = _mm_splat_ps( p0, 2 );
-	const __m128 p0W = _mm_splat_ps( p0, 3 );
-
-	const __m128 p1X = _mm_splat_ps( p1, 0 );
-	const __m128 p1Y = _mm_splat_ps( p1, 1 );
-	const __m128 p1Z = _mm_splat_ps( p1, 2 );
-	const __m128 p1W = _mm_splat_ps( p1, 3 );
+	ALIGN16( __m128 planeSplats[MAX_DEFERRED_OVERLAYS][2][4] );
+	R_OverlaySplatPlanes( planeSplats, parms, numParms );
 
 	for ( int i = 0; i < numVerts; ) {
 
@@ -266,35 +299,7 @@ static void R_OverlayPointCullSkinned( byte * cullBits, halfFloat_t * texCoordS,
 			const __m128 vY = _mm_unpackhi_ps( r0, r2 );	// v0.y, v1.y, v2.y, v3.y
 			const __m128 vZ = _mm_unpacklo_ps( r1, r3 );	// v0.z, v1.z, v2.z, v3.z
 
-			const __m128 d0 = _mm_madd_ps( vX, p0X, _mm_madd_ps( vY, p0Y, _mm_madd_ps( vZ, p0Z, p0W ) ) );
-			const __m128 d1 = _mm_madd_ps( vX, p1X, _mm_madd_ps( vY, p1Y, _mm_madd_ps( vZ, p1Z, p1W ) ) );
-			const __m128 d2 = _mm_sub_ps( vector_float_one, d0 );
-			const __m128 d3 = _mm_sub_ps( vector_float_one, d1 );
-
-			__m128i flt16S = FastF32toF16( __m128c( d0 ) );
-			__m128i flt16T = FastF32toF16( __m128c( d1 ) );
-
-			_mm_storel_epi64( (__m128i *)&texCoordS[i], flt16S );
-			_mm_storel_epi64( (__m128i *)&texCoordT[i], flt16T );
-
-			__m128i c0 = __m128c( _mm_cmplt_ps( d0, vector_float_zero ) );
-			__m128i c1 = __m128c( _mm_cmplt_ps( d1, vector_float_zero ) );
-			__m128i c2 = __m128c( _mm_cmplt_ps( d2, vector_float_zero ) );
-			__m128i c3 = __m128c( _mm_cmplt_ps( d3, vector_float_zero ) );
-
-			c0 = _mm_and_si128( c0, vector_int_mask0 );
-			c1 = _mm_and_si128( c1, vector_int_mask1 );
-			c2 = _mm_and_si128( c2, vector_int_mask2 );
-			c3 = _mm_and_si128( c3, vector_int_mask3 );
-
-			c0 = _mm_or_si128( c0, c1 );
-			c2 = _mm_or_si128( c2, c3 );
-			c0 = _mm_or_si128( c0, c2 );
-
-			c0 = _mm_packs_epi32( c0, c0 );
-			c0 = _mm_packus_epi16( c0, c0 );
-
-			*(unsigned int *)&cullBits[i] = _mm_cvtsi128_si32( c0 );
+			R_OverlayPointCull4( cullBits + i, texCoordS + i, texCoordT + i, stride, planeSplats, numParms, vX, vY, vZ );
 		}
 	}
 
@@ -308,25 +313,7 @@ static void R_OverlayPointCullSkinned( byte * cullBits, halfFloat_t * texCoordS,
 
 		for ( ; i <= nextNumVerts; i++ ) {
 			const idVec3 transformed = Scalar_LoadSkinnedDrawVertPosition( vertsODS[i], joints );
-
-			const float d0 = planes[0].Distance( transformed );
-			const float d1 = planes[1].Distance( transformed );
-			const float d2 = 1.0f - d0;
-			const float d3 = 1.0f - d1;
-
-			halfFloat_t s = Scalar_FastF32toF16( d0 );
-			halfFloat_t t = Scalar_FastF32toF16( d1 );
-
-			texCoordS[i] = s;
-			texCoordT[i] = t;
-
-			byte bits;
-			bits  = IEEE_FLT_SIGNBITSET( d0 ) << 0;
-			bits |= IEEE_FLT_SIGNBITSET( d1 ) << 1;
-			bits |= IEEE_FLT_SIGNBITSET( d2 ) << 2;
-			bits |= IEEE_FLT_SIGNBITSET( d3 ) << 3;
-
-			cullBits[i] = bits;
+			R_OverlayPointCull( cullBits + i, texCoordS + i, texCoordT + i, stride, parms, numParms, transformed );
 		}
 	}
 
@@ -335,14 +322,23 @@ static void R_OverlayPointCullSkinned( byte * cullBits, halfFloat_t * texCoordS,
 
 /*
 =====================
-idRenderModelOverlay::CreateOverlay
+idRenderModelOverlay::CreateOverlays
 
 This projects on both front and back sides to avoid seams
 The material should be clamped, because entire triangles are added, some of which
 may extend well past the 0.0 to 1.0 texture range
+
+All projections are evaluated with a single pass over the vertices of each
+surface, so skinned vertices are only transformed once.
 =====================
 */
-void idRenderModelOverlay::CreateOverlay( const idRenderModel *model, const idPlane localTextureAxis[2], const idMaterial *material ) {
+void idRenderModelOverlay::CreateOverlays( const idRenderModel *model, const overlayProjectionParms_t *parms, const int numParms ) {
+	assert( numParms <= MAX_DEFERRED_OVERLAYS );
+
+	if ( numParms <= 0 ) {
+		return;
+	}
+
 	// count up the maximum possible vertices and indexes per surface
 	int maxVerts = 0;
 	int maxIndexes = 0;
@@ -357,10 +353,12 @@ void idRenderModelOverlay::CreateOverlay( const idRenderModel *model, const idPl
 	}
 	maxIndexes += 3 * 16 / sizeof( triIndex_t );	// to allow the index size to be a multiple of 16 bytes
 
+	const int stride = ALIGN( maxVerts, 16 );
+
 	// make temporary buffers for the building process
-	idTempArray< byte > cullBits( maxVerts );
-	idTempArray< halfFloat_t > texCoordS( maxVerts );
-	idTempArray< halfFloat_t > texCoordT( maxVerts );
+	idTempArray< byte > cullBits( stride * numParms );
+	idTempArray< halfFloat_t > texCoordS( stride * numParms );
+	idTempArray< halfFloat_t > texCoordT( stride * numParms );
 	idTempArray< triIndex_t > vertexRemap( maxVerts );
 	idTempArray< overlayVertex_t > overlayVerts( maxVerts );
 	idTempArray< triIndex_t > overlayIndexes( maxIndexes );
@@ -380,95 +378,110 @@ void idRenderModelOverlay::CreateOverlay( const idRenderModel *model, const idPl
 
 		const srfTriangles_t *tri = surf->geometry;
 
-		// try to cull the whole surface along the first texture axis
-		const float d0 = tri->bounds.PlaneDistance( localTextureAxis[0] );
-		if ( d0 < 0.0f || d0 > 1.0f ) {
-			continue;
-		}
+		const overlayProjectionParms_t * surfParms[MAX_DEFERRED_OVERLAYS];
+		int numSurfParms = 0;
+		for ( int n = 0; n < numParms; n++ ) {
+			// try to cull the whole surface along the first texture axis
+			const float d0 = tri->bounds.PlaneDistance( parms[n].localTextureAxis[0] );
+			if ( d0 < 0.0f || d0 > 1.0f ) {
+				continue;
+			}
 
-		// try to cull the whole surface along the second texture axis
-		const float d1 = tri->bounds.PlaneDistance( localTextureAxis[1] );
-		if ( d1 < 0.0f || d1 > 1.0f ) {
+			// try to cull the whole surface along the second texture axis
+			const float d1 = tri->bounds.PlaneDistance( parms[n].localTextureAxis[1] );
+			if ( d1 < 0.0f || d1 > 1.0f ) {
+				continue;
+			}
+
+			surfParms[numSurfParms++] = &parms[n];
+		}
+		if ( numSurfParms == 0 ) {
 			continue;
 		}
 
 		if ( tri->staticModelWithJoints != NULL && r_useGPUSkinning.GetBool() ) {
-			R_OverlayPointCullSkinned( cullBits.Ptr(), texCoordS.Ptr(), texCoordT.Ptr(), localTextureAxis, tri->verts, tri->numVerts, tri->staticModelWithJoints->jointsInverted );
+			R_OverlayPointCullSkinned( cullBits.Ptr(), texCoordS.Ptr(), texCoordT.Ptr(), stride, surfParms, numSurfParms, tri->verts, tri->numVerts, tri->staticModelWithJoints->jointsInverted );
 		} else {
-			R_OverlayPointCullStatic( cullBits.Ptr(), texCoordS.Ptr(), texCoordT.Ptr(), localTextureAxis, tri->verts, tri->numVerts );
+			R_OverlayPointCullStatic( cullBits.Ptr(), texCoordS.Ptr(), texCoordT.Ptr(), stride, surfParms, numSurfParms, tri->verts, tri->numVerts );
 		}
 
-		// start streaming the indexes
-		idODSStreamedArray< triIndex_t, 256, SBT_QUAD, 3 > indexesODS( tri->indexes, tri->numIndexes );
+		for ( int n = 0; n < numSurfParms; n++ ) {
+			const byte * surfCullBits = cullBits.Ptr() + n * stride;
+			const halfFloat_t * surfTexCoordS = texCoordS.Ptr() + n * stride;
+			const halfFloat_t * surfTexCoordT = texCoordT.Ptr() + n * stride;
 
-		memset( vertexRemap.Ptr(), -1, vertexRemap.Size() );
-		int numIndexes = 0;
-		int numVerts = 0;
-		int maxReferencedVertex = 0;
+			// start streaming the indexes
+			idODSStreamedArray< triIndex_t, 256, SBT_QUAD, 3 > indexesODS( tri->indexes, tri->numIndexes );
 
-		// find triangles that need the overlay
-		for ( int i = 0; i < tri->numIndexes; ) {
+			memset( vertexRemap.Ptr(), -1, vertexRemap.Size() );
+			int numIndexes = 0;
+			int numVerts = 0;
+			int maxReferencedVertex = 0;
 
-			const int nextNumIndexes = indexesODS.FetchNextBatch() - 3;
+			// find triangles that need the overlay
+			for ( int i = 0; i < tri->numIndexes; ) {
 
-			for ( ; i <= nextNumIndexes; i += 3 ) {
-				const int i0 = indexesODS[i + 0];
-				const int i1 = indexesODS[i + 1];
-				const int i2 = indexesODS[i + 2];
+				const int nextNumIndexes = indexesODS.FetchNextBatch() - 3;
 
-				// skip triangles completely off one side
-				if ( cullBits[i0] & cullBits[i1] & cullBits[i2] ) {
-					continue;
-				}
+				for ( ; i <= nextNumIndexes; i += 3 ) {
+					const int i0 = indexesODS[i + 0];
+					const int i1 = indexesODS[i + 1];
+					const int i2 = indexesODS[i + 2];
 
-				// we could do more precise triangle culling, like a light interaction does, but it's not worth it
+					// skip triangles completely off one side
+					if ( surfCullBits[i0] & surfCullBits[i1] & surfCullBits[i2] ) {
+						continue;
+					}
+
+					// we could do more precise triangle culling, like a light interaction does, but it's not worth it
 
-				// keep this triangle
-				for ( int j = 0; j < 3; j++ ) {
-					int index = tri->indexes[i + j];
-					if ( vertexRemap[index] == (triIndex_t) -1 ) {
-						vertexRemap[index] = numVerts;
+					// keep this triangle
+					for ( int j = 0; j < 3; j++ ) {
+						int index = tri->indexes[i + j];
+						if ( vertexRemap[index] == (triIndex_t) -1 ) {
+							vertexRemap[index] = numVerts;
 
-						overlayVerts[numVerts].vertexNum = index;
-						overlayVerts[numVerts].st[0] = texCoordS[index];
-						overlayVerts[numVerts].st[1] = texCoordT[index];
-						numVerts++;
+							overlayVerts[numVerts].vertexNum = index;
+							overlayVerts[numVerts].st[0] = surfTexCoordS[index];
+							overlayVerts[numVerts].st[1] = surfTexCoordT[index];
+							numVerts++;
 
-						maxReferencedVertex = Max( maxReferencedVertex, index );
+							maxReferencedVertex = Max( maxReferencedVertex, index );
+						}
+						overlayIndexes[numIndexes] = vertexRemap[index];
+						numIndexes++;
 					}
-					overlayIndexes[numIndexes] = vertexRemap[index];
-					numIndexes++;
 				}
 			}
-		}
 
-		if ( numIndexes == 0 ) {
-			continue;
-		}
+			if ( numIndexes == 0 ) {
+				continue;
+			}
 
-		// add degenerate triangles until the index size is a multiple of 16 bytes
-		for ( ; ( ( ( numIndexes * sizeof( triIndex_t ) ) & 15 ) != 0 ); numIndexes += 3 ) {
-			overlayIndexes[numIndexes + 0] = 0;
-			overlayIndexes[numIndexes + 1] = 0;
-			overlayIndexes[numIndexes + 2] = 0;
-		}
+			// add degenerate triangles until the index size is a multiple of 16 bytes
+			for ( ; ( ( ( numIndexes * sizeof( triIndex_t ) ) & 15 ) != 0 ); numIndexes += 3 ) {
+				overlayIndexes[numIndexes + 0] = 0;
+				overlayIndexes[numIndexes + 1] = 0;
+				overlayIndexes[numIndexes + 2] = 0;
+			}
 
-		// allocate a new overlay
-		overlay_t & overlay = overlays[nextOverlay++ & ( MAX_OVERLAYS - 1 )];
-		FreeOverlay( overlay );
-		overlay.material = material;
-		overlay.surfaceNum = surfNum;
-		overlay.surfaceId = surf->id;
-		overlay.numIndexes = numIndexes;
-		overlay.indexes = (triIndex_t *)Mem_Alloc( numIndexes * sizeof( overlay.indexes[0] ), TAG_MODEL );
-		memcpy( overlay.indexes, overlayIndexes.Ptr(), numIndexes * sizeof( overlay.indexes[0] ) );
-		overlay.numVerts = numVerts;
-		overlay.verts = (overlayVertex_t *)Mem_Alloc( numVerts * sizeof( overlay.verts[0] ), TAG_MODEL );
-		memcpy( overlay.verts, overlayVerts.Ptr(), numVerts * sizeof( overlay.verts[0] ) );
-		overlay.maxReferencedVertex = maxReferencedVertex;
-
-		if ( nextOverlay - firstOverlay > MAX_OVERLAYS ) {
-			firstOverlay = nextOverlay - MAX_OVERLAYS;
+			// allocate a new overlay
+			overlay_t & overlay = overlays[nextOverlay++ & ( MAX_OVERLAYS - 1 )];
+			FreeOverlay( overlay );
+			overlay.material = surfParms[n]->material;
+			overlay.surfaceNum = surfNum;
+			overlay.surfaceId = surf->id;
+			overlay.numIndexes = numIndexes;
+			overlay.indexes = (triIndex_t *)Mem_Alloc( numIndexes * sizeof( overlay.indexes[0] ), TAG_MODEL );
+			memcpy( overlay.indexes, overlayIndexes.Ptr(), numIndexes * sizeof( overlay.indexes[0] ) );
+			overlay.numVerts = numVerts;
+			overlay.verts = (overlayVertex_t *)Mem_Alloc( numVerts * sizeof( overlay.verts[0] ), TAG_MODEL );
+			memcpy( overlay.verts, overlayVerts.Ptr(), numVerts * sizeof( overlay.verts[0] ) );
+			overlay.maxReferencedVertex = maxReferencedVertex;
+
+			if ( nextOverlay - firstOverlay > MAX_OVERLAYS ) {
+				firstOverlay = nextOverlay - MAX_OVERLAYS;
+			}
 		}
 	}
 }
@@ -479,14 +492,24 @@ idRenderModelOverlay::CreateDeferredOverlays
 ====================
 */
 void idRenderModelOverlay::CreateDeferredOverlays( const idRenderModel * model ) {
+	overlayProjectionParms_t parms[MAX_DEFERRED_OVERLAYS];
+	int numParms = 0;
 	for ( unsigned int i = firstDeferredOverlay; i < nextDeferredOverlay; i++ ) {
-		const overlayProjectionParms_t & parms = deferredOverlays[i & ( MAX_DEFERRED_OVERLAYS - 1 )];
-		if ( parms.startTime > tr->viewDef->renderView.time[0] -  DEFFERED_OVERLAY_TIMEOUT ) {
-			CreateOverlay( model, parms.localTextureAxis, parms.material );
+		const overlayProjectionParms_t & p = deferredOverlays[i & ( MAX_DEFERRED_OVERLAYS - 1 )];
+		if ( p.startTime > tr->viewDef->renderView.time[0] -  DEFFERED_OVERLAY_TIMEOUT ) {
+			parms[numParms++] = p;
 		}
 	}
 	firstDeferredOverlay = 0;
 	nextDeferredOverlay = 0;
+
+	if ( r_useBatchedDecals.GetBool() ) {
+		CreateOverlays( model, parms, numParms );
+	} else {
+		for ( int i = 0; i < numParms; i++ ) {
+			CreateOverlays( model, &parms[i], 1 );
+		}
+	}
 }
 
 /*
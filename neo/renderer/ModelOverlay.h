@@ -84,6 +84,7 @@ public:
 
 	void						AddDeferredOverlay( const overlayProjectionParms_t & localParms );
 	void						CreateDeferredOverlays( const idRenderModel * model );
+	void						CreateOverlays( const idRenderModel * model, const overlayProjectionParms_t * parms, const int numParms );
 
 	unsigned int				GetNumOverlayDrawSurfs();
 	struct drawSurf_t *			CreateOverlayDrawSurf( const struct viewEntity_t *space, const idRenderModel *baseModel, unsigned int index );
@@ -103,7 +104,6 @@ private:
 	const idMaterial *			overlayMaterials[MAX_OVERLAYS];
 	unsigned int				numOverlayMaterials;
 
-	void						CreateOverlay( const idRenderModel *model, const idPlane localTextureAxis[2], const idMaterial *material );
 	void						FreeOverlay( overlay_t & overlay );
 };
 
@@ -32,6 +32,8 @@ If you have questions concerning this license or the applicable additional terms
 #include "tr_local.h"
 #include "Model_local.h"
 
+extern idCVar r_useParticleBatches;
+
 static const char *parametricParticle_SnapshotName = "_ParametricParticle_Snapshot_";
 
 /*
@@ -158,6 +160,10 @@ idRenderModel *idRenderModelPrt::InstantiateDynamicModel( const struct renderEnt
 		int numVerts = 0;
 		idDrawVert *verts = surf->geometry->verts;
 
+		// live particles are gathered so their colors and quads can be evaluated together
+		particleGen_t batch[MAX_PARTICLE_BATCH];
+		int numBatched = 0;
+
 		for ( int index = 0; index < stage->totalParticles; index++ ) {
 			g.index = index;
 
@@ -210,8 +216,13 @@ idRenderModel *idRenderModelPrt::InstantiateDynamicModel( const struct renderEnt
 			g.age = g.frac * stage->particleLife;
 
 			// if the particle doesn't get drawn because it is faded out or beyond a kill region, don't increment the verts
-			numVerts += stage->CreateParticle( &g, verts + numVerts );
+			batch[numBatched++] = g;
+			if ( numBatched == MAX_PARTICLE_BATCH ) {
+				numVerts += stage->CreateParticles( batch, numBatched, verts + numVerts );
+				numBatched = 0;
+			}
 		}
+		numVerts += stage->CreateParticles( batch, numBatched, verts + numVerts );
 
 		// numVerts must be a multiple of 4
 		assert( ( numVerts & 3 ) == 0 && numVerts <= 4 * count );
@@ -285,3 +296,90 @@ int idRenderModelPrt::Memory() const {
 
 	return total;
 }
+
+/*
+====================
+benchmarkParticles
+
+Instantiates thousands of emitters of a particle model at different times,
+with and without batched particle evaluation.
+====================
+*/
+CONSOLE_COMMAND( benchmarkParticles, "times the instantiation of thousands of emitters of a particle model", idCmdSystem::ArgCompletion_ModelName ) {
+	if ( args.Argc() < 2 ) {
+		common->Printf( "usage: benchmarkParticles <model.prt> [numEmitters]\n" );
+		return;
+	}
+
+	idRenderModel * model = renderModelManager->FindModel( args.Argv( 1 ) );
+	if ( model == NULL || dynamic_cast<idRenderModelPrt *>( model ) == NULL ) {
+		common->Printf( "\"%s\" is not a particle model\n", args.Argv( 1 ) );
+		return;
+	}
+
+	const int numEmitters = ( args.Argc() > 2 ) ? Max( atoi( args.Argv( 2 ) ), 1 ) : 4096;
+
+	viewDef_t * viewDef = (viewDef_t *)Mem_ClearedAlloc( sizeof( viewDef_t ), TAG_RENDER );
+	viewDef->renderView.viewaxis.Identity();
+	viewDef->renderView.time[0] = viewDef->renderView.time[1] = 10000;
+
+	idTempArray< renderEntity_t > entities( numEmitters );
+	idTempArray< idRenderModel * > snapshots( numEmitters );
+	entities.Zero();
+	snapshots.Zero();
+
+	idRandom random( 0 );
+	for ( int i = 0; i < numEmitters; i++ ) {
+		renderEntity_t & ent = entities[i];
+		ent.hModel = model;
+		ent.axis.Identity();
+		ent.shaderParms[SHADERPARM_RED] = 1.0f;
+		ent.shaderParms[SHADERPARM_GREEN] = 1.0f;
+		ent.shaderParms[SHADERPARM_BLUE] = 1.0f;
+		ent.shaderParms[SHADERPARM_ALPHA] = 1.0f;
+		ent.shaderParms[SHADERPARM_TIMEOFFSET] = -random.RandomFloat() * 10.0f;
+		ent.shaderParms[SHADERPARM_DIVERSITY] = random.RandomFloat();
+	}
+
+	// allocate all the snapshot surfaces before timing anything
+	for ( int i = 0; i < numEmitters; i++ ) {
+		snapshots[i] = model->InstantiateDynamicModel( &entities[i], viewDef, snapshots[i] );
+	}
+
+	const bool useBatches = r_useParticleBatches.GetBool();
+
+	int msec[2];
+	int numVerts[2];
+	for ( int pass = 0; pass < 2; pass++ ) {
+		r_useParticleBatches.SetBool( pass == 1 );
+
+		numVerts[pass] = 0;
+		const uint64 start = Sys_Microseconds();
+		for ( int i = 0; i < numEmitters; i++ ) {
+			snapshots[i] = model->InstantiateDynamicModel( &entities[i], viewDef, snapshots[i] );
+		}
+		msec[pass] = (int)( ( Sys_Microseconds() - start ) / 1000 );
+
+		for ( int i = 0; i < numEmitters; i++ ) {
+			if ( snapshots[i] != NULL ) {
+				for ( int j = 0; j < snapshots[i]->NumSurfaces(); j++ ) {
+					numVerts[pass] += snapshots[i]->Surface( j )->geometry->numVerts;
+				}
+			}
+		}
+	}
+
+	r_useParticleBatches.SetBool( useBatches );
+
+	for ( int i = 0; i < numEmitters; i++ ) {
+		delete snapshots[i];
+	}
+	Mem_Free( viewDef );
+
+	common->Printf( "%i emitters, %i verts\n", numEmitters, numVerts[0] );
+	if ( numVerts[0] != numVerts[1] ) {
+		common->Printf( "batched evaluation created %i verts\n", numVerts[1] );
+	}
+	common->Printf( "single: %i msec\n", msec[0] );
+	common->Printf( "batched: %i msec (%1.1fx)\n", msec[1], ( msec[1] > 0 ) ? (float)msec[0] / msec[1] : 0.0f );
+}
@@ -184,6 +184,12 @@ void idImageGL::SetTexParameters() {
 		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_G, GL_RED );
 		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_B, GL_RED );
 		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_A, GL_RED );
+	} else if ( opts.format == FMT_BC5 ) {
+		// the shaders read normal maps in the DXT5 layout, X in alpha and Y in green
+		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_R, GL_ZERO );
+		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_G, GL_GREEN );
+		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_B, GL_ZERO );
+		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_A, GL_RED );
 	} else {
 		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_R, GL_RED );
 		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_G, GL_GREEN );
@@ -201,6 +207,11 @@ void idImageGL::SetTexParameters() {
 		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_G, GL_ONE );
 		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_B, GL_ONE );
 		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_A, GL_RED );
+	} else if ( opts.format == FMT_BC5 ) {
+		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_R, GL_ZERO );
+		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_G, GL_GREEN );
+		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_B, GL_ZERO );
+		qglTexParameteri( target, GL_TEXTURE_SWIZZLE_A, GL_RED );
 	}
 #endif
 
@@ -354,6 +365,16 @@ void idImageGL::AllocImage() {
 		dataFormat = GL_RGBA;
 		dataType = GL_UNSIGNED_BYTE;
 		break;
+	case FMT_BC5:
+		internalFormat = GL_COMPRESSED_RG_RGTC2;
+		dataFormat = GL_RG;
+		dataType = GL_UNSIGNED_BYTE;
+		break;
+	case FMT_BC7:
+		internalFormat = GL_COMPRESSED_RGBA_BPTC_UNORM_ARB;
+		dataFormat = GL_RGBA;
+		dataType = GL_UNSIGNED_BYTE;
+		break;
 	case FMT_DEPTH:
 		internalFormat = GL_DEPTH_COMPONENT;
 		dataFormat = GL_DEPTH_COMPONENT;
@@ -76,6 +76,11 @@ static void R_PerformanceCounters() {
 		common->Printf( "viewEntities:%i  shadowEntities:%i  viewLights:%i\n", tr->pc.c_visibleViewEntities,
 			tr->pc.c_shadowViewEntities, tr->pc.c_viewLights );
 	}
+	if ( r_showOcclusion.GetBool() ) {
+		common->Printf( "occluderTris:%i  occludedEntities:%i  occludedLights:%i  occludedShadows:%i  msec:%.2f\n",
+			tr->pc.c_occluderTris, tr->pc.c_occludedEntities, tr->pc.c_occludedLights,
+			tr->pc.c_occludedShadows, tr->pc.occlusionMicroSec * 0.001f );
+	}
 	if ( r_showUpdates.GetBool() ) {
 		common->Printf( "entityUpdates:%i  entityRefs:%i  lightUpdates:%i  lightRefs:%i\n", 
 			tr->pc.c_entityUpdates, tr->pc.c_entityReferences,
@@ -684,6 +689,9 @@ void idRenderSystemLocal::SwapCommandBuffers_FinishRendering(
 	// print any other statistics and clear all of them
 	R_PerformanceCounters();
 
+	// move the streamed image levels while neither the front end nor the back end are running
+	globalImages->UpdateStreaming();
+
 	// check for dynamic changes that require some initialization
 	R_CheckCvars();
 
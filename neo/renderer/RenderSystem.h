@@ -108,6 +108,8 @@ struct glconfig_t {
 	bool				multitextureAvailable;
 	bool				directStateAccess;
 	bool				textureCompressionAvailable;
+	bool				textureCompressionRGTCAvailable;	// BC5
+	bool				textureCompressionBPTCAvailable;	// BC7
 	bool				anisotropicFilterAvailable;
 	bool				textureLODBiasAvailable;
 	bool				seamlessCubeMapAvailable;
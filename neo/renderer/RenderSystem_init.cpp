@@ -166,6 +166,7 @@ idCVar r_showAddModel( "r_showAddModel", "0", CVAR_RENDERER | CVAR_BOOL, "report
 idCVar r_showDepth( "r_showDepth", "0", CVAR_RENDERER | CVAR_BOOL, "display the contents of the depth buffer and the depth range" );
 idCVar r_showSurfaces( "r_showSurfaces", "0", CVAR_RENDERER | CVAR_BOOL, "report surface/light/shadow counts" );
 idCVar r_showPrimitives( "r_showPrimitives", "0", CVAR_RENDERER | CVAR_INTEGER, "report drawsurf/index/vertex counts" );
+idCVar r_showOcclusion( "r_showOcclusion", "0", CVAR_RENDERER | CVAR_BOOL, "report software occlusion culling stats" );
 idCVar r_showEdges( "r_showEdges", "0", CVAR_RENDERER | CVAR_BOOL, "draw the sil edges" );
 idCVar r_showTexturePolarity( "r_showTexturePolarity", "0", CVAR_RENDERER | CVAR_BOOL, "shade triangles by texture area polarity" );
 idCVar r_showTangentSpace( "r_showTangentSpace", "0", CVAR_RENDERER | CVAR_INTEGER, "shade triangles by tangent space, 1 = use 1st tangent vector, 2 = use 2nd tangent vector, 3 = use normal vector", 0, 3, idCmdSystem::ArgCompletion_Integer<0,3> );
@@ -403,6 +404,10 @@ static void R_CheckPortableExtensions() {
 		qglGetCompressedTexImageARB = (PFNGLGETCOMPRESSEDTEXIMAGEARBPROC)GLimp_ExtensionPointer( "glGetCompressedTexImageARB" );
 	}
 
+	// GL_ARB_texture_compression_rgtc and GL_ARB_texture_compression_bptc, core in 3.0 and 4.2
+	glConfig.textureCompressionRGTCAvailable = glConfig.textureCompressionAvailable && ( glConfig.glVersion >= 3.0f || R_CheckExtension( "GL_ARB_texture_compression_rgtc" ) );
+	glConfig.textureCompressionBPTCAvailable = glConfig.textureCompressionAvailable && ( glConfig.glVersion >= 4.2f || R_CheckExtension( "GL_ARB_texture_compression_bptc" ) );
+
 	// GL_EXT_texture_filter_anisotropic
 	glConfig.anisotropicFilterAvailable = R_CheckExtension( "GL_EXT_texture_filter_anisotropic" );
 	if ( glConfig.anisotropicFilterAvailable ) {
@@ -2083,6 +2088,7 @@ void idRenderSystemLocal::Clear() {
 	}
 
 	frontEndJobList = NULL;
+	modelJobList = NULL;
 
 	memset(&unitSquareSurface_, 0, sizeof(drawSurf_t));
 	memset(&zeroOneCubeSurface_, 0, sizeof(drawSurf_t));
@@ -2338,6 +2344,7 @@ void idRenderSystemLocal::Init() {
 	}
 
 	frontEndJobList = parallelJobManager->AllocJobList( JOBLIST_RENDERER_FRONTEND, JOBLIST_PRIORITY_MEDIUM, 2048, 0, NULL );
+	modelJobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, MAX_CLEANUP_TRIANGLES_JOBS, 0, NULL );
 
 	// make sure the command buffers are ready to accept the first screen update
 	SwapCommandBuffers( NULL, NULL, NULL, NULL );
@@ -2380,6 +2387,7 @@ void idRenderSystemLocal::Shutdown() {
 	delete guiModel;
 
 	parallelJobManager->FreeJobList( frontEndJobList );
+	parallelJobManager->FreeJobList( modelJobList );
 
 	Clear();
 
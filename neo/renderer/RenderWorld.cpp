@@ -1162,7 +1162,7 @@ bool idRenderWorldLocal::ModelTrace( modelTrace_t &trace, qhandle_t entityHandle
 
 	renderEntity_t *refEnt = &def->parms;
 
-	idRenderModel *model = R_EntityDefDynamicModel( def );
+	idRenderModel *model = R_EntityDefTraceModel( def );
 	if ( model == NULL ) {
 		return false;
 	}
@@ -1294,7 +1294,7 @@ bool idRenderWorldLocal::Trace( modelTrace_t &trace, const idVec3 &start, const
 				}
 #endif
 
-				model = R_EntityDefDynamicModel( def );
+				model = R_EntityDefTraceModel( def );
 				if ( !model ) {
 					continue;	// can happen with particle systems, which don't instantiate without a valid view
 				}
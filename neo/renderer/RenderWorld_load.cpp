@@ -88,6 +88,8 @@ void idRenderWorldLocal::FreeWorld() {
 	}
 	localModels.Clear();
 
+	occlusion.Clear();
+
 	areaReferenceAllocator.Shutdown();
 	interactionAllocator.Shutdown();
 
@@ -916,6 +918,12 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 	AddWorldModelEntities();
 	ClearPortalStates();
 
+	// gather the large opaque area surfaces for software occlusion culling
+	occlusion.Clear();
+	for ( int i = 0; i < numPortalAreas; i++ ) {
+		occlusion.AddAreaOccluders( i, renderModelManager->FindModel( va( "_area%i", i ) ) );
+	}
+
 	// done!
 	return true;
 }
@@ -30,6 +30,7 @@ If you have questions concerning this license or the applicable additional terms
 #define __RENDERWORLDLOCAL_H__
 
 #include "BoundsTrack.h"
+#include "SoftwareOcclusion.h"
 
 // assume any lightDef or entityDef index above this is an internal error
 const int LUDICROUS_INDEX	= 10000;
@@ -171,6 +172,8 @@ public:
 	idList<idRenderEntityLocal*, TAG_ENTITY>	entityDefs;
 	idList<idRenderLightLocal*, TAG_LIGHT>		lightDefs;
 
+	idSoftwareOcclusion		occlusion;				// large opaque area surfaces, rendered for each view
+
 	idBlockAlloc<areaReference_t, 1024> areaReferenceAllocator;
 	idBlockAlloc<idInteraction, 256>	interactionAllocator;
 
@@ -0,0 +1,739 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. 
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").  
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#pragma hdrstop
+#include "../idlib/precompiled.h"
+
+#include "tr_local.h"
+
+extern idCVar r_useParallelAddModels;
+
+idCVar r_useSoftwareOcclusion( "r_useSoftwareOcclusion", "0", CVAR_RENDERER | CVAR_BOOL, "cull entities, lights and shadows against a software rasterized depth buffer of the large world surfaces" );
+idCVar r_occluderMinTriangleArea( "r_occluderMinTriangleArea", "1024", CVAR_RENDERER | CVAR_FLOAT, "minimum area of a world triangle to be used as an occluder, takes effect on the next map load" );
+
+/*
+================================================================================================
+
+	Occluder setup
+
+================================================================================================
+*/
+
+// A conservatively rasterized occluder triangle.
+// A pixel is completely covered if all edge functions are >= 0 at the pixel center.
+// The farthest 1/w inside a covered pixel is depthA * x + depthB * y + depthC at the pixel center.
+struct occluderTri_t {
+	float		edgeA[3];
+	float		edgeB[3];
+	float		edgeC[3];
+	float		depthA;
+	float		depthB;
+	float		depthC;
+	short		x1;
+	short		y1;
+	short		x2;
+	short		y2;
+};
+
+struct occluderBandParms_t {
+	const occluderTri_t *	tris;
+	int						numTris;
+	float *					depthBuffer;
+	int						y1;
+	int						y2;		// inclusive
+};
+
+/*
+========================
+idSoftwareOcclusion::idSoftwareOcclusion
+========================
+*/
+idSoftwareOcclusion::idSoftwareOcclusion() :
+	depthBuffer( NULL ),
+	zNear( 0.0f ),
+	validViewCount( -1 ) {
+}
+
+/*
+========================
+idSoftwareOcclusion::~idSoftwareOcclusion
+========================
+*/
+idSoftwareOcclusion::~idSoftwareOcclusion() {
+	Clear();
+}
+
+/*
+========================
+idSoftwareOcclusion::Clear
+========================
+*/
+void idSoftwareOcclusion::Clear() {
+	surfaces.Clear();
+	vertsX.Clear();
+	vertsY.Clear();
+	vertsZ.Clear();
+	indexes.Clear();
+	Mem_Free16( depthBuffer );
+	depthBuffer = NULL;
+	validViewCount = -1;
+}
+
+/*
+========================
+idSoftwareOcclusion::AddAreaOccluders
+
+Only opaque surfaces that will always be drawn are considered, and of those only
+the triangles that are large enough to hide something, unless the material has
+explicitly been marked with "forceOccluder".
+========================
+*/
+void idSoftwareOcclusion::AddAreaOccluders( const int areaNum, const idRenderModel * model ) {
+	if ( model == NULL ) {
+		return;
+	}
+
+	const float minArea = r_occluderMinTriangleArea.GetFloat();
+
+	for ( int i = 0; i < model->NumSurfaces(); i++ ) {
+		const modelSurface_t * surf = model->Surface( i );
+		const idMaterial * shader = surf->shader;
+		const srfTriangles_t * tri = surf->geometry;
+
+		if ( shader == NULL || tri == NULL || tri->verts == NULL || tri->indexes == NULL ) {
+			continue;
+		}
+		if ( !shader->IsDrawn() || shader->Coverage() != MC_OPAQUE || shader->Deform() != DFRM_NONE ) {
+			continue;
+		}
+		if ( shader->HasSubview() || shader->IsPortalSky() || shader->TestMaterialFlag( MF_NOOCCLUDER ) ) {
+			continue;
+		}
+
+		const bool forceOccluder = shader->TestMaterialFlag( MF_FORCEOCCLUDER );
+
+		occluderSurface_t occSurf;
+		occSurf.bounds.Clear();
+		occSurf.areaNum = areaNum;
+		occSurf.firstVert = vertsX.Num();
+		occSurf.numVerts = 0;
+		occSurf.firstIndex = indexes.Num();
+		occSurf.numIndexes = 0;
+
+		for ( int j = 0; j < tri->numIndexes; j += 3 ) {
+			const idVec3 & v0 = tri->verts[tri->indexes[j + 0]].xyz;
+			const idVec3 & v1 = tri->verts[tri->indexes[j + 1]].xyz;
+			const idVec3 & v2 = tri->verts[tri->indexes[j + 2]].xyz;
+
+			if ( !forceOccluder ) {
+				const float area = 0.5f * ( ( v1 - v0 ).Cross( v2 - v0 ) ).Length();
+				if ( area < minArea ) {
+					continue;
+				}
+			}
+
+			indexes.Append( occSurf.firstVert + tri->indexes[j + 0] );
+			indexes.Append( occSurf.firstVert + tri->indexes[j + 1] );
+			indexes.Append( occSurf.firstVert + tri->indexes[j + 2] );
+
+			occSurf.bounds.AddPoint( v0 );
+			occSurf.bounds.AddPoint( v1 );
+			occSurf.bounds.AddPoint( v2 );
+			occSurf.numIndexes += 3;
+		}
+
+		if ( occSurf.numIndexes == 0 ) {
+			continue;
+		}
+
+		// pad the vertices to a multiple of 4 so they can be transformed in groups
+		occSurf.numVerts = ( tri->numVerts + 3 ) & ~3;
+		for ( int j = 0; j < occSurf.numVerts; j++ ) {
+			const idVec3 & v = tri->verts[ Min( j, tri->numVerts - 1 ) ].xyz;
+			vertsX.Append( v.x );
+			vertsY.Append( v.y );
+			vertsZ.Append( v.z );
+		}
+
+		surfaces.Append( occSurf );
+	}
+
+	if ( surfaces.Num() > 0 && depthBuffer == NULL ) {
+		depthBuffer = (float *)Mem_Alloc16( BUFFER_WIDTH * BUFFER_HEIGHT * sizeof( depthBuffer[0] ), TAG_RENDER );
+	}
+}
+
+/*
+========================
+R_TransformOccluderVerts
+
+Transforms the occluder vertices to the clip space X, Y and W.
+The number of vertices must be a multiple of 4.
+========================
+*/
+static void R_TransformOccluderVerts( float * clipX, float * clipY, float * clipW, const float * x, const float * y, const float * z, const int numVerts, const idRenderMatrix & mvp ) {
+	assert( ( numVerts & 3 ) == 0 );
+
+#ifdef ID_WIN_X86_SSE2_INTRIN
+
+	const __m128 mvp0 = _mm_loadu_ps( mvp[0] );
+	const __m128 mvp1 = _mm_loadu_ps( mvp[1] );
+	const __m128 mvp3 = _mm_loadu_ps( mvp[3] );
+
+	const __m128 m00 = _mm_splat_ps( mvp0, 0 );
+	const __m128 m01 = _mm_splat_ps( mvp0, 1 );
+	const __m128 m02 = _mm_splat_ps( mvp0, 2 );
+	const __m128 m03 = _mm_splat_ps( mvp0, 3 );
+
+	const __m128 m10 = _mm_splat_ps( mvp1, 0 );
+	const __m128 m11 = _mm_splat_ps( mvp1, 1 );
+	const __m128 m12 = _mm_splat_ps( mvp1, 2 );
+	const __m128 m13 = _mm_splat_ps( mvp1, 3 );
+
+	const __m128 m30 = _mm_splat_ps( mvp3, 0 );
+	const __m128 m31 = _mm_splat_ps( mvp3, 1 );
+	const __m128 m32 = _mm_splat_ps( mvp3, 2 );
+	const __m128 m33 = _mm_splat_ps( mvp3, 3 );
+
+	for ( int i = 0; i < numVerts; i += 4 ) {
+		const __m128 vX = _mm_load_ps( x + i );
+		const __m128 vY = _mm_load_ps( y + i );
+		const __m128 vZ = _mm_load_ps( z + i );
+
+		_mm_store_ps( clipX + i, _mm_madd_ps( vX, m00, _mm_madd_ps( vY, m01, _mm_madd_ps( vZ, m02, m03 ) ) ) );
+		_mm_store_ps( clipY + i, _mm_madd_ps( vX, m10, _mm_madd_ps( vY, m11, _mm_madd_ps( vZ, m12, m13 ) ) ) );
+		_mm_store_ps( clipW + i, _mm_madd_ps( vX, m30, _mm_madd_ps( vY, m31, _mm_madd_ps( vZ, m32, m33 ) ) ) );
+	}
+
+#else
+
+	for ( int i = 0; i < numVerts; i++ ) {
+		clipX[i] = mvp[0][0] * x[i] + mvp[0][1] * y[i] + mvp[0][2] * z[i] + mvp[0][3];
+		clipY[i] = mvp[1][0] * x[i] + mvp[1][1] * y[i] + mvp[1][2] * z[i] + mvp[1][3];
+		clipW[i] = mvp[3][0] * x[i] + mvp[3][1] * y[i] + mvp[3][2] * z[i] + mvp[3][3];
+	}
+
+#endif
+}
+
+/*
+========================
+R_SetupOccluderTri
+
+The clip space vertices are stored as ( X, Y, W ) and must all be in front of the near plane.
+Returns false if the triangle can't completely cover any pixel.
+========================
+*/
+static bool R_SetupOccluderTri( occluderTri_t & tri, const idVec3 clip[3] ) {
+	const float scaleX = 0.5f * idSoftwareOcclusion::BUFFER_WIDTH;
+	const float scaleY = 0.5f * idSoftwareOcclusion::BUFFER_HEIGHT;
+
+	float px[3];
+	float py[3];
+	float pz[3];
+	for ( int i = 0; i < 3; i++ ) {
+		pz[i] = 1.0f / clip[i].z;
+		px[i] = ( clip[i].x * pz[i] + 1.0f ) * scaleX;
+		py[i] = ( clip[i].y * pz[i] + 1.0f ) * scaleY;
+	}
+
+	const float area = ( px[1] - px[0] ) * ( py[2] - py[0] ) - ( px[2] - px[0] ) * ( py[1] - py[0] );
+	if ( idMath::Fabs( area ) < 1.0f ) {
+		// smaller than a pixel
+		return false;
+	}
+
+	const float minX = Max( Min( px[0], Min( px[1], px[2] ) ), 0.0f );
+	const float minY = Max( Min( py[0], Min( py[1], py[2] ) ), 0.0f );
+	const float maxX = Min( Max( px[0], Max( px[1], px[2] ) ), (float)( idSoftwareOcclusion::BUFFER_WIDTH - 1 ) );
+	const float maxY = Min( Max( py[0], Max( py[1], py[2] ) ), (float)( idSoftwareOcclusion::BUFFER_HEIGHT - 1 ) );
+	if ( minX > maxX || minY > maxY ) {
+		return false;
+	}
+
+	tri.x1 = (short)idMath::Ftoi( minX );
+	tri.y1 = (short)idMath::Ftoi( minY );
+	tri.x2 = (short)idMath::Ftoi( maxX );
+	tri.y2 = (short)idMath::Ftoi( maxY );
+
+	// orient the edges so the inside is positive for either winding, and pull them
+	// in by half a pixel so they only pass for completely covered pixels
+	const float sign = ( area > 0.0f ) ? 1.0f : -1.0f;
+	for ( int i = 0; i < 3; i++ ) {
+		const int j = ( i + 1 ) % 3;
+		const float a = ( py[i] - py[j] ) * sign;
+		const float b = ( px[j] - px[i] ) * sign;
+		tri.edgeA[i] = a;
+		tri.edgeB[i] = b;
+		tri.edgeC[i] = - ( a * px[i] + b * py[i] ) - 0.5f * ( idMath::Fabs( a ) + idMath::Fabs( b ) );
+	}
+
+	// 1/w is linear in screen space, move it to the farthest value inside the pixel
+	const float invArea = 1.0f / area;
+	const float dzdx = ( ( pz[1] - pz[0] ) * ( py[2] - py[0] ) - ( pz[2] - pz[0] ) * ( py[1] - py[0] ) ) * invArea;
+	const float dzdy = ( ( pz[2] - pz[0] ) * ( px[1] - px[0] ) - ( pz[1] - pz[0] ) * ( px[2] - px[0] ) ) * invArea;
+	tri.depthA = dzdx;
+	tri.depthB = dzdy;
+	tri.depthC = pz[0] - dzdx * px[0] - dzdy * py[0] - 0.5f * ( idMath::Fabs( dzdx ) + idMath::Fabs( dzdy ) );
+
+	return true;
+}
+
+/*
+========================
+R_ClipOccluderTri
+
+Clips a clip space triangle stored as ( X, Y, W ) to the near plane and sets up the
+resulting triangles. Returns the number of triangles written to tris[], at most 2.
+========================
+*/
+static int R_ClipOccluderTri( occluderTri_t * tris, const idVec3 & v0, const idVec3 & v1, const idVec3 & v2, const float zNear ) {
+	const idVec3 * in[3] = { &v0, &v1, &v2 };
+
+	if ( v0.z >= zNear && v1.z >= zNear && v2.z >= zNear ) {
+		idVec3 clip[3] = { v0, v1, v2 };
+		return R_SetupOccluderTri( tris[0], clip ) ? 1 : 0;
+	}
+
+	idVec3 clipped[4];
+	int numClipped = 0;
+	for ( int i = 0; i < 3; i++ ) {
+		const idVec3 & a = *in[i];
+		const idVec3 & b = *in[( i + 1 ) % 3];
+		if ( a.z >= zNear ) {
+			clipped[numClipped++] = a;
+		}
+		if ( ( a.z >= zNear ) != ( b.z >= zNear ) ) {
+			const float f = ( a.z - zNear ) / ( a.z - b.z );
+			clipped[numClipped] = a + f * ( b - a );
+			clipped[numClipped].z = zNear;
+			numClipped++;
+		}
+	}
+
+	int numTris = 0;
+	for ( int i = 2; i < numClipped; i++ ) {
+		idVec3 clip[3] = { clipped[0], clipped[i - 1], clipped[i] };
+		if ( R_SetupOccluderTri( tris[numTris], clip ) ) {
+			numTris++;
+		}
+	}
+	return numTris;
+}
+
+/*
+================================================================================================
+
+	Rasterization
+
+================================================================================================
+*/
+
+/*
+========================
+R_RasterizeOccluderBand
+
+May be run in parallel, every job writes a separate range of rows.
+========================
+*/
+static void R_RasterizeOccluderBand( const occluderBandParms_t * parms ) {
+	const int width = idSoftwareOcclusion::BUFFER_WIDTH;
+
+	memset( parms->depthBuffer + parms->y1 * width, 0, ( parms->y2 - parms->y1 + 1 ) * width * sizeof( float ) );
+
+#ifdef ID_WIN_X86_SSE2_INTRIN
+
+	const __m128 vector_float_zero = { 0.0f, 0.0f, 0.0f, 0.0f };
+	const __m128 vector_float_four = { 4.0f, 4.0f, 4.0f, 4.0f };
+	const __m128 vector_float_pixel_centers = { 0.5f, 1.5f, 2.5f, 3.5f };
+
+	for ( int i = 0; i < parms->numTris; i++ ) {
+		const occluderTri_t & tri = parms->tris[i];
+
+		const int y1 = Max( (int)tri.y1, parms->y1 );
+		const int y2 = Min( (int)tri.y2, parms->y2 );
+		if ( y1 > y2 ) {
+			continue;
+		}
+
+		// the buffer width is a multiple of 4, so a group of 4 pixels never crosses a row
+		const int x1 = tri.x1 & ~3;
+		const int x2 = tri.x2;
+
+		const __m128 a0 = _mm_splat_ps( _mm_load_ss( &tri.edgeA[0] ), 0 );
+		const __m128 a1 = _mm_splat_ps( _mm_load_ss( &tri.edgeA[1] ), 0 );
+		const __m128 a2 = _mm_splat_ps( _mm_load_ss( &tri.edgeA[2] ), 0 );
+		const __m128 da = _mm_splat_ps( _mm_load_ss( &tri.depthA ), 0 );
+
+		const float startX = (float)x1;
+		const __m128 startCX = _mm_add_ps( _mm_splat_ps( _mm_load_ss( &startX ), 0 ), vector_float_pixel_centers );
+
+		for ( int y = y1; y <= y2; y++ ) {
+			const float cy = (float)y + 0.5f;
+			const float r0 = tri.edgeB[0] * cy + tri.edgeC[0];
+			const float r1 = tri.edgeB[1] * cy + tri.edgeC[1];
+			const float r2 = tri.edgeB[2] * cy + tri.edgeC[2];
+			const float rd = tri.depthB * cy + tri.depthC;
+
+			const __m128 row0 = _mm_splat_ps( _mm_load_ss( &r0 ), 0 );
+			const __m128 row1 = _mm_splat_ps( _mm_load_ss( &r1 ), 0 );
+			const __m128 row2 = _mm_splat_ps( _mm_load_ss( &r2 ), 0 );
+			const __m128 rowD = _mm_splat_ps( _mm_load_ss( &rd ), 0 );
+
+			float * row = parms->depthBuffer + y * width;
+			__m128 cx = startCX;
+
+			for ( int x = x1; x <= x2; x += 4 ) {
+				const __m128 e0 = _mm_madd_ps( cx, a0, row0 );
+				const __m128 e1 = _mm_madd_ps( cx, a1, row1 );
+				const __m128 e2 = _mm_madd_ps( cx, a2, row2 );
+
+				__m128 inside = _mm_cmpge_ps( e0, vector_float_zero );
+				inside = _mm_and_ps( inside, _mm_cmpge_ps( e1, vector_float_zero ) );
+				inside = _mm_and_ps( inside, _mm_cmpge_ps( e2, vector_float_zero ) );
+
+				if ( _mm_movemask_ps( inside ) != 0 ) {
+					const __m128 depth = _mm_madd_ps( cx, da, rowD );
+					const __m128 old = _mm_load_ps( row + x );
+					_mm_store_ps( row + x, _mm_max_ps( old, _mm_and_ps( inside, depth ) ) );
+				}
+
+				cx = _mm_add_ps( cx, vector_float_four );
+			}
+		}
+	}
+
+#else
+
+	for ( int i = 0; i < parms->numTris; i++ ) {
+		const occluderTri_t & tri = parms->tris[i];
+
+		const int y1 = Max( (int)tri.y1, parms->y1 );
+		const int y2 = Min( (int)tri.y2, parms->y2 );
+
+		for ( int y = y1; y <= y2; y++ ) {
+			const float cy = (float)y + 0.5f;
+			float * row = parms->depthBuffer + y * width;
+
+			for ( int x = tri.x1; x <= tri.x2; x++ ) {
+				const float cx = (float)x + 0.5f;
+				if ( tri.edgeA[0] * cx + tri.edgeB[0] * cy + tri.edgeC[0] < 0.0f ||
+						tri.edgeA[1] * cx + tri.edgeB[1] * cy + tri.edgeC[1] < 0.0f ||
+							tri.edgeA[2] * cx + tri.edgeB[2] * cy + tri.edgeC[2] < 0.0f ) {
+					continue;
+				}
+				row[x] = Max( row[x], tri.depthA * cx + tri.depthB * cy + tri.depthC );
+			}
+		}
+	}
+
+#endif
+}
+
+REGISTER_PARALLEL_JOB( R_RasterizeOccluderBand, "R_RasterizeOccluderBand" );
+
+/*
+========================
+idSoftwareOcclusion::RenderOccluders
+========================
+*/
+int idSoftwareOcclusion::RenderOccluders( const viewDef_t * viewDef, const idRenderWorldLocal * world, const int viewCount ) {
+	validViewCount = -1;
+
+	if ( surfaces.Num() == 0 ) {
+		return 0;
+	}
+
+	mvp = viewDef->worldSpace.mvp;
+	zNear = ( viewDef->renderView.cramZNear ) ? ( r_znear.GetFloat() * 0.25f ) : r_znear.GetFloat();
+
+	// find the occluder surfaces in the visible areas and inside the view frustum
+	int * visibleSurfaces = (int *)_alloca( surfaces.Num() * sizeof( int ) );
+	int numVisibleSurfaces = 0;
+	int numVisibleVerts = 0;
+	int numVisibleIndexes = 0;
+	for ( int i = 0; i < surfaces.Num(); i++ ) {
+		const occluderSurface_t & surf = surfaces[i];
+		if ( world->portalAreas[surf.areaNum].viewCount != viewCount ) {
+			continue;
+		}
+		if ( idRenderMatrix::CullBoundsToMVP( mvp, surf.bounds ) ) {
+			continue;
+		}
+		visibleSurfaces[numVisibleSurfaces++] = i;
+		numVisibleVerts += surf.numVerts;
+		numVisibleIndexes += surf.numIndexes;
+	}
+
+	// transform and set up the triangles, near clipping may split a triangle in two
+	float * clipX = (float *)R_FrameAlloc( numVisibleVerts * sizeof( float ) );
+	float * clipY = (float *)R_FrameAlloc( numVisibleVerts * sizeof( float ) );
+	float * clipW = (float *)R_FrameAlloc( numVisibleVerts * sizeof( float ) );
+	occluderTri_t * tris = (occluderTri_t *)R_FrameAlloc( ( numVisibleIndexes / 3 ) * 2 * sizeof( occluderTri_t ) );
+	int numTris = 0;
+
+	int vertBase = 0;
+	for ( int i = 0; i < numVisibleSurfaces; i++ ) {
+		const occluderSurface_t & surf = surfaces[visibleSurfaces[i]];
+
+		R_TransformOccluderVerts( clipX + vertBase, clipY + vertBase, clipW + vertBase,
+									vertsX.Ptr() + surf.firstVert, vertsY.Ptr() + surf.firstVert, vertsZ.Ptr() + surf.firstVert,
+									surf.numVerts, mvp );
+
+		const int indexBase = vertBase - surf.firstVert;
+		for ( int j = 0; j < surf.numIndexes; j += 3 ) {
+			const int i0 = indexBase + indexes[surf.firstIndex + j + 0];
+			const int i1 = indexBase + indexes[surf.firstIndex + j + 1];
+			const int i2 = indexBase + indexes[surf.firstIndex + j + 2];
+
+			const idVec3 v0( clipX[i0], clipY[i0], clipW[i0] );
+			const idVec3 v1( clipX[i1], clipY[i1], clipW[i1] );
+			const idVec3 v2( clipX[i2], clipY[i2], clipW[i2] );
+
+			if ( v0.z < zNear && v1.z < zNear && v2.z < zNear ) {
+				continue;
+			}
+
+			numTris += R_ClipOccluderTri( tris + numTris, v0, v1, v2, zNear );
+		}
+
+		vertBase += surf.numVerts;
+	}
+
+	// rasterize horizontal bands of the buffer in parallel
+	static const int ROWS_PER_BAND = BUFFER_HEIGHT / NUM_BANDS;
+	compile_time_assert( ROWS_PER_BAND * NUM_BANDS == BUFFER_HEIGHT );
+
+	occluderBandParms_t * bands = (occluderBandParms_t *)R_FrameAlloc( NUM_BANDS * sizeof( occluderBandParms_t ) );
+	for ( int i = 0; i < NUM_BANDS; i++ ) {
+		bands[i].tris = tris;
+		bands[i].numTris = numTris;
+		bands[i].depthBuffer = depthBuffer;
+		bands[i].y1 = i * ROWS_PER_BAND;
+		bands[i].y2 = ( i + 1 ) * ROWS_PER_BAND - 1;
+	}
+
+	if ( r_useParallelAddModels.GetBool() ) {
+		for ( int i = 0; i < NUM_BANDS; i++ ) {
+			tr->frontEndJobList->AddJob( (jobRun_t)R_RasterizeOccluderBand, &bands[i] );
+		}
+		tr->frontEndJobList->Submit();
+		tr->frontEndJobList->Wait();
+	} else {
+		for ( int i = 0; i < NUM_BANDS; i++ ) {
+			R_RasterizeOccluderBand( &bands[i] );
+		}
+	}
+
+	validViewCount = viewCount;
+
+	return numTris;
+}
+
+/*
+================================================================================================
+
+	Testing
+
+================================================================================================
+*/
+
+/*
+========================
+idSoftwareOcclusion::IsRectOccluded
+
+Returns true if every pixel in the inclusive rectangle has an occluder closer than depth.
+========================
+*/
+bool idSoftwareOcclusion::IsRectOccluded( const int x1, const int y1, const int x2, const int y2, const float depth ) const {
+	for ( int y = y1; y <= y2; y++ ) {
+		const float * row = depthBuffer + y * BUFFER_WIDTH;
+		int x = x1;
+
+#ifdef ID_WIN_X86_SSE2_INTRIN
+
+		for ( ; x <= x2 && ( x & 3 ) != 0; x++ ) {
+			if ( row[x] <= depth ) {
+				return false;
+			}
+		}
+
+		const __m128 vector_float_depth = _mm_splat_ps( _mm_load_ss( &depth ), 0 );
+		for ( ; x + 3 <= x2; x += 4 ) {
+			if ( _mm_movemask_ps( _mm_cmple_ps( _mm_load_ps( row + x ), vector_float_depth ) ) != 0 ) {
+				return false;
+			}
+		}
+
+#endif
+
+		for ( ; x <= x2; x++ ) {
+			if ( row[x] <= depth ) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/*
+========================
+idSoftwareOcclusion::CullBounds
+========================
+*/
+bool idSoftwareOcclusion::CullBounds( const idBounds & bounds ) const {
+	const float scaleX = 0.5f * BUFFER_WIDTH;
+	const float scaleY = 0.5f * BUFFER_HEIGHT;
+
+	float minX = idMath::INFINITY;
+	float minY = idMath::INFINITY;
+	float maxX = -idMath::INFINITY;
+	float maxY = -idMath::INFINITY;
+	float minW = idMath::INFINITY;
+
+	for ( int i = 0; i < 8; i++ ) {
+		const idVec3 p( bounds[( i >> 0 ) & 1][0], bounds[( i >> 1 ) & 1][1], bounds[( i >> 2 ) & 1][2] );
+
+		const float w = mvp[3][0] * p.x + mvp[3][1] * p.y + mvp[3][2] * p.z + mvp[3][3];
+		if ( w < zNear ) {
+			// crosses the near plane, so it can't be hidden
+			return false;
+		}
+
+		const float invW = 1.0f / w;
+		const float x = ( ( mvp[0][0] * p.x + mvp[0][1] * p.y + mvp[0][2] * p.z + mvp[0][3] ) * invW + 1.0f ) * scaleX;
+		const float y = ( ( mvp[1][0] * p.x + mvp[1][1] * p.y + mvp[1][2] * p.z + mvp[1][3] ) * invW + 1.0f ) * scaleY;
+
+		minX = Min( minX, x );
+		minY = Min( minY, y );
+		maxX = Max( maxX, x );
+		maxY = Max( maxY, y );
+		minW = Min( minW, w );
+	}
+
+	minX = Max( minX, 0.0f );
+	minY = Max( minY, 0.0f );
+	maxX = Min( maxX, (float)( BUFFER_WIDTH - 1 ) );
+	maxY = Min( maxY, (float)( BUFFER_HEIGHT - 1 ) );
+	if ( minX > maxX || minY > maxY ) {
+		// off screen, leave it to the frustum culling
+		return false;
+	}
+
+	return IsRectOccluded( idMath::Ftoi( minX ), idMath::Ftoi( minY ), idMath::Ftoi( maxX ), idMath::Ftoi( maxY ), 1.0f / minW );
+}
+
+/*
+================================================================================================
+
+	Front end
+
+================================================================================================
+*/
+
+/*
+========================
+R_OcclusionCullView
+
+Renders the occluders for the current view and removes the view lights that are completely
+hidden. View entities that are hidden are left on the list with an empty scissor rect so
+they can still cast shadows into the view.
+========================
+*/
+void R_OcclusionCullView() {
+	SCOPED_PROFILE_EVENT( "R_OcclusionCullView" );
+
+	viewDef_t * viewDef = tr->viewDef;
+	idSoftwareOcclusion & occlusion = viewDef->renderWorld->occlusion;
+
+	occlusion.Invalidate();
+
+	if ( !r_useSoftwareOcclusion.GetBool() ) {
+		return;
+	}
+	// mirrors and remote views are not worth the trouble
+	if ( viewDef->isSubview || viewDef->isXraySubview || viewDef->areaNum < 0 ) {
+		return;
+	}
+
+	const uint64 start = Sys_Microseconds();
+
+	tr->pc.c_occluderTris += occlusion.RenderOccluders( viewDef, viewDef->renderWorld, tr->viewCount );
+
+	if ( occlusion.IsValid( tr->viewCount ) ) {
+		viewLight_t ** ptr = &viewDef->viewLights;
+		while ( *ptr != NULL ) {
+			viewLight_t * vLight = *ptr;
+			// if the view is inside the light volume it crosses the near plane and won't be culled
+			if ( occlusion.CullBounds( vLight->lightDef->globalLightBounds ) ) {
+				vLight->lightDef->viewCount = -1;
+				*ptr = vLight->next;
+				tr->pc.c_occludedLights++;
+				continue;
+			}
+			ptr = &vLight->next;
+		}
+
+		for ( viewEntity_t * vEntity = viewDef->viewEntitys; vEntity != NULL; vEntity = vEntity->next ) {
+			if ( vEntity->scissorRect.IsEmpty() ) {
+				continue;
+			}
+			const idRenderEntityLocal * entityDef = vEntity->entityDef;
+			// depth hacked models are drawn in front of everything else
+			if ( entityDef->parms.weaponDepthHack || ( entityDef->parms.hModel != NULL && entityDef->parms.hModel->DepthHack() != 0.0f ) ) {
+				continue;
+			}
+			if ( occlusion.CullBounds( entityDef->globalReferenceBounds ) ) {
+				vEntity->scissorRect.Clear();
+				tr->pc.c_occludedEntities++;
+			}
+		}
+	}
+
+	tr->pc.occlusionMicroSec += (int)( Sys_Microseconds() - start );
+}
+
+/*
+========================
+R_OcclusionCullShadowBounds
+
+May be run in parallel.
+Returns true if the shadow bounds are completely hidden in the current view.
+========================
+*/
+bool R_OcclusionCullShadowBounds( const idBounds & shadowBounds ) {
+	const idSoftwareOcclusion & occlusion = tr->viewDef->renderWorld->occlusion;
+	if ( !occlusion.IsValid( tr->viewCount ) ) {
+		return false;
+	}
+	if ( !occlusion.CullBounds( shadowBounds ) ) {
+		return false;
+	}
+	tr->pc.c_occludedShadows++;
+	return true;
+}
@@ -0,0 +1,105 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company. 
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").  
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __SOFTWAREOCCLUSION_H__
+#define __SOFTWAREOCCLUSION_H__
+
+struct viewDef_t;
+class idRenderModel;
+class idRenderWorldLocal;
+
+/*
+================================================
+idSoftwareOcclusion
+
+Optional CPU occlusion culling for the renderer front end.
+
+At map load the large opaque surfaces of the area models are gathered as occluders.
+For every view, the occluders in the visible areas are rasterized into a low resolution
+buffer of 1/w values, after which entity, light and shadow bounds can be tested against
+it before any interaction or shadow volume work is done for them.
+
+The rasterization is conservative: occluders only write the pixels they completely
+cover, with the farthest depth inside the pixel, while tested bounds cover every pixel
+they touch with their nearest depth. A bounds is never reported as occluded while any
+part of it may be visible.
+================================================
+*/
+class idSoftwareOcclusion {
+public:
+	static const int	BUFFER_WIDTH = 256;		// must be a multiple of 4
+	static const int	BUFFER_HEIGHT = 128;
+	static const int	NUM_BANDS = 8;			// horizontal strips rasterized in parallel
+
+						idSoftwareOcclusion();
+						~idSoftwareOcclusion();
+
+	void				Clear();
+
+	// gathers the occluder triangles from the surfaces of a static world area model
+	void				AddAreaOccluders( const int areaNum, const idRenderModel * model );
+	int					GetNumOccluderTris() const { return indexes.Num() / 3; }
+
+	// rasterizes the occluders of all areas that are visible in the view,
+	// returns the number of occluder triangles that were rasterized
+	int					RenderOccluders( const viewDef_t * viewDef, const idRenderWorldLocal * world, const int viewCount );
+
+	// the buffer is only valid for the view it was rendered for
+	void				Invalidate() { validViewCount = -1; }
+	bool				IsValid( const int viewCount ) const { return validViewCount == viewCount; }
+
+	// returns true if the world space bounds is completely hidden behind the occluders
+	bool				CullBounds( const idBounds & bounds ) const;
+
+private:
+	struct occluderSurface_t {
+		idBounds		bounds;
+		int				areaNum;
+		int				firstVert;		// always a multiple of 4
+		int				numVerts;		// padded to a multiple of 4
+		int				firstIndex;
+		int				numIndexes;
+	};
+
+	idList< occluderSurface_t, TAG_RENDER >	surfaces;
+
+	// the occluder vertices are stored as a structure of arrays for SIMD transformation
+	idList< float, TAG_RENDER >				vertsX;
+	idList< float, TAG_RENDER >				vertsY;
+	idList< float, TAG_RENDER >				vertsZ;
+	idList< int, TAG_RENDER >				indexes;
+
+	float *				depthBuffer;			// [BUFFER_WIDTH * BUFFER_HEIGHT] 1/w, 0 = nothing rendered
+	idRenderMatrix		mvp;					// of the view the buffer was rendered for
+	float				zNear;
+	int					validViewCount;
+
+	bool				IsRectOccluded( const int x1, const int y1, const int x2, const int y2, const float depth ) const;
+};
+
+#endif // !__SOFTWAREOCCLUSION_H__
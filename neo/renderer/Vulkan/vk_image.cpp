@@ -147,6 +147,11 @@ void idImageVk::FinaliseImageUpload()
 		a = VK_COMPONENT_SWIZZLE_R;
 	} else if ( opts.format == FMT_INT8 ) {
 		r = g = b = a = VK_COMPONENT_SWIZZLE_R;
+	} else if ( opts.format == FMT_BC5 ) {
+		// the shaders read normal maps in the DXT5 layout, X in alpha and Y in green
+		r = b = VK_COMPONENT_SWIZZLE_ZERO;
+		g = VK_COMPONENT_SWIZZLE_G;
+		a = VK_COMPONENT_SWIZZLE_R;
 	} else {
 		r = VK_COMPONENT_SWIZZLE_R;
 		g = VK_COMPONENT_SWIZZLE_G;
@@ -561,6 +566,12 @@ bool idImageVk::AllocImageInternal(VkImage& newImage, VkImageView& newView)
 	case FMT_DXT5:
 		format = VK_FORMAT_BC3_UNORM_BLOCK;
 		break;
+	case FMT_BC5:
+		format = VK_FORMAT_BC5_UNORM_BLOCK;
+		break;
+	case FMT_BC7:
+		format = VK_FORMAT_BC7_UNORM_BLOCK;
+		break;
 	case FMT_DEPTH:
 		format = VK_FORMAT_D32_SFLOAT_S8_UINT;
 		break;
@@ -610,6 +621,11 @@ bool idImageVk::AllocImageInternal(VkImage& newImage, VkImageView& newView)
 		a = VK_COMPONENT_SWIZZLE_R;
 	} else if ( opts.format == FMT_INT8 ) {
 		r = g = b = a = VK_COMPONENT_SWIZZLE_R;
+	} else if ( opts.format == FMT_BC5 ) {
+		// the shaders read normal maps in the DXT5 layout, X in alpha and Y in green
+		r = b = VK_COMPONENT_SWIZZLE_ZERO;
+		g = VK_COMPONENT_SWIZZLE_G;
+		a = VK_COMPONENT_SWIZZLE_R;
 	} else {
 		r = VK_COMPONENT_SWIZZLE_R;
 		g = VK_COMPONENT_SWIZZLE_G;
@@ -22,6 +22,12 @@
 
 #undef RIGHT_SHIFT_IS_UNSIGNED
 
+/* SSE2 IDCT and color conversion, every Windows target has SSE2 intrinsics
+ * (see ID_WIN_X86_SSE2_INTRIN in sys_defines.h) */
+#if defined( _WIN32 ) && !defined( _MANAGED )
+#define SIMD_SSE2_SUPPORTED
+#endif
+
 #endif /* JPEG_INTERNALS */
 
 #ifdef JPEG_CJPEG_DJPEG
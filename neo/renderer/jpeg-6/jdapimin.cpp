@@ -195,6 +195,7 @@ default_decompress_parms( j_decompress_ptr cinfo ) {
     cinfo->dct_method = JDCT_DEFAULT;
     cinfo->do_fancy_upsampling = TRUE;
     cinfo->do_block_smoothing = TRUE;
+    cinfo->do_simd = TRUE;
     cinfo->quantize_colors = FALSE;
     /* We set these in case application only sets quantize_colors. */
     cinfo->dither_mode = JDITHER_FS;
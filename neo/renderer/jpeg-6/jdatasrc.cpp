@@ -197,3 +197,64 @@ jpeg_stdio_src( j_decompress_ptr cinfo, unsigned char * infile ) {
     src->pub.bytes_in_buffer = 0;/* forces fill_input_buffer on first read */
     src->pub.next_input_byte = NULL;/* until buffer loaded */
 }
+
+
+/*
+ * Memory source --- reads straight out of a file that is already in memory,
+ * without copying it through the input buffer and without needing padding
+ * past the end of the data.
+ */
+
+METHODDEF void
+init_mem_source( j_decompress_ptr cinfo ) {
+    /* no work necessary here */
+}
+
+METHODDEF boolean
+fill_mem_input_buffer( j_decompress_ptr cinfo ) {
+    static const JOCTET eoi_buffer[2] = { (JOCTET) 0xFF, (JOCTET) JPEG_EOI };
+
+    /* The whole file was handed over at once, so running out means it is truncated.
+     * Insert a fake EOI marker so that whatever is there can still be decoded.
+     */
+    WARNMS( cinfo, JWRN_JPEG_EOF );
+
+    cinfo->src->next_input_byte = eoi_buffer;
+    cinfo->src->bytes_in_buffer = 2;
+
+    return TRUE;
+}
+
+METHODDEF void
+skip_mem_input_data( j_decompress_ptr cinfo, long num_bytes ) {
+    struct jpeg_source_mgr * src = cinfo->src;
+
+    if ( num_bytes > 0 ) {
+        if ( num_bytes > (long) src->bytes_in_buffer ) {
+            (void) fill_mem_input_buffer( cinfo );
+        } else {
+            src->next_input_byte += (size_t) num_bytes;
+            src->bytes_in_buffer -= (size_t) num_bytes;
+        }
+    }
+}
+
+GLOBAL void
+jpeg_mem_src( j_decompress_ptr cinfo, const unsigned char * inbuffer, size_t insize ) {
+    struct jpeg_source_mgr * src;
+
+    if ( cinfo->src == NULL ) {/* first time for this JPEG object? */
+        cinfo->src = (struct jpeg_source_mgr *)
+                     ( * cinfo->mem->alloc_small )( (j_common_ptr) cinfo, JPOOL_PERMANENT,
+                                                   SIZEOF( struct jpeg_source_mgr ) );
+    }
+
+    src = cinfo->src;
+    src->init_source = init_mem_source;
+    src->fill_input_buffer = fill_mem_input_buffer;
+    src->skip_input_data = skip_mem_input_data;
+    src->resync_to_restart = jpeg_resync_to_restart;/* use default method */
+    src->term_source = term_source;
+    src->bytes_in_buffer = insize;
+    src->next_input_byte = (const JOCTET *) inbuffer;
+}
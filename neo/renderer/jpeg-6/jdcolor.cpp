@@ -155,6 +155,98 @@ ycc_rgb_convert( j_decompress_ptr cinfo,
 }
 
 
+#if defined( SIMD_SSE2_SUPPORTED ) && RGB_RED == 0 && RGB_GREEN == 1 && RGB_BLUE == 2 && RGB_PIXELSIZE == 4
+
+#include <emmintrin.h>
+
+#define YCC_RGB_SSE2_SUPPORTED
+
+#define CR_R_REM    ( (short) ( FIX( 1.40200 ) - ( 1L << SCALEBITS ) ) )
+#define CR_G_REM    ( (short) ( ( 1L << SCALEBITS ) - FIX( 0.71414 ) ) )
+#define CB_G_MUL    ( (short) -FIX( 0.34414 ) )
+#define CB_B_REM    ( (short) ( FIX( 1.77200 ) - 2 * ( 1L << SCALEBITS ) ) )
+
+/*
+ * SSE2 version of ycc_rgb_convert, eight pixels at a time.
+ * The table values are computed with 16 bit multiplies instead, which needs the
+ * constants that don't fit in 16 bits split into a multiple of 2^16 and a remainder.
+ * Since the multiple of 2^16 survives the descale exactly this gives the same
+ * results as the tables.  The unused fourth byte of each pixel is set to MAXJSAMPLE.
+ */
+
+METHODDEF void
+ycc_rgb_convert_sse2( j_decompress_ptr cinfo,
+                      JSAMPIMAGE input_buf, JDIMENSION input_row,
+                      JSAMPARRAY output_buf, int num_rows ) {
+    my_cconvert_ptr cconvert = (my_cconvert_ptr) cinfo->cconvert;
+    JSAMPROW outptr;
+    JSAMPROW inptr0, inptr1, inptr2;
+    JDIMENSION col;
+    JDIMENSION num_cols = cinfo->output_width;
+    JSAMPLE * range_limit = cinfo->sample_range_limit;
+    int * Crrtab = cconvert->Cr_r_tab;
+    int * Cbbtab = cconvert->Cb_b_tab;
+    INT32 * Crgtab = cconvert->Cr_g_tab;
+    INT32 * Cbgtab = cconvert->Cb_g_tab;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i center = _mm_set1_epi16( CENTERJSAMPLE );
+    const __m128i half = _mm_set1_epi32( ONE_HALF );
+    const __m128i alpha = _mm_set1_epi8( (char) MAXJSAMPLE );
+    /* (Cb, Cr) pair multipliers, R = Y + Cr + ..., G = Y - Cr + ..., B = Y + 2 * Cb + ... */
+    const __m128i r_mul = _mm_setr_epi16( 0, CR_R_REM, 0, CR_R_REM, 0, CR_R_REM, 0, CR_R_REM );
+    const __m128i g_mul = _mm_setr_epi16( CB_G_MUL, CR_G_REM, CB_G_MUL, CR_G_REM, CB_G_MUL, CR_G_REM, CB_G_MUL, CR_G_REM );
+    const __m128i b_mul = _mm_setr_epi16( CB_B_REM, 0, CB_B_REM, 0, CB_B_REM, 0, CB_B_REM, 0 );
+    SHIFT_TEMPS
+
+    while ( --num_rows >= 0 ) {
+        inptr0 = input_buf[0][input_row];
+        inptr1 = input_buf[1][input_row];
+        inptr2 = input_buf[2][input_row];
+        input_row++;
+        outptr = *output_buf++;
+        for ( col = 0; col + 8 <= num_cols; col += 8 ) {
+            __m128i y = _mm_unpacklo_epi8( _mm_loadl_epi64( (const __m128i *) ( inptr0 + col ) ), zero );
+            __m128i cb = _mm_sub_epi16( _mm_unpacklo_epi8( _mm_loadl_epi64( (const __m128i *) ( inptr1 + col ) ), zero ), center );
+            __m128i cr = _mm_sub_epi16( _mm_unpacklo_epi8( _mm_loadl_epi64( (const __m128i *) ( inptr2 + col ) ), zero ), center );
+            __m128i cbcr_lo = _mm_unpacklo_epi16( cb, cr );
+            __m128i cbcr_hi = _mm_unpackhi_epi16( cb, cr );
+            __m128i r, g, b, rg, ba;
+
+            r = _mm_packs_epi32( _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( cbcr_lo, r_mul ), half ), SCALEBITS ),
+                                 _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( cbcr_hi, r_mul ), half ), SCALEBITS ) );
+            g = _mm_packs_epi32( _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( cbcr_lo, g_mul ), half ), SCALEBITS ),
+                                 _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( cbcr_hi, g_mul ), half ), SCALEBITS ) );
+            b = _mm_packs_epi32( _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( cbcr_lo, b_mul ), half ), SCALEBITS ),
+                                 _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( cbcr_hi, b_mul ), half ), SCALEBITS ) );
+
+            /* Range-limiting is essential due to noise introduced by DCT losses. */
+            r = _mm_packus_epi16( _mm_add_epi16( _mm_add_epi16( y, cr ), r ), zero );
+            g = _mm_packus_epi16( _mm_add_epi16( _mm_sub_epi16( y, cr ), g ), zero );
+            b = _mm_packus_epi16( _mm_add_epi16( _mm_add_epi16( y, _mm_add_epi16( cb, cb ) ), b ), zero );
+
+            rg = _mm_unpacklo_epi8( r, g );
+            ba = _mm_unpacklo_epi8( b, alpha );
+            _mm_storeu_si128( (__m128i *) ( outptr ), _mm_unpacklo_epi16( rg, ba ) );
+            _mm_storeu_si128( (__m128i *) ( outptr + 16 ), _mm_unpackhi_epi16( rg, ba ) );
+            outptr += 8 * RGB_PIXELSIZE;
+        }
+        for ( ; col < num_cols; col++ ) {
+            int y  = GETJSAMPLE( inptr0[col] );
+            int cb = GETJSAMPLE( inptr1[col] );
+            int cr = GETJSAMPLE( inptr2[col] );
+            outptr[RGB_RED] =   range_limit[y + Crrtab[cr]];
+            outptr[RGB_GREEN] = range_limit[y +
+                                            ( (int) RIGHT_SHIFT( Cbgtab[cb] + Crgtab[cr],
+                                                                 SCALEBITS ) )];
+            outptr[RGB_BLUE] =  range_limit[y + Cbbtab[cb]];
+            outptr += RGB_PIXELSIZE;
+        }
+    }
+}
+
+#endif
+
+
 /**************** Cases other than YCbCr -> RGB **************/
 
 
@@ -331,6 +423,11 @@ jinit_color_deconverter( j_decompress_ptr cinfo ) {
             cinfo->out_color_components = RGB_PIXELSIZE;
             if ( cinfo->jpeg_color_space == JCS_YCbCr ) {
                 cconvert->pub.color_convert = ycc_rgb_convert;
+#ifdef YCC_RGB_SSE2_SUPPORTED
+                if ( cinfo->do_simd ) {
+                    cconvert->pub.color_convert = ycc_rgb_convert_sse2;
+                }
+#endif
                 build_ycc_rgb_table( cinfo );
             } else if ( cinfo->jpeg_color_space == JCS_RGB && RGB_PIXELSIZE == 3 ) {
                 cconvert->pub.color_convert = null_convert;
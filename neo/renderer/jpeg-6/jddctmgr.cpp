@@ -129,6 +129,11 @@ start_pass( j_decompress_ptr cinfo ) {
 #ifdef DCT_FLOAT_SUPPORTED
                     case JDCT_FLOAT:
                         method_ptr = jpeg_idct_float;
+#ifdef SIMD_SSE2_SUPPORTED
+                        if ( cinfo->do_simd ) {
+                            method_ptr = jpeg_idct_float_sse2;
+                        }
+#endif
                         method = JDCT_FLOAT;
                         break;
 #endif
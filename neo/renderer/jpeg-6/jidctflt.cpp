@@ -237,4 +237,132 @@ jpeg_idct_float( j_decompress_ptr cinfo, jpeg_component_info * compptr,
     }
 }
 
+#ifdef SIMD_SSE2_SUPPORTED
+
+#include <emmintrin.h>
+
+/*
+ * SSE2 version of jpeg_idct_float.  Each pass runs the same AA&N butterflies
+ * on four columns (pass 1) or four rows (pass 2) at a time, with the operations
+ * in the same order, so the outputs match the scalar version bit for bit.
+ * The final range limit is done with saturating packs instead of the
+ * mask-and-table lookup, which only differs for wildly corrupt input.
+ */
+
+#define IDCT_BUTTERFLY_SSE2( in0, in1, in2, in3, in4, in5, in6, in7, out ) { \
+        __m128 tmp0, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7; \
+        __m128 tmp10, tmp11, tmp12, tmp13; \
+        __m128 z5, z10, z11, z12, z13; \
+        tmp10 = _mm_add_ps( in0, in4 ); \
+        tmp11 = _mm_sub_ps( in0, in4 ); \
+        tmp13 = _mm_add_ps( in2, in6 ); \
+        tmp12 = _mm_sub_ps( _mm_mul_ps( _mm_sub_ps( in2, in6 ), c1_414 ), tmp13 ); \
+        tmp0 = _mm_add_ps( tmp10, tmp13 ); \
+        tmp3 = _mm_sub_ps( tmp10, tmp13 ); \
+        tmp1 = _mm_add_ps( tmp11, tmp12 ); \
+        tmp2 = _mm_sub_ps( tmp11, tmp12 ); \
+        z13 = _mm_add_ps( in5, in3 ); \
+        z10 = _mm_sub_ps( in5, in3 ); \
+        z11 = _mm_add_ps( in1, in7 ); \
+        z12 = _mm_sub_ps( in1, in7 ); \
+        tmp7 = _mm_add_ps( z11, z13 ); \
+        tmp11 = _mm_mul_ps( _mm_sub_ps( z11, z13 ), c1_414 ); \
+        z5 = _mm_mul_ps( _mm_add_ps( z10, z12 ), c1_847 ); \
+        tmp10 = _mm_sub_ps( _mm_mul_ps( c1_082, z12 ), z5 ); \
+        tmp12 = _mm_add_ps( _mm_mul_ps( cm2_613, z10 ), z5 ); \
+        tmp6 = _mm_sub_ps( tmp12, tmp7 ); \
+        tmp5 = _mm_sub_ps( tmp11, tmp6 ); \
+        tmp4 = _mm_add_ps( tmp10, tmp5 ); \
+        out[0] = _mm_add_ps( tmp0, tmp7 ); \
+        out[7] = _mm_sub_ps( tmp0, tmp7 ); \
+        out[1] = _mm_add_ps( tmp1, tmp6 ); \
+        out[6] = _mm_sub_ps( tmp1, tmp6 ); \
+        out[2] = _mm_add_ps( tmp2, tmp5 ); \
+        out[5] = _mm_sub_ps( tmp2, tmp5 ); \
+        out[4] = _mm_add_ps( tmp3, tmp4 ); \
+        out[3] = _mm_sub_ps( tmp3, tmp4 ); \
+}
+
+GLOBAL void
+jpeg_idct_float_sse2( j_decompress_ptr cinfo, jpeg_component_info * compptr,
+                      JCOEFPTR coef_block,
+                      JSAMPARRAY output_buf, JDIMENSION output_col ) {
+    const __m128 c1_414 = _mm_set1_ps( (FAST_FLOAT) 1.414213562 );
+    const __m128 c1_847 = _mm_set1_ps( (FAST_FLOAT) 1.847759065 );
+    const __m128 c1_082 = _mm_set1_ps( (FAST_FLOAT) 1.082392200 );
+    const __m128 cm2_613 = _mm_set1_ps( (FAST_FLOAT) -2.613125930 );
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi32( 1 << 2 );
+    const __m128i center = _mm_set1_epi32( CENTERJSAMPLE );
+    const FLOAT_MULT_TYPE * quantptr = (const FLOAT_MULT_TYPE *) compptr->dct_table;
+    __m128 in[DCTSIZE];
+    __m128 workspace[DCTSIZE][2];/* [row][column half] */
+    __m128 out[DCTSIZE];
+    __m128i ac;
+    int half, row;
+    SHIFT_TEMPS
+
+    /* Blocks with only a DC term are common in flat areas, every output is the same. */
+
+    ac = _mm_andnot_si128( _mm_cvtsi32_si128( 0xFFFF ), _mm_loadu_si128( (const __m128i *) coef_block ) );
+    for ( row = 1; row < DCTSIZE; row++ ) {
+        ac = _mm_or_si128( ac, _mm_loadu_si128( (const __m128i *) ( coef_block + row * DCTSIZE ) ) );
+    }
+    if ( _mm_movemask_epi8( _mm_cmpeq_epi8( ac, zero ) ) == 0xFFFF ) {
+        JSAMPLE * range_limit = IDCT_range_limit( cinfo );
+        FAST_FLOAT dcval = DEQUANTIZE( coef_block[0], quantptr[0] );
+        JSAMPLE dcsample = range_limit[(int) DESCALE( (INT32) dcval, 3 ) & RANGE_MASK];
+
+        for ( row = 0; row < DCTSIZE; row++ ) {
+            memset( output_buf[row] + output_col, dcsample, DCTSIZE );
+        }
+        return;
+    }
+
+    /* Pass 1: process four columns at a time, each vector holds one row of them. */
+
+    for ( half = 0; half < 2; half++ ) {
+        for ( row = 0; row < DCTSIZE; row++ ) {
+            __m128i coef = _mm_loadl_epi64( (const __m128i *) ( coef_block + row * DCTSIZE + half * 4 ) );
+            coef = _mm_srai_epi32( _mm_unpacklo_epi16( zero, coef ), 16 );
+            in[row] = _mm_mul_ps( _mm_cvtepi32_ps( coef ), _mm_loadu_ps( quantptr + row * DCTSIZE + half * 4 ) );
+        }
+        IDCT_BUTTERFLY_SSE2( in[0], in[1], in[2], in[3], in[4], in[5], in[6], in[7], out );
+        for ( row = 0; row < DCTSIZE; row++ ) {
+            workspace[row][half] = out[row];
+        }
+    }
+
+    /* Pass 2: process four rows at a time, transposed so each vector holds one column of them. */
+
+    for ( half = 0; half < 2; half++ ) {
+        int i;
+
+        for ( i = 0; i < DCTSIZE; i++ ) {
+            in[i] = workspace[half * 4 + ( i & 3 )][i >> 2];
+        }
+        _MM_TRANSPOSE4_PS( in[0], in[1], in[2], in[3] );
+        _MM_TRANSPOSE4_PS( in[4], in[5], in[6], in[7] );
+
+        IDCT_BUTTERFLY_SSE2( in[0], in[1], in[2], in[3], in[4], in[5], in[6], in[7], out );
+
+        /* Final output stage: scale down by a factor of 8 and range-limit */
+
+        for ( i = 0; i < DCTSIZE; i++ ) {
+            __m128i value = _mm_cvttps_epi32( out[i] );
+            value = _mm_srai_epi32( _mm_add_epi32( value, round ), 3 );
+            out[i] = _mm_castsi128_ps( _mm_add_epi32( value, center ) );
+        }
+        _MM_TRANSPOSE4_PS( out[0], out[1], out[2], out[3] );
+        _MM_TRANSPOSE4_PS( out[4], out[5], out[6], out[7] );
+
+        for ( i = 0; i < 4; i++ ) {
+            __m128i result = _mm_packs_epi32( _mm_castps_si128( out[i] ), _mm_castps_si128( out[i + 4] ) );
+            _mm_storel_epi64( (__m128i *) ( output_buf[half * 4 + i] + output_col ), _mm_packus_epi16( result, result ) );
+        }
+    }
+}
+
+#endif /* SIMD_SSE2_SUPPORTED */
+
 #endif /* DCT_FLOAT_SUPPORTED */
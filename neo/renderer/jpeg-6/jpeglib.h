@@ -434,6 +434,7 @@ struct jpeg_decompress_struct {
   J_DCT_METHOD dct_method;	/* IDCT algorithm selector */
   boolean do_fancy_upsampling;	/* TRUE=apply fancy upsampling */
   boolean do_block_smoothing;	/* TRUE=apply interblock smoothing */
+  boolean do_simd;		/* TRUE=use the SIMD IDCT and color conversion */
 
   boolean quantize_colors;	/* TRUE=colormapped output wanted */
   /* the following are ignored if not quantize_colors: */
@@ -820,6 +821,7 @@ typedef JMETHOD(boolean, jpeg_marker_parser_method, (j_decompress_ptr cinfo));
 #define jpeg_destroy_decompress	jDestDecompress
 #define jpeg_stdio_dest		jStdDest
 #define jpeg_stdio_src		jStdSrc
+#define jpeg_mem_src		jMemSrc
 #define jpeg_set_defaults	jSetDefaults
 #define jpeg_set_colorspace	jSetColorspace
 #define jpeg_default_colorspace	jDefColorspace
@@ -875,6 +877,9 @@ EXTERN void jpeg_destroy_decompress JPP((j_decompress_ptr cinfo));
 /* Caller is responsible for opening the file before and closing after. */
 EXTERN void jpeg_stdio_dest JPP((j_compress_ptr cinfo, FILE * outfile));
 EXTERN void jpeg_stdio_src JPP((j_decompress_ptr cinfo, unsigned char *infile));
+/* Decompression straight from a file already in memory, no padding needed. */
+EXTERN void jpeg_mem_src JPP((j_decompress_ptr cinfo, const unsigned char *inbuffer,
+			      size_t insize));
 
 /* Default parameter setup for compression */
 EXTERN void jpeg_set_defaults JPP((j_compress_ptr cinfo));
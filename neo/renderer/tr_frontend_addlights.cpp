@@ -357,6 +357,11 @@ static void R_AddSingleLight( viewLight_t * vLight ) {
 				continue;
 			}
 
+			// or if the whole shadow is hidden behind the world
+			if ( R_OcclusionCullShadowBounds( shadowBounds ) ) {
+				continue;
+			}
+
 			// debug tool to allow viewing of only one entity at a time
 			if ( r_singleEntity.GetInteger() >= 0 && r_singleEntity.GetInteger() != edef->index ) {
 				continue;
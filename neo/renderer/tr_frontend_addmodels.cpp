@@ -35,6 +35,8 @@ If you have questions concerning this license or the applicable additional terms
 idCVar r_skipStaticShadows( "r_skipStaticShadows", "0", CVAR_RENDERER | CVAR_BOOL, "skip static shadows" );
 idCVar r_skipDynamicShadows( "r_skipDynamicShadows", "0", CVAR_RENDERER | CVAR_BOOL, "skip dynamic shadows" );
 idCVar r_useParallelAddModels( "r_useParallelAddModels", "1", CVAR_RENDERER | CVAR_BOOL, "add all models in parallel with jobs" );
+idCVar r_useDynamicModelPrePass( "r_useDynamicModelPrePass", "1", CVAR_RENDERER | CVAR_BOOL, "instantiate the dynamic models of all visible entities in a separate pass before adding the models" );
+idCVar r_useCachedTraceModels( "r_useCachedTraceModels", "1", CVAR_RENDERER | CVAR_BOOL, "trace against the last dynamic model snapshot instead of instantiating a new one" );
 idCVar r_useParallelAddShadows( "r_useParallelAddShadows", "1", CVAR_RENDERER | CVAR_INTEGER, "0 = off, 1 = threaded", 0, 1 );
 idCVar r_useShadowPreciseInsideTest( "r_useShadowPreciseInsideTest", "1", CVAR_RENDERER | CVAR_BOOL, "use a precise and more expensive test to determine whether the view is inside a shadow volume" );
 idCVar r_cullDynamicShadowTriangles( "r_cullDynamicShadowTriangles", "1", CVAR_RENDERER | CVAR_BOOL, "cull occluder triangles that are outside the light frustum so they do not contribute to the dynamic shadow volume" );
@@ -156,7 +158,8 @@ bool R_IssueEntityDefCallback( idRenderEntityLocal *def ) {
 ===================
 R_EntityDefDynamicModel
 
-This is also called by the game code for idRenderWorldLocal::ModelTrace(), and idRenderWorldLocal::Trace() which is bad for performance...
+This is also called by the game code for idRenderWorldLocal::ModelTrace(), and idRenderWorldLocal::Trace() which is bad for performance,
+so those use R_EntityDefTraceModel() instead.
 
 Issues a deferred entity callback if necessary.
 If the model isn't dynamic, it returns the original.
@@ -233,6 +236,30 @@ idRenderModel *R_EntityDefDynamicModel( idRenderEntityLocal *def ) {
 	return def->dynamicModel;
 }
 
+/*
+===================
+R_EntityDefTraceModel
+
+Used by idRenderWorldLocal::ModelTrace() and idRenderWorldLocal::Trace().
+If a snapshot of the dynamic model exists it is used as is, even when it was
+created for an earlier frame, so game code traces don't issue entity callbacks
+or instantiate dynamic models outside of the front end.
+===================
+*/
+idRenderModel *R_EntityDefTraceModel( idRenderEntityLocal *def ) {
+	if ( def->dynamicModelFrameCount == tr->frameCount ) {
+		return def->dynamicModel;
+	}
+
+	if ( r_useCachedTraceModels.GetBool() && def->cachedDynamicModel != NULL ) {
+		if ( def->parms.hModel != NULL && def->parms.hModel->IsDynamicModel() != DM_STATIC ) {
+			return def->cachedDynamicModel;
+		}
+	}
+
+	return R_EntityDefDynamicModel( def );
+}
+
 /*
 ===================
 R_SetupDrawSurfShader
@@ -304,6 +331,94 @@ void R_SetupDrawSurfJoints( drawSurf_t * drawSurf, const srfTriangles_t * tri, c
 	drawSurf->jointCache = model->jointsInvertedBuffer;
 }
 
+/*
+===================
+R_InstantiateSingleDynamicModel
+
+May be run in parallel.
+
+Creates the dynamic model snapshot of an entity that is directly visible, so
+the R_AddSingleModel for it can immediately use it.
+===================
+*/
+static void R_InstantiateSingleDynamicModel( viewEntity_t * vEntity ) {
+	idRenderEntityLocal * entityDef = vEntity->entityDef;
+
+	SCOPED_PROFILE_EVENT( entityDef->parms.hModel->Name() );
+
+	R_EntityDefDynamicModel( entityDef );
+}
+
+REGISTER_PARALLEL_JOB( R_InstantiateSingleDynamicModel, "R_InstantiateSingleDynamicModel" );
+
+/*
+===================
+R_InstantiateDynamicModels
+
+The view entities with dynamic models are sorted to the front of the list.
+Entities that are only added for shadows are left alone, because
+R_AddSingleModel may find they don't need to be instantiated at all.
+===================
+*/
+static void R_InstantiateDynamicModels() {
+	SCOPED_PROFILE_EVENT( "R_InstantiateDynamicModels" );
+
+	const viewDef_t * viewDef = tr->viewDef;
+
+	int numJobs = 0;
+	for ( viewEntity_t * vEntity = viewDef->viewEntitys; vEntity != NULL; vEntity = vEntity->next ) {
+		const idRenderEntityLocal * entityDef = vEntity->entityDef;
+		if ( entityDef->parms.hModel->IsDynamicModel() == DM_STATIC ) {
+			break;
+		}
+		if ( vEntity->scissorRect.IsEmpty() ) {
+			continue;
+		}
+		if ( viewDef->isXraySubview && entityDef->parms.xrayIndex == 1 ) {
+			continue;
+		} else if ( !viewDef->isXraySubview && entityDef->parms.xrayIndex == 2 ) {
+			continue;
+		}
+
+		if ( r_useParallelAddModels.GetBool() ) {
+			tr->frontEndJobList->AddJob( (jobRun_t)R_InstantiateSingleDynamicModel, vEntity );
+			numJobs++;
+		} else {
+			R_InstantiateSingleDynamicModel( vEntity );
+		}
+	}
+
+	if ( numJobs > 0 ) {
+		tr->frontEndJobList->Submit();
+		tr->frontEndJobList->Wait();
+	}
+}
+
+/*
+===================
+R_ReportStreamedImageSizes
+
+Tells texture streaming how many texels across the images of the material cover on screen.
+May be run in parallel.
+===================
+*/
+static void R_ReportStreamedImageSizes( const viewEntity_t * vEntity, srfTriangles_t * tri, const idMaterial * shader ) {
+	idBounds projected;
+	idRenderMatrix::ProjectedBounds( projected, vEntity->mvp, tri->bounds );
+
+	const idScreenRect & viewport = tr->viewDef->viewport;
+	const float pixels = Max( ( projected[1][0] - projected[0][0] ) * viewport.GetWidth(), ( projected[1][1] - projected[0][1] ) * viewport.GetHeight() );
+	// every repeat of the texture covers only a part of the surface on screen
+	const float texels = pixels / R_TriSurfTexCoordSpan( tri );
+
+	for ( int i = 0; i < shader->GetNumStages(); i++ ) {
+		idImage * image = shader->GetStage( i )->texture.image;
+		if ( image != NULL && image->IsStreamed() ) {
+			image->ReportStreamedSize( texels );
+		}
+	}
+}
+
 /*
 ===================
 R_AddSingleModel
@@ -416,6 +531,11 @@ void R_AddSingleModel( viewEntity_t * vEntity ) {
 				if ( idRenderMatrix::CullBoundsToMVP( viewDef->worldSpace.mvp, shadowBounds ) ) {
 					continue;
 				}
+
+				// or if the whole shadow is hidden behind the world
+				if ( R_OcclusionCullShadowBounds( shadowBounds ) ) {
+					continue;
+				}
 			}
 			contactedLights[numContactedLights] = vLight;
 			staticInteractions[numContactedLights] = world->interactionTable[vLight->lightDef->index * world->interactionTableWidth + entityIndex];
@@ -608,6 +728,10 @@ void R_AddSingleModel( viewEntity_t * vEntity ) {
 
 			R_SetupDrawSurfShader( baseDrawSurf, shader, renderEntity );
 
+			if ( globalImages->StreamingImages() ) {
+				R_ReportStreamedImageSizes( vEntity, tri, shader );
+			}
+
 			// Check for deformations (eyeballs, flares, etc)
 			const deform_t shaderDeform = shader->Deform();
 			if ( shaderDeform != DFRM_NONE ) {
@@ -1005,6 +1129,15 @@ void R_AddModels() {
 
 	tr->viewDef->viewEntitys = R_SortViewEntities( tr->viewDef->viewEntitys );
 
+	//-------------------------------------------------
+	// Instantiate the visible dynamic models up front, so a single
+	// expensive model doesn't serialize the end of the add model jobs.
+	//-------------------------------------------------
+
+	if ( r_useDynamicModelPrePass.GetBool() ) {
+		R_InstantiateDynamicModels();
+	}
+
 	//-------------------------------------------------
 	// Go through each view entity that is either visible to the view, or to
 	// any light that intersects the view (for shadows).
@@ -387,6 +387,9 @@ void R_RenderView( viewDef_t *parms ) {
 	// wait for any shadow volume jobs from the previous frame to finish
 	tr->frontEndJobList->Wait();
 
+	// remove lights and entities that are completely hidden behind the world geometry
+	R_OcclusionCullView();
+
 	// make sure that interactions exist for all light / entity combinations that are visible
 	// add any pre-generated light shadows, and calculate the light shader values
 	R_AddLights();
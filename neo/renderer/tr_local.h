@@ -590,6 +590,11 @@ struct performanceCounters_t {
 	int		c_entityReferences;
 	int		c_lightReferences;
 	int		c_guiSurfs;
+	int		c_occluderTris;		// R_OcclusionCullView()
+	int		c_occludedEntities;
+	int		c_occludedLights;
+	int		c_occludedShadows;
+	int		occlusionMicroSec;
 	int		frontEndMicroSec;	// sum of time in all RE_RenderScene's in a frame
 };
 
@@ -832,6 +837,7 @@ public:
 	drawSurf_t				testImageSurface_;
 
 	idParallelJobList *		frontEndJobList;
+	idParallelJobList *		modelJobList;		// for cleaning up the surfaces of models that are loaded without a binary cache
 
 	unsigned				timerQueryId;		// for GL_TIME_ELAPSED_EXT queries
 };
@@ -948,6 +954,7 @@ extern idCVar r_showCull;					// report sphere and box culling stats
 extern idCVar r_showAddModel;				// report stats from tr_addModel
 extern idCVar r_showSurfaces;				// report surface/light/shadow counts
 extern idCVar r_showPrimitives;				// report vertex/index/draw counts
+extern idCVar r_showOcclusion;				// report software occlusion culling stats
 extern idCVar r_showPortals;				// draw portal outlines in color based on passed / not passed
 extern idCVar r_showSkel;					// draw the skeleton when model animates
 extern idCVar r_showOverDraw;				// show overdraw
@@ -1161,6 +1168,7 @@ TR_FRONTEND_ADDMODELS
 
 bool R_IssueEntityDefCallback( idRenderEntityLocal *def );
 idRenderModel *R_EntityDefDynamicModel( idRenderEntityLocal *def );
+idRenderModel *R_EntityDefTraceModel( idRenderEntityLocal *def );
 void R_ClearEntityDefDynamicModel( idRenderEntityLocal *def );
 
 void R_SetupDrawSurfShader( drawSurf_t * drawSurf, const idMaterial * shader, const renderEntity_t * renderEntity );
@@ -1169,6 +1177,17 @@ void R_LinkDrawSurfToView( drawSurf_t * drawSurf, viewDef_t * viewDef );
 
 void R_AddModels();
 
+/*
+============================================================
+
+TR_FRONTEND_OCCLUSION
+
+============================================================
+*/
+
+void R_OcclusionCullView();
+bool R_OcclusionCullShadowBounds( const idBounds & shadowBounds );
+
 /*
 =============================================================
 
@@ -1233,6 +1252,7 @@ void				R_FreeStaticTriSurfVertexCaches( srfTriangles_t *tri );
 int					R_TriSurfMemory( const srfTriangles_t *tri );
 
 void				R_BoundTriSurf( srfTriangles_t *tri );
+float				R_TriSurfTexCoordSpan( srfTriangles_t *tri );
 void				R_RemoveDuplicatedTriangles( srfTriangles_t *tri );
 void				R_CreateSilIndexes( srfTriangles_t *tri );
 void				R_RemoveDegenerateTriangles( srfTriangles_t *tri );
@@ -1240,6 +1260,18 @@ void				R_RemoveUnusedVerts( srfTriangles_t *tri );
 void				R_RangeCheckIndexes( const srfTriangles_t *tri );
 void				R_CreateVertexNormals( srfTriangles_t *tri );		// also called by dmap
 void				R_CleanupTriangles( srfTriangles_t *tri, bool createNormals, bool identifySilEdges, bool useUnsmoothedTangents );
+
+// the surfaces of a model don't share any data, so they can be cleaned up in parallel
+static const int	MAX_CLEANUP_TRIANGLES_JOBS = 1024;
+
+struct cleanupTrianglesParms_t {
+	srfTriangles_t *	tri;
+	bool				createNormals;
+	bool				identifySilEdges;
+	bool				useUnsmoothedTangents;
+};
+
+void				R_CleanupTriangleSurfaces( const cleanupTrianglesParms_t * parms, const int numSurfaces );
 void				R_ReverseTriangles( srfTriangles_t *tri );
 
 // Only deals with vertexes and indexes, not silhouettes, planes, etc.
@@ -31,6 +31,8 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "tr_local.h"
 
+idCVar r_useParallelCleanupTriangles( "r_useParallelCleanupTriangles", "1", CVAR_RENDERER | CVAR_BOOL, "cleanup the surfaces of models that are loaded without a binary cache on the job threads" );
+
 /*
 ==============================================================================
 
@@ -466,6 +468,41 @@ R_BoundTriSurf
 */
 void R_BoundTriSurf( srfTriangles_t *tri ) {
 	SIMDProcessor->MinMax( tri->bounds[0], tri->bounds[1], tri->verts, tri->numVerts );
+	tri->texCoordSpan = 0.0f;
+}
+
+/*
+=================
+R_TriSurfTexCoordSpan
+
+Returns how many times the texture repeats along the longest texture axis of the surface, texture
+streaming divides the screen size of the surface by it. Computed on first use and cached.
+=================
+*/
+float R_TriSurfTexCoordSpan( srfTriangles_t *tri ) {
+	if ( tri->texCoordSpan > 0.0f ) {
+		return tri->texCoordSpan;
+	}
+	if ( tri->verts == NULL || tri->numVerts == 0 ) {
+		tri->texCoordSpan = 1.0f;
+		return tri->texCoordSpan;
+	}
+
+	idVec2 mins = tri->verts[0].GetTexCoord();
+	idVec2 maxs = mins;
+	for ( int i = 1; i < tri->numVerts; i++ ) {
+		const idVec2 st = tri->verts[i].GetTexCoord();
+		mins.x = Min( mins.x, st.x );
+		mins.y = Min( mins.y, st.y );
+		maxs.x = Max( maxs.x, st.x );
+		maxs.y = Max( maxs.y, st.y );
+	}
+
+	// a tiled floor covers only a fraction of its screen size with each repeat, so it asks for
+	// a less detailed level, and an atlas piece asks for a more detailed one. The lower limit
+	// keeps surfaces with degenerate texcoords from asking for everything.
+	tri->texCoordSpan = idMath::ClampFloat( 1.0f / 256.0f, 256.0f, Max( maxs.x - mins.x, maxs.y - mins.y ) );
+	return tri->texCoordSpan;
 }
 
 /*
@@ -488,7 +525,7 @@ static int *R_CreateSilRemap( const srfTriangles_t *tri ) {
 		return remap;
 	}
 
-	idHashIndex		hash( 1024, tri->numVerts );
+	idHashIndex		hash( Max( 1024, Min( 1 << 16, idMath::CeilPowerOfTwo( tri->numVerts ) ) ), tri->numVerts );
 
 	c_removed = 0;
 	c_unique = 0;
@@ -586,11 +623,10 @@ void R_CreateDupVerts( srfTriangles_t *tri ) {
 R_DefineEdge
 ===============
 */
-static int c_duplicatedEdges, c_tripledEdges;
 static const int MAX_SIL_EDGES			= 0x7ffff;
 
 static void R_DefineEdge( const int v1, const int v2, const int planeNum, const int numPlanes,
-	idList<silEdge_t> & silEdges, idHashIndex	& silEdgeHash ) {
+	idList<silEdge_t> & silEdges, idHashIndex	& silEdgeHash, int & c_duplicatedEdges, int & c_tripledEdges ) {
 	int		i, hashKey;
 
 	// check for degenerate edge
@@ -633,23 +669,44 @@ static void R_DefineEdge( const int v1, const int v2, const int planeNum, const
 
 /*
 =================
-SilEdgeSort
+R_SortSilEdges
+
+Sorts the sil edges on p1 and then p2 with two stable counting sort passes,
+which is linear in the number of edges instead of the qsort n log n.
+The plane numbers range from 0 to numPlanes inclusive.
 =================
 */
-static int SilEdgeSort( const void *a, const void *b ) {
-	if ( ((silEdge_t *)a)->p1 < ((silEdge_t *)b)->p1 ) {
-		return -1;
+static void R_SortSilEdges( silEdge_t * silEdges, const int numSilEdges, const int numPlanes ) {
+	if ( numSilEdges <= 1 ) {
+		return;
 	}
-	if ( ((silEdge_t *)a)->p1 > ((silEdge_t *)b)->p1 ) {
-		return 1;
+
+	idTempArray< silEdge_t > sorted( numSilEdges );
+	idTempArray< int > offsets( numPlanes + 2 );
+
+	// sort on the least significant key first
+	offsets.Zero();
+	for ( int i = 0; i < numSilEdges; i++ ) {
+		offsets[silEdges[i].p2 + 1]++;
+	}
+	for ( int i = 1; i < numPlanes + 2; i++ ) {
+		offsets[i] += offsets[i - 1];
 	}
-	if ( ((silEdge_t *)a)->p2 < ((silEdge_t *)b)->p2 ) {
-		return -1;
+	for ( int i = 0; i < numSilEdges; i++ ) {
+		sorted[offsets[silEdges[i].p2]++] = silEdges[i];
+	}
+
+	// the second pass keeps the p2 order for edges with the same p1
+	offsets.Zero();
+	for ( int i = 0; i < numSilEdges; i++ ) {
+		offsets[sorted[i].p1 + 1]++;
 	}
-	if ( ((silEdge_t *)a)->p2 > ((silEdge_t *)b)->p2 ) {
-		return 1;
+	for ( int i = 1; i < numPlanes + 2; i++ ) {
+		offsets[i] += offsets[i - 1];
+	}
+	for ( int i = 0; i < numSilEdges; i++ ) {
+		silEdges[offsets[sorted[i].p1]++] = sorted[i];
 	}
-	return 0;
 }
 
 /*
@@ -660,8 +717,8 @@ If the surface will not deform, coplanar edges (polygon interiors)
 can never create silhouette plains, and can be omited
 =================
 */
-int	c_coplanarSilEdges;
-int	c_totalSilEdges;
+idSysInterlockedInteger	c_coplanarSilEdges;
+idSysInterlockedInteger	c_totalSilEdges;
 
 void R_IdentifySilEdges( srfTriangles_t *tri, bool omitCoplanarEdges ) {
 	int		i;
@@ -669,19 +726,22 @@ void R_IdentifySilEdges( srfTriangles_t *tri, bool omitCoplanarEdges ) {
 
 	omitCoplanarEdges = false;	// optimization doesn't work for some reason
 
-	static const int SILEDGE_HASH_SIZE		= 1024;
+	static const int MIN_SILEDGE_HASH_SIZE	= 1024;
+	static const int MAX_SILEDGE_HASH_SIZE	= 1 << 16;
 
 	const int numTris = tri->numIndexes / 3;
 
-	idList<silEdge_t>	silEdges( MAX_SIL_EDGES );
-	idHashIndex	silEdgeHash( SILEDGE_HASH_SIZE, MAX_SIL_EDGES );
-	int			numPlanes = numTris;
-
+	// size the hash to the surface so large models don't end up with long hash chains
+	const int silEdgeHashSize = Max( MIN_SILEDGE_HASH_SIZE, Min( MAX_SILEDGE_HASH_SIZE, idMath::CeilPowerOfTwo( numTris * 3 ) ) );
 
-	silEdgeHash.Clear();
+	idList<silEdge_t>	silEdges;
+	silEdges.Resize( Max( numTris * 3, 1 ) );
+	idHashIndex	silEdgeHash( silEdgeHashSize, Max( numTris * 3, 1 ) );
+	int			numPlanes = numTris;
 
-	c_duplicatedEdges = 0;
-	c_tripledEdges = 0;
+	// these are local so surfaces can be processed in parallel
+	int			c_duplicatedEdges = 0;
+	int			c_tripledEdges = 0;
 
 	for ( i = 0; i < numTris; i++ ) {
 		int		i1, i2, i3;
@@ -691,9 +751,9 @@ void R_IdentifySilEdges( srfTriangles_t *tri, bool omitCoplanarEdges ) {
 		i3 = tri->silIndexes[ i*3 + 2 ];
 
 		// create the edges
-		R_DefineEdge( i1, i2, i, numPlanes, silEdges, silEdgeHash );
-		R_DefineEdge( i2, i3, i, numPlanes, silEdges, silEdgeHash );
-		R_DefineEdge( i3, i1, i, numPlanes, silEdges, silEdgeHash );
+		R_DefineEdge( i1, i2, i, numPlanes, silEdges, silEdgeHash, c_duplicatedEdges, c_tripledEdges );
+		R_DefineEdge( i2, i3, i, numPlanes, silEdges, silEdgeHash, c_duplicatedEdges, c_tripledEdges );
+		R_DefineEdge( i3, i1, i, numPlanes, silEdges, silEdgeHash, c_duplicatedEdges, c_tripledEdges );
 	}
 
 	if ( c_duplicatedEdges || c_tripledEdges ) {
@@ -748,15 +808,15 @@ void R_IdentifySilEdges( srfTriangles_t *tri, bool omitCoplanarEdges ) {
 			}
 		}
 		if ( c_coplanarCulled ) {
-			c_coplanarSilEdges += c_coplanarCulled;
+			c_coplanarSilEdges.Add( c_coplanarCulled );
 //			common->Printf( "%i of %i sil edges coplanar culled\n", c_coplanarCulled,
 //				c_coplanarCulled + numSilEdges );
 		}
 	}
-	c_totalSilEdges += silEdges.Num();
+	c_totalSilEdges.Add( silEdges.Num() );
 
 	// sort the sil edges based on plane number
-	qsort( silEdges.Ptr(), silEdges.Num(), sizeof( silEdges[0] ), SilEdgeSort );
+	R_SortSilEdges( silEdges.Ptr(), silEdges.Num(), numPlanes );
 
 	// count up the distribution.
 	// a perfectly built model should only have shared
@@ -914,7 +974,118 @@ void R_DeriveNormalsAndTangents( srfTriangles_t *tri ) {
 	vertexTangents.Zero();
 	vertexBitangents.Zero();
 
-	for ( int i = 0; i < tri->numIndexes; i += 3 ) {
+	int firstScalarIndex = 0;
+
+#ifdef ID_WIN_X86_SSE2_INTRIN
+
+	const __m128 vector_float_one				= { 1.0f, 1.0f, 1.0f, 1.0f };
+	const __m128 vector_float_smallest			= _mm_splat_ps( _mm_load_ss( &idMath::FLT_SMALLEST_NON_DENORMAL ), 0 );
+	const __m128 vector_float_infinity			= _mm_splat_ps( _mm_load_ss( &idMath::INFINITY ), 0 );
+	const __m128 vector_float_sign_bit			= __m128c( _mm_set_epi32( 0x80000000, 0x80000000, 0x80000000, 0x80000000 ) );
+
+	// derive the face vectors for four triangles at a time, the same
+	// way as the scalar code below, and then add them to the vertices
+	const int numSIMDIndexes = ( tri->numIndexes / 12 ) * 12;
+	for ( int i = 0; i < numSIMDIndexes; i += 12 ) {
+		ALIGN16( float d0[5][4] );
+		ALIGN16( float d1[5][4] );
+
+		for ( int j = 0; j < 4; j++ ) {
+			const idDrawVert * a = tri->verts + tri->indexes[i + j * 3 + 0];
+			const idDrawVert * b = tri->verts + tri->indexes[i + j * 3 + 1];
+			const idDrawVert * c = tri->verts + tri->indexes[i + j * 3 + 2];
+
+			const idVec2 aST = a->GetTexCoord();
+			const idVec2 bST = b->GetTexCoord();
+			const idVec2 cST = c->GetTexCoord();
+
+			d0[0][j] = b->xyz[0] - a->xyz[0];
+			d0[1][j] = b->xyz[1] - a->xyz[1];
+			d0[2][j] = b->xyz[2] - a->xyz[2];
+			d0[3][j] = bST[0] - aST[0];
+			d0[4][j] = bST[1] - aST[1];
+
+			d1[0][j] = c->xyz[0] - a->xyz[0];
+			d1[1][j] = c->xyz[1] - a->xyz[1];
+			d1[2][j] = c->xyz[2] - a->xyz[2];
+			d1[3][j] = cST[0] - aST[0];
+			d1[4][j] = cST[1] - aST[1];
+		}
+
+		const __m128 d00 = _mm_load_ps( d0[0] );
+		const __m128 d01 = _mm_load_ps( d0[1] );
+		const __m128 d02 = _mm_load_ps( d0[2] );
+		const __m128 d03 = _mm_load_ps( d0[3] );
+		const __m128 d04 = _mm_load_ps( d0[4] );
+
+		const __m128 d10 = _mm_load_ps( d1[0] );
+		const __m128 d11 = _mm_load_ps( d1[1] );
+		const __m128 d12 = _mm_load_ps( d1[2] );
+		const __m128 d13 = _mm_load_ps( d1[3] );
+		const __m128 d14 = _mm_load_ps( d1[4] );
+
+		__m128 n0 = _mm_sub_ps( _mm_mul_ps( d11, d02 ), _mm_mul_ps( d12, d01 ) );
+		__m128 n1 = _mm_sub_ps( _mm_mul_ps( d12, d00 ), _mm_mul_ps( d10, d02 ) );
+		__m128 n2 = _mm_sub_ps( _mm_mul_ps( d10, d01 ), _mm_mul_ps( d11, d00 ) );
+
+		__m128 t0 = _mm_sub_ps( _mm_mul_ps( d00, d14 ), _mm_mul_ps( d04, d10 ) );
+		__m128 t1 = _mm_sub_ps( _mm_mul_ps( d01, d14 ), _mm_mul_ps( d04, d11 ) );
+		__m128 t2 = _mm_sub_ps( _mm_mul_ps( d02, d14 ), _mm_mul_ps( d04, d12 ) );
+
+		__m128 b0 = _mm_sub_ps( _mm_mul_ps( d03, d10 ), _mm_mul_ps( d00, d13 ) );
+		__m128 b1 = _mm_sub_ps( _mm_mul_ps( d03, d11 ), _mm_mul_ps( d01, d13 ) );
+		__m128 b2 = _mm_sub_ps( _mm_mul_ps( d03, d12 ), _mm_mul_ps( d02, d13 ) );
+
+		// area sign bit
+		const __m128 area = _mm_sub_ps( _mm_mul_ps( d03, d14 ), _mm_mul_ps( d04, d13 ) );
+		const __m128 signBit = _mm_and_ps( area, vector_float_sign_bit );
+
+		// same as idMath::InvSqrt
+		const __m128 nl = _mm_madd_ps( n0, n0, _mm_madd_ps( n1, n1, _mm_mul_ps( n2, n2 ) ) );
+		const __m128 tl = _mm_madd_ps( t0, t0, _mm_madd_ps( t1, t1, _mm_mul_ps( t2, t2 ) ) );
+		const __m128 bl = _mm_madd_ps( b0, b0, _mm_madd_ps( b1, b1, _mm_mul_ps( b2, b2 ) ) );
+
+		const __m128 f0 = _mm_sel_ps( vector_float_infinity, _mm_sqrt_ps( _mm_div_ps( vector_float_one, nl ) ), _mm_cmpgt_ps( nl, vector_float_smallest ) );
+		__m128 f1 = _mm_sel_ps( vector_float_infinity, _mm_sqrt_ps( _mm_div_ps( vector_float_one, tl ) ), _mm_cmpgt_ps( tl, vector_float_smallest ) );
+		__m128 f2 = _mm_sel_ps( vector_float_infinity, _mm_sqrt_ps( _mm_div_ps( vector_float_one, bl ) ), _mm_cmpgt_ps( bl, vector_float_smallest ) );
+		f1 = _mm_xor_ps( f1, signBit );
+		f2 = _mm_xor_ps( f2, signBit );
+
+		ALIGN16( float normal[3][4] );
+		ALIGN16( float tangent[3][4] );
+		ALIGN16( float bitangent[3][4] );
+
+		_mm_store_ps( normal[0], _mm_mul_ps( n0, f0 ) );
+		_mm_store_ps( normal[1], _mm_mul_ps( n1, f0 ) );
+		_mm_store_ps( normal[2], _mm_mul_ps( n2, f0 ) );
+
+		_mm_store_ps( tangent[0], _mm_mul_ps( t0, f1 ) );
+		_mm_store_ps( tangent[1], _mm_mul_ps( t1, f1 ) );
+		_mm_store_ps( tangent[2], _mm_mul_ps( t2, f1 ) );
+
+		_mm_store_ps( bitangent[0], _mm_mul_ps( b0, f2 ) );
+		_mm_store_ps( bitangent[1], _mm_mul_ps( b1, f2 ) );
+		_mm_store_ps( bitangent[2], _mm_mul_ps( b2, f2 ) );
+
+		for ( int j = 0; j < 4; j++ ) {
+			const idVec3 n( normal[0][j], normal[1][j], normal[2][j] );
+			const idVec3 t( tangent[0][j], tangent[1][j], tangent[2][j] );
+			const idVec3 b( bitangent[0][j], bitangent[1][j], bitangent[2][j] );
+
+			for ( int k = 0; k < 3; k++ ) {
+				const int v = tri->indexes[i + j * 3 + k];
+				vertexNormals[v] += n;
+				vertexTangents[v] += t;
+				vertexBitangents[v] += b;
+			}
+		}
+	}
+
+	firstScalarIndex = numSIMDIndexes;
+
+#endif
+
+	for ( int i = firstScalarIndex; i < tri->numIndexes; i += 3 ) {
 		const int v0 = tri->indexes[i + 0];
 		const int v1 = tri->indexes[i + 1];
 		const int v2 = tri->indexes[i + 2];
@@ -1310,16 +1481,6 @@ typedef struct {
 	int		faceNum;
 } indexSort_t;
 
-static int IndexSort( const void *a, const void *b ) {
-	if ( ((indexSort_t *)a)->vertexNum < ((indexSort_t *)b)->vertexNum ) {
-		return -1;
-	}
-	if ( ((indexSort_t *)a)->vertexNum > ((indexSort_t *)b)->vertexNum ) {
-		return 1;
-	}
-	return 0;
-}
-
 void R_BuildDominantTris( srfTriangles_t *tri ) {
 	int i, j;
 	dominantTri_t *dt;
@@ -1330,11 +1491,20 @@ void R_BuildDominantTris( srfTriangles_t *tri ) {
 		return;
 	}
 
-	for ( i = 0; i < tri->numIndexes; i++ ) {
-		ind[i].vertexNum = tri->indexes[i];
-		ind[i].faceNum = i / 3;
+	// bucket the indexes by vertex number with a counting sort
+	idTempArray< int > offsets( tri->numVerts + 1 );
+	offsets.Zero();
+	for ( i = 0; i < numIndexes; i++ ) {
+		offsets[tri->indexes[i] + 1]++;
+	}
+	for ( i = 1; i <= tri->numVerts; i++ ) {
+		offsets[i] += offsets[i - 1];
+	}
+	for ( i = 0; i < numIndexes; i++ ) {
+		const int sortIndex = offsets[tri->indexes[i]]++;
+		ind[sortIndex].vertexNum = tri->indexes[i];
+		ind[sortIndex].faceNum = i / 3;
 	}
-	qsort( ind, tri->numIndexes, sizeof( *ind ), IndexSort );
 
 	R_AllocStaticTriSurfDominantTris( tri, tri->numVerts );
 	dt = tri->dominantTris;
@@ -1513,20 +1683,29 @@ void R_RemoveDegenerateTriangles( srfTriangles_t *tri ) {
 
 	assert( tri->silIndexes != NULL );
 
-	// check for completely degenerate triangles
+	// check for completely degenerate triangles, compacting the remaining
+	// triangles in a single pass instead of a memmove for every removal
 	c_removed = 0;
+	int numIndexes = 0;
 	for ( i = 0; i < tri->numIndexes; i += 3 ) {
 		a = tri->silIndexes[i];
 		b = tri->silIndexes[i+1];
 		c = tri->silIndexes[i+2];
 		if ( a == b || a == c || b == c ) {
 			c_removed++;
-			memmove( tri->indexes + i, tri->indexes + i + 3, ( tri->numIndexes - i - 3 ) * sizeof( tri->indexes[0] ) );
-			memmove( tri->silIndexes + i, tri->silIndexes + i + 3, ( tri->numIndexes - i - 3 ) * sizeof( tri->silIndexes[0] ) );
-			tri->numIndexes -= 3;
-			i -= 3;
+			continue;
+		}
+		if ( numIndexes != i ) {
+			tri->indexes[numIndexes + 0] = tri->indexes[i + 0];
+			tri->indexes[numIndexes + 1] = tri->indexes[i + 1];
+			tri->indexes[numIndexes + 2] = tri->indexes[i + 2];
+			tri->silIndexes[numIndexes + 0] = a;
+			tri->silIndexes[numIndexes + 1] = b;
+			tri->silIndexes[numIndexes + 2] = c;
 		}
+		numIndexes += 3;
 	}
+	tri->numIndexes = numIndexes;
 
 	// this doesn't free the memory used by the unused verts
 
@@ -1754,6 +1933,43 @@ void R_CleanupTriangles( srfTriangles_t *tri, bool createNormals, bool identifyS
 	}
 }
 
+/*
+=================
+R_CleanupTrianglesJob
+
+May be run in parallel with other surfaces.
+=================
+*/
+static void R_CleanupTrianglesJob( const cleanupTrianglesParms_t * parms ) {
+	R_CleanupTriangles( parms->tri, parms->createNormals, parms->identifySilEdges, parms->useUnsmoothedTangents );
+}
+
+REGISTER_PARALLEL_JOB( R_CleanupTrianglesJob, "R_CleanupTrianglesJob" );
+
+/*
+=================
+R_CleanupTriangleSurfaces
+
+Cleans up a list of independent surfaces, on the job threads if possible.
+=================
+*/
+void R_CleanupTriangleSurfaces( const cleanupTrianglesParms_t * parms, const int numSurfaces ) {
+	if ( numSurfaces > 1 && r_useParallelCleanupTriangles.GetBool() && tr->modelJobList != NULL ) {
+		for ( int i = 0; i < numSurfaces; i += MAX_CLEANUP_TRIANGLES_JOBS ) {
+			const int numJobs = Min( numSurfaces - i, MAX_CLEANUP_TRIANGLES_JOBS );
+			for ( int j = 0; j < numJobs; j++ ) {
+				tr->modelJobList->AddJob( (jobRun_t)R_CleanupTrianglesJob, (void *)&parms[i + j] );
+			}
+			tr->modelJobList->Submit( NULL, JOBLIST_PARALLELISM_MAX_CORES );
+			tr->modelJobList->Wait();
+		}
+	} else {
+		for ( int i = 0; i < numSurfaces; i++ ) {
+			R_CleanupTrianglesJob( &parms[i] );
+		}
+	}
+}
+
 /*
 ===================================================================================
 
@@ -185,6 +185,24 @@ private:
 
 	const idMaterial *		atlasMaterial;
 
+	// per-frame submission counts, reset at the start of every Render
+	swfRenderStats_t		renderStats;
+
+	// scratch space for merging consecutive shape fills into a single AllocTris
+	struct swfFillBatch_t {
+		const idSWFShapeDrawFill *	fill;
+		const idMaterial *	material;
+		uint32				packedColorM;
+		uint32				packedColorA;
+		swfMatrix_t			invMatrix;
+		idVec2				atlasScale;
+		idVec2				atlasBias;
+		idVec2				oneOverSize;
+		bool				useAtlas;
+	};
+	idList< swfFillBatch_t, TAG_SWF >	fillBatch;
+	idList< triIndex_t, TAG_SWF >		fillBatchIndexes;
+
 	idBlockAlloc< idSWFSpriteInstance, 16 >	spriteInstanceAllocator;
 	idBlockAlloc< idSWFTextInstance, 16 >	textInstanceAllocator;
 
@@ -331,6 +349,10 @@ private:
 	void			DrawLine( idRenderSystem * gui, const idVec2 & p1, const idVec2 & p2, float width, const swfMatrix_t & matrix );
 	void			RenderEditText( idRenderSystem * gui, idSWFTextInstance * textInstance, const swfRenderState_t & renderState, int time, bool isSplitscreen = false );
 	uint64			GLStateForRenderState( const swfRenderState_t & renderState );
+	void			SetGLState( idRenderSystem * gui, const uint64 glState );
+	idDrawVert *	AllocTris( idRenderSystem * gui, int numVerts, const triIndex_t * indexes, int numIndexes, const idMaterial * material, const stereoDepthType_t stereoDepth );
+	void			CountSubmit( const idMaterial * material, const stereoDepthType_t stereoDepth, int numIndexes );
+	void			SubmitFillBatch( idRenderSystem * gui, const idSWFShape * shape, const swfRenderState_t & renderState, int first, int last );
 	void			FindTooltipIcons( idStr * text );
 
 	//----------------------------------
@@ -36,6 +36,9 @@ idCVar swf_titleSafe( "swf_titleSafe", "0.005", CVAR_FLOAT, "space between UI el
 
 idCVar swf_forceAlpha( "swf_forceAlpha", "0", CVAR_FLOAT, "force an alpha value on all elements, useful to show invisible animating elements", 0.0f, 1.0f );
 
+idCVar swf_batchFills( "swf_batchFills", "1", CVAR_BOOL, "merge consecutive shape fills that share a material into a single gui draw" );
+idCVar swf_showRenderStats( "swf_showRenderStats", "0", CVAR_BOOL, "print per-frame fill, submit and draw counts and render time for each swf" );
+
 extern idCVar swf_textStrokeSize;
 extern idCVar swf_textStrokeSizeGlyphSpacer;
 extern idCVar in_useJoystick;
@@ -51,6 +54,7 @@ idSWF::DrawStretchPic
 ========================
 */
 void idSWF::DrawStretchPic( float x, float y, float w, float h, float s1, float t1, float s2, float t2, const idMaterial *material ) {
+	CountSubmit( material, STEREO_DEPTH_TYPE_NONE, 6 );
 	renderSystem->DrawStretchPic( x * scaleToVirtual.x, y * scaleToVirtual.y, w * scaleToVirtual.x, h * scaleToVirtual.y, s1, t1, s2, t2, material );
 }
 
@@ -60,6 +64,7 @@ idSWF::DrawStretchPic
 ========================
 */
 void idSWF::DrawStretchPic( const idVec4 & topLeft, const idVec4 & topRight, const idVec4 & bottomRight, const idVec4 & bottomLeft, const idMaterial * material ) {
+	CountSubmit( material, STEREO_DEPTH_TYPE_NONE, 6 );
 	renderSystem->DrawStretchPic(
 		idVec4( topLeft.x * scaleToVirtual.x, topLeft.y * scaleToVirtual.y, topLeft.z, topLeft.w ),
 		idVec4( topRight.x * scaleToVirtual.x, topRight.y * scaleToVirtual.y, topRight.z, topRight.w ),
@@ -68,6 +73,51 @@ void idSWF::DrawStretchPic( const idVec4 & topLeft, const idVec4 & topRight, con
 		material );
 }
 
+/*
+========================
+idSWF::SetGLState
+========================
+*/
+void idSWF::SetGLState( idRenderSystem * gui, const uint64 glState ) {
+	renderStats.glState = glState;
+	gui->SetGLState( glState );
+}
+
+/*
+========================
+idSWF::CountSubmit
+
+Mirrors the surface break test in idGuiModel::AllocTris, so draws is the number
+of gui surfaces this swf produced.
+========================
+*/
+void idSWF::CountSubmit( const idMaterial * material, const stereoDepthType_t stereoDepth, int numIndexes ) {
+	if ( material == NULL ) {
+		return;
+	}
+	if ( renderStats.submits == 0 || material != renderStats.material || renderStats.glState != renderStats.lastGLState || stereoDepth != renderStats.stereoDepth ) {
+		renderStats.draws++;
+	}
+	renderStats.submits++;
+	renderStats.tris += numIndexes / 3;
+	renderStats.material = material;
+	renderStats.lastGLState = renderStats.glState;
+	renderStats.stereoDepth = stereoDepth;
+}
+
+/*
+========================
+idSWF::AllocTris
+========================
+*/
+idDrawVert * idSWF::AllocTris( idRenderSystem * gui, int numVerts, const triIndex_t * indexes, int numIndexes, const idMaterial * material, const stereoDepthType_t stereoDepth ) {
+	idDrawVert * verts = gui->AllocTris( numVerts, indexes, numIndexes, material, stereoDepth );
+	if ( verts != NULL ) {
+		CountSubmit( material, stereoDepth, numIndexes );
+	}
+	return verts;
+}
+
 /*
 ========================
 idSWF::Render
@@ -80,6 +130,10 @@ void idSWF::Render( idRenderSystem * gui, int time, bool isSplitscreen ) {
 	if ( !IsActive() ) {
 		return;
 	}
+
+	const uint64 renderStartTime = Sys_Microseconds();
+	renderStats.Clear();
+
 	if ( swf_stopat.GetInteger() > 0 ) {
 		if ( mainspriteInstance->currentFrame == swf_stopat.GetInteger() ) {
 			swf_timescale.SetFloat( 0.0f );
@@ -146,7 +200,7 @@ void idSWF::Render( idRenderSystem * gui, int time, bool isSplitscreen ) {
 	}
 
 	if ( isMouseInClientArea && ( mouseEnabled && useMouse ) && ( InhibitControl() || ( !InhibitControl() && !useInhibtControl ) ) ) {
-		gui->SetGLState( GLS_SRCBLEND_SRC_ALPHA | GLS_DSTBLEND_ONE_MINUS_SRC_ALPHA );
+		SetGLState( gui, GLS_SRCBLEND_SRC_ALPHA | GLS_DSTBLEND_ONE_MINUS_SRC_ALPHA );
 		gui->SetColor( idVec4( 1.0f, 1.0f, 1.0f, 1.0f ) );
 		idVec2 mouse = renderState.matrix.Transform( idVec2( mouseX - 1, mouseY - 2 ) );
 		//idSWFScriptObject * hitObject = HitTest( mainspriteInstance, swfRenderState_t(), mouseX, mouseY, NULL );
@@ -158,7 +212,13 @@ void idSWF::Render( idRenderSystem * gui, int time, bool isSplitscreen ) {
 	}
 
 	// restore the GL State
-	gui->SetGLState( 0 );
+	SetGLState( gui, 0 );
+
+	renderStats.microseconds = Sys_Microseconds() - renderStartTime;
+	if ( swf_showRenderStats.GetBool() ) {
+		idLib::Printf( "%s: %i fills, %i submits, %i draws, %i tris, %i usec\n", filename.c_str(),
+			renderStats.fills, renderStats.submits, renderStats.draws, renderStats.tris, (int)renderStats.microseconds );
+	}
 }
 
 /*
@@ -429,6 +489,8 @@ void idSWF::RenderMorphShape( idRenderSystem * gui, const idSWFShape * shape, co
 		return;
 	}
 
+	SetGLState( gui, GLStateForRenderState( renderState ) );
+
 	for ( int i = 0; i < shape->fillDraws.Num(); i++ ) {
 		const idSWFShapeDrawFill & fill = shape->fillDraws[i];
 		const idMaterial * material = NULL;
@@ -479,9 +541,9 @@ void idSWF::RenderMorphShape( idRenderSystem * gui, const idSWFShape * shape, co
 
 		swfMatrix_t invMatrix = styleMatrix.Inverse();
 
-		gui->SetGLState( GLStateForRenderState( renderState ) );
+		renderStats.fills++;
 
-		idDrawVert * verts = gui->AllocTris( fill.startVerts.Num(), fill.indices.Ptr(), fill.indices.Num(), material, renderState.stereoDepth );	
+		idDrawVert * verts = AllocTris( gui, fill.startVerts.Num(), fill.indices.Ptr(), fill.indices.Num(), material, renderState.stereoDepth );
 		if ( verts == NULL ) {
 			continue;
 		}
@@ -508,6 +570,104 @@ void idSWF::RenderMorphShape( idRenderSystem * gui, const idSWFShape * shape, co
 	}
 }
 
+/*
+========================
+idSWF::SubmitFillBatch
+
+Writes fillBatch[first..last] with a single AllocTris.  The fills all share a material
+and the gui state, so the gui model would have put them in one surface anyway, but
+merging them here saves the per-call overhead and the state tests for every fill.
+The gui model rejects a whole call that doesn't fit, so if the merged fills don't
+fit they are submitted one at a time to keep as many of them as there is room for.
+========================
+*/
+void idSWF::SubmitFillBatch( idRenderSystem * gui, const idSWFShape * shape, const swfRenderState_t & renderState, int first, int last ) {
+	const swfFillBatch_t & head = fillBatch[first];
+
+	int numVerts = 0;
+	int numIndexes = 0;
+	for ( int i = first; i <= last; i++ ) {
+		numVerts += fillBatch[i].fill->startVerts.Num();
+		numIndexes += fillBatch[i].fill->indices.Num();
+	}
+
+	const triIndex_t * indexes = head.fill->indices.Ptr();
+	if ( first != last ) {
+		// rebase the indexes of each fill past the verts of the fills before it
+		fillBatchIndexes.SetNum( numIndexes );
+		triIndex_t * outIndexes = fillBatchIndexes.Ptr();
+		int baseVert = 0;
+		for ( int i = first; i <= last; i++ ) {
+			const idSWFShapeDrawFill & fill = *fillBatch[i].fill;
+			for ( int j = 0; j < fill.indices.Num(); j++ ) {
+				*outIndexes++ = (triIndex_t)( baseVert + fill.indices[j] );
+			}
+			baseVert += fill.startVerts.Num();
+		}
+		indexes = fillBatchIndexes.Ptr();
+	}
+
+	idDrawVert * verts = AllocTris( gui, numVerts, indexes, numIndexes, head.material, renderState.stereoDepth );
+	if ( verts == NULL ) {
+		if ( first != last ) {
+			for ( int i = first; i <= last; i++ ) {
+				SubmitFillBatch( gui, shape, renderState, i, i );
+			}
+		}
+		return;
+	}
+
+	const swfRect_t & bounds = shape->startBounds;
+
+	for ( int i = first; i <= last; i++ ) {
+		const swfFillBatch_t & batch = fillBatch[i];
+		const idSWFShapeDrawFill & fill = *batch.fill;
+
+		ALIGNTYPE16 idDrawVert tempVerts[4];
+		for ( int j = 0; j < fill.startVerts.Num(); j++ ) {
+			const idVec2 & xy = fill.startVerts[j];
+
+			idDrawVert & vert = tempVerts[j & 3];
+
+			vert.Clear();
+			vert.xyz.ToVec2() = renderState.matrix.Transform( xy ).Scale( scaleToVirtual );
+			vert.xyz.z = 0.0f;
+			vert.SetNativeOrderColor( batch.packedColorM );
+			vert.SetNativeOrderColor2( batch.packedColorA );
+
+			// For some reason I don't understand, having texcoords
+			// in the range of 2000 or so causes what should be solid
+			// fill areas to have horizontal bands on nvidia, but not 360.
+			// Forcing the texcoords to zero fixes it.
+			if ( fill.style.type != 0 ) {
+				idVec2 st;
+				// all the swf vertexes have an implicit scale of 1/20 for some reason...
+				st.x = ( ( xy.x - bounds.tl.x ) * batch.oneOverSize.x ) * 20.0f;
+				st.y = ( ( xy.y - bounds.tl.y ) * batch.oneOverSize.y ) * 20.0f;
+				st = batch.invMatrix.Transform( st );
+				if ( batch.useAtlas ) {
+					st = st.Scale( batch.atlasScale ) + batch.atlasBias;
+				}
+
+				// inset the tc - the gui may use a vmtr and the tc might end up
+				// crossing page boundaries if using [0.0,1.0]
+				st.x = idMath::ClampFloat( 0.001f, 0.999f, st.x );
+				st.y = idMath::ClampFloat( 0.001f, 0.999f, st.y );
+				vert.SetTexCoord( st );
+			}
+
+			// write four verts at a time to video memory
+			if ( ( j & 3 ) == 3 ) {
+				WriteDrawVerts16( & verts[j & ~3], tempVerts, 4 );
+			}
+		}
+		// write any remaining verts to video memory
+		WriteDrawVerts16( & verts[fill.startVerts.Num() & ~3], tempVerts, fill.startVerts.Num() & 3 );
+
+		verts += fill.startVerts.Num();
+	}
+}
+
 /*
 ========================
 idSWF::RenderShape
@@ -519,6 +679,11 @@ void idSWF::RenderShape( idRenderSystem * gui, const idSWFShape * shape, const s
 		return;
 	}
 
+	// every fill in the shape is drawn with the same blend and stencil state
+	SetGLState( gui, GLStateForRenderState( renderState ) );
+
+	fillBatch.SetNum( 0 );
+
 	for ( int i = 0; i < shape->fillDraws.Num(); i++ ) {
 		const idSWFShapeDrawFill & fill = shape->fillDraws[i];
 		const idMaterial * material = NULL;
@@ -564,66 +729,53 @@ void idSWF::RenderShape( idRenderSystem * gui, const idSWFShape * shape, const s
 		if ( ( color.mul.w + color.add.w ) <= ALPHA_EPSILON ) {
 			continue;
 		}
+		if ( material == NULL || fill.indices.Num() == 0 ) {
+			continue;
+		}
 
-		uint32 packedColorM = LittleLong( PackColor( color.mul ) );
-		uint32 packedColorA = LittleLong( PackColor( ( color.add * 0.5f ) + idVec4( 0.5f ) ) ); // Compress from -1..1 to 0..1
-
-		const swfRect_t & bounds = shape->startBounds;
 		if ( renderState.materialWidth > 0 ) {
 			size.x = renderState.materialWidth;
 		}
 		if ( renderState.materialHeight > 0 ) {
 			size.y = renderState.materialHeight;
 		}
-		idVec2 oneOverSize( 1.0f / size.x, 1.0f / size.y );
-
-		gui->SetGLState( GLStateForRenderState( renderState ) );
-
-		idDrawVert * verts = gui->AllocTris( fill.startVerts.Num(), fill.indices.Ptr(), fill.indices.Num(), material, renderState.stereoDepth );	
-		if ( verts == NULL ) {
-			continue;
-		}
 
-		ALIGNTYPE16 idDrawVert tempVerts[4];
-		for ( int j = 0; j < fill.startVerts.Num(); j++ ) {
-			const idVec2 & xy = fill.startVerts[j];
-
-			idDrawVert & vert = tempVerts[j & 3];
-
-			vert.Clear();
-			vert.xyz.ToVec2() = renderState.matrix.Transform( xy ).Scale( scaleToVirtual );
-			vert.xyz.z = 0.0f;
-			vert.SetNativeOrderColor( packedColorM );
-			vert.SetNativeOrderColor2( packedColorA );
+		swfFillBatch_t & batch = fillBatch.Alloc();
+		batch.fill = &fill;
+		batch.material = material;
+		batch.packedColorM = LittleLong( PackColor( color.mul ) );
+		batch.packedColorA = LittleLong( PackColor( ( color.add * 0.5f ) + idVec4( 0.5f ) ) ); // Compress from -1..1 to 0..1
+		batch.invMatrix = invMatrix;
+		batch.atlasScale = atlasScale;
+		batch.atlasBias = atlasBias;
+		batch.oneOverSize.Set( 1.0f / size.x, 1.0f / size.y );
+		batch.useAtlas = useAtlas;
+
+		renderStats.fills++;
+	}
 
-			// For some reason I don't understand, having texcoords
-			// in the range of 2000 or so causes what should be solid
-			// fill areas to have horizontal bands on nvidia, but not 360.
-			// Forcing the texcoords to zero fixes it.
-			if ( fill.style.type != 0 ) {
-				idVec2 st;
-				// all the swf vertexes have an implicit scale of 1/20 for some reason...
-				st.x = ( ( xy.x - bounds.tl.x ) * oneOverSize.x ) * 20.0f;
-				st.y = ( ( xy.y - bounds.tl.y ) * oneOverSize.y ) * 20.0f;
-				st = invMatrix.Transform( st );
-				if ( useAtlas ) {
-					st = st.Scale( atlasScale ) + atlasBias;
+	// merge runs of consecutive fills that share a material, keeping the rebased
+	// indexes of a run within 16 bits
+	const int maxBatchVerts = 0xFFFF;
+	const bool batchFills = swf_batchFills.GetBool();
+	for ( int first = 0; first < fillBatch.Num(); ) {
+		int last = first;
+		if ( batchFills ) {
+			int numVerts = fillBatch[first].fill->startVerts.Num();
+			while ( last + 1 < fillBatch.Num() && fillBatch[last + 1].material == fillBatch[first].material ) {
+				numVerts += fillBatch[last + 1].fill->startVerts.Num();
+				if ( numVerts > maxBatchVerts ) {
+					break;
 				}
-
-				// inset the tc - the gui may use a vmtr and the tc might end up
-				// crossing page boundaries if using [0.0,1.0]
-				st.x = idMath::ClampFloat( 0.001f, 0.999f, st.x );
-				st.y = idMath::ClampFloat( 0.001f, 0.999f, st.y );
-				vert.SetTexCoord( st );
-			}
-
-			// write four verts at a time to video memory
-			if ( ( j & 3 ) == 3 ) {
-				WriteDrawVerts16( & verts[j & ~3], tempVerts, 4 );
+				last++;
 			}
 		}
-		// write any remaining verts to video memory
-		WriteDrawVerts16( & verts[fill.startVerts.Num() & ~3], tempVerts, fill.startVerts.Num() & 3 );
+		SubmitFillBatch( gui, shape, renderState, first, last );
+		first = last + 1;
+	}
+
+	if ( shape->lineDraws.Num() > 0 ) {
+		SetGLState( gui, GLStateForRenderState( renderState ) | GLS_POLYMODE_LINE );
 	}
 
 	for ( int i = 0; i < shape->lineDraws.Num(); i++ ) {
@@ -641,9 +793,9 @@ void idSWF::RenderShape( idRenderSystem * gui, const idSWFShape * shape, const s
 		uint32 packedColorM = LittleLong( PackColor( color.mul ) );
 		uint32 packedColorA = LittleLong( PackColor( ( color.add * 0.5f ) + idVec4( 0.5f ) ) ); // Compress from -1..1 to 0..1
 
-		gui->SetGLState( GLStateForRenderState( renderState ) | GLS_POLYMODE_LINE );
+		renderStats.fills++;
 
-		idDrawVert * verts = gui->AllocTris( line.startVerts.Num(), line.indices.Ptr(), line.indices.Num(), white, renderState.stereoDepth );	
+		idDrawVert * verts = AllocTris( gui, line.startVerts.Num(), line.indices.Ptr(), line.indices.Num(), white, renderState.stereoDepth );
 		if ( verts == NULL ) {
 			continue;
 		}
@@ -805,7 +957,7 @@ void idSWF::RenderEditText( idRenderSystem * gui, idSWFTextInstance * textInstan
 	selColor.w *= 0.5f;
 
 	gui->SetColor( defaultColor );
-	gui->SetGLState( GLStateForRenderState( renderState ) );
+	SetGLState( gui, GLStateForRenderState( renderState ) );
 
 	swfRect_t bounds;
 	bounds.tl.x = xScale * ( shape->bounds.tl.x + SWFTWIP( shape->leftMargin ) );
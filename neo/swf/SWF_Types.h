@@ -235,6 +235,35 @@ struct swfRenderState_t {
 	float ratio;
 	stereoDepthType_t stereoDepth;
 };
+struct swfRenderStats_t {
+	swfRenderStats_t();
+	void Clear();
+	int fills;					// shape fills and lines that passed the alpha test
+	int submits;				// AllocTris / DrawStretchPic calls made into the gui model
+	int draws;					// submits that could not merge into the previous gui surface
+	int tris;
+	uint64 microseconds;		// CPU time spent in idSWF::Render
+	uint64 glState;				// state most recently set on the gui
+	const idMaterial * material;	// last submitted material, state and stereo depth
+	uint64 lastGLState;
+	stereoDepthType_t stereoDepth;
+};
+
+ID_INLINE swfRenderStats_t::swfRenderStats_t() {
+	Clear();
+}
+
+ID_INLINE void swfRenderStats_t::Clear() {
+	fills = 0;
+	submits = 0;
+	draws = 0;
+	tris = 0;
+	microseconds = 0;
+	glState = 0;
+	material = NULL;
+	lastGLState = 0;
+	stereoDepth = STEREO_DEPTH_TYPE_NONE;
+}
 
 ID_INLINE swfRect_t::swfRect_t() :
 tl( 0.0f, 0.0f ),
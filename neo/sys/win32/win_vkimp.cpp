@@ -196,6 +196,10 @@ static void Vk_PickPhysicalDevice()
 
 				vkGetPhysicalDeviceFeatures(physicalDevice, &vkPhysicalDeviceFeatures);
 
+				// BC1 through BC7 share one feature
+				glConfig.textureCompressionRGTCAvailable = ( vkPhysicalDeviceFeatures.textureCompressionBC == VK_TRUE );
+				glConfig.textureCompressionBPTCAvailable = ( vkPhysicalDeviceFeatures.textureCompressionBC == VK_TRUE );
+
 				break;
 			}
 		}